@@ -17,6 +17,40 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkMath.h>
 #include <algorithm>
 
+/** \brief Allocates vertices from blocks of growing size.
+Vertices are never moved once created, so the pointers kept in the vertex list stay valid
+until the storage is destroyed.
+*/
+class mitk::ContourElement::VertexStorage
+{
+public:
+  VertexType* Create(mitk::Point3D &point, bool isControlPoint)
+  {
+    if (m_Blocks.empty() || m_Blocks.back().size() == m_Blocks.back().capacity())
+    {
+      std::size_t blockSize = m_Blocks.empty() ? MinimumBlockSize : 2 * m_Blocks.back().capacity();
+      if (blockSize > MaximumBlockSize)
+      {
+        blockSize = MaximumBlockSize;
+      }
+
+      m_Blocks.push_back(std::vector<VertexType>());
+      m_Blocks.back().reserve(blockSize);
+    }
+
+    m_Blocks.back().push_back(VertexType(point, isControlPoint));
+    return &m_Blocks.back().back();
+  }
+
+private:
+  static const std::size_t MinimumBlockSize = 256;
+  static const std::size_t MaximumBlockSize = 65536;
+
+  std::vector< std::vector<VertexType> > m_Blocks;
+};
+
+
+
 mitk::ContourElement::ContourElement()
 {
   this->m_Vertices = new VertexListType();
@@ -28,7 +62,9 @@ mitk::ContourElement::ContourElement()
 mitk::ContourElement::ContourElement(const mitk::ContourElement &other) :
   itk::LightObject(),
   m_Vertices(other.m_Vertices),
-  m_IsClosed(other.m_IsClosed)
+  m_IsClosed(other.m_IsClosed),
+  m_VertexStorage(other.m_VertexStorage),
+  m_ConcatenatedVertexStorages(other.m_ConcatenatedVertexStorages)
 {
 }
 
@@ -41,9 +77,36 @@ mitk::ContourElement::~ContourElement()
 
 
 
+void mitk::ContourElement::SetContiguousVertexStorage(bool contiguous)
+{
+  if (contiguous && this->m_VertexStorage == nullptr)
+  {
+    this->m_VertexStorage = std::make_shared<VertexStorage>();
+  }
+  else if (!contiguous && this->m_VertexStorage != nullptr)
+  {
+    //vertices created so far still live in the blocks
+    this->m_ConcatenatedVertexStorages.push_back(this->m_VertexStorage);
+    this->m_VertexStorage.reset();
+  }
+}
+
+
+
+mitk::ContourElement::VertexType* mitk::ContourElement::CreateVertex(mitk::Point3D &point, bool isControlPoint)
+{
+  if (this->m_VertexStorage != nullptr)
+  {
+    return this->m_VertexStorage->Create(point, isControlPoint);
+  }
+  return new VertexType(point, isControlPoint);
+}
+
+
+
 void mitk::ContourElement::AddVertex(mitk::Point3D &vertex, bool isControlPoint)
 {
-  this->m_Vertices->push_back(new VertexType(vertex, isControlPoint));
+  this->m_Vertices->push_back(this->CreateVertex(vertex, isControlPoint));
 }
 
 
@@ -57,7 +120,7 @@ void mitk::ContourElement::AddVertex(VertexType &vertex)
 
 void mitk::ContourElement::AddVertexAtFront(mitk::Point3D &vertex, bool isControlPoint)
 {
-  this->m_Vertices->push_front(new VertexType(vertex, isControlPoint));
+  this->m_Vertices->push_front(this->CreateVertex(vertex, isControlPoint));
 }
 
 
@@ -75,7 +138,7 @@ void mitk::ContourElement::InsertVertexAtIndex(mitk::Point3D &vertex, bool isCon
   {
     auto _where = this->m_Vertices->begin();
     _where += index;
-    this->m_Vertices->insert(_where, new VertexType(vertex, isControlPoint));
+    this->m_Vertices->insert(_where, this->CreateVertex(vertex, isControlPoint));
   }
 }
 
@@ -351,6 +414,18 @@ void mitk::ContourElement::Concatenate(mitk::ContourElement* other, bool check)
 {
   if( other->GetSize() > 0)
   {
+    //keep the blocks of the other contour alive as long as its vertices are referenced here
+    std::vector< std::shared_ptr<VertexStorage> > otherStorages = other->m_ConcatenatedVertexStorages;
+    otherStorages.push_back(other->m_VertexStorage);
+    for (auto storage : otherStorages)
+    {
+      if (storage != nullptr && storage != this->m_VertexStorage &&
+          std::find(this->m_ConcatenatedVertexStorages.begin(), this->m_ConcatenatedVertexStorages.end(), storage) == this->m_ConcatenatedVertexStorages.end())
+      {
+        this->m_ConcatenatedVertexStorages.push_back(storage);
+      }
+    }
+
     ConstVertexIterator otherIt =  other->m_Vertices->begin();
     ConstVertexIterator otherEnd =  other->m_Vertices->end();
     while(otherIt != otherEnd)
@@ -24,6 +24,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 
 #include <deque>
+#include <memory>
+#include <vector>
 
 namespace mitk
 {
@@ -113,8 +115,24 @@ namespace mitk
     {
       return this->m_Vertices->size();
     }
+
+    /** \brief Returns whether new vertices are allocated from contiguous blocks.
+    */
+    bool GetContiguousVertexStorage() const
+    {
+      return this->m_VertexStorage != nullptr;
+    }
     //   end of inline methods
 
+    /** \brief Allocate vertices created by this element from contiguous blocks instead of
+    one heap allocation per vertex.
+    This keeps large contours (e.g. from automatic segmentation) compact in memory. The blocks are
+    released together with the element (and every element the vertices were concatenated to).
+    Vertices that were already added are not moved.
+    \param contiguous - true = block storage; false = one allocation per vertex (default).
+    */
+    void SetContiguousVertexStorage(bool contiguous);
+
     /** \brief Add a vertex at the end of the contour
     \param point - coordinates in 3D space.
     \param isControlPoint - is the vertex a special control point.
@@ -260,9 +278,21 @@ namespace mitk
     ContourElement(const mitk::ContourElement &other);
     virtual ~ContourElement();
 
+    /** \brief Creates a new vertex, from the block storage if enabled.
+    */
+    VertexType* CreateVertex(mitk::Point3D &point, bool isControlPoint);
+
+    class VertexStorage;
+
     VertexListType* m_Vertices; //double ended queue with vertices
     bool m_IsClosed;
 
+    //block storage of the vertices created by this element, null if disabled
+    std::shared_ptr<VertexStorage> m_VertexStorage;
+
+    //block storages of other elements whose vertices were concatenated to this element
+    std::vector< std::shared_ptr<VertexStorage> > m_ConcatenatedVertexStorages;
+
   };
 } // namespace mitk
 
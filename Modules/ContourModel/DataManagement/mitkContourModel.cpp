@@ -17,7 +17,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkPlaneGeometry.h>
 
 mitk::ContourModel::ContourModel() :
-  m_UpdateBoundingBox(true)
+  m_UpdateBoundingBox(true),
+  m_ContiguousVertexStorage(false)
 {
   //set to initial state
   this->InitializeEmpty();
@@ -28,7 +29,8 @@ mitk::ContourModel::ContourModel() :
 mitk::ContourModel::ContourModel(const mitk::ContourModel &other) :
   mitk::BaseData(other),
   m_ContourSeries(other.m_ContourSeries),
-  m_lineInterpolation(other.m_lineInterpolation)
+  m_lineInterpolation(other.m_lineInterpolation),
+  m_ContiguousVertexStorage(other.m_ContiguousVertexStorage)
 {
   m_SelectedVertex = nullptr;
 }
@@ -503,6 +505,7 @@ void mitk::ContourModel::Expand(unsigned int timeSteps )
     for( std::size_t i = oldSize; i < static_cast<std::size_t>(timeSteps); i++)
     {
       m_ContourSeries.push_back(mitk::ContourElement::New());
+      m_ContourSeries.back()->SetContiguousVertexStorage(this->m_ContiguousVertexStorage);
     }
 
     this->InvokeEvent( ContourModelExpandTimeBoundsEvent() );
@@ -572,6 +575,16 @@ void mitk::ContourModel::RedistributeControlVertices(int period, int timestep)
   }
 }
 
+void mitk::ContourModel::SetContiguousVertexStorage(bool contiguous)
+{
+  this->m_ContiguousVertexStorage = contiguous;
+
+  for (auto element : this->m_ContourSeries)
+  {
+    element->SetContiguousVertexStorage(contiguous);
+  }
+}
+
 void mitk::ContourModel::ClearData()
 {
   //call the superclass, this releases the data of BaseData
@@ -599,6 +612,7 @@ void mitk::ContourModel::Initialize(mitk::ContourModel &other)
   for(mitk::TimeStepType currentTimestep = 0; currentTimestep < numberOfTimesteps; currentTimestep++)
   {
     this->m_ContourSeries.push_back(mitk::ContourElement::New());
+    this->m_ContourSeries.back()->SetContiguousVertexStorage(this->m_ContiguousVertexStorage);
     this->SetClosed(other.IsClosed(currentTimestep),currentTimestep);
   }
 
@@ -614,6 +628,7 @@ void mitk::ContourModel::InitializeEmpty()
   //clear data at timesteps
   this->m_ContourSeries.resize(0);
   this->m_ContourSeries.push_back(mitk::ContourElement::New());
+  this->m_ContourSeries.back()->SetContiguousVertexStorage(this->m_ContiguousVertexStorage);
 
   //set number of timesteps to one
   this->InitializeTimeGeometry(1);
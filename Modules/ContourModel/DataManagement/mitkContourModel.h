@@ -117,6 +117,13 @@ namespace mitk
     {
       return this->m_lineInterpolation;
     }
+
+    /** \brief Returns whether the vertices are allocated from contiguous blocks.
+    */
+    bool GetContiguousVertexStorage() const
+    {
+      return this->m_ContiguousVertexStorage;
+    }
     /*++++++++++++++++  END inline methods  +++++++++++++++++++++++*/
 
 
@@ -433,6 +440,13 @@ namespace mitk
     */
     virtual void RedistributeControlVertices(int period, int timestep);
 
+    /** \brief Allocate the vertices of all timesteps from contiguous blocks instead of one
+    heap allocation per vertex. Recommended for contours with many vertices.
+    Applies to existing and future timesteps.
+    \sa ContourElement::SetContiguousVertexStorage
+    */
+    void SetContiguousVertexStorage(bool contiguous);
+
   protected:
     mitkCloneMacro(Self);
 
@@ -460,6 +474,9 @@ namespace mitk
 
     //only update the bounding geometry if necessary
     bool m_UpdateBoundingBox;
+
+    //allocate the vertices of new contour elements from contiguous blocks
+    bool m_ContiguousVertexStorage;
   };
 
   itkEventMacro( ContourModelEvent, itk::AnyEvent );
@@ -29,6 +29,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <mitkPlaneGeometry.h>
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 mitk::ContourModelMapper2D::ContourModelMapper2D()
 {
 }
@@ -192,6 +196,27 @@ vtkSmartPointer<vtkPolyData> mitk::ContourModelMapper2D::CreateVtkPolyDataFromCo
     }
 
 
+    //distances of all vertices to the current plane, computed in one run
+    std::vector<mitk::Point3D> vertexCoordinates;
+    for (auto it = renderingContour->IteratorBegin(timestep); it != renderingContour->IteratorEnd(timestep); ++it)
+    {
+      vertexCoordinates.push_back((*it)->Coordinates);
+    }
+    std::vector<mitk::ScalarType> signedDistances(vertexCoordinates.size());
+    currentWorldGeometry->SignedDistance(vertexCoordinates.data(), signedDistances.data(), vertexCoordinates.size());
+    std::size_t currentIndex = 0;
+
+    //when cutting, only the lines that reach the tube around the plane have to be generated
+    bool useCuttingPlane = false;
+    this->GetDataNode()->GetBoolProperty( "use cutting plane", useCuttingPlane, renderer );
+    const double tubeRadius = 0.05;
+    auto isLineNeeded = [&](std::size_t index1, std::size_t index2)
+    {
+      return !useCuttingPlane ||
+        (std::min(signedDistances[index1], signedDistances[index2]) <= tubeRadius &&
+         std::max(signedDistances[index1], signedDistances[index2]) >= -tubeRadius);
+    };
+
     //iterate over all control points
     mitk::ContourModel::VertexIterator current = renderingContour->IteratorBegin(timestep);
     mitk::ContourModel::VertexIterator next = renderingContour->IteratorBegin(timestep);
@@ -206,12 +231,15 @@ vtkSmartPointer<vtkPolyData> mitk::ContourModelMapper2D::CreateVtkPolyDataFromCo
         mitk::ContourModel::VertexType* currentControlPoint = *current;
         mitk::ContourModel::VertexType* nextControlPoint = *next;
 
-        vtkIdType p1 = points->InsertNextPoint(currentControlPoint->Coordinates[0], currentControlPoint->Coordinates[1], currentControlPoint->Coordinates[2]);
-        vtkIdType p2 = points->InsertNextPoint(nextControlPoint->Coordinates[0], nextControlPoint->Coordinates[1], nextControlPoint->Coordinates[2]);
-        //add the line between both contorlPoints
-        lines->InsertNextCell(2);
-        lines->InsertCellPoint(p1);
-        lines->InsertCellPoint(p2);
+        if (isLineNeeded(currentIndex, currentIndex + 1))
+        {
+          vtkIdType p1 = points->InsertNextPoint(currentControlPoint->Coordinates[0], currentControlPoint->Coordinates[1], currentControlPoint->Coordinates[2]);
+          vtkIdType p2 = points->InsertNextPoint(nextControlPoint->Coordinates[0], nextControlPoint->Coordinates[1], nextControlPoint->Coordinates[2]);
+          //add the line between both contorlPoints
+          lines->InsertNextCell(2);
+          lines->InsertCellPoint(p1);
+          lines->InsertCellPoint(p2);
+        }
 
         if ( currentControlPoint->IsControlPoint )
         {
@@ -220,7 +248,7 @@ vtkSmartPointer<vtkPolyData> mitk::ContourModelMapper2D::CreateVtkPolyDataFromCo
           coordinates[1] = currentControlPoint->Coordinates[1];
           coordinates[2] = currentControlPoint->Coordinates[2];
 
-          double distance = plane->DistanceToPlane(coordinates);
+          double distance = std::abs(signedDistances[currentIndex]);
           if(distance < 0.1)
           {
             vtkSmartPointer<vtkSphereSource> sphere = vtkSmartPointer<vtkSphereSource>::New();
@@ -235,6 +263,7 @@ vtkSmartPointer<vtkPolyData> mitk::ContourModelMapper2D::CreateVtkPolyDataFromCo
 
         current++;
         next++;
+        currentIndex++;
       }//end while (it!=end)
 
       //check if last control point is enabled to draw it
@@ -245,7 +274,7 @@ vtkSmartPointer<vtkPolyData> mitk::ContourModelMapper2D::CreateVtkPolyDataFromCo
         coordinates[1] = (*current)->Coordinates[1];
         coordinates[2] = (*current)->Coordinates[2];
 
-        double distance = plane->DistanceToPlane(coordinates);
+        double distance = std::abs(signedDistances[currentIndex]);
         if(distance < 0.1)
         {
           vtkSmartPointer<vtkSphereSource> sphere = vtkSmartPointer<vtkSphereSource>::New();
@@ -261,7 +290,7 @@ vtkSmartPointer<vtkPolyData> mitk::ContourModelMapper2D::CreateVtkPolyDataFromCo
       /* If the contour is closed an additional line has to be created between the very first point
       * and the last point
       */
-      if(renderingContour->IsClosed(timestep))
+      if(renderingContour->IsClosed(timestep) && isLineNeeded(currentIndex, 0))
       {
         //add a line from the last to the first control point
         mitk::ContourModel::VertexType* firstControlPoint = *(renderingContour->IteratorBegin(timestep));
@@ -285,8 +314,6 @@ vtkSmartPointer<vtkPolyData> mitk::ContourModelMapper2D::CreateVtkPolyDataFromCo
 
 
       //cut through polyData
-      bool useCuttingPlane = false;
-      this->GetDataNode()->GetBoolProperty( "use cutting plane", useCuttingPlane, renderer );
       if (useCuttingPlane)
       {
         //slice through the data to get a 2D representation of the (possible) 3D contour
@@ -294,7 +321,7 @@ vtkSmartPointer<vtkPolyData> mitk::ContourModelMapper2D::CreateVtkPolyDataFromCo
         //needed because currently there is no outher solution if the contour is within the plane
         vtkSmartPointer<vtkTubeFilter> tubeFilter = vtkSmartPointer<vtkTubeFilter>::New();
         tubeFilter->SetInputData(polyDataIn3D);
-        tubeFilter->SetRadius(0.05);
+        tubeFilter->SetRadius(tubeRadius);
 
 
         //cuts through vtkPolyData with a given implicit function. In our case a plane
@@ -4,6 +4,13 @@ set(MODULE_TESTS
   mitkContourModelSetTest.cpp
 )
 
+if(MITK_ENABLE_RENDERING_TESTING)
+set(MODULE_TESTS
+  ${MODULE_TESTS}
+  mitkContourModelMapper2DTest.cpp
+)
+endif()
+
 set(MODULE_IMAGE_TESTS
 )
 set(MODULE_CUSTOM_TESTS
@@ -0,0 +1,120 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+//MITK
+#include <mitkRenderingTestHelper.h>
+#include <mitkContourModel.h>
+#include <mitkContourModelMapper2D.h>
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+
+/**
+ * Checks that the ContourModelMapper2D keeps the contour poly data as long as nothing changed, and regenerates it
+ * when the contour or the properties of its node are modified.
+ */
+class mitkContourModelMapper2DTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkContourModelMapper2DTestSuite);
+  MITK_TEST(NothingChanged_NotRegenerated);
+  MITK_TEST(ContourModified_Regenerated);
+  MITK_TEST(PropertyModified_Regenerated);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  mitk::RenderingTestHelper m_RenderingTestHelper;
+  mitk::ContourModel::Pointer m_Contour;
+  mitk::DataNode::Pointer m_Node;
+
+  /** renders and returns the poly data the mapper generated for the contour */
+  vtkSmartPointer<vtkPolyData> RenderAndGetPolyData()
+  {
+    m_RenderingTestHelper.Render();
+    mitk::ContourModelMapper2D* mapper = dynamic_cast<mitk::ContourModelMapper2D*>(m_Node->GetMapper(mitk::BaseRenderer::Standard2D));
+    CPPUNIT_ASSERT_MESSAGE("The contour is rendered by a ContourModelMapper2D", mapper != nullptr);
+    mitk::BaseRenderer* renderer = mitk::BaseRenderer::GetInstance(m_RenderingTestHelper.GetVtkRenderWindow());
+    return mapper->GetLocalStorage(renderer)->m_OutlinePolyData;
+  }
+
+public:
+
+  /**
+   * @brief mitkContourModelMapper2DTestSuite Because the RenderingTestHelper does not have an
+   * empty default constructor, we need this constructor to initialize the helper with a
+   * resolution.
+   */
+  mitkContourModelMapper2DTestSuite():
+    m_RenderingTestHelper(640, 480)
+  {}
+
+  void setUp() override
+  {
+    m_RenderingTestHelper = mitk::RenderingTestHelper(640, 480);
+
+    m_Contour = mitk::ContourModel::New();
+    mitk::Point3D point;
+    mitk::FillVector3D(point, 0.0, 0.0, 0.0);
+    m_Contour->AddVertex(point);
+    mitk::FillVector3D(point, 10.0, 0.0, 5.0);
+    m_Contour->AddVertex(point);
+    mitk::FillVector3D(point, 10.0, 10.0, 10.0);
+    m_Contour->AddVertex(point);
+    mitk::FillVector3D(point, 0.0, 10.0, 5.0);
+    m_Contour->AddVertex(point);
+    m_Contour->Close();
+
+    m_Node = mitk::DataNode::New();
+    m_Node->SetData(m_Contour);
+    m_RenderingTestHelper.AddNodeToStorage(m_Node);
+
+    // the first renderings adjust the camera to the data
+    m_RenderingTestHelper.Render();
+  }
+
+  void tearDown() override
+  {
+    m_Node = nullptr;
+    m_Contour = nullptr;
+  }
+
+  void NothingChanged_NotRegenerated()
+  {
+    vtkSmartPointer<vtkPolyData> polyData = this->RenderAndGetPolyData();
+    CPPUNIT_ASSERT_MESSAGE("The contour poly data is kept if nothing changed", polyData == this->RenderAndGetPolyData());
+  }
+
+  void ContourModified_Regenerated()
+  {
+    // keeps the poly data alive, so that a regenerated one can not get the same address
+    vtkSmartPointer<vtkPolyData> polyData = this->RenderAndGetPolyData();
+    mitk::Point3D point;
+    mitk::FillVector3D(point, 5.0, 12.0, 5.0);
+    m_Contour->AddVertex(point);
+    CPPUNIT_ASSERT_MESSAGE("Adding a vertex regenerates the contour poly data", polyData != this->RenderAndGetPolyData());
+  }
+
+  void PropertyModified_Regenerated()
+  {
+    vtkSmartPointer<vtkPolyData> polyData = this->RenderAndGetPolyData();
+    m_Node->SetFloatProperty("width", 3.0f);
+    CPPUNIT_ASSERT_MESSAGE("Changing a property regenerates the contour poly data", polyData != this->RenderAndGetPolyData());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkContourModelMapper2D)
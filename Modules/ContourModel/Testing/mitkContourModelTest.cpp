@@ -436,6 +436,68 @@ static void TestContourModelAPI()
 }
 
 
+//Fill a contour with block allocated vertices and check that they stay valid
+static void TestContiguousVertexStorage()
+{
+  mitk::ContourModel::Pointer contour = mitk::ContourModel::New();
+  contour->SetContiguousVertexStorage(true);
+
+  MITK_TEST_CONDITION(contour->GetContiguousVertexStorage(), "contiguous vertex storage is enabled");
+
+  const int numberOfVertices = 10000;
+  for (int i = 0; i < numberOfVertices; ++i)
+  {
+    mitk::Point3D p;
+    p[0] = i;
+    p[1] = -i;
+    p[2] = 0.5 * i;
+    contour->AddVertex(p, i % 10 == 0);
+  }
+
+  mitk::Point3D front;
+  front[0] = front[1] = front[2] = -1;
+  contour->AddVertexAtFront(front);
+  contour->InsertVertexAtIndex(front, 5000, true);
+
+  MITK_TEST_CONDITION(contour->GetNumberOfVertices() == numberOfVertices + 2, "all vertices were added");
+
+  bool allValid = true;
+  for (int i = 0; i < numberOfVertices; ++i)
+  {
+    const int index = i < 4999 ? i + 1 : i + 2;
+    const mitk::ContourModel::VertexType* vertex = contour->GetVertexAt(index);
+    allValid = allValid && vertex->Coordinates[0] == i && vertex->Coordinates[1] == -i &&
+      vertex->Coordinates[2] == 0.5 * i && vertex->IsControlPoint == (i % 10 == 0);
+  }
+  MITK_TEST_CONDITION(allValid, "block allocated vertices keep their values");
+  MITK_TEST_CONDITION(contour->GetVertexAt(5000)->IsControlPoint && contour->GetVertexAt(5000)->Coordinates == front, "inserted vertex");
+
+  //the other contour is destroyed while its vertices are still referenced by the concatenated one
+  {
+    mitk::ContourModel::Pointer contour2 = mitk::ContourModel::New();
+    contour2->SetContiguousVertexStorage(true);
+
+    mitk::Point3D p;
+    p[0] = 42;
+    p[1] = 43;
+    p[2] = 44;
+    contour2->AddVertex(p);
+
+    contour->Concatenate(contour2);
+  }
+
+  MITK_TEST_CONDITION(contour->GetNumberOfVertices() == numberOfVertices + 3, "contours were concatenated");
+  MITK_TEST_CONDITION(contour->GetVertexAt(numberOfVertices + 2)->Coordinates[1] == 43, "concatenated vertex outlives its contour");
+
+  contour->Expand(3);
+  MITK_TEST_CONDITION(contour->IsEmptyTimeStep(2) == false, "expanded contour");
+  mitk::Point3D p;
+  p[0] = p[1] = p[2] = 7;
+  contour->AddVertex(p, 2);
+  MITK_TEST_CONDITION(contour->GetVertexAt(0, 2)->Coordinates == p, "vertex at new timestep");
+}
+
+
 int mitkContourModelTest(int /*argc*/, char* /*argv*/[])
 {
   MITK_TEST_BEGIN("mitkContourModelTest")
@@ -454,6 +516,7 @@ int mitkContourModelTest(int /*argc*/, char* /*argv*/[])
   TestSetVertices();
   TestSelectVertexAtWrongPosition();
   TestContourModelAPI();
+  TestContiguousVertexStorage();
 
   MITK_TEST_END()
 }
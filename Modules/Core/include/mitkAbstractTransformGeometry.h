@@ -89,6 +89,15 @@ namespace mitk {
 
     virtual void Map(const mitk::Point2D & atPt2d_mm, const mitk::Vector2D &vec2d_mm, mitk::Vector3D &vec3d_mm) const override;
 
+    /**
+    * \brief maps the given points one by one, the abstract transform has no matrix to be cached
+    */
+    virtual bool Map(const mitk::Point3D *pts3d_mm, mitk::Point2D *pts2d_mm, std::size_t count) const override;
+
+    virtual void Map(const mitk::Point2D *pts2d_mm, mitk::Point3D *pts3d_mm, std::size_t count) const override;
+
+    virtual bool Project(const mitk::Point3D *pts3d_mm, mitk::Point3D *projectedPts3d_mm, std::size_t count) const override;
+
     virtual void IndexToWorld(const mitk::Point2D &pt_units, mitk::Point2D &pt_mm) const override;
 
     virtual void WorldToIndex(const mitk::Point2D &pt_mm, mitk::Point2D &pt_units) const override;
@@ -32,6 +32,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkTransform.h>
 #include <mitkGeometryTransformHolder.h>
 
+#include <memory>
+
 class vtkMatrix4x4;
 class vtkMatrixToLinearTransform;
 class vtkLinearTransform;
@@ -330,6 +332,20 @@ namespace mitk {
     //## For further information about coordinates types, please see the Geometry documentation
     void WorldToIndex(const mitk::Point3D& atPt3d_mm, const mitk::Vector3D& vec_mm, mitk::Vector3D& vec_units) const;
 
+    //##Documentation
+    //## @brief Convert world coordinates (in mm) of \a count \em points to (continuous!) index coordinates
+    //##
+    //## Equivalent to calling WorldToIndex(const mitk::Point3D&, mitk::Point3D&) for every point, but the
+    //## transform is looked up only once. \a pts_mm and \a pts_units may be the same array.
+    void WorldToIndex(const mitk::Point3D* pts_mm, mitk::Point3D* pts_units, std::size_t count) const;
+
+    //##Documentation
+    //## @brief Convert (continuous or discrete) index coordinates of \a count \em points to world coordinates (in mm)
+    //##
+    //## Equivalent to calling IndexToWorld(const mitk::Point3D&, mitk::Point3D&) for every point, but the
+    //## transform is looked up only once. \a pts_units and \a pts_mm may be the same array.
+    void IndexToWorld(const mitk::Point3D* pts_units, mitk::Point3D* pts_mm, std::size_t count) const;
+
     //##Documentation
     //## @brief Deprecated for use with ITK version 3.10 or newer.
     //## Convert ITK physical coordinates of a \em point (in mm,
@@ -590,6 +606,29 @@ namespace mitk {
     //## In Subclasses of BaseGeometry, implement own conditions or call Superclass::CheckBounds(bounds);.
     virtual void CheckIndexToWorldTransform(mitk::AffineTransform3D* /*transform*/){};
 
+    //##Documentation
+    //## @brief Plain copy of the IndexToWorldTransform used by the point mapping methods
+    //##
+    //## world = Matrix * index + Offset and index = InverseMatrix * (world - Offset).
+    //## ColumnNorms holds the length of the matrix columns, i.e. the spacing along the axes.
+    //## A cache is never changed once it is created, so threads can share it.
+    struct TransformCache
+    {
+      const TransformType* Transform;
+      unsigned long TransformMTime;
+      ScalarType Matrix[3][3];
+      ScalarType Offset[3];
+      ScalarType ColumnNorms[3];
+      ScalarType InverseMatrix[3][3];
+    };
+    typedef std::shared_ptr<const TransformCache> TransformCachePointer;
+
+    //##Documentation
+    //## @brief Returns the cached IndexToWorldTransform, a new one if the transform was replaced or modified
+    //##
+    //## Safe to call from several threads as long as none of them modifies the transform.
+    TransformCachePointer GetTransformCache() const;
+
   private:
 
     GeometryTransformHolder* m_GeometryTransform;
@@ -607,9 +646,8 @@ namespace mitk {
 
     static const unsigned int m_NDimensions = 3;
 
-    mutable TransformType::Pointer m_InvertedTransform;
-
-    mutable unsigned long m_IndexToWorldTransformLastModified;
+    //## accessed through std::atomic_load/std::atomic_store only
+    mutable TransformCachePointer m_TransformCache;
 
     bool m_ImageGeometry;
 
@@ -0,0 +1,76 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkChunkedGzip_h
+#define mitkChunkedGzip_h
+
+#include <MitkCoreExports.h>
+
+#include <cstddef>
+#include <ostream>
+
+namespace mitk
+{
+
+/**
+  \brief Compresses and decompresses data as a sequence of independent gzip members in parallel.
+
+  Every chunk of the data is compressed into a complete gzip member and the members are written one
+  after the other. Such concatenated members are valid gzip data, which every gzip reader (zlib, teem,
+  gunzip) decompresses to the original data, for instance the data of a gzip encoded NRRD file.
+
+  The header of every member contains the compressed size of the member as extra field with the
+  subfield id "MK", similar to BGZF. Decompress() uses it to find all members without decoding them,
+  so the members are inflated in parallel as well.
+*/
+class MITKCORE_EXPORT ChunkedGzip
+{
+  public:
+
+    /// Number of uncompressed bytes per gzip member if not given otherwise.
+    static const std::size_t DefaultChunkSize;
+
+    /**
+      \brief Appends size bytes of data as gzip members of chunkSize uncompressed bytes each to out.
+
+      level is the zlib compression level (-1 for the zlib default). Throws mitk::Exception if
+      compressing or writing fails.
+    */
+    static void Compress(const void* data, std::size_t size, std::ostream& out, int level = -1, std::size_t chunkSize = DefaultChunkSize);
+
+    /**
+      \brief Whether data starts with a gzip member that was written by Compress().
+
+      size is the number of available bytes, at least the size of a member header is needed.
+    */
+    static bool IsChunked(const void* data, std::size_t size);
+
+    /**
+      \brief Decompresses the gzip members written by Compress() to exactly outputSize bytes of output.
+
+      Returns false if data contains a member that was not written by Compress(), if a member is
+      corrupt or if the data does not decompress to outputSize bytes. output is undefined in that case.
+    */
+    static bool Decompress(const void* data, std::size_t size, void* output, std::size_t outputSize);
+
+  private:
+
+    ChunkedGzip() = delete;
+};
+
+} // namespace
+
+#endif
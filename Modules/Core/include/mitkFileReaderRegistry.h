@@ -61,6 +61,12 @@ public:
    */
   static MimeType GetMimeTypeForFile(const std::string& path, us::ModuleContext* context = us::GetModuleContext());
 
+  /**
+   * @brief Get the references of all readers registered for the given mime-type.
+   *
+   * The result is cached per module context and mime-type and reused until
+   * the service registry generation changes.
+   */
   static std::vector<ReaderReference> GetReferences(const MimeType& mimeType, us::ModuleContext* context = us::GetModuleContext());
 
   mitk::IFileReader* GetReader(const ReaderReference& ref, us::ModuleContext* context = us::GetModuleContext());
@@ -62,6 +62,7 @@ class SubImageSelector;
 class ImageTimeSelector;
 
 class ImageStatisticsHolder;
+class MemoryMappedFile;
 
 //##Documentation
 //## @brief Image class for storing images
@@ -193,6 +194,17 @@ public:
   //## @sa SetPicVolume
   virtual bool SetImportVolume(void *data, int t = 0, int n = 0, ImportMemoryManagementType importMemoryManagement = CopyMemory );
 
+  //##Documentation
+  //## @brief Use the memory mapped @a file as data of all volumes of the image.
+  //##
+  //## The mapping has to contain the pixels of all time steps in the layout of the image.
+  //## Nothing is copied: the pages of a slice are read from the file when the slice is accessed
+  //## first and copied when it is written first, so the file itself is never changed.
+  //## The image keeps @a file alive as long as any of its data items is in use, the file must not be
+  //## changed in place meanwhile (see MemoryMappedFile).
+  //## Returns false if the image has more than one channel or the mapping is too small.
+  virtual bool SetImportMappedFile(MemoryMappedFile *file);
+
   //##Documentation
   //## initialize new (or re-initialize) image information
   //## @warning Initialize() by pic assumes a plane, evenly spaced geometry starting at (0,0,0).
@@ -180,6 +180,9 @@ namespace mitk {
 
     ImageDataItem::ConstPointer m_Parent;
 
+    /// Keeps foreign memory (e.g. a MemoryMappedFile) that m_Data points to alive as long as the item exists.
+    itk::LightObject::ConstPointer m_MemoryOwner;
+
     unsigned int m_Dimension;
 
     unsigned int m_Dimensions[MAX_IMAGE_DIMENSIONS];
@@ -24,6 +24,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkHistogram.h>
 #endif
 
+#include <future>
+#include <vector>
+
 namespace mitk
 {
 
@@ -35,6 +38,15 @@ namespace mitk
 
   Each mitk::Image holds a normal pointer to its StatisticsHolder object. To get access to the methods, use the GetStatistics() method
   in mitk::Image class.
+
+  The extrema, the counts of the extremal voxels and a histogram of 256 bins are computed together for one time step
+  in a multi-threaded pass over the pixel buffer and kept until the image is modified. Pixel types of at most 16 bit
+  are counted per value, which gives the histogram in the same pass, all other pixel types need a second pass for the
+  histogram, which is only done if it is requested.
+
+  ComputeImageStatisticsInBackground() computes all time steps in a separate thread, e.g. when a mapper shows an image
+  with a provisional level window. Getters that need the statistics wait for it instead of computing them again,
+  IsComputingInBackground() tells whether they would have to wait.
   */
 class MITKCORE_EXPORT ImageStatisticsHolder
 {
@@ -47,7 +59,21 @@ public:
 
     typedef itk::Statistics::Histogram<double> HistogramType;
 
-    virtual const HistogramType* GetScalarHistogram(int t=0, unsigned int =0);
+    //##Documentation
+    //## \brief Get the histogram of 256 bins between the minimum and the maximum. Recomputation performed only when necessary.
+    virtual const HistogramType* GetScalarHistogram(int t=0, unsigned int component=0);
+
+    //##Documentation
+    //## \brief Starts computing the statistics and histograms of all time steps in a separate thread.
+    //##
+    //## Does nothing if a computation is already running or the statistics are up to date. The thread holds a read
+    //## ImageAccessLock on the image until it is done, so writers wait for it. Results are discarded if the image
+    //## is modified in the meantime.
+    void ComputeImageStatisticsInBackground();
+
+    //##Documentation
+    //## \brief Whether a computation started by ComputeImageStatisticsInBackground() is still running.
+    bool IsComputingInBackground();
 
     //##Documentation
     //## \brief Get the minimum for scalar images. Recomputation performed only when necessary.
@@ -129,30 +155,43 @@ public:
 
     bool IsValidTimeStep( int t) const;
 
-    template < typename ItkImageType >
-      friend void _ComputeExtremaInItkImage( const ItkImageType* itkImage, mitk::ImageStatisticsHolder* statisticsHolder, int t);
-    template < typename ItkImageType >
-      friend void _SimpleComputeExtremaInItkImage(const ItkImageType* itkImage, mitk::ImageStatisticsHolder* statisticsHolder, int t);
-
-    template < typename ItkImageType >
-      friend void _ComputeExtremaInItkVectorImage(const ItkImageType* itkImage, mitk::ImageStatisticsHolder* statisticsHolder, int t, unsigned int component);
-    template < typename ItkImageType >
-      friend void _SimpleComputeExtremaInItkVectorImage( const ItkImageType* itkImage, mitk::ImageStatisticsHolder* statisticsHolder, int t, unsigned int component);
-
 protected:
 
+      /** \brief Statistics of one time step as computed by ComputeTimeStepStatistics(). */
+      struct TimeStepStatistics
+      {
+        ScalarType Min;
+        ScalarType Max;
+        ScalarType SecondMin;
+        ScalarType SecondMax;
+        unsigned int CountOfMin;
+        unsigned int CountOfMax;
+        HistogramType::ConstPointer Histogram;
+        bool Valid;
+      };
+
+      /** \brief Computes the statistics of one component of a volume, without accessing the image. */
+      static TimeStepStatistics ComputeTimeStepStatistics(const ImageDataItem* volume, const PixelType& pixelType, unsigned int component,
+        bool computeHistogram);
+
       virtual void ResetImageStatistics();
 
+      //##Documentation
+      //## \brief Computes the statistics of time step t if they are not valid. With simple only the minimum and maximum have to be valid.
       virtual void ComputeImageStatistics(int t=0, unsigned int component=0, bool simple = false);
 
+      //##Documentation
+      //## \brief Takes over the results of the background computation, waits for it if wait is true, returns whether it is done.
+      bool FinishBackgroundComputation(bool wait);
+
+      void SetTimeStepStatistics(unsigned int t, const TimeStepStatistics& statistics);
+
       virtual void Expand( unsigned int timeSteps );
 
       ImageTimeSelector::Pointer GetTimeSelector();
 
       mitk::Image* m_Image;
 
-      mutable itk::Object::Pointer m_HistogramGeneratorObject;
-
       mutable itk::Object::Pointer m_TimeSelectorForExtremaObject;
       mutable std::vector<unsigned int> m_CountOfMinValuedVoxels;
       mutable std::vector<unsigned int> m_CountOfMaxValuedVoxels;
@@ -160,9 +199,13 @@ protected:
       mutable std::vector<ScalarType> m_ScalarMax;
       mutable std::vector<ScalarType> m_Scalar2ndMin;
       mutable std::vector<ScalarType> m_Scalar2ndMax;
+      std::vector<HistogramType::ConstPointer> m_ScalarHistograms;
 
       itk::TimeStamp m_LastRecomputeTimeStamp;
 
+      std::future< std::vector<TimeStepStatistics> > m_BackgroundStatistics;
+      itk::TimeStamp m_BackgroundStartTimeStamp;
+
 };
 
 } //end namespace
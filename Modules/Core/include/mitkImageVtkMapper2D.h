@@ -303,6 +303,13 @@ protected:
    */
   void ApplyLevelWindow(mitk::BaseRenderer* renderer);
 
+  /**
+   * @brief Replaces the level window that SetDefaultProperties() guessed while the statistics of the image were computed
+   * in the background ('levelwindow.provisional' is true) as soon as they are available.
+   * The range is always replaced, the window only if it was not changed in the meantime.
+   */
+  void UpdateProvisionalLevelWindow(mitk::BaseRenderer* renderer);
+
   /** \brief Set the color of the image/polydata */
   void ApplyColor( mitk::BaseRenderer* renderer );
 
@@ -146,8 +146,12 @@ namespace mitk {
 
     /**!
     * \brief sets level/window to optimize the contrast of the given Image
+    *
+    * While the statistics of the image are computed in the background (see ImageStatisticsHolder::ComputeImageStatisticsInBackground()),
+    * the level/window is guessed by the central slice without waiting for them.
+    * \return false if the level/window is such a provisional guess, which should be replaced by calling SetAuto again later.
     */
-    void SetAuto(const Image* image, bool tryPicTags = true, bool guessByCentralSlice = true, unsigned selectedComponent=0);
+    bool SetAuto(const Image* image, bool tryPicTags = true, bool guessByCentralSlice = true, unsigned selectedComponent=0);
 
     /**!
     * \brief sets level/window to the min/max greyvalues of the given Image
@@ -0,0 +1,76 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkMemoryMappedFile_h
+#define mitkMemoryMappedFile_h
+
+#include <MitkCoreExports.h>
+#include <mitkCommon.h>
+
+#include <itkLightObject.h>
+
+#include <string>
+
+namespace mitk
+{
+
+/**
+  \brief Private (copy-on-write) memory mapping of a part of a file.
+
+  The pages of the file are read by the operating system on first access, writes to the
+  mapped memory are never written back to the file. The mapping is released on destruction.
+
+  Map() returns nullptr if the file cannot be mapped. On Windows it always does, since mapping
+  files there turned out slower than reading them (see DicomSeriesReader); callers have to
+  read the file themselves in that case.
+
+  \warning The file must not be changed while it is mapped. Truncating it makes accesses to the missing pages
+  fail with SIGBUS, other changes may show up in pages that have not been accessed yet. ItkImageIO::Write()
+  therefore replaces files by renaming new ones over them, which keeps the mapped pages of the old file valid.
+  Files changed in place by other programs while an image of them is loaded are not detected.
+*/
+class MITKCORE_EXPORT MemoryMappedFile : public itk::LightObject
+{
+  public:
+
+    mitkClassMacroItkParent(MemoryMappedFile, itk::LightObject);
+
+    /// \brief Maps length bytes of the file fileName starting at offset, nullptr if this is not possible.
+    static Pointer Map(const std::string& fileName, std::size_t offset, std::size_t length);
+
+    void* GetData() const { return m_Data; }
+
+    std::size_t GetSize() const { return m_Size; }
+
+  protected:
+
+    MemoryMappedFile();
+    virtual ~MemoryMappedFile();
+
+  private:
+
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+    void* m_Mapping;
+    std::size_t m_MappingSize;
+    void* m_Data;
+    std::size_t m_Size;
+};
+
+} // namespace
+
+#endif
@@ -529,6 +529,36 @@ namespace mitk {
     */
     virtual bool Project(const mitk::Vector3D &vec3d_mm, mitk::Vector3D &projectedVec3d_mm) const;
 
+    /**
+    * \brief Maps \a count 3D points given in mm (\a pts3d_mm) onto the 2D
+    * geometry, like Map(const mitk::Point3D&, mitk::Point2D&) for every point.
+    *
+    * The transform of the geometry is looked up only once for all points.
+    * \return true if all points are inside the geometry
+    */
+    virtual bool Map(const mitk::Point3D *pts3d_mm, mitk::Point2D *pts2d_mm, std::size_t count) const;
+
+    /**
+    * \brief Converts \a count 2D points given in mm (\a pts2d_mm) into
+    * world-coordinates, like Map(const mitk::Point2D&, mitk::Point3D&) for every point.
+    */
+    virtual void Map(const mitk::Point2D *pts2d_mm, mitk::Point3D *pts3d_mm, std::size_t count) const;
+
+    /**
+    * \brief Projects \a count 3D points given in mm (\a pts3d_mm) onto the 2D
+    * geometry, like Project(const mitk::Point3D&, mitk::Point3D&) for every point.
+    *
+    * \a pts3d_mm and \a projectedPts3d_mm may be the same array.
+    * \return true if all points are inside the geometry
+    */
+    virtual bool Project(const mitk::Point3D *pts3d_mm, mitk::Point3D *projectedPts3d_mm, std::size_t count) const;
+
+    /**
+    * \brief Signed distances of \a count points from the geometry, like SignedDistance(const Point3D&) for every point
+    * (bounding-box \em not considered)
+    */
+    virtual void SignedDistance(const Point3D *pts3d_mm, ScalarType *distances, std::size_t count) const;
+
     /**
     * \brief Distance of the point from the geometry
     * (bounding-box \em not considered)
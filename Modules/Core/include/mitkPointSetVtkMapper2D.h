@@ -21,6 +21,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <MitkCoreExports.h>
 #include <mitkPointSetShapeProperty.h>
+#include <mitkPointSet.h>
 #include "mitkVtkMapper.h"
 #include "mitkBaseRenderer.h"
 #include "mitkLocalStorageHandler.h"
@@ -67,6 +68,12 @@ namespace mitk {
   * will be transformed into the world via the Geometry's index-to-world
   * transform.
   *
+  * Only points within "Pointset.2D.distance to plane" of the current
+  * slice and inside the visible part of the render window get a glyph
+  * and a label. The render objects are only regenerated if the point set,
+  * the node's properties, the slice or the camera changed; the world
+  * coordinates of the points are kept until the point set is modified.
+  *
   * Then the three Actors are combined inside a vtkPropAssembly and this
   * object is returned in GetProp() and so hooked up into the rendering
   * pipeline.
@@ -180,6 +187,17 @@ namespace mitk {
       // propassembly
       vtkSmartPointer<vtkPropAssembly> m_PropAssembly;
 
+      // world coordinates, ids and selection state of the points, kept until the point set is modified
+      std::vector<mitk::Point3D> m_WorldPoints;
+      std::vector<mitk::PointSet::PointIdentifier> m_PointIds;
+      std::vector<bool> m_PointSelected;
+      int m_WorldPointsTimeStep;
+      itk::TimeStamp m_WorldPointsUpdateTime;
+
+      // time and viewport size of the last generation of the render objects
+      itk::TimeStamp m_LastUpdateTime;
+      int m_LastViewportSize[2];
+
     };
 
     /** \brief The LocalStorageHandler holds all (three) LocalStorages for the three 2D render windows. */
@@ -21,12 +21,20 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "itkImageRegion.h"
 #include <vtkSmartPointer.h>
 
+#include <deque>
+#include <future>
+#include <map>
+
 class vtkPolyData;
 
 namespace mitk
 {
   /**
     * \brief Class for storing surfaces (vtkPolyData).
+    *
+    * Coarser versions of the polydata of a time step can be attached as levels of detail, e.g. by
+    * mitk::ACVD::RemeshLevelsOfDetailInBackground(). Mappers may render them instead of the polydata
+    * if the surface is small on screen or during interaction.
     * \ingroup Data
     */
   class MITKCORE_EXPORT Surface : public BaseData
@@ -34,6 +42,9 @@ namespace mitk
   public:
     typedef itk::ImageRegion<5> RegionType;
 
+    /** \brief A coarser version of the polydata of a time step, possibly still computed in the background. */
+    typedef std::future< vtkSmartPointer<vtkPolyData> > LevelOfDetailFuture;
+
     mitkClassMacro(Surface, BaseData);
     itkFactorylessNewMacro(Self)
     itkCloneMacro(Self)
@@ -59,6 +70,21 @@ namespace mitk
     virtual void UpdateOutputInformation() override;
     virtual bool VerifyRequestedRegion() override;
 
+    /** \brief Attach coarser versions of the polydata of time step t, ordered from the coarsest to the finest.
+     *
+     * A level becomes available as soon as it and all coarser levels are finished. Futures that fail are
+     * dropped together with all finer ones. All levels of t are dropped when its polydata is replaced or
+     * modified. The futures must not block on destruction, i.e. they should stem from a std::promise.
+     */
+    void SetLevelsOfDetail(std::vector<LevelOfDetailFuture> levels, unsigned int t = 0);
+
+    /** \brief Number of available levels of detail of time step t, including the polydata itself as the finest level.
+     */
+    unsigned int GetNumberOfLevelsOfDetail(unsigned int t = 0) const;
+
+    /** \brief Level of detail of time step t. Level 0 is the coarsest one, the finest level is GetVtkPolyData(t).
+     */
+    vtkPolyData* GetLevelOfDetail(unsigned int level, unsigned int t = 0) const;
 
   protected:
     mitkCloneMacro(Self);
@@ -73,10 +99,21 @@ namespace mitk
     virtual void InitializeEmpty() override;
 
   private:
+    struct LevelsOfDetail
+    {
+      std::vector< vtkSmartPointer<vtkPolyData> > Finished;
+      std::deque<LevelOfDetailFuture> Pending;
+      unsigned long PolyDataMTime;
+    };
+
+    /** \brief Collects the finished levels of detail of time step t and drops them if the polydata changed. */
+    const std::vector< vtkSmartPointer<vtkPolyData> >* GetFinishedLevelsOfDetail(unsigned int t) const;
+
     std::vector< vtkSmartPointer<vtkPolyData> > m_PolyDatas;
     mutable RegionType m_LargestPossibleRegion;
     mutable RegionType m_RequestedRegion;
     bool m_CalculateBoundingBox;
+    mutable std::map<unsigned int, LevelsOfDetail> m_LevelsOfDetail;
   };
 
   /**
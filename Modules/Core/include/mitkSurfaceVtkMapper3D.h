@@ -57,6 +57,8 @@ namespace mitk {
   *   - \b "scalar visibility": (BoolProperty) If the scarlars of the surface are visible
   *   - \b "Surface.TransferFunction (TransferFunctionProperty) Set a transferfunction for coloring the surface
   *   - \b "LookupTable (LookupTableProperty) LookupTable
+  *   - \b "surface.uselod": (BoolProperty) Render a coarser level of detail of the surface (see mitk::Surface::SetLevelsOfDetail)
+  *         if it is small on screen and during interaction. True by default.
 
   * Properties to look for are:
   *
@@ -93,6 +95,9 @@ public:
 
   static void SetDefaultProperties(mitk::DataNode* node, mitk::BaseRenderer* renderer = NULL, bool overwrite = false);
 
+  /** \brief Enabled if the surface has levels of detail and "surface.uselod" is set. */
+  virtual bool IsLODEnabled(mitk::BaseRenderer* renderer) const override;
+
 protected:
   SurfaceVtkMapper3D();
 
@@ -100,6 +105,11 @@ protected:
 
   virtual void GenerateDataForRenderer(mitk::BaseRenderer* renderer) override;
 
+  /** \brief Selects the coarsest level of detail of the input that has enough vertices for the projected size
+   * of the surface in the render window, or the next coarser one during interaction.
+   */
+  vtkPolyData* GetLevelOfDetailForRenderer(mitk::BaseRenderer* renderer);
+
   virtual void ResetMapper( mitk::BaseRenderer* renderer ) override;
 
   /** Checks whether the specified property is a ClippingProperty and if yes,
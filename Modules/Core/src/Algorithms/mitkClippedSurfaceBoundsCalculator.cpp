@@ -158,7 +158,7 @@ void mitk::ClippedSurfaceBoundsCalculator::CalculateIntersectionPoints(const mit
 {
   // SEE HEADER DOCUMENTATION for explanation
 
-  const mitk::BaseGeometry::Pointer imageGeometry = m_Image->GetGeometry()->Clone();
+  const mitk::BaseGeometry* imageGeometry = m_Image->GetGeometry();
 
   //  the cornerpoint(0) is the corner based Origin, which is original center based
   Point3D origin = imageGeometry->GetCornerPoint(0);           //Left, bottom, front
@@ -217,6 +217,10 @@ void mitk::ClippedSurfaceBoundsCalculator::CalculateIntersectionPoints(const mit
   edgesOf3DBox.push_back(std::make_pair(leftTopBack,        // left, top, back
     leftBottomBack));   // left, bottom, back
 
+  // intersection points of the edges within the image, converted to index coordinates in one run afterwards
+  std::vector<mitk::Point3D> intersectionPoints;
+  intersectionPoints.reserve(edgesOf3DBox.size());
+
   for ( auto iterator = edgesOf3DBox.cbegin(); iterator != edgesOf3DBox.cend(); ++iterator )
   {
     const Point3D startPoint = (*iterator).first;   // start point of the line
@@ -245,22 +249,31 @@ void mitk::ClippedSurfaceBoundsCalculator::CalculateIntersectionPoints(const mit
       doesLineIntersectWithPlane = geometry->IntersectionPointParam(line, t);
     }
 
-    //Get index point
-    mitk::Point3D intersectionIndexPoint;
-    imageGeometry->WorldToIndex(intersectionWorldPoint, intersectionIndexPoint);
-
     const bool lowerBoundGood = (0-mitk::sqrteps) <= t;
     const bool upperBoundGood = t <= 1.0 + mitk::sqrteps;
     if ( doesLineIntersectWithPlane && lowerBoundGood && upperBoundGood )
     {
-      for( int dim = 0; dim < 3; ++dim )
-      {
-        m_MinMaxOutput[dim].first = std::min( m_MinMaxOutput[dim].first, ROUND_P(intersectionIndexPoint[dim]) );
-        m_MinMaxOutput[dim].second = std::max( m_MinMaxOutput[dim].second, ROUND_P(intersectionIndexPoint[dim]) );
-      }
-      this->EnforceImageBounds();
+      intersectionPoints.push_back(intersectionWorldPoint);
     }
   }
+
+  if ( intersectionPoints.empty() )
+  {
+    return;
+  }
+
+  //Get index points
+  imageGeometry->WorldToIndex(intersectionPoints.data(), intersectionPoints.data(), intersectionPoints.size());
+  for ( auto iterator = intersectionPoints.cbegin(); iterator != intersectionPoints.cend(); ++iterator )
+  {
+    const mitk::Point3D& intersectionIndexPoint = *iterator;
+    for( int dim = 0; dim < 3; ++dim )
+    {
+      m_MinMaxOutput[dim].first = std::min( m_MinMaxOutput[dim].first, ROUND_P(intersectionIndexPoint[dim]) );
+      m_MinMaxOutput[dim].second = std::max( m_MinMaxOutput[dim].second, ROUND_P(intersectionIndexPoint[dim]) );
+    }
+  }
+  this->EnforceImageBounds();
 }
 
 void mitk::ClippedSurfaceBoundsCalculator::CalculateIntersectionPoints( PointListType pointList )
@@ -268,10 +281,12 @@ void mitk::ClippedSurfaceBoundsCalculator::CalculateIntersectionPoints( PointLis
   PointListType::const_iterator pointIterator;
 
   const mitk::SlicedGeometry3D::Pointer imageGeometry = m_Image->GetSlicedGeometry();
-  for ( pointIterator = pointList.cbegin(); pointIterator != pointList.cend(); ++pointIterator )
+  PointListType indexPointList( pointList.size() );
+  imageGeometry->WorldToIndex( pointList.data(), indexPointList.data(), pointList.size() );
+
+  for ( pointIterator = indexPointList.cbegin(); pointIterator != indexPointList.cend(); ++pointIterator )
   {
-    mitk::Point3D pntInIndexCoordinates;
-    imageGeometry->WorldToIndex( (*pointIterator), pntInIndexCoordinates );
+    const mitk::Point3D& pntInIndexCoordinates = *pointIterator;
 
     m_MinMaxOutput[0].first  = pntInIndexCoordinates[0] < m_MinMaxOutput[0].first  ? ROUND_P(pntInIndexCoordinates[0]) : m_MinMaxOutput[0].first;
     m_MinMaxOutput[0].second = pntInIndexCoordinates[0] > m_MinMaxOutput[0].second ? ROUND_P(pntInIndexCoordinates[0]) : m_MinMaxOutput[0].second;
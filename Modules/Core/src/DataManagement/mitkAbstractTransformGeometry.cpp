@@ -154,6 +154,34 @@ void mitk::AbstractTransformGeometry::Map(const mitk::Point2D & atPt2d_mm, const
   vtk2itk(vtkvec, vec3d_mm);
 }
 
+bool mitk::AbstractTransformGeometry::Map(const mitk::Point3D *pts3d_mm, mitk::Point2D *pts2d_mm, std::size_t count) const
+{
+  bool allInside = true;
+  for (std::size_t n = 0; n < count; ++n)
+  {
+    allInside &= Map(pts3d_mm[n], pts2d_mm[n]);
+  }
+  return allInside;
+}
+
+void mitk::AbstractTransformGeometry::Map(const mitk::Point2D *pts2d_mm, mitk::Point3D *pts3d_mm, std::size_t count) const
+{
+  for (std::size_t n = 0; n < count; ++n)
+  {
+    Map(pts2d_mm[n], pts3d_mm[n]);
+  }
+}
+
+bool mitk::AbstractTransformGeometry::Project(const mitk::Point3D *pts3d_mm, mitk::Point3D *projectedPts3d_mm, std::size_t count) const
+{
+  bool allInside = true;
+  for (std::size_t n = 0; n < count; ++n)
+  {
+    allInside &= Project(pts3d_mm[n], projectedPts3d_mm[n]);
+  }
+  return allInside;
+}
+
 void mitk::AbstractTransformGeometry::IndexToWorld(const mitk::Point2D &pt_units, mitk::Point2D &pt_mm) const
 {
   m_Plane->IndexToWorld(pt_units, pt_mm);
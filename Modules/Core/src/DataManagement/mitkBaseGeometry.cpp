@@ -16,6 +16,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <sstream>
 #include <iomanip>
+#include <cmath>
 
 #include <vtkMatrixToLinearTransform.h>
 #include <vtkMatrix4x4.h>
@@ -33,14 +34,14 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkScaleOperation.h"
 
 mitk::BaseGeometry::BaseGeometry() : Superclass(), mitk::OperationActor(),
-m_FrameOfReferenceID(0), m_IndexToWorldTransformLastModified(0), m_ImageGeometry(false), m_ModifiedLockFlag(false), m_ModifiedCalledFlag(false)
+m_FrameOfReferenceID(0), m_ImageGeometry(false), m_ModifiedLockFlag(false), m_ModifiedCalledFlag(false)
 {
   m_GeometryTransform = new GeometryTransformHolder();
   Initialize();
 }
 
 mitk::BaseGeometry::BaseGeometry(const BaseGeometry& other) : Superclass(), mitk::OperationActor(),
-m_FrameOfReferenceID(other.m_FrameOfReferenceID), m_IndexToWorldTransformLastModified(other.m_IndexToWorldTransformLastModified),
+m_FrameOfReferenceID(other.m_FrameOfReferenceID),
 m_ImageGeometry(other.m_ImageGeometry), m_ModifiedLockFlag(false), m_ModifiedCalledFlag(false)
 {
   m_GeometryTransform = new GeometryTransformHolder(*other.GetGeometryTransformHolder());
@@ -396,45 +397,92 @@ bool mitk::BaseGeometry::IsIndexInside(const mitk::Point3D& index) const
 
 void mitk::BaseGeometry::WorldToIndex(const mitk::Point3D &pt_mm, mitk::Point3D &pt_units) const
 {
-  mitk::Vector3D tempIn, tempOut;
-  const TransformType::OffsetType& offset = this->GetIndexToWorldTransform()->GetOffset();
-  tempIn = pt_mm.GetVectorFromOrigin() - offset;
+  this->WorldToIndex(&pt_mm, &pt_units, 1);
+}
 
-  WorldToIndex(tempIn, tempOut);
+void mitk::BaseGeometry::WorldToIndex(const mitk::Vector3D &vec_mm, mitk::Vector3D &vec_units) const
+{
+  const TransformCachePointer cachePointer = this->GetTransformCache();
+  const TransformCache& cache = *cachePointer;
 
-  pt_units = tempOut;
+  const mitk::Vector3D in = vec_mm;
+  for (int i = 0; i < 3; ++i)
+  {
+    vec_units[i] = cache.InverseMatrix[i][0] * in[0] + cache.InverseMatrix[i][1] * in[1] + cache.InverseMatrix[i][2] * in[2];
+  }
 }
 
-void mitk::BaseGeometry::WorldToIndex(const mitk::Vector3D &vec_mm, mitk::Vector3D &vec_units) const
+void mitk::BaseGeometry::WorldToIndex(const mitk::Point3D* pts_mm, mitk::Point3D* pts_units, std::size_t count) const
 {
-  // Get WorldToIndex transform
-  if (m_IndexToWorldTransformLastModified != this->GetIndexToWorldTransform()->GetMTime())
+  const TransformCachePointer cachePointer = this->GetTransformCache();
+  const TransformCache& cache = *cachePointer;
+  const ScalarType (&m)[3][3] = cache.InverseMatrix;
+
+  for (std::size_t n = 0; n < count; ++n)
   {
-    if (!m_InvertedTransform)
-    {
-      m_InvertedTransform = TransformType::New();
-    }
-    if (!this->GetIndexToWorldTransform()->GetInverse(m_InvertedTransform.GetPointer()))
+    const ScalarType x = pts_mm[n][0] - cache.Offset[0];
+    const ScalarType y = pts_mm[n][1] - cache.Offset[1];
+    const ScalarType z = pts_mm[n][2] - cache.Offset[2];
+    pts_units[n][0] = m[0][0] * x + m[0][1] * y + m[0][2] * z;
+    pts_units[n][1] = m[1][0] * x + m[1][1] * y + m[1][2] * z;
+    pts_units[n][2] = m[2][0] * x + m[2][1] * y + m[2][2] * z;
+  }
+}
+
+mitk::BaseGeometry::TransformCachePointer mitk::BaseGeometry::GetTransformCache() const
+{
+  const TransformType* transform = this->GetIndexToWorldTransform();
+  TransformCachePointer cache = std::atomic_load(&m_TransformCache);
+  if (cache && cache->Transform == transform && cache->TransformMTime == transform->GetMTime())
+  {
+    return cache;
+  }
+
+  // a new cache replaces the old one, which may still be in use by another thread
+  std::shared_ptr<TransformCache> newCache = std::make_shared<TransformCache>();
+  newCache->Transform = transform;
+  newCache->TransformMTime = transform->GetMTime();
+  const TransformType::MatrixType& matrix = transform->GetMatrix();
+  const TransformType::OffsetType& offset = transform->GetOffset();
+  for (int i = 0; i < 3; ++i)
+  {
+    for (int j = 0; j < 3; ++j)
     {
-      //Do not crash on inversion erron
-      //itkExceptionMacro("Internal ITK matrix inversion error, cannot proceed.");
-      MITK_WARN("Internal ITK matrix inversion error.");
+      newCache->Matrix[i][j] = matrix[i][j];
     }
-    m_IndexToWorldTransformLastModified = this->GetIndexToWorldTransform()->GetMTime();
+    newCache->Offset[i] = offset[i];
+  }
+  for (int j = 0; j < 3; ++j)
+  {
+    newCache->ColumnNorms[j] = std::sqrt(matrix[0][j] * matrix[0][j] + matrix[1][j] * matrix[1][j] + matrix[2][j] * matrix[2][j]);
   }
 
-  // Check for valid matrix inversion
-  const TransformType::MatrixType& inverse = m_InvertedTransform->GetMatrix();
-  if (inverse.GetVnlMatrix().has_nans())
+  // Get WorldToIndex transform, without the inverse cached by the ITK transform
+  vnl_matrix_fixed<ScalarType, 3, 3> inverse(0.0);
+  try
+  {
+    inverse = matrix.GetInverse();
+  }
+  catch (const itk::ExceptionObject&)
   {
     //Do not crash on inversion erron
-    //itkExceptionMacro("Internal ITK matrix inversion error, cannot proceed. Matrix was: " << std::endl
-    //  << this->GetIndexToWorldTransform()->GetMatrix() << "Suggested inverted matrix is:" << std::endl
-    //  << inverse);
     MITK_WARN("Internal ITK matrix inversion error.");
   }
+  if (inverse.has_nans())
+  {
+    MITK_WARN("Internal ITK matrix inversion error.");
+  }
+  for (int i = 0; i < 3; ++i)
+  {
+    for (int j = 0; j < 3; ++j)
+    {
+      newCache->InverseMatrix[i][j] = inverse[i][j];
+    }
+  }
 
-  vec_units = inverse * vec_mm;
+  cache = newCache;
+  std::atomic_store(&m_TransformCache, cache);
+  return cache;
 }
 
 void mitk::BaseGeometry::WorldToIndex(const mitk::Point3D & /*atPt3d_mm*/, const mitk::Vector3D &vec_mm, mitk::Vector3D &vec_units) const
@@ -485,12 +533,36 @@ void mitk::BaseGeometry::Translate(const Vector3D & vector)
 
 void mitk::BaseGeometry::IndexToWorld(const mitk::Point3D &pt_units, mitk::Point3D &pt_mm) const
 {
-  pt_mm = this->GetIndexToWorldTransform()->TransformPoint(pt_units);
+  this->IndexToWorld(&pt_units, &pt_mm, 1);
 }
 
 void mitk::BaseGeometry::IndexToWorld(const mitk::Vector3D &vec_units, mitk::Vector3D &vec_mm) const
 {
-  vec_mm = this->GetIndexToWorldTransform()->TransformVector(vec_units);
+  const TransformCachePointer cachePointer = this->GetTransformCache();
+  const TransformCache& cache = *cachePointer;
+
+  const mitk::Vector3D in = vec_units;
+  for (int i = 0; i < 3; ++i)
+  {
+    vec_mm[i] = cache.Matrix[i][0] * in[0] + cache.Matrix[i][1] * in[1] + cache.Matrix[i][2] * in[2];
+  }
+}
+
+void mitk::BaseGeometry::IndexToWorld(const mitk::Point3D* pts_units, mitk::Point3D* pts_mm, std::size_t count) const
+{
+  const TransformCachePointer cachePointer = this->GetTransformCache();
+  const TransformCache& cache = *cachePointer;
+  const ScalarType (&m)[3][3] = cache.Matrix;
+
+  for (std::size_t n = 0; n < count; ++n)
+  {
+    const ScalarType x = pts_units[n][0];
+    const ScalarType y = pts_units[n][1];
+    const ScalarType z = pts_units[n][2];
+    pts_mm[n][0] = m[0][0] * x + m[0][1] * y + m[0][2] * z + cache.Offset[0];
+    pts_mm[n][1] = m[1][0] * x + m[1][1] * y + m[1][2] * z + cache.Offset[1];
+    pts_mm[n][2] = m[2][0] * x + m[2][1] * y + m[2][2] * z + cache.Offset[2];
+  }
 }
 
 void mitk::BaseGeometry::ExecuteOperation(Operation* operation)
@@ -28,6 +28,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkProportionalTimeGeometry.h>
 #include "mitkCompareImageDataFilter.h"
 #include "mitkImageVtkAccessor.h"
+#include "mitkMemoryMappedFile.h"
 
 #include "mitkDicomTagsList.h"
 #include "mitkSliceNavigationController.h"
@@ -918,6 +919,38 @@ bool mitk::Image::SetImportVolume(void *data, int t, int n, ImportMemoryManageme
   return true;
 }
 
+bool mitk::Image::SetImportMappedFile(MemoryMappedFile *file)
+{
+  if (file == nullptr || !m_Initialized || GetNumberOfChannels() != 1) {
+    return false;
+  }
+
+  {
+    MutexHolder lock(m_ImageDataArraysLock);
+
+    ImageDataItemPointer data = new ImageDataItem(GetImageDescriptor(), 0, file->GetData(), false);
+    if (data->GetSize() > file->GetSize()) {
+      MITK_WARN << "Can't import mapped file of " << file->GetSize() << " bytes for an image of " << data->GetSize() << " bytes";
+      return false;
+    }
+    data->m_MemoryOwner = file;
+
+    // replaces the buffer allocated by Initialize(), which has not been touched and thus never been committed
+    m_Data = data;
+
+    const size_t ptypeSize = this->m_ImageDescriptor->GetChannelTypeById(0).GetSize();
+    for (unsigned int t = 0; t < m_Dimensions[3]; ++t) {
+      ImageDataItemPointer vol = new ImageDataItem(*m_Data, GetImageDescriptor(), t, 3u, nullptr, false, m_OffsetTable[3] * (ptypeSize) * t);
+      vol->SetComplete(true);
+      m_Volumes[GetVolumeIndex(t, 0)] = vol;
+    }
+    this->m_ImageDescriptor->GetChannelDescriptor(0).SetData(m_Data->GetData());
+  }
+  Modified();
+
+  return true;
+}
+
 void mitk::Image::Clear()
 {
   Superclass::Clear();
@@ -15,12 +15,290 @@ See LICENSE.txt or http://www.mitk.org for details.
 ===================================================================*/
 #include "mitkImageStatisticsHolder.h"
 
-#include "mitkHistogramGenerator.h"
-//#include "mitkImageTimeSelector.h"
 #include <mitkProperties.h>
+#include <mitkImageAccessLock.h>
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <type_traits>
+
+namespace
+{
+  typedef mitk::ImageStatisticsHolder::HistogramType HistogramType;
+
+  const unsigned int HistogramSize = 256;
+
+  // Blocks of pixels are processed in parallel and merged afterwards. The per value counting needs one table
+  // per block, therefore the number of blocks is limited.
+  const std::size_t MinimumBlockSize = 1 << 16;
+  const std::size_t MaximumNumberOfBlocks = 64;
+  const std::size_t MaximumNumberOfCountingBlocks = 16;
+
+  struct Extrema
+  {
+    mitk::ScalarType Min;
+    mitk::ScalarType SecondMin;
+    mitk::ScalarType Max;
+    mitk::ScalarType SecondMax;
+    unsigned int CountOfMin;
+    unsigned int CountOfMax;
+
+    Extrema()
+      : Min(itk::NumericTraits<mitk::ScalarType>::max()),
+        SecondMin(itk::NumericTraits<mitk::ScalarType>::max()),
+        Max(itk::NumericTraits<mitk::ScalarType>::NonpositiveMin()),
+        SecondMax(itk::NumericTraits<mitk::ScalarType>::NonpositiveMin()),
+        CountOfMin(0),
+        CountOfMax(0)
+    {
+    }
+
+    void AddToMin(mitk::ScalarType value, unsigned int count)
+    {
+      if (value < Min)
+      {
+        SecondMin = Min;
+        Min = value;
+        CountOfMin = count;
+      }
+      else if (value == Min)
+      {
+        CountOfMin += count;
+      }
+      else if (value < SecondMin)
+      {
+        SecondMin = value;
+      }
+    }
+
+    void AddToMax(mitk::ScalarType value, unsigned int count)
+    {
+      if (value > Max)
+      {
+        SecondMax = Max;
+        Max = value;
+        CountOfMax = count;
+      }
+      else if (value == Max)
+      {
+        CountOfMax += count;
+      }
+      else if (value > SecondMax)
+      {
+        SecondMax = value;
+      }
+    }
+
+    void Add(mitk::ScalarType value)
+    {
+      this->AddToMin(value, 1);
+      this->AddToMax(value, 1);
+    }
+
+    // The second extrema of other are candidates for the second extrema of the merged blocks, they are never
+    // beyond the merged extrema, so adding them without count does not change the counts.
+    void Merge(const Extrema& other)
+    {
+      if (other.CountOfMin > 0)
+      {
+        this->AddToMin(other.Min, other.CountOfMin);
+        this->AddToMin(other.SecondMin, 0);
+        this->AddToMax(other.Max, other.CountOfMax);
+        this->AddToMax(other.SecondMax, 0);
+      }
+    }
+  };
+
+  // Bins between minimum and maximum like itk::Statistics::SampleToHistogramFilter with its default marginal scale
+  // of 100, which extends the upper bound so that the maximum falls into the last bin.
+  struct HistogramBinning
+  {
+    double LowerBound;
+    double UpperBound;
+    double Scale;
+
+    HistogramBinning(double min, double max)
+      : LowerBound(min)
+    {
+      UpperBound = max + (max - min) / HistogramSize / 100.0;
+      if (!(UpperBound > LowerBound))
+      {
+        UpperBound = LowerBound + 1.0;
+      }
+      Scale = HistogramSize / (UpperBound - LowerBound);
+    }
+
+    bool Contains(double value) const
+    {
+      return value >= LowerBound && value < UpperBound;
+    }
+
+    unsigned int GetBin(double value) const
+    {
+      return std::min(static_cast<unsigned int>((value - LowerBound) * Scale), HistogramSize - 1);
+    }
+  };
+
+  HistogramType::ConstPointer CreateHistogram(const HistogramBinning& binning, const std::vector<std::size_t>& frequencies)
+  {
+    HistogramType::SizeType size(1);
+    size.Fill(HistogramSize);
+    HistogramType::MeasurementVectorType lowerBound(1);
+    HistogramType::MeasurementVectorType upperBound(1);
+    lowerBound[0] = binning.LowerBound;
+    upperBound[0] = binning.UpperBound;
+
+    HistogramType::Pointer histogram = HistogramType::New();
+    histogram->SetMeasurementVectorSize(1);
+    histogram->Initialize(size, lowerBound, upperBound);
+    for (unsigned int bin = 0; bin < HistogramSize; ++bin)
+    {
+      histogram->SetFrequency(bin, frequencies[bin]);
+    }
+    return histogram.GetPointer();
+  }
+
+  std::size_t GetNumberOfBlocks(std::size_t numberOfPixels, std::size_t maximumNumberOfBlocks)
+  {
+    return std::max<std::size_t>(1, std::min((numberOfPixels + MinimumBlockSize - 1) / MinimumBlockSize, maximumNumberOfBlocks));
+  }
+
+  // Types of at most 16 bit: counts every value per block in one pass, the extrema and the histogram follow from the counts.
+  template <typename TComponent>
+  bool ComputeStatistics(const TComponent* data, std::size_t numberOfPixels, std::size_t stride, bool /*computeHistogram*/,
+    Extrema& extrema, HistogramType::ConstPointer& histogram, std::true_type)
+  {
+    const std::size_t numberOfValues = std::size_t(1) << (8 * sizeof(TComponent));
+    const long long lowest = std::numeric_limits<TComponent>::lowest();
+    const std::size_t numberOfBlocks = GetNumberOfBlocks(numberOfPixels, MaximumNumberOfCountingBlocks);
+    const std::size_t blockSize = (numberOfPixels + numberOfBlocks - 1) / numberOfBlocks;
+
+    std::vector<unsigned int> counts(numberOfBlocks * numberOfValues, 0);
+#pragma omp parallel for
+    for (int block = 0; block < static_cast<int>(numberOfBlocks); ++block)
+    {
+      unsigned int* blockCounts = &counts[block * numberOfValues];
+      const std::size_t end = std::min(numberOfPixels, (block + 1) * blockSize);
+      for (std::size_t i = block * blockSize; i < end; ++i)
+      {
+        ++blockCounts[static_cast<long long>(data[i * stride]) - lowest];
+      }
+    }
+    for (std::size_t block = 1; block < numberOfBlocks; ++block)
+    {
+      const unsigned int* blockCounts = &counts[block * numberOfValues];
+      for (std::size_t value = 0; value < numberOfValues; ++value)
+      {
+        counts[value] += blockCounts[value];
+      }
+    }
+
+    for (std::size_t value = 0; value < numberOfValues; ++value)
+    {
+      if (counts[value] > 0)
+      {
+        extrema.AddToMin(static_cast<mitk::ScalarType>(static_cast<long long>(value) + lowest), counts[value]);
+        extrema.AddToMax(static_cast<mitk::ScalarType>(static_cast<long long>(value) + lowest), counts[value]);
+      }
+    }
+
+    const HistogramBinning binning(extrema.Min, extrema.Max);
+    std::vector<std::size_t> frequencies(HistogramSize, 0);
+    for (std::size_t value = 0; value < numberOfValues; ++value)
+    {
+      if (counts[value] > 0)
+      {
+        frequencies[binning.GetBin(static_cast<double>(static_cast<long long>(value) + lowest))] += counts[value];
+      }
+    }
+    histogram = CreateHistogram(binning, frequencies);
+    return true;
+  }
+
+  // All other types: extrema of the blocks in a first pass, the histogram in a second pass if requested.
+  template <typename TComponent>
+  bool ComputeStatistics(const TComponent* data, std::size_t numberOfPixels, std::size_t stride, bool computeHistogram,
+    Extrema& extrema, HistogramType::ConstPointer& histogram, std::false_type)
+  {
+    const std::size_t numberOfBlocks = GetNumberOfBlocks(numberOfPixels, MaximumNumberOfBlocks);
+    const std::size_t blockSize = (numberOfPixels + numberOfBlocks - 1) / numberOfBlocks;
+
+    std::vector<Extrema> blockExtrema(numberOfBlocks);
+#pragma omp parallel for
+    for (int block = 0; block < static_cast<int>(numberOfBlocks); ++block)
+    {
+      Extrema& localExtrema = blockExtrema[block];
+      const std::size_t end = std::min(numberOfPixels, (block + 1) * blockSize);
+      for (std::size_t i = block * blockSize; i < end; ++i)
+      {
+        localExtrema.Add(static_cast<mitk::ScalarType>(data[i * stride]));
+      }
+    }
+    for (std::size_t block = 0; block < numberOfBlocks; ++block)
+    {
+      extrema.Merge(blockExtrema[block]);
+    }
+
+    if (!computeHistogram)
+      return true;
+
+    const HistogramBinning binning(extrema.Min, extrema.Max);
+    std::vector<std::size_t> frequencies(numberOfBlocks * HistogramSize, 0);
+#pragma omp parallel for
+    for (int block = 0; block < static_cast<int>(numberOfBlocks); ++block)
+    {
+      std::size_t* blockFrequencies = &frequencies[block * HistogramSize];
+      const std::size_t end = std::min(numberOfPixels, (block + 1) * blockSize);
+      for (std::size_t i = block * blockSize; i < end; ++i)
+      {
+        const double value = static_cast<double>(data[i * stride]);
+        if (binning.Contains(value))
+        {
+          ++blockFrequencies[binning.GetBin(value)];
+        }
+      }
+    }
+    for (std::size_t block = 1; block < numberOfBlocks; ++block)
+    {
+      for (unsigned int bin = 0; bin < HistogramSize; ++bin)
+      {
+        frequencies[bin] += frequencies[block * HistogramSize + bin];
+      }
+    }
+    frequencies.resize(HistogramSize);
+    histogram = CreateHistogram(binning, frequencies);
+    return true;
+  }
+
+  template <typename TComponent>
+  bool ComputeStatistics(const void* data, std::size_t numberOfPixels, std::size_t numberOfComponents, unsigned int component,
+    bool computeHistogram, Extrema& extrema, HistogramType::ConstPointer& histogram)
+  {
+    typedef std::integral_constant<bool, std::numeric_limits<TComponent>::is_integer && sizeof(TComponent) <= 2> CountValues;
+    return ComputeStatistics(static_cast<const TComponent*>(data) + component, numberOfPixels, numberOfComponents,
+      computeHistogram, extrema, histogram, CountValues());
+  }
+
+  // Pixel types for which statistics are computed, all others get the range [0, 255].
+  bool HasScalarStatistics(const mitk::Image* image)
+  {
+    const mitk::PixelType pType = image->GetPixelType(0);
+    if (pType.GetNumberOfComponents() == 1 && (pType.GetPixelType() != itk::ImageIOBase::UNKNOWNPIXELTYPE) && (pType.GetPixelType() != itk::ImageIOBase::VECTOR))
+    {
+      return true;
+    }
+
+    // used to avoid statistics calculation on qball images. property will be replaced as soons as bug 17928 is merged and the diffusion image refactoring is complete.
+    mitk::BoolProperty* isqball = dynamic_cast< mitk::BoolProperty* >( image->GetProperty( "IsQballImage" ).GetPointer() );
+    return pType.GetPixelType() == itk::ImageIOBase::VECTOR && (!isqball || !isqball->GetValue());
+  }
+}
 
 mitk::ImageStatisticsHolder::ImageStatisticsHolder( mitk::Image* image)
-  : m_Image(image)/*, m_TimeSelectorForExtremaObject(NULL)*/
+  : m_Image(image)
 {
   m_CountOfMinValuedVoxels.resize(1, 0);
   m_CountOfMaxValuedVoxels.resize(1, 0);
@@ -28,37 +306,102 @@ mitk::ImageStatisticsHolder::ImageStatisticsHolder( mitk::Image* image)
   m_ScalarMax.resize(1, itk::NumericTraits<ScalarType>::NonpositiveMin());
   m_Scalar2ndMin.resize(1, itk::NumericTraits<ScalarType>::max());
   m_Scalar2ndMax.resize(1, itk::NumericTraits<ScalarType>::NonpositiveMin());
+  m_ScalarHistograms.resize(1);
+}
+
+mitk::ImageStatisticsHolder::~ImageStatisticsHolder()
+{
+  // a running background computation keeps the image alive, it is done if the image is deleted
+}
+
+const mitk::ImageStatisticsHolder::HistogramType* mitk::ImageStatisticsHolder::GetScalarHistogram(int t, unsigned int component)
+{
+  if (!m_Image->IsValidTimeStep(t)) return nullptr;
+
+  this->ComputeImageStatistics(t, component);
+  if (m_ScalarHistograms[t].IsNull() && HasScalarStatistics(m_Image))
+  {
+    // the extrema are known, but the pixel type needs a separate pass for the histogram
+    const PixelType pType = m_Image->GetPixelType(0);
+    TimeStepStatistics statistics = ComputeTimeStepStatistics(m_Image->GetVolumeData(t), pType,
+      pType.GetNumberOfComponents() == 1 ? 0 : component, true);
+    if (statistics.Valid)
+    {
+      this->SetTimeStepStatistics(t, statistics);
+    }
+  }
+  return m_ScalarHistograms[t];
+}
 
-  mitk::HistogramGenerator::Pointer generator = mitk::HistogramGenerator::New();
-  m_HistogramGeneratorObject = generator;
+void mitk::ImageStatisticsHolder::ComputeImageStatisticsInBackground()
+{
+  if (m_BackgroundStatistics.valid() || !m_Image->IsInitialized() || !HasScalarStatistics(m_Image)) return;
 
-  //m_Image = image;
+  // already up to date?
+  if (m_Image->GetMTime() <= m_LastRecomputeTimeStamp.GetMTime() && m_CountOfMinValuedVoxels[0] > 0) return;
 
-  // create time selector
-  //this->GetTimeSelector();
+  // the pixel buffers are requested here, the thread only reads them
+  std::vector<Image::ImageDataItemPointer> volumes;
+  for (unsigned int t = 0; t < m_Image->GetDimension(3); ++t)
+  {
+    volumes.push_back(m_Image->GetVolumeData(t));
+  }
+  const PixelType pixelType = m_Image->GetPixelType(0);
+
+  // taken on this thread while the image is certainly alive. The accessor references the image, so neither the image
+  // nor this holder are deleted before the thread releases the lock as its very last step.
+  struct ReadLock
+  {
+    ReadLock(Image* image) : Accessor(image), Lock(&Accessor) {}
+    ImageRegionAccessor Accessor;
+    ImageAccessLock Lock;
+  };
+  std::shared_ptr<ReadLock> readLock = std::make_shared<ReadLock>(m_Image);
+
+  std::promise< std::vector<TimeStepStatistics> > promise;
+  m_BackgroundStatistics = promise.get_future();
+  m_BackgroundStartTimeStamp.Modified();
+
+  std::thread([volumes, pixelType, readLock](std::promise< std::vector<TimeStepStatistics> > result) mutable
+  {
+    std::vector<TimeStepStatistics> statistics;
+    for (const Image::ImageDataItemPointer& volume : volumes)
+    {
+      statistics.push_back(ComputeTimeStepStatistics(volume, pixelType, 0, true));
+    }
+    result.set_value(statistics);
+    volumes.clear();
+    readLock.reset();
+  }, std::move(promise)).detach();
 }
 
-mitk::ImageStatisticsHolder::~ImageStatisticsHolder()
+bool mitk::ImageStatisticsHolder::IsComputingInBackground()
 {
-  m_HistogramGeneratorObject = nullptr;
-  //m_TimeSelectorForExtremaObject = NULL;
-  //m_Image = NULL;
+  return !this->FinishBackgroundComputation(false);
 }
 
-const mitk::ImageStatisticsHolder::HistogramType* mitk::ImageStatisticsHolder::GetScalarHistogram(int t, unsigned int /*component*/)
+bool mitk::ImageStatisticsHolder::FinishBackgroundComputation(bool wait)
 {
-  mitk::ImageTimeSelector* timeSelector = this->GetTimeSelector();
-  if(timeSelector!=nullptr)
-  {
-    timeSelector->SetTimeNr(t);
-    timeSelector->UpdateLargestPossibleRegion();
+  if (!m_BackgroundStatistics.valid()) return true;
+
+  if (!wait && m_BackgroundStatistics.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return false;
+
+  const std::vector<TimeStepStatistics> statistics = m_BackgroundStatistics.get();
+
+  // image modified while computing?
+  if (m_Image->GetMTime() > m_BackgroundStartTimeStamp.GetMTime()) return true;
 
-    mitk::HistogramGenerator* generator = static_cast<mitk::HistogramGenerator*>(m_HistogramGeneratorObject.GetPointer());
-    generator->SetImage(timeSelector->GetOutput());
-    generator->ComputeHistogram();
-    return static_cast<const mitk::ImageStatisticsHolder::HistogramType*>(generator->GetHistogram());
+  this->ResetImageStatistics();
+  this->Expand(statistics.size());
+  for (unsigned int t = 0; t < statistics.size() && t < m_ScalarMin.size(); ++t)
+  {
+    if (statistics[t].Valid)
+    {
+      this->SetTimeStepStatistics(t, statistics[t]);
+    }
   }
-  return nullptr;
+  m_LastRecomputeTimeStamp = m_BackgroundStartTimeStamp;
+  return true;
 }
 
 bool mitk::ImageStatisticsHolder::IsValidTimeStep( int t) const
@@ -68,15 +411,10 @@ bool mitk::ImageStatisticsHolder::IsValidTimeStep( int t) const
 
 mitk::ImageTimeSelector::Pointer mitk::ImageStatisticsHolder::GetTimeSelector()
 {
-  //if(m_TimeSelectorForExtremaObject.IsNull())
-  //{
-  //  m_TimeSelectorForExtremaObject = ImageTimeSelector::New();
-
-  ImageTimeSelector::Pointer timeSelector = ImageTimeSelector::New();//static_cast<mitk::ImageTimeSelector*>( m_TimeSelectorForExtremaObject.GetPointer() );
-    timeSelector->SetInput(m_Image);
-  //}
+  ImageTimeSelector::Pointer timeSelector = ImageTimeSelector::New();
+  timeSelector->SetInput(m_Image);
 
-  return timeSelector; //static_cast<ImageTimeSelector*>( m_TimeSelectorForExtremaObject.GetPointer() );
+  return timeSelector;
 }
 
 void mitk::ImageStatisticsHolder::Expand( unsigned int timeSteps )
@@ -94,6 +432,7 @@ void mitk::ImageStatisticsHolder::Expand( unsigned int timeSteps )
     m_Scalar2ndMax.resize(timeSteps, itk::NumericTraits<ScalarType>::NonpositiveMin());
     m_CountOfMinValuedVoxels.resize(timeSteps, 0);
     m_CountOfMaxValuedVoxels.resize(timeSteps, 0);
+    m_ScalarHistograms.resize(timeSteps);
   }
 }
 
@@ -105,315 +444,94 @@ void mitk::ImageStatisticsHolder::ResetImageStatistics()
   m_Scalar2ndMax.assign(1, itk::NumericTraits<ScalarType>::NonpositiveMin());
   m_CountOfMinValuedVoxels.assign(1, 0);
   m_CountOfMaxValuedVoxels.assign(1, 0);
+  m_ScalarHistograms.assign(1, nullptr);
 }
 
-
-#include "mitkImageAccessByItk.h"
-
-//#define BOUNDINGOBJECT_IGNORE
-
-template < typename ItkImageType >
-void mitk::_ComputeExtremaInItkImage( const ItkImageType* itkImage, mitk::ImageStatisticsHolder* statisticsHolder, int t)
-{
-  typename ItkImageType::RegionType region;
-  region = itkImage->GetBufferedRegion();
-  if(region.Crop(itkImage->GetRequestedRegion()) == false) return;
-  if(region != itkImage->GetRequestedRegion()) return;
-
-  itk::ImageRegionConstIterator<ItkImageType> it(itkImage, region);
-  typedef typename ItkImageType::PixelType TPixel;
-  TPixel value = 0;
-
-  if ( statisticsHolder == nullptr || !statisticsHolder->IsValidTimeStep( t ) ) return;
-  statisticsHolder->Expand(t+1); // make sure we have initialized all arrays
-
-  auto& countOfMinValuedVoxels = statisticsHolder->m_CountOfMinValuedVoxels[t];
-  auto& countOfMaxValuedVoxels = statisticsHolder->m_CountOfMaxValuedVoxels[t];
-
-  countOfMinValuedVoxels = 0;
-  countOfMaxValuedVoxels = 0;
-
-  auto& scalar2ndMin = statisticsHolder->m_Scalar2ndMin[t];
-  auto& scalar2ndMax = statisticsHolder->m_Scalar2ndMax[t];
-  auto& scalarMin = statisticsHolder->m_ScalarMin[t];
-  auto& scalarMax = statisticsHolder->m_ScalarMax[t];
-
-  scalar2ndMin= scalarMin = itk::NumericTraits<ScalarType>::max();
-  scalar2ndMax = scalarMax = itk::NumericTraits<ScalarType>::NonpositiveMin();
-
-  while( !it.IsAtEnd() )
-  {
-    value = it.Get();
-    //  if ( (value > mitkImage->m_ScalarMin) && (value < mitkImage->m_Scalar2ndMin) )        mitkImage->m_Scalar2ndMin = value;
-    //  else if ( (value < mitkImage->m_ScalarMax) && (value > mitkImage->m_Scalar2ndMax) )   mitkImage->m_Scalar2ndMax = value;
-    //  else if (value > mitkImage->m_ScalarMax)                                              mitkImage->m_ScalarMax = value;
-    //  else if (value < mitkImage->m_ScalarMin)                                              mitkImage->m_ScalarMin = value;
-
-    // if numbers start with 2ndMin or 2ndMax and never have that value again, the previous above logic failed
-#ifdef BOUNDINGOBJECT_IGNORE
-    if( value > -32765)
-    {
-#endif
-      // update min
-      if ( value < scalarMin )
-      {
-        scalar2ndMin = scalarMin;
-        scalarMin = value;
-        countOfMinValuedVoxels = 1;
-      }
-      else if ( value == scalarMin )
-      {
-        ++countOfMinValuedVoxels;
-      }
-      else if ( value < scalar2ndMin )
-      {
-        scalar2ndMin = value;
-      }
-
-      // update max
-      if ( value > scalarMax )
-      {
-        scalar2ndMax = scalarMax;
-        scalarMax = value;
-        countOfMaxValuedVoxels = 1;
-      }
-      else if ( value == scalarMax )
-      {
-        ++countOfMaxValuedVoxels;
-      }
-      else if ( value > scalar2ndMax )
-      {
-        scalar2ndMax = value;
-      }
-#ifdef BOUNDINGOBJECT_IGNORE
-    }
-#endif
-
-    ++it;
-  }
-
-  //// guard for wrong 2dMin/Max on single constant value images
-  if (scalarMax == scalarMin)
-  {
-    scalar2ndMax = scalar2ndMin = scalarMax;
-  }
-  statisticsHolder->m_LastRecomputeTimeStamp.Modified();
-  //MITK_DEBUG <<"extrema "<<itk::NumericTraits<TPixel>::NonpositiveMin()<<" "<<mitkImage->m_ScalarMin<<" "<<mitkImage->m_Scalar2ndMin<<" "<<mitkImage->m_Scalar2ndMax<<" "<<mitkImage->m_ScalarMax<<" "<<itk::NumericTraits<TPixel>::max();
-}
-
-// Computes only min and max of itkImage
-template < typename ItkImageType >
-void mitk::_SimpleComputeExtremaInItkImage(const ItkImageType* itkImage, mitk::ImageStatisticsHolder* statisticsHolder, int t)
+void mitk::ImageStatisticsHolder::SetTimeStepStatistics(unsigned int t, const TimeStepStatistics& statistics)
 {
-  typename ItkImageType::RegionType region;
-  region = itkImage->GetBufferedRegion();
-  if (region.Crop(itkImage->GetRequestedRegion()) == false) {
-    return;
-  }
-  if (region != itkImage->GetRequestedRegion()) { 
-    return;
-  }
-
-  itk::ImageRegionConstIterator<ItkImageType> it(itkImage, region);
-  typedef typename ItkImageType::PixelType TPixel;
-  TPixel value = 0;
-
-  if (statisticsHolder == nullptr || !statisticsHolder->IsValidTimeStep(t)) { 
-    return;
-  }
-  statisticsHolder->Expand(t + 1); // make sure we have initialized all arrays
-
-  auto& countOfMinValuedVoxels = statisticsHolder->m_CountOfMinValuedVoxels[t];
-  auto& countOfMaxValuedVoxels = statisticsHolder->m_CountOfMaxValuedVoxels[t];
-
-  countOfMinValuedVoxels = 0;
-  countOfMaxValuedVoxels = 0;
-
-  auto& scalar2ndMin = statisticsHolder->m_Scalar2ndMin[t];
-  auto& scalar2ndMax = statisticsHolder->m_Scalar2ndMax[t];
-  auto& scalarMin = statisticsHolder->m_ScalarMin[t];
-  auto& scalarMax = statisticsHolder->m_ScalarMax[t];
-
-  scalar2ndMin =
-    scalarMin = itk::NumericTraits<ScalarType>::max();
-  scalar2ndMax =
-    scalarMax = itk::NumericTraits<ScalarType>::NonpositiveMin();
-
-  while (!it.IsAtEnd()) {
-    value = it.Get();
-    //  if (value > mitkImage->m_ScalarMax)                                              mitkImage->m_ScalarMax = value;
-    //  else if (value < mitkImage->m_ScalarMin)                                       mitkImage->m_ScalarMin = value;
-#ifdef BOUNDINGOBJECT_IGNORE
-    if (value > -32765) {
-#endif
-      // update min
-      if (value < scalarMin) {
-        scalarMin = value;
-      }
-
-      // update max
-      if (value > scalarMax) {
-        scalarMax = value;
-      }
-#ifdef BOUNDINGOBJECT_IGNORE
-    }
-#endif
-
-    ++it;
-  }
-
-  statisticsHolder->m_LastRecomputeTimeStamp.Modified();
-  //MITK_DEBUG <<"extrema "<<itk::NumericTraits<TPixel>::NonpositiveMin()<<" "<<mitkImage->m_ScalarMin<<" "<<mitkImage->m_Scalar2ndMin<<" "<<mitkImage->m_Scalar2ndMax<<" "<<mitkImage->m_ScalarMax<<" "<<itk::NumericTraits<TPixel>::max();
+  m_ScalarMin[t] = statistics.Min;
+  m_ScalarMax[t] = statistics.Max;
+  m_Scalar2ndMin[t] = statistics.SecondMin;
+  m_Scalar2ndMax[t] = statistics.SecondMax;
+  m_CountOfMinValuedVoxels[t] = statistics.CountOfMin;
+  m_CountOfMaxValuedVoxels[t] = statistics.CountOfMax;
+  m_ScalarHistograms[t] = statistics.Histogram;
 }
 
-template < typename ItkImageType >
-void mitk::_ComputeExtremaInItkVectorImage( const ItkImageType* itkImage, mitk::ImageStatisticsHolder* statisticsHolder, int t, unsigned int component)
+mitk::ImageStatisticsHolder::TimeStepStatistics mitk::ImageStatisticsHolder::ComputeTimeStepStatistics(const ImageDataItem* volume,
+  const PixelType& pixelType, unsigned int component, bool computeHistogram)
 {
-  typename ItkImageType::RegionType region;
-  region = itkImage->GetBufferedRegion();
-  if(region.Crop(itkImage->GetRequestedRegion()) == false) return;
-  if(region != itkImage->GetRequestedRegion()) return;
-
-  itk::ImageRegionConstIterator<ItkImageType> it(itkImage, region);
-
-  if ( statisticsHolder == nullptr || !statisticsHolder->IsValidTimeStep( t ) ) return;
-  statisticsHolder->Expand(t+1); // make sure we have initialized all arrays
-
-  auto& countOfMinValuedVoxels = statisticsHolder->m_CountOfMinValuedVoxels[t];
-  auto& countOfMaxValuedVoxels = statisticsHolder->m_CountOfMaxValuedVoxels[t];
-
-  countOfMinValuedVoxels = 0;
-  countOfMaxValuedVoxels = 0;
-
-  auto& scalar2ndMin = statisticsHolder->m_Scalar2ndMin[t];
-  auto& scalar2ndMax = statisticsHolder->m_Scalar2ndMax[t];
-  auto& scalarMin = statisticsHolder->m_ScalarMin[t];
-  auto& scalarMax = statisticsHolder->m_ScalarMax[t];
-
-  scalar2ndMin = scalarMin = itk::NumericTraits<ScalarType>::max();
-  scalar2ndMax = scalarMax = itk::NumericTraits<ScalarType>::NonpositiveMin();
-
-  while( !it.IsAtEnd() )
+  TimeStepStatistics statistics;
+  statistics.Valid = false;
+  if (volume == nullptr || volume->GetData() == nullptr || pixelType.GetSize() == 0 || component >= pixelType.GetNumberOfComponents())
   {
-    double value = it.Get()[component];
-    //  if ( (value > mitkImage->m_ScalarMin) && (value < mitkImage->m_Scalar2ndMin) )        mitkImage->m_Scalar2ndMin = value;
-    //  else if ( (value < mitkImage->m_ScalarMax) && (value > mitkImage->m_Scalar2ndMax) )   mitkImage->m_Scalar2ndMax = value;
-    //  else if (value > mitkImage->m_ScalarMax)                                              mitkImage->m_ScalarMax = value;
-    //  else if (value < mitkImage->m_ScalarMin)                                              mitkImage->m_ScalarMin = value;
-
-    // if numbers start with 2ndMin or 2ndMax and never have that value again, the previous above logic failed
-#ifdef BOUNDINGOBJECT_IGNORE
-    if( value > -32765)
-    {
-#endif
-      // update min
-      if ( value < scalarMin )
-      {
-        scalar2ndMin = scalarMin;
-        scalarMin = value;
-        countOfMinValuedVoxels = 1;
-      }
-      else if ( value == scalarMin )
-      {
-        ++countOfMinValuedVoxels;
-      }
-      else if ( value < scalar2ndMin )
-      {
-        scalar2ndMin = value;
-      }
-
-      // update max
-      if ( value > scalarMax )
-      {
-        scalar2ndMax = scalarMax;
-        scalarMax = value;
-        countOfMaxValuedVoxels = 1;
-      }
-      else if ( value == scalarMax )
-      {
-        ++countOfMaxValuedVoxels;
-      }
-      else if ( value > scalar2ndMax )
-      {
-        scalar2ndMax = value;
-      }
-#ifdef BOUNDINGOBJECT_IGNORE
-    }
-#endif
-
-    ++it;
+    return statistics;
   }
 
-  //// guard for wrong 2dMin/Max on single constant value images
-  if (scalarMax == scalarMin)
+  const void* data = volume->GetData();
+  const std::size_t numberOfPixels = volume->GetSize() / pixelType.GetSize();
+  const std::size_t numberOfComponents = pixelType.GetNumberOfComponents();
+  if (numberOfPixels == 0)
   {
-    scalar2ndMax = scalar2ndMin = scalarMax;
+    return statistics;
   }
-  statisticsHolder->m_LastRecomputeTimeStamp.Modified();
-  //MITK_DEBUG <<"extrema "<<itk::NumericTraits<TPixel>::NonpositiveMin()<<" "<<mitkImage->m_ScalarMin<<" "<<mitkImage->m_Scalar2ndMin<<" "<<mitkImage->m_Scalar2ndMax<<" "<<mitkImage->m_ScalarMax<<" "<<itk::NumericTraits<TPixel>::max();
-}
 
-// Computes only min and max of itkImage
-template < typename ItkImageType >
-void mitk::_SimpleComputeExtremaInItkVectorImage(const ItkImageType* itkImage, mitk::ImageStatisticsHolder* statisticsHolder, int t, unsigned int component)
-{
-  typename ItkImageType::RegionType region;
-  region = itkImage->GetBufferedRegion();
-  if (region.Crop(itkImage->GetRequestedRegion()) == false) {
-    return;
-  }
-  if (region != itkImage->GetRequestedRegion()) {
-    return;
+  Extrema extrema;
+  bool computed = false;
+  switch (pixelType.GetComponentType())
+  {
+    case itk::ImageIOBase::UCHAR:
+      computed = ComputeStatistics<unsigned char>(data, numberOfPixels, numberOfComponents, component, computeHistogram, extrema, statistics.Histogram);
+      break;
+    case itk::ImageIOBase::CHAR:
+      computed = ComputeStatistics<signed char>(data, numberOfPixels, numberOfComponents, component, computeHistogram, extrema, statistics.Histogram);
+      break;
+    case itk::ImageIOBase::USHORT:
+      computed = ComputeStatistics<unsigned short>(data, numberOfPixels, numberOfComponents, component, computeHistogram, extrema, statistics.Histogram);
+      break;
+    case itk::ImageIOBase::SHORT:
+      computed = ComputeStatistics<short>(data, numberOfPixels, numberOfComponents, component, computeHistogram, extrema, statistics.Histogram);
+      break;
+    case itk::ImageIOBase::UINT:
+      computed = ComputeStatistics<unsigned int>(data, numberOfPixels, numberOfComponents, component, computeHistogram, extrema, statistics.Histogram);
+      break;
+    case itk::ImageIOBase::INT:
+      computed = ComputeStatistics<int>(data, numberOfPixels, numberOfComponents, component, computeHistogram, extrema, statistics.Histogram);
+      break;
+    case itk::ImageIOBase::ULONG:
+      computed = ComputeStatistics<unsigned long>(data, numberOfPixels, numberOfComponents, component, computeHistogram, extrema, statistics.Histogram);
+      break;
+    case itk::ImageIOBase::LONG:
+      computed = ComputeStatistics<long>(data, numberOfPixels, numberOfComponents, component, computeHistogram, extrema, statistics.Histogram);
+      break;
+    case itk::ImageIOBase::FLOAT:
+      computed = ComputeStatistics<float>(data, numberOfPixels, numberOfComponents, component, computeHistogram, extrema, statistics.Histogram);
+      break;
+    case itk::ImageIOBase::DOUBLE:
+      computed = ComputeStatistics<double>(data, numberOfPixels, numberOfComponents, component, computeHistogram, extrema, statistics.Histogram);
+      break;
+    default:
+      break;
   }
-
-  itk::ImageRegionConstIterator<ItkImageType> it(itkImage, region);
-
-  if (statisticsHolder == nullptr || !statisticsHolder->IsValidTimeStep(t)) {
-    return;
+  if (!computed || extrema.CountOfMin == 0)
+  {
+    return statistics;
   }
-  statisticsHolder->Expand(t + 1); // make sure we have initialized all arrays
-
-  auto& countOfMinValuedVoxels = statisticsHolder->m_CountOfMinValuedVoxels[t];
-  auto& countOfMaxValuedVoxels = statisticsHolder->m_CountOfMaxValuedVoxels[t];
-
-  countOfMinValuedVoxels = 0;
-  countOfMaxValuedVoxels = 0;
-
-  auto& scalar2ndMin = statisticsHolder->m_Scalar2ndMin[t];
-  auto& scalar2ndMax = statisticsHolder->m_Scalar2ndMax[t];
-  auto& scalarMin = statisticsHolder->m_ScalarMin[t];
-  auto& scalarMax = statisticsHolder->m_ScalarMax[t];
-
-  scalar2ndMin = scalarMin = itk::NumericTraits<ScalarType>::max();
-  scalar2ndMax = scalarMax = itk::NumericTraits<ScalarType>::NonpositiveMin();
-
-  while (!it.IsAtEnd()) {
-    double value = it.Get()[component];
-    //  if (value > mitkImage->m_ScalarMax)                                              mitkImage->m_ScalarMax = value;
-    //  else if (value < mitkImage->m_ScalarMin)                                       mitkImage->m_ScalarMin = value;
-
-    // if numbers start with 2ndMin or 2ndMax and never have that value again, the previous above logic failed
-#ifdef BOUNDINGOBJECT_IGNORE
-    if (value > -32765) {
-#endif
-      // update min
-      if (value < scalarMin) {
-        scalarMin = value;
-      }
 
-      // update max
-      if (value > scalarMax) {
-        scalarMax = value;
-      }
-#ifdef BOUNDINGOBJECT_IGNORE
-    }
-#endif
-
-    ++it;
+  // guard for wrong 2dMin/Max on single constant value images
+  if (extrema.Max == extrema.Min)
+  {
+    extrema.SecondMax = extrema.SecondMin = extrema.Max;
   }
 
-  statisticsHolder->m_LastRecomputeTimeStamp.Modified();
-  //MITK_DEBUG <<"extrema "<<itk::NumericTraits<TPixel>::NonpositiveMin()<<" "<<mitkImage->m_ScalarMin<<" "<<mitkImage->m_Scalar2ndMin<<" "<<mitkImage->m_Scalar2ndMax<<" "<<mitkImage->m_ScalarMax<<" "<<itk::NumericTraits<TPixel>::max();
+  statistics.Min = extrema.Min;
+  statistics.Max = extrema.Max;
+  statistics.SecondMin = extrema.SecondMin;
+  statistics.SecondMax = extrema.SecondMax;
+  statistics.CountOfMin = extrema.CountOfMin;
+  statistics.CountOfMax = extrema.CountOfMax;
+  statistics.Valid = true;
+  return statistics;
 }
 
 void mitk::ImageStatisticsHolder::ComputeImageStatistics(int t, unsigned int component, bool simple)
@@ -421,6 +539,9 @@ void mitk::ImageStatisticsHolder::ComputeImageStatistics(int t, unsigned int com
   // timestep valid?
   if (!m_Image->IsValidTimeStep(t)) return;
 
+  // results of a background computation are used instead of computing them again
+  this->FinishBackgroundComputation(true);
+
   // image modified?
   if (this->m_Image->GetMTime() > m_LastRecomputeTimeStamp.GetMTime())
     this->ResetImageStatistics();
@@ -437,44 +558,19 @@ void mitk::ImageStatisticsHolder::ComputeImageStatistics(int t, unsigned int com
       return; // All statistic were already computed
     }
   }
-  
 
-  // used to avoid statistics calculation on qball images. property will be replaced as soons as bug 17928 is merged and the diffusion image refactoring is complete.
-  mitk::BoolProperty* isqball = dynamic_cast< mitk::BoolProperty* >( m_Image->GetProperty( "IsQballImage" ).GetPointer() );
-  const mitk::PixelType pType = m_Image->GetPixelType(0);
-  if(pType.GetNumberOfComponents() == 1 && (pType.GetPixelType() != itk::ImageIOBase::UNKNOWNPIXELTYPE) && (pType.GetPixelType() != itk::ImageIOBase::VECTOR) )
+  if (HasScalarStatistics(m_Image))
   {
-    // recompute
-    mitk::ImageTimeSelector::Pointer timeSelector = this->GetTimeSelector();
-    if(timeSelector.IsNotNull())
+    // recompute, types of at most 16 bit get the histogram in the same pass
+    const mitk::PixelType pType = m_Image->GetPixelType(0);
+    TimeStepStatistics statistics = ComputeTimeStepStatistics(m_Image->GetVolumeData(t), pType,
+      pType.GetNumberOfComponents() == 1 ? 0 : component, false);
+    if (statistics.Valid)
     {
-      timeSelector->SetTimeNr(t);
-      timeSelector->UpdateLargestPossibleRegion();
-      const mitk::Image* image = timeSelector->GetOutput();
-      if (simple) {
-        AccessByItk_2( image, _SimpleComputeExtremaInItkImage, this, t );
-      } else {
-        AccessByItk_2(image, _ComputeExtremaInItkImage, this, t);
-      }
+      this->SetTimeStepStatistics(t, statistics);
+      m_LastRecomputeTimeStamp.Modified();
     }
   }
-  else if (pType.GetPixelType() == itk::ImageIOBase::VECTOR && (!isqball || !isqball->GetValue()))  // we have a vector image
-  {
-      // recompute
-      mitk::ImageTimeSelector::Pointer timeSelector = this->GetTimeSelector();
-      if(timeSelector.IsNotNull())
-      {
-        timeSelector->SetTimeNr(t);
-        timeSelector->UpdateLargestPossibleRegion();
-        const mitk::Image* image = timeSelector->GetOutput();
-        if (simple) {
-          AccessVectorPixelTypeByItk_n(image, _SimpleComputeExtremaInItkVectorImage, (this, t, component));
-        } else {
-          AccessVectorPixelTypeByItk_n(image, _ComputeExtremaInItkVectorImage, (this, t, component));
-        }
-        
-      }
-  }
   else
   {
     m_ScalarMin[t] = 0;
@@ -225,6 +225,8 @@ extrems is complete.
 
 If minValue == maxValue, the center slice is uniform and the above scan is repeated for
 the complete image, not just one slice
+(unless the statistics of the complete image are still computed in the background,
+then the result is provisional)
 
 Next, special cases of images with only 1, 2 or 3 distinct data values
 have hand assigned level window ranges.
@@ -248,13 +250,16 @@ In consequence the level window maximizes contrast with minimal amount of
 computation and does do useful things if the data contains std::min or
 std:max values or has only 1 or 2 or 3 data values.
 */
-void mitk::LevelWindow::SetAuto(const mitk::Image* image, bool /*tryPicTags*/, bool guessByCentralSlice,
+bool mitk::LevelWindow::SetAuto(const mitk::Image* image, bool /*tryPicTags*/, bool guessByCentralSlice,
     unsigned selectedComponent)
 {
   if ( IsFixed() )
-    return;
+    return true;
+
+  if ( image == nullptr || !image->IsInitialized() ) return true;
 
-  if ( image == nullptr || !image->IsInitialized() ) return;
+  // do not wait for the statistics of the whole image
+  const bool provisional = image->GetStatistics()->IsComputingInBackground();
 
   if ((image->GetPixelType().GetComponentType() == 9) || (image->GetPixelType().GetComponentType() == 10))
   {
@@ -271,20 +276,20 @@ void mitk::LevelWindow::SetAuto(const mitk::Image* image, bool /*tryPicTags*/, b
   ScalarType min2ndValue = 0.0;
   ScalarType max2ndValue = 0.0;
   mitk::ImageSliceSelector::Pointer sliceSelector = mitk::ImageSliceSelector::New();
-  if ( guessByCentralSlice )
+  if ( guessByCentralSlice || provisional )
   {
     sliceSelector->SetInput(image);
     sliceSelector->SetSliceNr(image->GetDimension(2)/2);
     sliceSelector->SetTimeNr(image->GetDimension(3)/2);
     sliceSelector->Update();
     image = sliceSelector->GetOutput();
-    if ( image == nullptr || !image->IsInitialized() ) return;
+    if ( image == nullptr || !image->IsInitialized() ) return !provisional;
 
     min2ndValue = image->GetStatistics()->GetScalarValue2ndMin();
     max2ndValue = image->GetStatistics()->GetScalarValue2ndMax();
     minValue    = image->GetStatistics()->GetScalarValueMin(0, selectedComponent);
     maxValue = image->GetStatistics()->GetScalarValueMax();
-    if ( minValue == maxValue )
+    if ( minValue == maxValue && !provisional )
     {
       // guessByCentralSlice seems to have failed, lets look at all data
       image       = wholeImage;
@@ -404,6 +409,7 @@ void mitk::LevelWindow::SetAuto(const mitk::Image* image, bool /*tryPicTags*/, b
   }
   SetWindowBounds(minValue, maxValue);
   SetDefaultLevelWindow((maxValue - minValue) / 2 + minValue, maxValue - minValue);
+  return !provisional;
 }
 
 void mitk::LevelWindow::SetToImageRange(const mitk::Image *image)
@@ -25,6 +25,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <vnl/vnl_cross.h>
 
+#include <algorithm>
+
 namespace mitk
 {
   PlaneGeometry::PlaneGeometry()
@@ -706,6 +708,27 @@ namespace mitk
     return SignedDistanceFromPlane(pt3d_mm);
   }
 
+  void
+  PlaneGeometry::SignedDistance( const Point3D *pts3d_mm, ScalarType *distances, std::size_t count ) const
+  {
+    const TransformCachePointer cachePointer = this->GetTransformCache();
+    const TransformCache& cache = *cachePointer;
+    const ScalarType len = cache.ColumnNorms[2];
+    if (len == 0)
+    {
+      std::fill(distances, distances + count, ScalarType(0));
+      return;
+    }
+
+    const ScalarType normal[3] = { cache.Matrix[0][2] / len, cache.Matrix[1][2] / len, cache.Matrix[2][2] / len };
+    for (std::size_t n = 0; n < count; ++n)
+    {
+      distances[n] = (pts3d_mm[n][0] - cache.Offset[0]) * normal[0]
+                   + (pts3d_mm[n][1] - cache.Offset[1]) * normal[1]
+                   + (pts3d_mm[n][2] - cache.Offset[2]) * normal[2];
+    }
+  }
+
   bool
   PlaneGeometry::IsAbove( const Point3D &pt3d_mm , bool considerBoundingBox) const
   {
@@ -950,28 +973,57 @@ namespace mitk
 
   bool PlaneGeometry::Map(const mitk::Point3D &pt3d_mm, mitk::Point2D &pt2d_mm) const
   {
-    assert(this->IsBoundingBoxNull()==false);
-
-    Point3D pt3d_units;
-    Superclass::WorldToIndex(pt3d_mm, pt3d_units);
-    pt2d_mm[0] = pt3d_units[0] * GetExtentInMM(0) / GetExtent(0);
-    pt2d_mm[1] = pt3d_units[1] * GetExtentInMM(1) / GetExtent(1);
-    pt3d_units[2]=0;
-    return const_cast<BoundingBox*>(this->GetBoundingBox())->IsInside(pt3d_units);
+    return PlaneGeometry::Map(&pt3d_mm, &pt2d_mm, 1);
   }
 
   void
   PlaneGeometry::Map(const mitk::Point2D &pt2d_mm, mitk::Point3D &pt3d_mm) const
   {
-    //pt2d_mm is measured from the origin of the world geometry (at leats it called form BaseRendere::Mouse...Event)
-    Point3D pt3d_units;
-    pt3d_units[0] = pt2d_mm[0] / (GetExtentInMM(0) / GetExtent(0));
-    pt3d_units[1] = pt2d_mm[1] / (GetExtentInMM(1) / GetExtent(1));
-    pt3d_units[2]=0;
-    //pt3d_units is a continuos index. We divided it with the Scale Factor (= spacing in x and y) to convert it from mm to index units.
-    //
-    pt3d_mm = GetIndexToWorldTransform()->TransformPoint(pt3d_units);
-    //now we convert the 3d index to a 3D world point in mm. We could have used IndexToWorld as well as GetITW->Transform...
+    PlaneGeometry::Map(&pt2d_mm, &pt3d_mm, 1);
+  }
+
+  bool PlaneGeometry::Map(const mitk::Point3D *pts3d_mm, mitk::Point2D *pts2d_mm, std::size_t count) const
+  {
+    assert(this->IsBoundingBoxNull()==false);
+
+    const TransformCachePointer cachePointer = this->GetTransformCache();
+    const TransformCache& cache = *cachePointer;
+    const ScalarType (&m)[3][3] = cache.InverseMatrix;
+    const BoundingBox::BoundsArrayType& bounds = this->GetBoundingBox()->GetBounds();
+    // the index z coordinate is set to 0 before the inside check
+    bool allInside = bounds[4] <= 0 && 0 <= bounds[5];
+
+    for (std::size_t n = 0; n < count; ++n)
+    {
+      const ScalarType x = pts3d_mm[n][0] - cache.Offset[0];
+      const ScalarType y = pts3d_mm[n][1] - cache.Offset[1];
+      const ScalarType z = pts3d_mm[n][2] - cache.Offset[2];
+      const ScalarType u = m[0][0] * x + m[0][1] * y + m[0][2] * z;
+      const ScalarType v = m[1][0] * x + m[1][1] * y + m[1][2] * z;
+      // the scale factor (mm per unit) is the length of the axis
+      pts2d_mm[n][0] = u * cache.ColumnNorms[0];
+      pts2d_mm[n][1] = v * cache.ColumnNorms[1];
+      allInside = allInside && bounds[0] <= u && u <= bounds[1] && bounds[2] <= v && v <= bounds[3];
+    }
+    return allInside;
+  }
+
+  void PlaneGeometry::Map(const mitk::Point2D *pts2d_mm, mitk::Point3D *pts3d_mm, std::size_t count) const
+  {
+    const TransformCachePointer cachePointer = this->GetTransformCache();
+    const TransformCache& cache = *cachePointer;
+    const ScalarType (&m)[3][3] = cache.Matrix;
+
+    for (std::size_t n = 0; n < count; ++n)
+    {
+      //pts2d_mm is measured from the origin of the world geometry (at leats it called form BaseRendere::Mouse...Event)
+      //divided by the scale factor (= spacing in x and y) it is a continuous index with z = 0
+      const ScalarType u = pts2d_mm[n][0] / cache.ColumnNorms[0];
+      const ScalarType v = pts2d_mm[n][1] / cache.ColumnNorms[1];
+      pts3d_mm[n][0] = m[0][0] * u + m[0][1] * v + cache.Offset[0];
+      pts3d_mm[n][1] = m[1][0] * u + m[1][1] * v + cache.Offset[1];
+      pts3d_mm[n][2] = m[2][0] * u + m[2][1] * v + cache.Offset[2];
+    }
   }
 
   void
@@ -1003,14 +1055,35 @@ namespace mitk
   bool
   PlaneGeometry::Project(
       const mitk::Point3D &pt3d_mm, mitk::Point3D &projectedPt3d_mm) const
+  {
+    return PlaneGeometry::Project(&pt3d_mm, &projectedPt3d_mm, 1);
+  }
+
+  bool
+  PlaneGeometry::Project(const mitk::Point3D *pts3d_mm, mitk::Point3D *projectedPts3d_mm, std::size_t count) const
   {
     assert(this->IsBoundingBoxNull()==false);
 
-    Point3D pt3d_units;
-    Superclass::WorldToIndex(pt3d_mm, pt3d_units);
-    pt3d_units[2] = 0;
-    projectedPt3d_mm = GetIndexToWorldTransform()->TransformPoint(pt3d_units);
-    return const_cast<BoundingBox*>(this->GetBoundingBox())->IsInside(pt3d_units);
+    const TransformCachePointer cachePointer = this->GetTransformCache();
+    const TransformCache& cache = *cachePointer;
+    const ScalarType (&inverse)[3][3] = cache.InverseMatrix;
+    const ScalarType (&m)[3][3] = cache.Matrix;
+    const BoundingBox::BoundsArrayType& bounds = this->GetBoundingBox()->GetBounds();
+    bool allInside = bounds[4] <= 0 && 0 <= bounds[5];
+
+    for (std::size_t n = 0; n < count; ++n)
+    {
+      const ScalarType x = pts3d_mm[n][0] - cache.Offset[0];
+      const ScalarType y = pts3d_mm[n][1] - cache.Offset[1];
+      const ScalarType z = pts3d_mm[n][2] - cache.Offset[2];
+      const ScalarType u = inverse[0][0] * x + inverse[0][1] * y + inverse[0][2] * z;
+      const ScalarType v = inverse[1][0] * x + inverse[1][1] * y + inverse[1][2] * z;
+      projectedPts3d_mm[n][0] = m[0][0] * u + m[0][1] * v + cache.Offset[0];
+      projectedPts3d_mm[n][1] = m[1][0] * u + m[1][1] * v + cache.Offset[1];
+      projectedPts3d_mm[n][2] = m[2][0] * u + m[2][1] * v + cache.Offset[2];
+      allInside = allInside && bounds[0] <= u && u <= bounds[1] && bounds[2] <= v && v <= bounds[3];
+    }
+    return allInside;
   }
 
   bool
@@ -19,6 +19,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkSurfaceOperation.h"
 
 #include <algorithm>
+#include <chrono>
 #include <vtkPolyData.h>
 
 static vtkSmartPointer<vtkPolyData> DeepCopy(vtkPolyData* other)
@@ -67,6 +68,7 @@ void mitk::Surface::Swap(mitk::Surface& other)
   std::swap(m_LargestPossibleRegion, other.m_LargestPossibleRegion);
   std::swap(m_RequestedRegion, other.m_RequestedRegion);
   std::swap(m_CalculateBoundingBox, other.m_CalculateBoundingBox);
+  std::swap(m_LevelsOfDetail, other.m_LevelsOfDetail);
 }
 
 mitk::Surface& mitk::Surface::operator=(Surface other)
@@ -83,6 +85,7 @@ mitk::Surface::~Surface()
 void mitk::Surface::ClearData()
 {
   m_PolyDatas.clear();
+  m_LevelsOfDetail.clear();
 
   Superclass::ClearData();
 }
@@ -122,6 +125,7 @@ void mitk::Surface::SetVtkPolyData(vtkPolyData* polyData, unsigned int t)
   }
 
   m_PolyDatas[t].TakeReference(polyData);
+  m_LevelsOfDetail.erase(t);
 
   if(polyData != nullptr)
     polyData->Register(nullptr);
@@ -328,6 +332,84 @@ unsigned int mitk::Surface::GetSizeOfPolyDataSeries() const
   return m_PolyDatas.size();
 }
 
+void mitk::Surface::SetLevelsOfDetail(std::vector<LevelOfDetailFuture> levels, unsigned int t)
+{
+  vtkPolyData* polyData = this->GetVtkPolyData(t);
+
+  if (polyData == nullptr)
+    mitkThrow() << "Surface has no polydata at time step " << t << " to attach levels of detail to.";
+
+  LevelsOfDetail& levelsOfDetail = m_LevelsOfDetail[t];
+  levelsOfDetail.Finished.clear();
+  levelsOfDetail.Pending.clear();
+  for (auto& level : levels)
+  {
+    levelsOfDetail.Pending.push_back(std::move(level));
+  }
+  levelsOfDetail.PolyDataMTime = polyData->GetMTime();
+}
+
+const std::vector< vtkSmartPointer<vtkPolyData> >* mitk::Surface::GetFinishedLevelsOfDetail(unsigned int t) const
+{
+  auto it = m_LevelsOfDetail.find(t);
+
+  if (it == m_LevelsOfDetail.end())
+    return nullptr;
+
+  LevelsOfDetail& levelsOfDetail = it->second;
+
+  if (t >= m_PolyDatas.size() || m_PolyDatas[t] == nullptr || m_PolyDatas[t]->GetMTime() != levelsOfDetail.PolyDataMTime)
+  {
+    // the levels do not match the polydata anymore
+    m_LevelsOfDetail.erase(it);
+    return nullptr;
+  }
+
+  while (!levelsOfDetail.Pending.empty() &&
+         levelsOfDetail.Pending.front().wait_for(std::chrono::seconds(0)) != std::future_status::timeout)
+  {
+    LevelOfDetailFuture level = std::move(levelsOfDetail.Pending.front());
+    levelsOfDetail.Pending.pop_front();
+
+    try
+    {
+      vtkSmartPointer<vtkPolyData> polyData = level.get();
+
+      if (polyData != nullptr)
+        levelsOfDetail.Finished.push_back(polyData);
+    }
+    catch (const std::exception& e)
+    {
+      MITK_WARN << "Level of detail of time step " << t << " could not be computed: " << e.what();
+      levelsOfDetail.Pending.clear();
+    }
+  }
+
+  return &levelsOfDetail.Finished;
+}
+
+unsigned int mitk::Surface::GetNumberOfLevelsOfDetail(unsigned int t) const
+{
+  if (t >= m_PolyDatas.size() || m_PolyDatas[t] == nullptr)
+    return 0;
+
+  const std::vector< vtkSmartPointer<vtkPolyData> >* finishedLevels = this->GetFinishedLevelsOfDetail(t);
+
+  return finishedLevels != nullptr
+    ? static_cast<unsigned int>(finishedLevels->size()) + 1
+    : 1;
+}
+
+vtkPolyData* mitk::Surface::GetLevelOfDetail(unsigned int level, unsigned int t) const
+{
+  const std::vector< vtkSmartPointer<vtkPolyData> >* finishedLevels = this->GetFinishedLevelsOfDetail(t);
+
+  if (finishedLevels != nullptr && level < finishedLevels->size())
+    return (*finishedLevels)[level];
+
+  return this->GetVtkPolyData(t);
+}
+
 void mitk::Surface::Graft(const DataObject* data)
 {
   const Surface* surface = dynamic_cast<const Surface*>(data);
@@ -337,6 +419,7 @@ void mitk::Surface::Graft(const DataObject* data)
 
   this->CopyInformation(data);
   m_PolyDatas.clear();
+  m_LevelsOfDetail.clear();
 
   for (unsigned int i = 0; i < surface->GetSizeOfPolyDataSeries(); ++i)
   {
@@ -0,0 +1,239 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkChunkedGzip.h"
+#include "mitkExceptionMacro.h"
+
+#include "itk_zlib.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+  // ID1 ID2 CM FLG(FEXTRA) MTIME(4) XFL OS(unknown) XLEN(2), followed by the subfield 'M' 'K' LEN(2) and the member size (4)
+  const std::size_t HeaderSize = 20;
+  const std::size_t TrailerSize = 8;
+  const std::size_t ExtraFieldSize = 8;
+  const unsigned char FlagExtra = 0x04;
+
+  // compressed chunks that are buffered before they are written
+  const int ChunksPerBatch = 32;
+
+  struct Member
+  {
+    std::size_t Offset;
+    std::size_t Size;
+    std::size_t OutputOffset;
+    std::size_t OutputSize;
+  };
+
+  void PutUInt16(unsigned char* buffer, unsigned int value)
+  {
+    buffer[0] = static_cast<unsigned char>(value & 0xff);
+    buffer[1] = static_cast<unsigned char>((value >> 8) & 0xff);
+  }
+
+  void PutUInt32(unsigned char* buffer, unsigned long value)
+  {
+    PutUInt16(buffer, static_cast<unsigned int>(value & 0xffff));
+    PutUInt16(buffer + 2, static_cast<unsigned int>((value >> 16) & 0xffff));
+  }
+
+  unsigned int GetUInt16(const unsigned char* buffer)
+  {
+    return buffer[0] | (static_cast<unsigned int>(buffer[1]) << 8);
+  }
+
+  unsigned long GetUInt32(const unsigned char* buffer)
+  {
+    return GetUInt16(buffer) | (static_cast<unsigned long>(GetUInt16(buffer + 2)) << 16);
+  }
+
+  /// Size of the member that starts at header, 0 if it was not written by ChunkedGzip.
+  std::size_t GetMemberSize(const unsigned char* header, std::size_t size)
+  {
+    if (size < HeaderSize || header[0] != 0x1f || header[1] != 0x8b || header[2] != Z_DEFLATED || header[3] != FlagExtra ||
+        GetUInt16(header + 10) != ExtraFieldSize || header[12] != 'M' || header[13] != 'K' || GetUInt16(header + 14) != 4)
+    {
+      return 0;
+    }
+    const std::size_t memberSize = GetUInt32(header + 16);
+    return memberSize >= HeaderSize + TrailerSize ? memberSize : 0;
+  }
+
+  /// Compresses one chunk into a complete gzip member, false if zlib fails.
+  bool CompressMember(const unsigned char* data, std::size_t size, int level, std::vector<unsigned char>& member)
+  {
+    z_stream stream;
+    stream.zalloc = Z_NULL;
+    stream.zfree = Z_NULL;
+    stream.opaque = Z_NULL;
+    // negative window bits: raw deflate data, the gzip header is written here to add the member size
+    if (deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+      return false;
+    }
+
+    member.resize(HeaderSize + deflateBound(&stream, static_cast<uLong>(size)) + TrailerSize);
+    stream.next_in = const_cast<Bytef*>(data);
+    stream.avail_in = static_cast<uInt>(size);
+    stream.next_out = member.data() + HeaderSize;
+    stream.avail_out = static_cast<uInt>(member.size() - HeaderSize - TrailerSize);
+    const int result = deflate(&stream, Z_FINISH);
+    const std::size_t compressedSize = stream.total_out;
+    deflateEnd(&stream);
+    if (result != Z_STREAM_END)
+    {
+      return false;
+    }
+
+    member.resize(HeaderSize + compressedSize + TrailerSize);
+    unsigned char* header = member.data();
+    std::fill(header, header + HeaderSize, 0);
+    header[0] = 0x1f;
+    header[1] = 0x8b;
+    header[2] = Z_DEFLATED;
+    header[3] = FlagExtra;
+    header[9] = 255;
+    PutUInt16(header + 10, ExtraFieldSize);
+    header[12] = 'M';
+    header[13] = 'K';
+    PutUInt16(header + 14, 4);
+    PutUInt32(header + 16, static_cast<unsigned long>(member.size()));
+
+    unsigned char* trailer = header + HeaderSize + compressedSize;
+    PutUInt32(trailer, crc32(crc32(0L, Z_NULL, 0), data, static_cast<uInt>(size)));
+    PutUInt32(trailer + 4, static_cast<unsigned long>(size));
+    return true;
+  }
+
+  /// Inflates one member into exactly member.OutputSize bytes of output and checks its CRC.
+  bool DecompressMember(const unsigned char* data, const Member& member, unsigned char* output)
+  {
+    z_stream stream;
+    stream.zalloc = Z_NULL;
+    stream.zfree = Z_NULL;
+    stream.opaque = Z_NULL;
+    stream.next_in = Z_NULL;
+    stream.avail_in = 0;
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+    {
+      return false;
+    }
+
+    stream.next_in = const_cast<Bytef*>(data + member.Offset + HeaderSize);
+    stream.avail_in = static_cast<uInt>(member.Size - HeaderSize - TrailerSize);
+    // zlib refuses a null output buffer, even for empty members
+    unsigned char emptyOutput;
+    stream.next_out = member.OutputSize != 0 ? output + member.OutputOffset : &emptyOutput;
+    stream.avail_out = static_cast<uInt>(member.OutputSize);
+    const int result = inflate(&stream, Z_FINISH);
+    const bool complete = result == Z_STREAM_END && stream.total_out == member.OutputSize;
+    inflateEnd(&stream);
+
+    const unsigned char* trailer = data + member.Offset + member.Size - TrailerSize;
+    return complete &&
+      crc32(crc32(0L, Z_NULL, 0), output + member.OutputOffset, static_cast<uInt>(member.OutputSize)) == GetUInt32(trailer);
+  }
+}
+
+const std::size_t mitk::ChunkedGzip::DefaultChunkSize = 1 << 20;
+
+void mitk::ChunkedGzip::Compress(const void* data, std::size_t size, std::ostream& out, int level, std::size_t chunkSize)
+{
+  // the size of a member has to fit into the 32 bit size fields of the header and the trailer
+  chunkSize = std::max<std::size_t>(1, std::min<std::size_t>(chunkSize, 1 << 30));
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  const std::size_t numberOfChunks = std::max<std::size_t>(1, (size + chunkSize - 1) / chunkSize);
+
+  std::vector< std::vector<unsigned char> > members(ChunksPerBatch);
+  for (std::size_t batchBegin = 0; batchBegin < numberOfChunks; batchBegin += ChunksPerBatch)
+  {
+    const int batchSize = static_cast<int>(std::min<std::size_t>(ChunksPerBatch, numberOfChunks - batchBegin));
+    bool failed = false;
+
+#pragma omp parallel for schedule(dynamic) reduction(||:failed)
+    for (int i = 0; i < batchSize; ++i)
+    {
+      const std::size_t begin = (batchBegin + i) * chunkSize;
+      const std::size_t end = std::min(size, begin + chunkSize);
+      failed = !CompressMember(bytes + begin, end - begin, level, members[i]) || failed;
+    }
+
+    if (failed)
+    {
+      mitkThrow() << "Compressing chunk " << batchBegin << " to " << (batchBegin + batchSize) << " failed.";
+    }
+    for (int i = 0; i < batchSize; ++i)
+    {
+      out.write(reinterpret_cast<const char*>(members[i].data()), members[i].size());
+    }
+    if (!out)
+    {
+      mitkThrow() << "Writing compressed data failed.";
+    }
+  }
+}
+
+bool mitk::ChunkedGzip::IsChunked(const void* data, std::size_t size)
+{
+  return GetMemberSize(static_cast<const unsigned char*>(data), size) != 0;
+}
+
+bool mitk::ChunkedGzip::Decompress(const void* data, std::size_t size, void* output, std::size_t outputSize)
+{
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+  // the member sizes in the headers and the uncompressed sizes in the trailers locate all members
+  std::vector<Member> members;
+  std::size_t outputOffset = 0;
+  for (std::size_t offset = 0; offset < size;)
+  {
+    Member member;
+    member.Offset = offset;
+    member.Size = GetMemberSize(bytes + offset, size - offset);
+    if (member.Size == 0 || member.Size > size - offset)
+    {
+      return false;
+    }
+    member.OutputOffset = outputOffset;
+    member.OutputSize = GetUInt32(bytes + offset + member.Size - 4);
+    if (member.OutputSize > outputSize - outputOffset)
+    {
+      return false;
+    }
+    members.push_back(member);
+    offset += member.Size;
+    outputOffset += member.OutputSize;
+  }
+  if (outputOffset != outputSize)
+  {
+    return false;
+  }
+
+  unsigned char* outputBytes = static_cast<unsigned char*>(output);
+  const int numberOfMembers = static_cast<int>(members.size());
+  bool failed = false;
+
+#pragma omp parallel for schedule(dynamic) reduction(||:failed)
+  for (int i = 0; i < numberOfMembers; ++i)
+  {
+    failed = !DecompressMember(bytes, members[i], outputBytes) || failed;
+  }
+
+  return !failed;
+}
@@ -27,6 +27,33 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "itksys/SystemTools.hxx"
 
+#include <itkSimpleFastMutexLock.h>
+#include <itkMutexLockHolder.h>
+
+namespace {
+
+struct CachedReaderReferences
+{
+  long m_Generation;
+  std::vector<mitk::FileReaderRegistry::ReaderReference> m_References;
+};
+
+typedef std::map<std::pair<us::ModuleContext*, std::string>, CachedReaderReferences> ReaderReferenceCacheType;
+
+itk::SimpleFastMutexLock& s_ReaderReferenceCacheMutex()
+{
+  static itk::SimpleFastMutexLock mutex;
+  return mutex;
+}
+
+ReaderReferenceCacheType& s_ReaderReferenceCache()
+{
+  static ReaderReferenceCacheType cache;
+  return cache;
+}
+
+}
+
 mitk::FileReaderRegistry::FileReaderRegistry()
 {
 }
@@ -61,9 +88,27 @@ std::vector<mitk::FileReaderRegistry::ReaderReference> mitk::FileReaderRegistry:
 {
   if (context == NULL) context = us::GetModuleContext();
 
+  // the references stay valid until a service is registered, unregistered or modified
+  const long generation = context->GetServiceRegistryGeneration();
+  const std::pair<us::ModuleContext*, std::string> key(context, mimeType.GetName());
+  {
+    itk::MutexLockHolder<itk::SimpleFastMutexLock> l(s_ReaderReferenceCacheMutex());
+    ReaderReferenceCacheType::const_iterator iter = s_ReaderReferenceCache().find(key);
+    if (iter != s_ReaderReferenceCache().end() && iter->second.m_Generation == generation)
+    {
+      return iter->second.m_References;
+    }
+  }
+
   std::string filter = us::LDAPProp(us::ServiceConstants::OBJECTCLASS()) == us_service_interface_iid<IFileReader>() &&
                        us::LDAPProp(IFileReader::PROP_MIMETYPE()) == mimeType.GetName();
-  return context->GetServiceReferences<IFileReader>(filter);
+  CachedReaderReferences cached;
+  cached.m_Generation = generation;
+  cached.m_References = context->GetServiceReferences<IFileReader>(filter);
+
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> l(s_ReaderReferenceCacheMutex());
+  s_ReaderReferenceCache()[key] = cached;
+  return cached.m_References;
 }
 
 mitk::IFileReader* mitk::FileReaderRegistry::GetReader(const mitk::FileReaderRegistry::ReaderReference& ref, us::ModuleContext* context)
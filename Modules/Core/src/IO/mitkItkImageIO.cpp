@@ -25,14 +25,27 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkCoreServices.h>
 #include <mitkIPropertyPersistence.h>
 #include <mitkArbitraryTimeGeometry.h>
+#include <mitkMemoryMappedFile.h>
+#include <mitkChunkedGzip.h>
+#include <mitkIOUtil.h>
 
 #include <itkImage.h>
 #include <itkImageIOFactory.h>
 #include <itkImageFileReader.h>
 #include <itkImageIORegion.h>
 #include <itkMetaDataObject.h>
+#include <itkByteSwapper.h>
+
+#include <itksys/Directory.hxx>
+#include <itksys/SystemTools.hxx>
 
 #include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <sstream>
 
 namespace mitk {
 
@@ -210,6 +223,409 @@ std::vector<TimePointType> ConvertMetaDataObjectToTimePointList(const itk::MetaD
   return result;
 };
 
+/**Helper function that trims white space and a trailing carriage return from a header line or value.*/
+static std::string TrimHeaderString(const std::string& text)
+{
+  const std::string::size_type begin = text.find_first_not_of(" \t\r");
+  if (begin == std::string::npos)
+  {
+    return std::string();
+  }
+  return text.substr(begin, text.find_last_not_of(" \t\r") - begin + 1);
+}
+
+/**Helper function that resolves a data file name of a detached header relative to the directory of the header.
+ * Returns an empty string for lists and numbered file patterns, which are spread over several files.*/
+static std::string GetDetachedDataFileName(const std::string& headerFileName, const std::string& dataFileName)
+{
+  if (dataFileName.empty() || dataFileName.compare(0, 4, "LIST") == 0 ||
+      dataFileName.find('%') != std::string::npos || dataFileName.find_first_of(" \t") != std::string::npos)
+  {
+    return std::string();
+  }
+  if (itksys::SystemTools::FileIsFullPath(dataFileName.c_str()))
+  {
+    return dataFileName;
+  }
+  return itksys::SystemTools::GetFilenamePath(headerFileName) + "/" + dataFileName;
+}
+
+/**Helper function that reads the fields of a NRRD header, except key/value pairs, with lower case names without spaces.
+ * dataOffset is the offset of the data in dataFileName without a byte skip. Returns false if path is no NRRD file
+ * or the data is spread over several files.*/
+static bool ReadNrrdHeader(const std::string& path, std::map<std::string, std::string>& fields,
+                           std::string& dataFileName, long long& dataOffset)
+{
+  std::ifstream header(path.c_str(), std::ios::binary);
+  std::string line;
+  if (!std::getline(header, line) || line.compare(0, 4, "NRRD") != 0)
+  {
+    return false;
+  }
+
+  while (std::getline(header, line))
+  {
+    line = TrimHeaderString(line);
+    if (line.empty())
+    {
+      break;
+    }
+    const std::string::size_type separator = line.find(": ");
+    if (line[0] == '#' || separator == std::string::npos)
+    {
+      // comments and key/value pairs ("key:=value")
+      continue;
+    }
+    std::string key = line.substr(0, separator);
+    key.erase(std::remove(key.begin(), key.end(), ' '), key.end());
+    std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+    fields[key] = TrimHeaderString(line.substr(separator + 2));
+  }
+
+  dataFileName.clear();
+  dataOffset = -1;
+  if (fields.count("datafile") != 0)
+  {
+    dataFileName = GetDetachedDataFileName(path, fields["datafile"]);
+    dataOffset = 0;
+  }
+  else if (header)
+  {
+    dataFileName = path;
+    dataOffset = header.tellg();
+  }
+  return !dataFileName.empty() && dataOffset >= 0;
+}
+
+/**Helper function that checks whether the data of a NRRD file can be used without byte swapping and
+ * without moving the pixel components, which the ImageIO takes from a non spatial axis of the file.*/
+static bool HasNativeNrrdLayout(std::map<std::string, std::string>& fields, std::size_t componentSize, unsigned int numberOfComponents)
+{
+  if (componentSize > 1 && fields["endian"] != (itk::ByteSwapper<int>::SystemIsBigEndian() ? "big" : "little"))
+  {
+    return false;
+  }
+  if (numberOfComponents > 1)
+  {
+    // the components have to be the first (fastest) axis
+    std::istringstream kinds(fields["kinds"]);
+    std::string firstKind;
+    kinds >> firstKind;
+    return !firstKind.empty() && firstKind != "domain" && firstKind != "space" && firstKind != "time";
+  }
+  return true;
+}
+
+/**Helper function that determines where the pixels of an uncompressed NRRD file in native byte order are stored.
+ * Returns false for every file that the ImageIO has to decode itself.*/
+static bool GetNrrdRawDataLocation(const std::string& path, std::size_t componentSize, unsigned int numberOfComponents,
+                                   std::size_t dataSize, std::string& dataFileName, long long& dataOffset)
+{
+  std::map<std::string, std::string> fields;
+  if (!ReadNrrdHeader(path, fields, dataFileName, dataOffset) ||
+      fields["encoding"] != "raw" || atoi(fields["lineskip"].c_str()) != 0 ||
+      !HasNativeNrrdLayout(fields, componentSize, numberOfComponents))
+  {
+    return false;
+  }
+
+  const long long byteSkip = atoll(fields["byteskip"].c_str());
+  if (byteSkip == -1)
+  {
+    dataOffset = static_cast<long long>(itksys::SystemTools::FileLength(dataFileName.c_str())) - static_cast<long long>(dataSize);
+  }
+  else
+  {
+    dataOffset += byteSkip;
+  }
+  return byteSkip >= -1;
+}
+
+/**Helper function that determines where the pixels of an uncompressed MetaImage file in native byte order are stored.
+ * Returns false for every file that the ImageIO has to decode itself.*/
+static bool GetMetaImageRawDataLocation(const std::string& path, std::size_t componentSize, std::size_t dataSize,
+                                        std::string& dataFileName, long long& dataOffset)
+{
+  std::ifstream header(path.c_str(), std::ios::binary);
+  std::map<std::string, std::string> fields;
+  std::string line;
+  while (std::getline(header, line))
+  {
+    const std::string::size_type separator = line.find('=');
+    if (separator == std::string::npos)
+    {
+      continue;
+    }
+    const std::string key = TrimHeaderString(line.substr(0, separator));
+    fields[key] = TrimHeaderString(line.substr(separator + 1));
+    if (key == "ElementDataFile")
+    {
+      // the last field of the header
+      break;
+    }
+  }
+
+  auto isTrue = [&fields](const char* key) {
+    std::string value = fields[key];
+    std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+    return value == "true" || value == "1";
+  };
+
+  if (isTrue("CompressedData") || (fields.count("BinaryData") != 0 && !isTrue("BinaryData")))
+  {
+    return false;
+  }
+  if (componentSize > 1)
+  {
+    const bool msb = fields.count("ElementByteOrderMSB") != 0 ? isTrue("ElementByteOrderMSB") : isTrue("BinaryDataByteOrderMSB");
+    if (msb != itk::ByteSwapper<int>::SystemIsBigEndian())
+    {
+      return false;
+    }
+  }
+
+  const long long headerSize = atoll(fields["HeaderSize"].c_str());
+  if (fields["ElementDataFile"] == "LOCAL")
+  {
+    dataFileName = path;
+    dataOffset = header ? static_cast<long long>(header.tellg()) : -1;
+    if (headerSize != 0 || dataOffset < 0)
+    {
+      return false;
+    }
+    return true;
+  }
+
+  dataFileName = GetDetachedDataFileName(path, fields["ElementDataFile"]);
+  if (dataFileName.empty() || headerSize < -1)
+  {
+    return false;
+  }
+  dataOffset = headerSize == -1
+    ? static_cast<long long>(itksys::SystemTools::FileLength(dataFileName.c_str())) - static_cast<long long>(dataSize)
+    : headerSize;
+  return true;
+}
+
+/**Helper function that maps the pixels of uncompressed NRRD and MetaImage files instead of reading them.
+ * Returns nullptr if the ImageIO has to read the file, e.g. because it is compressed, has to be byte swapped
+ * or the pixels would not be aligned in memory.*/
+static MemoryMappedFile::Pointer MapRawImageData(itk::ImageIOBase* imageIO, const std::string& path)
+{
+  const std::string ioName = imageIO->GetNameOfClass();
+  const std::size_t componentSize = imageIO->GetComponentSize();
+  const std::size_t dataSize = imageIO->GetImageSizeInBytes();
+
+  std::string dataFileName;
+  long long dataOffset = -1;
+  bool isRaw = false;
+  if (ioName == "NrrdImageIO")
+  {
+    isRaw = GetNrrdRawDataLocation(path, componentSize, imageIO->GetNumberOfComponents(), dataSize, dataFileName, dataOffset);
+  }
+  else if (ioName == "MetaImageIO")
+  {
+    isRaw = GetMetaImageRawDataLocation(path, componentSize, dataSize, dataFileName, dataOffset);
+  }
+
+  if (!isRaw || dataOffset < 0 || componentSize == 0 || dataOffset % static_cast<long long>(componentSize) != 0)
+  {
+    return nullptr;
+  }
+  return MemoryMappedFile::Map(dataFileName, static_cast<std::size_t>(dataOffset), dataSize);
+}
+
+/**Helper function that decompresses the pixels of gzip encoded NRRD files written by WriteChunkedGzipNrrd() in parallel.
+ * Returns false if the ImageIO has to read the file, e.g. because it was compressed by another writer.*/
+static bool ReadChunkedGzipNrrdData(itk::ImageIOBase* imageIO, const std::string& path, void* buffer)
+{
+  std::map<std::string, std::string> fields;
+  std::string dataFileName;
+  long long dataOffset = -1;
+  if (std::string(imageIO->GetNameOfClass()) != "NrrdImageIO" ||
+      !ReadNrrdHeader(path, fields, dataFileName, dataOffset) ||
+      (fields["encoding"] != "gzip" && fields["encoding"] != "gz") ||
+      atoi(fields["lineskip"].c_str()) != 0 || atoll(fields["byteskip"].c_str()) != 0 ||
+      !HasNativeNrrdLayout(fields, imageIO->GetComponentSize(), imageIO->GetNumberOfComponents()))
+  {
+    return false;
+  }
+
+  const long long fileSize = static_cast<long long>(itksys::SystemTools::FileLength(dataFileName.c_str()));
+  std::ifstream dataStream(dataFileName.c_str(), std::ios::binary);
+  char memberHeader[32];
+  dataStream.seekg(dataOffset);
+  dataStream.read(memberHeader, sizeof(memberHeader));
+  if (fileSize <= dataOffset || !ChunkedGzip::IsChunked(memberHeader, static_cast<std::size_t>(dataStream.gcount())))
+  {
+    return false;
+  }
+
+  const std::size_t compressedSize = static_cast<std::size_t>(fileSize - dataOffset);
+  MemoryMappedFile::Pointer compressedData = MemoryMappedFile::Map(dataFileName, static_cast<std::size_t>(dataOffset), compressedSize);
+  if (compressedData.IsNotNull())
+  {
+    return ChunkedGzip::Decompress(compressedData->GetData(), compressedSize, buffer, imageIO->GetImageSizeInBytes());
+  }
+
+  std::vector<char> compressedBuffer(compressedSize);
+  dataStream.clear();
+  dataStream.seekg(dataOffset);
+  dataStream.read(compressedBuffer.data(), compressedSize);
+  return dataStream && ChunkedGzip::Decompress(compressedBuffer.data(), compressedSize, buffer, imageIO->GetImageSizeInBytes());
+}
+
+/**Helper function that returns the field name of a line of a NRRD header in lower case without spaces, an empty
+ * string for comments and key/value pairs.*/
+static std::string GetNrrdFieldName(const std::string& line)
+{
+  const std::string::size_type separator = line.find(": ");
+  if (line.empty() || line[0] == '#' || separator == std::string::npos || line.find(":=") < separator)
+  {
+    return std::string();
+  }
+  std::string name = line.substr(0, separator);
+  name.erase(std::remove(name.begin(), name.end(), ' '), name.end());
+  std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+  return name;
+}
+
+/**Helper function that writes gzip encoded NRRD files with the header the ImageIO writes, but compresses
+ * the pixels in independent chunks in parallel (see ChunkedGzip). Every NRRD reader can read these files.
+ *
+ * The ImageIO writes a detached, uncompressed header next to path, so that all fields (including the "NRRD_..."
+ * meta data like the measurement frame) are written exactly like the ImageIO does. It writes the header of an
+ * image with a single pixel, so its data file only holds one pixel. The sizes, data file and encoding of the
+ * header are replaced by those of the compressed pixels. Returns false if the ImageIO has to write the file itself,
+ * e.g. for detached headers.*/
+static bool WriteChunkedGzipNrrd(itk::ImageIOBase* imageIO, const std::string& path, const void* buffer)
+{
+  if (std::string(imageIO->GetNameOfClass()) != "NrrdImageIO" || !imageIO->GetUseCompression() ||
+      itksys::SystemTools::LowerCase(itksys::SystemTools::GetFilenameLastExtension(path)) == ".nhdr")
+  {
+    return false;
+  }
+
+  const unsigned int dimension = imageIO->GetNumberOfDimensions();
+  std::vector<itk::ImageIOBase::SizeValueType> dimensions(dimension);
+  for (unsigned int i = 0; i < dimension; ++i)
+  {
+    dimensions[i] = imageIO->GetDimensions(i);
+  }
+  auto restoreImageIO = [&]() {
+    for (unsigned int i = 0; i < dimension; ++i)
+    {
+      imageIO->SetDimensions(i, dimensions[i]);
+    }
+    imageIO->SetFileName(path);
+    imageIO->UseCompressionOn();
+  };
+
+  // the header of a single pixel image, its detached data file is deleted right away
+  const std::string headerPath = path + "-header.nhdr";
+  for (unsigned int i = 0; i < dimension; ++i)
+  {
+    imageIO->SetDimensions(i, 1);
+  }
+  imageIO->SetFileName(headerPath);
+  imageIO->UseCompressionOff();
+  try
+  {
+    imageIO->Write(buffer);
+  }
+  catch (...)
+  {
+    restoreImageIO();
+    throw;
+  }
+  restoreImageIO();
+
+  std::map<std::string, std::string> fields;
+  std::string dataFileName;
+  long long dataOffset = -1;
+  const bool isDetached = ReadNrrdHeader(headerPath, fields, dataFileName, dataOffset) && dataFileName != headerPath;
+  if (isDetached)
+  {
+    std::remove(dataFileName.c_str());
+  }
+
+  bool isValidHeader = isDetached && fields.count("sizes") != 0;
+  std::ostringstream header;
+  std::ifstream headerStream(headerPath.c_str(), std::ios::binary);
+  std::string line;
+  while (isDetached && std::getline(headerStream, line) && !TrimHeaderString(line).empty())
+  {
+    const std::string fieldName = GetNrrdFieldName(TrimHeaderString(line));
+    if (fieldName == "encoding")
+    {
+      header << "encoding: gzip\n";
+    }
+    else if (fieldName == "sizes")
+    {
+      // the axis of the pixel components comes first and keeps its size, the image axes had a size of one
+      std::istringstream sizes(fields["sizes"]);
+      std::vector<std::string> axisSizes((std::istream_iterator<std::string>(sizes)), std::istream_iterator<std::string>());
+      isValidHeader = isValidHeader && axisSizes.size() >= dimension;
+      header << "sizes:";
+      for (std::size_t i = 0; i < axisSizes.size(); ++i)
+      {
+        const std::size_t imageAxis = i + dimension - axisSizes.size();
+        header << " " << (i + dimension >= axisSizes.size() ? std::to_string(dimensions[imageAxis]) : axisSizes[i]);
+      }
+      header << "\n";
+    }
+    else if (fieldName != "datafile" && fieldName != "byteskip" && fieldName != "lineskip")
+    {
+      header << line << "\n";
+    }
+  }
+  headerStream.close();
+  std::remove(headerPath.c_str());
+  if (!isValidHeader || fields["encoding"] != "raw")
+  {
+    mitkThrow() << "The NRRD header written for " << path << " can not be used.";
+  }
+  header << "\n";
+
+  std::ofstream file(path.c_str(), std::ios::binary);
+  if (!file)
+  {
+    mitkThrow() << "Cannot open " << path << " for writing.";
+  }
+  file << header.str();
+  ChunkedGzip::Compress(buffer, imageIO->GetImageSizeInBytes(), file);
+  file.close();
+  if (!file)
+  {
+    mitkThrow() << "Writing " << path << " failed.";
+  }
+  return true;
+}
+
+/**Helper function that renames all files of sourceDirectory into targetDirectory, replacing existing files, and
+ * removes sourceDirectory. Renaming keeps the pages of replaced files that are still mapped valid.*/
+static void MoveFilesInPlace(const std::string& sourceDirectory, const std::string& targetDirectory)
+{
+  itksys::Directory files;
+  if (!files.Load(sourceDirectory))
+  {
+    mitkThrow() << "Cannot list " << sourceDirectory << ".";
+  }
+  for (unsigned long i = 0; i < files.GetNumberOfFiles(); ++i)
+  {
+    const std::string fileName = files.GetFile(i);
+    if (fileName == "." || fileName == "..")
+    {
+      continue;
+    }
+    if (!itksys::SystemTools::RenameFile((sourceDirectory + "/" + fileName).c_str(), (targetDirectory + "/" + fileName).c_str()))
+    {
+      mitkThrow() << "Cannot replace " << targetDirectory << "/" << fileName << ".";
+    }
+  }
+  itksys::SystemTools::RemoveADirectory(sourceDirectory);
+}
+
 std::vector<BaseData::Pointer> ItkImageIO::Read()
 {
   std::vector<BaseData::Pointer> result;
@@ -285,7 +701,21 @@ std::vector<BaseData::Pointer> ItkImageIO::Read()
   MITK_INFO << "ioRegion: " << ioRegion << std::endl;
   m_ImageIO->SetIORegion( ioRegion );
   image->Initialize(MakePixelType(m_ImageIO), ndim, dimensions);
-  m_ImageIO->Read(image->GetVolumeData()->GetData());
+
+  // uncompressed pixels are mapped and read by the operating system when a slice is accessed first
+  MemoryMappedFile::Pointer mappedData;
+  if (m_ImageIO->GetNumberOfDimensions() == ndim)
+  {
+    mappedData = MapRawImageData(m_ImageIO, path);
+  }
+  if (mappedData.IsNull() || !image->SetImportMappedFile(mappedData))
+  {
+    void* buffer = image->GetVolumeData()->GetData();
+    if (!ReadChunkedGzipNrrdData(m_ImageIO, path, buffer))
+    {
+      m_ImageIO->Read(buffer);
+    }
+  }
   
   const itk::MetaDataDictionary& dictionary = m_ImageIO->GetMetaDataDictionary();
 
@@ -494,6 +924,12 @@ void ItkImageIO::Write()
 
   MITK_INFO << "Writing image: " << path << std::endl;
 
+  // The files are written to a new directory next to the target and renamed afterwards. The image may be a
+  // memory mapping of the file it is written to (see Read()), which must be replaced instead of truncated.
+  const std::string directory = itksys::SystemTools::GetFilenamePath(itksys::SystemTools::CollapseFullPath(path));
+  const std::string tmpDirectory = IOUtil::CreateTemporaryDirectory(".mitk-XXXXXX", directory);
+  const std::string tmpPath = tmpDirectory + "/" + itksys::SystemTools::GetFilenameName(path);
+
   try
   {
     // Implementation of writer using itkImageIO directly. This skips the use
@@ -567,7 +1003,7 @@ void ItkImageIO::Write()
     m_ImageIO->UseCompressionOn();
 
     m_ImageIO->SetIORegion(ioRegion);
-    m_ImageIO->SetFileName(path);
+    m_ImageIO->SetFileName(tmpPath);
 
     // Handle time geometry
     const ArbitraryTimeGeometry* arbitraryTG = dynamic_cast<const ArbitraryTimeGeometry*>(image->GetTimeGeometry());
@@ -613,10 +1049,17 @@ void ItkImageIO::Write()
     ImageRegionAccessor accessor(imagePointer);
     ImageAccessLock lock(&accessor);
 
-    m_ImageIO->Write(accessor.getData());
+    // NRRD files are compressed in parallel chunks, all other formats are written by the ImageIO
+    if (!WriteChunkedGzipNrrd(m_ImageIO, tmpPath, accessor.getData()))
+    {
+      m_ImageIO->Write(accessor.getData());
+    }
+
+    MoveFilesInPlace(tmpDirectory, directory);
   }
   catch (const std::exception& e)
   {
+    itksys::SystemTools::RemoveADirectory(tmpDirectory);
     mitkThrow() << e.what();
   }
 }
@@ -0,0 +1,87 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkMemoryMappedFile.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+mitk::MemoryMappedFile::MemoryMappedFile()
+  : m_Mapping(nullptr)
+  , m_MappingSize(0)
+  , m_Data(nullptr)
+  , m_Size(0)
+{
+}
+
+mitk::MemoryMappedFile::~MemoryMappedFile()
+{
+#ifndef _WIN32
+  if (m_Mapping != nullptr)
+  {
+    munmap(m_Mapping, m_MappingSize);
+  }
+#endif
+}
+
+mitk::MemoryMappedFile::Pointer mitk::MemoryMappedFile::Map(const std::string& fileName, std::size_t offset, std::size_t length)
+{
+#ifdef _WIN32
+  return nullptr;
+#else
+  if (length == 0)
+  {
+    return nullptr;
+  }
+
+  const int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    return nullptr;
+  }
+
+  struct stat fileStatus;
+  if (fstat(fd, &fileStatus) != 0 || static_cast<unsigned long long>(fileStatus.st_size) < static_cast<unsigned long long>(offset) + length)
+  {
+    close(fd);
+    return nullptr;
+  }
+
+  // the offset of a mapping has to be a multiple of the page size
+  const std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  const std::size_t pageOffset = offset % pageSize;
+
+  // PROT_WRITE on a MAP_PRIVATE mapping copies written pages, the file itself stays read only
+  void* mapping = mmap(nullptr, length + pageOffset, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, static_cast<off_t>(offset - pageOffset));
+  close(fd);
+  if (mapping == MAP_FAILED)
+  {
+    return nullptr;
+  }
+
+  Pointer result = new MemoryMappedFile();
+  result->UnRegister();
+  result->m_Mapping = mapping;
+  result->m_MappingSize = length + pageOffset;
+  result->m_Data = static_cast<char*>(mapping) + pageOffset;
+  result->m_Size = length;
+  return result;
+#endif
+}
@@ -653,6 +653,8 @@ void mitk::ImageVtkMapper2D::Update(mitk::BaseRenderer* renderer)
 
   data->UpdateOutputInformation();
 
+  this->UpdateProvisionalLevelWindow(renderer);
+
   const DataNode* node = this->GetDataNode();
   LocalStorage* localStorage = m_LSH.GetLocalStorage(renderer);
 
@@ -674,6 +676,46 @@ void mitk::ImageVtkMapper2D::Update(mitk::BaseRenderer* renderer)
   m_LSH.GetLocalStorage(renderer)->m_RenderedBefore = true;
 }
 
+void mitk::ImageVtkMapper2D::UpdateProvisionalLevelWindow(mitk::BaseRenderer* renderer)
+{
+  mitk::DataNode* node = this->GetDataNode();
+  bool provisional = false;
+  if (!node->GetBoolProperty("levelwindow.provisional", provisional, renderer) || !provisional)
+  {
+    return;
+  }
+
+  const mitk::Image* image = this->GetInput();
+  if (image->GetStatistics()->IsComputingInBackground())
+  {
+    return;
+  }
+
+  // update the properties where SetDefaultProperties() has put them, usually not the ones of this renderer
+  if (node->GetPropertyList(renderer)->GetProperty("levelwindow.provisional") == nullptr)
+  {
+    renderer = nullptr;
+  }
+
+  mitk::LevelWindow levelWindow;
+  if (node->GetLevelWindow(levelWindow, renderer, "levelwindow") && !levelWindow.IsFixed())
+  {
+    mitk::LevelWindow autoLevelWindow;
+    autoLevelWindow.SetAuto(image, false, true);
+    if (levelWindow.GetLevel() == levelWindow.GetDefaultLevel() && levelWindow.GetWindow() == levelWindow.GetDefaultWindow())
+    {
+      levelWindow = autoLevelWindow;
+    }
+    else
+    {
+      levelWindow.SetRangeMinMax(autoLevelWindow.GetRangeMin(), autoLevelWindow.GetRangeMax());
+      levelWindow.SetDefaultBoundaries(autoLevelWindow.GetDefaultLowerBound(), autoLevelWindow.GetDefaultUpperBound());
+    }
+    node->SetLevelWindow(levelWindow, renderer);
+  }
+  node->SetBoolProperty("levelwindow.provisional", false, renderer);
+}
+
 void mitk::ImageVtkMapper2D::SetDefaultProperties(mitk::DataNode* node, mitk::BaseRenderer* renderer, bool overwrite)
 {
   mitk::Image::Pointer image = dynamic_cast<mitk::Image*>(node->GetData());
@@ -811,6 +853,7 @@ void mitk::ImageVtkMapper2D::SetDefaultProperties(mitk::DataNode* node, mitk::Ba
     {
       /* initialize level/window from DICOM tags */
       mitk::LevelWindow contrast;
+      bool provisional = false;
       std::string sLevel;
       std::string sWindow;
       if ( image->GetPropertyList()->GetStringProperty( "dicom.voilut.WindowCenter", sLevel )
@@ -832,7 +875,9 @@ void mitk::ImageVtkMapper2D::SetDefaultProperties(mitk::DataNode* node, mitk::Ba
         }
         else
         {
-          contrast.SetAuto( static_cast<mitk::Image*>(node->GetData()), false, true ); // fallback
+          // guesses from the central slice until the statistics are known
+          image->GetStatistics()->ComputeImageStatisticsInBackground();
+          provisional = !contrast.SetAuto( static_cast<mitk::Image*>(node->GetData()), false, true ); // fallback
         }
 
         mitk::LevelWindowProperty::Pointer levelWindowProperty =
@@ -840,10 +885,16 @@ void mitk::ImageVtkMapper2D::SetDefaultProperties(mitk::DataNode* node, mitk::Ba
         if (levelWindowProperty.IsNull()) {
           contrast.SetLevelWindow(level, window, true);
         } else {
-          contrast.SetAuto(static_cast<mitk::Image *>(node->GetData()), false, true); // fallback
+          image->GetStatistics()->ComputeImageStatisticsInBackground();
+          provisional = !contrast.SetAuto(static_cast<mitk::Image *>(node->GetData()), false, true); // fallback
         }
 
         node->SetProperty("levelwindow", LevelWindowProperty::New(contrast), renderer);
+        if (provisional)
+        {
+          // the statistics are computed in the background, see UpdateProvisionalLevelWindow()
+          node->SetBoolProperty("levelwindow.provisional", true, renderer);
+        }
       }
     }
     if(((overwrite) || (node->GetProperty("opaclevelwindow", renderer)==NULL))
@@ -37,8 +37,12 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkTextActor.h>
 #include <vtkTextProperty.h>
 #include <vtkCellArray.h>
+#include <vtkCamera.h>
+#include <vtkRenderer.h>
 
 #include <stdlib.h>
+#include <cmath>
+#include <vector>
 
 // constructor LocalStorage
 mitk::PointSetVtkMapper2D::LocalStorage::LocalStorage()
@@ -83,6 +87,10 @@ mitk::PointSetVtkMapper2D::LocalStorage::LocalStorage()
 
   // propassembly
   m_PropAssembly = vtkSmartPointer <vtkPropAssembly>::New();
+
+  m_WorldPointsTimeStep = -1;
+  m_LastViewportSize[0] = 0;
+  m_LastViewportSize[1] = 0;
 }
 // destructor LocalStorage
 mitk::PointSetVtkMapper2D::LocalStorage::~LocalStorage()
@@ -157,6 +165,16 @@ static bool makePerpendicularVector2D(const mitk::Vector2D& in, mitk::Vector2D&
       return false;
 }
 
+// returns the next unused text actor of the given pool, the pool grows on demand
+static vtkTextActor* NextTextActor(std::vector< vtkSmartPointer<vtkTextActor> >& actors, std::size_t& numberOfUsedActors)
+{
+  if (numberOfUsedActors == actors.size())
+  {
+    actors.push_back(vtkSmartPointer<vtkTextActor>::New());
+  }
+  return actors[numberOfUsedActors++];
+}
+
 void mitk::PointSetVtkMapper2D::CreateVTKRenderObjects(mitk::BaseRenderer* renderer)
 {
   LocalStorage *ls = m_LSH.GetLocalStorage(renderer);
@@ -164,8 +182,7 @@ void mitk::PointSetVtkMapper2D::CreateVTKRenderObjects(mitk::BaseRenderer* rende
   unsigned i = 0;
 
   // The vtk text actors need to be removed manually from the propassembly
-  // since the same vtk text actors are not overwriten within this function,
-  // but new actors are added to the propassembly each time this function is executed.
+  // since only the actors used in this call are added to the propassembly again.
   // Thus, the actors from the last call must be removed in the beginning.
   for (i = 0; i < ls->m_VtkTextLabelActors.size(); i++)
   {
@@ -191,15 +208,9 @@ void mitk::PointSetVtkMapper2D::CreateVTKRenderObjects(mitk::BaseRenderer* rende
   ls->m_VtkSelectedPointListPolyData = vtkSmartPointer <vtkPolyData>::New();
   ls->m_VtkContourPolyData = vtkSmartPointer<vtkPolyData>::New();
 
-  // get input point set and update the PointSet
+  // get input point set
   mitk::PointSet::Pointer input = const_cast<mitk::PointSet*>(this->GetInput());
 
-  // only update the input data, if the property tells us to
-  bool update = true;
-  this->GetDataNode()->GetBoolProperty("updateDataOnRender", update);
-  if (update == true)
-    input->Update();
-
   int timestep = this->GetTimestep();
   mitk::PointSet::DataType::Pointer itkPointSet = input->GetPointSet(timestep);
 
@@ -209,14 +220,6 @@ void mitk::PointSetVtkMapper2D::CreateVTKRenderObjects(mitk::BaseRenderer* rende
     return;
   }
 
-  //iterator for point set
-  mitk::PointSet::PointsContainer::Iterator pointsIter = itkPointSet->GetPoints()->Begin();
-
-  // PointDataContainer has additional information to each point, e.g. whether
-  // it is selected or not
-  mitk::PointSet::PointDataContainer::Iterator pointDataIter;
-  pointDataIter = itkPointSet->GetPointData()->Begin();
-
   //check if the list for the PointDataContainer is the same size as the PointsContainer.
   //If not, then the points were inserted manually and can not be visualized according to the PointData (selected/unselected)
   bool pointDataBroken = (itkPointSet->GetPointData()->Size() != itkPointSet->GetPoints()->Size());
@@ -229,6 +232,39 @@ void mitk::PointSetVtkMapper2D::CreateVTKRenderObjects(mitk::BaseRenderer* rende
 
   ls->m_PropAssembly->VisibilityOn();
 
+  // transform all points of the point set to world coordinates in one run; this is only
+  // repeated if the point set was modified, not when scrolling through the slices
+  const mitk::BaseGeometry* inputGeometry = input->GetGeometry(timestep);
+  if (ls->m_WorldPointsTimeStep != timestep ||
+      ls->m_WorldPointsUpdateTime < input->GetMTime() ||
+      ls->m_WorldPointsUpdateTime < inputGeometry->GetMTime())
+  {
+    const std::size_t numberOfPoints = itkPointSet->GetPoints()->Size();
+    ls->m_WorldPoints.clear();
+    ls->m_PointIds.clear();
+    ls->m_PointSelected.clear();
+    ls->m_WorldPoints.reserve(numberOfPoints);
+    ls->m_PointIds.reserve(numberOfPoints);
+    ls->m_PointSelected.reserve(numberOfPoints);
+
+    mitk::PointSet::PointDataContainer::Iterator pointDataIter = itkPointSet->GetPointData()->Begin();
+    for (mitk::PointSet::PointsContainer::Iterator pointsIter = itkPointSet->GetPoints()->Begin();
+      pointsIter != itkPointSet->GetPoints()->End();
+      ++pointsIter, ++pointDataIter)
+    {
+      ls->m_WorldPoints.push_back(pointsIter->Value());
+      ls->m_PointIds.push_back(pointsIter->Index());
+      ls->m_PointSelected.push_back(pointDataIter->Value().selected);
+    }
+    inputGeometry->IndexToWorld(ls->m_WorldPoints.data(), ls->m_WorldPoints.data(), ls->m_WorldPoints.size());
+
+    ls->m_WorldPointsTimeStep = timestep;
+    ls->m_WorldPointsUpdateTime.Modified();
+  }
+
+  const std::vector<mitk::Point3D>& worldPoints = ls->m_WorldPoints;
+  const std::size_t numberOfPoints = worldPoints.size();
+
   // empty point sets, cellarrays, scalars
   ls->m_UnselectedPoints->Reset();
   ls->m_SelectedPoints->Reset();
@@ -241,80 +277,96 @@ void mitk::PointSetVtkMapper2D::CreateVTKRenderObjects(mitk::BaseRenderer* rende
 
   ls->m_DistancesBetweenPoints->Reset();
 
-  ls->m_VtkTextLabelActors.clear();
-  ls->m_VtkTextDistanceActors.clear();
-  ls->m_VtkTextAngleActors.clear();
-
   ls->m_UnselectedScales->SetNumberOfComponents(3);
   ls->m_SelectedScales->SetNumberOfComponents(3);
 
+  // the text actors of the last call are reused
+  std::size_t numberOfLabels = 0;
+  std::size_t numberOfDistances = 0;
+  std::size_t numberOfAngles = 0;
+
   int NumberContourPoints = 0;
   bool pointsOnSameSideOfPlane = false;
 
   const int text2dDistance = 10;
 
-  // initialize points with a random start value
-
-  // current point in point set
-  itk::Point<ScalarType> point = pointsIter->Value();
-
-  mitk::Point3D p = point;              // currently visited point
-  mitk::Point3D lastP = point;          // last visited point (predecessor in point set of "point")
-  mitk::Vector3D vec;                   // p - lastP
-  mitk::Vector3D lastVec;               // lastP - point before lastP
-  vec.Fill(0.0);
-  lastVec.Fill(0.0);
-
-  mitk::Point2D pt2d;
-  pt2d[0] = point[0];                    // projected_p in display coordinates
-  pt2d[1] = point[1];
-  mitk::Point2D lastPt2d = pt2d;         // last projected_p in display coordinates (predecessor in point set of "pt2d")
-  mitk::Point2D preLastPt2d = pt2d;     // projected_p in display coordinates before lastPt2
-
   const mitk::PlaneGeometry* geo2D = renderer->GetCurrentWorldPlaneGeometry();
 
-  vtkLinearTransform* dataNodeTransform = input->GetGeometry()->GetVtkTransform();
-
-  int count = 0;
+  // compute the distances of all points to the current plane in one run
+  std::vector<ScalarType> signedDistances(numberOfPoints);
+  geo2D->SignedDistance(worldPoints.data(), signedDistances.data(), numberOfPoints);
 
-  for (pointsIter = itkPointSet->GetPoints()->Begin();
-    pointsIter != itkPointSet->GetPoints()->End();
-    pointsIter++)
+  // display positions are only needed for points near the plane and for the annotations
+  // of the contour, so they are computed on demand
+  std::vector<mitk::Point2D> displayPoints(numberOfPoints);
+  std::vector<bool> displayPointComputed(numberOfPoints, false);
+  auto displayPoint = [&](std::size_t index) -> const mitk::Point2D&
+  {
+    if (!displayPointComputed[index])
+    {
+      renderer->WorldToDisplay(worldPoints[index], displayPoints[index]);
+      displayPointComputed[index] = true;
+    }
+    return displayPoints[index];
+  };
+
+  // points outside of the render window (enlarged by the glyph size and the label distance)
+  // do not get a glyph or a label
+  const int* viewportSize = renderer->GetViewportSize();
+  const bool cullToViewport = viewportSize[0] > 0 && viewportSize[1] > 0;
+  const double viewportMargin = cullToViewport
+    ? m_Point2DSize / renderer->GetScaleFactorMMPerDisplayUnit() + text2dDistance
+    : 0.0;
+  auto isInViewport = [&](const mitk::Point2D& pt2d)
+  {
+    return !cullToViewport ||
+      (pt2d[0] >= -viewportMargin && pt2d[0] <= viewportSize[0] + viewportMargin &&
+       pt2d[1] >= -viewportMargin && pt2d[1] <= viewportSize[1] + viewportMargin);
+  };
+
+  // the label properties are the same for all points
+  const char* pointLabel = NULL;
+  if (mitk::StringProperty* labelProperty = dynamic_cast<mitk::StringProperty *>(this->GetDataNode()->GetProperty("label")))
   {
-    lastP = p; // valid for number of points count > 0
-    preLastPt2d = lastPt2d; // valid only for count > 1
-    lastPt2d = pt2d;  // valid for number of points count > 0
+    pointLabel = labelProperty->GetValue();
+  }
 
-    lastVec = vec;    // valid only for counter > 1
+  int labelOffset = 0;
+  if (mitk::IntProperty* labelOffsetProperty = dynamic_cast<mitk::IntProperty*>(this->GetDataNode()->GetProperty("label.offset")))
+  {
+    labelOffset = labelOffsetProperty->GetValue();
+  }
 
-    // get current point in point set
-    point = pointsIter->Value();
+  float labelColor[4] = { 1.0, 1.0, 0.0, 1.0 };
+  //check if there is a color property
+  GetDataNode()->GetColor(labelColor);
 
-    // transform point
-    {
-      float vtkp[3];
-      itk2vtk(point, vtkp);
-      dataNodeTransform->TransformPoint(vtkp, vtkp);
-      vtk2itk(vtkp, point);
-    }
+  mitk::Vector3D vec;                   // p - lastP
+  mitk::Vector3D lastVec;               // lastP - point before lastP
+  vec.Fill(0.0);
+  lastVec.Fill(0.0);
 
-    p[0] = point[0];
-    p[1] = point[1];
-    p[2] = point[2];
+  for (std::size_t pointIndex = 0; pointIndex < numberOfPoints; ++pointIndex)
+  {
+    lastVec = vec;    // valid only for pointIndex > 1
 
-    renderer->WorldToDisplay(p, pt2d);
+    // get current transformed point in point set
+    const mitk::Point3D& point = worldPoints[pointIndex];
+    const mitk::Point3D& lastP = pointIndex > 0 ? worldPoints[pointIndex - 1] : point;
+    const ScalarType signedDistance = signedDistances[pointIndex];
+    const ScalarType lastSignedDistance = pointIndex > 0 ? signedDistances[pointIndex - 1] : signedDistance;
 
-    vec = p - lastP;    // valid only for counter > 0
+    vec = point - lastP;    // valid only for pointIndex > 0
 
-    // compute distance to current plane
-    float dist = geo2D->Distance(point);
+    // distance to current plane
+    float dist = std::abs(signedDistance);
 
     //draw markers on slices a certain distance away from the points
     //location according to the tolerance threshold (m_DistanceToPlane)
-    if(dist < m_DistanceToPlane)
+    if (dist < m_DistanceToPlane && isInViewport(displayPoint(pointIndex)))
     {
       // is point selected or not?
-      if (pointDataIter->Value().selected)
+      if (ls->m_PointSelected[pointIndex])
       {
         ls->m_SelectedPoints->InsertNextPoint(point[0], point[1], point[2]);
         // point is scaled according to its distance to the plane
@@ -329,51 +381,33 @@ void mitk::PointSetVtkMapper2D::CreateVTKRenderObjects(mitk::BaseRenderer* rende
 
       //---- LABEL -----//
       //paint label for each point if available
-      if (dynamic_cast<mitk::StringProperty *>(this->GetDataNode()->GetProperty("label")) != NULL)
+      if (pointLabel != NULL)
       {
-        const char * pointLabel = dynamic_cast<mitk::StringProperty *>(
-          this->GetDataNode()->GetProperty("label"))->GetValue();
-
-        int offset = 0;
-        mitk::IntProperty* labelOffset = dynamic_cast<mitk::IntProperty*>(this->GetDataNode()->GetProperty("label.offset"));
-        if (labelOffset) {
-          offset = labelOffset->GetValue();
-        }
-
         std::string l = pointLabel;
         if (input->GetSize() > 1)
         {
           std::stringstream ss;
-          ss << pointsIter->Index() + offset;
+          ss << ls->m_PointIds[pointIndex] + labelOffset;
           l.append(ss.str());
         }
 
-        ls->m_VtkTextActor = vtkSmartPointer<vtkTextActor>::New();
+        const mitk::Point2D& pt2d = displayPoint(pointIndex);
+
+        ls->m_VtkTextActor = NextTextActor(ls->m_VtkTextLabelActors, numberOfLabels);
 
         ls->m_VtkTextActor->SetDisplayPosition(pt2d[0] + text2dDistance, pt2d[1] + text2dDistance);
         ls->m_VtkTextActor->SetInput(l.c_str());
         ls->m_VtkTextActor->GetTextProperty()->SetOpacity(100);
-
-        float unselectedColor[4] = { 1.0, 1.0, 0.0, 1.0 };
-
-        //check if there is a color property
-        GetDataNode()->GetColor(unselectedColor);
-
-        ls->m_VtkTextActor->GetTextProperty()->SetColor(unselectedColor[0], unselectedColor[1], unselectedColor[2]);
-
-        ls->m_VtkTextLabelActors.push_back(ls->m_VtkTextActor);
+        ls->m_VtkTextActor->GetTextProperty()->SetColor(labelColor[0], labelColor[1], labelColor[2]);
       }
     }
 
     // draw contour, distance text and angle text in render window
 
     // lines between points, which intersect the current plane, are drawn
-    if (m_ShowContour && count > 0)
+    if (m_ShowContour && pointIndex > 0)
     {
-      ScalarType distance = renderer->GetCurrentWorldPlaneGeometry()->SignedDistance(point);
-      ScalarType lastDistance = renderer->GetCurrentWorldPlaneGeometry()->SignedDistance(lastP);
-
-      pointsOnSameSideOfPlane = (distance * lastDistance) > 0.5;
+      pointsOnSameSideOfPlane = (signedDistance * lastSignedDistance) > 0.5;
 
       // Points must be on different side of plane in order to draw a contour.
       // If "show distant lines" is enabled this condition is disregarded.
@@ -399,25 +433,28 @@ void mitk::PointSetVtkMapper2D::CreateVTKRenderObjects(mitk::BaseRenderer* rende
           buffer << std::fixed << std::setprecision(m_DistancesDecimalDigits) << distancePoints << " mm";
 
           // compute desired display position of text
+          const mitk::Point2D& pt2d = displayPoint(pointIndex);
+          const mitk::Point2D& lastPt2d = displayPoint(pointIndex - 1);
           Vector2D vec2d = pt2d - lastPt2d;
           makePerpendicularVector2D(vec2d, vec2d); // text is rendered within text2dDistance perpendicular to current line
           Vector2D pos2d = (lastPt2d.GetVectorFromOrigin() + pt2d.GetVectorFromOrigin()) * 0.5 + vec2d * text2dDistance;
 
-          ls->m_VtkTextActor = vtkSmartPointer<vtkTextActor>::New();
+          ls->m_VtkTextActor = NextTextActor(ls->m_VtkTextDistanceActors, numberOfDistances);
 
           ls->m_VtkTextActor->SetDisplayPosition(pos2d[0], pos2d[1]);
           ls->m_VtkTextActor->SetInput(buffer.str().c_str());
           ls->m_VtkTextActor->GetTextProperty()->SetColor(0.0, 1.0, 0.0);
-
-          ls->m_VtkTextDistanceActors.push_back(ls->m_VtkTextActor);
         }
 
-        if (m_ShowAngles && count > 1) // calculate and print angle between connected lines
+        if (m_ShowAngles && pointIndex > 1) // calculate and print angle between connected lines
         {
           std::stringstream buffer;
           buffer << angle(vec.GetVnlVector(), -lastVec.GetVnlVector()) * 180 / vnl_math::pi << "°";
 
           //compute desired display position of text
+          const mitk::Point2D& pt2d = displayPoint(pointIndex);
+          const mitk::Point2D& lastPt2d = displayPoint(pointIndex - 1);
+          const mitk::Point2D& preLastPt2d = displayPoint(pointIndex - 2);
           Vector2D vec2d = pt2d - lastPt2d;             // first arm enclosing the angle
           vec2d.Normalize();
           Vector2D lastVec2d = lastPt2d - preLastPt2d;  // second arm enclosing the angle
@@ -428,36 +465,28 @@ void mitk::PointSetVtkMapper2D::CreateVTKRenderObjects(mitk::BaseRenderer* rende
           // middle between two vectors that enclose the angle
           Vector2D pos2d = lastPt2d.GetVectorFromOrigin() + vec2d * text2dDistance * text2dDistance;
 
-          ls->m_VtkTextActor = vtkSmartPointer<vtkTextActor>::New();
+          ls->m_VtkTextActor = NextTextActor(ls->m_VtkTextAngleActors, numberOfAngles);
 
           ls->m_VtkTextActor->SetDisplayPosition(pos2d[0], pos2d[1]);
           ls->m_VtkTextActor->SetInput(buffer.str().c_str());
           ls->m_VtkTextActor->GetTextProperty()->SetColor(0.0, 1.0, 0.0);
-
-          ls->m_VtkTextAngleActors.push_back(ls->m_VtkTextActor);
         }
       }
     }
-
-    if (pointDataIter != itkPointSet->GetPointData()->End())
-    {
-      pointDataIter++;
-      count++;
-    }
   }
 
-  // add each single text actor to the assembly
-  for (i = 0; i < ls->m_VtkTextLabelActors.size(); i++)
+  // add each used text actor to the assembly
+  for (i = 0; i < numberOfLabels; i++)
   {
     ls->m_PropAssembly->AddPart(ls->m_VtkTextLabelActors.at(i));
   }
 
-  for (i = 0; i < ls->m_VtkTextDistanceActors.size(); i++)
+  for (i = 0; i < numberOfDistances; i++)
   {
     ls->m_PropAssembly->AddPart(ls->m_VtkTextDistanceActors.at(i));
   }
 
-  for (i = 0; i < ls->m_VtkTextAngleActors.size(); i++)
+  for (i = 0; i < numberOfAngles; i++)
   {
     ls->m_PropAssembly->AddPart(ls->m_VtkTextAngleActors.at(i));
   }
@@ -582,8 +611,26 @@ void mitk::PointSetVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rend
 
   LocalStorage *ls = m_LSH.GetLocalStorage(renderer);
 
-  // check whether the input data has been changed
-  bool needGenerateData = ls->IsGenerateDataRequired(renderer, this, GetDataNode());
+  // only update the input data, if the property tells us to
+  bool update = true;
+  node->GetBoolProperty("updateDataOnRender", update);
+  if (update == true)
+    const_cast<mitk::PointSet*>(this->GetInput())->Update();
+
+  // check whether the input data, its geometry, the properties, the slice or the camera have been changed,
+  // otherwise the render objects of the last call are still valid
+  const mitk::BaseGeometry* inputGeometry = this->GetInput()->GetGeometry(this->GetTimestep());
+  const int* viewportSize = renderer->GetViewportSize();
+  bool needGenerateData = ls->IsGenerateDataRequired(renderer, this, GetDataNode()) ||
+    (inputGeometry != NULL && ls->m_LastUpdateTime < inputGeometry->GetMTime()) ||
+    ls->m_LastUpdateTime < node->GetMTime() ||
+    ls->m_LastUpdateTime < node->GetPropertyList()->GetMTime() ||
+    ls->m_LastUpdateTime < node->GetPropertyList(renderer)->GetMTime() ||
+    ls->m_LastUpdateTime < renderer->GetCurrentWorldPlaneGeometryUpdateTime() ||
+    ls->m_LastUpdateTime < renderer->GetCurrentWorldPlaneGeometry()->GetMTime() ||
+    ls->m_LastUpdateTime < renderer->GetVtkRenderer()->GetActiveCamera()->GetMTime() ||
+    ls->m_LastViewportSize[0] != viewportSize[0] ||
+    ls->m_LastViewportSize[1] != viewportSize[1];
 
   // toggle visibility
   bool visible = true;
@@ -710,6 +757,15 @@ void mitk::PointSetVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rend
   {
     // create new vtk render objects (e.g. a circle for a point)
     this->CreateVTKRenderObjects(renderer);
+
+    // an invalid or empty point set hides the assembly and is checked again on the next call
+    if (ls->m_PropAssembly->GetVisibility())
+    {
+      ls->UpdateGenerateDataTime();
+      ls->m_LastUpdateTime.Modified();
+      ls->m_LastViewportSize[0] = viewportSize[0];
+      ls->m_LastViewportSize[1] = viewportSize[1];
+    }
   }
 }
 
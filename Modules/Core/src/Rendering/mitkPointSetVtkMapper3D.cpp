@@ -38,6 +38,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkTransform.h>
 #include <vtkTransformPolyDataFilter.h>
 #include <vtkPolyDataAlgorithm.h>
+#include <vtkGlyph3D.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
 #include <math.h>
 #include <stdlib.h>
 #include <vtkMatrix4x4.h>
@@ -140,6 +143,25 @@ void mitk::PointSetVtkMapper3D::CreateEdgeObjectsBetweenPoints(itk::Point<float>
   ++m_NumberOfSelectedAdded;
 }
 
+// places one sphere of the given radius at each of the given centers
+static vtkSmartPointer<vtkGlyph3D> CreateSphereGlyphs(vtkPoints* centers, double radius, int resolution)
+{
+  vtkSmartPointer<vtkSphereSource> sphere = vtkSmartPointer<vtkSphereSource>::New();
+  sphere->SetRadius(radius);
+  sphere->SetThetaResolution(resolution);
+  sphere->SetPhiResolution(resolution);
+
+  vtkSmartPointer<vtkPolyData> centerPolyData = vtkSmartPointer<vtkPolyData>::New();
+  centerPolyData->SetPoints(centers);
+
+  vtkSmartPointer<vtkGlyph3D> glyphs = vtkSmartPointer<vtkGlyph3D>::New();
+  glyphs->SetSourceConnection(sphere->GetOutputPort());
+  glyphs->SetInputData(centerPolyData);
+  glyphs->ScalingOff();
+  glyphs->OrientOff();
+  return glyphs;
+}
+
 void mitk::PointSetVtkMapper3D::CreateVTKRenderObjects()
 {
   m_vtkSelectedPointList = vtkSmartPointer<vtkAppendPolyData>::New();
@@ -281,6 +303,14 @@ void mitk::PointSetVtkMapper3D::CreateVTKRenderObjects()
   //check if the list for the PointDataContainer is the same size as the PointsContainer. Is not, then the points were inserted manually and can not be visualized according to the PointData (selected/unselected)
   bool pointDataBroken = (itkPointSet->GetPointData()->Size() != itkPointSet->GetPoints()->Size());
 
+  bool highlightSphere = false;
+  GetDataNode()->GetVisibility(highlightSphere, nullptr, "highlightSphere");
+
+  // plain spheres are not created per point but glyphed from one sphere source after the loop
+  vtkSmartPointer<vtkPoints> selectedSphereCenters = vtkSmartPointer<vtkPoints>::New();
+  vtkSmartPointer<vtkPoints> unselectedSphereCenters = vtkSmartPointer<vtkPoints>::New();
+  vtkSmartPointer<vtkPoints> highlightSphereCenters = vtkSmartPointer<vtkPoints>::New();
+
   //now add an object for each point in data
   mitk::PointSet::PointDataContainer::Iterator pointDataIter = itkPointSet->GetPointData()->Begin();
   for (ptIdx=0; ptIdx < nbPoints; ++ptIdx) // pointDataIter moved at end of loop
@@ -299,25 +329,7 @@ void mitk::PointSetVtkMapper3D::CreateVTKRenderObjects()
     switch (pointType)
     {
     case mitk::PTUNDEFINED:
-    {
-      vtkSmartPointer<vtkSphereSource> sphere = vtkSmartPointer<vtkSphereSource>::New();
-      sphere->SetRadius(m_PointSize/2.0f);
-      sphere->SetCenter(currentPoint);
-      //sphere->SetCenter(pointsIter.Value()[0],pointsIter.Value()[1],pointsIter.Value()[2]);
-
-      //MouseOrientation Tool (PositionTracker)
-      if(isInputDevice)
-      {
-        sphere->SetThetaResolution(10);
-        sphere->SetPhiResolution(10);
-      }
-      else
-      {
-        sphere->SetThetaResolution(20);
-        sphere->SetPhiResolution(20);
-      }
-      source = sphere;
-    }
+      // glyphed after the loop
       break;
     case mitk::PTSTART:
     {
@@ -359,38 +371,38 @@ void mitk::PointSetVtkMapper3D::CreateVTKRenderObjects()
       }
       break;
     default:
-      {
-        vtkSmartPointer<vtkSphereSource> sphere = vtkSmartPointer<vtkSphereSource>::New();
-        sphere->SetRadius(m_PointSize/2.0f);
-        sphere->SetCenter(currentPoint);
-        sphere->SetThetaResolution(20);
-        sphere->SetPhiResolution(20);
-        source = sphere;
-      }
+      // glyphed after the loop
       break;
     }
 
     if (pointDataIter.Value().selected && !pointDataBroken)
     {
-      m_vtkSelectedPointList->AddInputConnection(source->GetOutputPort());
-      ++m_NumberOfSelectedAdded;
+      if (source)
+      {
+        m_vtkSelectedPointList->AddInputConnection(source->GetOutputPort());
+        ++m_NumberOfSelectedAdded;
+      }
+      else
+      {
+        selectedSphereCenters->InsertNextPoint(currentPoint);
+      }
 
-      bool highlightSphere = false;
-      GetDataNode()->GetVisibility(highlightSphere, nullptr, "highlightSphere");
-      if (highlightSphere) {
-        vtkSmartPointer<vtkSphereSource> sphere = vtkSmartPointer<vtkSphereSource>::New();
-        sphere->SetRadius(m_PointSize);
-        sphere->SetCenter(currentPoint);
-        sphere->SetThetaResolution(20);
-        sphere->SetPhiResolution(20);
-        m_vtkSelectedAreaPointList->AddInputConnection(sphere->GetOutputPort());
-        ++m_NumberOfSelectedAreaAdded;
+      if (highlightSphere)
+      {
+        highlightSphereCenters->InsertNextPoint(currentPoint);
       }
     }
     else
     {
-      m_vtkUnselectedPointList->AddInputConnection(source->GetOutputPort());
-      ++m_NumberOfUnselectedAdded;
+      if (source)
+      {
+        m_vtkUnselectedPointList->AddInputConnection(source->GetOutputPort());
+        ++m_NumberOfUnselectedAdded;
+      }
+      else
+      {
+        unselectedSphereCenters->InsertNextPoint(currentPoint);
+      }
     }
     if (showLabel)
     {
@@ -433,6 +445,27 @@ void mitk::PointSetVtkMapper3D::CreateVTKRenderObjects()
       pointDataIter++;
   } // end FOR
 
+  //MouseOrientation Tool (PositionTracker) uses a coarser sphere
+  const int sphereResolution = isInputDevice ? 10 : 20;
+
+  if (selectedSphereCenters->GetNumberOfPoints() > 0)
+  {
+    m_vtkSelectedPointList->AddInputConnection(CreateSphereGlyphs(selectedSphereCenters, m_PointSize/2.0f, sphereResolution)->GetOutputPort());
+    ++m_NumberOfSelectedAdded;
+  }
+
+  if (unselectedSphereCenters->GetNumberOfPoints() > 0)
+  {
+    m_vtkUnselectedPointList->AddInputConnection(CreateSphereGlyphs(unselectedSphereCenters, m_PointSize/2.0f, sphereResolution)->GetOutputPort());
+    ++m_NumberOfUnselectedAdded;
+  }
+
+  if (highlightSphereCenters->GetNumberOfPoints() > 0)
+  {
+    m_vtkSelectedAreaPointList->AddInputConnection(CreateSphereGlyphs(highlightSphereCenters, m_PointSize, 20)->GetOutputPort());
+    ++m_NumberOfSelectedAreaAdded;
+  }
+
   //now according to number of elements added to selected or unselected, build up the rendering pipeline
   if (m_NumberOfSelectedAdded > 0)
   {
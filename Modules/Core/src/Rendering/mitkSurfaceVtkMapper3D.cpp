@@ -32,6 +32,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkIPropertyDescriptions.h>
 #include <mitkIPropertyAliases.h>
 #include <mitkDataNodePickingEventObserver.h>
+#include <mitkRenderingManager.h>
 
 //VTK
 #include <vtkActor.h>
@@ -42,6 +43,11 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkPointData.h>
 #include <vtkPlaneCollection.h>
 #include <vtkSmartPointer.h>
+#include <vtkCamera.h>
+#include <vtkMath.h>
+#include <vtkRenderer.h>
+
+#include <cmath>
 
 const mitk::Surface* mitk::SurfaceVtkMapper3D::GetInput()
 {
@@ -73,8 +79,7 @@ void mitk::SurfaceVtkMapper3D::GenerateDataForRenderer(mitk::BaseRenderer* rende
   //
   // set the input-object at time t for the mapper
   //
-  mitk::Surface::Pointer input  = const_cast< mitk::Surface* >( this->GetInput() );
-  vtkSmartPointer<vtkPolyData> polydata = input->GetVtkPolyData( this->GetTimestep() );
+  vtkSmartPointer<vtkPolyData> polydata = this->GetLevelOfDetailForRenderer( renderer );
   if(polydata == NULL)
   {
     ls->m_Actor->VisibilityOff();
@@ -113,6 +118,60 @@ void mitk::SurfaceVtkMapper3D::GenerateDataForRenderer(mitk::BaseRenderer* rende
     ls->m_Actor->VisibilityOn();
 }
 
+bool mitk::SurfaceVtkMapper3D::IsLODEnabled(mitk::BaseRenderer* renderer) const
+{
+  bool useLOD = false;
+  const mitk::Surface* input = static_cast<const mitk::Surface*>(GetDataNode()->GetData());
+
+  return GetDataNode()->GetBoolProperty("surface.uselod", useLOD, renderer) && useLOD &&
+    input != nullptr && input->GetNumberOfLevelsOfDetail(this->GetTimestep()) > 1;
+}
+
+vtkPolyData* mitk::SurfaceVtkMapper3D::GetLevelOfDetailForRenderer(mitk::BaseRenderer* renderer)
+{
+  const mitk::Surface* input = this->GetInput();
+  const unsigned int timestep = this->GetTimestep();
+  vtkPolyData* polydata = input->GetVtkPolyData(timestep);
+
+  if (polydata == nullptr || !this->IsLODEnabled(renderer))
+    return polydata;
+
+  // projected size of the bounding box diagonal in pixels
+  double bounds[6];
+  polydata->GetBounds(bounds);
+  const double center[3] = { (bounds[0] + bounds[1]) / 2, (bounds[2] + bounds[3]) / 2, (bounds[4] + bounds[5]) / 2 };
+  const double diagonal = polydata->GetLength();
+
+  vtkCamera* camera = renderer->GetVtkRenderer()->GetActiveCamera();
+  const double viewportHeight = renderer->GetViewportSize()[1];
+  const double visibleHeight = camera->GetParallelProjection()
+    ? 2.0 * camera->GetParallelScale()
+    : 2.0 * std::sqrt(vtkMath::Distance2BetweenPoints(camera->GetPosition(), center)) *
+      std::tan(vtkMath::RadiansFromDegrees(camera->GetViewAngle()) / 2.0);
+  const double projectedSize = visibleHeight > 0.0 ? viewportHeight * diagonal / visibleHeight : viewportHeight;
+
+  // about one vertex per two by two pixels is enough, finer levels do not look different
+  const double requiredNumberOfPoints = projectedSize * projectedSize / 4.0;
+  const unsigned int numberOfLevels = input->GetNumberOfLevelsOfDetail(timestep);
+
+  unsigned int level = numberOfLevels - 1;
+  for (unsigned int i = 0; i + 1 < numberOfLevels; ++i)
+  {
+    if (input->GetLevelOfDetail(i, timestep)->GetNumberOfPoints() >= requiredNumberOfPoints)
+    {
+      level = i;
+      break;
+    }
+  }
+
+  // the rendering manager renders LOD 0 during interaction and the final LOD afterwards
+  mitk::RenderingManager* renderingManager = renderer->GetRenderingManager();
+  if (level > 0 && renderingManager != nullptr && renderingManager->GetNextLOD(renderer) == 0)
+    --level;
+
+  return input->GetLevelOfDetail(level, timestep);
+}
+
 void mitk::SurfaceVtkMapper3D::ResetMapper( BaseRenderer* renderer )
 {
   LocalStorage *ls = m_LSH.GetLocalStorage(renderer);
@@ -525,6 +584,9 @@ void mitk::SurfaceVtkMapper3D::SetDefaultProperties(mitk::DataNode* node, mitk::
   // Backface culling
   node->AddProperty( "Backface Culling", mitk::BoolProperty::New(false), renderer, overwrite );
 
+  node->AddProperty( "surface.uselod", mitk::BoolProperty::New(true), renderer, overwrite );
+  mitk::CoreServices::GetPropertyDescriptions()->AddDescription( "surface.uselod", "Renders coarser levels of detail of the surface, if available, when it is small on screen and during interaction.");
+
   node->AddProperty( "Depth Sorting", mitk::BoolProperty::New(false), renderer, overwrite );
   mitk::CoreServices::GetPropertyDescriptions()->AddDescription( "Depth Sorting", "Enables correct rendering for transparent objects by ordering polygons according to the distance to the camera. It is not recommended to enable this property for large surfaces (rendering might be slow).");
   Superclass::SetDefaultProperties(node, renderer, overwrite);
@@ -111,6 +111,8 @@ set(MODULE_TESTS
   mitkLevelWindowManagerCppUnitTest.cpp
   mitkVectorPropertyTest.cpp
   mitkTemporoSpatialStringPropertyTest.cpp
+  mitkImageStatisticsHolderTest.cpp
+  mitkChunkedGzipTest.cpp
 )
 
 if(MITK_ENABLE_RENDERING_TESTING)
@@ -120,6 +122,7 @@ set(MODULE_TESTS
   mitkPointSetDataInteractorTest.cpp #since mitkInteractionTestHelper is currently creating a vtkRenderWindow
   mitkSurfaceVtkMapper2DTest.cpp #new rendering test in CppUnit style
   mitkSurfaceVtkMapper2D3DTest.cpp # comparisons/consistency 2D/3D
+  mitkPointSetVtkMapperUpdateTest.cpp
 )
 endif()
 
@@ -178,6 +181,8 @@ set(MODULE_CUSTOM_TESTS
     mitkImageToItkTest.cpp
     mitkImageSliceSelectorTest.cpp
     mitkSurfaceDepthPeelingTest.cpp
+    mitkChunkedGzipBenchmarkTest.cpp
+    mitkPlaneGeometryBatchMappingBenchmarkTest.cpp
 )
 
 # Currently not working on windows because of a rendering timing issue
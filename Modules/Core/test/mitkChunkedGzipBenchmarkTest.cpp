@@ -0,0 +1,75 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkTestingMacros.h>
+#include <mitkIOUtil.h>
+#include <mitkImageCast.h>
+#include <mitkImageGenerator.h>
+
+#include <itkImageFileWriter.h>
+#include <itkNrrdImageIO.h>
+#include <itkTimeProbe.h>
+
+#include <cstdio>
+
+/**Documentation
+ *  Logs the speed in MB/s of writing and reading a gzip encoded NRRD file in parallel chunks, and of writing it
+ *  with the single zlib stream of the ITK NrrdImageIO. Not run by ctest, start it from the test driver:
+ *  MitkCoreTestDriver mitkChunkedGzipBenchmarkTest
+ */
+int mitkChunkedGzipBenchmarkTest(int, char*[])
+{
+  MITK_TEST_BEGIN("mitkChunkedGzipBenchmarkTest");
+
+  typedef itk::Image<short, 3> ItkImageType;
+  mitk::Image::Pointer image = mitk::ImageGenerator::GenerateRandomImage<short>(256, 256, 128, 1, 0.5, 0.5, 2.0, 100.0, -100.0);
+  const double megaBytes = 256.0 * 256.0 * 128.0 * sizeof(short) / (1024.0 * 1024.0);
+
+  const std::string chunkedFilePath = mitk::IOUtil::CreateTemporaryFile("ChunkedGzipXXXXXX.nrrd");
+  itk::TimeProbe chunkedClock;
+  chunkedClock.Start();
+  mitk::IOUtil::Save(image, chunkedFilePath);
+  chunkedClock.Stop();
+
+  // the single zlib stream of the ImageIO, which wrote all NRRD files before
+  ItkImageType::Pointer itkImage;
+  mitk::CastToItkImage(image, itkImage);
+  const std::string singleStreamFilePath = mitk::IOUtil::CreateTemporaryFile("SingleGzipXXXXXX.nrrd");
+  itk::ImageFileWriter<ItkImageType>::Pointer writer = itk::ImageFileWriter<ItkImageType>::New();
+  writer->SetImageIO(itk::NrrdImageIO::New());
+  writer->SetInput(itkImage);
+  writer->SetFileName(singleStreamFilePath);
+  writer->UseCompressionOn();
+  itk::TimeProbe singleStreamClock;
+  singleStreamClock.Start();
+  writer->Update();
+  singleStreamClock.Stop();
+
+  itk::TimeProbe readClock;
+  readClock.Start();
+  mitk::Image::Pointer chunkedImage = mitk::IOUtil::LoadImage(chunkedFilePath);
+  readClock.Stop();
+  MITK_TEST_CONDITION_REQUIRED(chunkedImage.IsNotNull(), "The chunked file was read");
+
+  MITK_INFO << "Writing " << megaBytes << " MB as NRRD: chunked gzip " << megaBytes / chunkedClock.GetTotal() << " MB/s, "
+            << "single gzip stream " << megaBytes / singleStreamClock.GetTotal() << " MB/s";
+  MITK_INFO << "Reading the chunked gzip NRRD: " << megaBytes / readClock.GetTotal() << " MB/s";
+
+  std::remove(chunkedFilePath.c_str());
+  std::remove(singleStreamFilePath.c_str());
+
+  MITK_TEST_END();
+}
@@ -0,0 +1,125 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestingMacros.h"
+#include <mitkTestFixture.h>
+#include <mitkChunkedGzip.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * Compresses data into chunked gzip members and checks that it is decompressed again,
+ * and that data that was not written by ChunkedGzip is rejected.
+ */
+class mitkChunkedGzipTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkChunkedGzipTestSuite);
+  MITK_TEST(Decompress_SeveralChunks_EqualsData);
+  MITK_TEST(Decompress_PartialLastChunk_EqualsData);
+  MITK_TEST(Decompress_EmptyData_Succeeds);
+  MITK_TEST(Decompress_WrongOutputSize_Fails);
+  MITK_TEST(Decompress_CorruptMember_Fails);
+  MITK_TEST(IsChunked_PlainGzipHeader_False);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  std::vector<unsigned char> m_Data;
+
+  std::string Compress(std::size_t chunkSize)
+  {
+    std::ostringstream stream;
+    mitk::ChunkedGzip::Compress(m_Data.data(), m_Data.size(), stream, -1, chunkSize);
+    return stream.str();
+  }
+
+public:
+
+  void setUp() override
+  {
+    m_Data.resize(1000003);
+    for (std::size_t i = 0; i < m_Data.size(); ++i)
+    {
+      m_Data[i] = static_cast<unsigned char>((i / 1000) * 17 + (i * 7919) % 13);
+    }
+  }
+
+  void tearDown() override
+  {
+    m_Data.clear();
+  }
+
+  void Decompress_SeveralChunks_EqualsData()
+  {
+    const std::string compressed = this->Compress(1 << 16);
+    CPPUNIT_ASSERT_MESSAGE("Compressed data is marked as chunked", mitk::ChunkedGzip::IsChunked(compressed.data(), compressed.size()));
+
+    std::vector<unsigned char> output(m_Data.size());
+    CPPUNIT_ASSERT(mitk::ChunkedGzip::Decompress(compressed.data(), compressed.size(), output.data(), output.size()));
+    CPPUNIT_ASSERT_MESSAGE("Decompressed data equals data", output == m_Data);
+  }
+
+  void Decompress_PartialLastChunk_EqualsData()
+  {
+    m_Data.resize(3 * 4096 + 5);
+    const std::string compressed = this->Compress(4096);
+
+    std::vector<unsigned char> output(m_Data.size());
+    CPPUNIT_ASSERT(mitk::ChunkedGzip::Decompress(compressed.data(), compressed.size(), output.data(), output.size()));
+    CPPUNIT_ASSERT_MESSAGE("Decompressed data equals data", output == m_Data);
+  }
+
+  void Decompress_EmptyData_Succeeds()
+  {
+    m_Data.clear();
+    const std::string compressed = this->Compress(mitk::ChunkedGzip::DefaultChunkSize);
+    CPPUNIT_ASSERT_MESSAGE("An empty gzip member is written", !compressed.empty());
+    CPPUNIT_ASSERT(mitk::ChunkedGzip::Decompress(compressed.data(), compressed.size(), nullptr, 0));
+  }
+
+  void Decompress_WrongOutputSize_Fails()
+  {
+    const std::string compressed = this->Compress(1 << 16);
+    std::vector<unsigned char> output(m_Data.size() + 1);
+    CPPUNIT_ASSERT(!mitk::ChunkedGzip::Decompress(compressed.data(), compressed.size(), output.data(), output.size()));
+    CPPUNIT_ASSERT(!mitk::ChunkedGzip::Decompress(compressed.data(), compressed.size(), output.data(), m_Data.size() - 1));
+  }
+
+  void Decompress_CorruptMember_Fails()
+  {
+    std::string compressed = this->Compress(1 << 16);
+    compressed[compressed.size() / 2] ^= 0x55;
+    std::vector<unsigned char> output(m_Data.size());
+    CPPUNIT_ASSERT(!mitk::ChunkedGzip::Decompress(compressed.data(), compressed.size(), output.data(), output.size()));
+
+    // truncated data
+    compressed = this->Compress(1 << 16);
+    CPPUNIT_ASSERT(!mitk::ChunkedGzip::Decompress(compressed.data(), compressed.size() - 1, output.data(), output.size()));
+  }
+
+  void IsChunked_PlainGzipHeader_False()
+  {
+    // header of a gzip member without extra field, as written by gzip or the ITK ImageIOs
+    const unsigned char header[] = { 0x1f, 0x8b, 0x08, 0x00, 0, 0, 0, 0, 0x00, 0x03, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+    CPPUNIT_ASSERT(!mitk::ChunkedGzip::IsChunked(header, sizeof(header)));
+    std::vector<unsigned char> output(16);
+    CPPUNIT_ASSERT(!mitk::ChunkedGzip::Decompress(header, sizeof(header), output.data(), output.size()));
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkChunkedGzip)
@@ -0,0 +1,165 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestingMacros.h"
+#include <mitkTestFixture.h>
+#include <mitkImageGenerator.h>
+#include <mitkImageStatisticsHolder.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+/**
+ * Compares the statistics of the image statistics holder, computed directly or in the background,
+ * to the sorted pixel values of every time step.
+ */
+class mitkImageStatisticsHolderTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkImageStatisticsHolderTestSuite);
+  MITK_TEST(GetScalarValues_ShortImage_EqualSortedValues);
+  MITK_TEST(GetScalarValues_FloatImage_EqualSortedValues);
+  MITK_TEST(GetScalarHistogram_ShortImage_CountsAllPixels);
+  MITK_TEST(GetScalarHistogram_FloatImage_CountsAllPixels);
+  MITK_TEST(ComputeImageStatisticsInBackground_EqualSortedValues);
+  MITK_TEST(ComputeImageStatisticsInBackground_ImageModifiedAfterwards_Recomputed);
+  MITK_TEST(GetScalarValues_ConstantImage_SecondExtremaEqualExtrema);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  template <typename TPixel>
+  std::vector<double> SortedValues(mitk::Image* image, unsigned int t)
+  {
+    const TPixel* data = static_cast<const TPixel*>(image->GetVolumeData(t)->GetData());
+    const std::size_t numberOfPixels = std::size_t(image->GetDimension(0)) * image->GetDimension(1) * image->GetDimension(2);
+    std::vector<double> values(data, data + numberOfPixels);
+    std::sort(values.begin(), values.end());
+    return values;
+  }
+
+  template <typename TPixel>
+  void CheckStatistics(mitk::Image* image)
+  {
+    mitk::ImageStatisticsHolder* statistics = image->GetStatistics();
+    for (unsigned int t = 0; t < image->GetDimension(3); ++t)
+    {
+      const std::vector<double> values = this->SortedValues<TPixel>(image, t);
+      const double min = values.front();
+      const double max = values.back();
+      const double secondMin = *std::upper_bound(values.begin(), values.end(), min);
+      const double secondMax = *(std::lower_bound(values.begin(), values.end(), max) - 1);
+
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Minimum", min, statistics->GetScalarValueMin(t));
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Maximum", max, statistics->GetScalarValueMax(t));
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Second minimum", secondMin, statistics->GetScalarValue2ndMin(t));
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Second maximum", secondMax, statistics->GetScalarValue2ndMax(t));
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Count of minimum valued voxels",
+        static_cast<double>(std::count(values.begin(), values.end(), min)), statistics->GetCountOfMinValuedVoxels(t));
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Count of maximum valued voxels",
+        static_cast<double>(std::count(values.begin(), values.end(), max)), statistics->GetCountOfMaxValuedVoxels(t));
+    }
+  }
+
+  void CheckHistogram(mitk::Image* image)
+  {
+    mitk::ImageStatisticsHolder* statistics = image->GetStatistics();
+    for (unsigned int t = 0; t < image->GetDimension(3); ++t)
+    {
+      const mitk::ImageStatisticsHolder::HistogramType* histogram = statistics->GetScalarHistogram(t);
+      CPPUNIT_ASSERT_MESSAGE("Histogram exists", histogram != nullptr);
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("256 bins", 256u, static_cast<unsigned int>(histogram->GetSize(0)));
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Every pixel is counted",
+        static_cast<double>(image->GetDimension(0)) * image->GetDimension(1) * image->GetDimension(2),
+        static_cast<double>(histogram->GetTotalFrequency()));
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("The minimum is in the first bin",
+        static_cast<double>(statistics->GetCountOfMinValuedVoxels(t)) <= histogram->GetFrequency(0), true);
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("The maximum is in the last bin",
+        static_cast<double>(statistics->GetCountOfMaxValuedVoxels(t)) <= histogram->GetFrequency(255), true);
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("The histogram starts at the minimum",
+        statistics->GetScalarValueMin(t), histogram->GetBinMin(0, 0));
+    }
+  }
+
+public:
+
+  void GetScalarValues_ShortImage_EqualSortedValues()
+  {
+    mitk::Image::Pointer image = mitk::ImageGenerator::GenerateRandomImage<short>(64, 48, 20, 3, 1, 1, 1, 2000.0, -1000.0);
+    this->CheckStatistics<short>(image);
+  }
+
+  void GetScalarValues_FloatImage_EqualSortedValues()
+  {
+    mitk::Image::Pointer image = mitk::ImageGenerator::GenerateRandomImage<float>(64, 48, 20, 3, 1, 1, 1, 1.0, -1.0);
+    this->CheckStatistics<float>(image);
+  }
+
+  void GetScalarHistogram_ShortImage_CountsAllPixels()
+  {
+    mitk::Image::Pointer image = mitk::ImageGenerator::GenerateRandomImage<short>(64, 48, 20, 2, 1, 1, 1, 2000.0, -1000.0);
+    this->CheckHistogram(image);
+  }
+
+  void GetScalarHistogram_FloatImage_CountsAllPixels()
+  {
+    mitk::Image::Pointer image = mitk::ImageGenerator::GenerateRandomImage<float>(64, 48, 20, 2, 1, 1, 1, 1.0, -1.0);
+    this->CheckHistogram(image);
+  }
+
+  void ComputeImageStatisticsInBackground_EqualSortedValues()
+  {
+    mitk::Image::Pointer image = mitk::ImageGenerator::GenerateRandomImage<unsigned char>(128, 128, 64, 4, 1, 1, 1, 255.0, 0.0);
+    image->GetStatistics()->ComputeImageStatisticsInBackground();
+    this->CheckStatistics<unsigned char>(image);
+    this->CheckHistogram(image);
+    CPPUNIT_ASSERT_MESSAGE("The background computation is finished", !image->GetStatistics()->IsComputingInBackground());
+  }
+
+  void ComputeImageStatisticsInBackground_ImageModifiedAfterwards_Recomputed()
+  {
+    mitk::Image::Pointer image = mitk::ImageGenerator::GenerateRandomImage<short>(64, 64, 32, 2, 1, 1, 1, 100.0, 0.0);
+    image->GetStatistics()->ComputeImageStatisticsInBackground();
+    while (image->GetStatistics()->IsComputingInBackground())
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    short* data = static_cast<short*>(image->GetVolumeData(1)->GetData());
+    data[0] = 1000;
+    data[1] = -1000;
+    image->Modified();
+
+    this->CheckStatistics<short>(image);
+  }
+
+  void GetScalarValues_ConstantImage_SecondExtremaEqualExtrema()
+  {
+    mitk::Image::Pointer image = mitk::ImageGenerator::GenerateGradientImage<unsigned short>(16, 16, 4);
+    unsigned short* data = static_cast<unsigned short*>(image->GetVolumeData(0)->GetData());
+    std::fill(data, data + 16 * 16 * 4, 7);
+    image->Modified();
+
+    mitk::ImageStatisticsHolder* statistics = image->GetStatistics();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Minimum", 7.0, statistics->GetScalarValueMin());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Second minimum", 7.0, statistics->GetScalarValue2ndMin());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Second maximum", 7.0, statistics->GetScalarValue2ndMax());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Count of minimum valued voxels", 1024.0, statistics->GetCountOfMinValuedVoxels());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkImageStatisticsHolder)
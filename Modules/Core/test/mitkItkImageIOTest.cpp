@@ -25,9 +25,17 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "itksys/SystemTools.hxx"
 #include <itkImageRegionIterator.h>
-
+#include <itkByteSwapper.h>
+#include <itkImageFileReader.h>
+#include <itkImageFileWriter.h>
+#include <itkNrrdImageIO.h>
+#include <mitkImageCast.h>
+#include <mitkImageGenerator.h>
+
+#include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <vector>
 
 #ifdef WIN32
 #include "process.h"
@@ -47,6 +55,10 @@ class mitkItkImageIOTestSuite : public mitk::TestFixture
   MITK_TEST(TestWrite3DImageWithTwoPlanes);
   MITK_TEST(TestWrite3DplusT_ArbitraryTG);
   MITK_TEST(TestWrite3DplusT_ProportionalTG);
+  MITK_TEST(TestReadRawNrrd_MappedDataEqualsFileAndCopiedOnWrite);
+  MITK_TEST(TestReadRawMHD_MappedDataEqualsFile);
+  MITK_TEST(TestWriteOverMappedNrrd_MappedDataUnchanged);
+  MITK_TEST(TestWriteNrrd_ChunkedGzip_SameHeaderAsItkAndReadableByItk);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -96,6 +108,161 @@ public:
     // TODO
   }
 
+  void TestReadRawNrrd_MappedDataEqualsFileAndCopiedOnWrite()
+  {
+    std::ofstream headerStream;
+    const std::string headerFilePath = mitk::IOUtil::CreateTemporaryFile(headerStream, "XXXXXX.nhdr");
+    const std::string rawFilePath = headerFilePath.substr(0, headerFilePath.size() - 5) + ".raw";
+    headerStream << "NRRD0004\ntype: short\ndimension: 4\nsizes: 32 24 16 3\nencoding: raw\n"
+                 << "endian: " << (itk::ByteSwapper<int>::SystemIsBigEndian() ? "big" : "little") << "\n"
+                 << "byte skip: 6\ndata file: " << itksys::SystemTools::GetFilenameName(rawFilePath) << "\n";
+    headerStream.close();
+
+    const std::vector<short> pixels = this->WriteRawFile<short>(rawFilePath, 32 * 24 * 16 * 3, 6);
+    mitk::Image::Pointer image = mitk::IOUtil::LoadImage(headerFilePath);
+    this->CheckRawPixels(image, pixels);
+
+    // writing to the image must not change the file
+    short* data = static_cast<short*>(image->GetVolumeData(2)->GetData());
+    data[0] = static_cast<short>(pixels[32 * 24 * 16 * 2] + 1);
+    mitk::Image::Pointer reloadedImage = mitk::IOUtil::LoadImage(headerFilePath);
+    this->CheckRawPixels(reloadedImage, pixels);
+
+    std::remove(headerFilePath.c_str());
+    std::remove(rawFilePath.c_str());
+  }
+
+  void TestReadRawMHD_MappedDataEqualsFile()
+  {
+    std::ofstream headerStream;
+    const std::string headerFilePath = mitk::IOUtil::CreateTemporaryFile(headerStream, "XXXXXX.mhd");
+    const std::string rawFilePath = headerFilePath.substr(0, headerFilePath.size() - 4) + ".raw";
+    headerStream << "ObjectType = Image\nNDims = 3\nDimSize = 40 30 20\nElementType = MET_FLOAT\n"
+                 << "BinaryData = True\nCompressedData = False\n"
+                 << "ElementByteOrderMSB = " << (itk::ByteSwapper<int>::SystemIsBigEndian() ? "True" : "False") << "\n"
+                 << "ElementDataFile = " << itksys::SystemTools::GetFilenameName(rawFilePath) << "\n";
+    headerStream.close();
+
+    const std::vector<float> pixels = this->WriteRawFile<float>(rawFilePath, 40 * 30 * 20, 0);
+    mitk::Image::Pointer image = mitk::IOUtil::LoadImage(headerFilePath);
+    this->CheckRawPixels(image, pixels);
+
+    std::remove(headerFilePath.c_str());
+    std::remove(rawFilePath.c_str());
+  }
+
+  void TestWriteNrrd_ChunkedGzip_SameHeaderAsItkAndReadableByItk()
+  {
+    typedef itk::Image<short, 3> ItkImageType;
+    mitk::Image::Pointer image = mitk::ImageGenerator::GenerateRandomImage<short>(64, 48, 20, 1, 0.5, 0.75, 2.0, 100.0, -100.0);
+    const std::string chunkedFilePath = mitk::IOUtil::CreateTemporaryFile("ChunkedGzipXXXXXX.nrrd");
+    mitk::IOUtil::Save(image, chunkedFilePath);
+
+    ItkImageType::Pointer itkImage;
+    mitk::CastToItkImage(image, itkImage);
+    const std::string itkFilePath = mitk::IOUtil::CreateTemporaryFile("ItkGzipXXXXXX.nrrd");
+    itk::ImageFileWriter<ItkImageType>::Pointer writer = itk::ImageFileWriter<ItkImageType>::New();
+    writer->SetImageIO(itk::NrrdImageIO::New());
+    writer->SetInput(itkImage);
+    writer->SetFileName(itkFilePath);
+    writer->UseCompressionOn();
+    writer->Update();
+
+    CPPUNIT_ASSERT_MESSAGE("The header fields equal the ones of the ImageIO",
+      this->ReadNrrdHeaderFields(chunkedFilePath) == this->ReadNrrdHeaderFields(itkFilePath));
+
+    // ITK reads the concatenated gzip members one after the other
+    itk::ImageFileReader<ItkImageType>::Pointer reader = itk::ImageFileReader<ItkImageType>::New();
+    reader->SetFileName(chunkedFilePath);
+    reader->Update();
+    const short* pixels = static_cast<const short*>(image->GetVolumeData(0)->GetData());
+    const std::size_t numberOfPixels = 64 * 48 * 20;
+    CPPUNIT_ASSERT_MESSAGE("ITK reads the pixels of the chunked file",
+      std::equal(pixels, pixels + numberOfPixels, reader->GetOutput()->GetBufferPointer()));
+
+    mitk::Image::Pointer chunkedImage = mitk::IOUtil::LoadImage(chunkedFilePath);
+    const short* readPixels = static_cast<const short*>(chunkedImage->GetVolumeData(0)->GetData());
+    CPPUNIT_ASSERT_MESSAGE("The pixels are read in parallel chunks", std::equal(pixels, pixels + numberOfPixels, readPixels));
+    CPPUNIT_ASSERT_MESSAGE("TimeGeometries are equal.",
+      mitk::Equal(*(image->GetTimeGeometry()), *(chunkedImage->GetTimeGeometry()), mitk::eps, true));
+
+    std::remove(chunkedFilePath.c_str());
+    std::remove(itkFilePath.c_str());
+  }
+
+  /** the field lines of a NRRD header, without the magic, comments and key/value pairs */
+  std::vector<std::string> ReadNrrdHeaderFields(const std::string& fileName)
+  {
+    std::vector<std::string> fields;
+    std::ifstream stream(fileName.c_str(), std::ios::binary);
+    std::string line;
+    while (std::getline(stream, line) && !line.empty())
+    {
+      if (line.compare(0, 4, "NRRD") != 0 && line[0] != '#' && line.find(":=") == std::string::npos)
+      {
+        fields.push_back(line);
+      }
+    }
+    return fields;
+  }
+
+  void TestWriteOverMappedNrrd_MappedDataUnchanged()
+  {
+    std::ofstream headerStream;
+    const std::string filePath = mitk::IOUtil::CreateTemporaryFile(headerStream, "XXXXXX.nrrd");
+    headerStream << "NRRD0004\ntype: short\ndimension: 3\nsizes: 64 64 32\nencoding: raw\n"
+                 << "endian: " << (itk::ByteSwapper<int>::SystemIsBigEndian() ? "big" : "little") << "\n\n";
+    const std::size_t headerSize = static_cast<std::size_t>(headerStream.tellp());
+    headerStream.close();
+
+    // appends the pixels after the header, at an offset aligned to the component size
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Header size is even", std::size_t(0), headerSize % sizeof(short));
+    std::vector<short> pixels(64 * 64 * 32);
+    for (std::size_t i = 0; i < pixels.size(); ++i)
+    {
+      pixels[i] = static_cast<short>(static_cast<int>((i * 7919) % 1000) - 500);
+    }
+    std::ofstream rawStream(filePath.c_str(), std::ios::binary | std::ios::app);
+    rawStream.write(reinterpret_cast<const char*>(pixels.data()), pixels.size() * sizeof(short));
+    rawStream.close();
+
+    // the compressed file is smaller, truncating the mapped file would make the pages of the image invalid
+    mitk::Image::Pointer image = mitk::IOUtil::LoadImage(filePath);
+    mitk::IOUtil::Save(image, filePath);
+    this->CheckRawPixels(image, pixels);
+    this->CheckRawPixels(mitk::IOUtil::LoadImage(filePath), pixels);
+
+    std::remove(filePath.c_str());
+  }
+
+  template <typename TPixel>
+  std::vector<TPixel> WriteRawFile(const std::string& fileName, std::size_t numberOfPixels, std::size_t headerSize)
+  {
+    std::vector<TPixel> pixels(numberOfPixels);
+    for (std::size_t i = 0; i < numberOfPixels; ++i)
+    {
+      pixels[i] = static_cast<TPixel>(static_cast<int>((i * 7919) % 1000) - 500);
+    }
+    std::ofstream rawStream(fileName.c_str(), std::ios::binary);
+    rawStream << std::string(headerSize, 'x');
+    rawStream.write(reinterpret_cast<const char*>(pixels.data()), numberOfPixels * sizeof(TPixel));
+    return pixels;
+  }
+
+  template <typename TPixel>
+  void CheckRawPixels(mitk::Image* image, const std::vector<TPixel>& pixels)
+  {
+    CPPUNIT_ASSERT_MESSAGE("Raw image was loaded", image != nullptr);
+    const std::size_t volumeSize = std::size_t(image->GetDimension(0)) * image->GetDimension(1) * image->GetDimension(2);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Number of pixels", pixels.size(), volumeSize * image->GetDimension(3));
+    for (unsigned int t = 0; t < image->GetDimension(3); ++t)
+    {
+      const TPixel* data = static_cast<const TPixel*>(image->GetVolumeData(t)->GetData());
+      CPPUNIT_ASSERT_MESSAGE("Pixels equal the raw file",
+        std::equal(data, data + volumeSize, pixels.begin() + t * volumeSize));
+    }
+  }
+
   std::string AppendExtension(const std::string &filename, const char *extension)
   {
     std::string new_filename = filename;
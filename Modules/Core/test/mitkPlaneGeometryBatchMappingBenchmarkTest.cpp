@@ -0,0 +1,94 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkTestingMacros.h>
+#include <mitkPlaneGeometry.h>
+
+#include <itkTimeProbe.h>
+
+#include <random>
+#include <vector>
+
+/**Documentation
+ *  Logs the time of mapping one million points onto an oblique plane with the ITK transform, with the cached
+ *  transform per point and with the batch Map(). Not run by ctest, start it from the test driver:
+ *  MitkCoreTestDriver mitkPlaneGeometryBatchMappingBenchmarkTest
+ */
+int mitkPlaneGeometryBatchMappingBenchmarkTest(int, char*[])
+{
+  MITK_TEST_BEGIN("mitkPlaneGeometryBatchMappingBenchmarkTest");
+
+  mitk::PlaneGeometry::Pointer plane = mitk::PlaneGeometry::New();
+  mitk::Vector3D right, bottom, spacing;
+  mitk::FillVector3D(right, 60, 80, 0);
+  mitk::FillVector3D(bottom, 0, 0, 50);
+  mitk::FillVector3D(spacing, 0.5, 2.0, 3.0);
+  plane->InitializeStandardPlane(right, bottom, &spacing);
+  mitk::Point3D origin;
+  mitk::FillVector3D(origin, 4.5, 7.3, 11.2);
+  plane->SetOrigin(origin);
+
+  mitk::AffineTransform3D::Pointer inverse = mitk::AffineTransform3D::New();
+  plane->GetIndexToWorldTransform()->GetInverse(inverse);
+
+  const std::size_t count = 1000000;
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<mitk::ScalarType> coordinate(-100.0, 200.0);
+  std::vector<mitk::Point3D> points(count);
+  for (std::size_t n = 0; n < count; ++n)
+  {
+    mitk::FillVector3D(points[n], coordinate(generator), coordinate(generator), coordinate(generator));
+  }
+  std::vector<mitk::Point2D> itkMapped(count);
+  std::vector<mitk::Point2D> singleMapped(count);
+  std::vector<mitk::Point2D> batchMapped(count);
+
+  // Map(const Point3D&, Point2D&) as it was computed with the ITK transform before the transform was cached
+  itk::TimeProbe itkClock;
+  itkClock.Start();
+  for (std::size_t n = 0; n < count; ++n)
+  {
+    mitk::Point3D units = inverse->TransformPoint(points[n]);
+    itkMapped[n][0] = units[0] * plane->GetExtentInMM(0) / plane->GetExtent(0);
+    itkMapped[n][1] = units[1] * plane->GetExtentInMM(1) / plane->GetExtent(1);
+  }
+  itkClock.Stop();
+
+  itk::TimeProbe singleClock;
+  singleClock.Start();
+  for (std::size_t n = 0; n < count; ++n)
+  {
+    plane->Map(points[n], singleMapped[n]);
+  }
+  singleClock.Stop();
+
+  itk::TimeProbe batchClock;
+  batchClock.Start();
+  plane->Map(points.data(), batchMapped.data(), count);
+  batchClock.Stop();
+
+  MITK_INFO << "Mapping " << count << " points onto a plane: ITK transform " << itkClock.GetTotal() << " s, "
+            << "cached transform per point " << singleClock.GetTotal() << " s, batch " << batchClock.GetTotal() << " s";
+
+  bool allEqual = true;
+  for (std::size_t n = 0; n < count && allEqual; ++n)
+  {
+    allEqual = mitk::Equal(itkMapped[n], singleMapped[n], 1E-9) && mitk::Equal(itkMapped[n], batchMapped[n], 1E-9);
+  }
+  MITK_TEST_CONDITION(allEqual, "The cached and the batch mapping equal the ITK transform");
+
+  MITK_TEST_END();
+}
@@ -32,6 +32,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <fstream>
 #include <iomanip>
+#include <random>
+#include <thread>
+#include <vector>
 
 static const mitk::ScalarType testEps = 1E-9; // the epsilon used in this test == at least float precision.
 
@@ -55,6 +58,9 @@ class mitkPlaneGeometryTestSuite : public mitk::TestFixture
   // MITK_TEST(testPlaneGeometryInitializeOrder);
   MITK_TEST(TestIntersectionPoint);
   MITK_TEST(TestCase1210);
+  MITK_TEST(TestBatchMapping_ObliquePlane_EqualsItkTransform);
+  MITK_TEST(TestBatchMapping_TransformModified_CacheUpdated);
+  MITK_TEST(TestBatchMapping_ConcurrentThreads_EqualsItkTransform);
 
   CPPUNIT_TEST_SUITE_END();
 
@@ -66,6 +72,40 @@ private:
   mitk::ScalarType width, height;
   mitk::ScalarType widthInMM, heightInMM, thicknessInMM;
 
+  mitk::PlaneGeometry::Pointer CreateObliquePlane()
+  {
+    mitk::PlaneGeometry::Pointer plane = mitk::PlaneGeometry::New();
+    mitk::Vector3D obliqueRight, obliqueBottom, obliqueSpacing;
+    mitk::FillVector3D(obliqueRight, 60, 80, 0);
+    mitk::FillVector3D(obliqueBottom, 0, 0, 50);
+    mitk::FillVector3D(obliqueSpacing, 0.5, 2.0, 3.0);
+    plane->InitializeStandardPlane(obliqueRight, obliqueBottom, &obliqueSpacing);
+    plane->SetOrigin(origin);
+    return plane;
+  }
+
+  std::vector<mitk::Point3D> CreateRandomPoints(std::size_t count)
+  {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<mitk::ScalarType> coordinate(-100.0, 200.0);
+    std::vector<mitk::Point3D> points(count);
+    for (std::size_t n = 0; n < count; ++n)
+    {
+      mitk::FillVector3D(points[n], coordinate(generator), coordinate(generator), coordinate(generator));
+    }
+    return points;
+  }
+
+  // Map(const Point3D&, Point2D&) as it was computed with the ITK transform before the transform was cached
+  bool ItkMap(const mitk::PlaneGeometry* plane, const mitk::AffineTransform3D* inverse, const mitk::Point3D& pt3d_mm, mitk::Point2D& pt2d_mm)
+  {
+    mitk::Point3D pt3d_units = inverse->TransformPoint(pt3d_mm);
+    pt2d_mm[0] = pt3d_units[0] * plane->GetExtentInMM(0) / plane->GetExtent(0);
+    pt2d_mm[1] = pt3d_units[1] * plane->GetExtentInMM(1) / plane->GetExtent(1);
+    pt3d_units[2] = 0;
+    return const_cast<mitk::BaseGeometry::BoundingBoxType*>(plane->GetBoundingBox())->IsInside(pt3d_units);
+  }
+
 public:
 
   void setUp() override
@@ -956,5 +996,150 @@ private:
     //This eps is temporarily set to 10*mitk::eps. See bug #15037 for details.
     CPPUNIT_ASSERT_MESSAGE("Testing WorldToIndex(pt2d_mm, pt2d_units) and compare with expected:", mitk::Equal(pt2d_units, testpt2d_units, 10*mitk::eps));
   }
+
+  void TestBatchMapping_ObliquePlane_EqualsItkTransform()
+  {
+    mitk::PlaneGeometry::Pointer plane = this->CreateObliquePlane();
+    const mitk::AffineTransform3D* transform = plane->GetIndexToWorldTransform();
+    mitk::AffineTransform3D::Pointer inverse = mitk::AffineTransform3D::New();
+    transform->GetInverse(inverse);
+
+    const std::size_t count = 1000;
+    const std::vector<mitk::Point3D> points = this->CreateRandomPoints(count);
+
+    std::vector<mitk::Point2D> mapped(count);
+    std::vector<mitk::Point3D> projected(count);
+    std::vector<mitk::Point3D> units(count);
+    std::vector<mitk::Point3D> world(count);
+    std::vector<mitk::Point3D> backMapped(count);
+    std::vector<mitk::ScalarType> distances(count);
+    const bool allMappedInside = plane->Map(points.data(), mapped.data(), count);
+    const bool allProjectedInside = plane->Project(points.data(), projected.data(), count);
+    plane->BaseGeometry::WorldToIndex(points.data(), units.data(), count);
+    plane->BaseGeometry::IndexToWorld(units.data(), world.data(), count);
+    plane->Map(mapped.data(), backMapped.data(), count);
+    plane->SignedDistance(points.data(), distances.data(), count);
+
+    std::size_t numberOfInsidePoints = 0;
+    for (std::size_t n = 0; n < count; ++n)
+    {
+      mitk::Point2D expectedMapped;
+      const bool inside = this->ItkMap(plane, inverse, points[n], expectedMapped);
+      numberOfInsidePoints += inside ? 1 : 0;
+      CPPUNIT_ASSERT_MESSAGE("Batch Map(3D, 2D) equals the ITK transform", mitk::Equal(expectedMapped, mapped[n], testEps));
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Single point Map(3D, 2D) reports inside as the bounding box", inside, plane->Map(points[n], expectedMapped));
+
+      mitk::Point3D expectedUnits = inverse->TransformPoint(points[n]);
+      CPPUNIT_ASSERT_MESSAGE("Batch WorldToIndex equals the ITK transform", mitk::Equal(expectedUnits, units[n], testEps));
+      CPPUNIT_ASSERT_MESSAGE("Batch IndexToWorld inverts WorldToIndex", mitk::Equal(points[n], world[n], testEps));
+
+      expectedUnits[2] = 0;
+      CPPUNIT_ASSERT_MESSAGE("Batch Project equals the ITK transform", mitk::Equal(transform->TransformPoint(expectedUnits), projected[n], testEps));
+      CPPUNIT_ASSERT_MESSAGE("Batch Map(2D, 3D) returns the projected points", mitk::Equal(projected[n], backMapped[n], testEps));
+      CPPUNIT_ASSERT_MESSAGE("Batch SignedDistance equals SignedDistanceFromPlane",
+        mitk::Equal(plane->SignedDistanceFromPlane(points[n]), distances[n], testEps));
+    }
+    CPPUNIT_ASSERT_MESSAGE("Some random points are inside and some are outside", numberOfInsidePoints > 0 && numberOfInsidePoints < count);
+    CPPUNIT_ASSERT_MESSAGE("Batch Map is not inside if a point is outside", !allMappedInside && !allProjectedInside);
+
+    mitk::Point3D center = plane->GetCenter();
+    mitk::Point3D insidePoints[2] = { center, plane->GetOrigin() };
+    mitk::Point2D insideMapped[2];
+    CPPUNIT_ASSERT_MESSAGE("Batch Map is inside if all points are inside", plane->Map(insidePoints, insideMapped, 2));
+
+    plane->Project(insidePoints, insidePoints, 2);
+    CPPUNIT_ASSERT_MESSAGE("Project in place", mitk::Equal(plane->ProjectPointOntoPlane(center), insidePoints[0], testEps));
+  }
+
+  void TestBatchMapping_TransformModified_CacheUpdated()
+  {
+    mitk::Point3D point;
+    mitk::FillVector3D(point, 20.0, 30.0, 40.0);
+    mitk::Point3D units;
+    planegeometry->BaseGeometry::WorldToIndex(point, units);
+    mitk::Point2D mapped;
+    planegeometry->Map(point, mapped);
+
+    // changed through the transform itself, as interactors do
+    mitk::Vector3D offset;
+    mitk::FillVector3D(offset, 1.0, 2.0, 3.0);
+    mitk::AffineTransform3D::OutputVectorType newOffset = planegeometry->GetIndexToWorldTransform()->GetOffset() + offset;
+    planegeometry->GetIndexToWorldTransform()->SetOffset(newOffset);
+    mitk::Point3D movedUnits;
+    planegeometry->BaseGeometry::WorldToIndex(point + offset, movedUnits);
+    CPPUNIT_ASSERT_MESSAGE("WorldToIndex follows a modified transform", mitk::Equal(units, movedUnits, testEps));
+
+    mitk::Point3D world;
+    planegeometry->BaseGeometry::IndexToWorld(&units, &world, 1);
+    CPPUNIT_ASSERT_MESSAGE("IndexToWorld follows a modified transform", mitk::Equal(point + offset, world, testEps));
+
+    // changed through the geometry
+    mitk::Vector3D doubleSpacing;
+    mitk::FillVector3D(doubleSpacing, 2.0, 2.0, thicknessInMM);
+    planegeometry->SetSpacing(doubleSpacing);
+    planegeometry->BaseGeometry::WorldToIndex(point + offset, movedUnits);
+    CPPUNIT_ASSERT_MESSAGE("WorldToIndex follows a new spacing", mitk::Equal(units[0] / 2.0, movedUnits[0], testEps));
+    mitk::Point2D remapped;
+    planegeometry->Map(point + offset, remapped);
+    CPPUNIT_ASSERT_MESSAGE("Map follows a new spacing", mitk::Equal(mapped, remapped, testEps));
+
+    // replaced transform
+    mitk::AffineTransform3D::Pointer identity = mitk::AffineTransform3D::New();
+    planegeometry->SetIndexToWorldTransform(identity);
+    planegeometry->BaseGeometry::WorldToIndex(point, movedUnits);
+    CPPUNIT_ASSERT_MESSAGE("WorldToIndex follows a replaced transform", mitk::Equal(point, movedUnits, testEps));
+
+    // copies own their transform
+    mitk::PlaneGeometry::Pointer clone = planegeometry->Clone();
+    clone->SetOrigin(origin);
+    planegeometry->BaseGeometry::WorldToIndex(point, movedUnits);
+    CPPUNIT_ASSERT_MESSAGE("A modified clone does not change the original", mitk::Equal(point, movedUnits, testEps));
+  }
+
+  void TestBatchMapping_ConcurrentThreads_EqualsItkTransform()
+  {
+    mitk::PlaneGeometry::Pointer plane = this->CreateObliquePlane();
+    mitk::AffineTransform3D::Pointer inverse = mitk::AffineTransform3D::New();
+    plane->GetIndexToWorldTransform()->GetInverse(inverse);
+
+    const std::size_t count = 1000;
+    const std::vector<mitk::Point3D> points = this->CreateRandomPoints(count);
+    std::vector<mitk::Point2D> itkMapped(count);
+    for (std::size_t n = 0; n < count; ++n)
+    {
+      this->ItkMap(plane, inverse, points[n], itkMapped[n]);
+    }
+
+    // the threads fill the transform cache of the new geometry at the same time
+    mitk::PlaneGeometry::Pointer sharedPlane = plane->Clone();
+    const unsigned int numberOfThreads = 4;
+    std::vector< std::vector<mitk::Point2D> > threadMapped(numberOfThreads, std::vector<mitk::Point2D>(count));
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < numberOfThreads; ++i)
+    {
+      std::vector<mitk::Point2D>* mapped = &threadMapped[i];
+      const mitk::PlaneGeometry* geometry = sharedPlane;
+      const std::vector<mitk::Point3D>* input = &points;
+      threads.push_back(std::thread([geometry, input, mapped]()
+      {
+        for (std::size_t n = 0; n < input->size(); ++n)
+        {
+          geometry->Map((*input)[n], (*mapped)[n]);
+        }
+      }));
+    }
+    for (std::thread& thread : threads)
+    {
+      thread.join();
+    }
+
+    for (unsigned int i = 0; i < numberOfThreads; ++i)
+    {
+      for (std::size_t n = 0; n < count; ++n)
+      {
+        CPPUNIT_ASSERT_MESSAGE("Map in concurrent threads equals the ITK transform", mitk::Equal(itkMapped[n], threadMapped[i][n], testEps));
+      }
+    }
+  }
 };
 MITK_TEST_SUITE_REGISTRATION(mitkPlaneGeometry)
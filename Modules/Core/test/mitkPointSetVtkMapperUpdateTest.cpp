@@ -0,0 +1,169 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+//MITK
+#include <mitkRenderingTestHelper.h>
+#include <mitkPointSetVtkMapper2D.h>
+#include <mitkPointSetVtkMapper3D.h>
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+
+/**
+ * Checks that the point set mappers keep their render objects as long as nothing changed, and regenerate them
+ * when the point set, its geometry or the properties of its node are modified.
+ */
+class mitkPointSetVtkMapperUpdateTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkPointSetVtkMapperUpdateTestSuite);
+  MITK_TEST(Mapper2D_NothingChanged_NotRegenerated);
+  MITK_TEST(Mapper2D_PointSetModified_Regenerated);
+  MITK_TEST(Mapper2D_GeometryModified_Regenerated);
+  MITK_TEST(Mapper2D_PropertyModified_Regenerated);
+  MITK_TEST(Mapper3D_NothingChanged_NotRegenerated);
+  MITK_TEST(Mapper3D_PointSetModified_Regenerated);
+  MITK_TEST(Mapper3D_PointSizeModified_Regenerated);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  mitk::RenderingTestHelper m_RenderingTestHelper;
+  mitk::PointSet::Pointer m_PointSet;
+  mitk::DataNode::Pointer m_Node;
+
+  /** renders and returns the time the 2D mapper generated its render objects */
+  unsigned long RenderAndGetGenerateDataTime2D()
+  {
+    m_RenderingTestHelper.Render();
+    mitk::PointSetVtkMapper2D* mapper = dynamic_cast<mitk::PointSetVtkMapper2D*>(m_Node->GetMapper(mitk::BaseRenderer::Standard2D));
+    CPPUNIT_ASSERT_MESSAGE("The point set is rendered by a PointSetVtkMapper2D", mapper != nullptr);
+    mitk::BaseRenderer* renderer = mitk::BaseRenderer::GetInstance(m_RenderingTestHelper.GetVtkRenderWindow());
+    return mapper->m_LSH.GetLocalStorage(renderer)->m_LastUpdateTime.GetMTime();
+  }
+
+  /** renders and returns the time the 3D mapper generated its render objects */
+  unsigned long RenderAndGetGenerateDataTime3D()
+  {
+    m_RenderingTestHelper.Render();
+    mitk::PointSetVtkMapper3D* mapper = dynamic_cast<mitk::PointSetVtkMapper3D*>(m_Node->GetMapper(mitk::BaseRenderer::Standard3D));
+    CPPUNIT_ASSERT_MESSAGE("The point set is rendered by a PointSetVtkMapper3D", mapper != nullptr);
+    mitk::BaseRenderer* renderer = mitk::BaseRenderer::GetInstance(m_RenderingTestHelper.GetVtkRenderWindow());
+    return mapper->m_LSH.GetLocalStorage(renderer)->GetLastGenerateDataTime().GetMTime();
+  }
+
+public:
+
+  /**
+   * @brief mitkPointSetVtkMapperUpdateTestSuite Because the RenderingTestHelper does not have an
+   * empty default constructor, we need this constructor to initialize the helper with a
+   * resolution.
+   */
+  mitkPointSetVtkMapperUpdateTestSuite():
+    m_RenderingTestHelper(640, 480)
+  {}
+
+  void setUp() override
+  {
+    m_RenderingTestHelper = mitk::RenderingTestHelper(640, 480);
+
+    m_PointSet = mitk::PointSet::New();
+    mitk::Point3D point;
+    mitk::FillVector3D(point, 0.0, 0.0, 0.0);
+    m_PointSet->InsertPoint(0, point);
+    mitk::FillVector3D(point, 10.0, 20.0, 5.0);
+    m_PointSet->InsertPoint(1, point);
+    mitk::FillVector3D(point, 20.0, 0.0, 10.0);
+    m_PointSet->InsertPoint(2, point);
+
+    m_Node = mitk::DataNode::New();
+    m_Node->SetData(m_PointSet);
+    m_RenderingTestHelper.AddNodeToStorage(m_Node);
+
+    // the first renderings adjust the camera to the data
+    m_RenderingTestHelper.Render();
+  }
+
+  void tearDown() override
+  {
+    m_Node = nullptr;
+    m_PointSet = nullptr;
+  }
+
+  void Mapper2D_NothingChanged_NotRegenerated()
+  {
+    unsigned long generateDataTime = this->RenderAndGetGenerateDataTime2D();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("The render objects are kept if nothing changed",
+                                 generateDataTime, this->RenderAndGetGenerateDataTime2D());
+  }
+
+  void Mapper2D_PointSetModified_Regenerated()
+  {
+    unsigned long generateDataTime = this->RenderAndGetGenerateDataTime2D();
+    mitk::Point3D point;
+    mitk::FillVector3D(point, 5.0, 5.0, 5.0);
+    m_PointSet->InsertPoint(3, point);
+    CPPUNIT_ASSERT_MESSAGE("Inserting a point regenerates the render objects",
+                           generateDataTime < this->RenderAndGetGenerateDataTime2D());
+  }
+
+  void Mapper2D_GeometryModified_Regenerated()
+  {
+    unsigned long generateDataTime = this->RenderAndGetGenerateDataTime2D();
+    mitk::Vector3D translation;
+    mitk::FillVector3D(translation, 1.0, 2.0, 0.0);
+    m_PointSet->GetGeometry()->Translate(translation);
+    CPPUNIT_ASSERT_MESSAGE("Moving the geometry of the point set regenerates the render objects",
+                           generateDataTime < this->RenderAndGetGenerateDataTime2D());
+  }
+
+  void Mapper2D_PropertyModified_Regenerated()
+  {
+    unsigned long generateDataTime = this->RenderAndGetGenerateDataTime2D();
+    m_Node->SetFloatProperty("point 2D size", 12.0f);
+    CPPUNIT_ASSERT_MESSAGE("Changing a property regenerates the render objects",
+                           generateDataTime < this->RenderAndGetGenerateDataTime2D());
+  }
+
+  void Mapper3D_NothingChanged_NotRegenerated()
+  {
+    m_RenderingTestHelper.SetMapperIDToRender3D();
+    m_RenderingTestHelper.Render();
+    unsigned long generateDataTime = this->RenderAndGetGenerateDataTime3D();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("The render objects are kept if nothing changed",
+                                 generateDataTime, this->RenderAndGetGenerateDataTime3D());
+  }
+
+  void Mapper3D_PointSetModified_Regenerated()
+  {
+    m_RenderingTestHelper.SetMapperIDToRender3D();
+    unsigned long generateDataTime = this->RenderAndGetGenerateDataTime3D();
+    mitk::Point3D point;
+    mitk::FillVector3D(point, 5.0, 5.0, 5.0);
+    m_PointSet->InsertPoint(3, point);
+    CPPUNIT_ASSERT_MESSAGE("Inserting a point regenerates the render objects",
+                           generateDataTime < this->RenderAndGetGenerateDataTime3D());
+  }
+
+  void Mapper3D_PointSizeModified_Regenerated()
+  {
+    m_RenderingTestHelper.SetMapperIDToRender3D();
+    unsigned long generateDataTime = this->RenderAndGetGenerateDataTime3D();
+    m_Node->SetFloatProperty("pointsize", 3.0f);
+    CPPUNIT_ASSERT_MESSAGE("Changing the point size regenerates the render objects",
+                           generateDataTime < this->RenderAndGetGenerateDataTime3D());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkPointSetVtkMapperUpdate)
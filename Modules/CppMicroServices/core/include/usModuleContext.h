@@ -477,6 +477,18 @@ public:
     return result;
   }
 
+  /**
+   * Returns the generation of the framework service registry.
+   *
+   * <p>
+   * The generation changes whenever a service is registered or unregistered
+   * or the properties of a registered service are modified. Callers can keep
+   * the results of service lookups as long as the generation did not change.
+   *
+   * @return The current generation of the service registry.
+   */
+  long GetServiceRegistryGeneration() const;
+
   /**
    * Returns a <code>ServiceReference</code> object for a service that
    * implements and was registered under the specified class.
@@ -95,6 +95,11 @@ std::vector<ServiceReferenceU > ModuleContext::GetServiceReferences(const std::s
   return result;
 }
 
+long ModuleContext::GetServiceRegistryGeneration() const
+{
+  return d->module->coreCtx->services.GetGeneration();
+}
+
 ServiceReferenceU ModuleContext::GetServiceReference(const std::string& clazz)
 {
   return d->module->coreCtx->services.Get(d->module, clazz);
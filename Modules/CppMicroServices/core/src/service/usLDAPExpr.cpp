@@ -287,6 +287,24 @@ bool LDAPExpr::GetMatchedObjectClasses(ObjectClassSet& objClasses) const
   return false;
 }
 
+void LDAPExpr::GetRequiredEqualities(AttributeValueList& attrValues) const
+{
+  if (d->m_operator == EQ)
+  {
+    if (d->m_attrValue.find(LDAPExprConstants::WILDCARD()) == std::string::npos)
+    {
+      attrValues.push_back(std::make_pair(d->m_attrName, d->m_attrValue));
+    }
+  }
+  else if (d->m_operator == AND)
+  {
+    for (std::size_t i = 0; i < d->m_args.size( ); i++)
+    {
+      d->m_args[i].GetRequiredEqualities(attrValues);
+    }
+  }
+}
+
 std::string LDAPExpr::ToLower(const std::string& str)
 {
   std::string lowerStr(str);
@@ -29,6 +29,7 @@
 
 #include <vector>
 #include <string>
+#include <utility>
 
 US_BEGIN_NAMESPACE
 
@@ -57,6 +58,7 @@ public:
   typedef std::vector<std::string> StringList;
   typedef std::vector<StringList> LocalCache;
   typedef US_UNORDERED_SET_TYPE<std::string> ObjectClassSet;
+  typedef std::vector<std::pair<std::string, std::string> > AttributeValueList;
 
 
   /**
@@ -83,6 +85,15 @@ public:
    */
   bool GetMatchedObjectClasses(ObjectClassSet& objClasses) const;
 
+  /**
+   * Get the attribute value pairs which a property set must contain for this
+   * LDAP expression to match. These are the equality operands without wildcards
+   * of this expression or of nested AND expressions.
+   *
+   * \param attrValues The required attribute names and values will be added to attrValues.
+   */
+  void GetRequiredEqualities(AttributeValueList& attrValues) const;
+
   /**
    * Checks if this LDAP expression is "simple". The definition of
    * a simple filter is:
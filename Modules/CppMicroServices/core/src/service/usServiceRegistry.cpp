@@ -22,6 +22,8 @@
 #include <iterator>
 #include <stdexcept>
 #include <cassert>
+#include <algorithm>
+#include <cctype>
 
 #include "usServiceRegistry_p.h"
 #include "usServiceFactory.h"
@@ -34,6 +36,17 @@
 
 US_BEGIN_NAMESPACE
 
+static bool IsObjectClassKey(const std::string& key)
+{
+  const std::string& objectClass = ServiceConstants::OBJECTCLASS();
+  if (key.length() != objectClass.length()) return false;
+  for (std::size_t i = 0; i < key.length(); ++i)
+  {
+    if (::tolower(key[i]) != ::tolower(objectClass[i])) return false;
+  }
+  return true;
+}
+
 ServicePropertiesImpl ServiceRegistry::CreateServiceProperties(const ServiceProperties& in,
                                                                const std::vector<std::string>& classes,
                                                                bool isFactory, bool isPrototypeFactory,
@@ -67,6 +80,7 @@ ServicePropertiesImpl ServiceRegistry::CreateServiceProperties(const ServiceProp
 
 ServiceRegistry::ServiceRegistry(CoreModuleContext* coreCtx)
   : core(coreCtx)
+  , generation(0)
 {
 
 }
@@ -81,6 +95,8 @@ void ServiceRegistry::Clear()
   services.clear();
   serviceRegistrations.clear();
   classServices.clear();
+  classPropertyIndexes.clear();
+  filterExpressions.clear();
   core = 0;
 }
 
@@ -123,6 +139,7 @@ ServiceRegistrationBase ServiceRegistry::RegisterService(ModulePrivate* module,
           std::lower_bound(s.begin(), s.end(), res);
       s.insert(ip, res);
     }
+    InvalidateIndexes_unlocked(classes);
   }
 
   ServiceReferenceBase r = res.GetReference(std::string());
@@ -145,6 +162,29 @@ void ServiceRegistry::UpdateServiceRegistrationOrder(const ServiceRegistrationBa
     s.erase(std::remove(s.begin(), s.end(), sr), s.end());
     s.insert(std::lower_bound(s.begin(), s.end(), sr), sr);
   }
+  InvalidateIndexes_unlocked(classes);
+}
+
+void ServiceRegistry::ServicePropertiesChanged(const std::vector<std::string>& classes)
+{
+  MutexLock lock(mutex);
+  InvalidateIndexes_unlocked(classes);
+}
+
+long ServiceRegistry::GetGeneration() const
+{
+  MutexLock lock(mutex);
+  return generation;
+}
+
+void ServiceRegistry::InvalidateIndexes_unlocked(const std::vector<std::string>& classes)
+{
+  ++generation;
+  for (std::vector<std::string>::const_iterator i = classes.begin();
+       i != classes.end(); ++i)
+  {
+    classPropertyIndexes.erase(*i);
+  }
 }
 
 void ServiceRegistry::Get(const std::string& clazz,
@@ -203,7 +243,7 @@ void ServiceRegistry::Get_unlocked(const std::string& clazz, const std::string&
   {
     if (!filter.empty())
     {
-      ldap = LDAPExpr(filter);
+      ldap = GetFilter_unlocked(filter);
       LDAPExpr::ObjectClassSet matched;
       if (ldap.GetMatchedObjectClasses(matched))
       {
@@ -214,7 +254,15 @@ void ServiceRegistry::Get_unlocked(const std::string& clazz, const std::string&
           MapClassServices::const_iterator i = classServices.find(*className);
           if (i != classServices.end())
           {
-            std::copy(i->second.begin(), i->second.end(), std::back_inserter(v));
+            std::vector<ServiceRegistrationBase> candidates;
+            if (GetCandidates_unlocked(i->first, i->second, ldap, candidates))
+            {
+              std::copy(candidates.begin(), candidates.end(), std::back_inserter(v));
+            }
+            else
+            {
+              std::copy(i->second.begin(), i->second.end(), std::back_inserter(v));
+            }
           }
         }
         if (!v.empty())
@@ -253,7 +301,12 @@ void ServiceRegistry::Get_unlocked(const std::string& clazz, const std::string&
     }
     if (!filter.empty())
     {
-      ldap = LDAPExpr(filter);
+      ldap = GetFilter_unlocked(filter);
+      if (GetCandidates_unlocked(clazz, it->second, ldap, v))
+      {
+        s = v.begin();
+        send = v.end();
+      }
     }
   }
 
@@ -280,6 +333,96 @@ void ServiceRegistry::Get_unlocked(const std::string& clazz, const std::string&
   }
 }
 
+LDAPExpr ServiceRegistry::GetFilter_unlocked(const std::string& filter) const
+{
+  MapFilterExpressions::const_iterator i = filterExpressions.find(filter);
+  if (i != filterExpressions.end())
+  {
+    return i->second;
+  }
+
+  // invalid filters throw here and are not cached
+  LDAPExpr ldap(filter);
+  if (filterExpressions.size() >= MaxCachedFilters)
+  {
+    filterExpressions.clear();
+  }
+  filterExpressions.insert(std::make_pair(filter, ldap));
+  return ldap;
+}
+
+bool ServiceRegistry::GetCandidates_unlocked(const std::string& clazz,
+                                             const std::vector<ServiceRegistrationBase>& classRegs,
+                                             const LDAPExpr& ldap,
+                                             std::vector<ServiceRegistrationBase>& candidates) const
+{
+  LDAPExpr::AttributeValueList equalities;
+  ldap.GetRequiredEqualities(equalities);
+
+  bool narrowed = false;
+  for (LDAPExpr::AttributeValueList::const_iterator i = equalities.begin();
+       i != equalities.end(); ++i)
+  {
+    // the registrations are already restricted to the class
+    if (IsObjectClassKey(i->first)) continue;
+
+    const PropertyIndex& index = GetPropertyIndex_unlocked(clazz, classRegs, i->first);
+    std::vector<ServiceRegistrationBase> matching;
+    US_UNORDERED_MAP_TYPE<std::string, std::vector<ServiceRegistrationBase> >::const_iterator value =
+        index.valueServices.find(i->second);
+    if (value != index.valueServices.end())
+    {
+      std::merge(value->second.begin(), value->second.end(), index.unindexed.begin(), index.unindexed.end(),
+                 std::back_inserter(matching));
+    }
+    else
+    {
+      matching = index.unindexed;
+    }
+
+    if (!narrowed || matching.size() < candidates.size())
+    {
+      candidates.swap(matching);
+      narrowed = true;
+    }
+  }
+  return narrowed;
+}
+
+const ServiceRegistry::PropertyIndex& ServiceRegistry::GetPropertyIndex_unlocked(const std::string& clazz,
+                                                                                 const std::vector<ServiceRegistrationBase>& classRegs,
+                                                                                 const std::string& key) const
+{
+  MapPropertyIndexes& indexes = classPropertyIndexes[clazz];
+  MapPropertyIndexes::iterator i = indexes.find(key);
+  if (i != indexes.end())
+  {
+    return i->second;
+  }
+
+  PropertyIndex& index = indexes[key];
+  for (std::vector<ServiceRegistrationBase>::const_iterator s = classRegs.begin();
+       s != classRegs.end(); ++s)
+  {
+    // look up the key the same way LDAPExpr::Evaluate does
+    const ServicePropertiesImpl& props = s->d->properties;
+    int propIndex = props.FindCaseSensitive(key);
+    if (propIndex < 0) propIndex = props.Find(key);
+    if (propIndex < 0) continue;
+
+    const Any& value = props.Value(propIndex);
+    if (value.Type() == typeid(std::string))
+    {
+      index.valueServices[ref_any_cast<std::string>(value)].push_back(*s);
+    }
+    else if (!value.Empty())
+    {
+      index.unindexed.push_back(*s);
+    }
+  }
+  return index;
+}
+
 void ServiceRegistry::RemoveServiceRegistration(const ServiceRegistrationBase& sr)
 {
   MutexLock lock(mutex);
@@ -303,6 +446,7 @@ void ServiceRegistry::RemoveServiceRegistration(const ServiceRegistrationBase& s
       classServices.erase(*i);
     }
   }
+  InvalidateIndexes_unlocked(classes);
 }
 
 void ServiceRegistry::GetRegisteredByModule(ModulePrivate* p,
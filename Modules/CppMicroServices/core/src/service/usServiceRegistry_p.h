@@ -27,6 +27,7 @@
 #include "usServiceRegistration.h"
 
 #include "usThreads_p.h"
+#include "usLDAPExpr_p.h"
 
 US_BEGIN_NAMESPACE
 
@@ -116,6 +117,22 @@ public:
   void UpdateServiceRegistrationOrder(const ServiceRegistrationBase& sr,
                                       const std::vector<std::string>& classes);
 
+  /**
+   * Service properties changed, drop the property indexes
+   * of the classes of the service.
+   *
+   * @param classes The class names under which the service is registered.
+   */
+  void ServicePropertiesChanged(const std::vector<std::string>& classes);
+
+  /**
+   * Get the generation of the registry. It is incremented whenever a
+   * service is registered, unregistered or its properties change.
+   *
+   * @return The current generation.
+   */
+  long GetGeneration() const;
+
   /**
    * Get all services implementing a certain class.
    * Only used internally by the framework.
@@ -173,11 +190,67 @@ private:
 
   friend class ServiceHooks;
 
+  /**
+   * Registrations of one class grouped by the string value of a property.
+   * Registrations with a non-string value for the property are kept in
+   * <code>unindexed</code>, registrations without the property are left out.
+   * All lists keep the ranking order of the class.
+   */
+  struct PropertyIndex
+  {
+    US_UNORDERED_MAP_TYPE<std::string, std::vector<ServiceRegistrationBase> > valueServices;
+    std::vector<ServiceRegistrationBase> unindexed;
+  };
+
+  typedef US_UNORDERED_MAP_TYPE<std::string, PropertyIndex> MapPropertyIndexes;
+  typedef US_UNORDERED_MAP_TYPE<std::string, MapPropertyIndexes> MapClassPropertyIndexes;
+  typedef US_UNORDERED_MAP_TYPE<std::string, LDAPExpr> MapFilterExpressions;
+
+  /**
+   * Parsed filter strings are kept up to this number,
+   * the cache is cleared when it is exceeded.
+   */
+  static const std::size_t MaxCachedFilters = 512;
+
+  /**
+   * Mapping of class name to the property indexes built for it.
+   * Indexes are created on first use and dropped when a service
+   * of the class changes.
+   */
+  mutable MapClassPropertyIndexes classPropertyIndexes;
+
+  mutable MapFilterExpressions filterExpressions;
+
+  long generation;
+
   void Get_unlocked(const std::string& clazz, std::vector<ServiceRegistrationBase>& serviceRegs) const;
 
   void Get_unlocked(const std::string& clazz, const std::string& filter,
                     ModulePrivate* module, std::vector<ServiceReferenceBase>& serviceRefs) const;
 
+  /**
+   * Get the parsed filter from the cache or parse and cache it.
+   *
+   * @throws std::invalid_argument If the filter cannot be parsed.
+   */
+  LDAPExpr GetFilter_unlocked(const std::string& filter) const;
+
+  /**
+   * Narrow the registrations of a class down to the ones which can match the
+   * required equalities of the filter, using the property index with the
+   * fewest candidates.
+   *
+   * @return <code>false</code> if the filter has no required equality
+   *         besides the object class, <code>true</code> otherwise.
+   */
+  bool GetCandidates_unlocked(const std::string& clazz, const std::vector<ServiceRegistrationBase>& classRegs,
+                              const LDAPExpr& ldap, std::vector<ServiceRegistrationBase>& candidates) const;
+
+  const PropertyIndex& GetPropertyIndex_unlocked(const std::string& clazz, const std::vector<ServiceRegistrationBase>& classRegs,
+                                                 const std::string& key) const;
+
+  void InvalidateIndexes_unlocked(const std::vector<std::string>& classes);
+
   // purposely not implemented
   ServiceRegistry(const ServiceRegistry&);
   ServiceRegistry& operator=(const ServiceRegistry&);
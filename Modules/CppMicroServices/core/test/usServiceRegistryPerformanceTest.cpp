@@ -204,6 +204,7 @@ public:
   void TestAddListeners();
   void TestRegisterServices();
 
+  void TestFilteredLookups();
   void TestModifyServices();
   void TestUnregisterServices();
 
@@ -358,6 +359,31 @@ void ServiceRegistryPerformanceTest::RegisterServices(int n)
   }
 }
 
+void ServiceRegistryPerformanceTest::TestFilteredLookups()
+{
+  const int nLookups = 10000;
+  Log() << "Look up " << nLookups << " services by their service.pid, and check that each lookup returns one service\n";
+
+  std::vector<std::string> filters;
+  for(int i = 0; i < nServices; i++)
+  {
+    std::stringstream ss;
+    ss << "(service.pid=my.service." << i << ")";
+    filters.push_back(ss.str());
+  }
+
+  std::size_t nFound = 0;
+  HighPrecisionTimer t;
+  t.Start();
+  for(int i = 0; i < nLookups; i++)
+  {
+    nFound += mc->GetServiceReferences<IPerfTestService>(filters[i % nServices]).size();
+  }
+  long long us = t.ElapsedMicro();
+  Log() << "filtered lookups took " << us << "us (" << static_cast<double>(us) / nLookups << "us per lookup)\n";
+  US_TEST_CONDITION_REQUIRED(nFound == static_cast<std::size_t>(nLookups), "Each filtered lookup must return exactly one service");
+}
+
 void ServiceRegistryPerformanceTest::TestModifyServices()
 {
   Log() << "Modify all services, and check that we get #of services ("
@@ -420,6 +446,7 @@ int usServiceRegistryPerformanceTest(int /*argc*/, char* /*argv*/[])
   perfTest.InitTestCase();
   perfTest.TestAddListeners();
   perfTest.TestRegisterServices();
+  perfTest.TestFilteredLookups();
   perfTest.TestModifyServices();
   perfTest.TestUnregisterServices();
   perfTest.CleanupTestCase();
@@ -127,6 +127,62 @@ void TestServicePropertiesUpdate()
   US_TEST_CONDITION_REQUIRED(context->GetServiceReferences<ITestServiceA>().empty(), "Testing service count")
 }
 
+void TestFilteredServiceLookups()
+{
+  struct TestServiceA : public ITestServiceA
+  {
+  };
+
+  ModuleContext* context = GetModuleContext();
+
+  TestServiceA s1;
+  TestServiceA s2;
+  TestServiceA s3;
+  ServiceProperties props1;
+  props1["mimetype"] = std::string("image/nrrd");
+  ServiceProperties props2;
+  props2["mimetype"] = std::string("image/png");
+  ServiceProperties props3;
+  std::vector<std::string> mimeTypes;
+  mimeTypes.push_back("image/png");
+  mimeTypes.push_back("image/nrrd");
+  props3["MimeType"] = mimeTypes;
+
+  long generation = context->GetServiceRegistryGeneration();
+  ServiceRegistration<ITestServiceA> reg1 = context->RegisterService<ITestServiceA>(&s1, props1);
+  ServiceRegistration<ITestServiceA> reg2 = context->RegisterService<ITestServiceA>(&s2, props2);
+  ServiceRegistration<ITestServiceA> reg3 = context->RegisterService<ITestServiceA>(&s3, props3);
+  US_TEST_CONDITION(context->GetServiceRegistryGeneration() != generation, "Testing generation change on registration")
+
+  const std::string nrrdFilter = "(&(objectclass=ITestServiceA)(mimetype=image/nrrd))";
+  US_TEST_CONDITION_REQUIRED(context->GetServiceReferences<ITestServiceA>("(mimetype=image/nrrd)").size() == 2, "Testing string and list properties")
+  US_TEST_CONDITION_REQUIRED(context->GetServiceReferences("", nrrdFilter).size() == 2, "Testing lookup without class name")
+  US_TEST_CONDITION_REQUIRED(context->GetServiceReferences<ITestServiceA>("(mimetype=image/jpeg)").empty(), "Testing unknown property value")
+  US_TEST_CONDITION_REQUIRED(context->GetServiceReferences<ITestServiceA>("(mimetype=image/*)").size() == 3, "Testing wildcard filter")
+  US_TEST_CONDITION_REQUIRED(context->GetServiceReferences<ITestServiceA>("(|(mimetype=image/png)(mimetype=image/nrrd))").size() == 3, "Testing OR filter")
+
+  // change a property without changing the ranking
+  generation = context->GetServiceRegistryGeneration();
+  props2["mimetype"] = std::string("image/nrrd");
+  reg2.SetProperties(props2);
+  US_TEST_CONDITION(context->GetServiceRegistryGeneration() != generation, "Testing generation change on modification")
+  US_TEST_CONDITION_REQUIRED(context->GetServiceReferences<ITestServiceA>("(mimetype=image/nrrd)").size() == 3, "Testing modified property")
+  US_TEST_CONDITION_REQUIRED(context->GetServiceReferences<ITestServiceA>("(mimetype=image/png)").size() == 1, "Testing modified property")
+
+  generation = context->GetServiceRegistryGeneration();
+  reg1.Unregister();
+  US_TEST_CONDITION(context->GetServiceRegistryGeneration() != generation, "Testing generation change on unregistration")
+  US_TEST_CONDITION_REQUIRED(context->GetServiceReferences<ITestServiceA>("(mimetype=image/nrrd)").size() == 2, "Testing unregistered service")
+
+  generation = context->GetServiceRegistryGeneration();
+  context->GetServiceReferences<ITestServiceA>("(mimetype=image/nrrd)");
+  US_TEST_CONDITION(context->GetServiceRegistryGeneration() == generation, "Testing constant generation on lookups")
+
+  reg2.Unregister();
+  reg3.Unregister();
+  US_TEST_CONDITION_REQUIRED(context->GetServiceReferences<ITestServiceA>("(mimetype=image/nrrd)").empty(), "Testing service count")
+}
+
 
 int usServiceRegistryTest(int /*argc*/, char* /*argv*/[])
 {
@@ -135,6 +191,7 @@ int usServiceRegistryTest(int /*argc*/, char* /*argv*/[])
   TestServiceInterfaceId();
   TestMultipleServiceRegistrations();
   TestServicePropertiesUpdate();
+  TestFilteredServiceLookups();
 
   US_TEST_END()
 }
@@ -17,6 +17,19 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkImage.h"
 #include "mitkDemonsRegistration.h"
 
+#include <itkCommand.h>
+
+namespace
+{
+  typedef itk::Image<itk::Vector<float, 3>, 3> DeformationFieldType;
+
+  /** keeps the deformation field reported for every finished resolution level */
+  void CollectLevelDeformationField(itk::Object* caller, const itk::EventObject&, void* clientData)
+  {
+    mitk::DemonsRegistration* registration = dynamic_cast<mitk::DemonsRegistration*>(caller);
+    static_cast<std::vector<itk::DataObject::Pointer>*>(clientData)->push_back(registration->GetLevelDeformationField());
+  }
+}
 
 int mitkDemonsRegistrationTest(int /*argc*/, char* /*argv*/[])
 {
@@ -124,5 +137,41 @@ int mitkDemonsRegistrationTest(int /*argc*/, char* /*argv*/[])
   itk::Image<class itk::Vector<float, 3>,3>::Pointer deformationField = demonsRegistration->GetDeformationField();
   std::cout<<"[PASSED]"<<std::endl;
 
+  std::cout << "Perform multi-resolution registration: ";
+  std::vector<unsigned int> shrinkFactors;
+  shrinkFactors.push_back(4);
+  shrinkFactors.push_back(2);
+  shrinkFactors.push_back(1);
+  demonsRegistration->SetShrinkFactors(shrinkFactors);
+  demonsRegistration->SetRegistrationThreads(2);
+  std::vector<itk::DataObject::Pointer> levelFields;
+  itk::CStyleCommand::Pointer levelCommand = itk::CStyleCommand::New();
+  levelCommand->SetClientData(&levelFields);
+  levelCommand->SetCallback(&CollectLevelDeformationField);
+  demonsRegistration->AddObserver(mitk::DeformationFieldLevelEvent(), levelCommand);
+  demonsRegistration->Modified();
+  demonsRegistration->Update();
+  if (demonsRegistration->GetCurrentLevel() != shrinkFactors.size() ||
+      demonsRegistration->GetLevelDeformationField() == nullptr)
+  {
+    std::cout<<"[FAILED] not every resolution level was reported" <<std::endl;
+    return EXIT_FAILURE;
+  }
+  deformationField = demonsRegistration->GetDeformationField();
+  if (deformationField->GetLargestPossibleRegion().GetSize()[0] != dim[0])
+  {
+    std::cout<<"[FAILED] final deformation field does not have full resolution" <<std::endl;
+    return EXIT_FAILURE;
+  }
+  // the field of the coarsest level must not have been replaced by the later levels
+  DeformationFieldType* coarsestField = levelFields.empty() ? nullptr : dynamic_cast<DeformationFieldType*>(levelFields.front().GetPointer());
+  if (levelFields.size() != shrinkFactors.size() || coarsestField == nullptr ||
+      coarsestField->GetLargestPossibleRegion().GetSize()[0] != dim[0] / shrinkFactors.front())
+  {
+    std::cout<<"[FAILED] deformation field of the first level was not kept" <<std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout<<"[PASSED]"<<std::endl;
+
   return EXIT_SUCCESS;
 }
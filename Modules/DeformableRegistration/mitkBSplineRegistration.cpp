@@ -258,6 +258,11 @@ namespace mitk {
 
     std::cout << std::endl << "Starting Registration" << std::endl;
 
+    if (m_RegistrationThreads > 0)
+    {
+      registration->SetNumberOfThreads(m_RegistrationThreads);
+    }
+
     try
     {
       double tstart(clock());
@@ -332,6 +337,10 @@ namespace mitk {
     warper->SetOutputOrigin( movingImage->GetOrigin() );
     warper->SetOutputDirection( movingImage->GetDirection() );
     warper->SetDisplacementField( field );
+    if (m_RegistrationThreads > 0)
+    {
+      warper->SetNumberOfThreads(m_RegistrationThreads);
+    }
     warper->Update();
 
     typename InternalImageType::Pointer result = warper->GetOutput();
@@ -352,6 +361,7 @@ namespace mitk {
       fieldWriter->SetInput( field );
 
       fieldWriter->SetFileName( m_DeformationFileName );
+      fieldWriter->SetUseCompression( m_CompressDeformationField );
       try
       {
         fieldWriter->Update();
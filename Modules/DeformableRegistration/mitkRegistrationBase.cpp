@@ -20,6 +20,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 namespace mitk {
 
   RegistrationBase::RegistrationBase()
+    : m_RegistrationThreads(0),
+      m_CompressDeformationField(false),
+      m_CurrentLevel(0)
   {
     m_ReferenceImage = Image::New();
   }
@@ -35,6 +38,30 @@ namespace mitk {
     Modified();
   }
 
+  void RegistrationBase::SetShrinkFactors(const std::vector<unsigned int>& shrinkFactors)
+  {
+    m_ShrinkFactors = shrinkFactors;
+    Modified();
+  }
+
+  const std::vector<unsigned int>& RegistrationBase::GetShrinkFactors() const
+  {
+    return m_ShrinkFactors;
+  }
+
+  itk::DataObject* RegistrationBase::GetLevelDeformationField() const
+  {
+    return m_LevelDeformationField.GetPointer();
+  }
+
+  void RegistrationBase::SetLevelDeformationField(itk::DataObject* field)
+  {
+    m_LevelDeformationField = field;
+    MITK_INFO << "Finished resolution level " << m_CurrentLevel << " of " << m_ShrinkFactors.size();
+    this->InvokeEvent(DeformationFieldLevelEvent());
+    ++m_CurrentLevel;
+  }
+
   void RegistrationBase::SetProgress(const itk::EventObject& )
   {
     ProgressBar::GetInstance()->AddStepsToDo(1);
@@ -20,8 +20,23 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkImageToImageFilter.h"
 #include "MitkDeformableRegistrationExports.h"
 
+#include <itkCommand.h>
+#include <itkImageDuplicator.h>
+#include <itkMultiResolutionPDEDeformableRegistration.h>
+
+#include <algorithm>
+
+#include <vector>
+
 namespace mitk {
 
+  /*!
+  \brief Sent by registrations running in multi-resolution mode whenever a pyramid level is finished.
+
+  The intermediate deformation field of that level can be obtained with RegistrationBase::GetLevelDeformationField().
+  */
+  itkEventMacro( DeformationFieldLevelEvent, itk::AnyEvent );
+
   /*!
   \brief This class handles the images for the registration as well as taking care of the progress bar during the registration process.
   It is the base class for the registration classes.
@@ -47,6 +62,45 @@ namespace mitk {
     */
     virtual void SetReferenceImage( Image::Pointer fixedImage);
 
+    /*!
+    * \brief Sets the isotropic shrink factor of every resolution level, coarsest first, e.g. {4, 2, 1}.
+    *
+    * With more than one entry the registration runs in multi-resolution mode: every level starts from the
+    * expanded deformation field of the previous one and performs the configured number of iterations.
+    * An empty list (the default) registers at full resolution only. Only the demons registrations, which
+    * run through RunPDERegistration(), use the shrink factors.
+    */
+    void SetShrinkFactors(const std::vector<unsigned int>& shrinkFactors);
+
+    const std::vector<unsigned int>& GetShrinkFactors() const;
+
+    /*!
+    * \brief Sets the number of threads used by the registration filters. 0 keeps the ITK default.
+    *
+    * Named differently from itk::ProcessObject::SetNumberOfThreads(), which would otherwise be hidden.
+    */
+    itkSetMacro(RegistrationThreads, unsigned int);
+    itkGetMacro(RegistrationThreads, unsigned int);
+
+    /*!
+    * \brief Sets whether deformation fields written to disk are compressed. Default is false.
+    */
+    itkSetMacro(CompressDeformationField, bool);
+    itkGetMacro(CompressDeformationField, bool);
+
+    /*!
+    * \brief Returns the deformation field of the last finished resolution level, see DeformationFieldLevelEvent.
+    *
+    * The field is an itk::Image of itk::Vector<float, N> pixels with the dimension of the registered images.
+    * It is a copy that later levels do not change. Only the most recent level is kept.
+    */
+    itk::DataObject* GetLevelDeformationField() const;
+
+    /*!
+    * \brief Returns the number of resolution levels finished so far in the current run.
+    */
+    itkGetMacro(CurrentLevel, unsigned int);
+
   protected:
 
     /*!
@@ -74,9 +128,121 @@ namespace mitk {
     */
     virtual void SetRemainingProgress(int steps);
 
+    /*!
+    * \brief Runs \a filter on \a fixedImage and \a movingImage and returns the resulting deformation field.
+    *
+    * Depending on the shrink factors this is either a plain full resolution run or a multi-resolution run
+    * through itk::MultiResolutionPDEDeformableRegistration, which reports every finished level with a
+    * DeformationFieldLevelEvent.
+    */
+    template <class TRegistrationFilter, class TInternalImage, class TDeformationField>
+    typename TDeformationField::Pointer RunPDERegistration(TRegistrationFilter* filter,
+                                                           TInternalImage* fixedImage,
+                                                           TInternalImage* movingImage,
+                                                           unsigned int iterations);
+
+    /*!
+    * \brief Copies the output of a finished resolution level, which the next level overwrites, and passes it
+    * to SetLevelDeformationField().
+    */
+    template <class TDeformationField>
+    void OnLevelFinished(itk::Object* caller, const itk::EventObject&);
+
+    /*!
+    * \brief Keeps the deformation field of a finished resolution level and sends a DeformationFieldLevelEvent.
+    */
+    void SetLevelDeformationField(itk::DataObject* field);
+
     Image::Pointer m_ReferenceImage;
+
+    std::vector<unsigned int> m_ShrinkFactors;
+    unsigned int m_RegistrationThreads;
+    bool m_CompressDeformationField;
+
+    itk::DataObject::Pointer m_LevelDeformationField;
+    unsigned int m_CurrentLevel;
   };
 
+  template <class TDeformationField>
+  void RegistrationBase::OnLevelFinished(itk::Object* caller, const itk::EventObject&)
+  {
+    itk::ProcessObject* filter = dynamic_cast<itk::ProcessObject*>(caller);
+    if (filter == nullptr)
+      return;
+
+    TDeformationField* field = dynamic_cast<TDeformationField*>(filter->GetOutput(0));
+    if (field == nullptr)
+      return;
+
+    typename itk::ImageDuplicator<TDeformationField>::Pointer duplicator = itk::ImageDuplicator<TDeformationField>::New();
+    duplicator->SetInputImage(field);
+    duplicator->Update();
+    this->SetLevelDeformationField(duplicator->GetOutput());
+  }
+
+  template <class TRegistrationFilter, class TInternalImage, class TDeformationField>
+  typename TDeformationField::Pointer RegistrationBase::RunPDERegistration(TRegistrationFilter* filter,
+                                                                           TInternalImage* fixedImage,
+                                                                           TInternalImage* movingImage,
+                                                                           unsigned int iterations)
+  {
+    typedef itk::MultiResolutionPDEDeformableRegistration<TInternalImage, TInternalImage, TDeformationField, float> MultiResolutionType;
+    const unsigned int dimension = TInternalImage::ImageDimension;
+
+    if (m_RegistrationThreads > 0)
+    {
+      filter->SetNumberOfThreads(m_RegistrationThreads);
+    }
+
+    m_CurrentLevel = 0;
+    m_LevelDeformationField = nullptr;
+
+    if (m_ShrinkFactors.size() < 2)
+    {
+      filter->SetFixedImage(fixedImage);
+      filter->SetMovingImage(movingImage);
+      filter->SetNumberOfIterations(iterations);
+      filter->Update();
+      return filter->GetOutput();
+    }
+
+    const unsigned int numberOfLevels = m_ShrinkFactors.size();
+    typename MultiResolutionType::Pointer multiResolution = MultiResolutionType::New();
+    multiResolution->SetRegistrationFilter(filter);
+    multiResolution->SetFixedImage(fixedImage);
+    multiResolution->SetMovingImage(movingImage);
+    multiResolution->SetNumberOfLevels(numberOfLevels);
+
+    typename MultiResolutionType::FixedImagePyramidType::ScheduleType schedule(numberOfLevels, dimension);
+    std::vector<unsigned int> levelIterations(numberOfLevels, iterations);
+    for (unsigned int level = 0; level < numberOfLevels; ++level)
+    {
+      for (unsigned int d = 0; d < dimension; ++d)
+      {
+        schedule[level][d] = std::max(1u, m_ShrinkFactors[level]);
+      }
+    }
+    multiResolution->GetFixedImagePyramid()->SetSchedule(schedule);
+    multiResolution->GetMovingImagePyramid()->SetSchedule(schedule);
+    multiResolution->SetNumberOfIterations(&levelIterations[0]);
+    if (m_RegistrationThreads > 0)
+    {
+      multiResolution->SetNumberOfThreads(m_RegistrationThreads);
+    }
+
+    // the registration filter finishes once per level, right before its output is handed on to the next level
+    typename itk::MemberCommand<RegistrationBase>::Pointer levelCommand = itk::MemberCommand<RegistrationBase>::New();
+    levelCommand->SetCallbackFunction(this, &RegistrationBase::OnLevelFinished<TDeformationField>);
+    const unsigned long observerTag = filter->AddObserver(itk::EndEvent(), levelCommand);
+
+    multiResolution->Update();
+    filter->RemoveObserver(observerTag);
+
+    typename TDeformationField::Pointer field = multiResolution->GetOutput();
+    field->DisconnectPipeline();
+    return field;
+  }
+
 } // namespace mitk
 
 #endif // MITKREGISTRATIONBASE_H
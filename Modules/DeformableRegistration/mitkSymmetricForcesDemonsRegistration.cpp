@@ -126,13 +126,12 @@ namespace mitk {
 
       typename FixedImageCasterType::Pointer fixedImageCaster = FixedImageCasterType::New();
       fixedImageCaster->SetInput(fixedImage);
-      filter->SetFixedImage( fixedImageCaster->GetOutput() );
       typename MovingImageCasterType::Pointer movingImageCaster = MovingImageCasterType::New();
       movingImageCaster->SetInput(movingImage);
-      filter->SetMovingImage(movingImageCaster->GetOutput());
-      filter->SetNumberOfIterations( m_Iterations );
       filter->SetStandardDeviations( m_StandardDeviation );
-      filter->Update();
+      typename DeformationFieldType::Pointer deformationField =
+        this->RunPDERegistration<RegistrationFilterType, InternalImageType, DeformationFieldType>(
+          filter, fixedImageCaster->GetOutput(), movingImageCaster->GetOutput(), m_Iterations);
 
       typename WarperType::Pointer warper = WarperType::New();
       typename InterpolatorType::Pointer interpolator = InterpolatorType::New();
@@ -141,7 +140,7 @@ namespace mitk {
       warper->SetInterpolator( interpolator );
       warper->SetOutputSpacing( fixedImage->GetSpacing() );
       warper->SetOutputOrigin( fixedImage->GetOrigin() );
-      warper->SetDisplacementField( filter->GetOutput() );
+      warper->SetDisplacementField( deformationField );
       warper->Update();
       typename WriterType::Pointer      writer =  WriterType::New();
       typename CastFilterType::Pointer  caster =  CastFilterType::New();
@@ -162,7 +161,7 @@ namespace mitk {
         typedef DeformationFieldType  VectorImage2DType;
         typedef typename DeformationFieldType::PixelType Vector2DType;
 
-        typename VectorImage2DType::ConstPointer vectorImage2D = filter->GetOutput();
+        typename VectorImage2DType::ConstPointer vectorImage2D = deformationField;
 
         typename VectorImage2DType::RegionType  region2D = vectorImage2D->GetBufferedRegion();
         typename VectorImage2DType::IndexType   index2D  = region2D.GetIndex();
@@ -234,6 +233,7 @@ namespace mitk {
         m_DeformationField = vectorImage3D;
 
         writer3D->SetFileName( m_FieldName );
+        writer3D->SetUseCompression( m_CompressDeformationField );
 
         try
         {
@@ -251,9 +251,10 @@ namespace mitk {
       {
         typename FieldWriterType::Pointer      fieldwriter =  FieldWriterType::New();
         fieldwriter->SetFileName( m_FieldName );
-        fieldwriter->SetInput( filter->GetOutput() );
+        fieldwriter->SetInput( deformationField );
+        fieldwriter->SetUseCompression( m_CompressDeformationField );
         //m_DeformationField = filter->GetOutput();
-        m_DeformationField = (itk::Image<itk::Vector<float, 3>,3> *)(filter->GetOutput()); //see BUG #3732
+        m_DeformationField = (itk::Image<itk::Vector<float, 3>,3> *)(deformationField.GetPointer()); //see BUG #3732
         if(m_SaveField)
         {
           fieldwriter->Update();
@@ -19,6 +19,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <boost/numeric/conversion/converter.hpp>
 
+#include <algorithm>
+#include <queue>
+
 #include <mitkConnectomicsConstantsManager.h>
 
 mitk::ConnectomicsBetweennessHistogram::ConnectomicsBetweennessHistogram()
@@ -71,13 +74,99 @@ void mitk::ConnectomicsBetweennessHistogram::ComputeFromConnectomicsNetwork( Con
 void mitk::ConnectomicsBetweennessHistogram::CalculateUnweightedUndirectedBetweennessCentrality(
   NetworkType* boostGraph, IteratorType /*vertex_iterator_begin*/, IteratorType /*vertex_iterator_end*/ )
 {
-  boost::brandes_betweenness_centrality(
-    *boostGraph,
-    boost::centrality_map(
-    boost::make_iterator_property_map( m_CentralityMap.begin(), boost::get( &mitk::ConnectomicsNetwork::NetworkNode::id, *boostGraph ), double() )
-    ).vertex_index_map( boost::get( &mitk::ConnectomicsNetwork::NetworkNode::id, *boostGraph ) )
-    );
+  int numberOfNodes( boost::num_vertices( *boostGraph ) );
+  std::vector< BCMapType > dependencies( std::min( numberOfNodes, static_cast< int >( SourcesPerBlock ) ) );
+
+  for( int blockStart( 0 ); blockStart < numberOfNodes; blockStart += SourcesPerBlock )
+  {
+    int blockSize = std::min( static_cast< int >( SourcesPerBlock ), numberOfNodes - blockStart );
+
+#pragma omp parallel for schedule(dynamic)
+    for( int offset = 0; offset < blockSize; offset++ )
+    {
+      CalculateSingleSourceDependencies( boostGraph, boost::vertex( blockStart + offset, *boostGraph ), dependencies[ offset ] );
+    }
 
+    // sum up in source order, exactly as the sequential algorithm does
+    for( int offset( 0 ); offset < blockSize; offset++ )
+    {
+      for( int index( 0 ); index < numberOfNodes; index++ )
+      {
+        m_CentralityMap[ index ] += dependencies[ offset ][ index ];
+      }
+    }
+  }
+
+  // in an undirected graph every path has been counted from both of its ends
+  for( int index( 0 ); index < numberOfNodes; index++ )
+  {
+    m_CentralityMap[ index ] /= 2.0;
+  }
+}
+
+void mitk::ConnectomicsBetweennessHistogram::CalculateSingleSourceDependencies(
+  NetworkType* boostGraph, DescriptorType source, BCMapType& dependencies )
+{
+  int numberOfNodes( boost::num_vertices( *boostGraph ) );
+
+  std::vector< std::vector< DescriptorType > > incoming( numberOfNodes );
+  std::vector< int > distance( numberOfNodes, -1 );
+  std::vector< PathCountType > pathCount( numberOfNodes, 0 );
+  std::vector< double > dependency( numberOfNodes, 0.0 );
+  std::vector< DescriptorType > orderedVertices;
+  orderedVertices.reserve( numberOfNodes );
+
+  // breadth first search, counting the shortest paths to each vertex
+  std::queue< DescriptorType > queue;
+  distance[ source ] = 0;
+  pathCount[ source ] = 1;
+  queue.push( source );
+  while( !queue.empty() )
+  {
+    DescriptorType v = queue.front();
+    queue.pop();
+    orderedVertices.push_back( v );
+
+    OutEdgeIteratorType edge, edgeEnd;
+    for( boost::tie( edge, edgeEnd ) = boost::out_edges( v, *boostGraph ); edge != edgeEnd; ++edge )
+    {
+      DescriptorType w = boost::target( *edge, *boostGraph );
+      if( distance[ w ] < 0 )
+      {
+        distance[ w ] = distance[ v ] + 1;
+        pathCount[ w ] = pathCount[ v ];
+        incoming[ w ].push_back( v );
+        queue.push( w );
+      }
+      else if( distance[ w ] == distance[ v ] + 1 )
+      {
+        pathCount[ w ] += pathCount[ v ];
+        incoming[ w ].push_back( v );
+      }
+    }
+  }
+
+  // accumulate the dependencies from the farthest vertices back to the source
+  for( std::vector< DescriptorType >::reverse_iterator it = orderedVertices.rbegin(); it != orderedVertices.rend(); ++it )
+  {
+    DescriptorType w = *it;
+    for( unsigned int index( 0 ); index < incoming[ w ].size(); index++ )
+    {
+      DescriptorType v = incoming[ w ][ index ];
+      double factor = double( pathCount[ v ] ) / double( pathCount[ w ] );
+      factor *= ( 1.0 + dependency[ w ] );
+      dependency[ v ] += factor;
+    }
+  }
+
+  // the source does not lie on its own paths
+  dependency[ source ] = 0.0;
+
+  dependencies.assign( numberOfNodes, 0.0 );
+  for( int index( 0 ); index < numberOfNodes; index++ )
+  {
+    dependencies[ ( *boostGraph )[ boost::vertex( index, *boostGraph ) ].id ] = dependency[ index ];
+  }
 }
 
 void mitk::ConnectomicsBetweennessHistogram::CalculateWeightedUndirectedBetweennessCentrality(
@@ -54,14 +54,27 @@ namespace mitk {
     /* Typedefs */
     typedef mitk::ConnectomicsNetwork::NetworkType NetworkType;
     typedef boost::graph_traits< NetworkType >::vertex_iterator IteratorType;
+    typedef boost::graph_traits< NetworkType >::vertex_descriptor DescriptorType;
+    typedef boost::graph_traits< NetworkType >::out_edge_iterator OutEdgeIteratorType;
+    typedef boost::graph_traits< NetworkType >::degree_size_type PathCountType;
     typedef std::vector< double > BCMapType;
 
+    /** Number of sources whose dependencies are computed in parallel before they are accumulated */
+    static const int SourcesPerBlock = 64;
+
     /** @brief Creates a new histogram from the network source. */
     virtual void ComputeFromConnectomicsNetwork( ConnectomicsNetwork* source ) override;
 
-    /** Calculate betweenness centrality ignoring the weight of the edges */
+    /** \brief Calculate betweenness centrality ignoring the weight of the edges
+     *
+     * Follows boost::brandes_betweenness_centrality, but computes the dependencies of a block of sources in parallel.
+     * They are accumulated in source order, so the result is identical to the boost implementation.
+     */
     void CalculateUnweightedUndirectedBetweennessCentrality( NetworkType*, IteratorType, IteratorType );
 
+    /** Breadth first search from the source and back propagation of the dependencies of all other vertices on it, indexed by node id */
+    void CalculateSingleSourceDependencies( NetworkType*, DescriptorType source, BCMapType& dependencies );
+
     /** Calculate betweenness centrality taking into consideration the weight of the edges */
     void CalculateWeightedUndirectedBetweennessCentrality( NetworkType*, IteratorType, IteratorType );
 
@@ -16,6 +16,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkConnectomicsNetworkCreator.h"
 
+#include <algorithm>
 #include <sstream>
 #include <vector>
 
@@ -89,6 +90,39 @@ itk::Point<float, 3> mitk::ConnectomicsNetworkCreator::GetItkPoint(double point[
   return itkPoint;
 }
 
+namespace
+{
+  // the first fiber end point a label was found at, order is 2 * fiber + end point
+  struct LabelEncounter
+  {
+    long order;
+    itk::Index<3> index;
+  };
+
+  // a connection between two labels, oriented as found in its first fiber
+  struct LabelConnection
+  {
+    int firstFiber;
+    mitk::ConnectomicsNetworkCreator::ImageLabelPairType labels;
+    int weight;
+  };
+
+  typedef std::map< int, LabelEncounter > LabelEncounterMapType;
+  typedef std::map< std::pair< int, int >, LabelConnection > LabelConnectionMapType;
+
+  // labels and connections found in one chunk of consecutive fibers
+  struct FiberChunk
+  {
+    LabelEncounterMapType labels;
+    LabelConnectionMapType connections;
+  };
+
+  bool EarlierConnection( const LabelConnection& a, const LabelConnection& b )
+  {
+    return a.firstFiber < b.firstFiber;
+  }
+}
+
 void mitk::ConnectomicsNetworkCreator::CreateNetworkFromFibersAndSegmentation()
 {
 
@@ -102,32 +136,119 @@ void mitk::ConnectomicsNetworkCreator::CreateNetworkFromFibersAndSegmentation()
   vtkSmartPointer<vtkCellArray> vLines = fiberPolyData->GetLines();
   vLines->InitTraversal();
 
+  // the cell array can only be traversed sequentially, so remember where each fiber is stored
   int numFibers = m_FiberBundle->GetNumFibers();
+  std::vector< vtkIdType > numPointsInCells( numFibers, 0 );
+  std::vector< vtkIdType* > pointsInCells( numFibers, nullptr );
   for( int fiberID( 0 ); fiberID < numFibers; fiberID++ )
   {
-    vtkIdType   numPointsInCell(0);
-    vtkIdType*  pointsInCell(nullptr);
-    vLines->GetNextCell ( numPointsInCell, pointsInCell );
+    vLines->GetNextCell ( numPointsInCells[ fiberID ], pointsInCells[ fiberID ] );
+  }
+
+  int numChunks = ( numFibers + FibersPerChunk - 1 ) / FibersPerChunk;
+  std::vector< FiberChunk > chunks( numChunks );
+
+#pragma omp parallel for schedule(dynamic)
+  for( int chunkID = 0; chunkID < numChunks; chunkID++ )
+  {
+    FiberChunk& chunk = chunks[ chunkID ];
+    int chunkEnd = std::min( numFibers, ( chunkID + 1 ) * FibersPerChunk );
+
+    for( int fiberID( chunkID * FibersPerChunk ); fiberID < chunkEnd; fiberID++ )
+    {
+      TractType::Pointer singleTract = TractType::New();
+      for( int pointInCellID( 0 ); pointInCellID < numPointsInCells[ fiberID ] ; pointInCellID++)
+      {
+        // push back point, using the thread safe variant of GetPoint
+        double point[ 3 ];
+        fiberPolyData->GetPoint( pointsInCells[ fiberID ][ pointInCellID ], point );
+        singleTract->InsertElement( singleTract->Size(), GetItkPoint( point ) );
+      }
+
+      if ( singleTract->Size() == 0 )
+      {
+        continue;
+      }
+
+      ImageIndexPairType endPointIndices;
+      ImageLabelPairType labelpair = ReturnLabelForFiberTract( singleTract, m_MappingStrategy, endPointIndices );
+
+      // insert does not replace, so only the first encounter of each label is kept
+      LabelEncounter firstEncounter = { 2l * fiberID, endPointIndices.first };
+      LabelEncounter lastEncounter = { 2l * fiberID + 1, endPointIndices.second };
+      chunk.labels.insert( std::make_pair( labelpair.first, firstEncounter ) );
+      chunk.labels.insert( std::make_pair( labelpair.second, lastEncounter ) );
+
+      if( m_ZeroLabelInvalid && ( labelpair.first == 0 || labelpair.second == 0 ) )
+      {
+        MITK_DEBUG << "Connection aborted";
+        continue;
+      }
+
+      // check for loops (if they are not allowed)
+      if( !allowLoops && labelpair.first == labelpair.second )
+      {
+        continue;
+      }
+
+      std::pair< int, int > key( std::min( labelpair.first, labelpair.second ), std::max( labelpair.first, labelpair.second ) );
+      LabelConnection connection = { fiberID, labelpair, 0 };
+      chunk.connections.insert( std::make_pair( key, connection ) ).first->second.weight++;
+    }
+  }
+
+  // merge the chunks in fiber order, so earlier fibers take precedence just as in a sequential run
+  LabelEncounterMapType labels;
+  LabelConnectionMapType connections;
+  for( int chunkID( 0 ); chunkID < numChunks; chunkID++ )
+  {
+    labels.insert( chunks[ chunkID ].labels.begin(), chunks[ chunkID ].labels.end() );
 
-    TractType::Pointer singleTract = TractType::New();
-    for( int pointInCellID( 0 ); pointInCellID < numPointsInCell ; pointInCellID++)
+    for( LabelConnectionMapType::const_iterator it = chunks[ chunkID ].connections.begin(); it != chunks[ chunkID ].connections.end(); ++it )
     {
-      // push back point
-      PointType point = GetItkPoint( fiberPolyData->GetPoint( pointsInCell[ pointInCellID ] ) );
-      singleTract->InsertElement( singleTract->Size(), point );
+      std::pair< LabelConnectionMapType::iterator, bool > inserted = connections.insert( *it );
+      if( !inserted.second )
+      {
+        inserted.first->second.weight += it->second.weight;
+      }
     }
+  }
+  chunks.clear();
+
+  // create nodes and vertices in the order the labels were encountered, which determines the vertex ids
+  std::vector< std::pair< long, int > > labelOrder;
+  for( LabelEncounterMapType::const_iterator it = labels.begin(); it != labels.end(); ++it )
+  {
+    labelOrder.push_back( std::make_pair( it->second.order, it->first ) );
+  }
+  std::sort( labelOrder.begin(), labelOrder.end() );
+
+  for( unsigned int index( 0 ); index < labelOrder.size(); index++ )
+  {
+    int label = labelOrder[ index ].second;
+    CreateNewNode( label, labels[ label ].index, m_UseCoMCoordinates );
 
-    if ( singleTract && ( singleTract->Size() > 0 ) )
+    if( !( m_ZeroLabelInvalid && ( label == 0 ) ) )
     {
-      AddConnectionToNetwork(
-        ReturnAssociatedVertexPairForLabelPair(
-        ReturnLabelForFiberTract( singleTract, m_MappingStrategy )
-        )
-        );
-      m_AbortConnection = false;
+      ReturnAssociatedVertexForLabel( label );
     }
   }
 
+  // add the edges in the order they were first found
+  std::vector< LabelConnection > orderedConnections;
+  for( LabelConnectionMapType::const_iterator it = connections.begin(); it != connections.end(); ++it )
+  {
+    orderedConnections.push_back( it->second );
+  }
+  std::sort( orderedConnections.begin(), orderedConnections.end(), EarlierConnection );
+
+  for( unsigned int index( 0 ); index < orderedConnections.size(); index++ )
+  {
+    VertexType vertexA = m_LabelToVertexMap.find( orderedConnections[ index ].labels.first )->second;
+    VertexType vertexB = m_LabelToVertexMap.find( orderedConnections[ index ].labels.second )->second;
+    m_ConNetwork->AddEdge( vertexA, vertexB, m_ConNetwork->GetNode( vertexA ).id, m_ConNetwork->GetNode( vertexB ).id, orderedConnections[ index ].weight );
+  }
+
   // Prune unconnected nodes
   //m_ConNetwork->PruneUnconnectedSingleNodes();
 
@@ -189,31 +310,33 @@ mitk::ConnectomicsNetworkCreator::VertexType mitk::ConnectomicsNetworkCreator::R
 
 mitk::ConnectomicsNetworkCreator::ConnectionType mitk::ConnectomicsNetworkCreator::ReturnAssociatedVertexPairForLabelPair( ImageLabelPairType labelpair )
 {
-  //hand both labels through to the single label function
-  ConnectionType connection( ReturnAssociatedVertexForLabel(labelpair.first), ReturnAssociatedVertexForLabel(labelpair.second) );
+  //hand both labels through to the single label function, first label first
+  VertexType firstVertex = ReturnAssociatedVertexForLabel( labelpair.first );
+  VertexType secondVertex = ReturnAssociatedVertexForLabel( labelpair.second );
+  ConnectionType connection( firstVertex, secondVertex );
 
   return connection;
 }
 
-mitk::ConnectomicsNetworkCreator::ImageLabelPairType mitk::ConnectomicsNetworkCreator::ReturnLabelForFiberTract( TractType::Pointer singleTract, mitk::ConnectomicsNetworkCreator::MappingStrategy strategy)
+mitk::ConnectomicsNetworkCreator::ImageLabelPairType mitk::ConnectomicsNetworkCreator::ReturnLabelForFiberTract( TractType::Pointer singleTract, mitk::ConnectomicsNetworkCreator::MappingStrategy strategy, ImageIndexPairType& endPointIndices )
 {
   switch( strategy )
   {
   case EndElementPosition:
     {
-      return EndElementPositionLabel( singleTract );
+      return EndElementPositionLabel( singleTract, endPointIndices );
     }
   case JustEndPointVerticesNoLabel:
     {
-      return JustEndPointVerticesNoLabelTest( singleTract );
+      return JustEndPointVerticesNoLabelTest( singleTract, endPointIndices );
     }
   case EndElementPositionAvoidingWhiteMatter:
     {
-      return EndElementPositionLabelAvoidingWhiteMatter( singleTract );
+      return EndElementPositionLabelAvoidingWhiteMatter( singleTract, endPointIndices );
     }
   case PrecomputeAndDistance:
     {
-      return PrecomputeVertexLocationsBySegmentation( singleTract );
+      return PrecomputeVertexLocationsBySegmentation( singleTract, endPointIndices );
     }
   }
 
@@ -223,7 +346,7 @@ mitk::ConnectomicsNetworkCreator::ImageLabelPairType mitk::ConnectomicsNetworkCr
   return nullPair;
 }
 
-mitk::ConnectomicsNetworkCreator::ImageLabelPairType mitk::ConnectomicsNetworkCreator::EndElementPositionLabel( TractType::Pointer singleTract )
+mitk::ConnectomicsNetworkCreator::ImageLabelPairType mitk::ConnectomicsNetworkCreator::EndElementPositionLabel( TractType::Pointer singleTract, ImageIndexPairType& endPointIndices )
 {
   ImageLabelPairType labelpair;
 
@@ -258,22 +381,22 @@ mitk::ConnectomicsNetworkCreator::ImageLabelPairType mitk::ConnectomicsNetworkCr
     labelpair.first = firstLabel;
     labelpair.second = lastLabel;
 
-    // Add property to property map
-    CreateNewNode( firstLabel, firstElementSegIndex, m_UseCoMCoordinates );
-    CreateNewNode( lastLabel, lastElementSegIndex, m_UseCoMCoordinates );
+    // the nodes are created from these indices once the fibers have been mapped
+    endPointIndices.first = firstElementSegIndex;
+    endPointIndices.second = lastElementSegIndex;
   }
 
   return labelpair;
 }
 
-mitk::ConnectomicsNetworkCreator::ImageLabelPairType mitk::ConnectomicsNetworkCreator::PrecomputeVertexLocationsBySegmentation( TractType::Pointer /*singleTract*/ )
+mitk::ConnectomicsNetworkCreator::ImageLabelPairType mitk::ConnectomicsNetworkCreator::PrecomputeVertexLocationsBySegmentation( TractType::Pointer /*singleTract*/, ImageIndexPairType& /*endPointIndices*/ )
 {
   ImageLabelPairType labelpair;
 
   return labelpair;
 }
 
-mitk::ConnectomicsNetworkCreator::ImageLabelPairType mitk::ConnectomicsNetworkCreator::EndElementPositionLabelAvoidingWhiteMatter( TractType::Pointer singleTract )
+mitk::ConnectomicsNetworkCreator::ImageLabelPairType mitk::ConnectomicsNetworkCreator::EndElementPositionLabelAvoidingWhiteMatter( TractType::Pointer singleTract, ImageIndexPairType& endPointIndices )
 {
   ImageLabelPairType labelpair;
 
@@ -384,15 +507,15 @@ mitk::ConnectomicsNetworkCreator::ImageLabelPairType mitk::ConnectomicsNetworkCr
     labelpair.first = firstLabel;
     labelpair.second = lastLabel;
 
-    // Add property to property map
-    CreateNewNode( firstLabel, firstElementSegIndex, m_UseCoMCoordinates );
-    CreateNewNode( lastLabel, lastElementSegIndex, m_UseCoMCoordinates );
+    // the nodes are created from these indices once the fibers have been mapped
+    endPointIndices.first = firstElementSegIndex;
+    endPointIndices.second = lastElementSegIndex;
   }
 
   return labelpair;
 }
 
-mitk::ConnectomicsNetworkCreator::ImageLabelPairType mitk::ConnectomicsNetworkCreator::JustEndPointVerticesNoLabelTest( TractType::Pointer singleTract )
+mitk::ConnectomicsNetworkCreator::ImageLabelPairType mitk::ConnectomicsNetworkCreator::JustEndPointVerticesNoLabelTest( TractType::Pointer singleTract, ImageIndexPairType& endPointIndices )
 {
   ImageLabelPairType labelpair;
 
@@ -427,9 +550,9 @@ mitk::ConnectomicsNetworkCreator::ImageLabelPairType mitk::ConnectomicsNetworkCr
     labelpair.first = firstLabel;
     labelpair.second = lastLabel;
 
-    // Add property to property map
-    CreateNewNode( firstLabel, firstElementSegIndex, m_UseCoMCoordinates );
-    CreateNewNode( lastLabel, lastElementSegIndex, m_UseCoMCoordinates );
+    // the nodes are created from these indices once the fibers have been mapped
+    endPointIndices.first = firstElementSegIndex;
+    endPointIndices.second = lastElementSegIndex;
   }
 
   return labelpair;
@@ -79,8 +79,14 @@ namespace mitk
     /** Types for labels **/
     typedef int                                             ImageLabelType;
     typedef std::pair< ImageLabelType, ImageLabelType >     ImageLabelPairType;
+    typedef std::pair< itk::Index<3>, itk::Index<3> >       ImageIndexPairType;
 
-    /** Given a fiber bundle and a parcellation are set, this will create a network from both */
+    /** \brief Given a fiber bundle and a parcellation are set, this will create a network from both
+     *
+     * The fibers are mapped to label pairs in parallel chunks of FibersPerChunk fibers. Each chunk collects its own
+     * label and edge maps, which are merged in fiber order afterwards, so the network is identical to the one
+     * created by mapping the fibers one after another.
+     */
     void CreateNetworkFromFibersAndSegmentation();
     void SetFiberBundle(mitk::FiberBundle::Pointer fiberBundle);
     void SetSegmentation(mitk::Image::Pointer segmentation);
@@ -115,8 +121,8 @@ namespace mitk
     /** Return the vertexes associated with a pair of labels */
     ConnectionType ReturnAssociatedVertexPairForLabelPair( ImageLabelPairType labelpair );
 
-    /** Return the pair of labels which identify the areas connected by a single fiber */
-    ImageLabelPairType ReturnLabelForFiberTract( TractType::Pointer singleTract, MappingStrategy strategy );
+    /** Return the pair of labels which identify the areas connected by a single fiber, as well as the indices they were found at */
+    ImageLabelPairType ReturnLabelForFiberTract( TractType::Pointer singleTract, MappingStrategy strategy, ImageIndexPairType& endPointIndices );
 
     /** Assign the additional information which should be part of the vertex */
     void SupplyVertexWithInformation( ImageLabelType& label, VertexType& vertex );
@@ -164,25 +170,25 @@ namespace mitk
 
     Map a fiber to a vertex by taking the value of the parcellation image at the same world coordinates as the last
     and first element of the tract.*/
-    ImageLabelPairType EndElementPositionLabel( TractType::Pointer singleTract );
+    ImageLabelPairType EndElementPositionLabel( TractType::Pointer singleTract, ImageIndexPairType& endPointIndices );
 
     /** Map by distance between elements and vertices depending on their volume
 
     First go through the parcellation and compute the coordinates of the future vertices. Assign a radius according on their volume.
     Then map an edge to a label by considering the nearest vertices and comparing the distance to them to their radii. */
-    ImageLabelPairType PrecomputeVertexLocationsBySegmentation( TractType::Pointer singleTract );
+    ImageLabelPairType PrecomputeVertexLocationsBySegmentation( TractType::Pointer singleTract, ImageIndexPairType& endPointIndices );
 
         /** Use the position of the end and starting element only to map to labels
 
     Just take first and last position, no labelling, nothing */
-    ImageLabelPairType JustEndPointVerticesNoLabelTest( TractType::Pointer singleTract );
+    ImageLabelPairType JustEndPointVerticesNoLabelTest( TractType::Pointer singleTract, ImageIndexPairType& endPointIndices );
 
     /** Use the position of the end and starting element unless it is in white matter, then search for nearby parcellation to map to labels
 
     Map a fiber to a vertex by taking the value of the parcellation image at the same world coordinates as the last
     and first element of the tract. If this happens to be white matter, then try to extend the fiber in a line and
     take the first non-white matter parcel, that is intersected. */
-    ImageLabelPairType EndElementPositionLabelAvoidingWhiteMatter( TractType::Pointer singleTract );
+    ImageLabelPairType EndElementPositionLabelAvoidingWhiteMatter( TractType::Pointer singleTract, ImageIndexPairType& endPointIndices );
 
     ///////// Conversions //////////
     /** Convert fiber index to segmentation index coordinates */
@@ -191,6 +197,10 @@ namespace mitk
     void SegmentationToFiberCoords( mitk::Point3D& segCoord, mitk::Point3D& fiberCoord );
 
     /////////////////////// Variables ////////////////////////
+
+    // number of fibers mapped by one parallel work item
+    static const int FibersPerChunk = 1000;
+
     mitk::FiberBundle::Pointer m_FiberBundle;
     mitk::Image::Pointer m_Segmentation;
     ITKImageType::Pointer m_SegmentationItk;
@@ -66,7 +66,6 @@ void mitk::ConnectomicsShortestPathHistogram::ComputeFromConnectomicsNetwork( Co
 
 void mitk::ConnectomicsShortestPathHistogram::CalculateUnweightedUndirectedShortestPaths( NetworkType* boostGraph )
 {
-  std::vector< DescriptorType > predecessorMap( boost::num_vertices( *boostGraph ) );
   int numberOfNodes( boost::num_vertices( *boostGraph ) );
 
   m_DistanceMatrix.resize( numberOfNodes );
@@ -75,12 +74,12 @@ void mitk::ConnectomicsShortestPathHistogram::CalculateUnweightedUndirectedShort
     m_DistanceMatrix[ index ].resize( numberOfNodes );
   }
 
-  IteratorType iterator, end;
-  boost::tie(iterator, end) = boost::vertices( *boostGraph );
-
-  for ( int index(0) ; iterator != end; ++iterator, index++)
+  // every source only writes its own row of the distance matrix, the vertices of the vecS graph are their own indices
+#pragma omp parallel for schedule(dynamic)
+  for ( int index = 0; index < numberOfNodes; index++ )
   {
-          boost::dijkstra_shortest_paths(*boostGraph, *iterator, boost::predecessor_map(&predecessorMap[ 0 ]).distance_map(&m_DistanceMatrix[ index ][ 0 ]).weight_map( boost::get( &mitk::ConnectomicsNetwork::NetworkEdge::edge_weight ,*boostGraph ) ) ) ;
+    std::vector< DescriptorType > predecessorMap( numberOfNodes );
+    boost::dijkstra_shortest_paths(*boostGraph, boost::vertex( index, *boostGraph ), boost::predecessor_map(&predecessorMap[ 0 ]).distance_map(&m_DistanceMatrix[ index ][ 0 ]).weight_map( boost::get( &mitk::ConnectomicsNetwork::NetworkEdge::edge_weight ,*boostGraph ) ) ) ;
   }
 }
 
@@ -0,0 +1,201 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestingMacros.h"
+#include "mitkTestFixture.h"
+#include <mitkQBallImage.h>
+#include <itkDiffusionQballReconstructionImageFilter.h>
+#include <itkAnalyticalDiffusionQballReconstructionImageFilter.h>
+#include <itkPointShell.h>
+#include <itkImageRegionIterator.h>
+#include <itkTimeProbe.h>
+
+#include <cmath>
+
+/**
+ * Reconstructs synthetic single shell data (isotropic and anisotropic voxels) and reports the
+ * reconstruction throughput in voxels per second for typical HARDI acquisitions.
+ */
+class mitkQballReconstructionThroughputTestSuite : public mitk::TestFixture
+{
+
+  CPPUNIT_TEST_SUITE(mitkQballReconstructionThroughputTestSuite);
+  MITK_TEST(AnalyticalReconstruction_SyntheticData_ExpectedOdfs);
+  MITK_TEST(Reconstruction_HardiShells_Throughput);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  typedef itk::VectorImage<short,3> DwiImageType;
+  typedef itk::AnalyticalDiffusionQballReconstructionImageFilter<short,short,float,4,QBALL_ODFSIZE> AnalyticalFilterType;
+  typedef itk::DiffusionQballReconstructionImageFilter<short,short,float,QBALL_ODFSIZE> NumericalFilterType;
+  typedef AnalyticalFilterType::GradientDirectionContainerType GradientContainerType;
+  typedef AnalyticalFilterType::GradientDirectionType GradientType;
+
+  static const unsigned int ImageSize = 20;
+
+  GradientContainerType::Pointer m_Gradients;
+  DwiImageType::Pointer m_Dwi;
+
+  /** one baseline and numberOfDirections directions evenly spread over the sphere */
+  void CreateGradients(unsigned int numberOfDirections)
+  {
+    m_Gradients = GradientContainerType::New();
+    GradientType baseline;
+    baseline.fill(0.0);
+    m_Gradients->push_back(baseline);
+
+    const double goldenAngle = M_PI*(3.0-std::sqrt(5.0));
+    for (unsigned int i=0; i<numberOfDirections; i++)
+    {
+      double z = 1.0 - 2.0*(i+0.5)/numberOfDirections;
+      double r = std::sqrt(1.0-z*z);
+      GradientType g;
+      g[0] = r*std::cos(goldenAngle*i);
+      g[1] = r*std::sin(goldenAngle*i);
+      g[2] = z;
+      m_Gradients->push_back(g);
+    }
+  }
+
+  /**
+   * Voxels with x < 2 have no signal, voxels with z < ImageSize/2 diffuse isotropically
+   * and the remaining voxels diffuse along the x-axis.
+   */
+  void CreateDwi(double bValue)
+  {
+    m_Dwi = DwiImageType::New();
+    DwiImageType::RegionType region;
+    region.SetSize(0, ImageSize);
+    region.SetSize(1, ImageSize);
+    region.SetSize(2, ImageSize);
+    m_Dwi->SetRegions(region);
+    m_Dwi->SetVectorLength(m_Gradients->Size());
+    m_Dwi->Allocate();
+
+    const double s0 = 1000.0;
+    itk::ImageRegionIterator<DwiImageType> it(m_Dwi, region);
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+      DwiImageType::IndexType index = it.GetIndex();
+      DwiImageType::PixelType pixel(m_Gradients->Size());
+      for (unsigned int i=0; i<m_Gradients->Size(); i++)
+      {
+        const GradientType& g = m_Gradients->ElementAt(i);
+        double adc = 0.0007;
+        if (index[2] >= static_cast<long>(ImageSize/2))
+          adc = 0.0017*g[0]*g[0] + 0.0003*(g[1]*g[1] + g[2]*g[2]);
+        double signal = index[0] < 2 ? 0.0 : s0*std::exp(-bValue*adc);
+        pixel[i] = static_cast<short>(signal);
+      }
+      it.Set(pixel);
+    }
+  }
+
+  AnalyticalFilterType::OutputImageType::PixelType GetOdf(AnalyticalFilterType::OutputImageType* image, long x, long y, long z)
+  {
+    AnalyticalFilterType::OutputImageType::IndexType index;
+    index[0] = x;
+    index[1] = y;
+    index[2] = z;
+    return image->GetPixel(index);
+  }
+
+public:
+
+  void setUp() override
+  {
+    this->CreateGradients(64);
+    this->CreateDwi(1000);
+  }
+
+  void tearDown() override
+  {
+    m_Gradients = nullptr;
+    m_Dwi = nullptr;
+  }
+
+  void AnalyticalReconstruction_SyntheticData_ExpectedOdfs()
+  {
+    AnalyticalFilterType::Pointer filter = AnalyticalFilterType::New();
+    filter->SetGradientImage(m_Gradients, m_Dwi);
+    filter->SetBValue(1000);
+    filter->SetLambda(0.006);
+    filter->SetNormalizationMethod(AnalyticalFilterType::QBAR_STANDARD);
+    filter->Update();
+    AnalyticalFilterType::OutputImageType* output = filter->GetOutput();
+
+    AnalyticalFilterType::OutputImageType::PixelType empty = this->GetOdf(output, 0, 5, 5);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Voxels without signal are not reconstructed.", 0.0f, empty.GetNorm());
+
+    // a constant signal is represented exactly by the first spherical harmonic
+    AnalyticalFilterType::OutputImageType::PixelType isotropic = this->GetOdf(output, 10, 10, 2);
+    for (unsigned int i=0; i<QBALL_ODFSIZE; i++)
+      CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Isotropic diffusion yields a flat ODF.", 1.0/QBALL_ODFSIZE, isotropic[i], 1e-5);
+
+    vnl_matrix_fixed<double, 3, QBALL_ODFSIZE>* directions =
+        itk::PointShell<QBALL_ODFSIZE, vnl_matrix_fixed<double, 3, QBALL_ODFSIZE> >::DistributePointShell();
+    AnalyticalFilterType::OutputImageType::PixelType anisotropic = this->GetOdf(output, 10, 10, 15);
+    unsigned int maximum = 0;
+    for (unsigned int i=1; i<QBALL_ODFSIZE; i++)
+      if (anisotropic[i] > anisotropic[maximum])
+        maximum = i;
+    CPPUNIT_ASSERT_MESSAGE("ODF maximum points along the diffusion direction.", std::fabs((*directions)(0, maximum)) > 0.9);
+  }
+
+  void Reconstruction_HardiShells_Throughput()
+  {
+    const unsigned int numberOfDirections[] = { 64, 128 };
+    const double bValues[] = { 1000, 3000 };
+    const double numberOfVoxels = ImageSize*ImageSize*ImageSize;
+
+    for (unsigned int shell=0; shell<2; shell++)
+    {
+      this->CreateGradients(numberOfDirections[shell]);
+      this->CreateDwi(bValues[shell]);
+
+      AnalyticalFilterType::Pointer analytical = AnalyticalFilterType::New();
+      analytical->SetGradientImage(m_Gradients, m_Dwi);
+      analytical->SetBValue(bValues[shell]);
+      analytical->SetLambda(0.006);
+      analytical->SetNormalizationMethod(AnalyticalFilterType::QBAR_SOLID_ANGLE);
+      analytical->SetNumberOfThreads(1);
+      itk::TimeProbe analyticalClock;
+      analyticalClock.Start();
+      analytical->Update();
+      analyticalClock.Stop();
+
+      NumericalFilterType::Pointer numerical = NumericalFilterType::New();
+      numerical->SetGradientImage(m_Gradients, m_Dwi);
+      numerical->SetBValue(bValues[shell]);
+      numerical->SetNormalizationMethod(NumericalFilterType::QBR_STANDARD);
+      numerical->SetNumberOfThreads(1);
+      itk::TimeProbe numericalClock;
+      numericalClock.Start();
+      numerical->Update();
+      numericalClock.Stop();
+
+      MITK_INFO << numberOfDirections[shell] << " directions, b=" << bValues[shell] << ": "
+                << numberOfVoxels/analyticalClock.GetTotal() << " voxels/s (analytical CSA), "
+                << numberOfVoxels/numericalClock.GetTotal() << " voxels/s (numerical), including the reconstruction matrix setup";
+
+      CPPUNIT_ASSERT_MESSAGE("Analytical reconstruction produced an output.", analytical->GetOutput()->GetBufferPointer() != nullptr);
+      CPPUNIT_ASSERT_MESSAGE("Numerical reconstruction produced an output.", numerical->GetOutput()->GetBufferPointer() != nullptr);
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkQballReconstructionThroughput)
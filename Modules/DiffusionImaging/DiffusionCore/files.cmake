@@ -83,6 +83,7 @@ set(H_FILES
   include/Algorithms/Reconstruction/itkAnalyticalDiffusionQballReconstructionImageFilter.h
   include/Algorithms/Reconstruction/itkDiffusionMultiShellQballReconstructionImageFilter.h
   include/Algorithms/Reconstruction/itkPointShell.h
+  include/Algorithms/Reconstruction/itkOdfReconstructionBlock.h
   include/Algorithms/Reconstruction/itkOrientationDistributionFunction.h
   include/Algorithms/Reconstruction/itkDiffusionIntravoxelIncoherentMotionReconstructionImageFilter.h
   include/Algorithms/Reconstruction/itkDiffusionKurtosisReconstructionImageFilter.h
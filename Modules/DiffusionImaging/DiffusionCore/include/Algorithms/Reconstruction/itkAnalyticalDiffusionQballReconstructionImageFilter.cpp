@@ -34,6 +34,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <boost/math/special_functions.hpp>
 
 #include "itkPointShell.h"
+#include "itkOdfReconstructionBlock.h"
 
 using namespace boost::math;
 
@@ -351,74 +352,104 @@ void AnalyticalDiffusionQballReconstructionImageFilter<T,TG,TO,L,NODF>
             gradientind.push_back(gradientind[i]);
     }
 
+    // the voxels are reconstructed in blocks, one matrix product per block
+    typedef OdfReconstructionBlock<TO> BlockType;
+    BlockType signals;
+    BlockType coefficients;
+    BlockType odfs;
+    signals.SetNumberOfRows(m_NumberOfGradientDirections);
+    std::vector< typename NumericTraits<ReferencePixelType>::AccumulateType > b0Values(BlockType::BlockSize);
+    std::vector< int > blockColumns(BlockType::BlockSize);
+    vnl_vector<TO> B(m_NumberOfGradientDirections);
+
     while( !git.IsAtEnd() )
     {
-        GradientVectorType b = git.Get();
-
-        typename NumericTraits<ReferencePixelType>::AccumulateType b0 = NumericTraits<ReferencePixelType>::Zero;
-
-        // Average the baseline image pixels
-        for(unsigned int i = 0; i < baselineind.size(); ++i)
+        // gather the pre-normalized signals of the next voxels, voxels below the threshold get no column
+        unsigned int numberOfVoxels = 0;
+        unsigned int numberOfColumns = 0;
+        while( !git.IsAtEnd() && numberOfVoxels < BlockType::BlockSize )
         {
-            b0 += b[baselineind[i]];
-        }
-        b0 /= this->m_NumberOfBaselineImages;
+            GradientVectorType b = git.Get();
 
-        OdfPixelType odf(0.0);
-        typename CoefficientImageType::PixelType coeffPixel(0.0);
-        vnl_vector<TO> B(m_NumberOfGradientDirections);
+            typename NumericTraits<ReferencePixelType>::AccumulateType b0 = NumericTraits<ReferencePixelType>::Zero;
 
-        if( (b0 != 0) && (b0 >= m_Threshold) )
-        {
-            for( unsigned int i = 0; i< m_NumberOfGradientDirections; i++ )
+            // Average the baseline image pixels
+            for(unsigned int i = 0; i < baselineind.size(); ++i)
             {
-                B[i] = static_cast<TO>(b[gradientind[i]]);
+                b0 += b[baselineind[i]];
             }
+            b0 /= this->m_NumberOfBaselineImages;
 
-            B = PreNormalize(B, b0);
-            if(m_NormalizationMethod == QBAR_SOLID_ANGLE)
+            b0Values[numberOfVoxels] = b0;
+            blockColumns[numberOfVoxels] = -1;
+
+            if( (b0 != 0) && (b0 >= m_Threshold) )
             {
-                vnl_vector<TO> coeffs(m_NumberCoefficients);
-                coeffs = ( (*m_CoeffReconstructionMatrix) * B );
-                coeffs[0] += 1.0/(2.0*sqrt(QBALL_ANAL_RECON_PI));
-                odf = ( (*m_SphericalHarmonicBasisMatrix) * coeffs ).data_block();
-                coeffPixel = coeffs.data_block();
+                if(m_NormalizationMethod == QBAR_NONNEG_SOLID_ANGLE)
+                {
+                    /** this would be the place to implement a non-negative
+                  * solver for quadratic programming problem:
+                  * min .5*|| Bc-s ||^2 subject to -CLPc <= 4*pi*ones
+                  * (refer to MICCAI 2009 Goh et al. "Estimating ODFs with PDF constraints")
+                  * .5*|| Bc-s ||^2 == .5*c'B'Bc - x'B's + .5*s's
+                  */
+
+                    itkExceptionMacro( << "Nonnegative Solid Angle not yet implemented");
+                }
+
+                for( unsigned int i = 0; i< m_NumberOfGradientDirections; i++ )
+                {
+                    B[i] = static_cast<TO>(b[gradientind[i]]);
+                }
+
+                B = PreNormalize(B, b0);
+                signals.SetColumn(numberOfColumns, B);
+                blockColumns[numberOfVoxels] = numberOfColumns++;
             }
-            else if(m_NormalizationMethod == QBAR_NONNEG_SOLID_ANGLE)
+
+            ++numberOfVoxels;
+            ++git;  // Gradient  image iterator
+        }
+
+        if( numberOfColumns > 0 )
+        {
+            coefficients.Multiply(*m_CoeffReconstructionMatrix, signals, numberOfColumns);
+            TO* c0 = coefficients.GetRow(0);
+            for( unsigned int v = 0; v < numberOfColumns; v++ )
             {
-                /** this would be the place to implement a non-negative
-              * solver for quadratic programming problem:
-              * min .5*|| Bc-s ||^2 subject to -CLPc <= 4*pi*ones
-              * (refer to MICCAI 2009 Goh et al. "Estimating ODFs with PDF constraints")
-              * .5*|| Bc-s ||^2 == .5*c'B'Bc - x'B's + .5*s's
-              */
-
-                itkExceptionMacro( << "Nonnegative Solid Angle not yet implemented");
+                c0[v] += 1.0/(2.0*sqrt(QBALL_ANAL_RECON_PI));
             }
+
+            if(m_NormalizationMethod == QBAR_SOLID_ANGLE)
+                odfs.Multiply(*m_SphericalHarmonicBasisMatrix, coefficients, numberOfColumns);
             else
+                odfs.Multiply(*m_ReconstructionMatrix, signals, numberOfColumns);
+        }
+
+        for( unsigned int v = 0; v < numberOfVoxels; v++ )
+        {
+            OdfPixelType odf(0.0);
+            typename CoefficientImageType::PixelType coeffPixel(0.0);
+
+            if( blockColumns[v] >= 0 )
             {
-                vnl_vector<TO> coeffs(m_NumberCoefficients);
-                coeffs = ( (*m_CoeffReconstructionMatrix) * B );
-                coeffs[0] += 1.0/(2.0*sqrt(QBALL_ANAL_RECON_PI));
-                coeffPixel = coeffs.data_block();
-                odf = ( (*m_ReconstructionMatrix) * B ).data_block();
+                odfs.GetColumn(blockColumns[v], odf);
+                coefficients.GetColumn(blockColumns[v], coeffPixel);
+                odf = Normalize(odf, b0Values[v]);
             }
-            odf = Normalize(odf, b0);
 
+            oit.Set( odf );
+            oit2.Set( b0Values[v] );
+            float sum = 0;
+            for (unsigned int k=0; k<odf.Size(); k++)
+                sum += (float) odf[k];
+            oit3.Set( sum-1 );
+            oit4.Set(coeffPixel);
+            ++oit;  // odf image iterator
+            ++oit3; // odf sum image iterator
+            ++oit2; // b0 image iterator
+            ++oit4; // coefficient image iterator
         }
-
-        oit.Set( odf );
-        oit2.Set( b0 );
-        float sum = 0;
-        for (unsigned int k=0; k<odf.Size(); k++)
-            sum += (float) odf[k];
-        oit3.Set( sum-1 );
-        oit4.Set(coeffPixel);
-        ++oit;  // odf image iterator
-        ++oit3; // odf sum image iterator
-        ++oit2; // b0 image iterator
-        ++oit4; // coefficient image iterator
-        ++git;  // Gradient  image iterator
     }
 
     std::cout << "One Thread finished reconstruction" << std::endl;
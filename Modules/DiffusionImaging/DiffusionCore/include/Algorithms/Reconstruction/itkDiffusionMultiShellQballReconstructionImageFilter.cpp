@@ -20,6 +20,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <itkTimeProbe.h>
 #include <itkPointShell.h>
+#include <itkOdfReconstructionBlock.h>
 #include <mitkDiffusionFunctionCollection.h>
 
 namespace itk {
@@ -633,52 +634,83 @@ void DiffusionMultiShellQballReconstructionImageFilter<T,TG,TO,L,NODF>
 
   typedef typename GradientImagesType::PixelType         GradientVectorType;
 
+  // signals and results of a block of voxels, which is reconstructed with one matrix product
+  typedef OdfReconstructionBlock<double> BlockType;
+  BlockType signals;
+  BlockType coefficients;
+  BlockType odfs;
+  signals.SetNumberOfRows(NumbersOfGradientIndicies);
+  std::vector< int > blockColumns(BlockType::BlockSize);
+  vnl_vector<double> SignalVector(NumbersOfGradientIndicies);
+
   // iterate overall voxels of the gradient image region
   while( ! git.IsAtEnd() )
   {
-    GradientVectorType b = git.Get();
-    // ODF Vector
-    OdfPixelType odf(0.0);
-
-    double b0average = 0;
-    const unsigned int b0size = BZeroIndicies.size();
-    for(unsigned int i = 0; i < b0size ; ++i)
+    unsigned int numberOfVoxels = 0;
+    unsigned int numberOfColumns = 0;
+    while( ! git.IsAtEnd() && numberOfVoxels < BlockType::BlockSize )
     {
-      b0average += b[BZeroIndicies[i]];
-    }
-    b0average /= b0size;
-    bzeroIterator.Set(b0average);
-    ++bzeroIterator;
+      GradientVectorType b = git.Get();
 
-    // Create the Signal Vector
-    vnl_vector<double> SignalVector(NumbersOfGradientIndicies);
-    if( (b0average != 0) && (b0average >= m_Threshold) )
-    {
-
-      for( unsigned int i = 0; i< SignalIndicies.size(); i++ )
+      double b0average = 0;
+      const unsigned int b0size = BZeroIndicies.size();
+      for(unsigned int i = 0; i < b0size ; ++i)
       {
-        SignalVector[i] = static_cast<double>(b[SignalIndicies[i]]);
+        b0average += b[BZeroIndicies[i]];
       }
+      b0average /= b0size;
+      bzeroIterator.Set(b0average);
+      ++bzeroIterator;
+
+      blockColumns[numberOfVoxels] = -1;
+      if( (b0average != 0) && (b0average >= m_Threshold) )
+      {
+        // Create the Signal Vector
+        for( unsigned int i = 0; i< SignalIndicies.size(); i++ )
+        {
+          SignalVector[i] = static_cast<double>(b[SignalIndicies[i]]);
+        }
+
+        // apply threashold an generate ln(-ln(E)) signal
+        // Replace SignalVector with PreNormalized SignalVector
+        S_S0Normalization(SignalVector, b0average);
+        Projection1(SignalVector);
 
-      // apply threashold an generate ln(-ln(E)) signal
-      // Replace SignalVector with PreNormalized SignalVector
-      S_S0Normalization(SignalVector, b0average);
-      Projection1(SignalVector);
+        DoubleLogarithm(SignalVector);
 
-      DoubleLogarithm(SignalVector);
+        signals.SetColumn(numberOfColumns, SignalVector);
+        blockColumns[numberOfVoxels] = numberOfColumns++;
+      }
+      ++numberOfVoxels;
+      ++git;
+    }
 
+    if( numberOfColumns > 0 )
+    {
       // approximate ODF coeffs
-      vnl_vector<double>  coeffs = ( (*m_CoeffReconstructionMatrix) * SignalVector );
-      coeffs[0] = 1.0/(2.0*sqrt(M_PI));
+      coefficients.Multiply(*m_CoeffReconstructionMatrix, signals, numberOfColumns);
+      double* c0 = coefficients.GetRow(0);
+      for( unsigned int v = 0; v < numberOfColumns; v++ )
+      {
+        c0[v] = 1.0/(2.0*sqrt(M_PI));
+      }
 
-      odf = element_cast<double, TO>(( (*m_ODFSphericalHarmonicBasisMatrix) * coeffs )).data_block();
-      odf *= (M_PI*4/NODF);
+      odfs.Multiply(*m_ODFSphericalHarmonicBasisMatrix, coefficients, numberOfColumns);
     }
-    // set ODF to ODF-Image
-    oit.Set( odf );
-    ++oit;
-    ++git;
 
+    for( unsigned int v = 0; v < numberOfVoxels; v++ )
+    {
+      // ODF Vector
+      OdfPixelType odf(0.0);
+      if( blockColumns[v] >= 0 )
+      {
+        odfs.GetColumn(blockColumns[v], odf);
+        odf *= (M_PI*4/NODF);
+      }
+      // set ODF to ODF-Image
+      oit.Set( odf );
+      ++oit;
+    }
   }
 
   MITK_INFO << "One Thread finished reconstruction";
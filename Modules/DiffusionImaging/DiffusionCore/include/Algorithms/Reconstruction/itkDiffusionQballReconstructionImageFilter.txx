@@ -23,6 +23,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "itkArray.h"
 #include "vnl/vnl_vector.h"
 #include "itkPointShell.h"
+#include "itkOdfReconstructionBlock.h"
 
 #define _USE_MATH_DEFINES
 #include <math.h>
@@ -232,6 +233,14 @@ namespace itk {
     oit2.GoToBegin();
     vnl_vector<TOdfPixelType> B(m_NumberOfGradientDirections);
 
+    // signals and ODFs of a block of voxels
+    typedef OdfReconstructionBlock<TOdfPixelType> BlockType;
+    BlockType signals;
+    BlockType odfs;
+    signals.SetNumberOfRows(m_NumberOfGradientDirections);
+    std::vector< typename NumericTraits<ReferencePixelType>::AccumulateType > b0Values(BlockType::BlockSize);
+    std::vector< int > blockColumns(BlockType::BlockSize);
+
     // Two cases here:
     // 1. Gradients specified in multiple images
     // 'n' iterators for each of the gradient images
@@ -268,56 +277,77 @@ namespace itk {
       }
 
       // Following loop does the actual reconstruction work in each voxel
-      // (Tuch, Q-Ball Reconstruction [1])
+      // (Tuch, Q-Ball Reconstruction [1]), blocks of voxels are reconstructed
+      // with one matrix product
       while( !it.IsAtEnd() )
       {
-
-        // b-zero reference value
-        ReferencePixelType b0 = it.Get();
-
-        // init ODF
-        OdfPixelType odf(0.0);
-
-        // threshold on reference value to suppress noisy regions
-        if( (b0 != 0) && (b0 >= m_Threshold) )
+        unsigned int numberOfVoxels = 0;
+        unsigned int numberOfColumns = 0;
+        while( !it.IsAtEnd() && numberOfVoxels < BlockType::BlockSize )
         {
+          // b-zero reference value
+          ReferencePixelType b0 = it.Get();
+          b0Values[numberOfVoxels] = b0;
+          blockColumns[numberOfVoxels] = -1;
 
-          // fill array of diffusion measurements
-          for( unsigned int i = 0; i< m_NumberOfGradientDirections; i++ )
+          // threshold on reference value to suppress noisy regions
+          if( (b0 != 0) && (b0 >= m_Threshold) )
           {
-            GradientPixelType b = gradientItContainer[i]->Get();
-            B[i] = static_cast<TOdfPixelType>(b);
-            ++(*gradientItContainer[i]);
-          }
 
-          // pre-normalization according to m_NormalizationMethod
-          B = PreNormalize(B);
+            // fill array of diffusion measurements
+            for( unsigned int i = 0; i< m_NumberOfGradientDirections; i++ )
+            {
+              GradientPixelType b = gradientItContainer[i]->Get();
+              B[i] = static_cast<TOdfPixelType>(b);
+              ++(*gradientItContainer[i]);
+            }
 
-          // actual reconstruction
-          odf = ( (*m_ReconstructionMatrix) * B ).data_block();
+            // pre-normalization according to m_NormalizationMethod
+            B = PreNormalize(B);
+            signals.SetColumn(numberOfColumns, B);
+            blockColumns[numberOfVoxels] = numberOfColumns++;
+          }
+          else
+          {
+            // in case we fall below threshold, we just increment to next voxel
+            for( unsigned int i = 0; i< m_NumberOfGradientDirections; i++ )
+            {
+              ++(*gradientItContainer[i]);
+            }
+          }
+          ++numberOfVoxels;
+          ++it;
+        }
 
-          // post-normalization according to m_NormalizationMethod
-          odf.Normalize();
+        // actual reconstruction
+        if( numberOfColumns > 0 )
+        {
+          odfs.Multiply(*m_ReconstructionMatrix, signals, numberOfColumns);
         }
-        else
+
+        for( unsigned int v = 0; v < numberOfVoxels; v++ )
         {
-          // in case we fall below threshold, we just increment to next voxel
-          for( unsigned int i = 0; i< m_NumberOfGradientDirections; i++ )
+          // init ODF
+          OdfPixelType odf(0.0);
+
+          if( blockColumns[v] >= 0 )
           {
-            ++(*gradientItContainer[i]);
+            odfs.GetColumn(blockColumns[v], odf);
+
+            // post-normalization according to m_NormalizationMethod
+            odf.Normalize();
           }
-        }
 
-        for (unsigned int i=0; i<odf.Size(); i++)
-            if (odf.GetElement(i)!=odf.GetElement(i))
-                odf.Fill(0.0);
+          for (unsigned int i=0; i<odf.Size(); i++)
+              if (odf.GetElement(i)!=odf.GetElement(i))
+                  odf.Fill(0.0);
 
-        // set and increment output iterators
-        oit.Set( odf );
-        ++oit;
-        oit2.Set( b0 );
-        ++oit2;
-        ++it;
+          // set and increment output iterators
+          oit.Set( odf );
+          ++oit;
+          oit2.Set( b0Values[v] );
+          ++oit2;
+        }
       }
 
       // clean up
@@ -365,52 +395,73 @@ namespace itk {
       }
 
       // Following loop does the actual reconstruction work in each voxel
-      // (Tuch, Q-Ball Reconstruction [1])
+      // (Tuch, Q-Ball Reconstruction [1]), blocks of voxels are reconstructed
+      // with one matrix product
       while( !git.IsAtEnd() )
       {
-        // current vector of diffusion measurements
-        GradientVectorType b = git.Get();
-
-        // average of current b-zero reference values
-        typename NumericTraits<ReferencePixelType>::AccumulateType b0 = NumericTraits<ReferencePixelType>::Zero;
-        for(unsigned int i = 0; i < baselineind.size(); ++i)
+        unsigned int numberOfVoxels = 0;
+        unsigned int numberOfColumns = 0;
+        while( !git.IsAtEnd() && numberOfVoxels < BlockType::BlockSize )
         {
-          b0 += b[baselineind[i]];
-        }
-        b0 /= this->m_NumberOfBaselineImages;
+          // current vector of diffusion measurements
+          GradientVectorType b = git.Get();
 
-        // init resulting ODF
-        OdfPixelType odf(0.0);
+          // average of current b-zero reference values
+          typename NumericTraits<ReferencePixelType>::AccumulateType b0 = NumericTraits<ReferencePixelType>::Zero;
+          for(unsigned int i = 0; i < baselineind.size(); ++i)
+          {
+            b0 += b[baselineind[i]];
+          }
+          b0 /= this->m_NumberOfBaselineImages;
+          b0Values[numberOfVoxels] = b0;
+          blockColumns[numberOfVoxels] = -1;
 
-        // threshold on reference value to suppress noisy regions
-        if( (b0 != 0) && (b0 >= m_Threshold) )
-        {
-          for( unsigned int i = 0; i< m_NumberOfGradientDirections; i++ )
+          // threshold on reference value to suppress noisy regions
+          if( (b0 != 0) && (b0 >= m_Threshold) )
           {
-            B[i] = static_cast<TOdfPixelType>(b[gradientind[i]]);
+            for( unsigned int i = 0; i< m_NumberOfGradientDirections; i++ )
+            {
+              B[i] = static_cast<TOdfPixelType>(b[gradientind[i]]);
+            }
+
+            // pre-normalization according to m_NormalizationMethod
+            B = PreNormalize(B);
+            signals.SetColumn(numberOfColumns, B);
+            blockColumns[numberOfVoxels] = numberOfColumns++;
           }
+          ++numberOfVoxels;
+          ++git; // Gradient  image iterator
+        }
 
-          // pre-normalization according to m_NormalizationMethod
-          B = PreNormalize(B);
+        // actual reconstruction
+        if( numberOfColumns > 0 )
+        {
+          odfs.Multiply(*m_ReconstructionMatrix, signals, numberOfColumns);
+        }
 
-          // actual reconstruction
-          odf = ( (*m_ReconstructionMatrix) * B ).data_block();
+        for( unsigned int v = 0; v < numberOfVoxels; v++ )
+        {
+          // init resulting ODF
+          OdfPixelType odf(0.0);
 
-          // post-normalization according to m_NormalizationMethod
-          odf = Normalize(odf, b0);
+          if( blockColumns[v] >= 0 )
+          {
+            odfs.GetColumn(blockColumns[v], odf);
 
-        }
+            // post-normalization according to m_NormalizationMethod
+            odf = Normalize(odf, b0Values[v]);
+          }
 
-        for (unsigned int i=0; i<odf.Size(); i++)
-            if (odf.GetElement(i)!=odf.GetElement(i))
-                odf.Fill(0.0);
+          for (unsigned int i=0; i<odf.Size(); i++)
+              if (odf.GetElement(i)!=odf.GetElement(i))
+                  odf.Fill(0.0);
 
-        // set and increment output iterators
-        oit.Set( odf );
-        ++oit;
-        oit2.Set( b0 );
-        ++oit2;
-        ++git; // Gradient  image iterator
+          // set and increment output iterators
+          oit.Set( odf );
+          ++oit;
+          oit2.Set( b0Values[v] );
+          ++oit2;
+        }
       }
     }
 
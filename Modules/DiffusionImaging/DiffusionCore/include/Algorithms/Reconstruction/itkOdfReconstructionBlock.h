@@ -0,0 +1,141 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef __itkOdfReconstructionBlock_h_
+#define __itkOdfReconstructionBlock_h_
+
+#include <vnl/vnl_matrix.h>
+#include <vnl/vnl_vector.h>
+#include <vector>
+
+namespace itk
+{
+/** \class OdfReconstructionBlock
+ * \brief Holds the signals (or results) of up to BlockSize voxels, one voxel per column.
+ *
+ * The Q-ball reconstruction filters gather the pre-normalized signals of several voxels into
+ * one block and reconstruct all of them with a single matrix product (Multiply()) instead of
+ * one matrix-vector product per voxel. The block is stored row by row with the voxel index
+ * innermost, so the product runs over contiguous memory and is vectorized by the compiler.
+ *
+ * For every voxel the products are summed in the same order as in vnl_matrix * vnl_vector,
+ * so the results equal the per-voxel reconstruction.
+ */
+template< class TValue >
+class OdfReconstructionBlock
+{
+public:
+
+  enum { BlockSize = 64 };
+
+  typedef TValue ValueType;
+
+  OdfReconstructionBlock() : m_NumberOfRows(0) {}
+
+  void SetNumberOfRows(unsigned int rows)
+  {
+    if (rows != m_NumberOfRows)
+    {
+      m_NumberOfRows = rows;
+      m_Data.resize(rows*BlockSize);
+    }
+  }
+
+  unsigned int GetNumberOfRows() const { return m_NumberOfRows; }
+
+  TValue* GetRow(unsigned int row) { return &m_Data[row*BlockSize]; }
+  const TValue* GetRow(unsigned int row) const { return &m_Data[row*BlockSize]; }
+
+  void SetColumn(unsigned int column, const vnl_vector<TValue>& vector)
+  {
+    for (unsigned int r=0; r<m_NumberOfRows; r++)
+      m_Data[r*BlockSize+column] = vector[r];
+  }
+
+  /** Copies a column into a vector type with operator[], e.g. itk::Vector, casting the elements. */
+  template< class TVector >
+  void GetColumn(unsigned int column, TVector& vector) const
+  {
+    for (unsigned int r=0; r<m_NumberOfRows; r++)
+      vector[r] = m_Data[r*BlockSize+column];
+  }
+
+  /** Sets this block to matrix * block for the first numberOfColumns columns. */
+  void Multiply(const vnl_matrix<TValue>& matrix, const OdfReconstructionBlock& block, unsigned int numberOfColumns)
+  {
+    const unsigned int rows = matrix.rows();
+    const unsigned int cols = matrix.cols();
+    this->SetNumberOfRows(rows);
+
+    // four rows at once, so every signal value is loaded once for four products
+    unsigned int r = 0;
+    for (; r+4<=rows; r+=4)
+    {
+      const TValue* m0 = matrix[r];
+      const TValue* m1 = matrix[r+1];
+      const TValue* m2 = matrix[r+2];
+      const TValue* m3 = matrix[r+3];
+      TValue* o0 = this->GetRow(r);
+      TValue* o1 = this->GetRow(r+1);
+      TValue* o2 = this->GetRow(r+2);
+      TValue* o3 = this->GetRow(r+3);
+      for (unsigned int v=0; v<numberOfColumns; v++)
+        o0[v] = o1[v] = o2[v] = o3[v] = TValue(0);
+
+      for (unsigned int c=0; c<cols; c++)
+      {
+        const TValue a0 = m0[c];
+        const TValue a1 = m1[c];
+        const TValue a2 = m2[c];
+        const TValue a3 = m3[c];
+        const TValue* s = block.GetRow(c);
+        for (unsigned int v=0; v<numberOfColumns; v++)
+        {
+          const TValue sv = s[v];
+          o0[v] += a0*sv;
+          o1[v] += a1*sv;
+          o2[v] += a2*sv;
+          o3[v] += a3*sv;
+        }
+      }
+    }
+
+    for (; r<rows; r++)
+    {
+      const TValue* m = matrix[r];
+      TValue* o = this->GetRow(r);
+      for (unsigned int v=0; v<numberOfColumns; v++)
+        o[v] = TValue(0);
+
+      for (unsigned int c=0; c<cols; c++)
+      {
+        const TValue a = m[c];
+        const TValue* s = block.GetRow(c);
+        for (unsigned int v=0; v<numberOfColumns; v++)
+          o[v] += a*s[v];
+      }
+    }
+  }
+
+private:
+
+  std::vector<TValue> m_Data;
+  unsigned int        m_NumberOfRows;
+};
+
+}
+
+#endif //__itkOdfReconstructionBlock_h_
@@ -20,7 +20,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkVtkMapper.h"
 #include "vtkPropAssembly.h"
-#include "vtkAppendPolyData.h"
+#include "vtkPolyData.h"
 #include "vtkActor.h"
 #include "vtkOpenGLPolyDataMapper.h"
 #include "vtkPlane.h"
@@ -29,14 +29,24 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "vtkTransform.h"
 #include "vtkDataArrayTemplate.h"
 #include "vtkSmartPointer.h"
-#include "vtkOdfSource.h"
 #include "vtkThickPlane.h"
 
+#include <list>
+#include <vector>
+
 namespace mitk {
 
 //##Documentation
 //## @brief Mapper for spherical object densitiy function representations
 //##
+//## All glyphs share one tessellation of the sphere (the base mesh of
+//## itk::OrientationDistributionFunction). For the glyphs of a slice only
+//## the centers, the radii of the sphere vertices and the colors are stored
+//## in a GlyphBuffer. The glyph mesh is assembled from this buffer into one
+//## polydata per renderer, reusing its arrays and connectivity. The buffers
+//## of the last slices of each renderer are cached, so scrolling back to a
+//## slice only reassembles the mesh.
+//##
 template<class TPixelType, int NrOdfDirections>
 class OdfVtkMapper2D : public VtkMapper
 {
@@ -87,12 +97,28 @@ public:
     virtual void GenerateDataForRenderer(mitk::BaseRenderer* renderer) override;
     virtual bool IsLODEnabled( BaseRenderer * /*renderer*/ ) const override { return true; }
 
+    /** \brief Glyphs of one displayed slice, the vertices of glyph g are center(g) + radius(g,j) * direction(j). */
+    struct GlyphBuffer
+    {
+        OdfDisplayGeometry      m_DisplayGeometry;
+        unsigned int            m_NumberOfGlyphs;
+        std::vector<float>      m_Centers;      ///< 3 per glyph
+        std::vector<float>      m_Radii;        ///< NrOdfDirections per glyph
+        std::vector<float>      m_ColorValues;  ///< NrOdfDirections per glyph, mapped to the cell colors
+        std::vector<float>      m_Rgba;         ///< 4 per glyph, only used for the tensor colourisation mode
+    };
+
+    /** Number of slices per renderer whose glyph buffers are kept. */
+    static const unsigned int NumberOfCachedSlices = 8;
+
     class LocalStorage : public mitk::Mapper::BaseLocalStorage
     {
     public:
 
         std::vector< vtkSmartPointer<vtkPropAssembly> >       m_PropAssemblies;
-        std::vector< vtkSmartPointer<vtkAppendPolyData> >     m_OdfsPlanes;
+        std::vector< vtkSmartPointer<vtkPolyData> >           m_OdfsPlanes;
+        std::vector< unsigned int >                           m_NumberOfGlyphCells;
+        std::vector< std::list<GlyphBuffer> >                 m_GlyphBuffers;   ///< per renderer index, most recent first
         std::vector< vtkSmartPointer<vtkActor> >              m_OdfsActors;
         std::vector< vtkSmartPointer<vtkOpenGLPolyDataMapper> >     m_OdfsMappers;
         vtkSmartPointer< vtkPolyData >                        m_TemplateOdf;
@@ -112,7 +138,13 @@ protected:
     OdfVtkMapper2D();
     virtual ~OdfVtkMapper2D();
 
-    static void GlyphMethod(void *arg);
+    /** \brief Computes the glyph of point id of the cut plane and appends it to the buffer. */
+    void AddGlyph(vtkDataArray* odfvals, vtkIdType id, const mitk::Point3D& center, GlyphBuffer& buffer);
+    /** \brief Assembles the glyph mesh of a buffer, only the connectivity depends on the number of glyphs. */
+    void BuildGlyphMesh(const GlyphBuffer& buffer, LocalStorage* localStorage, int index);
+    static void InitializeGlyphTemplate();
+    void ShowGlyphMesh(LocalStorage* localStorage, int index);
+
     bool IsPlaneRotated(mitk::BaseRenderer* renderer);
     static bool m_toggleTensorEllipsoidView;
     static bool m_toggleColourisationMode;
@@ -125,16 +157,19 @@ private:
 
     mitk::Image* GetInput();
 
-    static vtkSmartPointer<vtkTransform> m_OdfTransform;
-    static vtkSmartPointer<vtkOdfSource> m_OdfSource;
+    /** shared tessellation: unit vertex directions and the cells in vtkCellArray layout */
+    static std::vector<double>    m_GlyphDirections;
+    static std::vector<vtkIdType> m_GlyphCells;
+    static vtkIdType              m_NumberOfGlyphCellsPerGlyph;
+
     static float    m_Scaling;
     static int      m_Normalization;
     static int      m_ScaleBy;
     static float    m_IndexParam1;
     static float    m_IndexParam2;
-    static vtkSmartPointer<vtkDoubleArray> m_colourScalars;
 
     int             m_ShowMaxNumber;
+    double          m_AdditionalScale;
 
     std::vector< vtkSmartPointer<vtkPlane> >          m_Planes;
     std::vector< vtkSmartPointer<vtkCutter> >         m_Cutters;
@@ -34,18 +34,18 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "vtkMaskedGlyph3D.h"
 #include "vtkGlyph2D.h"
 #include "vtkGlyph3D.h"
-#include "vtkMaskedProgrammableGlyphFilter.h"
+#include "vtkMaskPoints.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkLinearTransform.h"
 #include "vtkCamera.h"
 #include "vtkPointData.h"
-#include "vtkTransformPolyDataFilter.h"
 #include "vtkTransform.h"
-#include "vtkOdfSource.h"
 #include "vtkDoubleArray.h"
 #include "vtkLookupTable.h"
 #include "vtkProperty.h"
-#include "vtkPolyDataNormals.h"
 #include "vtkLight.h"
 #include "vtkLightCollection.h"
 #include "vtkMath.h"
@@ -70,10 +70,13 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 
 template<class T, int N>
-vtkSmartPointer<vtkTransform> mitk::OdfVtkMapper2D<T,N>::m_OdfTransform = vtkSmartPointer<vtkTransform>::New();
+std::vector<double> mitk::OdfVtkMapper2D<T,N>::m_GlyphDirections;
 
 template<class T, int N>
-vtkSmartPointer<vtkOdfSource> mitk::OdfVtkMapper2D<T,N>::m_OdfSource = vtkSmartPointer<vtkOdfSource>::New();
+std::vector<vtkIdType> mitk::OdfVtkMapper2D<T,N>::m_GlyphCells;
+
+template<class T, int N>
+vtkIdType mitk::OdfVtkMapper2D<T,N>::m_NumberOfGlyphCellsPerGlyph = 0;
 
 template<class T, int N>
 float mitk::OdfVtkMapper2D<T,N>::m_Scaling;
@@ -99,8 +102,6 @@ bool mitk::OdfVtkMapper2D<T, N>::m_toggleColourisationMode = false;
 template<class T, int N>
 bool mitk::OdfVtkMapper2D<T, N>::m_toggleGlyphPlacementMode = true;
 
-template<class T, int N>
-vtkSmartPointer<vtkDoubleArray> mitk::OdfVtkMapper2D<T, N>::m_colourScalars = nullptr;
 
 #define ODF_MAPPER_PI M_PI
 
@@ -112,13 +113,12 @@ mitk::OdfVtkMapper2D<T,N>::LocalStorage::LocalStorage()
     m_PropAssemblies.push_back(vtkPropAssembly::New());
     m_PropAssemblies.push_back(vtkPropAssembly::New());
 
-    m_OdfsPlanes.push_back(vtkAppendPolyData::New());
-    m_OdfsPlanes.push_back(vtkAppendPolyData::New());
-    m_OdfsPlanes.push_back(vtkAppendPolyData::New());
+    m_OdfsPlanes.push_back(vtkSmartPointer<vtkPolyData>::New());
+    m_OdfsPlanes.push_back(vtkSmartPointer<vtkPolyData>::New());
+    m_OdfsPlanes.push_back(vtkSmartPointer<vtkPolyData>::New());
 
-    m_OdfsPlanes[0]->AddInputData(vtkPolyData::New());
-    m_OdfsPlanes[1]->AddInputData(vtkPolyData::New());
-    m_OdfsPlanes[2]->AddInputData(vtkPolyData::New());
+    m_NumberOfGlyphCells.resize(3, 0);
+    m_GlyphBuffers.resize(3);
 
     m_OdfsActors.push_back(vtkActor::New());
     m_OdfsActors.push_back(vtkActor::New());
@@ -192,6 +192,7 @@ mitk::OdfVtkMapper2D<T,N>
     m_Clippers2[2]->SetClipFunction( m_ThickPlanes2[2] );
 
     m_ShowMaxNumber = 500;
+    m_AdditionalScale = 1.0;
 }
 
 template<class T, int N>
@@ -234,37 +235,41 @@ int  mitk::OdfVtkMapper2D<T,N>
 
 template<class T, int N>
 void  mitk::OdfVtkMapper2D<T,N>
-::GlyphMethod(void *arg)
+::InitializeGlyphTemplate()
 {
-    vtkMaskedProgrammableGlyphFilter* pfilter=(vtkMaskedProgrammableGlyphFilter*)arg;
-
-    double point[3];
-    double debugpoint[3];
-    pfilter->GetPoint(point);
-    pfilter->GetPoint(debugpoint);
-
-    itk::Point<double,3> p(point);
-    Vector3D spacing = pfilter->GetGeometry()->GetSpacing();
-    p[0] /= spacing[0];
-    p[1] /= spacing[1];
-    p[2] /= spacing[2];
-
-    mitk::Point3D p2;
-    pfilter->GetGeometry()->IndexToWorld( p, p2 );
-    point[0] = p2[0];
-    point[1] = p2[1];
-    point[2] = p2[2];
-
-    vtkPointData* data = pfilter->GetPointData();
-    vtkDataArray* odfvals = data->GetArray("vector");
-    vtkIdType id = pfilter->GetPointId();
-    m_OdfTransform->Identity();
-    m_OdfTransform->Translate(point[0],point[1],point[2]);
+    if( !m_GlyphCells.empty() )
+        return;
 
+    typedef itk::OrientationDistributionFunction<float,N> OdfType;
+    vtkPolyData* baseMesh = OdfType::GetBaseMesh();
+
+    m_GlyphDirections.resize(3*N);
+    for(int j=0; j<N; j++)
+        baseMesh->GetPoints()->GetPoint(j, &m_GlyphDirections[3*j]);
+
+    vtkCellArray* polys = baseMesh->GetPolys();
+    vtkIdType npts; vtkIdType *pts;
+    polys->InitTraversal();
+    while(polys->GetNextCell(npts,pts))
+    {
+        m_GlyphCells.push_back(npts);
+        for(int i=0; i<npts; i++)
+            m_GlyphCells.push_back(pts[i]);
+    }
+    m_NumberOfGlyphCellsPerGlyph = polys->GetNumberOfCells();
+}
+
+#define __IMG_DAT_ITEM__CLIP_0_1__(val) (val) = ( (val) < 0.0 ) ? ( 0.0 ) : ( ( (val) > 1.0 ) ? ( 1.0 ) : ( (val) ) );
+
+template<class T, int N>
+void  mitk::OdfVtkMapper2D<T,N>
+::AddGlyph(vtkDataArray* odfvals, vtkIdType id, const mitk::Point3D& center, GlyphBuffer& buffer)
+{
     typedef itk::OrientationDistributionFunction<float,N> OdfType;
     OdfType odf;
 
-    if( odfvals->GetNumberOfComponents()==6 and not m_toggleTensorEllipsoidView )
+    double rgba[4] = {0,0,0,0};
+    if( odfvals->GetNumberOfComponents()==6 )
     {
         float tensorelems[6] = {
             (float)odfvals->GetComponent(id,0),
@@ -275,120 +280,217 @@ void  mitk::OdfVtkMapper2D<T,N>
             (float)odfvals->GetComponent(id,5),
         };
         itk::DiffusionTensor3D<float> tensor(tensorelems);
-        odf.InitFromTensor(tensor);
+        if( not m_toggleTensorEllipsoidView )
+            odf.InitFromTensor(tensor);
+        else
+            odf.InitFromEllipsoid(tensor);
 
-        if( (pfilter-> GetColorMode()) == 0 ) // m_ColourisationMode; VTK_COLOR_BY_INPUT=0, VTK_COLOR_BY_SOURCE=1.
+        if( m_toggleColourisationMode )
         { /// \brief Colourisation of glyph like in MitkWorkbench's dti visualisation, r,g,b,a=x,y,z,fa of main direction of diffusion.
-//          unsigned char rgba[4] = {0,0,0,0};
-          double rgba[4] = {0,0,0,0};
-          rgba[3] = fabs(tensor.GetFractionalAnisotropy()); //* 255); // fa = FractionalAnisotropy => Helligkeit = Value, and alpha.
+          rgba[3] = fabs(tensor.GetFractionalAnisotropy()); // fa = FractionalAnisotropy => Helligkeit = Value, and alpha.
           typename itk::DiffusionTensor3D<T>::EigenValuesArrayType eigenValues;
           typename itk::DiffusionTensor3D<T>::EigenVectorsMatrixType eigenVectors;
           tensor.ComputeEigenAnalysis( eigenValues, eigenVectors ); // normalized eigenvectors as rows in ascending order.
           rgba[0] = (fabs( eigenVectors(2, 0) ) * rgba[3]);
           rgba[1] = (fabs( eigenVectors(2, 1) ) * rgba[3]);
           rgba[2] = (fabs( eigenVectors(2, 2) ) * rgba[3]);
-//#define __IMG_DAT_ITEM__CLIP_00_FF__(val) (val) = ( (val) < 0 ) ? ( 0 ) : ( ( (val) > 255 ) ? ( 255 ) : ( (val) ) );
-#define __IMG_DAT_ITEM__CLIP_0_1__(val) (val) = ( (val) < 0.0 ) ? ( 0.0 ) : ( ( (val) > 1.0 ) ? ( 1.0 ) : ( (val) ) );
-        __IMG_DAT_ITEM__CLIP_0_1__(rgba[0]);
-        __IMG_DAT_ITEM__CLIP_0_1__(rgba[1]);
-        __IMG_DAT_ITEM__CLIP_0_1__(rgba[2]);
-        __IMG_DAT_ITEM__CLIP_0_1__(rgba[3]);
-          m_colourScalars-> InsertNextTuple4( rgba[0], rgba[1], rgba[2], rgba[3] ); // Allocates space automaticaly.
-
-          data-> AddArray( m_colourScalars );
-          data-> SetActiveScalars( "GLYPH_COLORS" );
-        }
-        else
-        {
-          data-> SetActiveScalars( "vector" );
-          data-> RemoveArray( "GLYPH_COLORS" );
+          __IMG_DAT_ITEM__CLIP_0_1__(rgba[0]);
+          __IMG_DAT_ITEM__CLIP_0_1__(rgba[1]);
+          __IMG_DAT_ITEM__CLIP_0_1__(rgba[2]);
+          __IMG_DAT_ITEM__CLIP_0_1__(rgba[3]);
         }
     }
-
-    else if( odfvals->GetNumberOfComponents()==6 and m_toggleTensorEllipsoidView )
-    {
-      float tensorElements[6] = {
-          (float)odfvals->GetComponent(id, 0), (float)odfvals->GetComponent(id, 1), (float)odfvals->GetComponent(id, 2),
-          (float)odfvals->GetComponent(id, 3), (float)odfvals->GetComponent(id, 4), (float)odfvals->GetComponent(id, 5),
-      };
-      itk::DiffusionTensor3D<float> tensor( tensorElements );
-      odf.InitFromEllipsoid( tensor );
-
-      if( (pfilter-> GetColorMode()) == 0 ) // m_ColourisationMode; VTK_COLOR_BY_INPUT=0, VTK_COLOR_BY_SOURCE=1.
-      { /// \brief Colourisation of glyph like in MitkWorkbench's dti visualisation, r,g,b,a=x,y,z,fa of main direction of diffusion.
-        double rgba[4] = {0,0,0,0};
-        rgba[3] = fabs( tensor.GetFractionalAnisotropy()); // * 255 ); // fa = FractionalAnisotropy => Helligkeit = Value
-        typename itk::DiffusionTensor3D<T>::EigenValuesArrayType eigenValues;
-        typename itk::DiffusionTensor3D<T>::EigenVectorsMatrixType eigenVectors;
-        tensor.ComputeEigenAnalysis( eigenValues, eigenVectors ); // normalized eigenvectors as rows in ascending order.
-        rgba[0] = (fabs( eigenVectors(2, 0) ) * rgba[3]);
-        rgba[1] = (fabs( eigenVectors(2, 1) ) * rgba[3]);
-        rgba[2] = (fabs( eigenVectors(2, 2) ) * rgba[3]);
-        __IMG_DAT_ITEM__CLIP_0_1__(rgba[0]);
-        __IMG_DAT_ITEM__CLIP_0_1__(rgba[1]);
-        __IMG_DAT_ITEM__CLIP_0_1__(rgba[2]);
-        __IMG_DAT_ITEM__CLIP_0_1__(rgba[3]);
-
-        m_colourScalars-> InsertNextTuple4( rgba[0], rgba[1], rgba[2], rgba[3] );
-        data-> CopyScalarsOn();
-        data-> SetCopyAttribute(id, 1);
-        data-> SetCopyScalars(id);
-        data-> CopyAllOn();
-        data-> SetDebug('1');
-
-        pfilter-> DebugOn();
-        pfilter-> GetOutput()-> DebugOn();
-        pfilter-> GetOutput()-> GetPointData()-> CopyScalarsOn();
-
-        data-> AddArray( m_colourScalars );
-        data-> SetActiveScalars( "GLYPH_COLORS" );
-
-#ifndef NDEBUG
-        {
-          vtkIndent indent;
-          std::cout << "<data>\n";
-          data-> PrintSelf(std::cout, indent.GetNextIndent());
-          std::cout << "</data>\n<pfilter>\n";
-          pfilter-> PrintSelf(std::cout, indent.GetNextIndent());
-          std::cout << pfilter->GetOutput()->GetClassName() << "\n";
-          pfilter-> GetOutput()-> PrintSelf(std::cout, indent.GetNextIndent());
-          pfilter-> GetOutput()->GetPointData()-> PrintSelf(std::cout, indent.GetNextIndent());
-          pfilter-> GetOutput()->GetPointData()->GetScalars()-> PrintSelf(std::cout, indent.GetNextIndent());
-          std::cout << "</pfilter>";
-        }
-#endif
-
-      }
-      else
-      {
-        data-> SetActiveScalars( "vector" );
-        data-> RemoveArray( "GLYPH_COLORS" );
-      }
-    }
-
     else
     {
         for(int i=0; i<N; i++)
             odf[i] = (double)odfvals->GetComponent(id,i);
     }
 
+    double scale = m_Scaling;
     switch(m_ScaleBy)
     {
     case ODFSB_NONE:
-        m_OdfSource->SetScale(m_Scaling);
         break;
     case ODFSB_GFA:
-        m_OdfSource->SetScale(m_Scaling*odf.GetGeneralizedGFA(m_IndexParam1, m_IndexParam2));
+        scale = m_Scaling*odf.GetGeneralizedGFA(m_IndexParam1, m_IndexParam2);
         break;
     case ODFSB_PC:
-        m_OdfSource->SetScale(m_Scaling*odf.GetPrincipleCurvature(m_IndexParam1, m_IndexParam2, 0));
+        scale = m_Scaling*odf.GetPrincipleCurvature(m_IndexParam1, m_IndexParam2, 0);
+        break;
+    }
+
+    // same normalization as vtkOdfSource
+    OdfType colorOdf;
+    switch(m_Normalization)
+    {
+    case mitk::ODFN_MINMAX:
+        odf = odf.MinMaxNormalize();
+        colorOdf = odf;
+        break;
+    case mitk::ODFN_MAX:
+        odf = odf.MaxNormalize();
+        colorOdf = odf;
         break;
+    case mitk::ODFN_NONE:
+        colorOdf = odf.MaxNormalize();
+        break;
+    default:
+        odf = odf.MinMaxNormalize();
+        colorOdf = odf;
     }
 
-    m_OdfSource->SetNormalization(m_Normalization);
-    m_OdfSource->SetOdf(odf);
-    m_OdfSource->Modified();
+    buffer.m_Centers.push_back(center[0]);
+    buffer.m_Centers.push_back(center[1]);
+    buffer.m_Centers.push_back(center[2]);
+    const double radiusScale = scale*m_AdditionalScale*0.5;
+    for(int j=0; j<N; j++)
+    {
+        buffer.m_Radii.push_back(odf[j]*radiusScale);
+        buffer.m_ColorValues.push_back(colorOdf[j]);
+    }
+    for(int c=0; c<4; c++)
+        buffer.m_Rgba.push_back(rgba[c]);
+    buffer.m_NumberOfGlyphs++;
+}
+
+template<class T, int N>
+void  mitk::OdfVtkMapper2D<T,N>
+::BuildGlyphMesh(const GlyphBuffer& buffer, LocalStorage* localStorage, int index)
+{
+    vtkPolyData* mesh = localStorage->m_OdfsPlanes[index];
+    const vtkIdType numberOfGlyphs = buffer.m_NumberOfGlyphs;
+    const vtkIdType numberOfPoints = numberOfGlyphs*N;
+    const vtkIdType numberOfCells = numberOfGlyphs*m_NumberOfGlyphCellsPerGlyph;
+    const vtkIdType cellsSize = static_cast<vtkIdType>(m_GlyphCells.size());
+
+    vtkPoints* points = mesh->GetPoints();
+    if( points == NULL )
+    {
+        vtkSmartPointer<vtkPoints> newPoints = vtkSmartPointer<vtkPoints>::New();
+        newPoints->SetDataTypeToFloat();
+        mesh->SetPoints(newPoints);
+        points = newPoints;
+    }
+    points->SetNumberOfPoints(numberOfPoints);
+
+    vtkFloatArray* normals = vtkFloatArray::SafeDownCast(mesh->GetPointData()->GetNormals());
+    if( normals == NULL )
+    {
+        vtkSmartPointer<vtkFloatArray> newNormals = vtkSmartPointer<vtkFloatArray>::New();
+        newNormals->SetNumberOfComponents(3);
+        newNormals->SetName("Normals");
+        mesh->GetPointData()->SetNormals(newNormals);
+        normals = newNormals;
+    }
+    normals->SetNumberOfTuples(numberOfPoints);
+
+    vtkDoubleArray* colors = vtkDoubleArray::SafeDownCast(mesh->GetCellData()->GetScalars());
+    if( colors == NULL )
+    {
+        vtkSmartPointer<vtkDoubleArray> newColors = vtkSmartPointer<vtkDoubleArray>::New();
+        mesh->GetCellData()->SetScalars(newColors);
+        colors = newColors;
+    }
+    colors->SetNumberOfTuples(numberOfCells);
+
+    // the connectivity only depends on the number of glyphs
+    if( localStorage->m_NumberOfGlyphCells[index] != numberOfGlyphs || mesh->GetPolys() == NULL )
+    {
+        vtkSmartPointer<vtkIdTypeArray> cellIds = vtkSmartPointer<vtkIdTypeArray>::New();
+        cellIds->SetNumberOfValues(numberOfGlyphs*cellsSize);
+        vtkIdType* ids = cellIds->GetPointer(0);
+        for(vtkIdType g=0; g<numberOfGlyphs; g++)
+        {
+            const vtkIdType offset = g*N;
+            vtkIdType* glyphIds = ids + g*cellsSize;
+            for(vtkIdType c=0; c<cellsSize; )
+            {
+                const vtkIdType npts = m_GlyphCells[c];
+                glyphIds[c] = npts;
+                for(vtkIdType i=1; i<=npts; i++)
+                    glyphIds[c+i] = m_GlyphCells[c+i] + offset;
+                c += npts+1;
+            }
+        }
+        vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
+        polys->SetCells(numberOfCells, cellIds);
+        mesh->SetPolys(polys);
+        localStorage->m_NumberOfGlyphCells[index] = numberOfGlyphs;
+    }
+
+    float* pointData = static_cast<vtkFloatArray*>(points->GetData())->GetPointer(0);
+    float* normalData = normals->GetPointer(0);
+    double* colorData = colors->GetPointer(0);
+    for(vtkIdType g=0; g<numberOfGlyphs; g++)
+    {
+        const float* center = &buffer.m_Centers[3*g];
+        const float* radii = &buffer.m_Radii[g*N];
+        const float* colorValues = &buffer.m_ColorValues[g*N];
+        float* p = pointData + 3*g*N;
+        float* n = normalData + 3*g*N;
+        for(int j=0; j<N; j++)
+        {
+            p[3*j]   = center[0] + radii[j]*m_GlyphDirections[3*j];
+            p[3*j+1] = center[1] + radii[j]*m_GlyphDirections[3*j+1];
+            p[3*j+2] = center[2] + radii[j]*m_GlyphDirections[3*j+2];
+            n[3*j] = n[3*j+1] = n[3*j+2] = 0;
+        }
+
+        // point normals are the normalized sum of the normals of the adjacent cells, cell colors the mean of their vertices
+        double* cellColors = colorData + g*m_NumberOfGlyphCellsPerGlyph;
+        for(vtkIdType c=0, cell=0; c<cellsSize; cell++)
+        {
+            const vtkIdType npts = m_GlyphCells[c];
+            const vtkIdType* pts = &m_GlyphCells[c+1];
+            double val = 0;
+            for(vtkIdType i=0; i<npts; i++)
+                val += colorValues[pts[i]];
+            cellColors[cell] = 1-val/npts;
+
+            const float* p0 = p + 3*pts[0];
+            const float* p1 = p + 3*pts[1];
+            const float* p2 = p + 3*pts[2];
+            double e1[3] = { p1[0]-p0[0], p1[1]-p0[1], p1[2]-p0[2] };
+            double e2[3] = { p2[0]-p0[0], p2[1]-p0[1], p2[2]-p0[2] };
+            double cellNormal[3];
+            vtkMath::Cross(e1, e2, cellNormal);
+            vtkMath::Normalize(cellNormal);
+            for(vtkIdType i=0; i<npts; i++)
+            {
+                float* pointNormal = n + 3*pts[i];
+                pointNormal[0] += cellNormal[0];
+                pointNormal[1] += cellNormal[1];
+                pointNormal[2] += cellNormal[2];
+            }
+            c += npts+1;
+        }
+        for(int j=0; j<N; j++)
+            vtkMath::Normalize(n + 3*j);
+    }
+
+    if( m_toggleColourisationMode )
+    {
+        vtkSmartPointer<vtkDoubleArray> glyphColors = vtkSmartPointer<vtkDoubleArray>::New();
+        glyphColors->SetNumberOfComponents( 4 ); // red, green, blue and alpha are the 4 components per tuple.
+        glyphColors->SetName( "GLYPH_COLORS" );
+        glyphColors->SetNumberOfTuples(numberOfPoints);
+        for(vtkIdType g=0; g<numberOfGlyphs; g++)
+        {
+            const float* rgba = &buffer.m_Rgba[4*g];
+            for(int j=0; j<N; j++)
+                glyphColors->SetTuple4(g*N+j, rgba[0], rgba[1], rgba[2], rgba[3]);
+        }
+        mesh->GetPointData()->AddArray(glyphColors);
+    }
+    else
+    {
+        mesh->GetPointData()->RemoveArray( "GLYPH_COLORS" );
+    }
+
+    points->Modified();
+    normals->Modified();
+    colors->Modified();
+    mesh->Modified();
 }
 
 template<class T, int N>
@@ -503,6 +605,20 @@ void  mitk::OdfVtkMapper2D<T,N>
 
     int index = GetIndex(renderer);
 
+    // glyphs of recently displayed slices are only reassembled
+    const OdfDisplayGeometry displayGeometry = dispGeo;
+    std::list<GlyphBuffer>& buffers = localStorage->m_GlyphBuffers[index];
+    for(typename std::list<GlyphBuffer>::iterator it = buffers.begin(); it != buffers.end(); ++it)
+    {
+        if( dispGeo.Equals(it->m_DisplayGeometry) )
+        {
+            buffers.splice(buffers.begin(), buffers, it);
+            BuildGlyphMesh(buffers.front(), localStorage, index);
+            this->ShowGlyphMesh(localStorage, index);
+            return;
+        }
+    }
+
     vtkSmartPointer<vtkTransform> inversetransform = vtkSmartPointer<vtkTransform>::New();
     inversetransform->Identity();
     inversetransform->Concatenate(vtktransform->GetLinearInverse());
@@ -690,68 +806,64 @@ void  mitk::OdfVtkMapper2D<T,N>
 
         if(cuttedPlane->GetNumberOfPoints())
         {
-            localStorage->m_OdfsPlanes[index]->RemoveAllInputs();
-
-            vtkSmartPointer<vtkPolyDataNormals> normals = vtkSmartPointer<vtkPolyDataNormals>::New();
-            normals->SetInputConnection( m_OdfSource->GetOutputPort() );
-            normals->SplittingOff();
-            normals->ConsistencyOff();
-            normals->AutoOrientNormalsOff();
-            normals->ComputePointNormalsOn();
-            normals->ComputeCellNormalsOff();
-            normals->FlipNormalsOff();
-            normals->NonManifoldTraversalOff();
-
-            vtkSmartPointer<vtkTransformPolyDataFilter> trans = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
-            trans->SetInputConnection( normals->GetOutputPort() );
-            trans->SetTransform(m_OdfTransform);
-
-            vtkSmartPointer<vtkMaskedProgrammableGlyphFilter> glyphGenerator = vtkSmartPointer<vtkMaskedProgrammableGlyphFilter>::New();
-            glyphGenerator->SetMaximumNumberOfPoints(std::min(m_ShowMaxNumber,(int)cuttedPlane->GetNumberOfPoints()));
-
-            glyphGenerator->SetRandomMode( m_toggleGlyphPlacementMode );
-
-            glyphGenerator->SetUseMaskPoints(1);
-            glyphGenerator->SetSourceConnection(trans->GetOutputPort() );
-            glyphGenerator->SetInput(cuttedPlane);
-
-            if( not m_toggleColourisationMode )
-            {
-              glyphGenerator-> SetColorModeToColorBySource();
-              glyphGenerator-> SetInputArrayToProcess(0,0,0, vtkDataObject::FIELD_ASSOCIATION_POINTS , "vector");
-              if(m_colourScalars != nullptr) { m_colourScalars-> Initialize(); }
-            }
-            else if ( m_toggleColourisationMode )
-            {
-              m_colourScalars = vtkSmartPointer<vtkDoubleArray>::New();
-              m_colourScalars-> SetNumberOfComponents( 4 ); // red, green, blue and alpha are the 4 components per tuple.
-              m_colourScalars-> SetName( "GLYPH_COLORS" );
-              glyphGenerator-> SetColorModeToColorByInput();
-              glyphGenerator-> SetInputArrayToProcess(0,0,0, vtkDataObject::FIELD_ASSOCIATION_POINTS , "GLYPH_COLORS");
-            }
-
-            glyphGenerator->SetGeometry(this->GetDataNode()->GetData()->GetGeometry());
-            glyphGenerator->SetGlyphMethod(&(GlyphMethod),(void *)glyphGenerator);
-
-            try
-            {
-              glyphGenerator->Update();
-            }
-            catch( itk::ExceptionObject& err )
+            InitializeGlyphTemplate();
+
+            GlyphBuffer buffer;
+            buffer.m_DisplayGeometry = displayGeometry;
+            buffer.m_NumberOfGlyphs = 0;
+
+            int maximumNumberOfGlyphs = std::min(m_ShowMaxNumber,(int)cuttedPlane->GetNumberOfPoints());
+            vtkSmartPointer<vtkMaskPoints> maskPoints = vtkSmartPointer<vtkMaskPoints>::New();
+            maskPoints->SetInputData(cuttedPlane);
+            maskPoints->SetMaximumNumberOfPoints(maximumNumberOfGlyphs);
+            maskPoints->SetOnRatio(cuttedPlane->GetNumberOfPoints() / maximumNumberOfGlyphs);
+            maskPoints->SetRandomMode( m_toggleGlyphPlacementMode );
+            maskPoints->Update();
+            vtkPolyData* glyphPoints = maskPoints->GetOutput();
+
+            vtkDataArray* odfvals = glyphPoints->GetPointData()->GetArray("vector");
+            if( odfvals != NULL )
             {
-                std::cout << err << std::endl;
+                mitk::BaseGeometry* geometry = this->GetDataNode()->GetData()->GetGeometry();
+                Vector3D spacing = geometry->GetSpacing();
+                vtkIdType numberOfGlyphs = glyphPoints->GetNumberOfPoints();
+                buffer.m_Centers.reserve(3*numberOfGlyphs);
+                buffer.m_Radii.reserve(N*numberOfGlyphs);
+                buffer.m_ColorValues.reserve(N*numberOfGlyphs);
+                buffer.m_Rgba.reserve(4*numberOfGlyphs);
+                for(vtkIdType id=0; id<numberOfGlyphs; id++)
+                {
+                    double point[3];
+                    glyphPoints->GetPoint(id, point);
+                    itk::Point<double,3> p(point);
+                    p[0] /= spacing[0];
+                    p[1] /= spacing[1];
+                    p[2] /= spacing[2];
+                    mitk::Point3D center;
+                    geometry->IndexToWorld( p, center );
+                    AddGlyph(odfvals, id, center, buffer);
+                }
             }
 
-            localStorage->m_OdfsPlanes[index]->AddInputConnection(glyphGenerator->GetOutputPort());
-            localStorage->m_OdfsPlanes[index]->Update();
+            buffers.push_front(buffer);
+            if( buffers.size() > NumberOfCachedSlices )
+                buffers.pop_back();
+            BuildGlyphMesh(buffers.front(), localStorage, index);
         }
     }
+    this->ShowGlyphMesh(localStorage, index);
+}
+
+template<class T, int N>
+void  mitk::OdfVtkMapper2D<T,N>
+::ShowGlyphMesh(LocalStorage* localStorage, int index)
+{
     localStorage->m_PropAssemblies[index]->VisibilityOn();
     if(localStorage->m_PropAssemblies[index]->GetParts()->IsItemPresent(localStorage->m_OdfsActors[index]))
     {
       localStorage->m_PropAssemblies[index]->RemovePart(localStorage->m_OdfsActors[index]);
     }
-    localStorage->m_OdfsMappers[index]->SetInputData(localStorage->m_OdfsPlanes[index]->GetOutput());
+    localStorage->m_OdfsMappers[index]->SetInputData(localStorage->m_OdfsPlanes[index]);
     localStorage->m_PropAssemblies[index]->AddPart(localStorage->m_OdfsActors[index]);
 }
 
@@ -884,14 +996,22 @@ void  mitk::OdfVtkMapper2D<T,N>
     OdfDisplayGeometry dispGeo = MeasureDisplayedGeometry( renderer);
 
 
-    if ( (localStorage->m_LastUpdateTime >= m_DataNode->GetMTime()) //was the node modified?
+    bool dataUnchanged = (localStorage->m_LastUpdateTime >= m_DataNode->GetMTime()) //was the node modified?
       && (localStorage->m_LastUpdateTime >= m_DataNode->GetPropertyList()->GetMTime()) //was a property modified?
-      && (localStorage->m_LastUpdateTime >= m_DataNode->GetPropertyList(renderer)->GetMTime())
-      && dispGeo.Equals(m_LastDisplayGeometry))
+      && (localStorage->m_LastUpdateTime >= m_DataNode->GetPropertyList(renderer)->GetMTime());
+
+    if ( dataUnchanged && dispGeo.Equals(m_LastDisplayGeometry))
     {
       return;
     }
 
+    // cached glyphs are only valid for the same data and properties
+    if ( !dataUnchanged )
+    {
+      for(unsigned int i=0; i<localStorage->m_GlyphBuffers.size(); i++)
+        localStorage->m_GlyphBuffers[i].clear();
+    }
+
     localStorage->m_LastUpdateTime.Modified();
 
     if(!IsVisibleOdfs(renderer))
@@ -906,7 +1026,7 @@ void  mitk::OdfVtkMapper2D<T,N>
       localStorage->m_OdfsActors[1]->VisibilityOn();
       localStorage->m_OdfsActors[2]->VisibilityOn();
 
-      m_OdfSource->SetAdditionalScale(GetMinImageSpacing(GetIndex(renderer)));
+      m_AdditionalScale = GetMinImageSpacing(GetIndex(renderer));
       ApplyPropertySettings();
 
       for(unsigned iter=0; iter<3; ++iter)
@@ -61,16 +61,38 @@ EnergyComputer::EnergyComputer(ItkFloatImageType* mask, ParticleGrid* particleGr
     if (QBALL_ODFSIZE != m_SphereInterpolator->nverts)
         fprintf(stderr,"EnergyComputer: error during init: data does not match with interpolation scheme\n");
 
-    int totsz = m_Size[0]*m_Size[1]*m_Size[2];
+    m_Region = mask->GetLargestPossibleRegion();
+    ComputeActiveVoxels();
+}
+
+void EnergyComputer::SetRegion(const ItkRegionType& region)
+{
+    m_Region = region;
+    m_Region.Crop(m_Mask->GetLargestPossibleRegion());
+    ComputeActiveVoxels();
+}
+
+void EnergyComputer::ComputeActiveVoxels()
+{
+    int totsz = m_Region.GetNumberOfPixels();
+    m_CumulatedSpatialProbability.clear();
+    m_ActiveIndices.clear();
     m_CumulatedSpatialProbability.resize(totsz + 1, 0.0);
     m_ActiveIndices.resize(totsz, 0);
 
+    int xBegin = m_Region.GetIndex()[0];
+    int yBegin = m_Region.GetIndex()[1];
+    int zBegin = m_Region.GetIndex()[2];
+    int xEnd = xBegin + m_Region.GetSize()[0];
+    int yEnd = yBegin + m_Region.GetSize()[1];
+    int zEnd = zBegin + m_Region.GetSize()[2];
+
     // calculate active voxels and cumulate probabilities
     m_NumActiveVoxels = 0;
     m_CumulatedSpatialProbability[0] = 0;
-    for (int x = 0; x < m_Size[0];x++)
-        for (int y = 0; y < m_Size[1];y++)
-            for (int z = 0; z < m_Size[2];z++)
+    for (int x = xBegin; x < xEnd;x++)
+        for (int y = yBegin; y < yEnd;y++)
+            for (int z = zBegin; z < zEnd;z++)
             {
                 int idx = x+(y+z*m_Size[1])*m_Size[0];
                 ItkFloatImageType::IndexType index;
@@ -140,7 +162,7 @@ float EnergyComputer::SpatProb(vnl_vector_fixed<float, 3> pos)
     index[1] = floor(pos[1]/m_Spacing[1]);
     index[2] = floor(pos[2]/m_Spacing[2]);
 
-    if (m_Mask->GetLargestPossibleRegion().IsInside(index)) // is inside image?
+    if (m_Region.IsInside(index)) // is inside image (or the region of the current chain)?
         return m_Mask->GetPixel(index);
     else
         return 0;
@@ -166,6 +188,23 @@ float EnergyComputer::mexp(float x)
     //  return exp(-x);
 }
 
+float EnergyComputer::ComputeTotalEnergy()
+{
+    float energy = 0;
+    for (int i=0; i<m_ParticleGrid->m_NumParticles; i++)
+    {
+        Particle* p = m_ParticleGrid->GetParticle(i);
+        energy += ComputeExternalEnergy(p->GetPos(), p->GetDir(), p);
+
+        // each connection is shared by two particles
+        if (p->pID != -1)
+            energy += 0.5*ComputeInternalEnergyConnection(p,+1);
+        if (p->mID != -1)
+            energy += 0.5*ComputeInternalEnergyConnection(p,-1);
+    }
+    return energy;
+}
+
 int EnergyComputer::GetNumActiveVoxels()
 {
     return m_NumActiveVoxels;
@@ -36,11 +36,15 @@ public:
     //typedef itk::Vector<float, QBALL_ODFSIZE>   OdfVectorType;
     //typedef itk::Image<OdfVectorType, 3>        ItkQBallImgType;
     typedef itk::Image<float, 3>                ItkFloatImageType;
+    typedef ItkFloatImageType::RegionType       ItkRegionType;
     typedef itk::Statistics::MersenneTwisterRandomVariateGenerator ItkRandGenType;
 
     EnergyComputer(ItkFloatImageType* mask, ParticleGrid* particleGrid, SphereInterpolator* interpolator, ItkRandGenType* randGen);
     void SetParameters(float particleWeight, float particleWidth, float connectionPotential, float curvThres, float inexBalance, float particlePotential);
 
+    // restrict particles to a region of the mask, e.g. the slab of one of several parallel chains
+    void SetRegion(const ItkRegionType& region);
+
     // get random position inside mask
     void DrawRandomPosition(vnl_vector_fixed<float, 3>& R);
 
@@ -52,6 +56,9 @@ public:
     virtual float ComputeInternalEnergyConnection(Particle *p1,int ep1, Particle *p2, int ep2) = 0;
     virtual float ComputeInternalEnergy(Particle *dp) = 0;
 
+    // energy of the current particle configuration: external energy of each particle and internal energy of each connection
+    float ComputeTotalEnergy();
+
     int GetNumActiveVoxels();
 
 protected:
@@ -61,6 +68,7 @@ protected:
     ParticleGrid*                   m_ParticleGrid;
     ItkRandGenType*                 m_RandGen;
     ItkFloatImageType*              m_Mask;
+    ItkRegionType                   m_Region;           // particles are only allowed inside this region
     vnl_vector_fixed<int, 3>        m_Size;
     vnl_vector_fixed<float, 3>      m_Spacing;
     std::vector< float >            m_CumulatedSpatialProbability;
@@ -79,6 +87,7 @@ protected:
     float   m_SquaredParticleLength;        // squared particle length
     float   m_CurvatureThreshold;           // maximum angle accepted between two connected particles
 
+    void ComputeActiveVoxels();
     float SpatProb(vnl_vector_fixed<float, 3> pos);
     float EvaluateOdf(vnl_vector_fixed<float, 3> &pos, vnl_vector_fixed<float, 3> dir);
     float mbesseli0(float x);
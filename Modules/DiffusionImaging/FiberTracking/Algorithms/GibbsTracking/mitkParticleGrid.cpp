@@ -22,6 +22,16 @@ See LICENSE.txt or http://www.mitk.org for details.
 using namespace mitk;
 
 ParticleGrid::ParticleGrid(ItkFloatImageType* image, float particleLength, int cellCapacity)
+{
+    InitializeGrid(image, image->GetLargestPossibleRegion(), particleLength, cellCapacity);
+}
+
+ParticleGrid::ParticleGrid(ItkFloatImageType* image, const ItkRegionType& region, float particleLength, int cellCapacity)
+{
+    InitializeGrid(image, region, particleLength, cellCapacity);
+}
+
+void ParticleGrid::InitializeGrid(ItkFloatImageType* image, const ItkRegionType& region, float particleLength, int cellCapacity)
 {
     // initialize counters
     m_NumParticles = 0;
@@ -31,12 +41,15 @@ ParticleGrid::ParticleGrid(ItkFloatImageType* image, float particleLength, int c
 
     // define isotropic grid from voxel spacing and particle length
     float cellSize = 2*m_ParticleLength;
-    m_GridSize[0] = image->GetLargestPossibleRegion().GetSize()[0]*image->GetSpacing()[0]/cellSize +1;
-    m_GridSize[1] = image->GetLargestPossibleRegion().GetSize()[1]*image->GetSpacing()[1]/cellSize +1;
-    m_GridSize[2] = image->GetLargestPossibleRegion().GetSize()[2]*image->GetSpacing()[2]/cellSize +1;
+    m_GridSize[0] = region.GetSize()[0]*image->GetSpacing()[0]/cellSize +1;
+    m_GridSize[1] = region.GetSize()[1]*image->GetSpacing()[1]/cellSize +1;
+    m_GridSize[2] = region.GetSize()[2]*image->GetSpacing()[2]/cellSize +1;
     m_GridScale[0] = 1/cellSize;
     m_GridScale[1] = 1/cellSize;
     m_GridScale[2] = 1/cellSize;
+    m_GridOrigin[0] = region.GetIndex()[0]*image->GetSpacing()[0];
+    m_GridOrigin[1] = region.GetIndex()[1]*image->GetSpacing()[1];
+    m_GridOrigin[2] = region.GetIndex()[2]*image->GetSpacing()[2];
 
     m_CellCapacity = cellCapacity;          // maximum number of particles per grid cell
     m_ContainerCapacity = 100000;           // initial particle container capacity
@@ -127,17 +140,17 @@ Particle* ParticleGrid::NewParticle(vnl_vector_fixed<float, 3> R)
             return nullptr;
     }
 
-    int xint = int(R[0]*m_GridScale[0]);
+    int xint = int((R[0]-m_GridOrigin[0])*m_GridScale[0]);
     if (xint < 0)
         return nullptr;
     if (xint >= m_GridSize[0])
         return nullptr;
-    int yint = int(R[1]*m_GridScale[1]);
+    int yint = int((R[1]-m_GridOrigin[1])*m_GridScale[1]);
     if (yint < 0)
         return nullptr;
     if (yint >= m_GridSize[1])
         return nullptr;
-    int zint = int(R[2]*m_GridScale[2]);
+    int zint = int((R[2]-m_GridOrigin[2])*m_GridScale[2]);
     if (zint < 0)
         return nullptr;
     if (zint >= m_GridSize[2])
@@ -167,17 +180,17 @@ bool ParticleGrid::TryUpdateGrid(int k)
 {
     Particle* p = &(m_Particles[k]);
 
-    int xint = int(p->GetPos()[0]*m_GridScale[0]);
+    int xint = int((p->GetPos()[0]-m_GridOrigin[0])*m_GridScale[0]);
     if (xint < 0)
         return false;
     if (xint >= m_GridSize[0])
         return false;
-    int yint = int(p->GetPos()[1]*m_GridScale[1]);
+    int yint = int((p->GetPos()[1]-m_GridOrigin[1])*m_GridScale[1]);
     if (yint < 0)
         return false;
     if (yint >= m_GridSize[1])
         return false;
-    int zint = int(p->GetPos()[2]*m_GridScale[2]);
+    int zint = int((p->GetPos()[2]-m_GridOrigin[2])*m_GridScale[2]);
     if (zint < 0)
         return false;
     if (zint >= m_GridSize[2])
@@ -264,9 +277,9 @@ void ParticleGrid::RemoveParticle(int k)
 
 void ParticleGrid::ComputeNeighbors(vnl_vector_fixed<float, 3> &R)
 {
-    float xfrac = R[0]*m_GridScale[0];
-    float yfrac = R[1]*m_GridScale[1];
-    float zfrac = R[2]*m_GridScale[2];
+    float xfrac = (R[0]-m_GridOrigin[0])*m_GridScale[0];
+    float yfrac = (R[1]-m_GridOrigin[1])*m_GridScale[1];
+    float zfrac = (R[2]-m_GridOrigin[2])*m_GridScale[2];
     int xint = int(xfrac);
     int yint = int(yfrac);
     int zint = int(zfrac);
@@ -386,6 +399,42 @@ void ParticleGrid::DestroyConnection(Particle *P1,int ep1)
     m_NumConnections--;
 }
 
+// copy particles and connections of a grid which was created for the same image
+int ParticleGrid::InsertParticles(ParticleGrid* grid)
+{
+    int numFailed = 0;
+    std::vector< int > newIds(grid->m_NumParticles, -1);
+    for (int i=0; i<grid->m_NumParticles; i++)
+    {
+        Particle* source = grid->GetParticle(i);
+        Particle* p = NewParticle(source->GetPos());
+        if (p==nullptr)
+        {
+            numFailed++;
+            continue;
+        }
+        p->GetDir() = source->GetDir();
+        newIds[i] = p->ID;
+    }
+
+    // every connection is created once, from the particle with the smaller ID
+    for (int i=0; i<grid->m_NumParticles; i++)
+    {
+        Particle* source = grid->GetParticle(i);
+        if (newIds[i]==-1)
+            continue;
+        for (int ep=-1; ep<=1; ep+=2)
+        {
+            int partner = (ep==1)? source->pID : source->mID;
+            if (partner<=i || newIds[partner]==-1)
+                continue;
+            int partnerEp = (grid->GetParticle(partner)->pID==i)? 1 : -1;
+            CreateConnection(GetParticle(newIds[i]), ep, GetParticle(newIds[partner]), partnerEp);
+        }
+    }
+    return numFailed;
+}
+
 bool ParticleGrid::CheckConsistency()
 {
     for (int i=0; i<m_NumParticles; i++)
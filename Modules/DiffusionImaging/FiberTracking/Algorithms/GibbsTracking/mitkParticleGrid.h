@@ -36,6 +36,7 @@ class MITKFIBERTRACKING_EXPORT ParticleGrid
 public:
 
     typedef itk::Image< float, 3 >  ItkFloatImageType;
+    typedef ItkFloatImageType::RegionType ItkRegionType;
 
     int m_NumParticles;         // number of particles
     int m_NumConnections;       // number of connections
@@ -43,6 +44,7 @@ public:
     float m_ParticleLength;
 
     ParticleGrid(ItkFloatImageType* image, float particleLength, int cellCapacity);
+    ParticleGrid(ItkFloatImageType* image, const ItkRegionType& region, float particleLength, int cellCapacity);   ///< grid only covering the given image region
     ~ParticleGrid();
 
     Particle* GetParticle(int ID);
@@ -60,9 +62,11 @@ public:
 
     bool CheckConsistency();
     void ResetGrid();
+    int InsertParticles(ParticleGrid* grid);  ///< copies the particles and connections of another grid, returns the number of particles that could not be inserted
 
 protected:
 
+    void InitializeGrid(ItkFloatImageType* image, const ItkRegionType& region, float particleLength, int cellCapacity);
     bool ReallocateGrid();
 
     std::vector< Particle* >    m_Grid;             // the grid
@@ -73,6 +77,7 @@ protected:
 
     vnl_vector_fixed< int, 3 >      m_GridSize;     // grid dimensions
     vnl_vector_fixed< float, 3 >    m_GridScale;    // scaling factor for grid
+    vnl_vector_fixed< float, 3 >    m_GridOrigin;   // position of the first grid cell
 
     int m_CellCapacity;      // particle capacity of single cell in grid
 
@@ -29,6 +29,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkImageDuplicator.h>
 #include <itkResampleImageFilter.h>
 #include <itkTimeProbe.h>
+#include <itkImageRegionConstIteratorWithIndex.h>
 
 // MISC
 #include <fstream>
@@ -66,7 +67,10 @@ GibbsTrackingFilter< ItkQBallImageType >::GibbsTrackingFilter():
     m_RandomSeed(-1),
     m_LoadParameterFile(""),
     m_LutPath(""),
-    m_IsInValidState(true)
+    m_IsInValidState(true),
+    m_NumberOfChains(1),
+    m_SerialFraction(0.1),
+    m_Energy(0)
 {
 
 }
@@ -290,10 +294,34 @@ void GibbsTrackingFilter< ItkQBallImageType >::GenerateData()
     TimeProbe clock; clock.Start();
     m_NumAcceptedFibers = 0;
     unsigned long counter = 1;
+    unsigned long parallelAccepted = 0;
 
-    boost::progress_display disp(m_Steps*singleIts);
+    // sample the first temperature steps with parallel chains
+    unsigned int firstSerialStep = 1;
+    if (m_NumberOfChains>1 && !m_AbortTracking)
+    {
+        unsigned int serialSteps = std::max(1, (int)(m_SerialFraction*m_Steps+0.5));
+        if (serialSteps < m_Steps)
+        {
+            unsigned int parallelSteps = m_Steps-serialSteps;
+            if (!RunParallelChains(particleGrid, interpolator, randGen, singleIts, parallelSteps, counter, parallelAccepted))
+            {
+                delete sampler;
+                delete encomp;
+                delete interpolator;
+                delete particleGrid;
+                m_IsInValidState = false;
+                m_AbortTracking = true;
+                m_BuildFibers = false;
+                return;
+            }
+            firstSerialStep = parallelSteps+1;
+        }
+    }
+
+    boost::progress_display disp((m_Steps-firstSerialStep+1)*singleIts);
     if (!m_AbortTracking)
-    for( m_CurrentStep = 1; m_CurrentStep <= m_Steps; m_CurrentStep++ )
+    for( m_CurrentStep = firstSerialStep; m_CurrentStep <= m_Steps; m_CurrentStep++ )
     {
         // update temperatur for simulated annealing process
         float temperature = m_StartTemperature * exp(alpha*(((1.0)*m_CurrentStep)/((1.0)*m_Steps)));
@@ -309,7 +337,7 @@ void GibbsTrackingFilter< ItkQBallImageType >::GenerateData()
 
             if (m_BuildFibers || (i==singleIts-1 && m_CurrentStep==m_Steps))
             {
-                m_ProposalAcceptance = (float)sampler->GetNumAcceptedProposals()/counter;
+                m_ProposalAcceptance = (float)(parallelAccepted+sampler->GetNumAcceptedProposals())/counter;
                 m_NumParticles = particleGrid->m_NumParticles;
                 m_NumConnections = particleGrid->m_NumConnections;
 
@@ -321,7 +349,7 @@ void GibbsTrackingFilter< ItkQBallImageType >::GenerateData()
             counter++;
         }
 
-        m_ProposalAcceptance = (float)sampler->GetNumAcceptedProposals()/counter;
+        m_ProposalAcceptance = (float)(parallelAccepted+sampler->GetNumAcceptedProposals())/counter;
         m_NumParticles = particleGrid->m_NumParticles;
         m_NumConnections = particleGrid->m_NumConnections;
 
@@ -335,6 +363,7 @@ void GibbsTrackingFilter< ItkQBallImageType >::GenerateData()
         m_NumAcceptedFibers = m_FiberPolyData->GetNumberOfLines();
     }
     clock.Stop();
+    m_Energy = encomp->ComputeTotalEnergy();
 
     delete sampler;
     delete encomp;
@@ -351,12 +380,208 @@ void GibbsTrackingFilter< ItkQBallImageType >::GenerateData()
     s = (int)preClock.GetTotal()%60;
     MITK_INFO << "GibbsTrackingFilter: preparation of the data took " << m << "m and " << s << "s";
     MITK_INFO << "GibbsTrackingFilter: " << m_NumAcceptedFibers << " fibers accepted";
+    MITK_INFO << "GibbsTrackingFilter: energy of the final configuration " << m_Energy;
 
 //    sampler->PrintProposalTimes();
 
     SaveParameters();
 }
 
+template< class ItkQBallImageType >
+void GibbsTrackingFilter< ItkQBallImageType >::PartitionMask(unsigned int numberOfChains, std::vector< ItkFloatImageType::RegionType >& regions, std::vector< unsigned long >& activeVoxels)
+{
+    ItkFloatImageType::RegionType region = m_MaskImage->GetLargestPossibleRegion();
+    unsigned int axis = 0;
+    for (unsigned int d=1; d<3; d++)
+        if (region.GetSize()[d] > region.GetSize()[axis])
+            axis = d;
+    unsigned int numSlices = region.GetSize()[axis];
+    if (numberOfChains > numSlices)
+        numberOfChains = numSlices;
+
+    // active voxels per slice along the longest axis
+    std::vector< unsigned long > sliceCount(numSlices, 0);
+    unsigned long total = 0;
+    ImageRegionConstIteratorWithIndex< ItkFloatImageType > it(m_MaskImage, region);
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+        if (it.Get() > 0.5)
+        {
+            sliceCount[it.GetIndex()[axis]-region.GetIndex()[axis]]++;
+            total++;
+        }
+    }
+
+    regions.clear();
+    activeVoxels.clear();
+    unsigned int firstSlice = 0;
+    unsigned long cumulated = 0;
+    unsigned long slabCount = 0;
+    for (unsigned int s=0; s<numSlices; s++)
+    {
+        cumulated += sliceCount[s];
+        slabCount += sliceCount[s];
+
+        // close the slab if it contains its share of the active voxels or if the remaining slices are needed for the remaining chains
+        unsigned int chain = regions.size();
+        bool closeSlab = (s==numSlices-1);
+        if (chain+1 < numberOfChains)
+            closeSlab = cumulated*numberOfChains >= total*(chain+1) || numSlices-s-1 == numberOfChains-chain-1;
+
+        if (closeSlab)
+        {
+            ItkFloatImageType::RegionType slab = region;
+            slab.SetIndex(axis, region.GetIndex()[axis]+firstSlice);
+            slab.SetSize(axis, s-firstSlice+1);
+            regions.push_back(slab);
+            activeVoxels.push_back(slabCount);
+            firstSlice = s+1;
+            slabCount = 0;
+        }
+    }
+}
+
+template< class ItkQBallImageType >
+bool GibbsTrackingFilter< ItkQBallImageType >::RunParallelChains(mitk::ParticleGrid* particleGrid, SphereInterpolator* interpolator, Statistics::MersenneTwisterRandomVariateGenerator* randGen,
+                                                                 unsigned long singleIts, unsigned int parallelSteps, unsigned long& numProposals, unsigned long& numAcceptedProposals)
+{
+    std::vector< ItkFloatImageType::RegionType > regions;
+    std::vector< unsigned long > activeVoxels;
+    PartitionMask(m_NumberOfChains, regions, activeVoxels);
+    unsigned long totalActiveVoxels = 0;
+    for (unsigned int k=0; k<activeVoxels.size(); k++)
+        totalActiveVoxels += activeVoxels[k];
+
+    // every chain gets its own components, seeded from the main random generator for reproducible results
+    std::vector< GibbsChain > chains(regions.size());
+    bool success = true;
+    for (unsigned int k=0; k<chains.size(); k++)
+    {
+        GibbsChain& chain = chains[k];
+        chain.m_ParticleGrid = nullptr;
+        chain.m_Interpolator = nullptr;
+        chain.m_EnergyComputer = nullptr;
+        chain.m_Sampler = nullptr;
+        chain.m_RandGen = Statistics::MersenneTwisterRandomVariateGenerator::New();
+        chain.m_RandGen->SetSeed(randGen->GetIntegerVariate());
+        chain.m_ProposalsPerStep = totalActiveVoxels>0 ? (unsigned long)((double)singleIts*activeVoxels[k]/totalActiveVoxels) : 0;
+        if (!success)
+            continue;
+        try
+        {
+            chain.m_ParticleGrid = new ParticleGrid(m_MaskImage, regions[k], m_ParticleLength, m_ParticleGridCellCapacity);
+            chain.m_Interpolator = new SphereInterpolator(*interpolator);
+            chain.m_EnergyComputer = new GibbsEnergyComputer(m_QBallImage, m_MaskImage, chain.m_ParticleGrid, chain.m_Interpolator, chain.m_RandGen);
+            chain.m_EnergyComputer->SetParameters(m_ParticleWeight,m_ParticleWidth,m_ConnectionPotential*m_ParticleLength*m_ParticleLength,m_CurvatureThreshold,m_InexBalance,m_ParticlePotential);
+            chain.m_EnergyComputer->SetRegion(regions[k]);
+            chain.m_Sampler = new MetropolisHastingsSampler(chain.m_ParticleGrid, chain.m_EnergyComputer, chain.m_RandGen, m_CurvatureThreshold);
+        }
+        catch(...)
+        {
+            MITK_ERROR << "Particle grid allocation of the parallel chains failed. Not enough memory? Try to reduce the number of chains.";
+            success = false;
+        }
+    }
+
+    if (success)
+    {
+        MITK_INFO << "GibbsTrackingFilter: sampling " << parallelSteps << " of " << m_Steps << " temperature steps with " << chains.size() << " parallel chains";
+
+        ParallelChainsData data;
+        data.m_Filter = this;
+        data.m_Chains = &chains;
+
+        // the chains are synchronized a few times to report the progress and to build intermediate fibers
+        unsigned int stepsPerBatch = std::max(1u, parallelSteps/100);
+        boost::progress_display disp(parallelSteps);
+        for (unsigned int firstStep = 1; firstStep <= parallelSteps && !m_AbortTracking; firstStep += stepsPerBatch)
+        {
+            data.m_FirstStep = firstStep;
+            data.m_LastStep = std::min(firstStep+stepsPerBatch-1, parallelSteps);
+
+            this->GetMultiThreader()->SetNumberOfThreads(chains.size());
+            this->GetMultiThreader()->SetSingleMethod(SampleChainsCallback, &data);
+            this->GetMultiThreader()->SingleMethodExecute();
+
+            m_CurrentStep = data.m_LastStep;
+            m_NumParticles = 0;
+            m_NumConnections = 0;
+            numAcceptedProposals = 0;
+            for (unsigned int k=0; k<chains.size(); k++)
+            {
+                m_NumParticles += chains[k].m_ParticleGrid->m_NumParticles;
+                m_NumConnections += chains[k].m_ParticleGrid->m_NumConnections;
+                numAcceptedProposals += chains[k].m_Sampler->GetNumAcceptedProposals();
+            }
+            numProposals = 1 + (unsigned long)data.m_LastStep*singleIts;
+            m_ProposalAcceptance = (float)numAcceptedProposals/numProposals;
+            disp += data.m_LastStep-data.m_FirstStep+1;
+
+            if (m_BuildFibers)
+            {
+                MergeChains(chains, particleGrid);
+                FiberBuilder fiberBuilder(particleGrid, m_MaskImage);
+                m_FiberPolyData = fiberBuilder.iterate(m_MinFiberLength);
+                m_NumAcceptedFibers = m_FiberPolyData->GetNumberOfLines();
+                m_BuildFibers = false;
+            }
+        }
+        MergeChains(chains, particleGrid);
+    }
+
+    for (unsigned int k=0; k<chains.size(); k++)
+    {
+        delete chains[k].m_Sampler;
+        delete chains[k].m_EnergyComputer;
+        delete chains[k].m_Interpolator;
+        delete chains[k].m_ParticleGrid;
+    }
+    return success;
+}
+
+template< class ItkQBallImageType >
+void GibbsTrackingFilter< ItkQBallImageType >::MergeChains(std::vector< GibbsChain >& chains, mitk::ParticleGrid* particleGrid)
+{
+    if (particleGrid->m_NumParticles > 0)
+        particleGrid->ResetGrid();
+
+    int numFailed = 0;
+    for (unsigned int k=0; k<chains.size(); k++)
+        numFailed += particleGrid->InsertParticles(chains[k].m_ParticleGrid);
+    if (numFailed > 0)
+        MITK_WARN << "GibbsTrackingFilter: " << numFailed << " particles of the parallel chains could not be merged";
+}
+
+template< class ItkQBallImageType >
+ITK_THREAD_RETURN_TYPE GibbsTrackingFilter< ItkQBallImageType >::SampleChainsCallback(void* arg)
+{
+    MultiThreader::ThreadInfoStruct* info = static_cast<MultiThreader::ThreadInfoStruct*>(arg);
+    ParallelChainsData* data = static_cast<ParallelChainsData*>(info->UserData);
+
+    // the multithreader may provide less threads than chains
+    for (unsigned int k=info->ThreadID; k<data->m_Chains->size(); k+=info->NumberOfThreads)
+        data->m_Filter->SampleChain((*data->m_Chains)[k], data->m_FirstStep, data->m_LastStep);
+    return ITK_THREAD_RETURN_VALUE;
+}
+
+template< class ItkQBallImageType >
+void GibbsTrackingFilter< ItkQBallImageType >::SampleChain(GibbsChain& chain, unsigned int firstStep, unsigned int lastStep)
+{
+    float alpha = log(m_EndTemperature/m_StartTemperature);
+    for (unsigned int step = firstStep; step <= lastStep; step++)
+    {
+        float temperature = m_StartTemperature * exp(alpha*(((1.0)*step)/((1.0)*m_Steps)));
+        chain.m_Sampler->SetTemperature(temperature);
+
+        for (unsigned long i=0; i<chain.m_ProposalsPerStep; i++)
+        {
+            if (m_AbortTracking)
+                return;
+            chain.m_Sampler->MakeProposal();
+        }
+    }
+}
+
 template< class ItkQBallImageType >
 void GibbsTrackingFilter< ItkQBallImageType >::PrepareMaskImage()
 {
@@ -18,12 +18,16 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 // MITK
 #include <mitkSphereInterpolator.h>
+#include <mitkParticleGrid.h>
+#include <mitkMetropolisHastingsSampler.h>
+#include <mitkGibbsEnergyComputer.h>
 
 // ITK
 #include <itkProcessObject.h>
 #include <itkImage.h>
 #include <itkDiffusionTensor3D.h>
 #include <itkMersenneTwisterRandomVariateGenerator.h>
+#include <itkMultiThreader.h>
 
 // VTK
 #include <vtkSmartPointer.h>
@@ -35,7 +39,14 @@ See LICENSE.txt or http://www.mitk.org for details.
 namespace itk{
 
 /**
-* \brief Performes global fiber tractography on the input Q-Ball or tensor image (Gibbs tracking, Reisert 2010).   */
+* \brief Performes global fiber tractography on the input Q-Ball or tensor image (Gibbs tracking, Reisert 2010).
+*
+* With more than one chain (SetNumberOfChains), the mask is split into slabs along its longest axis, each containing
+* the same number of active voxels. Every slab is sampled by an independent chain (own particle grid, energy computer
+* and random generator) in its own thread, with a share of the proposals proportional to its active voxels. Since the
+* chains do not share any data, no locking is needed and the result only depends on the random seed. Afterwards the
+* chains are merged into one particle grid and the last temperature steps (SerialFraction) are sampled on the whole
+* volume, which connects the fibers across the slab boundaries.   */
 
 template< class ItkQBallImageType >
 class GibbsTrackingFilter : public ProcessObject
@@ -73,6 +84,8 @@ public:
     itkSetMacro( LoadParameterFile, std::string )   ///< Parameter file.
     itkSetMacro( SaveParameterFile, std::string )
     itkSetMacro( LutPath, std::string )             ///< Path to lookuptables. Default is binary directory.
+    itkSetMacro( NumberOfChains, unsigned int )     ///< Number of spatial chains sampled in parallel. Default is 1 (single chain).
+    itkSetMacro( SerialFraction, float )            ///< Fraction of the temperature steps sampled on the whole volume after merging the parallel chains.
 
     /** Getter. */
     itkGetMacro( ParticleWeight, float )
@@ -85,6 +98,9 @@ public:
     itkGetMacro( ProposalAcceptance, float )
     itkGetMacro( Steps, unsigned int)
     itkGetMacro( IsInValidState, bool)
+    itkGetMacro( NumberOfChains, unsigned int )
+    itkGetMacro( SerialFraction, float )
+    itkGetMacro( Energy, float )                    ///< Energy of the final particle configuration
     FiberPolyDataType GetFiberBundle();             ///< Output fibers
 
     /** Input images. */
@@ -107,6 +123,35 @@ protected:
     bool LoadParameters();
     bool SaveParameters();
 
+    /** Sampler of one slab of the mask. */
+    struct GibbsChain
+    {
+        mitk::ParticleGrid*                 m_ParticleGrid;
+        SphereInterpolator*                 m_Interpolator;
+        GibbsEnergyComputer*                m_EnergyComputer;
+        mitk::MetropolisHastingsSampler*    m_Sampler;
+        Statistics::MersenneTwisterRandomVariateGenerator::Pointer m_RandGen;
+        unsigned long                       m_ProposalsPerStep;
+    };
+
+    /** Data shared by the threads sampling the chains. */
+    struct ParallelChainsData
+    {
+        GibbsTrackingFilter*        m_Filter;
+        std::vector< GibbsChain >*  m_Chains;
+        unsigned int                m_FirstStep;
+        unsigned int                m_LastStep;
+    };
+
+    /** Splits the mask into slabs with the same number of active voxels. */
+    void PartitionMask(unsigned int numberOfChains, std::vector< ItkFloatImageType::RegionType >& regions, std::vector< unsigned long >& activeVoxels);
+    /** Samples the temperature steps 1 to parallelSteps with independent chains and merges them into particleGrid. */
+    bool RunParallelChains(mitk::ParticleGrid* particleGrid, SphereInterpolator* interpolator, Statistics::MersenneTwisterRandomVariateGenerator* randGen,
+                           unsigned long singleIts, unsigned int parallelSteps, unsigned long& numProposals, unsigned long& numAcceptedProposals);
+    void MergeChains(std::vector< GibbsChain >& chains, mitk::ParticleGrid* particleGrid);
+    static ITK_THREAD_RETURN_TYPE SampleChainsCallback(void* arg);
+    void SampleChain(GibbsChain& chain, unsigned int firstStep, unsigned int lastStep);
+
     // Input Images
     typename ItkQBallImageType::Pointer m_QBallImage;
     typename ItkFloatImageType::Pointer m_MaskImage;
@@ -138,6 +183,9 @@ protected:
     std::string     m_SaveParameterFile;    ///< filename of parameter file (writer)
     std::string     m_LutPath;              ///< path to lookuptables used by the sphere interpolator
     bool            m_IsInValidState;       ///< Whether the filter is in a valid state, false if error occured
+    unsigned int    m_NumberOfChains;       ///< number of spatial chains sampled in parallel
+    float           m_SerialFraction;       ///< fraction of the temperature steps sampled on the merged chains
+    float           m_Energy;               ///< energy of the final particle configuration
 
     FiberPolyDataType m_FiberPolyData;      ///< container for reconstructed fibers
 
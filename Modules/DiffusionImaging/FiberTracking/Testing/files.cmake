@@ -1,6 +1,7 @@
 SET(MODULE_CUSTOM_TESTS
   mitkFiberBundleReaderWriterTest.cpp
   mitkGibbsTrackingTest.cpp
+  mitkGibbsTrackingBenchmarkTest.cpp
   mitkStreamlineTrackingTest.cpp
   mitkPeakExtractionTest.cpp
   mitkLocalFiberPlausibilityTest.cpp
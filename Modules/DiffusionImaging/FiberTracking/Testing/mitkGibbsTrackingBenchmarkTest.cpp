@@ -0,0 +1,109 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkTestingMacros.h>
+#include <mitkImageCast.h>
+#include <mitkQBallImage.h>
+#include <itkGibbsTrackingFilter.h>
+#include <mitkFiberBundle.h>
+#include <mitkIOUtil.h>
+#include <itkTimeProbe.h>
+
+using namespace mitk;
+
+typedef itk::Vector<float, QBALL_ODFSIZE> OdfVectorType;
+typedef itk::Image<OdfVectorType,3> OdfVectorImgType;
+typedef itk::Image<float,3> MaskImgType;
+typedef itk::GibbsTrackingFilter<OdfVectorImgType> GibbsTrackingFilterType;
+
+static GibbsTrackingFilterType::Pointer RunGibbsTracking(OdfVectorImgType* qbi, MaskImgType* mask, unsigned long iterations, unsigned int chains, float particleWeight, double& seconds)
+{
+  GibbsTrackingFilterType::Pointer gibbsTracker = GibbsTrackingFilterType::New();
+  gibbsTracker->SetQBallImage(qbi);
+  gibbsTracker->SetMaskImage(mask);
+  gibbsTracker->SetDuplicateImage(true);
+  gibbsTracker->SetRandomSeed(1);
+  gibbsTracker->SetIterations(iterations);
+  gibbsTracker->SetParticleWeight(particleWeight);
+  gibbsTracker->SetNumberOfChains(chains);
+
+  itk::TimeProbe clock;
+  clock.Start();
+  gibbsTracker->Update();
+  clock.Stop();
+  seconds = clock.GetTotal();
+  return gibbsTracker;
+}
+
+/**Documentation
+ *  Compares energy versus wall time of the single chain and the parallel Gibbs tracking.
+ *  Not run by ctest, start it from the test driver with a q-ball image and a mask:
+ *  MitkFiberTrackingTestDriver mitkGibbsTrackingBenchmarkTest qBallImage.qbi diffusionImageMask.nrrd
+ */
+int mitkGibbsTrackingBenchmarkTest(int argc, char* argv[])
+{
+  MITK_TEST_BEGIN("mitkGibbsTrackingBenchmarkTest");
+
+  MITK_TEST_CONDITION_REQUIRED(argc>2,"check for input data")
+
+  try{
+    QBallImage::Pointer mitkQballImage = dynamic_cast<mitk::QBallImage*>(mitk::IOUtil::Load(argv[1]).at(0).GetPointer());
+    MITK_TEST_CONDITION_REQUIRED(mitkQballImage.IsNotNull(),"check qball image")
+    Image::Pointer mitkMaskImage = dynamic_cast<mitk::Image*>(mitk::IOUtil::Load(argv[2]).at(0).GetPointer());
+    MITK_TEST_CONDITION_REQUIRED(mitkMaskImage.IsNotNull(),"check mask image")
+
+    OdfVectorImgType::Pointer itk_qbi = OdfVectorImgType::New();
+    mitk::CastToItkImage(mitkQballImage, itk_qbi);
+    MaskImgType::Pointer itk_mask = MaskImgType::New();
+    mitk::CastToItkImage(mitkMaskImage, itk_mask);
+
+    // the particle weight is estimated once and shared by all runs
+    double seconds = 0;
+    GibbsTrackingFilterType::Pointer tracker = RunGibbsTracking(itk_qbi, itk_mask, 100000, 1, 0, seconds);
+    float particleWeight = tracker->GetParticleWeight();
+    MITK_TEST_CONDITION_REQUIRED(particleWeight>0, "check particle weight estimation")
+
+    const unsigned int chains = 4;
+    const unsigned long iterations[] = { 200000, 400000, 800000 };
+    for (unsigned int i=0; i<3; i++)
+    {
+      double singleSeconds = 0;
+      GibbsTrackingFilterType::Pointer single = RunGibbsTracking(itk_qbi, itk_mask, iterations[i], 1, particleWeight, singleSeconds);
+      double parallelSeconds = 0;
+      GibbsTrackingFilterType::Pointer parallel = RunGibbsTracking(itk_qbi, itk_mask, iterations[i], chains, particleWeight, parallelSeconds);
+
+      MITK_INFO << iterations[i] << " iterations: single chain energy " << single->GetEnergy() << " after " << singleSeconds << "s, "
+                << chains << " chains energy " << parallel->GetEnergy() << " after " << parallelSeconds << "s";
+
+      MITK_TEST_CONDITION(single->GetIsInValidState() && parallel->GetIsInValidState(), "check if tracking succeeded")
+      MITK_TEST_CONDITION(parallel->GetNumParticles()>0, "check if parallel chains produced particles")
+    }
+
+    // the parallel result only depends on the seed, not on the thread scheduling
+    GibbsTrackingFilterType::Pointer parallel1 = RunGibbsTracking(itk_qbi, itk_mask, 200000, chains, particleWeight, seconds);
+    mitk::FiberBundle::Pointer fib1 = mitk::FiberBundle::New(parallel1->GetFiberBundle());
+    GibbsTrackingFilterType::Pointer parallel2 = RunGibbsTracking(itk_qbi, itk_mask, 200000, chains, particleWeight, seconds);
+    mitk::FiberBundle::Pointer fib2 = mitk::FiberBundle::New(parallel2->GetFiberBundle());
+    MITK_TEST_CONDITION_REQUIRED(fib1->Equals(fib2), "check if parallel gibbs tracking is reproducible");
+  }
+  catch(...)
+  {
+    return EXIT_FAILURE;
+  }
+
+  // always end with this!
+  MITK_TEST_END();
+}
@@ -40,6 +40,13 @@ namespace itk
   To compute  the costs of the gradient magnitude dynamically
   an iverted map of the histogram of gradient magnitude image is used.
 
+  The local costs only depend on the target pixel of a link. They are
+  computed once for the whole image in Initialize() and cached in a
+  cost image until the image, the cost map or its settings change, so
+  GetCost() reduces to a lookup. Changing the repulsive points or the
+  cost map modifies the cost function, which invalidates the search tree
+  kept by itk::ShortestPathImageFilter.
+
   */
   template <class TInputImageType>
   class ITK_EXPORT ShortestPathCostFunctionLiveWire : public ShortestPathCostFunction<TInputImageType>
@@ -91,7 +98,11 @@ namespace itk
     /** \brief Clear repulsive points in cost function*/
     virtual void ClearRepulsivePoints();
 
-    itkSetMacro (RequestedRegion, RegionType);
+    // The requested region does not change the costs, so setting it does not modify the cost function
+    void SetRequestedRegion(const RegionType& region)
+    {
+      this->m_RequestedRegion = region;
+    }
     itkGetMacro (RequestedRegion, RegionType);
 
     // Set/Get function for sigma parameter
@@ -105,12 +116,18 @@ namespace itk
       this->m_CostMap = costMap;
       this->m_UseCostMap = true;
       this->m_MaxMapCosts = -1;
+      this->m_LocalCostImageValid = false;
       this->Modified();
     }
 
     void SetUseCostMap(bool useCostMap)
     {
-      this->m_UseCostMap = useCostMap;
+      if (this->m_UseCostMap != useCostMap)
+      {
+        this->m_UseCostMap = useCostMap;
+        this->m_LocalCostImageValid = false;
+        this->Modified();
+      }
     }
 
     /**
@@ -118,7 +135,12 @@ namespace itk
     */
     void SetCostMapMaximum(double max)
     {
-      this->m_MaxMapCosts = max;
+      if (this->m_MaxMapCosts != max)
+      {
+        this->m_MaxMapCosts = max;
+        this->m_LocalCostImageValid = false;
+        this->Modified();
+      }
     }
 
 
@@ -149,6 +171,9 @@ namespace itk
     const VectorOutputImageType* GetGradientImage()
         { return this->m_GradientImage.GetPointer(); };
 
+    const FloatImageType* GetLocalCostImage()
+        { return this->m_LocalCostImage.GetPointer(); };
+
   protected:
 
     ShortestPathCostFunctionLiveWire();
@@ -160,6 +185,7 @@ namespace itk
     FloatImageType::Pointer m_EdgeImage;
     UnsignedCharImageType::Pointer m_MaskImage;
     VectorOutputImageType::Pointer m_GradientImage;
+    FloatImageType::Pointer m_LocalCostImage;
 
     double minCosts;
 
@@ -184,6 +210,14 @@ namespace itk
 
     double m_MaxMapCosts;
 
+    /** \brief Computes the costs of entering pixel p, without repulsive points and distance scaling*/
+    double ComputeLocalCost(const IndexType& p);
+
+    /** \brief Fills m_LocalCostImage with ComputeLocalCost for every pixel*/
+    void UpdateLocalCostImage();
+
+    bool m_LocalCostImageValid;
+
   private:
 
     double SigmoidFunction(double I, double max, double min, double alpha, double beta);
@@ -28,6 +28,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkGradientImageFilter.h>
 #include <itkGradientMagnitudeImageFilter.h>
 #include <itkLaplacianImageFilter.h>
+#include <itkImageRegionIteratorWithIndex.h>
 
 
 namespace itk
@@ -43,6 +44,7 @@ namespace itk
     m_Initialized = false;
     m_UseCostMap = false;
     m_MaxMapCosts = -1.0;
+    m_LocalCostImageValid = false;
   }
 
   template<class TInputImageType>
@@ -51,6 +53,7 @@ namespace itk
   {
     this->m_MaskImage->SetPixel(index, 255);
     m_UseRepulsivePoints = true;
+    this->Modified();
   }
 
   template<class TInputImageType>
@@ -58,6 +61,7 @@ namespace itk
     ::RemoveRepulsivePoint( const IndexType&  index )
   {
     this->m_MaskImage->SetPixel(index, 0);
+    this->Modified();
   }
 
   template<class TInputImageType>
@@ -88,6 +92,7 @@ namespace itk
   {
     m_UseRepulsivePoints = false;
     this->m_MaskImage->FillBuffer(0);
+    this->Modified();
   }
 
 
@@ -95,13 +100,6 @@ namespace itk
   double ShortestPathCostFunctionLiveWire<TInputImageType>
     ::GetCost(IndexType p1 ,IndexType  p2)
   {
-    // local component costs
-    // weights
-    double w1;
-    double w2;
-    double w3;
-    double costs = 0.0;
-
     // if we are on the mask, return asap
     if (m_UseRepulsivePoints)
     {
@@ -110,6 +108,38 @@ namespace itk
         return 1000;
     }
 
+    double costs = this->m_LocalCostImage->GetPixel(p2);
+
+    //scale by euclidian distance
+    double costScale;
+    if( p1[0] == p2[0] || p1[1] == p2[1])
+    {
+      //horizontal or vertical neighbor
+      costScale = 1.0;
+    }
+    else
+    {
+      //diagonal neighbor
+      costScale = sqrt(2.0);
+    }
+
+    costs *= costScale;
+
+    return costs;
+  }
+
+
+  template<class TInputImageType>
+  double ShortestPathCostFunctionLiveWire<TInputImageType>
+    ::ComputeLocalCost(const IndexType& p2)
+  {
+    // local component costs
+    // weights
+    double w1;
+    double w2;
+    double w3;
+    double costs = 0.0;
+
     double gradientX, gradientY;
     gradientX = gradientY = 0.0;
 
@@ -285,22 +315,28 @@ namespace itk
     }
     costs = w1 * laplacianCost + w2 * gradientCost + w3 * gradientDirectionCost;
 
-    //scale by euclidian distance
-    double costScale;
-    if( p1[0] == p2[0] || p1[1] == p2[1])
-    {
-      //horizontal or vertical neighbor
-      costScale = 1.0;
-    }
-    else
+    return costs;
+  }
+
+
+  template<class TInputImageType>
+  void ShortestPathCostFunctionLiveWire<TInputImageType>
+    ::UpdateLocalCostImage()
+  {
+    this->m_LocalCostImage = FloatImageType::New();
+    this->m_LocalCostImage->SetRegions( this->m_Image->GetLargestPossibleRegion() );
+    this->m_LocalCostImage->SetOrigin( this->m_Image->GetOrigin() );
+    this->m_LocalCostImage->SetSpacing( this->m_Image->GetSpacing() );
+    this->m_LocalCostImage->SetDirection( this->m_Image->GetDirection() );
+    this->m_LocalCostImage->Allocate();
+
+    itk::ImageRegionIteratorWithIndex<FloatImageType> it( this->m_LocalCostImage, this->m_LocalCostImage->GetLargestPossibleRegion() );
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
     {
-      //diagonal neighbor
-      costScale = sqrt(2.0);
+      it.Set( static_cast<float>( this->ComputeLocalCost( it.GetIndex() ) ) );
     }
 
-    costs *= costScale;
-
-    return costs;
+    m_LocalCostImageValid = true;
   }
 
 
@@ -392,6 +428,13 @@ namespace itk
       minCosts = 0.0; // The lower, the more thouroughly! 0 = dijkstra. If estimate costs are lower than actual costs everything is fine. If estimation is higher than actual costs, you might not get the shortest but a different path.
 
       m_Initialized = true;
+      m_LocalCostImageValid = false;
+    }
+
+    // the local costs of all pixels are computed once per image and cost map
+    if (!m_LocalCostImageValid)
+    {
+      this->UpdateLocalCostImage();
     }
 
     // check start/end point value
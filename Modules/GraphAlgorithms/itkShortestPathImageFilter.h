@@ -34,6 +34,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 //void SetCalcAllDistances(bool) // Optional (default=false), Calculate Distances over the whole image. CAREFUL, algorithm time extends a lot. Necessary for GetDistanceImage
 //void SetStoreVectorOrder(bool) // Optional (default=false), Stores in which order the pixels were checked. Necessary for GetVectorOrderImage
 //void AddEndIndex(const IndexType & EndIndex) //Optional. By calling this function you can add several endpoints! The algorithm will look for several shortest Pathes. From Start to all Endpoints.
+//void SetReuseSearchTree(bool) // Optional (default=true), if only the end point changed since the last update, the search continues from the previous search tree instead of starting from scratch
 //
 /// GET FUNCTIONS
 //std::vector< itk::Index<3> > GetVectorPath(); // returns the shortest path as vector
@@ -70,6 +71,7 @@ namespace itk
       typedef typename TInputImageType::PixelType                      InputImagePixelType;
       typedef typename TInputImageType::SizeType                       InputImageSizeType;
       typedef typename TInputImageType::IndexType                      IndexType;
+      typedef typename TInputImageType::OffsetType                     OffsetType;
       typedef typename itk::ImageRegionIteratorWithIndex< InputImageType >          InputImageIteratorType;
 
       typedef TOutputImageType                                    OutputImageType;
@@ -133,6 +135,11 @@ namespace itk
       itkSetMacro (ActivateTimeOut, bool);
       itkGetMacro (ActivateTimeOut, bool);
 
+      // \brief (default=true), keep the search tree of the last update. If start point, input and cost function are unchanged, a new end point
+      // is answered from the already closed nodes or by continuing the search from the stored open list (live wire "on-the-fly" search)
+      itkSetMacro (ReuseSearchTree, bool);
+      itkGetMacro (ReuseSearchTree, bool);
+
       // \brief returns shortest Path as vector
       std::vector< IndexType > GetVectorPath();
 
@@ -183,6 +190,23 @@ namespace itk
 
       bool m_Initialized;
 
+      bool m_ReuseSearchTree;
+
+      // state the current search tree was computed for
+      bool m_SearchTreeValid;
+      NodeNumType m_SearchTreeStartNode;
+      const InputImageType* m_SearchTreeInput;
+      ModifiedTimeType m_SearchTreeInputMTime;
+      ModifiedTimeType m_SearchTreeCostFunctionMTime;
+      bool m_SearchTreeFullNeighbors;
+
+      // open list: indexed d-ary min-heap of node numbers ordered by distAndEst, see ShortestPathNode::heapIndex
+      std::vector< NodeNumType > m_Heap;
+      const static unsigned int HEAP_ARITY = 4;
+
+      // index offsets of the neighbors of a pixel, depending on m_Graph_fullNeighbors
+      std::vector< OffsetType > m_NeighborOffsets;
+
 
       CostFunctionTypePointer m_CostFunction;
       IndexType m_StartIndex, m_EndIndex;
@@ -218,6 +242,20 @@ namespace itk
       // \brief Returns the neighbors of a node
       std::vector<ShortestPathNode*> GetNeighbors(NodeNumType nodeNum, bool FullNeighbors);
 
+      // \brief Fills m_NeighborOffsets for N4/N6 or, with FullNeighbors, for N8/N26
+      void InitNeighborOffsets(bool FullNeighbors);
+
+      // \brief Returns true if the search tree of the last update is valid for the current start point, input and cost function
+      bool CanReuseSearchTree();
+
+      // \brief Open list operations
+      void HeapPush(NodeNumType nodeNum);
+      NodeNumType HeapPop();
+      void HeapSiftUp(NodeNumType heapPos);
+      void HeapSiftDown(NodeNumType heapPos);
+      // \brief Recomputes the estimates of all open nodes for the current end point and restores the heap order
+      void HeapRekey();
+
       // \brief Check if coords are in bounds of image
       bool CoordIsInBounds(IndexType);
 
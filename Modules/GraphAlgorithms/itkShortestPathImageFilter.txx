@@ -41,7 +41,14 @@ namespace itk
     m_CalcAllDistances(false),
     multipleEndPoints(false),
     m_ActivateTimeOut(false),
-    m_Initialized(false)
+    m_Initialized(false),
+    m_ReuseSearchTree(true),
+    m_SearchTreeValid(false),
+    m_SearchTreeStartNode(0),
+    m_SearchTreeInput(nullptr),
+    m_SearchTreeInputMTime(0),
+    m_SearchTreeCostFunctionMTime(0),
+    m_SearchTreeFullNeighbors(false)
   {
     m_endPoints.clear();
     m_endPointsClosed.clear();
@@ -407,7 +414,7 @@ namespace itk
     m_Graph_StartNode = CoordToNode(m_StartIndex);
     //MITK_INFO << "StartIndex = " << StartIndex;
     //MITK_INFO << "StartNode = " << m_Graph_StartNode;
-    m_Initialized = false;
+    this->Modified();
   }
 
 
@@ -421,6 +428,7 @@ namespace itk
     }
     m_Graph_EndNode = CoordToNode(m_EndIndex);
     //MITK_INFO << "EndNode = " << m_Graph_EndNode;
+    this->Modified();
   }
 
   template <class TInputImageType, class TOutputImageType>
@@ -443,10 +451,11 @@ namespace itk
     getEstimatedCostsToTarget (const typename TInputImageType::IndexType &a)
   {
     // Returns the minimal possible costs for a path from "a" to targetnode.
-    itk::Vector<float,3> v;
-    v[0] = m_EndIndex[0]-a[0];
-    v[1] = m_EndIndex[1]-a[1];
-    v[2] = m_EndIndex[2]-a[2];
+    itk::Vector<float,TInputImageType::ImageDimension> v;
+    for (unsigned int i=0;i<TInputImageType::ImageDimension;++i)
+    {
+      v[i] = m_EndIndex[i]-a[i];
+    }
 
     return  m_CostFunction->GetMinCost() * v.GetNorm();
   }
@@ -455,42 +464,230 @@ namespace itk
   template <class TInputImageType, class TOutputImageType>
   void
     ShortestPathImageFilter<TInputImageType, TOutputImageType>::
-    InitGraph()
+    InitNeighborOffsets(bool FullNeighbors)
   {
-    if(!m_Initialized)
+    m_NeighborOffsets.clear();
+
+    // enumerate all offsets in {-1,0,1}^dim. Without FullNeighbors only the
+    // face neighbors (exactly one non-zero component) are used.
+    const unsigned int dim = TInputImageType::ImageDimension;
+    unsigned int numberOfOffsets = 1;
+    for (unsigned int i=0; i<dim; ++i)
+      numberOfOffsets *= 3;
+
+    for (unsigned int n=0; n<numberOfOffsets; ++n)
     {
-      // Clean up previous stuff
-      CleanUp();
+      OffsetType offset;
+      unsigned int code = n;
+      unsigned int nonZero = 0;
+      for (unsigned int i=0; i<dim; ++i)
+      {
+        offset[i] = static_cast<int>(code % 3) - 1;
+        code /= 3;
+        if (offset[i] != 0)
+          ++nonZero;
+      }
 
-      // Calc Number of nodes
-      m_ImageDimensions = TInputImageType::ImageDimension;
-      const InputImageSizeType &size = this->GetInput()->GetRequestedRegion().GetSize();
-      m_Graph_NumberOfNodes = 1;
-      for (NodeNumType i=0; i<m_ImageDimensions; ++i)
-        m_Graph_NumberOfNodes=m_Graph_NumberOfNodes*size[i];
+      if (nonZero == 0 || (nonZero > 1 && !FullNeighbors))
+        continue;
 
-      // Initialize mainNodeList with that number
-      m_Nodes = new ShortestPathNode[m_Graph_NumberOfNodes];
+      m_NeighborOffsets.push_back(offset);
+    }
+  }
+
+  template <class TInputImageType, class TOutputImageType>
+  bool
+    ShortestPathImageFilter<TInputImageType, TOutputImageType>::
+    CanReuseSearchTree()
+  {
+    // The closed nodes of a search keep their optimal distance to the start node
+    // for any end point, so only a changed end point does not invalidate them.
+    return m_ReuseSearchTree
+      && m_SearchTreeValid
+      && m_Nodes != nullptr
+      && !multipleEndPoints
+      && !m_StoreVectorOrder
+      && m_SearchTreeStartNode == m_Graph_StartNode
+      && m_SearchTreeInput == this->GetInput()
+      && m_SearchTreeInputMTime == this->GetInput()->GetMTime()
+      && m_SearchTreeCostFunctionMTime == m_CostFunction->GetMTime()
+      && m_SearchTreeFullNeighbors == m_Graph_fullNeighbors;
+  }
+
+  template <class TInputImageType, class TOutputImageType>
+  inline void
+    ShortestPathImageFilter<TInputImageType, TOutputImageType>::
+    HeapPush(NodeNumType nodeNum)
+  {
+    m_Nodes[nodeNum].heapIndex = m_Heap.size();
+    m_Heap.push_back(nodeNum);
+    HeapSiftUp(m_Nodes[nodeNum].heapIndex);
+  }
+
+  template <class TInputImageType, class TOutputImageType>
+  inline NodeNumType
+    ShortestPathImageFilter<TInputImageType, TOutputImageType>::
+    HeapPop()
+  {
+    const NodeNumType top = m_Heap.front();
+    const NodeNumType last = m_Heap.back();
+    m_Heap.pop_back();
+    if (!m_Heap.empty())
+    {
+      m_Heap[0] = last;
+      m_Nodes[last].heapIndex = 0;
+      HeapSiftDown(0);
+    }
+    return top;
+  }
+
+  template <class TInputImageType, class TOutputImageType>
+  inline void
+    ShortestPathImageFilter<TInputImageType, TOutputImageType>::
+    HeapSiftUp(NodeNumType heapPos)
+  {
+    const NodeNumType nodeNum = m_Heap[heapPos];
+    const DistanceType key = m_Nodes[nodeNum].distAndEst;
+
+    while (heapPos > 0)
+    {
+      const NodeNumType parentPos = (heapPos - 1) / HEAP_ARITY;
+      if (m_Nodes[m_Heap[parentPos]].distAndEst <= key)
+        break;
+
+      m_Heap[heapPos] = m_Heap[parentPos];
+      m_Nodes[m_Heap[heapPos]].heapIndex = heapPos;
+      heapPos = parentPos;
+    }
+
+    m_Heap[heapPos] = nodeNum;
+    m_Nodes[nodeNum].heapIndex = heapPos;
+  }
+
+  template <class TInputImageType, class TOutputImageType>
+  inline void
+    ShortestPathImageFilter<TInputImageType, TOutputImageType>::
+    HeapSiftDown(NodeNumType heapPos)
+  {
+    const NodeNumType nodeNum = m_Heap[heapPos];
+    const DistanceType key = m_Nodes[nodeNum].distAndEst;
+    const NodeNumType heapSize = m_Heap.size();
 
-      // Initialize each node in nodelist
-      for (NodeNumType i=0; i<m_Graph_NumberOfNodes; i++)
+    while (true)
+    {
+      const NodeNumType firstChild = heapPos * HEAP_ARITY + 1;
+      if (firstChild >= heapSize)
+        break;
+
+      // pick the child with the lowest score
+      const NodeNumType endChild = std::min<NodeNumType>(firstChild + HEAP_ARITY, heapSize);
+      NodeNumType bestChild = firstChild;
+      for (NodeNumType child = firstChild + 1; child < endChild; ++child)
       {
-        m_Nodes[i].distAndEst = -1;
-        m_Nodes[i].distance = -1;
-        m_Nodes[i].prevNode = -1;
-        m_Nodes[i].mainListIndex=i;
-        m_Nodes[i].closed=false;
+        if (m_Nodes[m_Heap[child]].distAndEst < m_Nodes[m_Heap[bestChild]].distAndEst)
+          bestChild = child;
       }
 
-      m_Initialized = true;
+      if (m_Nodes[m_Heap[bestChild]].distAndEst >= key)
+        break;
+
+      m_Heap[heapPos] = m_Heap[bestChild];
+      m_Nodes[m_Heap[heapPos]].heapIndex = heapPos;
+      heapPos = bestChild;
     }
 
-    // In the beginning, the Startnode needs a distance of 0
-    m_Nodes[m_Graph_StartNode].distance = 0;
-    m_Nodes[m_Graph_StartNode].distAndEst = 0;
+    m_Heap[heapPos] = nodeNum;
+    m_Nodes[nodeNum].heapIndex = heapPos;
+  }
+
+  template <class TInputImageType, class TOutputImageType>
+  void
+    ShortestPathImageFilter<TInputImageType, TOutputImageType>::
+    HeapRekey()
+  {
+    // pure dijkstra, the scores do not depend on the end point
+    if (m_CostFunction->GetMinCost() == 0)
+      return;
+
+    for (NodeNumType i=0; i<m_Heap.size(); ++i)
+    {
+      ShortestPathNode &node = m_Nodes[m_Heap[i]];
+      node.distAndEst = node.distance + getEstimatedCostsToTarget(NodeToCoord(m_Heap[i]));
+    }
+
+    // bottom-up heap construction
+    if (m_Heap.size() > 1)
+    {
+      for (NodeNumType i = (m_Heap.size() - 2) / HEAP_ARITY + 1; i-- > 0; )
+        HeapSiftDown(i);
+    }
+  }
+
+  template <class TInputImageType, class TOutputImageType>
+  void
+    ShortestPathImageFilter<TInputImageType, TOutputImageType>::
+    InitGraph()
+  {
+    // Calc Number of nodes
+    m_ImageDimensions = TInputImageType::ImageDimension;
+    const InputImageSizeType &size = this->GetInput()->GetRequestedRegion().GetSize();
+    NodeNumType numberOfNodes = 1;
+    for (NodeNumType i=0; i<m_ImageDimensions; ++i)
+      numberOfNodes = numberOfNodes*size[i];
 
     // initalize cost function
     m_CostFunction->Initialize();
+
+    if (numberOfNodes == m_Graph_NumberOfNodes && CanReuseSearchTree())
+    {
+      // only the end point moved, continue with the previous search tree
+      HeapRekey();
+      return;
+    }
+
+    if (m_Nodes == nullptr || numberOfNodes != m_Graph_NumberOfNodes)
+    {
+      // Clean up previous stuff
+      CleanUp();
+
+      // Initialize mainNodeList with that number
+      m_Graph_NumberOfNodes = numberOfNodes;
+      m_Nodes = new ShortestPathNode[m_Graph_NumberOfNodes];
+    }
+    else
+    {
+      // same size, the node list is reset in place
+      m_VectorOrder.clear();
+      m_VectorPath.clear();
+    }
+
+    // Initialize each node in nodelist
+    for (NodeNumType i=0; i<m_Graph_NumberOfNodes; i++)
+    {
+      m_Nodes[i].distAndEst = -1;
+      m_Nodes[i].distance = -1;
+      m_Nodes[i].prevNode = -1;
+      m_Nodes[i].mainListIndex=i;
+      m_Nodes[i].heapIndex=0;
+      m_Nodes[i].closed=false;
+    }
+    m_Initialized = true;
+
+    // In the beginning, the Startnode needs a distance of 0 and is the only discovered node
+    m_Nodes[m_Graph_StartNode].distance = 0;
+    m_Nodes[m_Graph_StartNode].distAndEst = 0;
+    m_Heap.clear();
+    HeapPush(m_Graph_StartNode);
+
+    InitNeighborOffsets(m_Graph_fullNeighbors);
+
+    // remember what this search tree is valid for
+    m_SearchTreeStartNode = m_Graph_StartNode;
+    m_SearchTreeInput = this->GetInput();
+    m_SearchTreeInputMTime = this->GetInput()->GetMTime();
+    m_SearchTreeCostFunctionMTime = m_CostFunction->GetMTime();
+    m_SearchTreeFullNeighbors = m_Graph_fullNeighbors;
+    m_SearchTreeValid = !multipleEndPoints;
   }
 
   template <class TInputImageType, class TOutputImageType>
@@ -509,40 +706,22 @@ namespace itk
     DistanceType curNodeDistance = 0;
     NodeNumType numberOfNodesChecked = 0;
 
-    // Create Multimap (tree structure for fast searching)
-    std::multimap<double,ShortestPathNode*> myMap;
-    std::pair< std::multimap<double,ShortestPathNode*>::iterator, std::multimap<double,ShortestPathNode*>::iterator> ret;
-    std::multimap<double,ShortestPathNode*>::iterator it;
-
-    // At first, only startNote is discovered.
-    myMap.insert( std::pair<double,ShortestPathNode*> (m_Nodes[m_Graph_StartNode].distAndEst, &m_Nodes[m_Graph_StartNode]) );
+    // a reused search tree might already contain the path to the end point
+    if (!multipleEndPoints && !m_CalcAllDistances && m_Nodes[m_Graph_EndNode].closed)
+    {
+      return;
+    }
 
     // While there are discovered Nodes, pick the one with lowest distance,
     // update its neighbors and eventually delete it from the discovered Nodes list.
-    while(!myMap.empty())
+    while(!m_Heap.empty())
     {
       numberOfNodesChecked++;
-      /*if ( (numberOfNodesChecked % (m_Graph_NumberOfNodes/100)) == 0)
-      {
-        MITK_INFO << "Checked " << ( numberOfNodesChecked / (m_Graph_NumberOfNodes/100) ) << "% List: " << myMap.size() << "\n";
-      }*/
-
-      // Get element with lowest score
-      mainNodeListIndex = myMap.begin()->second->mainListIndex;
-      curNodeDistance = myMap.begin()->second->distance;
-      myMap.begin()->second->closed = true; // close it
-
-      // Debug:
-      //MITK_INFO << "INFO: size " << myMap.size();
-      /*
-      for (it = myMap.begin(); it != myMap.end(); ++it)
-      {
-      MITK_INFO << "(1) " << it->first << "|" << it->second->distAndEst << "|"<<it->second->mainListIndex;
-      }
-      */
 
-      // Kicks out element with lowest score
-      myMap.erase( myMap.begin() );
+      // Kicks out element with lowest score and closes it
+      mainNodeListIndex = HeapPop();
+      curNodeDistance = m_Nodes[mainNodeListIndex].distance;
+      m_Nodes[mainNodeListIndex].closed = true;
 
       // if wanted, store vector order
       if (m_StoreVectorOrder)
@@ -551,138 +730,36 @@ namespace itk
       }
 
       // Check neighbors
-      std::vector<ShortestPathNode*> neighborNodes = GetNeighbors(mainNodeListIndex, m_Graph_fullNeighbors);
-      for (NodeNumType i=0; i<neighborNodes.size(); i++)
+      const IndexType coordCurNode = NodeToCoord(mainNodeListIndex);
+      for (unsigned int i=0; i<m_NeighborOffsets.size(); i++)
       {
-        if (neighborNodes[i]->closed)
-          continue; // this nodes is already closed, go to next neighbor
+        const IndexType coordNeighborNode = coordCurNode + m_NeighborOffsets[i];
+        if (!CoordIsInBounds(coordNeighborNode))
+          continue;
 
-        IndexType coordCurNode = NodeToCoord(mainNodeListIndex);
-        IndexType coordNeighborNode = NodeToCoord(neighborNodes[i]->mainListIndex);
+        ShortestPathNode* neighborNode = &m_Nodes[CoordToNode(coordNeighborNode)];
+        if (neighborNode->closed)
+          continue; // this nodes is already closed, go to next neighbor
 
         // calculate the new Distance to the current neighbor
         double newDistance = curNodeDistance
           + (m_CostFunction->GetCost(coordCurNode, coordNeighborNode));
 
+        // if that neighbornode is not discovered yet, push it to the open list
+        if (neighborNode->distance == -1)
+        {
+          neighborNode->distance = newDistance;
+          neighborNode->distAndEst = newDistance + getEstimatedCostsToTarget(coordNeighborNode);
+          neighborNode->prevNode = mainNodeListIndex;
+          HeapPush(neighborNode->mainListIndex);
+        }
         // if it is shorter than any yet known path to this neighbor, than the current path is better. Save that!
-        if ((newDistance < neighborNodes[i]->distance) || (neighborNodes[i]->distance == -1) )
+        else if (newDistance < neighborNode->distance)
         {
-          // if that neighbornode is not in discoverednodeList yet, Push it there and update
-          if (neighborNodes[i]->distance == -1)
-          {
-
-            neighborNodes[i]->distance = newDistance;
-            neighborNodes[i]->distAndEst = newDistance + getEstimatedCostsToTarget(coordNeighborNode);
-            neighborNodes[i]->prevNode = mainNodeListIndex;
-            myMap.insert( std::pair<double,ShortestPathNode*> (m_Nodes[neighborNodes[i]->mainListIndex].distAndEst, &m_Nodes[neighborNodes[i]->mainListIndex]) );
-            /*
-            MITK_INFO << "Inserted: " << m_Nodes[neighborNodes[i]->mainListIndex].distAndEst << "|" << m_Nodes[neighborNodes[i]->mainListIndex].mainListIndex;
-            MITK_INFO << "INFO: size " << myMap.size();
-            for (it = myMap.begin(); it != myMap.end(); ++it)
-            {
-            MITK_INFO << "(1) " << it->first << "|" << it->second->distAndEst << "|"<<it->second->mainListIndex;
-            }
-            */
-          }
-          // or if is already in discoverednodelist, update
-          else
-          {
-
-            /*
-            it = myMap.find(neighborNodes[i]->distAndEst);
-            if (it == myMap.end() )
-            {
-            MITK_INFO << "Nothing!";
-            // look further
-            for (it = myMap.begin(); it != myMap.end(); ++it)
-            {
-            if ((*it).second->mainListIndex == lookForId)
-            {
-            MITK_INFO << "But it is there!!!";
-            MITK_INFO << "Searched for: " << lookFor << "   but had: " << (*it).second->distAndEst;
-            }
-
-            }
-            }
-            */
-
-            // 1st : find and delete old element
-            bool found = false;
-            ret = myMap.equal_range(neighborNodes[i]->distAndEst);
-
-            if ((ret.first == ret.second))
-            {
-              /*+++++++++++++ no exact match +++++++++++++*/
-              //MITK_INFO << "No exact match!"; // if this happens, you are screwed
-              /*
-              MITK_INFO << "Was looking for: " << lookFor << "  ID: " << lookForId;
-              if (ret.first != myMap.end() )
-              {
-              it = ret.first;
-              MITK_INFO << "Found: " << it->first << "  ID: " << it->second->mainListIndex;
-              ++it;
-              MITK_INFO << "Found: " << it->first << "  ID: " << it->second->mainListIndex;
-              --it;
-              --it;
-              MITK_INFO << "Found: " << it->first << "  ID: " << it->second->mainListIndex;
-              }
-
-              // look if that ID is found in the map
-              for (it = myMap.begin(); it != myMap.end(); ++it)
-              {
-              if ((*it).second->mainListIndex == lookForId)
-              {
-              MITK_INFO << "But it is there!!!";
-              MITK_INFO << "Searched dist: " << lookFor << "  found dist: " << (*it).second->distAndEst;
-              }
-
-              }
-              */
-            }
-            else
-            {
-              for (it=ret.first; it!=ret.second; ++it)
-              {
-                if (it->second->mainListIndex == neighborNodes[i]->mainListIndex)
-                {
-                  found = true;
-                  myMap.erase(it);
-                  /*
-                  MITK_INFO << "INFO: size " << myMap.size();
-                  MITK_INFO << "Erase: " << it->first << "|" << it->second->mainListIndex;
-
-                  MITK_INFO << "INFO: size " << myMap.size();
-                  for (it = myMap.begin(); it != myMap.end(); ++it)
-                  {
-                  MITK_INFO << "(1) " << it->first << "|" << it->second->distAndEst << "|"<<it->second->mainListIndex;
-                  }
-                  */
-                  break;
-                }
-              }
-            }
-
-            if (!found)
-            {
-              //MITK_INFO << "Could not find it! :(";
-              continue;
-            }
-
-            // 2nd: update and insert new element
-            neighborNodes[i]->distance = newDistance;
-            neighborNodes[i]->distAndEst = newDistance + getEstimatedCostsToTarget(coordNeighborNode);
-            neighborNodes[i]->prevNode = mainNodeListIndex;
-            //myMap.insert( std::pair<double,ShortestPathNode*> (neighborNodes[i]->distAndEst, neighborNodes[i]));
-            myMap.insert( std::pair<double,ShortestPathNode*> (m_Nodes[neighborNodes[i]->mainListIndex].distAndEst, &m_Nodes[neighborNodes[i]->mainListIndex]) );
-
-            //MITK_INFO << "Re-Inserted: " << m_Nodes[neighborNodes[i]->mainListIndex].distAndEst << "|" << m_Nodes[neighborNodes[i]->mainListIndex].mainListIndex;
-            //MITK_INFO << "INFO: size " << myMap.size();
-            /*for (it = myMap.begin(); it != myMap.end(); ++it)
-            {
-            MITK_INFO << "(1) " << it->first << "|" << it->second->distAndEst << "|"<<it->second->mainListIndex;
-            }*/
-
-          }
+          neighborNode->distance = newDistance;
+          neighborNode->distAndEst = newDistance + getEstimatedCostsToTarget(coordNeighborNode);
+          neighborNode->prevNode = mainNodeListIndex;
+          HeapSiftUp(neighborNode->heapIndex);
         }
       }
       // finished with checking all neighbors.
@@ -718,7 +795,9 @@ namespace itk
             if (m_Graph_EndNode == mainNodeListIndex)
             {
               // set new end
-              SetEndIndex( m_endPoints[0] );
+              m_EndIndex = m_endPoints[0];
+              m_Graph_EndNode = CoordToNode(m_EndIndex);
+              HeapRekey();
             }
           }
         }
@@ -904,6 +983,9 @@ namespace itk
 
     if (m_Nodes)
       delete [] m_Nodes;
+    m_Nodes = nullptr;
+    m_Heap.clear();
+    m_SearchTreeValid = false;
   }
 
 
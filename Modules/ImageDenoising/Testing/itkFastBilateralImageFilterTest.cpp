@@ -0,0 +1,110 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "itkFastBilateralImageFilter.h"
+#include "itkBilateralImageFilter.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTimeProbe.h"
+
+typedef itk::Image<float, 3>
+ImageType;
+
+/**
+* step edge along x with a small periodic texture on both sides
+*/
+ImageType::Pointer GenerateStepImage()
+{
+  ImageType::Pointer image = ImageType::New();
+
+  ImageType::RegionType region;
+  ImageType::SizeType size = {{48,48,12}};
+  region.SetSize( size );
+  image->SetRegions( region );
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, region);
+  for(it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    ImageType::IndexType index = it.GetIndex();
+    float value = index[0] < 24 ? 0.0f : 100.0f;
+    value += ((index[0] + index[1] + index[2]) % 2) ? 1.0f : -1.0f;
+    it.Set(value);
+  }
+
+  return image;
+}
+
+int itkFastBilateralImageFilterTest(int /*argc*/, char* /*argv*/[])
+{
+  ImageType::Pointer image = GenerateStepImage();
+
+  try
+  {
+    typedef itk::BilateralImageFilter<ImageType,ImageType> ExactFilterType;
+    ExactFilterType::Pointer exactFilter = ExactFilterType::New();
+    exactFilter->SetInput(image);
+    exactFilter->SetDomainSigma(2.0);
+    exactFilter->SetRangeSigma(10.0);
+
+    itk::TimeProbe exactTime;
+    exactTime.Start();
+    exactFilter->Update();
+    exactTime.Stop();
+
+    typedef itk::FastBilateralImageFilter<ImageType,ImageType> FastFilterType;
+    FastFilterType::Pointer fastFilter = FastFilterType::New();
+    fastFilter->SetInput(image);
+    fastFilter->SetDomainSigma(2.0);
+    fastFilter->SetRangeSigma(10.0);
+
+    itk::TimeProbe fastTime;
+    fastTime.Start();
+    fastFilter->Update();
+    fastTime.Stop();
+
+    std::cout << "itk::BilateralImageFilter: " << exactTime.GetTotal() << " s, "
+              << "itk::FastBilateralImageFilter: " << fastTime.GetTotal() << " s" << std::endl;
+
+    itk::ImageRegionIterator<ImageType> exactIt(exactFilter->GetOutput(), image->GetLargestPossibleRegion());
+    itk::ImageRegionIteratorWithIndex<ImageType> fastIt(fastFilter->GetOutput(), image->GetLargestPossibleRegion());
+    double meanDifference = 0.0;
+    for(exactIt.GoToBegin(), fastIt.GoToBegin(); !fastIt.IsAtEnd(); ++exactIt, ++fastIt)
+    {
+      // the edge must survive: no pixel may be pulled towards the other side
+      const float expected = fastIt.GetIndex()[0] < 24 ? 0.0f : 100.0f;
+      if(fabs(fastIt.Get() - expected) > 5.0)
+      {
+        std::cout << "Edge not preserved at " << fastIt.GetIndex() << ": " << fastIt.Get() << std::endl;
+        return EXIT_FAILURE;
+      }
+      meanDifference += fabs(fastIt.Get() - exactIt.Get());
+    }
+    meanDifference /= image->GetLargestPossibleRegion().GetNumberOfPixels();
+
+    std::cout << "Mean absolute difference to exact filter: " << meanDifference << std::endl;
+    if(meanDifference > 1.0)
+    {
+      return EXIT_FAILURE;
+    }
+  }
+  catch (...)
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
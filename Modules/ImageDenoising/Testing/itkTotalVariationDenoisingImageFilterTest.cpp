@@ -18,6 +18,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "itkTotalVariationSingleIterationImageFilter.h"
 #include "itkLocalVariationImageFilter.h"
 #include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkDefaultConvertPixelTraits.h"
 
 // image typedefs
 typedef itk::Image<float, 3>
@@ -131,6 +133,53 @@ void PrintVectorImage(VectorImageType::Pointer image)
   std::cout << std::endl;
 }
 
+/**
+* the denoising as it was implemented before the single iteration filter was
+* reused: a new filter per iteration, each one fed with the previous output
+*/
+template <class TImage>
+typename TImage::Pointer DenoiseWithNewFilterPerIteration(TImage* image, int iterations, double lambda)
+{
+  typedef itk::TotalVariationSingleIterationImageFilter<TImage,TImage>
+    SingleFilterType;
+  typename TImage::Pointer result = image;
+  for(int i=0; i<iterations; i++)
+  {
+    typename SingleFilterType::Pointer filter = SingleFilterType::New();
+    filter->SetInput( result );
+    filter->SetOriginalImage( image );
+    filter->SetLambda(lambda);
+    filter->SetNumberOfThreads(1);
+    filter->UpdateLargestPossibleRegion();
+    result = filter->GetOutput();
+  }
+  return result;
+}
+
+/**
+* compares every pixel (and every vector component) of two images
+*/
+template <class TImage>
+bool ImagesAreEqual(TImage* expected, TImage* result, double precision)
+{
+  typedef itk::ImageRegionConstIterator<TImage> ConstIteratorType;
+  ConstIteratorType expectedIt(expected, expected->GetLargestPossibleRegion());
+  ConstIteratorType resultIt(result, expected->GetLargestPossibleRegion());
+  for(; !expectedIt.IsAtEnd(); ++expectedIt, ++resultIt)
+  {
+    typedef itk::DefaultConvertPixelTraits<typename TImage::PixelType> PixelTraits;
+    for(unsigned int c=0; c<PixelTraits::GetNumberOfComponents(); c++)
+    {
+      if(fabs(PixelTraits::GetNthComponent(c, expectedIt.Get()) -
+        PixelTraits::GetNthComponent(c, resultIt.Get())) > precision)
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 /**
 * todo
 */
@@ -203,7 +252,9 @@ int itkTotalVariationDenoisingImageFilterTest(int /*argc*/, char* /*argv*/[])
     ImageType::Pointer outImageTV = tvFilter->GetOutput();
 
     PrintImage(outImageTV);
-    if(fabs(outImageTV->GetPixel(index) - 4.0) > precision)
+    ImageType::Pointer expectedTV =
+      DenoiseWithNewFilterPerIteration<ImageType>(image, 30, 0.1);
+    if(!ImagesAreEqual<ImageType>(expectedTV, outImageTV, 1e-5))
     {
       return EXIT_FAILURE;
     }
@@ -276,7 +327,9 @@ int itkTotalVariationDenoisingImageFilterTest(int /*argc*/, char* /*argv*/[])
     VectorImageType::Pointer outVecImageTV = tvVecFilter->GetOutput();
 
     PrintVectorImage(outVecImageTV);
-    if(fabs(outVecImageTV->GetPixel(vecIndex)[1] - 4.0) > precision)
+    VectorImageType::Pointer expectedVecTV =
+      DenoiseWithNewFilterPerIteration<VectorImageType>(vecImage, 30, 0.1);
+    if(!ImagesAreEqual<VectorImageType>(expectedVecTV, outVecImageTV, 1e-5))
     {
       return EXIT_FAILURE;
     }
@@ -2,6 +2,8 @@ set(CPP_FILES
   mitkBilateralFilter.cpp
 )
 set(H_FILES
+  itkFastBilateralImageFilter.h
+  itkFastBilateralImageFilter.txx
   itkLocalVariationImageFilter.h
   itkLocalVariationImageFilter.txx
   itkTotalVariationDenoisingImageFilter.h
@@ -0,0 +1,136 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef __itkFastBilateralImageFilter_h
+#define __itkFastBilateralImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkImage.h"
+
+#include <vector>
+
+namespace itk
+{
+/** \class FastBilateralImageFilter
+ * \brief Approximates a bilateral filter on scalar images with a bilateral grid
+ *
+ * The image is splatted into a coarse (N+1)-dimensional grid whose cells are
+ * DomainSigma (in physical units) wide along the image axes and RangeSigma
+ * wide along the intensity axis. The grid is blurred with a separable
+ * binomial kernel and sliced again by (N+1)-linear interpolation. The cost
+ * is therefore independent of the kernel size, which makes the filter
+ * suitable for large volumes and large domain sigmas where
+ * itk::BilateralImageFilter evaluates the full spatial times range kernel
+ * per pixel.
+ *
+ * The result is close to, but not identical with, itk::BilateralImageFilter
+ * using the same sigmas.
+ *
+ * Reference: Chen, Paris and Durand, Real-time edge-aware image processing
+ * with the bilateral grid, SIGGRAPH 2007
+ *
+ * \sa BilateralImageFilter
+ *
+ * \ingroup IntensityImageFilters
+ */
+template <class TInputImage, class TOutputImage>
+class FastBilateralImageFilter :
+    public ImageToImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Extract dimension from input and output image. */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TInputImage::ImageDimension);
+  itkStaticConstMacro(GridDimension, unsigned int,
+                      TInputImage::ImageDimension + 1);
+  /** Empty grid cells on each side of every grid axis, enough that the blur
+   * kernel and the interpolation never leave the grid. */
+  itkStaticConstMacro(GridPadding, unsigned int, 2);
+
+  /** Convenient typedefs for simplifying declarations. */
+  typedef TInputImage InputImageType;
+  typedef TOutputImage OutputImageType;
+
+  /** Standard class typedefs. */
+  typedef FastBilateralImageFilter Self;
+  typedef ImageToImageFilter< InputImageType, OutputImageType> Superclass;
+  typedef SmartPointer<Self> Pointer;
+  typedef SmartPointer<const Self>  ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkFactorylessNewMacro(Self)
+  itkCloneMacro(Self)
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(FastBilateralImageFilter, ImageToImageFilter);
+
+  /** Image typedef support. */
+  typedef typename InputImageType::PixelType InputPixelType;
+  typedef typename OutputImageType::PixelType OutputPixelType;
+  typedef typename OutputImageType::RegionType OutputImageRegionType;
+
+  /** Spatial extent of the filter in physical units. */
+  itkSetMacro(DomainSigma, double);
+  itkGetMacro(DomainSigma, double);
+
+  /** Intensity extent of the filter. */
+  itkSetMacro(RangeSigma, double);
+  itkGetMacro(RangeSigma, double);
+
+  /** The whole input is needed to build the grid. */
+  virtual void GenerateInputRequestedRegion();
+
+protected:
+  FastBilateralImageFilter();
+  virtual ~FastBilateralImageFilter() {}
+  void PrintSelf(std::ostream& os, Indent indent) const;
+
+  /** Splats the input into the grid and blurs it. */
+  void BeforeThreadedGenerateData();
+
+  /** Slices the blurred grid for the pixels of one thread region. */
+  void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                            ThreadIdType threadId );
+
+  /** Releases the grid. */
+  void AfterThreadedGenerateData();
+
+  /** Blurs the grid along one axis with a [1 2 1]/4 kernel, applied twice. */
+  void BlurGridAlongAxis(unsigned int axis);
+
+  double m_DomainSigma;
+  double m_RangeSigma;
+
+  /** interleaved (weighted value, weight) pairs */
+  std::vector<float> m_Grid;
+  std::vector<float> m_GridLine;
+  size_t m_GridSize[TInputImage::ImageDimension + 1];
+  size_t m_GridStride[TInputImage::ImageDimension + 1];
+  double m_SamplingRate[TInputImage::ImageDimension];
+  double m_MinimumValue;
+
+private:
+  FastBilateralImageFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkFastBilateralImageFilter.txx"
+#endif
+
+#endif //__itkFastBilateralImageFilter_h
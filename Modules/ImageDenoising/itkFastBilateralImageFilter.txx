@@ -0,0 +1,254 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef _itkFastBilateralImageFilter_txx
+#define _itkFastBilateralImageFilter_txx
+
+#include "itkFastBilateralImageFilter.h"
+
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkProgressReporter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace itk
+{
+
+  template <class TInputImage, class TOutputImage>
+  FastBilateralImageFilter<TInputImage, TOutputImage>
+    ::FastBilateralImageFilter()
+    : m_DomainSigma(2.0),
+      m_RangeSigma(50.0),
+      m_MinimumValue(0.0)
+  {
+    for (unsigned int d = 0; d < GridDimension; ++d)
+    {
+      m_GridSize[d] = 0;
+      m_GridStride[d] = 0;
+    }
+    for (unsigned int d = 0; d < ImageDimension; ++d)
+    {
+      m_SamplingRate[d] = 1.0;
+    }
+  }
+
+  template <class TInputImage, class TOutputImage>
+  void
+    FastBilateralImageFilter<TInputImage, TOutputImage>
+    ::GenerateInputRequestedRegion()
+  {
+    Superclass::GenerateInputRequestedRegion();
+
+    typename Superclass::InputImagePointer inputPtr =
+      const_cast< TInputImage * >( this->GetInput() );
+    if ( inputPtr )
+    {
+      inputPtr->SetRequestedRegionToLargestPossibleRegion();
+    }
+  }
+
+  template <class TInputImage, class TOutputImage>
+  void
+    FastBilateralImageFilter<TInputImage, TOutputImage>
+    ::BeforeThreadedGenerateData()
+  {
+    if (m_DomainSigma <= 0.0 || m_RangeSigma <= 0.0)
+    {
+      itkExceptionMacro(<< "DomainSigma and RangeSigma have to be positive.");
+    }
+
+    const InputImageType* input = this->GetInput();
+    const typename InputImageType::RegionType region = input->GetLargestPossibleRegion();
+    const typename InputImageType::SpacingType spacing = input->GetSpacing();
+
+    // intensity range determines the extent of the range axis
+    double minimum = std::numeric_limits<double>::max();
+    double maximum = -std::numeric_limits<double>::max();
+    ImageRegionConstIterator<InputImageType> minMaxIt(input, region);
+    for (minMaxIt.GoToBegin(); !minMaxIt.IsAtEnd(); ++minMaxIt)
+    {
+      const double value = static_cast<double>(minMaxIt.Get());
+      minimum = std::min(minimum, value);
+      maximum = std::max(maximum, value);
+    }
+    m_MinimumValue = minimum;
+
+    size_t numberOfCells = 1;
+    for (unsigned int d = 0; d < ImageDimension; ++d)
+    {
+      m_SamplingRate[d] = spacing[d] / m_DomainSigma;
+      m_GridSize[d] = static_cast<size_t>(std::floor((region.GetSize()[d] - 1) * m_SamplingRate[d])) + 1 + 2 * GridPadding;
+    }
+    m_GridSize[ImageDimension] = static_cast<size_t>(std::floor((maximum - minimum) / m_RangeSigma)) + 1 + 2 * GridPadding;
+
+    for (unsigned int d = 0; d < GridDimension; ++d)
+    {
+      m_GridStride[d] = numberOfCells;
+      numberOfCells *= m_GridSize[d];
+    }
+
+    m_Grid.assign(2 * numberOfCells, 0.0f);
+
+    // splat every pixel into its nearest grid cell
+    ImageRegionConstIteratorWithIndex<InputImageType> splatIt(input, region);
+    for (splatIt.GoToBegin(); !splatIt.IsAtEnd(); ++splatIt)
+    {
+      const typename InputImageType::IndexType index = splatIt.GetIndex();
+      const double value = static_cast<double>(splatIt.Get());
+
+      size_t cell = m_GridStride[ImageDimension] *
+        (static_cast<size_t>((value - minimum) / m_RangeSigma + 0.5) + GridPadding);
+      for (unsigned int d = 0; d < ImageDimension; ++d)
+      {
+        cell += m_GridStride[d] *
+          (static_cast<size_t>((index[d] - region.GetIndex()[d]) * m_SamplingRate[d] + 0.5) + GridPadding);
+      }
+
+      m_Grid[2 * cell] += static_cast<float>(value);
+      m_Grid[2 * cell + 1] += 1.0f;
+    }
+
+    for (unsigned int axis = 0; axis < GridDimension; ++axis)
+    {
+      this->BlurGridAlongAxis(axis);
+    }
+  }
+
+  template <class TInputImage, class TOutputImage>
+  void
+    FastBilateralImageFilter<TInputImage, TOutputImage>
+    ::BlurGridAlongAxis(unsigned int axis)
+  {
+    const size_t length = m_GridSize[axis];
+    const size_t stride = m_GridStride[axis];
+    const size_t numberOfCells = m_Grid.size() / 2;
+
+    m_GridLine.resize(2 * length);
+
+    for (size_t start = 0; start < numberOfCells; ++start)
+    {
+      // only cells with coordinate 0 along the axis start a line
+      if ((start / stride) % length != 0)
+        continue;
+
+      // two passes of [1 2 1]/4 give the binomial [1 4 6 4 1]/16 kernel,
+      // the padding cells are empty so the line ends are treated as zero
+      for (int pass = 0; pass < 2; ++pass)
+      {
+        for (size_t i = 0; i < length; ++i)
+        {
+          const size_t cell = 2 * (start + i * stride);
+          m_GridLine[2 * i] = m_Grid[cell];
+          m_GridLine[2 * i + 1] = m_Grid[cell + 1];
+        }
+        for (size_t i = 1; i + 1 < length; ++i)
+        {
+          const size_t cell = 2 * (start + i * stride);
+          m_Grid[cell] = 0.25f * (m_GridLine[2 * i - 2] + 2.0f * m_GridLine[2 * i] + m_GridLine[2 * i + 2]);
+          m_Grid[cell + 1] = 0.25f * (m_GridLine[2 * i - 1] + 2.0f * m_GridLine[2 * i + 1] + m_GridLine[2 * i + 3]);
+        }
+      }
+    }
+  }
+
+  template <class TInputImage, class TOutputImage>
+  void
+    FastBilateralImageFilter<TInputImage, TOutputImage>
+    ::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+    ThreadIdType threadId)
+  {
+    const InputImageType* input = this->GetInput();
+    OutputImageType* output = this->GetOutput();
+    const typename InputImageType::IndexType start = input->GetLargestPossibleRegion().GetIndex();
+
+    ProgressReporter progress(
+      this, threadId, outputRegionForThread.GetNumberOfPixels());
+
+    ImageRegionConstIterator<InputImageType> inputIt(input, outputRegionForThread);
+    ImageRegionIteratorWithIndex<OutputImageType> outputIt(output, outputRegionForThread);
+
+    const unsigned int numberOfCorners = 1u << GridDimension;
+    size_t floorCoordinate[GridDimension];
+    double fraction[GridDimension];
+
+    for (inputIt.GoToBegin(), outputIt.GoToBegin(); !outputIt.IsAtEnd(); ++inputIt, ++outputIt)
+    {
+      const typename OutputImageType::IndexType index = outputIt.GetIndex();
+      const double value = static_cast<double>(inputIt.Get());
+
+      for (unsigned int d = 0; d < ImageDimension; ++d)
+      {
+        const double coordinate = (index[d] - start[d]) * m_SamplingRate[d] + GridPadding;
+        floorCoordinate[d] = static_cast<size_t>(coordinate);
+        fraction[d] = coordinate - floorCoordinate[d];
+      }
+      const double rangeCoordinate = (value - m_MinimumValue) / m_RangeSigma + GridPadding;
+      floorCoordinate[ImageDimension] = static_cast<size_t>(rangeCoordinate);
+      fraction[ImageDimension] = rangeCoordinate - floorCoordinate[ImageDimension];
+
+      // (N+1)-linear interpolation of the homogeneous grid values
+      double weightedValue = 0.0;
+      double weight = 0.0;
+      for (unsigned int corner = 0; corner < numberOfCorners; ++corner)
+      {
+        double interpolationWeight = 1.0;
+        size_t cell = 0;
+        for (unsigned int d = 0; d < GridDimension; ++d)
+        {
+          const bool upper = (corner >> d) & 1u;
+          interpolationWeight *= upper ? fraction[d] : 1.0 - fraction[d];
+          cell += (floorCoordinate[d] + (upper ? 1 : 0)) * m_GridStride[d];
+        }
+        weightedValue += interpolationWeight * m_Grid[2 * cell];
+        weight += interpolationWeight * m_Grid[2 * cell + 1];
+      }
+
+      outputIt.Set(static_cast<OutputPixelType>(weight > 0.0 ? weightedValue / weight : value));
+      progress.CompletedPixel();
+    }
+  }
+
+  template <class TInputImage, class TOutputImage>
+  void
+    FastBilateralImageFilter<TInputImage, TOutputImage>
+    ::AfterThreadedGenerateData()
+  {
+    std::vector<float>().swap(m_Grid);
+    std::vector<float>().swap(m_GridLine);
+  }
+
+  /**
+  * Standard "PrintSelf" method
+  */
+  template <class TInputImage, class TOutput>
+  void
+    FastBilateralImageFilter<TInputImage, TOutput>
+    ::PrintSelf(
+    std::ostream& os,
+    Indent indent) const
+  {
+    Superclass::PrintSelf( os, indent );
+    os << indent << "DomainSigma: " << m_DomainSigma << std::endl;
+    os << indent << "RangeSigma: " << m_RangeSigma << std::endl;
+  }
+
+} // end namespace itk
+
+#endif
@@ -64,47 +64,25 @@ namespace itk
     infilter->Update();
     typename TOutputImage::Pointer origImage = infilter->GetOutput();
 
-    typename SingleIterationFilterType::Pointer filter;
+    // one single iteration filter is reused; the result of every iteration is
+    // disconnected from it and fed back as the input of the next one
+    typename SingleIterationFilterType::Pointer filter =
+      SingleIterationFilterType::New();
+    filter->SetOriginalImage( origImage );
+    filter->SetLambda(m_Lambda);
+    filter->SetNumberOfThreads(this->GetNumberOfThreads());
+
     for(int i=0; i<m_NumberIterations; i++)
     {
-      filter = SingleIterationFilterType::New();
       filter->SetInput( image );
-      filter->SetOriginalImage( origImage );
-      filter->SetLambda(m_Lambda);
-      filter->SetNumberOfThreads(this->GetNumberOfThreads());
       filter->UpdateLargestPossibleRegion();
       image = filter->GetOutput();
+      image->DisconnectPipeline();
       std::cout << "Iteration " << i+1 << "/" <<
         m_NumberIterations << std::endl;
     }
 
-    typename OutputImageType::Pointer output = this->GetOutput();
-    output->SetSpacing(image->GetSpacing());
-    typename OutputImageType::RegionType largestPossibleRegion;
-    largestPossibleRegion.SetSize(
-      image->GetLargestPossibleRegion().GetSize() );
-    largestPossibleRegion.SetIndex(
-      image->GetLargestPossibleRegion().GetIndex() );
-    output->SetLargestPossibleRegion(
-      image->GetLargestPossibleRegion() );
-    output->SetBufferedRegion(
-      image->GetLargestPossibleRegion() );
-    output->Allocate();
-
-    itk::ImageRegionIterator<OutputImageType> oit(
-      output, output->GetLargestPossibleRegion());
-    oit.GoToBegin();
-
-    itk::ImageRegionConstIterator<OutputImageType> iit(
-      image, image->GetLargestPossibleRegion());
-    iit.GoToBegin();
-
-    while(!oit.IsAtEnd())
-    {
-      oit.Set(iit.Get());
-      ++iit;
-      ++oit;
-    }
+    this->GraftOutput( image );
   }
 
 
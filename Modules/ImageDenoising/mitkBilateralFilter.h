@@ -38,11 +38,17 @@ namespace mitk
     itkSetMacro(RangeSigma,float);
     itkSetMacro(AutoKernel,bool);
     itkSetMacro(KernelRadius,unsigned int);
+    /*!
+    \brief Use the bilateral grid approximation (itk::FastBilateralImageFilter) instead of the exact ITK filter.
+    Much faster for large volumes and large domain sigmas; the kernel size settings are ignored. Default is false.
+    */
+    itkSetMacro(UseBilateralGrid,bool);
 
     itkGetMacro(DomainSigma,float);
     itkGetMacro(RangeSigma,float);
     itkGetMacro(AutoKernel,bool);
     itkGetMacro(KernelRadius,unsigned int);
+    itkGetMacro(UseBilateralGrid,bool);
 
   protected:
     /*!
@@ -74,6 +80,7 @@ namespace mitk
     float m_RangeSigma; ///Sigma of the range mask kernel. See ITK docu
     bool m_AutoKernel; //true: kernel size is calculated from DomainSigma. See ITK Doc; false: set by m_KernelRadius
     unsigned int m_KernelRadius; //use in combination with m_AutoKernel = true
+    bool m_UseBilateralGrid; //true: approximate the filter with a bilateral grid, see itk::FastBilateralImageFilter
   };
 } //END mitk namespace
 #endif
@@ -3,6 +3,8 @@
 #include <string>
 #include <algorithm>
 #include <iterator>
+#include <vector>
+#include <functional>
 
 #define BOOST_LOG_DYN_LINK 1
 
@@ -13,6 +15,9 @@
 #include <boost/current_function.hpp>
 #include <boost/xpressive/xpressive.hpp>
 #include <boost/uuid/uuid.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
 
 // boost log
 #include <boost/log/trivial.hpp>
@@ -21,6 +26,7 @@
 #include <boost/log/sources/logger.hpp>
 
 // boost log::sinks
+#include <boost/log/sinks/sink.hpp>
 #include <boost/log/sinks/text_ostream_backend.hpp>
 
 // boost log::attributes
@@ -34,6 +40,9 @@
 
 #include "StringUtilities.h"
 
+// formats the calling function name once per call site and keeps it in a function local static
+#define AUTOPLAN_CALLER_NAME [](const char* function) -> const std::string& { static const std::string name = Logger::details::formatCallerName(function); return name; }(BOOST_CURRENT_FUNCTION)
+
 // TODO add call BOOST_CURRENT_FUNCTION after investigate it behavior on Apple system
 #ifdef __APPLE__
   #define AUTOPLAN_INFO BOOST_LOG_STREAM_SEV(Logger::Log::get().lg, boost::log::trivial::info)
@@ -42,11 +51,11 @@
   #define AUTOPLAN_WARNING BOOST_LOG_STREAM_SEV(Logger::Log::get().lg, boost::log::trivial::warning)
   #define AUTOPLAN_FATAL BOOST_LOG_STREAM_SEV(Logger::Log::get().lg, boost::log::trivial::fatal)
 #else
-  #define AUTOPLAN_INFO BOOST_LOG_STREAM_SEV(Logger::Log::get(Logger::details::formatCallerName(BOOST_CURRENT_FUNCTION)).lg, boost::log::trivial::info)
-  #define AUTOPLAN_ERROR BOOST_LOG_STREAM_SEV(Logger::Log::get(Logger::details::formatCallerName(BOOST_CURRENT_FUNCTION)).lg, boost::log::trivial::error)
-  #define AUTOPLAN_TRACE BOOST_LOG_STREAM_SEV(Logger::Log::get(Logger::details::formatCallerName(BOOST_CURRENT_FUNCTION)).lg, boost::log::trivial::trace)
-  #define AUTOPLAN_WARNING BOOST_LOG_STREAM_SEV(Logger::Log::get(Logger::details::formatCallerName(BOOST_CURRENT_FUNCTION)).lg, boost::log::trivial::warning)
-  #define AUTOPLAN_FATAL BOOST_LOG_STREAM_SEV(Logger::Log::get(Logger::details::formatCallerName(BOOST_CURRENT_FUNCTION)).lg, boost::log::trivial::fatal)
+  #define AUTOPLAN_INFO BOOST_LOG_STREAM_SEV(Logger::Log::get(AUTOPLAN_CALLER_NAME).lg, boost::log::trivial::info)
+  #define AUTOPLAN_ERROR BOOST_LOG_STREAM_SEV(Logger::Log::get(AUTOPLAN_CALLER_NAME).lg, boost::log::trivial::error)
+  #define AUTOPLAN_TRACE BOOST_LOG_STREAM_SEV(Logger::Log::get(AUTOPLAN_CALLER_NAME).lg, boost::log::trivial::trace)
+  #define AUTOPLAN_WARNING BOOST_LOG_STREAM_SEV(Logger::Log::get(AUTOPLAN_CALLER_NAME).lg, boost::log::trivial::warning)
+  #define AUTOPLAN_FATAL BOOST_LOG_STREAM_SEV(Logger::Log::get(AUTOPLAN_CALLER_NAME).lg, boost::log::trivial::fatal)
 #endif // __APPLE__
 
 struct ThrowAwayPattern {};
@@ -62,7 +71,7 @@ ThrowAwayPattern & operator<<(ThrowAwayPattern&__, T)
   #ifdef __APPLE__
     #define AUTOPLAN_DEBUG BOOST_LOG_STREAM_SEV(Logger::Log::get().lg, boost::log::trivial::debug)
   #else
-    #define AUTOPLAN_DEBUG BOOST_LOG_STREAM_SEV(Logger::Log::get(Logger::details::formatCallerName(BOOST_CURRENT_FUNCTION)).lg, boost::log::trivial::debug)
+    #define AUTOPLAN_DEBUG BOOST_LOG_STREAM_SEV(Logger::Log::get(AUTOPLAN_CALLER_NAME).lg, boost::log::trivial::debug)
   #endif // __APPLE__
 #else
   #define AUTOPLAN_DEBUG _
@@ -88,6 +97,13 @@ namespace Logger
       bool datastoragelog;
       bool tcpdump;
 
+      // file, tcp and console records are formatted and written by background threads, off by default
+      bool asynclog;
+      // drop records when the queue of an asynchronous sink is full instead of blocking the caller
+      bool dropOnOverflow;
+      // milliseconds between two flushes of the asynchronous sinks
+      unsigned int flushInterval;
+
       static Options& get();
 
       std::string getIphost() const;
@@ -114,7 +130,19 @@ namespace Logger
 
       clock_t m_StartTime;
 
+      std::vector< boost::shared_ptr< boost::log::sinks::sink > > m_AsyncSinks;
+      std::vector< std::function<void()> > m_StopAsyncSinks;
+      boost::thread m_FlushThread;
+      boost::mutex m_FlushMutex;
+      boost::condition_variable m_FlushCondition;
+      bool m_StopFlushing;
+
+      void startFlushThread();
+      void stopAsyncSinks();
+
     public:
+      ~Log();
+
       boost::log::sources::severity_logger< boost::log::trivial::severity_level > lg;
       boost::shared_ptr< std::stringstream > getDataStream() const;
       boost::shared_ptr< boost::log::sinks::text_ostream_backend > getDataBackend() const;
@@ -42,6 +42,9 @@
 
 #include <boost/phoenix/bind.hpp>
 
+#include <boost/core/null_deleter.hpp>
+#include <boost/thread/locks.hpp>
+
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
 
@@ -143,9 +146,56 @@ namespace
 
 namespace Logger
 {
-  typedef boost::log::sinks::synchronous_sink< boost::log::sinks::text_file_backend > file_sink;
   typedef boost::log::sinks::synchronous_sink< boost::log::sinks::text_ostream_backend > ostream_sink;
 
+  namespace
+  {
+    // maximum number of records waiting in the queue of an asynchronous sink
+    const size_t ASYNC_QUEUE_SIZE = 8192;
+
+    typedef boost::log::sinks::bounded_fifo_queue< ASYNC_QUEUE_SIZE, boost::log::sinks::block_on_overflow > blocking_queue;
+    typedef boost::log::sinks::bounded_fifo_queue< ASYNC_QUEUE_SIZE, boost::log::sinks::drop_on_overflow > dropping_queue;
+
+    template< typename TBackend, typename TQueue >
+    boost::shared_ptr< boost::log::sinks::sink > addAsyncSink(const boost::shared_ptr< TBackend >& backend,
+      const boost::log::formatter& formatter, std::vector< std::function<void()> >& stopSinks)
+    {
+      typedef boost::log::sinks::asynchronous_sink< TBackend, TQueue > sink_type;
+
+      boost::shared_ptr< sink_type > sink = boost::make_shared< sink_type >(backend);
+      sink->set_formatter(formatter);
+      boost::log::core::get()->add_sink(sink);
+
+      // records still in the queue are written by the final flush
+      stopSinks.push_back([sink] {
+        boost::log::core::get()->remove_sink(sink);
+        sink->stop();
+        sink->flush();
+      });
+      return sink;
+    }
+
+    /// Adds an asynchronous sink if enabled in the options, a synchronous sink otherwise.
+    /// Synchronous sinks flush after each record if autoFlush is set, asynchronous ones are flushed periodically.
+    template< typename TBackend >
+    void addSink(const boost::shared_ptr< TBackend >& backend, const boost::log::formatter& formatter, bool autoFlush,
+      std::vector< boost::shared_ptr< boost::log::sinks::sink > >& asyncSinks, std::vector< std::function<void()> >& stopSinks)
+    {
+      backend->auto_flush(autoFlush && !Options::get().asynclog);
+
+      if (!Options::get().asynclog) {
+        boost::shared_ptr< boost::log::sinks::synchronous_sink< TBackend > > sink =
+          boost::make_shared< boost::log::sinks::synchronous_sink< TBackend > >(backend);
+        sink->set_formatter(formatter);
+        boost::log::core::get()->add_sink(sink);
+      } else if (Options::get().dropOnOverflow) {
+        asyncSinks.push_back(addAsyncSink< TBackend, dropping_queue >(backend, formatter, stopSinks));
+      } else {
+        asyncSinks.push_back(addAsyncSink< TBackend, blocking_queue >(backend, formatter, stopSinks));
+      }
+    }
+  }
+
   Options::Options()
   {
     // defaults
@@ -154,6 +204,9 @@ namespace Logger
     tcplog = true;
     datastoragelog = false;
     tcpdump = false;
+    asynclog = false;
+    dropOnOverflow = false;
+    flushInterval = 500;
 
 #ifdef _WIN32
     
@@ -200,6 +253,7 @@ namespace Logger
     , additionalField(std::string())
     , m_StartTime(clock())
     , sessionTag(boost::uuids::random_generator()())
+    , m_StopFlushing(false)
   {
     dataBackend =
       boost::make_shared< boost::log::sinks::text_ostream_backend >();
@@ -210,6 +264,46 @@ namespace Logger
     reinitLogger();
   }
 
+  Log::~Log()
+  {
+    stopAsyncSinks();
+  }
+
+  void Log::startFlushThread()
+  {
+    m_StopFlushing = false;
+    m_FlushThread = boost::thread([this] {
+      boost::unique_lock< boost::mutex > lock(m_FlushMutex);
+      while (!m_StopFlushing) {
+        m_FlushCondition.wait_for(lock, boost::chrono::milliseconds(Options::get().flushInterval));
+        if (m_StopFlushing) {
+          break;
+        }
+        for (const auto& sink : m_AsyncSinks) {
+          sink->flush();
+        }
+      }
+    });
+  }
+
+  void Log::stopAsyncSinks()
+  {
+    {
+      boost::lock_guard< boost::mutex > lock(m_FlushMutex);
+      m_StopFlushing = true;
+    }
+    m_FlushCondition.notify_all();
+    if (m_FlushThread.joinable()) {
+      m_FlushThread.join();
+    }
+
+    for (const auto& stopSink : m_StopAsyncSinks) {
+      stopSink();
+    }
+    m_StopAsyncSinks.clear();
+    m_AsyncSinks.clear();
+  }
+
   boost::shared_ptr< std::stringstream > Log::getDataStream() const
   {
     return dataStream;
@@ -235,38 +329,39 @@ namespace Logger
 
   void Log::reinitLogger()
   {
+    stopAsyncSinks();
     boost::log::core::get()->remove_all_sinks();
 
     /// Just return if everything is disabled
     if (!(Options::get().consolelog || Options::get().filelog || Options::get().tcplog || Options::get().datastoragelog)) return;
 
+    const boost::log::formatter jsonFormatter =
+      boost::log::expressions::format("{\"datetime\": \"%8%\", \"user\": \"%3%@%2%\", \"severity\": \"%4%\", \"source\": \"%5%\", \"fullname\": \"%6%\", \"organization\": \"%7%\", \"message\": \"%1%\", \"sessiontag\": \"%9%\" %10%}")
+      % boost::phoenix::bind(&MessageForLogstash, boost::log::expressions::attr<std::string>("Message"))
+      % boost::log::expressions::attr<std::string>("ComputerName")
+      % boost::log::expressions::attr<std::string>("UserName")
+      % boost::log::trivial::severity
+      % boost::log::expressions::attr<std::string>("Source")
+      % boost::log::expressions::attr<std::string>("FullName")
+      % boost::log::expressions::attr<std::string>("Organization")
+      % boost::log::expressions::format_date_time< boost::posix_time::ptime >("TimeStamp", TIME_STAMP_FORMAT)
+      % boost::log::expressions::attr<boost::uuids::uuid>("SessionTag")
+      % boost::log::expressions::attr<std::string>("AdditionalField");
+
     if (Options::get().filelog) {
-      boost::shared_ptr< file_sink > sink(new file_sink(
-        boost::log::keywords::file_name = Options::get().logsPath + "/%Y%m%d_%H%M%S_%5N.json",
-        boost::log::keywords::rotation_size = 16384
-      ));
-      sink->locked_backend()->set_file_collector(boost::log::sinks::file::make_collector(
+      boost::shared_ptr< boost::log::sinks::text_file_backend > backend =
+        boost::make_shared< boost::log::sinks::text_file_backend >(
+          boost::log::keywords::file_name = Options::get().logsPath + "/%Y%m%d_%H%M%S_%5N.json",
+          boost::log::keywords::rotation_size = 16384
+        );
+      backend->set_file_collector(boost::log::sinks::file::make_collector(
         boost::log::keywords::target = Options::get().logsPath,     /*< the target directory >*/
         boost::log::keywords::max_size = 16 * 1024 * 1024,          /*< maximum total size of the stored files, in bytes >*/
         boost::log::keywords::min_free_space = 100 * 1024 * 1024    /*< minimum free space on the drive, in bytes >*/
       ));
-      sink->set_formatter(
-        boost::log::expressions::format("{\"datetime\": \"%8%\", \"user\": \"%3%@%2%\", \"severity\": \"%4%\", \"source\": \"%5%\", \"fullname\": \"%6%\", \"organization\": \"%7%\", \"message\": \"%1%\", \"sessiontag\": \"%9%\" %10%}")
-        % boost::phoenix::bind(&MessageForLogstash, boost::log::expressions::attr<std::string>("Message"))
-        % boost::log::expressions::attr<std::string>("ComputerName")
-        % boost::log::expressions::attr<std::string>("UserName")
-        % boost::log::trivial::severity
-        % boost::log::expressions::attr<std::string>("Source")
-        % boost::log::expressions::attr<std::string>("FullName")
-        % boost::log::expressions::attr<std::string>("Organization")
-        % boost::log::expressions::format_date_time< boost::posix_time::ptime >("TimeStamp", TIME_STAMP_FORMAT)
-        % boost::log::expressions::attr<boost::uuids::uuid>("SessionTag")
-        % boost::log::expressions::attr<std::string>("AdditionalField")
-      );
-      sink->locked_backend()->auto_flush(true);
 
       /// Add the sink to the core
-      boost::log::core::get()->add_sink(sink);
+      addSink(backend, jsonFormatter, true, m_AsyncSinks, m_StopAsyncSinks);
     }
 
     if (Options::get().tcplog) {
@@ -284,34 +379,16 @@ namespace Logger
       });
 
       backend->add_stream(stream);
-      backend->auto_flush(true);
-
-      boost::shared_ptr< ostream_sink > sink2(new ostream_sink(backend));
 
       // raw json data to TCP
       if (Options::get().tcpdump) {
-        sink2->set_formatter(
-          boost::log::expressions::format("%1%")
+        addSink(backend, boost::log::expressions::format("%1%")
           % boost::phoenix::bind
-              (&MessageToUTF8, boost::log::expressions::attr<std::string>("Message"))
-        );
+              (&MessageToUTF8, boost::log::expressions::attr<std::string>("Message")),
+          true, m_AsyncSinks, m_StopAsyncSinks);
       } else {
-        sink2->set_formatter(
-          boost::log::expressions::format("{\"datetime\": \"%8%\", \"user\": \"%3%@%2%\", \"severity\": \"%4%\", \"source\": \"%5%\", \"fullname\": \"%6%\", \"organization\": \"%7%\", \"message\": \"%1%\", \"sessiontag\": \"%9%\" %10%}")
-          % boost::phoenix::bind(&MessageForLogstash, boost::log::expressions::attr<std::string>("Message"))
-          % boost::log::expressions::attr<std::string>("ComputerName")
-          % boost::log::expressions::attr<std::string>("UserName")
-          % boost::log::trivial::severity
-          % boost::log::expressions::attr<std::string>("Source")
-          % boost::log::expressions::attr<std::string>("FullName")
-          % boost::log::expressions::attr<std::string>("Organization")
-          % boost::log::expressions::format_date_time< boost::posix_time::ptime >("TimeStamp", TIME_STAMP_FORMAT)
-          % boost::log::expressions::attr<boost::uuids::uuid>("SessionTag")
-          % boost::log::expressions::attr<std::string>("AdditionalField")
-        );
+        addSink(backend, jsonFormatter, true, m_AsyncSinks, m_StopAsyncSinks);
       }
-
-      boost::log::core::get()->add_sink(sink2);
     }
 
     if (Options::get().datastoragelog) {
@@ -332,19 +409,24 @@ namespace Logger
     }
 
     if (Options::get().consolelog) {
-      boost::log::add_console_log(
-        std::cout,
-        boost::log::keywords::format = (
-          boost::log::expressions::stream
+      boost::shared_ptr< boost::log::sinks::text_ostream_backend > backend =
+        boost::make_shared< boost::log::sinks::text_ostream_backend >();
+      backend->add_stream(boost::shared_ptr< std::ostream >(&std::cout, boost::null_deleter()));
+
+      addSink(backend,
+        boost::log::expressions::stream
           << '[' << boost::log::expressions::format_date_time< boost::posix_time::ptime >("TimeStamp", TIME_STAMP_FORMAT) << "] "
           << '(' << boost::log::expressions::attr<std::string>("Source") << ')'
           << boost::log::expressions::if_(boost::log::trivial::severity != boost::log::trivial::info)
           [
             boost::log::expressions::stream << ' ' << boost::log::trivial::severity
           ] << ": "
-          << boost::phoenix::bind(&MessageToOEM, boost::log::expressions::attr<std::string>("Message"))
-          )
-        );
+          << boost::phoenix::bind(&MessageToOEM, boost::log::expressions::attr<std::string>("Message")),
+        false, m_AsyncSinks, m_StopAsyncSinks);
+    }
+
+    if (!m_AsyncSinks.empty()) {
+      startFlushThread();
     }
 
     boost::log::core::get()->add_global_attribute("TimeStamp", boost::log::attributes::local_clock());
@@ -0,0 +1,88 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <AutoplanLogging.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+  const unsigned int numberOfCalls = 20000;
+
+  /** average time of one log call on the calling thread in microseconds */
+  double MeasureLogCall(bool async, bool dropOnOverflow)
+  {
+    Logger::Options::get().asynclog = async;
+    Logger::Options::get().dropOnOverflow = dropOnOverflow;
+    Logger::Log::get().reinitLogger();
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (unsigned int i = 0; i < numberOfCalls; ++i) {
+      AUTOPLAN_INFO << "benchmark record " << i;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    Logger::Log::get().flush();
+    return std::chrono::duration<double, std::micro>(end - start).count() / numberOfCalls;
+  }
+
+  /** average time of formatting the caller name without the per call site cache in microseconds */
+  double MeasureCallerNameFormatting()
+  {
+    auto start = std::chrono::high_resolution_clock::now();
+    for (unsigned int i = 0; i < numberOfCalls; ++i) {
+      Logger::details::formatCallerName(BOOST_CURRENT_FUNCTION);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / numberOfCalls;
+  }
+}
+
+/**
+ * Reports the time a log call costs on the calling thread with synchronous and asynchronous file sinks.
+ * This is a benchmark and not run by ctest, start it manually with the directory for the log files as only argument:
+ * AutoplanLoggingBenchmark <logs path>
+ */
+int main(int argc, char* argv[])
+{
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <logs path>" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  Logger::Options::get().logsPath = argv[1];
+  Logger::Options::get().consolelog = false;
+  Logger::Options::get().filelog = true;
+  Logger::Options::get().tcplog = false;
+  Logger::Options::get().datastoragelog = false;
+
+  double synchronous = MeasureLogCall(false, false);
+  double blocking = MeasureLogCall(true, false);
+  double dropping = MeasureLogCall(true, true);
+  double formatting = MeasureCallerNameFormatting();
+
+  std::cout << "Log call on the calling thread: " << synchronous << "us synchronous, " << blocking << "us asynchronous (blocking), "
+            << dropping << "us asynchronous (dropping); formatting the caller name without cache: " << formatting << "us" << std::endl;
+
+  // stops and drains the asynchronous sinks
+  Logger::Options::get().asynclog = false;
+  Logger::Options::get().filelog = false;
+  Logger::Log::get().reinitLogger();
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,135 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <AutoplanLogging.h>
+
+#include <boost/filesystem.hpp>
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <utility>
+
+namespace
+{
+  int failures = 0;
+
+  void Check(bool condition, const std::string& message)
+  {
+    std::cout << (condition ? "[PASSED] " : "[FAILED] ") << message << std::endl;
+    if (!condition) {
+      ++failures;
+    }
+  }
+
+  class CallerNameTestClass
+  {
+  public:
+    /** the cached and the freshly formatted caller name of this function */
+    static std::pair< const std::string*, std::string > Names()
+    {
+      return std::make_pair(&AUTOPLAN_CALLER_NAME, Logger::details::formatCallerName(BOOST_CURRENT_FUNCTION));
+    }
+  };
+
+  void TestCallerNameCache()
+  {
+    std::pair< const std::string*, std::string > first = CallerNameTestClass::Names();
+    std::pair< const std::string*, std::string > second = CallerNameTestClass::Names();
+
+    Check(first.first == second.first, "The caller name is kept per call site.");
+    Check(first.second == *first.first, "The cached caller name equals the formatted one.");
+  }
+
+  /** the concatenated content of all log files in the given directory */
+  std::string ReadLogFiles(const boost::filesystem::path& logsPath)
+  {
+    std::string content;
+    for (boost::filesystem::directory_iterator it(logsPath), end; it != end; ++it) {
+      if (it->path().extension() == ".json") {
+        std::ifstream file(it->path().string().c_str());
+        content.append(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+      }
+    }
+    return content;
+  }
+
+  /** logs to the data storage sink, which stays synchronous, and to the file sink, which uses the given mode */
+  void TestLogging(const std::string& logsPath, bool async, bool dropOnOverflow)
+  {
+    const std::string mode = async ? (dropOnOverflow ? "asynchronous (dropping)" : "asynchronous (blocking)") : "synchronous";
+
+    // every mode writes to its own, empty directory
+    boost::filesystem::path modeLogsPath = boost::filesystem::path(logsPath) / (async ? (dropOnOverflow ? "dropping" : "blocking") : "sync");
+    boost::filesystem::remove_all(modeLogsPath);
+    boost::filesystem::create_directories(modeLogsPath);
+
+    Logger::Options::get().logsPath = modeLogsPath.string();
+    Logger::Options::get().asynclog = async;
+    Logger::Options::get().dropOnOverflow = dropOnOverflow;
+    Logger::Log::get().reinitLogger();
+    Logger::Log::get().resetData();
+
+    for (unsigned int i = 0; i < 1000; ++i) {
+      AUTOPLAN_INFO << "test record " << i;
+    }
+    Logger::Log::get().flush();
+
+    Check(Logger::Log::get().getData().find("test record 999") != std::string::npos,
+      "The last record reached the data storage sink with " + mode + " file sink.");
+
+    std::string fileContent = ReadLogFiles(modeLogsPath);
+    if (dropOnOverflow) {
+      // records may be dropped while the queue is full, but not all of them
+      Check(fileContent.find("test record ") != std::string::npos, "Records were written by the " + mode + " file sink.");
+    } else {
+      Check(fileContent.find("test record 0\"") != std::string::npos && fileContent.find("test record 999") != std::string::npos,
+        "The first and the last record were written by the " + mode + " file sink.");
+    }
+  }
+}
+
+/**
+ * Checks the per call site caller name cache and logs through synchronous and asynchronous sinks.
+ * The only argument is the directory for the log files.
+ */
+int main(int argc, char* argv[])
+{
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <logs path>" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  Check(!Logger::Options::get().asynclog, "Asynchronous sinks are opt-in.");
+
+  Logger::Options::get().consolelog = false;
+  Logger::Options::get().filelog = true;
+  Logger::Options::get().tcplog = false;
+  Logger::Options::get().datastoragelog = true;
+
+  TestCallerNameCache();
+  TestLogging(argv[1], false, false);
+  TestLogging(argv[1], true, false);
+  TestLogging(argv[1], true, true);
+
+  // stops and drains the asynchronous sinks
+  Logger::Options::get().asynclog = false;
+  Logger::Options::get().filelog = false;
+  Logger::Log::get().reinitLogger();
+
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,98 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+
+#include <mitkIGTLMessageQueue.h>
+
+#include <igtlStringMessage.h>
+#include <igtlTransformMessage.h>
+
+class mitkIGTLMessageQueueTestSuite : public mitk::TestFixture {
+  CPPUNIT_TEST_SUITE(mitkIGTLMessageQueueTestSuite);
+  MITK_TEST(Test_KeepLatestOnly_DropsOlderMessages);
+  MITK_TEST(Test_BufferCapacity_DropsOldestMessage);
+  MITK_TEST(Test_MessageTypes_AreQueuedSeparately);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  mitk::IGTLMessageQueue::Pointer m_Queue;
+
+  igtl::StringMessage::Pointer CreateStringMessage(const std::string& text)
+  {
+    igtl::StringMessage::Pointer message = igtl::StringMessage::New();
+    message->SetString(text);
+    return message;
+  }
+
+public:
+
+  void setUp() override
+  {
+    m_Queue = mitk::IGTLMessageQueue::New();
+  }
+
+  void tearDown() override
+  {
+    m_Queue = nullptr;
+  }
+
+  void Test_KeepLatestOnly_DropsOlderMessages()
+  {
+    m_Queue->EnableInfiniteBuffering(true);
+    m_Queue->PushMessage(CreateStringMessage("first").GetPointer());
+    m_Queue->PushMessage(CreateStringMessage("second").GetPointer());
+
+    igtl::StringMessage::Pointer pulled = m_Queue->PullStringMessage();
+    CPPUNIT_ASSERT_MESSAGE("Latest message was not kept", pulled.IsNotNull() && std::string(pulled->GetString()) == "second");
+    CPPUNIT_ASSERT_MESSAGE("Queue is not empty after pulling the latest message", m_Queue->PullStringMessage().IsNull());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong number of received messages", 2ul, m_Queue->GetNumberOfReceivedMessages());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong number of dropped messages", 1ul, m_Queue->GetNumberOfDroppedMessages());
+  }
+
+  void Test_BufferCapacity_DropsOldestMessage()
+  {
+    m_Queue->EnableInfiniteBuffering(false);
+    m_Queue->SetBufferCapacity(2);
+    m_Queue->PushMessage(CreateStringMessage("first").GetPointer());
+    m_Queue->PushMessage(CreateStringMessage("second").GetPointer());
+    m_Queue->PushMessage(CreateStringMessage("third").GetPointer());
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong queue size", 2, m_Queue->GetSize());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong number of dropped messages", 1ul, m_Queue->GetNumberOfDroppedMessages());
+    CPPUNIT_ASSERT_MESSAGE("Oldest message was not dropped", std::string(m_Queue->PullStringMessage()->GetString()) == "second");
+    CPPUNIT_ASSERT_MESSAGE("Messages are not pulled in order", std::string(m_Queue->PullStringMessage()->GetString()) == "third");
+    CPPUNIT_ASSERT_MESSAGE("Latency is negative", m_Queue->GetMeanLatency() >= 0.0);
+
+    m_Queue->ResetStatistics();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Statistics were not reset", 0ul, m_Queue->GetNumberOfReceivedMessages());
+  }
+
+  void Test_MessageTypes_AreQueuedSeparately()
+  {
+    m_Queue->EnableInfiniteBuffering(true);
+    m_Queue->PushMessage(CreateStringMessage("text").GetPointer());
+    m_Queue->PushMessage(igtl::TransformMessage::New().GetPointer());
+
+    CPPUNIT_ASSERT_MESSAGE("Transform message replaced the string message", m_Queue->PullStringMessage().IsNotNull());
+    CPPUNIT_ASSERT_MESSAGE("Transform message was not queued", m_Queue->PullTransformMessage().IsNotNull());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Messages of different types were dropped", 0ul, m_Queue->GetNumberOfDroppedMessages());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkIGTLMessageQueue)
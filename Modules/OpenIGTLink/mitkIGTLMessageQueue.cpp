@@ -18,204 +18,110 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <string>
 #include "igtlMessageBase.h"
 
-void mitk::IGTLMessageQueue::PushSendMessage(igtl::MessageBase::Pointer message)
+bool mitk::IGTLMessageQueue::GetKeepLatestOnly()
 {
   this->m_Mutex->Lock();
-  if (this->m_BufferingType == IGTLMessageQueue::Infinit)
-    m_SendQueue.clear();
-
-  m_SendQueue.push_back(message);
+  bool keepLatestOnly = (this->m_BufferingType == IGTLMessageQueue::Infinit);
   this->m_Mutex->Unlock();
+  return keepLatestOnly;
 }
 
-void mitk::IGTLMessageQueue::PushCommandMessage(igtl::MessageBase::Pointer message)
+void mitk::IGTLMessageQueue::PushSendMessage(igtl::MessageBase::Pointer message)
 {
-  this->m_Mutex->Lock();
-  if (this->m_BufferingType == IGTLMessageQueue::Infinit)
-    m_CommandQueue.clear();
+  m_SendQueue.Push(message, this->GetKeepLatestOnly(), this->GetBufferCapacity());
+}
 
-  m_CommandQueue.push_back(message);
-  this->m_Mutex->Unlock();
+void mitk::IGTLMessageQueue::PushCommandMessage(igtl::MessageBase::Pointer message)
+{
+  m_CommandQueue.Push(message, this->GetKeepLatestOnly(), this->GetBufferCapacity());
 }
 
 void mitk::IGTLMessageQueue::PushMessage(igtl::MessageBase::Pointer msg)
 {
   this->m_Mutex->Lock();
+  bool keepLatestOnly = (this->m_BufferingType == IGTLMessageQueue::Infinit);
+  unsigned int capacity = this->m_BufferCapacity;
+  m_Latest_Message = msg;
+  this->m_Mutex->Unlock();
 
-  std::stringstream infolog;
-
-  infolog << "Received message of type ";
+  const char* type = "OTHER";
 
-  if (dynamic_cast<igtl::TrackingDataMessage*>(msg.GetPointer()) != nullptr)
+  if (igtl::TrackingDataMessage* trackingMsg = dynamic_cast<igtl::TrackingDataMessage*>(msg.GetPointer()))
   {
-    if (this->m_BufferingType == IGTLMessageQueue::Infinit)
-      m_TrackingDataQueue.clear();
-
-    this->m_TrackingDataQueue.push_back(dynamic_cast<igtl::TrackingDataMessage*>(msg.GetPointer()));
-
-    infolog << "TDATA";
+    this->m_TrackingDataQueue.Push(trackingMsg, keepLatestOnly, capacity);
+    type = "TDATA";
   }
-  else if (dynamic_cast<igtl::TransformMessage*>(msg.GetPointer()) != nullptr)
+  else if (igtl::TransformMessage* transformMsg = dynamic_cast<igtl::TransformMessage*>(msg.GetPointer()))
   {
-    if (this->m_BufferingType == IGTLMessageQueue::Infinit)
-      m_TransformQueue.clear();
-
-    this->m_TransformQueue.push_back(dynamic_cast<igtl::TransformMessage*>(msg.GetPointer()));
-
-    infolog << "TRANSFORM";
+    this->m_TransformQueue.Push(transformMsg, keepLatestOnly, capacity);
+    type = "TRANSFORM";
   }
-  else if (dynamic_cast<igtl::StringMessage*>(msg.GetPointer()) != nullptr)
+  else if (igtl::StringMessage* stringMsg = dynamic_cast<igtl::StringMessage*>(msg.GetPointer()))
   {
-    if (this->m_BufferingType == IGTLMessageQueue::Infinit)
-      m_StringQueue.clear();
-
-    this->m_StringQueue.push_back(dynamic_cast<igtl::StringMessage*>(msg.GetPointer()));
-
-    infolog << "STRING";
+    this->m_StringQueue.Push(stringMsg, keepLatestOnly, capacity);
+    type = "STRING";
   }
-  else if (dynamic_cast<igtl::ImageMessage*>(msg.GetPointer()) != nullptr)
+  else if (igtl::ImageMessage* imageMsg = dynamic_cast<igtl::ImageMessage*>(msg.GetPointer()))
   {
-    igtl::ImageMessage::Pointer imageMsg = dynamic_cast<igtl::ImageMessage*>(msg.GetPointer());
-    int* dim = new int[3];
+    int dim[3];
     imageMsg->GetDimensions(dim);
     if (dim[2] > 1)
     {
-      if (this->m_BufferingType == IGTLMessageQueue::Infinit)
-        m_Image3dQueue.clear();
-
-      this->m_Image3dQueue.push_back(dynamic_cast<igtl::ImageMessage*>(msg.GetPointer()));
-
-      infolog << "IMAGE3D";
+      this->m_Image3dQueue.Push(imageMsg, keepLatestOnly, capacity);
+      type = "IMAGE3D";
     }
     else
     {
-      if (this->m_BufferingType == IGTLMessageQueue::Infinit)
-        m_Image2dQueue.clear();
-
-      this->m_Image2dQueue.push_back(dynamic_cast<igtl::ImageMessage*>(msg.GetPointer()));
-
-      infolog << "IMAGE2D";
+      this->m_Image2dQueue.Push(imageMsg, keepLatestOnly, capacity);
+      type = "IMAGE2D";
     }
   }
   else
   {
-    if (this->m_BufferingType == IGTLMessageQueue::Infinit)
-      m_MiscQueue.clear();
-
-    this->m_MiscQueue.push_back(msg);
-
-    infolog << "OTHER";
+    this->m_MiscQueue.Push(msg, keepLatestOnly, capacity);
   }
 
-  m_Latest_Message = msg;
-
-  MITK_INFO << infolog.str();
-
-  this->m_Mutex->Unlock();
+  MITK_DEBUG << "Received message of type " << type;
 }
 
 igtl::MessageBase::Pointer mitk::IGTLMessageQueue::PullSendMessage()
 {
-  igtl::MessageBase::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_SendQueue.size() > 0)
-  {
-    ret = this->m_SendQueue.front();
-    this->m_SendQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_SendQueue.Pull();
 }
 
 igtl::MessageBase::Pointer mitk::IGTLMessageQueue::PullMiscMessage()
 {
-  igtl::MessageBase::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_MiscQueue.size() > 0)
-  {
-    ret = this->m_MiscQueue.front();
-    this->m_MiscQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_MiscQueue.Pull();
 }
 
 igtl::ImageMessage::Pointer mitk::IGTLMessageQueue::PullImage2dMessage()
 {
-  igtl::ImageMessage::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_Image2dQueue.size() > 0)
-  {
-    ret = this->m_Image2dQueue.front();
-    this->m_Image2dQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_Image2dQueue.Pull();
 }
 
 igtl::ImageMessage::Pointer mitk::IGTLMessageQueue::PullImage3dMessage()
 {
-  igtl::ImageMessage::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_Image3dQueue.size() > 0)
-  {
-    ret = this->m_Image3dQueue.front();
-    this->m_Image3dQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_Image3dQueue.Pull();
 }
 
 igtl::TrackingDataMessage::Pointer mitk::IGTLMessageQueue::PullTrackingMessage()
 {
-  igtl::TrackingDataMessage::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_TrackingDataQueue.size() > 0)
-  {
-    ret = this->m_TrackingDataQueue.front();
-    this->m_TrackingDataQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_TrackingDataQueue.Pull();
 }
 
 igtl::MessageBase::Pointer mitk::IGTLMessageQueue::PullCommandMessage()
 {
-  igtl::MessageBase::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_CommandQueue.size() > 0)
-  {
-    ret = this->m_CommandQueue.front();
-    this->m_CommandQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_CommandQueue.Pull();
 }
 
 igtl::StringMessage::Pointer mitk::IGTLMessageQueue::PullStringMessage()
 {
-  igtl::StringMessage::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_StringQueue.size() > 0)
-  {
-    ret = this->m_StringQueue.front();
-    this->m_StringQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_StringQueue.Pull();
 }
 
 igtl::TransformMessage::Pointer mitk::IGTLMessageQueue::PullTransformMessage()
 {
-  igtl::TransformMessage::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_TransformQueue.size() > 0)
-  {
-    ret = this->m_TransformQueue.front();
-    this->m_TransformQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_TransformQueue.Pull();
 }
 
 std::string mitk::IGTLMessageQueue::GetNextMsgInformationString()
@@ -286,8 +192,8 @@ std::string mitk::IGTLMessageQueue::GetLatestMsgDeviceType()
 
 int mitk::IGTLMessageQueue::GetSize()
 {
-  return (this->m_CommandQueue.size() + this->m_Image2dQueue.size() + this->m_Image3dQueue.size() + this->m_MiscQueue.size()
-    + this->m_StringQueue.size() + this->m_TrackingDataQueue.size() + this->m_TransformQueue.size());
+  return (this->m_CommandQueue.GetSize() + this->m_Image2dQueue.GetSize() + this->m_Image3dQueue.GetSize() + this->m_MiscQueue.GetSize()
+    + this->m_StringQueue.GetSize() + this->m_TrackingDataQueue.GetSize() + this->m_TransformQueue.GetSize());
 }
 
 void mitk::IGTLMessageQueue::EnableInfiniteBuffering(bool enable)
@@ -300,13 +206,76 @@ void mitk::IGTLMessageQueue::EnableInfiniteBuffering(bool enable)
   this->m_Mutex->Unlock();
 }
 
+void mitk::IGTLMessageQueue::SetBufferCapacity(unsigned int capacity)
+{
+  this->m_Mutex->Lock();
+  this->m_BufferCapacity = capacity;
+  this->m_Mutex->Unlock();
+}
+
+unsigned int mitk::IGTLMessageQueue::GetBufferCapacity()
+{
+  this->m_Mutex->Lock();
+  unsigned int capacity = this->m_BufferCapacity;
+  this->m_Mutex->Unlock();
+  return capacity;
+}
+
+void mitk::IGTLMessageQueue::AccumulateStatistics(unsigned long& received, unsigned long& dropped, unsigned long& pulled, double& latencySum)
+{
+  // the send queue is not counted, it holds outgoing messages
+  this->m_CommandQueue.AccumulateStatistics(received, dropped, pulled, latencySum);
+  this->m_Image2dQueue.AccumulateStatistics(received, dropped, pulled, latencySum);
+  this->m_Image3dQueue.AccumulateStatistics(received, dropped, pulled, latencySum);
+  this->m_TransformQueue.AccumulateStatistics(received, dropped, pulled, latencySum);
+  this->m_TrackingDataQueue.AccumulateStatistics(received, dropped, pulled, latencySum);
+  this->m_StringQueue.AccumulateStatistics(received, dropped, pulled, latencySum);
+  this->m_MiscQueue.AccumulateStatistics(received, dropped, pulled, latencySum);
+}
+
+unsigned long mitk::IGTLMessageQueue::GetNumberOfReceivedMessages()
+{
+  unsigned long received = 0, dropped = 0, pulled = 0;
+  double latencySum = 0.0;
+  this->AccumulateStatistics(received, dropped, pulled, latencySum);
+  return received;
+}
+
+unsigned long mitk::IGTLMessageQueue::GetNumberOfDroppedMessages()
+{
+  unsigned long received = 0, dropped = 0, pulled = 0;
+  double latencySum = 0.0;
+  this->AccumulateStatistics(received, dropped, pulled, latencySum);
+  return dropped;
+}
+
+double mitk::IGTLMessageQueue::GetMeanLatency()
+{
+  unsigned long received = 0, dropped = 0, pulled = 0;
+  double latencySum = 0.0;
+  this->AccumulateStatistics(received, dropped, pulled, latencySum);
+  return pulled > 0 ? latencySum / pulled : 0.0;
+}
+
+void mitk::IGTLMessageQueue::ResetStatistics()
+{
+  this->m_CommandQueue.ResetStatistics();
+  this->m_Image2dQueue.ResetStatistics();
+  this->m_Image3dQueue.ResetStatistics();
+  this->m_TransformQueue.ResetStatistics();
+  this->m_TrackingDataQueue.ResetStatistics();
+  this->m_StringQueue.ResetStatistics();
+  this->m_MiscQueue.ResetStatistics();
+  this->m_SendQueue.ResetStatistics();
+}
+
 mitk::IGTLMessageQueue::IGTLMessageQueue()
 {
   this->m_Mutex = itk::FastMutexLock::New();
   this->m_BufferingType = IGTLMessageQueue::Infinit;
+  this->m_BufferCapacity = 0;
 }
 
 mitk::IGTLMessageQueue::~IGTLMessageQueue()
 {
-  this->m_Mutex->Unlock();
-}
\ No newline at end of file
+}
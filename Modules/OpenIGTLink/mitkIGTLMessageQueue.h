@@ -23,7 +23,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "itkFastMutexLock.h"
 #include "mitkCommon.h"
 
+#include <chrono>
 #include <deque>
+#include <utility>
 
 //OpenIGTLink
 #include "igtlMessageBase.h"
@@ -37,6 +39,14 @@ namespace mitk {
   * \class IGTLMessageQueue
   * \brief Thread safe message queue to store OpenIGTLink messages.
   *
+  * Every message type is stored in its own lane with its own lock, so the
+  * receiving thread and consumers of different message types (e.g. images
+  * and tracking data) do not contend for a single mutex. The lock of a lane
+  * is only held for pointer operations.
+  *
+  * The queue counts received and dropped messages and measures the time
+  * messages spend in the queue until they are pulled.
+  *
   * \ingroup OpenIGTLink
   */
   class MITKOPENIGTLINK_EXPORT IGTLMessageQueue : public itk::Object
@@ -109,28 +119,167 @@ namespace mitk {
     */
     void EnableInfiniteBuffering(bool enable);
 
+    /**
+    * \brief Sets the maximum number of messages kept per message type if
+    * the queue stores more than the latest message. If a type exceeds the
+    * capacity its oldest message is dropped. 0 (default) means unlimited.
+    */
+    void SetBufferCapacity(unsigned int capacity);
+    unsigned int GetBufferCapacity();
+
+    /**
+    * \brief Returns the number of received messages of all types since the
+    * last call of ResetStatistics()
+    */
+    unsigned long GetNumberOfReceivedMessages();
+
+    /**
+    * \brief Returns the number of received messages that were replaced or
+    * discarded before they were pulled
+    */
+    unsigned long GetNumberOfDroppedMessages();
+
+    /**
+    * \brief Returns the mean time in milliseconds the pulled messages spent
+    * in the queue
+    */
+    double GetMeanLatency();
+
+    /**
+    * \brief Resets the received/dropped counters and the latency
+    */
+    void ResetStatistics();
+
   protected:
     IGTLMessageQueue();
     virtual ~IGTLMessageQueue();
 
+    typedef std::chrono::steady_clock ClockType;
+
+    /**
+    * \brief Queue for one message type with its own lock and statistics
+    */
+    template <class TMessage>
+    class MessageLane
+    {
+    public:
+      typedef typename TMessage::Pointer MessagePointer;
+
+      MessageLane()
+        : m_Mutex(itk::FastMutexLock::New()),
+          m_NumberOfReceived(0),
+          m_NumberOfDropped(0),
+          m_NumberOfPulled(0),
+          m_LatencySum(0.0)
+      {
+      }
+
+      /**
+      * \brief Adds a message. With latestOnly all older messages are
+      * dropped, otherwise the oldest one is dropped if capacity is exceeded.
+      */
+      void Push(TMessage* message, bool latestOnly, unsigned int capacity)
+      {
+        const ClockType::time_point now = ClockType::now();
+        m_Mutex->Lock();
+        if (latestOnly)
+        {
+          m_NumberOfDropped += m_Messages.size();
+          m_Messages.clear();
+        }
+        else if (capacity > 0 && m_Messages.size() >= capacity)
+        {
+          m_Messages.pop_front();
+          ++m_NumberOfDropped;
+        }
+        m_Messages.push_back(std::make_pair(MessagePointer(message), now));
+        ++m_NumberOfReceived;
+        m_Mutex->Unlock();
+      }
+
+      /**
+      * \brief Returns and removes the oldest message, nullptr if empty
+      */
+      MessagePointer Pull()
+      {
+        MessagePointer ret = nullptr;
+        m_Mutex->Lock();
+        if (!m_Messages.empty())
+        {
+          ret = m_Messages.front().first;
+          m_LatencySum += std::chrono::duration<double, std::milli>(ClockType::now() - m_Messages.front().second).count();
+          ++m_NumberOfPulled;
+          m_Messages.pop_front();
+        }
+        m_Mutex->Unlock();
+        return ret;
+      }
+
+      size_t GetSize()
+      {
+        m_Mutex->Lock();
+        size_t size = m_Messages.size();
+        m_Mutex->Unlock();
+        return size;
+      }
+
+      /**
+      * \brief Adds the counters of this lane to the given values
+      */
+      void AccumulateStatistics(unsigned long& received, unsigned long& dropped, unsigned long& pulled, double& latencySum)
+      {
+        m_Mutex->Lock();
+        received += m_NumberOfReceived;
+        dropped += m_NumberOfDropped;
+        pulled += m_NumberOfPulled;
+        latencySum += m_LatencySum;
+        m_Mutex->Unlock();
+      }
+
+      void ResetStatistics()
+      {
+        m_Mutex->Lock();
+        m_NumberOfReceived = 0;
+        m_NumberOfDropped = 0;
+        m_NumberOfPulled = 0;
+        m_LatencySum = 0.0;
+        m_Mutex->Unlock();
+      }
+
+    private:
+      itk::FastMutexLock::Pointer m_Mutex;
+      std::deque< std::pair< MessagePointer, ClockType::time_point > > m_Messages;
+      unsigned long m_NumberOfReceived;
+      unsigned long m_NumberOfDropped;
+      unsigned long m_NumberOfPulled;
+      double m_LatencySum;
+    };
+
+    /**
+    * \brief Returns true if only the latest message of each type is kept
+    */
+    bool GetKeepLatestOnly();
+
+    void AccumulateStatistics(unsigned long& received, unsigned long& dropped, unsigned long& pulled, double& latencySum);
+
   protected:
     /**
-    * \brief Mutex to take car of the queue
+    * \brief Mutex to take care of the latest message and the buffer settings
     */
     itk::FastMutexLock::Pointer m_Mutex;
 
     /**
-    * \brief the queue that stores pointer to the inserted messages
+    * \brief the lanes that store pointer to the inserted messages
     */
-    std::deque< igtl::MessageBase::Pointer > m_CommandQueue;
-    std::deque< igtl::ImageMessage::Pointer > m_Image2dQueue;
-    std::deque< igtl::ImageMessage::Pointer > m_Image3dQueue;
-    std::deque< igtl::TransformMessage::Pointer > m_TransformQueue;
-    std::deque< igtl::TrackingDataMessage::Pointer > m_TrackingDataQueue;
-    std::deque< igtl::StringMessage::Pointer > m_StringQueue;
-    std::deque< igtl::MessageBase::Pointer > m_MiscQueue;
+    MessageLane< igtl::MessageBase > m_CommandQueue;
+    MessageLane< igtl::ImageMessage > m_Image2dQueue;
+    MessageLane< igtl::ImageMessage > m_Image3dQueue;
+    MessageLane< igtl::TransformMessage > m_TransformQueue;
+    MessageLane< igtl::TrackingDataMessage > m_TrackingDataQueue;
+    MessageLane< igtl::StringMessage > m_StringQueue;
+    MessageLane< igtl::MessageBase > m_MiscQueue;
 
-    std::deque< igtl::MessageBase::Pointer> m_SendQueue;
+    MessageLane< igtl::MessageBase > m_SendQueue;
 
     igtl::MessageBase::Pointer m_Latest_Message;
 
@@ -138,6 +287,8 @@ namespace mitk {
     * \brief defines the kind of buffering
     */
     BufferingType m_BufferingType;
+
+    unsigned int m_BufferCapacity;
   };
 }
 
@@ -210,22 +210,22 @@ void mitk::PlanarFigureMapper2D::PaintPolyLine(
   bool closed,
   Point2D& anchorPoint,
   const PlaneGeometry* planarFigurePlaneGeometry,
-  const PlaneGeometry* rendererPlaneGeometry,
+  const PlaneGeometry* /*rendererPlaneGeometry*/,
   const mitk::BaseRenderer * renderer)
 {
   mitk::Point2D rightMostPoint;
   rightMostPoint.Fill( itk::NumericTraits<float>::min() );
 
-  // transform all vertices into Point2Ds in display-Coordinates and store them in vector
-  std::vector<mitk::Point2D> pointlist;
-  for ( auto iter = vertices.cbegin(); iter!=vertices.cend(); ++iter )
-  {
-    // Draw this 2D point as OpenGL vertex
-    mitk::Point2D displayPoint;
-    this->TransformObjectToDisplay( *iter, displayPoint,
-      planarFigurePlaneGeometry, rendererPlaneGeometry, renderer );
+  // transform all vertices into Point2Ds in display-Coordinates and store them in vector,
+  // mapping them from local 2D geometry into 3D world space in one run
+  std::vector<mitk::Point3D> worldPoints( vertices.size() );
+  planarFigurePlaneGeometry->Map( vertices.data(), worldPoints.data(), vertices.size() );
 
-    pointlist.push_back(displayPoint);
+  std::vector<mitk::Point2D> pointlist( vertices.size() );
+  for ( std::size_t i = 0; i < worldPoints.size(); ++i )
+  {
+    // Project 3D world point onto display geometry
+    renderer->WorldToView( worldPoints[i], pointlist[i] );
   }
 
   if (!pointlist.size())
@@ -278,11 +278,7 @@ void mitk::PlanarFigureMapper2D::PaintPolyLine(
   // effect when using the MESA OpenGL library.
   if ( closed )
   {
-    mitk::Point2D displayPoint;
-    this->TransformObjectToDisplay( vertices.cbegin()[0], displayPoint,
-      planarFigurePlaneGeometry, rendererPlaneGeometry, renderer );
-
-    pointlist.push_back( displayPoint );
+    pointlist.push_back( pointlist.front() );
   }
 
   // now paint all the points in one run
@@ -293,6 +289,7 @@ void mitk::PlanarFigureMapper2D::PaintPolyLine(
     points[i * 2 + 1] = pointlist[i][1];
   }
   this->m_Context->DrawPoly(points, pointlist.size());
+  delete[] points;
 
   anchorPoint = rightMostPoint;
 }
@@ -25,6 +25,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkRenderingManager.h>
 #include <numpy/arrayobject.h>
 #include <mitkExceptionMacro.h>
+#include <mitkImageAccessLock.h>
+#include <itkCommand.h>
+#include <algorithm>
 
 #ifndef WIN32
 #include <dlfcn.h>
@@ -287,7 +290,10 @@ bool mitk::PythonService::CopyToPythonAsSimpleItkImage(mitk::Image *image, const
   mitk::PixelType pixelType = image->GetPixelType();
   itk::ImageIOBase::IOPixelType ioPixelType = image->GetPixelType().GetPixelType();
   PyObject* npyArray = NULL;
-  void* array = (void*) image->GetVolumeData()->GetData();
+  // the temporary numpy view is only read while SimpleITK copies it
+  mitk::ImageRegionAccessor accessor( image );
+  mitk::ImageAccessLock lock( &accessor );
+  void* array = accessor.getData();
 
   mitk::Vector3D xDirection;
   mitk::Vector3D yDirection;
@@ -558,6 +564,247 @@ mitk::PixelType DeterminePixelType(const std::string& pythonPixeltype, int nrCom
   return pixelType;
 }
 
+namespace
+{
+  const char* const NumpyImageViewName = "mitk.ImageView";
+
+  /// keeps the image locked as long as a numpy array references its data
+  struct NumpyImageView
+  {
+    NumpyImageView( mitk::Image* image, bool writeAccess )
+      : accessor( image ), lock( &accessor, writeAccess )
+    {
+    }
+
+    mitk::ImageRegionAccessor accessor;
+    mitk::ImageAccessLock lock;
+  };
+
+  void ReleaseNumpyImageView( PyObject* capsule )
+  {
+    delete static_cast<NumpyImageView*>( PyCapsule_GetPointer( capsule, NumpyImageViewName ) );
+  }
+
+  /// drops the reference of an adopted numpy array when the image is deleted
+  void ReleaseNumpyArray( itk::Object*, const itk::EventObject&, void* clientData )
+  {
+    // the interpreter already freed all objects if it was finalized before the image
+    if( !Py_IsInitialized() )
+    {
+      return;
+    }
+    PyGILState_STATE gilState = PyGILState_Ensure();
+    Py_DECREF( static_cast<PyObject*>( clientData ) );
+    PyGILState_Release( gilState );
+  }
+
+  /// \return true if the data of the array belongs to an image shared by ShareToPythonAsNumpyArray()
+  bool IsImageView( PyArrayObject* npyArray )
+  {
+    PyObject* base = PyArray_BASE( npyArray );
+    while( base != NULL && PyArray_Check( base ) )
+    {
+      base = PyArray_BASE( (PyArrayObject*) base );
+    }
+    return base != NULL && PyCapsule_IsValid( base, NumpyImageViewName );
+  }
+
+  /// \return false if the component type has no numpy equivalent
+  bool DetermineNumpyType( const mitk::PixelType& pixelType, int& npyType )
+  {
+    switch( pixelType.GetComponentType() )
+    {
+      case itk::ImageIOBase::UCHAR:  npyType = NPY_UBYTE;  return true;
+      case itk::ImageIOBase::CHAR:   npyType = NPY_BYTE;   return true;
+      case itk::ImageIOBase::USHORT: npyType = NPY_USHORT; return true;
+      case itk::ImageIOBase::SHORT:  npyType = NPY_SHORT;  return true;
+      case itk::ImageIOBase::UINT:   npyType = NPY_UINT;   return true;
+      case itk::ImageIOBase::INT:    npyType = NPY_INT;    return true;
+      case itk::ImageIOBase::ULONG:  npyType = NPY_ULONG;  return true;
+      case itk::ImageIOBase::LONG:   npyType = NPY_LONG;   return true;
+      case itk::ImageIOBase::FLOAT:  npyType = NPY_FLOAT;  return true;
+      case itk::ImageIOBase::DOUBLE: npyType = NPY_DOUBLE; return true;
+      default: return false;
+    }
+  }
+
+  /// creates an image on top of the data of a C contiguous array and takes over the reference to the array.
+  /// Four dimensional arrays are split into time steps.
+  mitk::Image::Pointer ReferenceNumpyArray( PyArrayObject* npyArray, unsigned int nrComponents )
+  {
+    unsigned int nrDimensions = PyArray_NDIM( npyArray );
+    if( nrComponents > 1 ) // the last dimension holds the vector components
+    {
+      if( nrDimensions < 2 || static_cast<unsigned int>( PyArray_DIM( npyArray, nrDimensions - 1 ) ) != nrComponents )
+      {
+        Py_DECREF( npyArray );
+        mitkThrow() << "the last array dimension does not match " << nrComponents << " components";
+      }
+      --nrDimensions;
+    }
+    if( nrDimensions < 2 || nrDimensions > 4 )
+    {
+      Py_DECREF( npyArray );
+      mitkThrow() << "cannot create an image with " << nrDimensions << " dimensions";
+    }
+
+    std::string dtype;
+    PyObject* py_dtypeName = PyObject_GetAttrString( (PyObject*) PyArray_DESCR( npyArray ), "name" );
+    if( py_dtypeName != NULL )
+    {
+      dtype = PyString_AsString( py_dtypeName );
+      Py_DECREF( py_dtypeName );
+    }
+
+    mitk::PixelType pixelType = mitk::MakePixelType<char, char >( 1 );
+    try
+    {
+      pixelType = DeterminePixelType( dtype, nrComponents, nrDimensions );
+    }
+    catch( const mitk::Exception& )
+    {
+      Py_DECREF( npyArray );
+      throw;
+    }
+
+    // fill backwards, numpy stores the slowest varying dimension first
+    std::vector<unsigned int> dimensions( nrDimensions );
+    for( unsigned int i = 0; i < nrDimensions; ++i )
+    {
+      dimensions[i] = PyArray_DIM( npyArray, nrDimensions - 1 - i );
+    }
+
+    mitk::Image::Pointer mitkImage = mitk::Image::New();
+    mitkImage->Initialize( pixelType, nrDimensions, dimensions.data() );
+
+    char* data = static_cast<char*>( PyArray_DATA( npyArray ) );
+    const size_t volumeSize = static_cast<size_t>( dimensions[0] ) * dimensions[1] * ( nrDimensions > 2 ? dimensions[2] : 1 )
+                              * mitkImage->GetPixelType().GetSize();
+    for( unsigned int t = 0; t < mitkImage->GetTimeSteps(); ++t )
+    {
+      mitkImage->SetImportVolume( data + t * volumeSize, t, 0, mitk::Image::ReferenceMemory );
+    }
+
+    itk::CStyleCommand::Pointer releaseCommand = itk::CStyleCommand::New();
+    releaseCommand->SetClientData( npyArray );
+    releaseCommand->SetCallback( &ReleaseNumpyArray );
+    mitkImage->AddObserver( itk::DeleteEvent(), releaseCommand );
+
+    return mitkImage;
+  }
+}
+
+bool mitk::PythonService::ShareToPythonAsNumpyArray( mitk::Image* image, const std::string& varName, bool writeAccess )
+{
+  int npyType = NPY_NOTYPE;
+  if( image == nullptr || !DetermineNumpyType( image->GetPixelType(), npyType ) )
+  {
+    MITK_WARN << "not a recognized pixeltype";
+    return false;
+  }
+
+  import_array1 (false);
+
+  // numpy orders the dimensions from the slowest to the fastest varying one, the components come last
+  const unsigned int nrDimensions = std::min( image->GetDimension(), 3u );
+  const unsigned int nrComponents = image->GetPixelType().GetNumberOfComponents();
+  npy_intp npy_dims[4];
+  int npy_nd = 0;
+  for( int i = nrDimensions - 1; i >= 0; --i )
+  {
+    npy_dims[npy_nd++] = image->GetDimension( i );
+  }
+  if( nrComponents > 1 )
+  {
+    npy_dims[npy_nd++] = nrComponents;
+  }
+
+  NumpyImageView* view = new NumpyImageView( image, writeAccess );
+  PyObject* npyArray = PyArray_New( &PyArray_Type, npy_nd, npy_dims, npyType, NULL, view->accessor.getData(), 0,
+                                    writeAccess ? NPY_ARRAY_CARRAY : NPY_ARRAY_CARRAY_RO, NULL );
+  if( npyArray == NULL )
+  {
+    delete view;
+    return false;
+  }
+
+  // the array owns the view, python releases the lock together with the last reference to the array
+  PyObject* capsule = PyCapsule_New( view, NumpyImageViewName, &ReleaseNumpyImageView );
+  if( capsule == NULL )
+  {
+    Py_DECREF( npyArray );
+    delete view;
+    return false;
+  }
+  if( PyArray_SetBaseObject( (PyArrayObject*) npyArray, capsule ) != 0 )
+  {
+    Py_DECREF( npyArray );
+    return false;
+  }
+
+  PyObject *pyMod = PyImport_AddModule((char*)"__main__");
+  PyObject *pyDict = PyModule_GetDict(pyMod);
+  const int status = PyDict_SetItemString( pyDict, varName.c_str(), npyArray );
+  Py_DECREF( npyArray );
+
+  return status == 0;
+}
+
+bool mitk::PythonService::ReleaseSharedNumpyArray( const std::string& varName )
+{
+  PyObject *pyMod = PyImport_AddModule((char*)"__main__");
+  PyObject *pyDict = PyModule_GetDict(pyMod);
+  PyObject* object = PyDict_GetItemString( pyDict, varName.c_str() );
+  if( object == NULL )
+  {
+    return false;
+  }
+
+  // the dictionary holds the only reference if deleting the variable deletes the array
+  const bool released = Py_REFCNT( object ) == 1;
+  PyDict_DelItemString( pyDict, varName.c_str() );
+  if( !released )
+  {
+    MITK_WARN << varName << " is still referenced in python, the image stays locked until the last reference is deleted";
+  }
+  return released;
+}
+
+mitk::Image::Pointer mitk::PythonService::AdoptImageFromNumpyArray( const std::string& varName, const mitk::BaseGeometry* geometry,
+                                                                    unsigned int numberOfComponents )
+{
+  import_array1 (nullptr);
+
+  PyObject *pyMod = PyImport_AddModule((char*)"__main__");
+  PyObject *pyDict = PyModule_GetDict(pyMod);
+  PyObject* object = PyDict_GetItemString( pyDict, varName.c_str() );
+  if( object == NULL || !PyArray_Check( object ) )
+  {
+    mitkThrow() << varName << " is not a numpy array";
+  }
+
+  // returns a new reference to the array itself if it is already C contiguous, aligned and in native byte order.
+  // An image on a read-only array or on the data of a shared image could be written without holding a lock, copy those.
+  int requirements = NPY_ARRAY_IN_ARRAY | NPY_ARRAY_NOTSWAPPED;
+  if( !PyArray_ISWRITEABLE( (PyArrayObject*) object ) || IsImageView( (PyArrayObject*) object ) )
+  {
+    requirements |= NPY_ARRAY_ENSURECOPY;
+  }
+  PyArrayObject* npyArray = (PyArrayObject*) PyArray_FROM_OF( object, requirements );
+  if( npyArray == NULL )
+  {
+    PyErr_Clear();
+    mitkThrow() << "cannot convert " << varName << " to a contiguous array";
+  }
+
+  mitk::Image::Pointer mitkImage = ReferenceNumpyArray( npyArray, numberOfComponents );
+  if( geometry != nullptr )
+  {
+    mitkImage->SetGeometry( geometry->Clone() );
+  }
+  return mitkImage;
+}
+
 mitk::Image::Pointer mitk::PythonService::CopySimpleItkImageFromPython(const std::string &stdvarName)
 {
   double*ds = NULL;
@@ -565,7 +812,6 @@ mitk::Image::Pointer mitk::PythonService::CopySimpleItkImageFromPython(const std
   PyObject *pyMod = PyImport_AddModule((char*)"__main__");
   // global dictionarry
   PyObject *pyDict = PyModule_GetDict(pyMod);
-  mitk::Image::Pointer mitkImage = mitk::Image::New();
   mitk::Vector3D spacing;
   mitk::Point3D origin;
   QString command;
@@ -583,8 +829,6 @@ mitk::Image::Pointer mitk::PythonService::CopySimpleItkImageFromPython(const std
   MITK_DEBUG("PythonService") << "Issuing python command " << command.toStdString();
   this->Execute(command.toStdString(), IPythonService::MULTI_LINE_COMMAND );
 
-  PyObject* py_dtype = PyDict_GetItemString(pyDict,QString("%1_dtype").arg(varName).toStdString().c_str() );
-  std::string dtype = PyString_AsString(py_dtype);
   PyArrayObject* py_data = (PyArrayObject*) PyDict_GetItemString(pyDict,QString("%1_numpy_array").arg(varName).toStdString().c_str() );
   PyArrayObject* py_spacing = (PyArrayObject*) PyDict_GetItemString(pyDict,QString("%1_spacing").arg(varName).toStdString().c_str() );
   PyArrayObject* py_origin = (PyArrayObject*) PyDict_GetItemString(pyDict,QString("%1_origin").arg(varName).toStdString().c_str() );
@@ -594,25 +838,9 @@ mitk::Image::Pointer mitk::PythonService::CopySimpleItkImageFromPython(const std
 
   unsigned int nr_Components = *((unsigned int*) py_nrComponents->data);
 
-  unsigned int nr_dimensions = py_data->nd;
-  if (nr_Components > 1) // for VectorImages the last dimension in the numpy array are the vector components.
-  {
-    --nr_dimensions;
-  }
-
-  mitk::PixelType pixelType = DeterminePixelType(dtype, nr_Components, nr_dimensions);
-
-  unsigned int* dimensions = new unsigned int[nr_dimensions];
-  // fill backwards , nd data saves dimensions in opposite direction
-  for( unsigned i = 0; i < nr_dimensions; ++i )
-  {
-    dimensions[i] = py_data->dimensions[nr_dimensions - 1 - i];
-  }
-
-  mitkImage->Initialize(pixelType, nr_dimensions, dimensions);
-
-
-  mitkImage->SetChannel(py_data->data);
+  // GetArrayFromImage returns a new contiguous array, the image references it instead of copying it again
+  Py_INCREF( py_data );
+  mitk::Image::Pointer mitkImage = ReferenceNumpyArray( py_data, nr_Components );
 
 
   ds = (double*)py_spacing->data;
@@ -667,9 +895,6 @@ mitk::Image::Pointer mitk::PythonService::CopySimpleItkImageFromPython(const std
   MITK_DEBUG("PythonService") << "Issuing python command " << command.toStdString();
   this->Execute(command.toStdString(), IPythonService::MULTI_LINE_COMMAND );
 
-  delete[] dimensions;
-
-
   return mitkImage;
 }
 
@@ -69,6 +69,16 @@ namespace mitk
       /// \see IPythonService::CopyItkImageFromPython()
       mitk::Image::Pointer CopySimpleItkImageFromPython( const std::string& varName );
       ///
+      /// \see IPythonService::ShareToPythonAsNumpyArray()
+      bool ShareToPythonAsNumpyArray( mitk::Image* image, const std::string& varName, bool writeAccess = false );
+      ///
+      /// \see IPythonService::ReleaseSharedNumpyArray()
+      bool ReleaseSharedNumpyArray( const std::string& varName );
+      ///
+      /// \see IPythonService::AdoptImageFromNumpyArray()
+      mitk::Image::Pointer AdoptImageFromNumpyArray( const std::string& varName, const mitk::BaseGeometry* geometry = nullptr,
+                                                     unsigned int numberOfComponents = 1 );
+      ///
       /// \see IPythonService::IsOpenCvPythonWrappingAvailable()
       bool IsOpenCvPythonWrappingAvailable();
       ///
@@ -113,6 +113,27 @@ namespace mitk
         /// \return the image or 0 if copying was not possible
         virtual mitk::Image::Pointer CopySimpleItkImageFromPython( const std::string& varName ) = 0;
 
+        ///
+        /// exposes the volume data of the first time step of an image as numpy array named "varName" without copying it.
+        /// The array holds an mitk::ImageAccessLock on the image until it is deleted in python, a write lock if writeAccess
+        /// is true and a read lock with a read-only array otherwise. Conflicting locks on the image wait until then, so release
+        /// the array with ReleaseSharedNumpyArray() as soon as python is done with it.
+        /// \return true if the array was created, else false
+        virtual bool ShareToPythonAsNumpyArray( mitk::Image* image, const std::string& varName, bool writeAccess = false ) = 0;
+        ///
+        /// removes the variable "varName" shared by ShareToPythonAsNumpyArray() from python.
+        /// \return true if this released the lock on the image, false if other python objects still reference the array
+        virtual bool ReleaseSharedNumpyArray( const std::string& varName ) = 0;
+        ///
+        /// creates an image that references the data of the numpy array named "varName". The last array dimension is used for
+        /// the pixel components if numberOfComponents is larger than one. Arrays which are not C contiguous, aligned and in native
+        /// byte order are converted once. Read-only arrays and arrays on the data of an image shared with
+        /// ShareToPythonAsNumpyArray() are copied, since the image could otherwise be written without holding a lock.
+        /// The image keeps the array alive until it is deleted. The geometry is cloned if given.
+        /// \return the image, throws an mitk::Exception if the variable is no suitable array
+        virtual mitk::Image::Pointer AdoptImageFromNumpyArray( const std::string& varName, const mitk::BaseGeometry* geometry = nullptr,
+                                                               unsigned int numberOfComponents = 1 ) = 0;
+
         ///
         /// \return true, if OpenCv wrapping is available, false otherwise
         virtual bool IsOpenCvPythonWrappingAvailable() = 0;
@@ -1,5 +1,11 @@
 set(MODULE_TESTS
   mitkPythonTest.cpp
+  mitkNumpyPythonTest.cpp
+)
+
+# benchmarks, not run by ctest
+set(MODULE_CUSTOM_TESTS
+  mitkNumpyPythonBenchmarkTest.cpp
 )
 
 #TODO: temporarily disabled untill segfault is fixed (bug-19152)
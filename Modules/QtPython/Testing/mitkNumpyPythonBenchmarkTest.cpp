@@ -0,0 +1,77 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+#include <mitkCommonPythonTest.h>
+#include <itkTimeProbe.h>
+
+/**
+ * Reports the image round trip throughput through numpy arrays compared to the SimpleITK transfer
+ * if the wrapping is available. Not run by ctest, start it from the test driver:
+ * MitkQtPythonTestDriver mitkNumpyPythonBenchmarkTest
+ */
+class mitkNumpyPythonBenchmarkTestSuite : public mitk::CommonPythonTestSuite
+{
+  CPPUNIT_TEST_SUITE(mitkNumpyPythonBenchmarkTestSuite);
+  MITK_TEST(RoundTrip_NumpyAndSimpleItk_Throughput);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void RoundTrip_NumpyAndSimpleItk_Throughput()
+  {
+    const unsigned int repetitions = 20;
+    const mitk::PixelType pixelType = m_Image->GetPixelType();
+    const double megabytes = repetitions * static_cast<double>( pixelType.GetSize() ) * m_Image->GetDimension( 0 )
+                             * m_Image->GetDimension( 1 ) * m_Image->GetDimension( 2 ) / ( 1024.0 * 1024.0 );
+
+    // the view is shared without a copy, adopting it copies the data once as it is read-only
+    itk::TimeProbe numpyClock;
+    mitk::Image::Pointer pythonImage;
+    for( unsigned int i = 0; i < repetitions; ++i )
+    {
+      numpyClock.Start();
+      m_PythonService->ShareToPythonAsNumpyArray( m_Image, "mitkImage_view" );
+      pythonImage = m_PythonService->AdoptImageFromNumpyArray( "mitkImage_view", m_Image->GetGeometry() );
+      m_PythonService->ReleaseSharedNumpyArray( "mitkImage_view" );
+      numpyClock.Stop();
+    }
+
+    CPPUNIT_ASSERT_MESSAGE( "Compare if images are equal after transfer.",
+                            mitk::Equal( *pythonImage.GetPointer(), *m_Image.GetPointer(), mitk::eps, true ) );
+
+    std::stringstream report;
+    report << "Image round trip: " << megabytes / numpyClock.GetTotal() << " MB/s (numpy arrays)";
+
+    if( m_PythonService->IsSimpleItkPythonWrappingAvailable() )
+    {
+      itk::TimeProbe simpleItkClock;
+      for( unsigned int i = 0; i < repetitions; ++i )
+      {
+        simpleItkClock.Start();
+        m_PythonService->CopyToPythonAsSimpleItkImage( m_Image, "mitkImage" );
+        pythonImage = m_PythonService->CopySimpleItkImageFromPython( "mitkImage" );
+        simpleItkClock.Stop();
+      }
+      report << ", " << megabytes / simpleItkClock.GetTotal() << " MB/s (SimpleITK copies)";
+
+      CPPUNIT_ASSERT_MESSAGE( "Compare if images are equal after transfer.",
+                              mitk::Equal( *pythonImage.GetPointer(), *m_Image.GetPointer(), mitk::eps, true ) );
+    }
+
+    MITK_INFO << report.str();
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkNumpyPythonBenchmark)
@@ -0,0 +1,99 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+#include <mitkCommonPythonTest.h>
+
+/**
+ * Transfers images through numpy views and checks that the views lock the image only as long as they exist.
+ */
+class mitkNumpyPythonTestSuite : public mitk::CommonPythonTestSuite
+{
+  CPPUNIT_TEST_SUITE(mitkNumpyPythonTestSuite);
+  MITK_TEST(ShareAndAdopt_CopiedArray_EqualImage);
+  MITK_TEST(Share_ReadOnlyView_WriteFails);
+  MITK_TEST(Share_WritableView_ModifiesImage);
+  MITK_TEST(Adopt_SharedView_CopiesData);
+  MITK_TEST(Release_ReferencedView_KeepsLock);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void ShareAndAdopt_CopiedArray_EqualImage()
+  {
+    CPPUNIT_ASSERT_MESSAGE( "Valid image shared with python should return true.",
+                            m_PythonService->ShareToPythonAsNumpyArray( m_Image, "mitkImage_view" ) );
+
+    // the copy outlives the view, which releases the lock on the image
+    m_PythonService->Execute( "mitkImage_copy = mitkImage_view.copy()", mitk::IPythonService::SINGLE_LINE_COMMAND );
+    CPPUNIT_ASSERT_MESSAGE( "Python execute error occured.", !m_PythonService->PythonErrorOccured() );
+    CPPUNIT_ASSERT_MESSAGE( "Releasing the only reference releases the lock.",
+                            m_PythonService->ReleaseSharedNumpyArray( "mitkImage_view" ) );
+
+    mitk::Image::Pointer pythonImage = m_PythonService->AdoptImageFromNumpyArray( "mitkImage_copy", m_Image->GetGeometry() );
+    m_PythonService->Execute( "del mitkImage_copy", mitk::IPythonService::SINGLE_LINE_COMMAND );
+
+    CPPUNIT_ASSERT_MESSAGE( "Compare if images are equal after transfer.",
+                            mitk::Equal( *pythonImage.GetPointer(), *m_Image.GetPointer(), mitk::eps, true ) );
+  }
+
+  void Share_ReadOnlyView_WriteFails()
+  {
+    m_PythonService->ShareToPythonAsNumpyArray( m_Image, "mitkImage_view" );
+    m_PythonService->Execute( "mitkImage_view[0,0,0] = 1", mitk::IPythonService::SINGLE_LINE_COMMAND );
+    CPPUNIT_ASSERT_MESSAGE( "Writing to a read-only view fails.", m_PythonService->PythonErrorOccured() );
+    m_PythonService->ReleaseSharedNumpyArray( "mitkImage_view" );
+  }
+
+  void Share_WritableView_ModifiesImage()
+  {
+    mitk::Image::Pointer image = m_Image->Clone();
+    m_PythonService->ShareToPythonAsNumpyArray( image, "mitkImage_view", true );
+    m_PythonService->Execute( "mitkImage_view.fill(0)", mitk::IPythonService::SINGLE_LINE_COMMAND );
+    CPPUNIT_ASSERT_MESSAGE( "Python execute error occured.", !m_PythonService->PythonErrorOccured() );
+    m_PythonService->ReleaseSharedNumpyArray( "mitkImage_view" );
+
+    m_PythonService->ShareToPythonAsNumpyArray( image, "mitkImage_view" );
+    std::string maximum = m_PythonService->Execute( "int(mitkImage_view.max())", mitk::IPythonService::EVAL_COMMAND );
+    m_PythonService->ReleaseSharedNumpyArray( "mitkImage_view" );
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "The image data was modified through the view.", std::string( "0" ), maximum );
+  }
+
+  void Adopt_SharedView_CopiesData()
+  {
+    m_PythonService->ShareToPythonAsNumpyArray( m_Image, "mitkImage_view" );
+    mitk::Image::Pointer pythonImage = m_PythonService->AdoptImageFromNumpyArray( "mitkImage_view", m_Image->GetGeometry() );
+    m_PythonService->ReleaseSharedNumpyArray( "mitkImage_view" );
+
+    CPPUNIT_ASSERT_MESSAGE( "An image adopted from a view does not alias the shared image.",
+                            pythonImage->GetVolumeData()->GetData() != m_Image->GetVolumeData()->GetData() );
+    CPPUNIT_ASSERT_MESSAGE( "Compare if images are equal after transfer.",
+                            mitk::Equal( *pythonImage.GetPointer(), *m_Image.GetPointer(), mitk::eps, true ) );
+  }
+
+  void Release_ReferencedView_KeepsLock()
+  {
+    m_PythonService->ShareToPythonAsNumpyArray( m_Image, "mitkImage_view" );
+    m_PythonService->Execute( "mitkImage_other = mitkImage_view", mitk::IPythonService::SINGLE_LINE_COMMAND );
+    CPPUNIT_ASSERT_MESSAGE( "Releasing a view which is referenced elsewhere keeps the lock.",
+                            !m_PythonService->ReleaseSharedNumpyArray( "mitkImage_view" ) );
+    CPPUNIT_ASSERT_MESSAGE( "Releasing the last reference releases the lock.",
+                            m_PythonService->ReleaseSharedNumpyArray( "mitkImage_other" ) );
+    CPPUNIT_ASSERT_MESSAGE( "Releasing an unknown variable fails.",
+                            !m_PythonService->ReleaseSharedNumpyArray( "mitkImage_other" ) );
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkNumpyPython)
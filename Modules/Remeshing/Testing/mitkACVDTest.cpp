@@ -20,7 +20,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkDebugLeaks.h>
 #include <vtkPolyData.h>
 #include <vtkSmartPointer.h>
+#include <chrono>
 #include <sstream>
+#include <thread>
 
 #define _MITK_TEST_FOR_EXCEPTION(STATEMENT, EXCEPTION, MESSAGE) \
   MITK_TEST_OUTPUT_NO_ENDL(<< MESSAGE) \
@@ -86,6 +88,39 @@ static void Remesh_SurfaceIsValid_ReturnsRemeshedSurface(const std::string& file
   MITK_TEST_CONDITION(remeshedSurface.IsNotNull() && remeshedSurface->GetVtkPolyData() != NULL && remeshedSurface->GetVtkPolyData()->GetNumberOfPolys() != 0, "Remesh_SurfaceIsValid_ReturnsRemeshedSurface")
 }
 
+static void RemeshLevelsOfDetailInBackground_SurfaceIsNull_ThrowsException()
+{
+  mitk::Surface::Pointer surface;
+  _MITK_TEST_FOR_EXCEPTION(mitk::ACVD::RemeshLevelsOfDetailInBackground(surface, 0, std::vector<double>(1, 0.1)), mitk::Exception, "RemeshLevelsOfDetailInBackground_SurfaceIsNull_ThrowsException")
+}
+
+static void RemeshLevelsOfDetailInBackground_SurfaceIsValid_AttachesLevelsOfDetail(const std::string& filename, unsigned int t, double gradation, int subsampling, double edgeSplitting, int optimizationLevel, bool forceManifold, bool boundaryFixing)
+{
+  mitk::Surface::Pointer surface = mitk::IOUtil::LoadSurface(filename);
+
+  std::vector<double> fractions;
+  fractions.push_back(0.2);
+  fractions.push_back(0.05);
+  mitk::ACVD::RemeshLevelsOfDetailInBackground(surface, t, fractions, gradation, subsampling, edgeSplitting, optimizationLevel, forceManifold, boundaryFixing);
+
+  MITK_TEST_CONDITION(surface->GetNumberOfLevelsOfDetail(t) >= 1, "The surface itself is available while remeshing")
+
+  for (int i = 0; i < 6000 && surface->GetNumberOfLevelsOfDetail(t) < 3; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+  MITK_TEST_CONDITION_REQUIRED(surface->GetNumberOfLevelsOfDetail(t) == 3, "RemeshLevelsOfDetailInBackground_SurfaceIsValid_AttachesLevelsOfDetail")
+
+  vtkPolyData* coarse = surface->GetLevelOfDetail(0, t);
+  vtkPolyData* medium = surface->GetLevelOfDetail(1, t);
+  vtkPolyData* fine = surface->GetLevelOfDetail(2, t);
+
+  MITK_TEST_CONDITION(fine == surface->GetVtkPolyData(t), "The finest level is the surface itself")
+  MITK_TEST_CONDITION(coarse->GetNumberOfPolys() != 0 && coarse->GetNumberOfPoints() < medium->GetNumberOfPoints() && medium->GetNumberOfPoints() < fine->GetNumberOfPoints(), "Levels are ordered from coarsest to finest")
+
+  surface->GetVtkPolyData(t)->Modified();
+  MITK_TEST_CONDITION(surface->GetNumberOfLevelsOfDetail(t) == 1, "Levels are dropped when the surface is modified")
+}
+
 int mitkACVDTest(int argc, char* argv[])
 {
   if (argc != 10)
@@ -120,5 +155,8 @@ int mitkACVDTest(int argc, char* argv[])
 
     Remesh_SurfaceIsValid_ReturnsRemeshedSurface(filename, t, numVertices, gradation, subsampling, edgeSplitting, optimizationLevel, forceManifold, boundaryFixing);
 
+    RemeshLevelsOfDetailInBackground_SurfaceIsNull_ThrowsException();
+    RemeshLevelsOfDetailInBackground_SurfaceIsValid_AttachesLevelsOfDetail(filename, t, gradation, subsampling, edgeSplitting, optimizationLevel, forceManifold, boundaryFixing);
+
   MITK_TEST_END()
 }
@@ -25,6 +25,16 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkSmartPointer.h>
 #include <vtkSurface.h>
 
+#include <ThreadPoolUtilities.h>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+
 struct ClustersQuadrics
 {
   explicit ClustersQuadrics(int size)
@@ -73,14 +83,12 @@ static void ValidateSurface(mitk::Surface::ConstPointer surface, unsigned int t)
     mitkThrow() << "Input surface has no polygons at time step " << t << "!";
 }
 
-mitk::Surface::Pointer mitk::ACVD::Remesh(mitk::Surface::ConstPointer surface, unsigned int t, int numVertices, double gradation, int subsampling, double edgeSplitting, int optimizationLevel, bool forceManifold, bool boundaryFixing)
+static vtkSmartPointer<vtkPolyData> RemeshPolyData(vtkPolyData* polyData, int numVertices, double gradation, int subsampling, double edgeSplitting, int optimizationLevel, bool forceManifold, bool boundaryFixing)
 {
-  ValidateSurface(surface, t);
-
   MITK_INFO << "Start remeshing...";
 
   vtkSmartPointer<vtkPolyData> surfacePolyData = vtkSmartPointer<vtkPolyData>::New();
-  surfacePolyData->DeepCopy(const_cast<Surface*>(surface.GetPointer())->GetVtkPolyData(t));
+  surfacePolyData->DeepCopy(polyData);
 
   vtkSmartPointer<vtkSurface> mesh = vtkSmartPointer<vtkSurface>::New();
 
@@ -176,14 +184,151 @@ mitk::Surface::Pointer mitk::ACVD::Remesh(mitk::Surface::ConstPointer surface, u
 
   normals->Update();
 
-  Surface::Pointer remeshedSurface = Surface::New();
-  remeshedSurface->SetVtkPolyData(normals->GetOutput());
-
   MITK_INFO << "Finished remeshing";
 
+  return normals->GetOutput();
+}
+
+namespace
+{
+  /** \brief Processes remeshing tasks one after another in a task of the shared thread pool.
+   *
+   * When the module is unloaded, pending tasks are dropped and a running task is told to stop. ACVD itself cannot be
+   * interrupted, so the task only stops before its next level of detail. The destructor waits for it, so that no pool
+   * thread runs code of the module after it was unloaded.
+   */
+  class BackgroundRemesher
+  {
+  public:
+    typedef std::function<void(const std::atomic<bool>&)> TaskType;
+
+    static BackgroundRemesher& GetInstance()
+    {
+      static BackgroundRemesher instance;
+      return instance;
+    }
+
+    void Enqueue(TaskType task)
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+
+      m_Tasks.push_back(std::move(task));
+
+      if (!m_IsProcessing)
+      {
+        m_IsProcessing = true;
+        m_TaskGroup.Enqueue([this] { this->ProcessTasks(); }, Utilities::TaskPriority::LOW);
+      }
+    }
+
+    ~BackgroundRemesher()
+    {
+      m_Abort = true;
+
+      {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Tasks.clear();
+      }
+
+      // drops the pool task if it has not been started yet, waits for it otherwise
+      m_TaskGroup.Stop();
+      m_TaskGroup.WaitAll();
+    }
+
+  private:
+    BackgroundRemesher()
+      : m_Abort(false),
+        m_IsProcessing(false)
+    {
+    }
+
+    void ProcessTasks()
+    {
+      for (;;)
+      {
+        TaskType task;
+
+        {
+          std::lock_guard<std::mutex> lock(m_Mutex);
+
+          if (m_Abort || m_Tasks.empty())
+          {
+            m_IsProcessing = false;
+            return;
+          }
+
+          task = std::move(m_Tasks.front());
+          m_Tasks.pop_front();
+        }
+
+        task(m_Abort);
+      }
+    }
+
+    std::mutex m_Mutex;
+    std::deque<TaskType> m_Tasks;
+    std::atomic<bool> m_Abort;
+    bool m_IsProcessing;
+    Utilities::TaskGroup m_TaskGroup;
+  };
+}
+
+mitk::Surface::Pointer mitk::ACVD::Remesh(mitk::Surface::ConstPointer surface, unsigned int t, int numVertices, double gradation, int subsampling, double edgeSplitting, int optimizationLevel, bool forceManifold, bool boundaryFixing)
+{
+  ValidateSurface(surface, t);
+
+  vtkPolyData* polyData = const_cast<Surface*>(surface.GetPointer())->GetVtkPolyData(t);
+
+  Surface::Pointer remeshedSurface = Surface::New();
+  remeshedSurface->SetVtkPolyData(RemeshPolyData(polyData, numVertices, gradation, subsampling, edgeSplitting, optimizationLevel, forceManifold, boundaryFixing));
+
   return remeshedSurface;
 }
 
+void mitk::ACVD::RemeshLevelsOfDetailInBackground(Surface::Pointer surface, unsigned int t, std::vector<double> fractions, double gradation, int subsampling, double edgeSplitting, int optimizationLevel, bool forceManifold, bool boundaryFixing)
+{
+  ValidateSurface(surface.GetPointer(), t);
+
+  fractions.erase(std::remove_if(fractions.begin(), fractions.end(), [](double fraction) { return fraction <= 0.0 || fraction >= 1.0; }), fractions.end());
+  std::sort(fractions.begin(), fractions.end());
+
+  if (fractions.empty())
+    return;
+
+  // the background task must not access the surface
+  vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+  polyData->DeepCopy(surface->GetVtkPolyData(t));
+
+  typedef std::promise< vtkSmartPointer<vtkPolyData> > PromiseType;
+  std::shared_ptr< std::vector<PromiseType> > promises = std::make_shared< std::vector<PromiseType> >(fractions.size());
+
+  std::vector<Surface::LevelOfDetailFuture> levels;
+  for (auto& promise : *promises)
+    levels.push_back(promise.get_future());
+
+  surface->SetLevelsOfDetail(std::move(levels), t);
+
+  BackgroundRemesher::GetInstance().Enqueue([=](const std::atomic<bool>& abort)
+  {
+    const double numPoints = static_cast<double>(polyData->GetNumberOfPoints());
+
+    // levels that are not computed due to an abort report a broken promise
+    for (std::size_t i = 0; i < fractions.size() && !abort; ++i)
+    {
+      try
+      {
+        const int numVertices = std::max(4, static_cast<int>(fractions[i] * numPoints));
+        (*promises)[i].set_value(RemeshPolyData(polyData, numVertices, gradation, subsampling, edgeSplitting, optimizationLevel, forceManifold, boundaryFixing));
+      }
+      catch (...)
+      {
+        (*promises)[i].set_exception(std::current_exception());
+      }
+    }
+  });
+}
+
+
 mitk::ACVD::RemeshFilter::RemeshFilter()
 : m_TimeStep(0),
   m_NumVertices(0),
@@ -21,6 +21,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkSurfaceToSurfaceFilter.h>
 #include <MitkRemeshingExports.h>
 
+#include <vector>
+
 namespace mitk
 {
   namespace ACVD
@@ -51,6 +53,21 @@ namespace mitk
      */
     MITKREMESHING_EXPORT Surface::Pointer Remesh(Surface::ConstPointer surface, unsigned int t, int numVertices, double gradation, int subsampling = 10, double edgeSplitting = 0.0, int optimizationLevel = 1, bool forceManifold = false, bool boundaryFixing = false);
 
+    /** \brief Remesh a surface to a chain of levels of detail in the background and attach them to the surface.
+     *
+     * The polydata at time step t is copied and remeshed in a task of the shared thread pool to the given fractions of its
+     * vertex count, starting with the coarsest level. The levels are attached to the surface via
+     * Surface::SetLevelsOfDetail() and become available one after another, so mappers can already render a coarse
+     * level while the finer ones are computed. Requests are processed one after another, as the remeshing itself is
+     * multithreaded. See Remesh() for the remaining parameters.
+     *
+     * \param[in] surface Input surface, the levels of detail are attached to it.
+     * \param[in] t Time step of a four-dimensional input surface, zero otherwise.
+     * \param[in] fractions Fractions of the vertex count of the levels, e.g. 0.05 and 0.2. The surface itself is the finest level, fractions of one or more are ignored.
+     * \exception mitk::Exception if the input surface is invalid.
+     */
+    MITKREMESHING_EXPORT void RemeshLevelsOfDetailInBackground(Surface::Pointer surface, unsigned int t, std::vector<double> fractions, double gradation = 0.0, int subsampling = 10, double edgeSplitting = 0.0, int optimizationLevel = 1, bool forceManifold = false, bool boundaryFixing = false);
+
     /** \brief Encapsulates mitk::ACVD::Remesh function as filter.
      */
     class MITKREMESHING_EXPORT RemeshFilter : public mitk::SurfaceToSurfaceFilter
@@ -21,7 +21,10 @@ namespace mitk {
 
   ImageRegistrationMethod::ImageRegistrationMethod()
   : m_Interpolator(0),
-    m_MultiResolutionScales(1)
+    m_MultiResolutionScales(1),
+    m_SamplingPercentage(1.0),
+    m_EarlyStoppingPatience(0),
+    m_EarlyStoppingTolerance(0.0)
   {
     m_ReferenceImage = Image::New();
     m_OptimizerScales.clear();
@@ -99,4 +102,17 @@ namespace mitk {
     m_MultiResolutionScales = levels;
   }
 
+  void ImageRegistrationMethod::SetSamplingPercentage(double samplingPercentage)
+  {
+    m_SamplingPercentage = samplingPercentage;
+    this->Modified();
+  }
+
+  void ImageRegistrationMethod::SetEarlyStopping(unsigned int patience, double relativeTolerance)
+  {
+    m_EarlyStoppingPatience = patience;
+    m_EarlyStoppingTolerance = relativeTolerance;
+    this->Modified();
+  }
+
 } // end namespace
@@ -76,6 +76,19 @@ namespace mitk
 
     void SetNumberOfLevels( unsigned int levels );
 
+    /**
+    \brief Sets the fraction of fixed image voxels the metric is evaluated on, applied on every level.
+    The default of 1.0 keeps the sampling configured by the metric parameters. See MetricParameters::SetSamplingPercentage().
+    */
+    void SetSamplingPercentage( double samplingPercentage );
+
+    /**
+    \brief Stops each level once the metric changed less than the relative tolerance within the given
+    number of iterations. A patience of 0 (the default) disables early stopping.
+    See RigidRegistrationObserver::SetEarlyStopping().
+    */
+    void SetEarlyStopping( unsigned int patience, double relativeTolerance );
+
   protected:
     ImageRegistrationMethod();
     virtual ~ImageRegistrationMethod();
@@ -97,6 +110,9 @@ namespace mitk
     itk::Array<double> m_OptimizerScales;
 
     unsigned int m_MultiResolutionScales;
+    double m_SamplingPercentage;
+    unsigned int m_EarlyStoppingPatience;
+    double m_EarlyStoppingTolerance;
   };
 }
 
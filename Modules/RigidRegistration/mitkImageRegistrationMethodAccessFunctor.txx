@@ -16,6 +16,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkImageRegistrationMethodAccessFunctor.h"
 #include "mitkImageRegistrationMethod.h"
+#include "mitkMetricFactory.h"
 
 #include <mitkImageCast.h>
 
@@ -24,6 +25,50 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 namespace mitk {
 
+/**
+\brief Restricts the metric to the sampling percentage at the start of every level, based on the
+size of the fixed image of that level.
+*/
+template <class TRegistration>
+class ImageRegistrationSamplingCommand : public itk::Command
+{
+public:
+  typedef ImageRegistrationSamplingCommand Self;
+  typedef itk::Command Superclass;
+  typedef itk::SmartPointer<Self> Pointer;
+  itkNewMacro(Self);
+
+  double m_SamplingPercentage;
+
+  void Execute(itk::Object * object, const itk::EventObject & event) override
+  {
+    if( !(itk::IterationEvent().CheckEvent( &event )) )
+    {
+      return;
+    }
+
+    TRegistration* registration = dynamic_cast<TRegistration*>(object);
+    if (registration == nullptr)
+    {
+      return;
+    }
+
+    typedef typename TRegistration::FixedImageType FixedImageType;
+    const unsigned long level = registration->GetCurrentLevel();
+    const itk::SizeValueType numberOfPixels =
+      registration->GetFixedImagePyramid()->GetOutput(level)->GetLargestPossibleRegion().GetNumberOfPixels();
+    MetricFactory<typename FixedImageType::PixelType, FixedImageType::ImageDimension>::ConfigureSampling(
+      registration->GetMetric(), m_SamplingPercentage, numberOfPixels);
+  }
+
+  void Execute(const itk::Object *, const itk::EventObject & ) override
+  {
+  }
+
+protected:
+  ImageRegistrationSamplingCommand() : m_SamplingPercentage(1.0) {}
+};
+
 template<typename TPixel, unsigned int VImageDimension>
 void ImageRegistrationMethodAccessFunctor::AccessItkImage(const itk::Image<TPixel, VImageDimension>* itkImage1,
                                                           ImageRegistrationMethod* method)
@@ -142,6 +187,23 @@ void ImageRegistrationMethodAccessFunctor::AccessItkImage(const itk::Image<TPixe
   }
 
 
+  // the metric keeps its own sampling configuration unless a subset of the voxels was requested
+  if (method->m_SamplingPercentage < 1.0)
+  {
+    typename ImageRegistrationSamplingCommand<RegistrationType>::Pointer samplingCommand =
+      ImageRegistrationSamplingCommand<RegistrationType>::New();
+    samplingCommand->m_SamplingPercentage = method->m_SamplingPercentage;
+    registration->AddObserver( itk::IterationEvent(), samplingCommand );
+  }
+
+  // early stopping is done by the observer, so create one if none was given
+  if (method->m_EarlyStoppingPatience > 0)
+  {
+    if (method->m_Observer.IsNull())
+      method->m_Observer = RigidRegistrationObserver::New();
+    method->m_Observer->SetEarlyStopping(method->m_EarlyStoppingPatience, method->m_EarlyStoppingTolerance);
+  }
+
   // registering command observer with the optimizer
   unsigned int pyramid_observer_tag = 0;
   if (method->m_Observer.IsNotNull())
@@ -68,6 +68,16 @@ namespace mitk {
     */
     MetricPointer GetMetric( );
 
+    /**
+    \brief Restricts the evaluation of the given metric to a random subset of the fixed image region.
+
+    \a numberOfPixels is the size of the fixed image region the metric will be initialized with, e.g. the
+    size of the current pyramid level. A \a samplingPercentage of 1.0 (or a subset that would not be smaller
+    than the region) switches back to evaluation over all pixels. The random generator is seeded with a
+    fixed value so that consecutive runs with the same settings produce identical results.
+    */
+    static void ConfigureSampling(MetricType* metric, double samplingPercentage, itk::SizeValueType numberOfPixels);
+
     /**
     \brief Sets the instance to the metric parameters class which holds all parameters for the new metric.
     */
@@ -88,6 +98,8 @@ namespace mitk {
     MetricFactory();
     ~MetricFactory() {};
 
+    MetricPointer CreateMetric( );
+
     MetricParameters::Pointer m_MetricParameters;
   };
 
@@ -42,6 +42,41 @@ namespace mitk {
     typename MetricFactory< TPixelType, VImageDimension>::MetricPointer
     MetricFactory<TPixelType, VImageDimension>
     ::GetMetric( )
+  {
+    MetricPointer metric = this->CreateMetric();
+    if (metric.IsNotNull() && m_MetricParameters->GetNumberOfThreads() > 0)
+    {
+      metric->SetNumberOfThreads(m_MetricParameters->GetNumberOfThreads());
+    }
+    return metric;
+  }
+
+  template < class TPixelType, unsigned int VImageDimension >
+    void MetricFactory<TPixelType, VImageDimension>
+    ::ConfigureSampling(MetricType* metric, double samplingPercentage, itk::SizeValueType numberOfPixels)
+  {
+    if (metric == nullptr)
+    {
+      return;
+    }
+
+    const itk::SizeValueType numberOfSamples = static_cast<itk::SizeValueType>(samplingPercentage * numberOfPixels);
+    if (samplingPercentage >= 1.0 || numberOfSamples == 0 || numberOfSamples >= numberOfPixels)
+    {
+      metric->UseAllPixelsOn();
+      return;
+    }
+
+    metric->UseAllPixelsOff();
+    metric->SetUseSequentialSampling(false);
+    metric->SetNumberOfFixedImageSamples(numberOfSamples);
+    metric->ReinitializeSeed( 76926294 );
+  }
+
+  template < class TPixelType, unsigned int VImageDimension >
+    typename MetricFactory< TPixelType, VImageDimension>::MetricPointer
+    MetricFactory<TPixelType, VImageDimension>
+    ::CreateMetric( )
   {
     int metric = m_MetricParameters->GetMetric();
     if (metric == MetricParameters::MEANSQUARESIMAGETOIMAGEMETRIC)
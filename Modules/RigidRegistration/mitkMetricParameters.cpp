@@ -45,7 +45,9 @@ namespace mitk {
     m_MovingImageStandardDeviationMutualInformation(0.4),
     m_UseNormalizerAndSmootherMutualInformation(true),
     m_FixedSmootherVarianceMutualInformation(0.2),
-    m_MovingSmootherVarianceMutualInformation(0.2)
+    m_MovingSmootherVarianceMutualInformation(0.2),
+    m_SamplingPercentage(1.0),
+    m_NumberOfThreads(0)
   {
 
   }
@@ -232,6 +232,30 @@ namespace mitk {
     */
     itkGetMacro( MovingSmootherVarianceMutualInformation, float );
 
+    /**
+    \brief Sets the fraction (0,1] of fixed image voxels the metric is evaluated on.
+
+    The default of 1.0 leaves the sampling of the metric as it is configured otherwise, e.g. the number
+    of spatial samples of the Mattes mutual information. Smaller values make the metric draw a
+    reproducible random subset of that size from the fixed image region on every initialization,
+    which is respected by the multi-threaded itk::MeanSquaresImageToImageMetric and
+    itk::MattesMutualInformationImageToImageMetric.
+    */
+    itkSetClampMacro( SamplingPercentage, double, 0.0001, 1.0 );
+    /**
+    \brief Returns the fraction of fixed image voxels the metric is evaluated on.
+    */
+    itkGetMacro( SamplingPercentage, double );
+
+    /**
+    \brief Sets the number of threads used to evaluate metric value and derivative. 0 keeps the ITK default.
+    */
+    itkSetMacro( NumberOfThreads, unsigned int );
+    /**
+    \brief Returns the number of threads used to evaluate metric value and derivative.
+    */
+    itkGetMacro( NumberOfThreads, unsigned int );
+
   protected:
     MetricParameters();
     ~MetricParameters() {};
@@ -261,6 +285,9 @@ namespace mitk {
     bool m_UseNormalizerAndSmootherMutualInformation;
     float m_FixedSmootherVarianceMutualInformation;
     float m_MovingSmootherVarianceMutualInformation;
+    // sampling and threading, valid for all metrics derived from itk::ImageToImageMetric
+    double m_SamplingPercentage;
+    unsigned int m_NumberOfThreads;
   };
 
 } // namespace mitk
@@ -118,6 +118,42 @@ namespace mitk
     itkSetMacro(BlurFixedImage, bool);
     itkSetMacro(BlurMovingImage, bool);
 
+    /**
+    \brief Sets the fraction of fixed image voxels the metric is evaluated on, one entry per pyramid level.
+
+    Levels without an entry reuse the last given rate. An empty list (the default) uses the sampling
+    percentage of the metric parameters on every level. The sampling of the metric is only changed if
+    at least one rate is below 1.0. See MetricParameters::SetSamplingPercentage().
+    */
+    void SetSamplingRates(const std::vector<double>& samplingRates)
+    {
+      m_SamplingRates = samplingRates;
+      this->Modified();
+    }
+
+    const std::vector<double>& GetSamplingRates() const
+    {
+      return m_SamplingRates;
+    }
+
+    /**
+    \brief Sets the number of threads the metric uses to evaluate value and derivative. 0 keeps the ITK default.
+    */
+    itkSetMacro(NumberOfMetricThreads, unsigned int);
+    itkGetMacro(NumberOfMetricThreads, unsigned int);
+
+    /**
+    \brief Stops each pyramid level once the metric changed less than the relative tolerance within
+    the given number of iterations. A patience of 0 (the default) disables early stopping.
+    See RigidRegistrationObserver::SetEarlyStopping().
+    */
+    void SetEarlyStopping(unsigned int patience, double relativeTolerance)
+    {
+      m_EarlyStoppingPatience = patience;
+      m_EarlyStoppingTolerance = relativeTolerance;
+      this->Modified();
+    }
+
 
   protected:
     PyramidalRegistrationMethod();
@@ -146,6 +182,10 @@ namespace mitk
     itk::Array2D<unsigned int> m_FixedSchedule;
     itk::Array2D<unsigned int> m_MovingSchedule;
 
+    std::vector<double> m_SamplingRates;
+    unsigned int m_NumberOfMetricThreads;
+    unsigned int m_EarlyStoppingPatience;
+    double m_EarlyStoppingTolerance;
 
     bool m_UseMask;
     bool m_MatchHistograms;
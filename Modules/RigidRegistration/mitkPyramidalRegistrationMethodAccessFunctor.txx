@@ -23,6 +23,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkMultiResolutionImageRegistrationMethod.h>
 #include <itkRescaleIntensityImageFilter.h>
 #include <itkHistogramMatchingImageFilter.h>
+#include <itkTimeProbe.h>
+
+#include <algorithm>
 
 #include "mitkMetricFactory.h"
 #include "mitkTransformFactory.h"
@@ -67,6 +70,7 @@ void PyramidalRegistrationMethodAccessFunctor::AccessItkImage(const itk::Image<T
   method->m_TransformParameters = method->ParseTransformParameters(transformValues);
   method->m_MetricParameters = method->ParseMetricParameters(metricValues);
   method->m_OptimizerParameters = method->ParseOptimizerParameters(optimizerValues);
+  method->m_MetricParameters->SetNumberOfThreads(method->m_NumberOfMetricThreads);
 
 
   // The fixed and the moving image
@@ -202,6 +206,14 @@ void PyramidalRegistrationMethodAccessFunctor::AccessItkImage(const itk::Image<T
     registration->GetMetric()->SetFixedImageMask(mask);
   }
 
+  // early stopping is done by the observer, so create one if none was given
+  if (method->m_EarlyStoppingPatience > 0)
+  {
+    if (method->m_Observer.IsNull())
+      method->m_Observer = RigidRegistrationObserver::New();
+    method->m_Observer->SetEarlyStopping(method->m_EarlyStoppingPatience, method->m_EarlyStoppingTolerance);
+  }
+
   // registering command observer with the optimizer
   if (method->m_Observer.IsNotNull())
   {
@@ -216,14 +228,24 @@ void PyramidalRegistrationMethodAccessFunctor::AccessItkImage(const itk::Image<T
   command->m_Presets = method->m_Presets;
   command->m_UseMask = method->m_UseMask;
   command->m_BrainMask = method->m_BrainMask;
+  // the metric keeps its own sampling configuration unless a subset of the voxels was requested for some level
+  std::vector<double> samplingRates = method->m_SamplingRates;
+  if (samplingRates.empty())
+    samplingRates.push_back(method->m_MetricParameters->GetSamplingPercentage());
+  if (*std::min_element(samplingRates.begin(), samplingRates.end()) < 1.0)
+    command->m_SamplingRates = samplingRates;
 
   registration->AddObserver( itk::IterationEvent(), command );
   registration->SetSchedules(method->m_FixedSchedule, method->m_MovingSchedule);
 
   // Start the registration process
+  itk::TimeProbe registrationTime;
   try
   {
+    registrationTime.Start();
     registration->Update();
+    registrationTime.Stop();
+    MITK_INFO << "Pyramidal registration finished after " << registrationTime.GetTotal() << " s";
   }
   catch( itk::ExceptionObject & err )
   {
@@ -49,8 +49,30 @@ namespace mitk {
     mitk::RigidRegistrationObserver::Pointer observer;
     bool m_UseMask;
     std::vector<std::string> m_Presets;
+    std::vector<double> m_SamplingRates;
     MaskType::Pointer m_BrainMask;
 
+    /**
+    \brief Restricts the metric to the sampling rate configured for the level the registration is about to start.
+
+    Must be called before the registration initializes the metric for that level.
+    */
+    void ConfigureMetricSampling(RegistrationPointer registration)
+    {
+      if (m_SamplingRates.empty())
+      {
+        return;
+      }
+
+      const unsigned long level = registration->GetCurrentLevel();
+      const double samplingRate = m_SamplingRates[std::min<std::size_t>(level, m_SamplingRates.size() - 1)];
+      const itk::SizeValueType numberOfPixels =
+        registration->GetFixedImagePyramid()->GetOutput(level)->GetLargestPossibleRegion().GetNumberOfPixels();
+
+      mitk::MetricFactory<float, 3>::ConfigureSampling(registration->GetMetric(), samplingRate, numberOfPixels);
+      MITK_INFO << "Level " << level << ": evaluating metric on " << samplingRate * 100.0 << "% of " << numberOfPixels << " voxels";
+    }
+
     void Execute(itk::Object * object, const itk::EventObject & event) override
     {
       if( !(itk::IterationEvent().CheckEvent( &event )) )
@@ -69,6 +91,8 @@ namespace mitk {
       std::cout << "MultiResolution Level : "
                 << registration->GetCurrentLevel()  << std::endl << std::endl;
 
+      this->ConfigureMetricSampling(registration);
+
 
       if ( registration->GetCurrentLevel() == 0 )
       {
@@ -17,11 +17,55 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkRigidRegistrationObserver.h"
 #include "mitkProgressBar.h"
 
-mitk::RigidRegistrationObserver::RigidRegistrationObserver() : m_OptimizerValue(0), m_StopOptimization(false)
+#include <algorithm>
+#include <cmath>
+
+mitk::RigidRegistrationObserver::RigidRegistrationObserver() : m_OptimizerValue(0), m_StopOptimization(false),
+  m_EarlyStoppingPatience(0), m_EarlyStoppingTolerance(0.0), m_BestOptimizerValue(0), m_LastIteration(0),
+  m_IterationsWithoutImprovement(0)
 {
 
 }
 
+void mitk::RigidRegistrationObserver::SetEarlyStopping(unsigned int patience, double relativeTolerance)
+{
+  m_EarlyStoppingPatience = patience;
+  m_EarlyStoppingTolerance = relativeTolerance;
+  m_IterationsWithoutImprovement = 0;
+}
+
+void mitk::RigidRegistrationObserver::UpdateEarlyStopping(unsigned int iteration)
+{
+  if (m_EarlyStoppingPatience == 0)
+    return;
+
+  // a new optimizer run (e.g. the next pyramid level) restarts the iteration count
+  if (iteration <= m_LastIteration)
+  {
+    m_BestOptimizerValue = m_OptimizerValue;
+    m_IterationsWithoutImprovement = 0;
+  }
+  m_LastIteration = iteration;
+
+  // metrics may be maximized or minimized, so only the magnitude of the change counts
+  const double change = std::abs(m_OptimizerValue - m_BestOptimizerValue);
+  const double scale = std::max(std::abs(m_BestOptimizerValue), 1e-12);
+  if (change / scale > m_EarlyStoppingTolerance)
+  {
+    m_BestOptimizerValue = m_OptimizerValue;
+    m_IterationsWithoutImprovement = 0;
+    return;
+  }
+
+  if (++m_IterationsWithoutImprovement >= m_EarlyStoppingPatience)
+  {
+    MITK_INFO << "Metric changed less than " << m_EarlyStoppingTolerance << " over the last "
+              << m_EarlyStoppingPatience << " iterations, stopping optimization.";
+    m_StopOptimization = true;
+    m_IterationsWithoutImprovement = 0;
+  }
+}
+
 void mitk::RigidRegistrationObserver::HandleOptimizationIterationEvent(OptimizerType *optimizer)
 {
   unsigned int iteration = 0;
@@ -35,6 +79,7 @@ void mitk::RigidRegistrationObserver::HandleOptimizationIterationEvent(Optimizer
 
     MITK_INFO << "("<< iteration << ") "   << m_OptimizerValue << " :: "<<  m_Params << std::endl;
 
+    this->UpdateEarlyStopping(iteration);
     if( this->m_StopOptimization )
     {
       rsgdbase->StopOptimization();
@@ -52,6 +97,7 @@ void mitk::RigidRegistrationObserver::HandleOptimizationIterationEvent(Optimizer
 
     MITK_INFO << "("<< iteration << ") "   << m_OptimizerValue << " :: "<<  m_Params << std::endl;
 
+    this->UpdateEarlyStopping(iteration);
     if( this->m_StopOptimization )
     {
       gdbase->StopOptimization();
@@ -69,6 +115,7 @@ void mitk::RigidRegistrationObserver::HandleOptimizationIterationEvent(Optimizer
 
     MITK_INFO << "("<< iteration << ") "   << m_OptimizerValue << " :: "<<  m_Params << std::endl;
 
+    this->UpdateEarlyStopping(iteration);
     if( this->m_StopOptimization )
     {
       powbase->StopOptimization();
@@ -86,9 +133,10 @@ void mitk::RigidRegistrationObserver::HandleOptimizationIterationEvent(Optimizer
 
     MITK_INFO << "("<< iteration << ") "   << m_OptimizerValue << " :: "<<  m_Params << std::endl;
 
+    this->UpdateEarlyStopping(iteration);
     if( this->m_StopOptimization )
     {
-      powbase->StopOptimization();
+      opluso->StopOptimization();
       m_StopOptimization = false;
     }
     return;
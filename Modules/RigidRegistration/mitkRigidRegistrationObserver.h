@@ -118,16 +118,34 @@ namespace mitk {
       */
       void SetStopOptimization(bool stopOptimization);
 
+      /**
+      * \brief Stops the optimization early once the metric value did not change by more than \a relativeTolerance
+      * within \a patience consecutive iterations.
+      *
+      * The check is restarted whenever the optimizer starts a new run, e.g. on every level of a pyramidal registration.
+      * A patience of 0 (the default) disables early stopping. Relies on the same StopOptimization() support as
+      * SetStopOptimization().
+      */
+      void SetEarlyStopping(unsigned int patience, double relativeTolerance);
+
     protected:
       RigidRegistrationObserver();
 
       void HandleOptimizationIterationEvent(OptimizerType *optimizer );
 
+      void UpdateEarlyStopping(unsigned int iteration);
+
   private:
     double m_OptimizerValue;
     itk::Array<double> m_Params;
     bool m_StopOptimization;
 
+    unsigned int m_EarlyStoppingPatience;
+    double m_EarlyStoppingTolerance;
+    double m_BestOptimizerValue;
+    unsigned int m_LastIteration;
+    unsigned int m_IterationsWithoutImprovement;
+
   };
 
   template < class RegistrationType >
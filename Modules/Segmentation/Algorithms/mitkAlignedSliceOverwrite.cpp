@@ -0,0 +1,339 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkAlignedSliceOverwrite.h"
+
+#include <mitkAbstractTransformGeometry.h>
+#include <mitkImageAccessLock.h>
+#include <mitkImageRegionAccessor.h>
+#include <mitkPlaneClipping.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+
+namespace
+{
+  // largest distance of a slice pixel to a voxel center (in voxels) that still counts as on the voxel grid
+  const double GridTolerance = 1e-3;
+
+  // number of slices whose strided rows are written interleaved
+  const long SliceBlockSize = 16;
+
+  struct SlicePointers
+  {
+    char* Volume;
+    const char* Slice;
+    char* Original;
+  };
+
+  bool GetUnitStep(const mitk::Vector3D& step, unsigned int& axis, int& direction)
+  {
+    axis = 0;
+    for (unsigned int d = 1; d < 3; ++d)
+    {
+      if (std::abs(step[d]) > std::abs(step[axis]))
+      {
+        axis = d;
+      }
+    }
+    for (unsigned int d = 0; d < 3; ++d)
+    {
+      if (std::abs(std::abs(step[d]) - (d == axis ? 1.0 : 0.0)) > GridTolerance)
+      {
+        return false;
+      }
+    }
+    direction = step[axis] > 0 ? 1 : -1;
+    return true;
+  }
+
+  template <std::size_t VPixelSize>
+  inline void CopyPixel(char* target, const char* source, std::size_t pixelSize)
+  {
+    std::memcpy(target, source, VPixelSize > 0 ? VPixelSize : pixelSize);
+  }
+
+  // slice rows that are contiguous in the volume, one memcpy per row
+  void WriteContiguousRows(const std::vector<SlicePointers>& slices, long sizeX, long sizeY, std::ptrdiff_t yStride, std::size_t pixelSize)
+  {
+    const long numberOfRows = static_cast<long>(slices.size()) * sizeY;
+    const std::size_t rowSize = sizeX * pixelSize;
+
+#pragma omp parallel for
+    for (long row = 0; row < numberOfRows; ++row)
+    {
+      const SlicePointers& slice = slices[row / sizeY];
+      const long y = row % sizeY;
+      char* voxel = slice.Volume + y * yStride;
+      std::memcpy(slice.Original + y * rowSize, voxel, rowSize);
+      std::memcpy(voxel, slice.Slice + y * rowSize, rowSize);
+    }
+  }
+
+  // slice rows that are strided in the volume, the voxels of neighboring slices are written next to each other
+  template <std::size_t VPixelSize>
+  void WriteStridedRows(const std::vector<SlicePointers>& slices, long sizeX, long sizeY, std::ptrdiff_t xStride, std::ptrdiff_t yStride, std::size_t pixelSize)
+  {
+    const long numberOfSlices = static_cast<long>(slices.size());
+
+#pragma omp parallel for
+    for (long y = 0; y < sizeY; ++y)
+    {
+      for (long blockBegin = 0; blockBegin < numberOfSlices; blockBegin += SliceBlockSize)
+      {
+        const long blockEnd = std::min(numberOfSlices, blockBegin + SliceBlockSize);
+        for (long x = 0; x < sizeX; ++x)
+        {
+          const std::ptrdiff_t voxelOffset = y * yStride + x * xStride;
+          const std::ptrdiff_t pixelOffset = (y * sizeX + x) * pixelSize;
+          for (long k = blockBegin; k < blockEnd; ++k)
+          {
+            char* voxel = slices[k].Volume + voxelOffset;
+            CopyPixel<VPixelSize>(slices[k].Original + pixelOffset, voxel, pixelSize);
+            CopyPixel<VPixelSize>(voxel, slices[k].Slice + pixelOffset, pixelSize);
+          }
+        }
+      }
+    }
+  }
+}
+
+mitk::AlignedSliceOverwrite::AlignedSliceOverwrite()
+{
+}
+
+mitk::AlignedSliceOverwrite::~AlignedSliceOverwrite()
+{
+}
+
+bool mitk::AlignedSliceOverwrite::ComputeMapping(const Image* volume, const PlaneGeometry* plane, unsigned int timeStep, const Image* slice, SliceMapping& mapping)
+{
+  if (!volume || !plane || !slice || volume->GetDimension() < 3 || timeStep >= volume->GetTimeSteps()
+      || dynamic_cast<const AbstractTransformGeometry*>(plane) || !(slice->GetPixelType() == volume->GetPixelType()))
+  {
+    return false;
+  }
+  const BaseGeometry* geometry = volume->GetTimeGeometry()->GetGeometryForTimeStep(timeStep);
+  if (!geometry)
+  {
+    return false;
+  }
+
+  // output grid of ExtractSliceFilter with SetInPlaneResampleExtentByGeometry(true)
+  const double extent[2] = { plane->GetExtent(0), plane->GetExtent(1) };
+  const double spacing[2] = { plane->GetExtentInMM(0) / extent[0], plane->GetExtentInMM(1) / extent[1] };
+  Vector3D right = plane->GetAxisVector(0);
+  Vector3D bottom = plane->GetAxisVector(1);
+  right.Normalize();
+  bottom.Normalize();
+
+  int xMin = 0;
+  int yMin = 0;
+  int xMax = static_cast<int>(extent[0]);
+  int yMax = static_cast<int>(extent[1]);
+  if (plane->GetReferenceGeometry())
+  {
+    double bounds[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+    if (PlaneClipping::CalculateClippedPlaneBounds(plane->GetReferenceGeometry(), plane, bounds))
+    {
+      xMin = static_cast<int>(bounds[0] / spacing[0] + 0.5);
+      xMax = static_cast<int>(bounds[1] / spacing[0] + 0.5);
+      yMin = static_cast<int>(bounds[2] / spacing[1] + 0.5);
+      yMax = static_cast<int>(bounds[3] / spacing[1] + 0.5);
+    }
+  }
+
+  const int size[2] = { std::max(0, xMax - 1) - xMin + 1, std::max(0, yMax - 1) - yMin + 1 };
+  if (size[0] <= 0 || size[1] <= 0 || slice->GetDimension(0) != static_cast<unsigned int>(size[0])
+      || slice->GetDimension(1) != static_cast<unsigned int>(size[1]) || (slice->GetDimension() > 2 && slice->GetDimension(2) != 1))
+  {
+    return false;
+  }
+
+  // continuous voxel index of the center of slice pixel (x, y)
+  Point3D first = plane->GetOrigin();
+  first += right * (spacing[0] * (xMin + 0.5));
+  first += bottom * (spacing[1] * (yMin + 0.5));
+  auto continuousIndex = [&](double x, double y)
+  {
+    Point3D index;
+    geometry->WorldToIndex(first + right * (spacing[0] * x) + bottom * (spacing[1] * y), index);
+    return index;
+  };
+
+  const Point3D originIndex = continuousIndex(0, 0);
+  if (!GetUnitStep(continuousIndex(1, 0) - originIndex, mapping.XAxis, mapping.XStep)
+      || !GetUnitStep(continuousIndex(0, 1) - originIndex, mapping.YAxis, mapping.YStep) || mapping.XAxis == mapping.YAxis)
+  {
+    return false;
+  }
+  for (unsigned int d = 0; d < 3; ++d)
+  {
+    mapping.Origin[d] = static_cast<IndexType::IndexValueType>(std::floor(originIndex[d] + 0.5));
+  }
+  mapping.Size[0] = size[0];
+  mapping.Size[1] = size[1];
+
+  // the mapping is affine, so if all corners hit their voxel centers and lie inside of the volume, every pixel does
+  for (int cornerY = 0; cornerY < 2; ++cornerY)
+  {
+    for (int cornerX = 0; cornerX < 2; ++cornerX)
+    {
+      const int x = cornerX * (size[0] - 1);
+      const int y = cornerY * (size[1] - 1);
+      const Point3D index = continuousIndex(x, y);
+      for (unsigned int d = 0; d < 3; ++d)
+      {
+        IndexType::IndexValueType expected = mapping.Origin[d];
+        expected += d == mapping.XAxis ? mapping.XStep * x : 0;
+        expected += d == mapping.YAxis ? mapping.YStep * y : 0;
+        if (std::abs(index[d] - expected) > GridTolerance || expected < 0 || expected >= static_cast<IndexType::IndexValueType>(volume->GetDimension(d)))
+        {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+void mitk::AlignedSliceOverwrite::SetVolume(Image* volume)
+{
+  m_Volume = volume;
+  m_Slices.clear();
+  m_OriginalSlices.clear();
+  this->Modified();
+}
+
+bool mitk::AlignedSliceOverwrite::AddSlice(Image* slice, const PlaneGeometry* plane, unsigned int timeStep)
+{
+  SliceEntry entry;
+  if (!ComputeMapping(m_Volume, plane, timeStep, slice, entry.Mapping))
+  {
+    return false;
+  }
+  entry.Slice = slice;
+  entry.TimeStep = timeStep;
+  m_Slices.push_back(entry);
+  this->Modified();
+  return true;
+}
+
+bool mitk::AlignedSliceOverwrite::CanJoinBatch(std::size_t batchBegin, std::size_t index) const
+{
+  const SliceEntry& first = m_Slices[batchBegin];
+  const SliceEntry& entry = m_Slices[index];
+  if (entry.TimeStep != first.TimeStep || entry.Mapping.XAxis != first.Mapping.XAxis || entry.Mapping.YAxis != first.Mapping.YAxis
+      || entry.Mapping.XStep != first.Mapping.XStep || entry.Mapping.YStep != first.Mapping.YStep
+      || entry.Mapping.Size[0] != first.Mapping.Size[0] || entry.Mapping.Size[1] != first.Mapping.Size[1]
+      || entry.Mapping.Origin[first.Mapping.XAxis] != first.Mapping.Origin[first.Mapping.XAxis]
+      || entry.Mapping.Origin[first.Mapping.YAxis] != first.Mapping.Origin[first.Mapping.YAxis])
+  {
+    return false;
+  }
+
+  // slices of a batch are written in any order, so they must not share voxels
+  const unsigned int normalAxis = 3 - first.Mapping.XAxis - first.Mapping.YAxis;
+  for (std::size_t i = batchBegin; i < index; ++i)
+  {
+    if (m_Slices[i].Mapping.Origin[normalAxis] == entry.Mapping.Origin[normalAxis])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+void mitk::AlignedSliceOverwrite::Write()
+{
+  m_OriginalSlices.clear();
+  if (m_Volume.IsNull() || m_Slices.empty())
+  {
+    return;
+  }
+
+  const std::size_t pixelSize = m_Volume->GetPixelType().GetSize();
+  const std::ptrdiff_t axisStride[3] = { static_cast<std::ptrdiff_t>(pixelSize),
+    static_cast<std::ptrdiff_t>(pixelSize * m_Volume->GetDimension(0)),
+    static_cast<std::ptrdiff_t>(pixelSize * m_Volume->GetDimension(0) * m_Volume->GetDimension(1)) };
+
+  // the originals start as copies of the slices and receive the replaced voxels
+  std::vector< std::unique_ptr<ImageRegionAccessor> > accessors;
+  std::vector< std::unique_ptr<ImageAccessLock> > locks;
+  std::vector< SlicePointers > pointers(m_Slices.size());
+  for (std::size_t i = 0; i < m_Slices.size(); ++i)
+  {
+    Image::Pointer original = m_Slices[i].Slice->Clone();
+    m_OriginalSlices.push_back(original);
+
+    accessors.emplace_back(new ImageRegionAccessor(m_Slices[i].Slice));
+    locks.emplace_back(new ImageAccessLock(accessors.back().get()));
+    pointers[i].Slice = static_cast<const char*>(accessors.back()->getData());
+
+    accessors.emplace_back(new ImageRegionAccessor(original));
+    locks.emplace_back(new ImageAccessLock(accessors.back().get(), true));
+    pointers[i].Original = static_cast<char*>(accessors.back()->getData());
+  }
+
+  ImageRegionAccessor volumeAccessor(m_Volume);
+  ImageAccessLock volumeLock(&volumeAccessor, true);
+
+  std::size_t batchBegin = 0;
+  while (batchBegin < m_Slices.size())
+  {
+    std::size_t batchEnd = batchBegin + 1;
+    while (batchEnd < m_Slices.size() && this->CanJoinBatch(batchBegin, batchEnd))
+    {
+      ++batchEnd;
+    }
+
+    const SliceMapping& mapping = m_Slices[batchBegin].Mapping;
+    char* volumeData = static_cast<char*>(volumeAccessor.getData(m_Slices[batchBegin].TimeStep));
+    std::vector< SlicePointers > batch(pointers.begin() + batchBegin, pointers.begin() + batchEnd);
+    for (std::size_t i = batchBegin; i < batchEnd; ++i)
+    {
+      const IndexType& origin = m_Slices[i].Mapping.Origin;
+      batch[i - batchBegin].Volume = volumeData + origin[0] * axisStride[0] + origin[1] * axisStride[1] + origin[2] * axisStride[2];
+    }
+
+    const long sizeX = mapping.Size[0];
+    const long sizeY = mapping.Size[1];
+    const std::ptrdiff_t xStride = mapping.XStep * axisStride[mapping.XAxis];
+    const std::ptrdiff_t yStride = mapping.YStep * axisStride[mapping.YAxis];
+    if (xStride == static_cast<std::ptrdiff_t>(pixelSize))
+    {
+      WriteContiguousRows(batch, sizeX, sizeY, yStride, pixelSize);
+    }
+    else
+    {
+      switch (pixelSize)
+      {
+        case 1: WriteStridedRows<1>(batch, sizeX, sizeY, xStride, yStride, pixelSize); break;
+        case 2: WriteStridedRows<2>(batch, sizeX, sizeY, xStride, yStride, pixelSize); break;
+        case 4: WriteStridedRows<4>(batch, sizeX, sizeY, xStride, yStride, pixelSize); break;
+        case 8: WriteStridedRows<8>(batch, sizeX, sizeY, xStride, yStride, pixelSize); break;
+        default: WriteStridedRows<0>(batch, sizeX, sizeY, xStride, yStride, pixelSize); break;
+      }
+    }
+
+    batchBegin = batchEnd;
+  }
+
+  m_Slices.clear();
+  m_Volume->Modified();
+}
@@ -0,0 +1,108 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkAlignedSliceOverwrite_h_Included
+#define mitkAlignedSliceOverwrite_h_Included
+
+#include <MitkSegmentationExports.h>
+#include <mitkCommon.h>
+#include <mitkImage.h>
+#include <mitkPlaneGeometry.h>
+
+#include <itkObject.h>
+
+#include <vector>
+
+namespace mitk
+{
+
+/**
+  \brief Writes 2D slices that lie on the voxel grid of a volume back without reslicing.
+
+  A slice that was extracted by ExtractSliceFilter (with SetInPlaneResampleExtentByGeometry(true) and
+  the reslice transform of the volume geometry) along a plane that is parallel to two image axes and
+  has the voxel size of the image maps every slice pixel to exactly one voxel. AddSlice() checks this
+  and returns false for every other slice, which then has to be written by mitkVtkImageOverwrite.
+
+  Write() copies all added slices in the order they were added under a single write lock of the volume.
+  Rows along the first image axis are copied with memcpy. Consecutive slices with the same orientation
+  that do not overlap are written together: in parallel row by row, and, if their rows are strided in
+  the volume, interleaved in blocks of neighboring slices so that the voxels written next to each other
+  are also next to each other in memory. The replaced voxels are kept as slices with the geometry of the
+  written slices for undo.
+*/
+class MITKSEGMENTATION_EXPORT AlignedSliceOverwrite : public itk::Object
+{
+  public:
+
+    mitkClassMacroItkParent(AlignedSliceOverwrite, itk::Object);
+    itkFactorylessNewMacro(Self)
+
+    typedef itk::Index<3> IndexType;
+
+    /// \brief Voxel index of slice pixel (x, y) is Origin + x * XStep + y * YStep.
+    struct SliceMapping
+    {
+      IndexType Origin;
+      unsigned int XAxis;
+      unsigned int YAxis;
+      int XStep;
+      int YStep;
+      unsigned int Size[2];
+    };
+
+    /// \brief Computes the voxels that the reslicer overwrites with slice, false if they are not a part of the voxel grid.
+    static bool ComputeMapping(const Image* volume, const PlaneGeometry* plane, unsigned int timeStep, const Image* slice, SliceMapping& mapping);
+
+    /// \brief Sets the volume to write to and removes all slices.
+    void SetVolume(Image* volume);
+
+    /// \brief Adds a slice to be written by Write(), returns false and does not add it if it is not aligned with the volume.
+    bool AddSlice(Image* slice, const PlaneGeometry* plane, unsigned int timeStep);
+
+    unsigned int GetNumberOfSlices() const { return static_cast<unsigned int>(m_Slices.size()); }
+
+    /// \brief Writes all added slices into the volume and removes them.
+    void Write();
+
+    /// \brief The voxels replaced by the last Write(), one slice per written slice in the order they were added.
+    const std::vector< Image::Pointer >& GetOriginalSlices() const { return m_OriginalSlices; }
+
+  protected:
+
+    AlignedSliceOverwrite();
+    virtual ~AlignedSliceOverwrite();
+
+  private:
+
+    struct SliceEntry
+    {
+      Image::Pointer Slice;
+      unsigned int TimeStep;
+      SliceMapping Mapping;
+    };
+
+    /// Whether slice index can be written together with the slices [batchBegin, index), which do not overlap.
+    bool CanJoinBatch(std::size_t batchBegin, std::size_t index) const;
+
+    Image::Pointer m_Volume;
+    std::vector< SliceEntry > m_Slices;
+    std::vector< Image::Pointer > m_OriginalSlices;
+};
+
+} // namespace
+
+#endif
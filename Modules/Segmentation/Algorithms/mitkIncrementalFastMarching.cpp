@@ -0,0 +1,259 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkIncrementalFastMarching.h"
+
+#include <itkNumericTraits.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+  // relative decrease below which an alive point keeps its arrival time, so rounding does not ripple through the result
+  const double AliveDecreaseTolerance = 1e-5;
+}
+
+mitk::IncrementalFastMarching::IncrementalFastMarching()
+: m_SpeedImageUpdateTime(0),
+  m_NumberOfPropagatedSeeds(0),
+  m_NeedsFullMarch(true),
+  m_StoppingValue(static_cast<double>(itk::NumericTraits<float>::max()) / 2.0),
+  m_LargeValue(itk::NumericTraits<float>::max() / 2.0),
+  m_NumberOfMarchedPoints(0)
+{
+}
+
+mitk::IncrementalFastMarching::~IncrementalFastMarching()
+{
+}
+
+void mitk::IncrementalFastMarching::Initialize(const ImageType* referenceImage)
+{
+  m_ArrivalTimes = ImageType::New();
+  m_ArrivalTimes->CopyInformation(referenceImage);
+  m_ArrivalTimes->SetRegions(referenceImage->GetLargestPossibleRegion());
+  m_ArrivalTimes->Allocate();
+
+  m_SpeedImage = nullptr;
+  m_SpeedRegion = RegionType();
+  m_NeedsFullMarch = true;
+  this->Modified();
+}
+
+void mitk::IncrementalFastMarching::SetSpeedImage(const ImageType* speedImage)
+{
+  if (speedImage != m_SpeedImage.GetPointer() || speedImage->GetUpdateMTime() != m_SpeedImageUpdateTime
+      || speedImage->GetBufferedRegion() != m_SpeedRegion)
+  {
+    m_SpeedImage = speedImage;
+    m_SpeedImageUpdateTime = speedImage->GetUpdateMTime();
+    m_SpeedRegion = speedImage->GetBufferedRegion();
+    m_NeedsFullMarch = true;
+    this->Modified();
+  }
+}
+
+void mitk::IncrementalFastMarching::AddSeed(const IndexType& seed)
+{
+  m_Seeds.push_back(seed);
+  this->Modified();
+}
+
+void mitk::IncrementalFastMarching::RemoveLastSeed()
+{
+  if (!m_Seeds.empty())
+  {
+    m_Seeds.pop_back();
+    m_NeedsFullMarch = true;
+    this->Modified();
+  }
+}
+
+void mitk::IncrementalFastMarching::ClearSeeds()
+{
+  m_Seeds.clear();
+  m_NeedsFullMarch = true;
+  this->Modified();
+}
+
+void mitk::IncrementalFastMarching::SetStoppingValue(double value)
+{
+  if (m_StoppingValue != value)
+  {
+    m_StoppingValue = value;
+    this->Modified();
+  }
+}
+
+void mitk::IncrementalFastMarching::InsertTrialPoint(const IndexType& index, float value)
+{
+  if (!m_SpeedRegion.IsInside(index))
+  {
+    return;
+  }
+
+  const itk::OffsetValueType offset = m_ArrivalTimes->ComputeOffset(index);
+  if (value < m_ArrivalTimes->GetBufferPointer()[offset])
+  {
+    m_ArrivalTimes->GetBufferPointer()[offset] = value;
+    m_Labels[offset] = TrialPoint;
+    m_Front.push(FrontNodeType(value, offset));
+  }
+}
+
+float mitk::IncrementalFastMarching::Solve(const IndexType& index) const
+{
+  const double speed = m_SpeedImage->GetPixel(index);
+  if (speed <= 0.0)
+  {
+    return m_LargeValue;
+  }
+
+  // smallest alive neighbor per axis, sorted by arrival time
+  const float* arrivalTimes = m_ArrivalTimes->GetBufferPointer();
+  std::pair< float, unsigned int > neighbors[3];
+  unsigned int numberOfNeighbors = 0;
+  for (unsigned int axis = 0; axis < 3; ++axis)
+  {
+    float smallest = m_LargeValue;
+    for (int step = -1; step <= 1; step += 2)
+    {
+      IndexType neighbor = index;
+      neighbor[axis] += step;
+      if (m_SpeedRegion.IsInside(neighbor))
+      {
+        const itk::OffsetValueType offset = m_ArrivalTimes->ComputeOffset(neighbor);
+        if (m_Labels[offset] == AlivePoint)
+        {
+          smallest = std::min(smallest, arrivalTimes[offset]);
+        }
+      }
+    }
+    if (smallest < m_LargeValue)
+    {
+      neighbors[numberOfNeighbors++] = std::make_pair(smallest, axis);
+    }
+  }
+  std::sort(neighbors, neighbors + numberOfNeighbors);
+
+  // same quadratic as itk::FastMarchingImageFilter::UpdateValue
+  const ImageType::SpacingType& spacing = m_SpeedImage->GetSpacing();
+  double solution = m_LargeValue;
+  double aa = 0.0;
+  double bb = 0.0;
+  double cc = -1.0 / (speed * speed);
+  for (unsigned int i = 0; i < numberOfNeighbors; ++i)
+  {
+    const double value = neighbors[i].first;
+    if (solution < value)
+    {
+      break;
+    }
+
+    const double spaceFactor = 1.0 / (spacing[neighbors[i].second] * spacing[neighbors[i].second]);
+    aa += spaceFactor;
+    bb += value * spaceFactor;
+    cc += value * value * spaceFactor;
+
+    const double discriminant = bb * bb - aa * cc;
+    if (discriminant < 0.0)
+    {
+      break;
+    }
+    solution = (std::sqrt(discriminant) + bb) / aa;
+  }
+
+  return solution < m_LargeValue ? static_cast<float>(solution) : m_LargeValue;
+}
+
+void mitk::IncrementalFastMarching::March()
+{
+  float* arrivalTimes = m_ArrivalTimes->GetBufferPointer();
+
+  while (!m_Front.empty() && m_Front.top().first <= m_StoppingValue)
+  {
+    const FrontNodeType node = m_Front.top();
+    m_Front.pop();
+
+    // skip nodes whose arrival time was lowered after they were queued
+    if (m_Labels[node.second] != TrialPoint || node.first != arrivalTimes[node.second])
+    {
+      continue;
+    }
+    m_Labels[node.second] = AlivePoint;
+    ++m_NumberOfMarchedPoints;
+
+    const IndexType index = m_ArrivalTimes->ComputeIndex(node.second);
+    for (unsigned int axis = 0; axis < 3; ++axis)
+    {
+      for (int step = -1; step <= 1; step += 2)
+      {
+        IndexType neighbor = index;
+        neighbor[axis] += step;
+        if (!m_SpeedRegion.IsInside(neighbor))
+        {
+          continue;
+        }
+
+        // alive points are only lowered by seeds that were added later, never by a later point
+        const itk::OffsetValueType offset = m_ArrivalTimes->ComputeOffset(neighbor);
+        if (m_Labels[offset] == AlivePoint && arrivalTimes[offset] <= node.first)
+        {
+          continue;
+        }
+
+        const float value = this->Solve(neighbor);
+        if (m_Labels[offset] != AlivePoint || value < arrivalTimes[offset] * (1.0 - AliveDecreaseTolerance))
+        {
+          this->InsertTrialPoint(neighbor, value);
+        }
+      }
+    }
+  }
+}
+
+void mitk::IncrementalFastMarching::Update()
+{
+  m_NumberOfMarchedPoints = 0;
+  if (m_ArrivalTimes.IsNull())
+  {
+    return;
+  }
+
+  bool changed = m_NeedsFullMarch;
+  if (m_NeedsFullMarch)
+  {
+    m_ArrivalTimes->FillBuffer(m_LargeValue);
+    m_Labels.assign(m_ArrivalTimes->GetBufferedRegion().GetNumberOfPixels(), FarPoint);
+    m_Front = FrontType();
+    m_NumberOfPropagatedSeeds = 0;
+    m_NeedsFullMarch = false;
+  }
+
+  // without a speed image no seed is inside of the speed region and the front stays empty
+  for (; m_NumberOfPropagatedSeeds < m_Seeds.size(); ++m_NumberOfPropagatedSeeds)
+  {
+    this->InsertTrialPoint(m_Seeds[m_NumberOfPropagatedSeeds], 0.0);
+  }
+
+  this->March();
+
+  if (changed || m_NumberOfMarchedPoints > 0)
+  {
+    m_ArrivalTimes->Modified();
+  }
+}
@@ -0,0 +1,130 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkIncrementalFastMarching_h_Included
+#define mitkIncrementalFastMarching_h_Included
+
+#include <MitkSegmentationExports.h>
+#include <mitkCommon.h>
+
+#include <itkObject.h>
+#include <itkImage.h>
+
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace mitk
+{
+
+/**
+  \brief Fast marching on a speed image that keeps its arrival times between updates.
+
+  Computes the same arrival times as itk::FastMarchingImageFilter (first order upwind scheme, seeds
+  with arrival time 0), but keeps the arrival times, the point labels and the trial front. This allows
+  to extend an existing result instead of marching again:
+  - AddSeed() propagates the new seed only as far as it lowers the existing arrival times.
+  - Increasing the stopping value continues marching from the stored trial front.
+  - Decreasing the stopping value does not march at all.
+
+  The arrival times cover the region of the reference image given to Initialize(). The front only
+  moves inside of the buffered region of the speed image, so the speed image may be computed for a
+  region of interest only. Arrival times up to the stopping value are exact, larger ones are tentative.
+*/
+class MITKSEGMENTATION_EXPORT IncrementalFastMarching : public itk::Object
+{
+  public:
+
+    mitkClassMacroItkParent(IncrementalFastMarching, itk::Object);
+    itkFactorylessNewMacro(Self)
+
+    typedef itk::Image< float, 3 >  ImageType;
+    typedef ImageType::IndexType    IndexType;
+    typedef ImageType::RegionType   RegionType;
+
+    /// \brief Allocates the arrival times with the geometry of referenceImage, the seeds are kept.
+    void Initialize(const ImageType* referenceImage);
+
+    /// \brief Sets the speed image. A new or regenerated speed image is marched again from all seeds.
+    void SetSpeedImage(const ImageType* speedImage);
+
+    /// \brief Adds a seed with arrival time 0, which is propagated locally on the next Update().
+    void AddSeed(const IndexType& seed);
+
+    /// \brief Removes the last seed. The arrival times are marched again on the next Update().
+    void RemoveLastSeed();
+
+    /// \brief Removes all seeds.
+    void ClearSeeds();
+
+    const std::vector< IndexType >& GetSeeds() const { return m_Seeds; }
+
+    void SetStoppingValue(double value);
+    itkGetConstMacro(StoppingValue, double);
+
+    /// \brief Arrival time of points that were not reached.
+    itkGetConstMacro(LargeValue, float);
+
+    /// \brief Number of points that were marched in the last Update().
+    itkGetConstMacro(NumberOfMarchedPoints, unsigned long);
+
+    /// \brief Brings the arrival times up to date with the seeds, the speed image and the stopping value.
+    void Update();
+
+    ImageType* GetArrivalTimes() const { return m_ArrivalTimes; }
+
+  protected:
+
+    IncrementalFastMarching();
+    virtual ~IncrementalFastMarching();
+
+  private:
+
+    enum LabelType { FarPoint = 0, TrialPoint, AlivePoint };
+
+    typedef std::pair< float, itk::OffsetValueType > FrontNodeType;
+    typedef std::priority_queue< FrontNodeType, std::vector< FrontNodeType >, std::greater< FrontNodeType > > FrontType;
+
+    /// Makes point a trial point with the given arrival time if it is inside of the speed image.
+    void InsertTrialPoint(const IndexType& index, float value);
+
+    /// Solves the upwind equation at index from its alive neighbors, m_LargeValue if it can not be reached.
+    float Solve(const IndexType& index) const;
+
+    /// Marches the trial front up to the stopping value.
+    void March();
+
+    ImageType::ConstPointer m_SpeedImage;
+    unsigned long m_SpeedImageUpdateTime;
+    RegionType m_SpeedRegion;
+
+    ImageType::Pointer m_ArrivalTimes;
+    std::vector< unsigned char > m_Labels;
+    FrontType m_Front;
+
+    std::vector< IndexType > m_Seeds;
+    unsigned int m_NumberOfPropagatedSeeds;
+    bool m_NeedsFullMarch;
+
+    double m_StoppingValue;
+    float m_LargeValue;
+    unsigned long m_NumberOfMarchedPoints;
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,325 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkRegionGrowingFloodTree_h_Included
+#define mitkRegionGrowingFloodTree_h_Included
+
+#include <itkObject.h>
+#include <itkObjectFactory.h>
+#include <itkImage.h>
+#include <itkNumericTraits.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace mitk
+{
+
+/**
+ * \brief Seed rooted component tree of an image for connected threshold region growing with changing thresholds.
+ *
+ * Build() floods the image once from the seed, always continuing at the pixel with the smallest
+ * deviation from a reference value (usually the value around the seed). The resulting tree is the
+ * branch of the component tree of the deviation image that contains the seed: every node stores the
+ * minimum and maximum pixel value on its path to the seed.
+ *
+ * Cut() then returns the connected threshold region for any interval [lower, upper] in time proportional
+ * to the size of the region instead of flooding the image again. The subtree of nodes whose path values
+ * lie inside the interval is the exact region for intervals centered on the reference value. For other
+ * intervals the subtree is continued by a flood into the pixels that are connected over other paths.
+ *
+ * Pixels are connected over their faces, like in itk::ConnectedThresholdImageFilter.
+ */
+template <typename TImage>
+class RegionGrowingFloodTree : public itk::Object
+{
+public:
+  typedef RegionGrowingFloodTree Self;
+  typedef itk::Object Superclass;
+  typedef itk::SmartPointer<Self> Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  itkNewMacro(Self);
+  itkTypeMacro(RegionGrowingFloodTree, itk::Object);
+
+  itkStaticConstMacro(ImageDimension, unsigned int, TImage::ImageDimension);
+
+  typedef TImage ImageType;
+  typedef typename ImageType::PixelType PixelType;
+  typedef typename ImageType::IndexType IndexType;
+  typedef typename ImageType::RegionType RegionType;
+  typedef itk::OffsetValueType OffsetValueType;
+
+  /**
+   * \brief Floods the buffered region of image from seed and stores the tree.
+   * The image is referenced and must not be modified as long as the tree is cut.
+   */
+  void Build(const ImageType* image, const IndexType& seed, double referenceValue);
+
+  /**
+   * \brief Writes foreground into all pixels of output that are connected to the seed within [lower, upper].
+   *
+   * output has to cover the buffered region of the image and has to be zero inside of it,
+   * foreground must not be zero. Returns the bounding region of the written pixels, which is
+   * empty if the seed value is outside of the interval.
+   */
+  template <typename TOutputImage>
+  RegionType Cut(PixelType lower, PixelType upper, TOutputImage* output, typename TOutputImage::PixelType foreground) const;
+
+  /** \brief Number of pixels in the tree. */
+  std::size_t GetNumberOfNodes() const { return m_Offsets.size(); }
+
+protected:
+  RegionGrowingFloodTree() : m_ReferenceValue(0) {}
+  virtual ~RegionGrowingFloodTree() {}
+
+private:
+  RegionGrowingFloodTree(const Self&); // purposely not implemented
+  void operator=(const Self&); // purposely not implemented
+
+  /** Linear offset of the face neighbor of offset in direction (dimension, step), false outside of the image */
+  bool GetNeighbor(OffsetValueType offset, unsigned int dimension, int step, OffsetValueType& neighbor) const;
+
+  /** True if every pixel value within the largest deviation of [lower, upper] from the reference value is inside of it */
+  bool IsCenteredInterval(PixelType lower, PixelType upper) const;
+
+  typename ImageType::ConstPointer m_Image;
+  double m_ReferenceValue;
+  OffsetValueType m_Strides[ImageDimension];
+  OffsetValueType m_Size[ImageDimension];
+
+  // tree nodes in flood order, the seed is node 0
+  std::vector<OffsetValueType> m_Offsets;
+  std::vector<PixelType> m_PathMinimum;
+  std::vector<PixelType> m_PathMaximum;
+
+  // children of node n are m_Children[m_FirstChild[n]] to m_Children[m_FirstChild[n + 1] - 1]
+  std::vector<unsigned int> m_FirstChild;
+  std::vector<unsigned int> m_Children;
+};
+
+template <typename TImage>
+bool RegionGrowingFloodTree<TImage>::GetNeighbor(OffsetValueType offset, unsigned int dimension, int step, OffsetValueType& neighbor) const
+{
+  const OffsetValueType coordinate = (offset / m_Strides[dimension]) % m_Size[dimension] + step;
+  if (coordinate < 0 || coordinate >= m_Size[dimension])
+  {
+    return false;
+  }
+  neighbor = offset + step * m_Strides[dimension];
+  return true;
+}
+
+template <typename TImage>
+void RegionGrowingFloodTree<TImage>::Build(const ImageType* image, const IndexType& seed, double referenceValue)
+{
+  m_Image = image;
+  m_ReferenceValue = referenceValue;
+  m_Offsets.clear();
+  m_PathMinimum.clear();
+  m_PathMaximum.clear();
+  m_FirstChild.clear();
+  m_Children.clear();
+
+  const RegionType region = image->GetBufferedRegion();
+  if (!region.IsInside(seed))
+  {
+    return;
+  }
+
+  OffsetValueType stride = 1;
+  for (unsigned int d = 0; d < ImageDimension; ++d)
+  {
+    m_Strides[d] = stride;
+    m_Size[d] = region.GetSize(d);
+    stride *= m_Size[d];
+  }
+
+  const PixelType* buffer = image->GetBufferPointer();
+  const std::size_t numberOfPixels = region.GetNumberOfPixels();
+  std::vector<bool> flooded(numberOfPixels, false);
+  std::vector<unsigned int> parents;
+  parents.reserve(numberOfPixels);
+  m_Offsets.reserve(numberOfPixels);
+  m_PathMinimum.reserve(numberOfPixels);
+  m_PathMaximum.reserve(numberOfPixels);
+
+  // (largest deviation on the path, (pixel offset, parent node)), the smallest deviation is flooded first
+  typedef std::pair<double, std::pair<OffsetValueType, unsigned int> > FrontType;
+  std::priority_queue<FrontType, std::vector<FrontType>, std::greater<FrontType> > front;
+
+  const OffsetValueType seedOffset = image->ComputeOffset(seed);
+  const unsigned int noParent = std::numeric_limits<unsigned int>::max();
+  front.push(FrontType(std::abs(buffer[seedOffset] - referenceValue), std::make_pair(seedOffset, noParent)));
+
+  while (!front.empty())
+  {
+    const FrontType current = front.top();
+    front.pop();
+
+    const OffsetValueType offset = current.second.first;
+    if (flooded[offset])
+    {
+      continue;
+    }
+    flooded[offset] = true;
+
+    const unsigned int parent = current.second.second;
+    const PixelType value = buffer[offset];
+    const unsigned int node = static_cast<unsigned int>(m_Offsets.size());
+    m_Offsets.push_back(offset);
+    parents.push_back(parent);
+    m_PathMinimum.push_back(parent == noParent ? value : std::min(value, m_PathMinimum[parent]));
+    m_PathMaximum.push_back(parent == noParent ? value : std::max(value, m_PathMaximum[parent]));
+
+    for (unsigned int d = 0; d < ImageDimension; ++d)
+    {
+      for (int step = -1; step <= 1; step += 2)
+      {
+        OffsetValueType neighbor;
+        if (this->GetNeighbor(offset, d, step, neighbor) && !flooded[neighbor])
+        {
+          const double deviation = std::max(current.first, std::abs(buffer[neighbor] - referenceValue));
+          front.push(FrontType(deviation, std::make_pair(neighbor, node)));
+        }
+      }
+    }
+  }
+
+  // children lists in compressed form, in flood order
+  const std::size_t numberOfNodes = m_Offsets.size();
+  m_FirstChild.assign(numberOfNodes + 1, 0);
+  for (std::size_t node = 1; node < numberOfNodes; ++node)
+  {
+    ++m_FirstChild[parents[node] + 1];
+  }
+  for (std::size_t node = 0; node < numberOfNodes; ++node)
+  {
+    m_FirstChild[node + 1] += m_FirstChild[node];
+  }
+  m_Children.resize(numberOfNodes > 0 ? numberOfNodes - 1 : 0);
+  std::vector<unsigned int> nextChild(m_FirstChild.begin(), m_FirstChild.end() - 1);
+  for (std::size_t node = 1; node < numberOfNodes; ++node)
+  {
+    m_Children[nextChild[parents[node]]++] = static_cast<unsigned int>(node);
+  }
+
+  this->Modified();
+}
+
+template <typename TImage>
+bool RegionGrowingFloodTree<TImage>::IsCenteredInterval(PixelType lower, PixelType upper) const
+{
+  const double deviation = std::max(m_ReferenceValue - lower, upper - m_ReferenceValue);
+  double smallest = m_ReferenceValue - deviation;
+  double largest = m_ReferenceValue + deviation;
+  if (itk::NumericTraits<PixelType>::is_integer)
+  {
+    smallest = std::ceil(smallest);
+    largest = std::floor(largest);
+  }
+  return smallest >= lower && largest <= upper;
+}
+
+template <typename TImage>
+template <typename TOutputImage>
+typename RegionGrowingFloodTree<TImage>::RegionType RegionGrowingFloodTree<TImage>::Cut(
+  PixelType lower, PixelType upper, TOutputImage* output, typename TOutputImage::PixelType foreground) const
+{
+  RegionType bounds;
+  if (m_Offsets.empty() || m_PathMinimum[0] < lower || m_PathMaximum[0] > upper)
+  {
+    return bounds;
+  }
+
+  typename TOutputImage::PixelType* outputBuffer = output->GetBufferPointer();
+  std::vector<OffsetValueType> region;
+
+  // subtree of the nodes whose paths to the seed stay inside of the interval
+  std::vector<unsigned int> stack(1, 0);
+  while (!stack.empty())
+  {
+    const unsigned int node = stack.back();
+    stack.pop_back();
+    outputBuffer[m_Offsets[node]] = foreground;
+    region.push_back(m_Offsets[node]);
+
+    for (unsigned int child = m_FirstChild[node]; child < m_FirstChild[node + 1]; ++child)
+    {
+      const unsigned int childNode = m_Children[child];
+      if (m_PathMinimum[childNode] >= lower && m_PathMaximum[childNode] <= upper)
+      {
+        stack.push_back(childNode);
+      }
+    }
+  }
+
+  // an interval that is not centered on the reference value can connect pixels over paths the tree did not take
+  if (!this->IsCenteredInterval(lower, upper))
+  {
+    const PixelType* buffer = m_Image->GetBufferPointer();
+    for (std::size_t i = 0; i < region.size(); ++i)
+    {
+      for (unsigned int d = 0; d < ImageDimension; ++d)
+      {
+        for (int step = -1; step <= 1; step += 2)
+        {
+          OffsetValueType neighbor;
+          if (this->GetNeighbor(region[i], d, step, neighbor) && outputBuffer[neighbor] != foreground
+            && buffer[neighbor] >= lower && buffer[neighbor] <= upper)
+          {
+            outputBuffer[neighbor] = foreground;
+            region.push_back(neighbor);
+          }
+        }
+      }
+    }
+  }
+
+  OffsetValueType minimum[ImageDimension];
+  OffsetValueType maximum[ImageDimension];
+  for (unsigned int d = 0; d < ImageDimension; ++d)
+  {
+    minimum[d] = m_Size[d];
+    maximum[d] = -1;
+  }
+  for (std::size_t i = 0; i < region.size(); ++i)
+  {
+    for (unsigned int d = 0; d < ImageDimension; ++d)
+    {
+      const OffsetValueType coordinate = (region[i] / m_Strides[d]) % m_Size[d];
+      minimum[d] = std::min(minimum[d], coordinate);
+      maximum[d] = std::max(maximum[d], coordinate);
+    }
+  }
+
+  const RegionType imageRegion = m_Image->GetBufferedRegion();
+  for (unsigned int d = 0; d < ImageDimension; ++d)
+  {
+    bounds.SetIndex(d, imageRegion.GetIndex(d) + minimum[d]);
+    bounds.SetSize(d, maximum[d] - minimum[d] + 1);
+  }
+  return bounds;
+}
+
+} // namespace mitk
+
+#endif
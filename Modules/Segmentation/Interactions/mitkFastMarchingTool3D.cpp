@@ -26,6 +26,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkImageTimeSelector.h"
 #include "mitkImageCast.h"
 
+#include <algorithm>
+#include <cmath>
+
 // us
 #include <usModule.h>
 #include <usModuleResource.h>
@@ -89,8 +92,8 @@ const char* mitk::FastMarchingTool3D::GetName() const
 
 void mitk::FastMarchingTool3D::SetUpperThreshold(double value)
 {
+  // the threshold filter is limited to the stopping value in Update()
   m_UpperThreshold = value / 10.0;
-  m_ThresholdFilter->SetUpperThreshold( m_UpperThreshold );
   m_NeedUpdate = true;
 }
 
@@ -139,7 +142,6 @@ void mitk::FastMarchingTool3D::SetStoppingValue(double value)
   if (m_StoppingValue != value)
   {
       m_StoppingValue = value;
-      m_FastMarchingFilter->SetStoppingValue( m_StoppingValue );
       m_NeedUpdate = true;
   }
 }
@@ -177,6 +179,9 @@ void mitk::FastMarchingTool3D::Activated()
 
   m_ProgressCommand = mitk::ToolCommand::New();
 
+  m_RegionOfInterestFilter = RegionOfInterestFilterType::New();
+  m_RegionOfInterestFilter->SetDirectionCollapseToIdentity();
+
   m_ThresholdFilter = ThresholdingFilterType::New();
   m_ThresholdFilter->SetLowerThreshold( m_LowerThreshold );
   m_ThresholdFilter->SetUpperThreshold( m_UpperThreshold );
@@ -200,20 +205,13 @@ void mitk::FastMarchingTool3D::Activated()
   m_SigmoidFilter->SetOutputMinimum( 0.0 );
   m_SigmoidFilter->SetOutputMaximum( 1.0 );
 
-  m_FastMarchingFilter = FastMarchingFilterType::New();
-  m_FastMarchingFilter->AddObserver( itk::ProgressEvent(), m_ProgressCommand);
-  m_FastMarchingFilter->SetStoppingValue( m_StoppingValue );
-
-  m_SeedContainer = NodeContainer::New();
-  m_SeedContainer->Initialize();
-  m_FastMarchingFilter->SetTrialPoints( m_SeedContainer );
+  m_FastMarching = mitk::IncrementalFastMarching::New();
 
-  //set up pipeline
-  m_SmoothFilter->SetInput( m_ReferenceImageAsITK );
+  //set up pipeline, the fast marching and the threshold filter are connected in Initialize()
+  m_RegionOfInterestFilter->SetInput( m_ReferenceImageAsITK );
+  m_SmoothFilter->SetInput( m_RegionOfInterestFilter->GetOutput() );
   m_GradientMagnitudeFilter->SetInput( m_SmoothFilter->GetOutput() );
   m_SigmoidFilter->SetInput( m_GradientMagnitudeFilter->GetOutput() );
-  m_FastMarchingFilter->SetInput( m_SigmoidFilter->GetOutput() );
-  m_ThresholdFilter->SetInput( m_FastMarchingFilter->GetOutput() );
 
   m_ToolManager->GetDataStorage()->Add(m_SeedsAsPointSetNode, m_ToolManager->GetWorkingData(0));
 
@@ -236,7 +234,6 @@ void mitk::FastMarchingTool3D::Deactivated()
   this->m_SmoothFilter->RemoveAllObservers();
   this->m_SigmoidFilter->RemoveAllObservers();
   this->m_GradientMagnitudeFilter->RemoveAllObservers();
-  this->m_FastMarchingFilter->RemoveAllObservers();
   m_ResultImageNode = NULL;
   mitk::RenderingManager::GetInstance()->RequestUpdateAll();
 
@@ -277,10 +274,69 @@ void mitk::FastMarchingTool3D::Initialize()
     CastToItkImageSingleComponent(m_ReferenceImage, m_ReferenceImageAsITK, displayedComponent);
 
   }
-  m_SmoothFilter->SetInput( m_ReferenceImageAsITK );
+  m_RegionOfInterestFilter->SetInput( m_ReferenceImageAsITK );
+  m_RegionOfInterest = InternalImageType::RegionType();
+
+  // the seeds are kept for the new time step
+  m_FastMarching->Initialize( m_ReferenceImageAsITK );
+  m_ThresholdFilter->SetInput( m_FastMarching->GetArrivalTimes() );
   m_NeedUpdate = true;
 }
 
+double mitk::FastMarchingTool3D::GetLargestResultArrivalTime() const
+{
+  // arrival times above the upper threshold are not part of the result, so there is no need to march further
+  return std::min<double>( m_StoppingValue, m_UpperThreshold );
+}
+
+mitk::FastMarchingTool3D::InternalImageType::RegionType mitk::FastMarchingTool3D::ComputeRegionOfInterest(double reach) const
+{
+  const InternalImageType::RegionType largestRegion = m_ReferenceImageAsITK->GetLargestPossibleRegion();
+  const InternalImageType::SpacingType spacing = m_ReferenceImageAsITK->GetSpacing();
+  const std::vector<InternalImageType::IndexType>& seeds = m_FastMarching->GetSeeds();
+
+  InternalImageType::IndexType lower = seeds.front();
+  InternalImageType::IndexType upper = seeds.front();
+  for (std::size_t i = 1; i < seeds.size(); ++i)
+  {
+    for (unsigned int d = 0; d < 3; ++d)
+    {
+      lower[d] = std::min( lower[d], seeds[i][d] );
+      upper[d] = std::max( upper[d], seeds[i][d] );
+    }
+  }
+
+  // the sigmoid limits the speed to 1, so the front moves at most reach in each direction until it arrives
+  // at reach. The margin keeps the borders of the smoothing and gradient filters away from the front.
+  InternalImageType::RegionType region;
+  for (unsigned int d = 0; d < 3; ++d)
+  {
+    const double margin = std::min( std::ceil( ( std::max( reach, 0.0 ) + 3.0 * m_Sigma ) / spacing[d] ) + 2.0, static_cast<double>( largestRegion.GetSize(d) ) );
+    region.SetIndex( d, lower[d] - static_cast<itk::IndexValueType>( margin ) );
+    region.SetSize( d, upper[d] - lower[d] + 1 + 2 * static_cast<itk::SizeValueType>( margin ) );
+  }
+  region.Crop( largestRegion );
+  return region;
+}
+
+void mitk::FastMarchingTool3D::UpdateSpeedImage()
+{
+  // without seeds the fast marching only clears the arrival times
+  if (m_FastMarching->GetSeeds().empty())
+    return;
+
+  const double reach = this->GetLargestResultArrivalTime();
+  if (!m_RegionOfInterest.IsInside( this->ComputeRegionOfInterest(reach) ))
+  {
+    // grow with some slack, so slightly larger thresholds or nearby seeds do not compute the speed image again
+    m_RegionOfInterest = this->ComputeRegionOfInterest(1.5 * reach);
+    m_RegionOfInterestFilter->SetExtractionRegion( m_RegionOfInterest );
+  }
+
+  m_SigmoidFilter->Update();
+  m_FastMarching->SetSpeedImage( m_SigmoidFilter->GetOutput() );
+}
+
 mitk::Image::Pointer mitk::FastMarchingTool3D::getImageAtCurrentTimeStep(mitk::Image::Pointer workingImage)
 {
   mitk::Image::Pointer imageAtCurrentTimeStep = mitk::Image::New();
@@ -362,12 +418,7 @@ void mitk::FastMarchingTool3D::OnAddPoint()
   seedPosition[1] = clickInIndex[1];
   seedPosition[2] = clickInIndex[2];
 
-  NodeType node;
-  const double seedValue = 0.0;
-  node.SetValue( seedValue );
-  node.SetIndex( seedPosition );
-  this->m_SeedContainer->InsertElement(this->m_SeedContainer->Size(), node);
-  m_FastMarchingFilter->Modified();
+  this->m_FastMarching->AddSeed( seedPosition );
 
   mitk::RenderingManager::GetInstance()->RequestUpdateAll();
 
@@ -383,11 +434,10 @@ void mitk::FastMarchingTool3D::OnAddPoint()
 void mitk::FastMarchingTool3D::OnDelete()
 {
   // delete last seed point
-  if(!(this->m_SeedContainer->empty()))
+  if(!(this->m_FastMarching->GetSeeds().empty()))
   {
-    //delete last element of seeds container
-    this->m_SeedContainer->pop_back();
-    m_FastMarchingFilter->Modified();
+    //delete last seed, the arrival times are marched again from the remaining seeds
+    this->m_FastMarching->RemoveLastSeed();
 
     mitk::RenderingManager::GetInstance()->RequestUpdateAll();
 
@@ -411,6 +461,13 @@ void mitk::FastMarchingTool3D::Update()
     CurrentlyBusy.Send(true);
     try
     {
+      this->UpdateSpeedImage();
+
+      // extends the arrival times of the previous update if only seeds were added or the stopping value grew
+      m_FastMarching->SetStoppingValue( this->GetLargestResultArrivalTime() );
+      m_FastMarching->Update();
+
+      m_ThresholdFilter->SetUpperThreshold( this->GetLargestResultArrivalTime() );
       m_ThresholdFilter->Update();
     }
     catch( itk::ExceptionObject & excep )
@@ -446,8 +503,8 @@ void mitk::FastMarchingTool3D::Update()
 void mitk::FastMarchingTool3D::ClearSeeds()
 {
   // clear seeds for FastMarching as well as the PointSet for visualization
-  if(this->m_SeedContainer.IsNotNull())
-    this->m_SeedContainer->Initialize();
+  if(this->m_FastMarching.IsNotNull())
+    this->m_FastMarching->ClearSeeds();
 
   if(this->m_SeedsAsPointSet.IsNotNull())
   {
@@ -473,9 +530,6 @@ void mitk::FastMarchingTool3D::ClearSeeds()
     m_PointSetRemoveObserverTag = m_SeedsAsPointSet->AddObserver( mitk::PointSetRemoveEvent(), pointRemovedCommand);
   }
 
-  if(this->m_FastMarchingFilter.IsNotNull())
-    m_FastMarchingFilter->Modified();
-
   this->m_NeedUpdate = true;
 }
 
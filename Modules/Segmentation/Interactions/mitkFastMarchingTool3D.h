@@ -29,8 +29,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "itkImage.h"
 
+#include "mitkIncrementalFastMarching.h"
+
 //itk filter
-#include "itkFastMarchingImageFilter.h"
+#include "itkExtractImageFilter.h"
 #include "itkBinaryThresholdImageFilter.h"
 #include "itkGradientMagnitudeRecursiveGaussianImageFilter.h"
 #include "itkSigmoidImageFilter.h"
@@ -48,9 +50,14 @@ namespace mitk
 
   The segmentation is done by setting one or more seed points on the image
   and adapting the time range and threshold. The pipeline is:
-    Smoothing->GradientMagnitude->SigmoidFunction->FastMarching->Threshold
+    RegionOfInterest->Smoothing->GradientMagnitude->SigmoidFunction->FastMarching->Threshold
   The resulting binary image is seen as a segmentation of an object.
 
+  The speed image (smoothing, gradient magnitude and sigmoid) is only computed for a region around
+  the seeds that the front can reach within the stopping value and the upper threshold, and only again
+  if its parameters change or the region has to grow. Added seeds and larger stopping values extend the
+  existing arrival times (see IncrementalFastMarching), changed thresholds only threshold them again.
+
   For detailed documentation see ITK Software Guide section 9.3.1 Fast Marching Segmentation.
 */
 class MITKSEGMENTATION_EXPORT FastMarchingTool3D : public AutoSegmentationTool
@@ -69,13 +76,11 @@ class MITKSEGMENTATION_EXPORT FastMarchingTool3D : public AutoSegmentationTool
     typedef mitk::Tool::DefaultSegmentationDataType   OutputPixelType;
     typedef itk::Image< OutputPixelType, 3 >          OutputImageType;
 
+    typedef itk::ExtractImageFilter< InternalImageType, InternalImageType >                             RegionOfInterestFilterType;
     typedef itk::BinaryThresholdImageFilter< InternalImageType, OutputImageType >                       ThresholdingFilterType;
     typedef itk::CurvatureAnisotropicDiffusionImageFilter< InternalImageType, InternalImageType >       SmoothingFilterType;
     typedef itk::GradientMagnitudeRecursiveGaussianImageFilter< InternalImageType, InternalImageType >  GradientFilterType;
     typedef itk::SigmoidImageFilter< InternalImageType, InternalImageType >                             SigmoidFilterType;
-    typedef itk::FastMarchingImageFilter< InternalImageType, InternalImageType >                        FastMarchingFilterType;
-    typedef FastMarchingFilterType::NodeContainer                                                       NodeContainer;
-    typedef FastMarchingFilterType::NodeType                                                            NodeType;
 
     bool CanHandle(BaseData* referenceData) const override;
 
@@ -134,6 +139,15 @@ class MITKSEGMENTATION_EXPORT FastMarchingTool3D : public AutoSegmentationTool
 
     mitk::Image::Pointer getImageAtCurrentTimeStep(mitk::Image::Pointer workingImage);
 
+    /// \brief Largest arrival time that can be part of the result.
+    double GetLargestResultArrivalTime() const;
+
+    /// \brief Region around the seeds that a front with speed at most 1 reaches until reach plus the filter margins.
+    InternalImageType::RegionType ComputeRegionOfInterest(double reach) const;
+
+    /// \brief Updates the speed image for a region of interest that contains all points the front can reach.
+    void UpdateSpeedImage();
+
     mitk::ToolCommand::Pointer m_ProgressCommand;
 
     Image::Pointer m_ReferenceImage;
@@ -149,9 +163,9 @@ class MITKSEGMENTATION_EXPORT FastMarchingTool3D : public AutoSegmentationTool
     float m_Alpha; //used in Sigmoid filter
     float m_Beta; //used in Sigmoid filter
 
-    NodeContainer::Pointer m_SeedContainer; //seed points for FastMarching
 
     InternalImageType::Pointer m_ReferenceImageAsITK; //the reference image as itk::Image
+    InternalImageType::RegionType m_RegionOfInterest; //the region the speed image is computed for
 
     mitk::DataNode::Pointer m_ResultImageNode;//holds the result as a preview image
 
@@ -161,11 +175,12 @@ class MITKSEGMENTATION_EXPORT FastMarchingTool3D : public AutoSegmentationTool
     unsigned int m_PointSetAddObserverTag;
     unsigned int m_PointSetRemoveObserverTag;
 
+    RegionOfInterestFilterType::Pointer m_RegionOfInterestFilter;
     ThresholdingFilterType::Pointer m_ThresholdFilter;
     SmoothingFilterType::Pointer m_SmoothFilter;
     GradientFilterType::Pointer m_GradientMagnitudeFilter;
     SigmoidFilterType::Pointer m_SigmoidFilter;
-    FastMarchingFilterType::Pointer m_FastMarchingFilter;
+    IncrementalFastMarching::Pointer m_FastMarching;
 };
 
 } // namespace
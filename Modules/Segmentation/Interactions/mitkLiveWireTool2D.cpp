@@ -214,17 +214,16 @@ void mitk::LiveWireTool2D::ConfirmSegmentation()
               mitk::ContourModel::Pointer projectedContour = mitk::ContourModelUtils::ProjectContourTo2DSlice(workingSlice, contourModel, true, false);
               mitk::ContourModelUtils::FillContourInSlice(projectedContour, workingSlice, 1.0);
 
-              //write back to image volume
+              //collect the slice, all slices are written back to the image volume together
               SliceInformation sliceInfo(workingSlice, itWorkingContours->second, currentTimestep);
               sliceList.push_back(sliceInfo);
-              this->WriteSliceToVolume(sliceInfo);
             }
           }
         }
         ++itWorkingContours;
       }
 
-      this->WriteBackSegmentationResult(sliceList, false);
+      this->WriteBackSegmentationResult(sliceList);
     }
   }
 
@@ -36,6 +36,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkRenderingManager.h"
 #include "mitkApplicationCursor.h"
 #include "mitkImageToContourModelFilter.h"
+#include "mitkRegionGrowingFloodTree.h"
 #include "mitkRegionGrowingTool.xpm"
 
 // us
@@ -46,7 +47,6 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 // ITK
 #include "mitkImageAccessByItk.h"
-#include <itkConnectedThresholdImageFilter.h>
 #include <itkConnectedComponentImageFilter.h>
 #include <itkNeighborhoodIterator.h>
 #include <itkImageRegionIteratorWithIndex.h>
@@ -187,7 +187,7 @@ void mitk::RegionGrowingTool::IsInsideSegmentation(itk::Image<TPixel, imageDimen
     }
 }
 
-// Do the region growing (i.e. call an ITK filter that does it)
+// Do the region growing (i.e. cut the flood tree of the seed at the thresholds)
 template<typename TPixel, unsigned int imageDimension>
 void mitk::RegionGrowingTool::StartRegionGrowing(itk::Image<TPixel, imageDimension>* inputImage, itk::Index<imageDimension> seedIndex, std::array<ScalarType, 2> thresholds, mitk::Image::Pointer& outputImage)
 {
@@ -196,26 +196,24 @@ void mitk::RegionGrowingTool::StartRegionGrowing(itk::Image<TPixel, imageDimensi
     typedef itk::Image<TPixel, imageDimension> InputImageType;
     typedef itk::Image<DefaultSegmentationDataType, imageDimension> OutputImageType;
 
-    typedef itk::ConnectedThresholdImageFilter<InputImageType, OutputImageType> RegionGrowingFilterType;
-    typename RegionGrowingFilterType::Pointer regionGrower = RegionGrowingFilterType::New();
-
-    // perform region growing in desired segmented region
-    regionGrower->SetInput(inputImage);
-    regionGrower->AddSeed(seedIndex);
-
-    regionGrower->SetLower(thresholds[0]);
-    regionGrower->SetUpper(thresholds[1]);
-
-    try
+    // The flood tree is built once per seed, every threshold change while dragging is a cut of the tree
+    typedef RegionGrowingFloodTree<InputImageType> FloodTreeType;
+    typename FloodTreeType::Pointer floodTree = dynamic_cast<FloodTreeType*>(m_FloodTree.GetPointer());
+    if (floodTree.IsNull())
     {
-        regionGrower->Update();
-    }
-    catch(...)
-    {
-        return; // Should we do something?
+        floodTree = FloodTreeType::New();
+        floodTree->Build(inputImage, seedIndex, m_SeedValue);
+        m_FloodTree = floodTree.GetPointer();
     }
 
-    typename OutputImageType::Pointer resultImage = regionGrower->GetOutput();
+    typename OutputImageType::Pointer resultImage = OutputImageType::New();
+    resultImage->CopyInformation(inputImage);
+    resultImage->SetRegions(inputImage->GetBufferedRegion());
+    resultImage->Allocate();
+    resultImage->FillBuffer(0);
+
+    // perform region growing in desired segmented region
+    typename OutputImageType::RegionType regionBounds = floodTree->Cut(static_cast<TPixel>(thresholds[0]), static_cast<TPixel>(thresholds[1]), resultImage.GetPointer(), 1);
 
     // Smooth result: Every pixel is replaced by the majority of the neighborhood
     typedef itk::NeighborhoodIterator<OutputImageType> NeighborhoodIteratorType;
@@ -224,37 +222,40 @@ void mitk::RegionGrowingTool::StartRegionGrowing(itk::Image<TPixel, imageDimensi
     typename NeighborhoodIteratorType::RadiusType radius;
     radius.Fill(2); // for now, maybe make this something the user can adjust in the preferences?
 
-    NeighborhoodIteratorType neighborhoodIterator(radius, resultImage, resultImage->GetRequestedRegion());
-    ImageIteratorType imageIterator(resultImage, resultImage->GetRequestedRegion());
-
-    for (neighborhoodIterator.GoToBegin(), imageIterator.GoToBegin(); !neighborhoodIterator.IsAtEnd(); ++neighborhoodIterator, ++imageIterator)
+    // Pixels outside of the bounds of the region can not get a majority, so only the bounds are smoothed
+    if (regionBounds.GetNumberOfPixels() > 0)
     {
-        DefaultSegmentationDataType voteYes(0);
-        DefaultSegmentationDataType voteNo(0);
+        NeighborhoodIteratorType neighborhoodIterator(radius, resultImage, regionBounds);
+        ImageIteratorType imageIterator(resultImage, regionBounds);
 
-        for (unsigned int i = 0; i < neighborhoodIterator.Size(); ++i)
+        for (neighborhoodIterator.GoToBegin(), imageIterator.GoToBegin(); !neighborhoodIterator.IsAtEnd(); ++neighborhoodIterator, ++imageIterator)
         {
-            if (neighborhoodIterator.GetPixel(i) > 0)
+            DefaultSegmentationDataType voteYes(0);
+            DefaultSegmentationDataType voteNo(0);
+
+            for (unsigned int i = 0; i < neighborhoodIterator.Size(); ++i)
+            {
+                if (neighborhoodIterator.GetPixel(i) > 0)
+                {
+                    voteYes += 1;
+                }
+                else
+                {
+                    voteNo += 1;
+                }
+            }
+
+            if (voteYes > voteNo)
             {
-                voteYes += 1;
+                imageIterator.Set(1);
             }
             else
             {
-                voteNo += 1;
+                imageIterator.Set(0);
             }
         }
-
-        if (voteYes > voteNo)
-        {
-            imageIterator.Set(1);
-        }
-        else
-        {
-            imageIterator.Set(0);
-        }
     }
-
-    if (resultImage.IsNull())
+    else
     {
         MITK_DEBUG << "Region growing result is empty.";
     }
@@ -427,6 +428,7 @@ void mitk::RegionGrowingTool::OnMousePressedOutside(StateMachineAction*, Interac
         AccessFixedDimensionByItk_3(m_ReferenceSlice, GetNeighborhoodAverage, 2, indexInReferenceSlice2D, &averageValue, 1);
         m_SeedValue = averageValue;
         MITK_INFO << "Seed value is " << m_SeedValue;
+        m_FloodTree = nullptr;
 
         // Get level window settings
         LevelWindow lw(0, 500); // default window 0 to 500, can we do something smarter here?
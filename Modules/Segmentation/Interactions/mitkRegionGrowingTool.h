@@ -126,7 +126,8 @@ class MITKSEGMENTATION_EXPORT RegionGrowingTool : public FeedbackContourTool
     void IsInsideSegmentation(itk::Image<TPixel, imageDimension>* itkImage, itk::Index<imageDimension> index, bool* result);
 
     /**
-     * @brief Template that calls an ITK filter to do the region growing.
+     * @brief Template that does the region growing by cutting the flood tree of the seed (see RegionGrowingFloodTree).
+     * The tree is built on the first call after m_FloodTree was reset and reused for all following thresholds.
      */
     template<typename TPixel, unsigned int imageDimension>
     void StartRegionGrowing(itk::Image<TPixel, imageDimension>* itkImage, itk::Index<imageDimension> seedPoint, std::array<ScalarType, 2> thresholds, mitk::Image::Pointer& outputImage);
@@ -135,6 +136,7 @@ class MITKSEGMENTATION_EXPORT RegionGrowingTool : public FeedbackContourTool
     Image::Pointer m_WorkingSlice;
 
     ScalarType m_SeedValue;
+    itk::Object::Pointer m_FloodTree; ///< RegionGrowingFloodTree of the current seed in the reference slice
     itk::Index<3> m_SeedPoint;
     std::array<ScalarType, 2> m_Thresholds;
     std::array<ScalarType, 2> m_InitialThresholds;
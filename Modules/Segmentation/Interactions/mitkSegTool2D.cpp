@@ -43,6 +43,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 //includes for resling and overwriting
 #include <mitkExtractSliceFilter.h>
 #include <mitkVtkImageOverwrite.h>
+#include <mitkAlignedSliceOverwrite.h>
 #include <vtkSmartPointer.h>
 #include <vtkImageData.h>
 
@@ -344,11 +345,12 @@ void mitk::SegTool2D::WriteBackSegmentationResult(std::vector<mitk::SegTool2D::S
   timeSelector->Update();
   Image::Pointer dimRefImg = timeSelector->GetOutput();
 
+  if(writeSliceToVolume)
+    this->WriteSlicesToVolume(sliceList);
+
   for (unsigned int i = 0; i < sliceList.size(); ++i)
   {
     SliceInformation currentSliceInfo = sliceList.at(i);
-    if(writeSliceToVolume)
-      this->WriteSliceToVolume(currentSliceInfo);
     if (m_SurfaceInterpolationEnabled && dimRefImg->GetDimension() == 3)
     {
       currentSliceInfo.slice->DisconnectPipeline();
@@ -364,7 +366,55 @@ void mitk::SegTool2D::WriteBackSegmentationResult(std::vector<mitk::SegTool2D::S
   mitk::RenderingManager::GetInstance()->RequestUpdateAll();
 }
 
-void mitk::SegTool2D::WriteSliceToVolume(mitk::SegTool2D::SliceInformation sliceInfo)
+void mitk::SegTool2D::WriteSlicesToVolume(const std::vector<SliceInformation>& sliceList)
+{
+  DataNode* workingNode( m_ToolManager->GetWorkingData(0) );
+  Image* image = dynamic_cast<Image*>(workingNode->GetData());
+  if (!image || sliceList.empty())
+    return;
+
+  // all operation events of the list share one object event id and are undone in one step
+  UndoStackItem::IncCurrObjectEventId();
+  UndoStackItem::IncCurrGroupEventId();
+
+  AlignedSliceOverwrite::Pointer alignedOverwrite = AlignedSliceOverwrite::New();
+  alignedOverwrite->SetVolume(image);
+  std::vector<SliceInformation> alignedSlices;
+
+  auto writeAlignedSlices = [&]()
+  {
+    if (alignedSlices.empty())
+      return;
+
+    alignedOverwrite->Write();
+    const std::vector<Image::Pointer>& originalSlices = alignedOverwrite->GetOriginalSlices();
+    for (unsigned int i = 0; i < alignedSlices.size(); ++i)
+    {
+      const SliceInformation& sliceInfo = alignedSlices[i];
+      DiffSliceOperation* undoOperation = new DiffSliceOperation(image, originalSlices[i], dynamic_cast<SlicedGeometry3D*>(originalSlices[i]->GetGeometry()), sliceInfo.timestep, sliceInfo.plane);
+      DiffSliceOperation* doOperation = new DiffSliceOperation(image, sliceInfo.slice, dynamic_cast<SlicedGeometry3D*>(sliceInfo.slice->GetGeometry()), sliceInfo.timestep, sliceInfo.plane);
+      OperationEvent* undoStackItem = new OperationEvent( DiffSliceOperationApplier::GetInstance(), doOperation, undoOperation, "Segmentation", workingNode);
+      UndoController::GetCurrentUndoModel()->SetOperationEvent(undoStackItem);
+    }
+    alignedSlices.clear();
+  };
+
+  for (const SliceInformation& sliceInfo : sliceList)
+  {
+    if (alignedOverwrite->AddSlice(sliceInfo.slice, sliceInfo.plane, sliceInfo.timestep))
+    {
+      alignedSlices.push_back(sliceInfo);
+    }
+    else
+    {
+      writeAlignedSlices();
+      this->WriteSliceToVolume(sliceInfo, false);
+    }
+  }
+  writeAlignedSlices();
+}
+
+void mitk::SegTool2D::WriteSliceToVolume(mitk::SegTool2D::SliceInformation sliceInfo, bool separateUndoStep)
 {
   DataNode* workingNode( m_ToolManager->GetWorkingData(0) );
   Image* image = dynamic_cast<Image*>(workingNode->GetData());
@@ -409,8 +459,11 @@ void mitk::SegTool2D::WriteSliceToVolume(mitk::SegTool2D::SliceInformation slice
   OperationEvent* undoStackItem = new OperationEvent( DiffSliceOperationApplier::GetInstance(), doOperation, undoOperation, "Segmentation", m_ToolManager->GetWorkingData(0));
 
   //add it to the undo controller
-  UndoStackItem::IncCurrObjectEventId();
-  UndoStackItem::IncCurrGroupEventId();
+  if (separateUndoStep)
+  {
+    UndoStackItem::IncCurrObjectEventId();
+    UndoStackItem::IncCurrGroupEventId();
+  }
   UndoController::GetCurrentUndoModel()->SetOperationEvent(undoStackItem);
 
   //clear the pointers as the operation are stored in the undocontroller and also deleted from there
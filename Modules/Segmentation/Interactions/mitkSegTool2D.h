@@ -156,7 +156,19 @@ class MITKSEGMENTATION_EXPORT SegTool2D : public Tool
 
     void WriteBackSegmentationResult (std::vector<SliceInformation> sliceList, bool writeSliceToVolume = true);
 
-    void WriteSliceToVolume (SliceInformation sliceInfo);
+    /**
+      \brief Writes a slice into the working image. With separateUndoStep == false the undo operation is added to the current undo step.
+    */
+    void WriteSliceToVolume (SliceInformation sliceInfo, bool separateUndoStep = true);
+
+    /**
+      \brief Writes all slices into the working image in one undo step.
+
+      Slices on the voxel grid of the working image are copied directly by AlignedSliceOverwrite,
+      all other slices are resliced into the image in between, so overlapping slices are written in order.
+    */
+    void WriteSlicesToVolume (const std::vector<SliceInformation>& sliceList);
+
     /**
       \brief Adds a new node called Contourmarker to the datastorage which holds a mitk::PlanarFigure.
              By selecting this node the slicestack will be reoriented according to the PlanarFigure's Geometry
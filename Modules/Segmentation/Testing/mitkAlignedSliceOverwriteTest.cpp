@@ -0,0 +1,261 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestingMacros.h"
+#include <mitkTestFixture.h>
+#include <mitkAlignedSliceOverwrite.h>
+
+#include <mitkExtractSliceFilter.h>
+#include <mitkImageAccessLock.h>
+#include <mitkImageCast.h>
+#include <mitkImageRegionAccessor.h>
+#include <mitkImageVtkAccessor.h>
+#include <mitkInteractionConst.h>
+#include <mitkRotationOperation.h>
+#include <mitkVtkImageOverwrite.h>
+
+#include <itkImage.h>
+#include <itkImageRegionIterator.h>
+#include <itkTimeProbe.h>
+
+#include <vtkSmartPointer.h>
+
+#include <cstring>
+
+/**
+ * Compares the slices written by mitk::AlignedSliceOverwrite to the ones written by mitkVtkImageOverwrite
+ * for single slices, batches of crossing and repeated slices, and checks that oblique slices are rejected.
+ */
+class mitkAlignedSliceOverwriteTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkAlignedSliceOverwriteTestSuite);
+  MITK_TEST(Write_StandardPlanes_EqualOverwriteFilter);
+  MITK_TEST(Write_SliceBatch_EqualOverwriteFilter);
+  MITK_TEST(AddSlice_RotatedPlane_Rejected);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  typedef itk::Image<unsigned short, 3> ImageType;
+
+  mitk::Image::Pointer m_ExpectedImage;
+  mitk::Image::Pointer m_ResultImage;
+
+  mitk::PlaneGeometry::Pointer NewPlane(mitk::PlaneGeometry::PlaneOrientation orientation, int sliceIndex)
+  {
+    mitk::PlaneGeometry::Pointer plane = mitk::PlaneGeometry::New();
+    plane->InitializeStandardPlane(m_ResultImage->GetGeometry(), orientation, sliceIndex, true, false);
+    mitk::Point3D origin = plane->GetOrigin();
+    mitk::Vector3D normal = plane->GetNormal();
+    normal.Normalize();
+    origin += normal * 0.5; //pixelspacing is 1, so half the spacing is 0.5
+    plane->SetOrigin(origin);
+    return plane;
+  }
+
+  /** extracts the slice like SegTool2D::GetAffectedImageSliceAs2DImage */
+  mitk::Image::Pointer ExtractSlice(mitk::Image* image, mitk::PlaneGeometry* plane)
+  {
+    vtkSmartPointer<mitkVtkImageOverwrite> reslice = vtkSmartPointer<mitkVtkImageOverwrite>::New();
+    reslice->SetOverwriteMode(false);
+    mitk::ExtractSliceFilter::Pointer extractor = mitk::ExtractSliceFilter::New(reslice);
+    extractor->SetInput(image);
+    extractor->SetWorldGeometry(plane);
+    extractor->SetVtkOutputRequest(false);
+    extractor->SetResliceTransformByGeometry(image->GetTimeGeometry()->GetGeometryForTimeStep(0));
+    extractor->SetInPlaneResampleExtentByGeometry(true);
+    extractor->Update();
+    mitk::Image::Pointer slice = extractor->GetOutput();
+    slice->DisconnectPipeline();
+    return slice;
+  }
+
+  /** writes the slice like SegTool2D::WriteSliceToVolume */
+  void OverwriteSlice(mitk::Image* image, mitk::Image* slice, mitk::PlaneGeometry* plane)
+  {
+    vtkSmartPointer<mitkVtkImageOverwrite> reslice = vtkSmartPointer<mitkVtkImageOverwrite>::New();
+    mitk::ImageVtkAccessor accessor(slice);
+    reslice->SetInputSlice(accessor.getVtkImageData());
+    reslice->SetOverwriteMode(true);
+    reslice->Modified();
+
+    mitk::ExtractSliceFilter::Pointer extractor = mitk::ExtractSliceFilter::New(reslice);
+    extractor->SetInput(image);
+    extractor->SetWorldGeometry(plane);
+    extractor->SetVtkOutputRequest(false);
+    extractor->SetResliceTransformByGeometry(image->GetGeometry(0));
+    extractor->SetInPlaneResampleExtentByGeometry(true);
+    extractor->Modified();
+    extractor->Update();
+  }
+
+  /** a copy of the slice of m_ResultImage with values that do not appear in the volume */
+  mitk::Image::Pointer NewEditedSlice(mitk::PlaneGeometry* plane, unsigned short marker)
+  {
+    mitk::Image::Pointer slice = this->ExtractSlice(m_ResultImage, plane);
+    mitk::ImageRegionAccessor accessor(slice);
+    mitk::ImageAccessLock lock(&accessor, true);
+    unsigned short* data = static_cast<unsigned short*>(accessor.getData());
+    const unsigned int numberOfPixels = slice->GetDimension(0) * slice->GetDimension(1);
+    for (unsigned int i = 0; i < numberOfPixels; ++i)
+    {
+      data[i] = static_cast<unsigned short>(marker + i % 7);
+    }
+    return slice;
+  }
+
+  bool EqualData(mitk::Image* expected, mitk::Image* result)
+  {
+    mitk::ImageRegionAccessor expectedAccessor(expected);
+    mitk::ImageAccessLock expectedLock(&expectedAccessor);
+    mitk::ImageRegionAccessor resultAccessor(result);
+    mitk::ImageAccessLock resultLock(&resultAccessor);
+
+    std::size_t size = expected->GetPixelType().GetSize();
+    for (unsigned int d = 0; d < expected->GetDimension(); ++d)
+    {
+      if (expected->GetDimension(d) != result->GetDimension(d))
+      {
+        return false;
+      }
+      size *= expected->GetDimension(d);
+    }
+    return std::memcmp(expectedAccessor.getData(), resultAccessor.getData(), size) == 0;
+  }
+
+public:
+
+  void setUp() override
+  {
+    ImageType::SizeType size;
+    size[0] = 48;
+    size[1] = 40;
+    size[2] = 32;
+    ImageType::Pointer image = ImageType::New();
+    image->SetRegions(size);
+    image->SetSpacing(1.0);
+    image->Allocate();
+
+    //fill the image with distinct values
+    unsigned short pixelValue = 0;
+    itk::ImageRegionIterator<ImageType> iterator(image, image->GetLargestPossibleRegion());
+    for (iterator.GoToBegin(); !iterator.IsAtEnd(); ++iterator)
+    {
+      iterator.Set(pixelValue++);
+    }
+
+    mitk::CastToMitkImage(image, m_ExpectedImage);
+    mitk::CastToMitkImage(image, m_ResultImage);
+  }
+
+  void tearDown() override
+  {
+    m_ExpectedImage = nullptr;
+    m_ResultImage = nullptr;
+  }
+
+  void Write_StandardPlanes_EqualOverwriteFilter()
+  {
+    const mitk::PlaneGeometry::PlaneOrientation orientations[3] = { mitk::PlaneGeometry::Axial, mitk::PlaneGeometry::Sagittal, mitk::PlaneGeometry::Frontal };
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      mitk::PlaneGeometry::Pointer plane = this->NewPlane(orientations[i], 11);
+      mitk::Image::Pointer originalSlice = this->ExtractSlice(m_ResultImage, plane);
+      mitk::Image::Pointer slice = this->NewEditedSlice(plane, 60000);
+
+      mitk::AlignedSliceOverwrite::Pointer overwrite = mitk::AlignedSliceOverwrite::New();
+      overwrite->SetVolume(m_ResultImage);
+      CPPUNIT_ASSERT_MESSAGE("A standard plane is aligned with the volume.", overwrite->AddSlice(slice, plane, 0));
+      overwrite->Write();
+      this->OverwriteSlice(m_ExpectedImage, slice, plane);
+
+      CPPUNIT_ASSERT_MESSAGE("The volume equals the one written by the overwrite filter.", this->EqualData(m_ExpectedImage, m_ResultImage));
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("One original slice per written slice.", static_cast<std::size_t>(1), overwrite->GetOriginalSlices().size());
+      CPPUNIT_ASSERT_MESSAGE("The original slice holds the replaced voxels.", this->EqualData(originalSlice, overwrite->GetOriginalSlices()[0]));
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("The written slices are removed.", 0u, overwrite->GetNumberOfSlices());
+    }
+  }
+
+  void Write_SliceBatch_EqualOverwriteFilter()
+  {
+    // a run of sagittal slices, crossed by axial slices and repeated afterwards, so the order of the writes matters
+    std::vector<mitk::PlaneGeometry::Pointer> planes;
+    for (int sliceIndex = 3; sliceIndex < 45; sliceIndex += 2)
+    {
+      planes.push_back(this->NewPlane(mitk::PlaneGeometry::Sagittal, sliceIndex));
+    }
+    planes.push_back(this->NewPlane(mitk::PlaneGeometry::Axial, 5));
+    planes.push_back(this->NewPlane(mitk::PlaneGeometry::Axial, 6));
+    planes.push_back(this->NewPlane(mitk::PlaneGeometry::Sagittal, 7));
+    planes.push_back(this->NewPlane(mitk::PlaneGeometry::Frontal, 20));
+    planes.push_back(this->NewPlane(mitk::PlaneGeometry::Frontal, 20));
+
+    std::vector<mitk::Image::Pointer> slices;
+    std::vector<mitk::Image::Pointer> originalSlices;
+    for (unsigned int i = 0; i < planes.size(); ++i)
+    {
+      slices.push_back(this->NewEditedSlice(planes[i], static_cast<unsigned short>(60000 + 10 * i)));
+    }
+
+    itk::TimeProbe overwriteClock;
+    itk::TimeProbe filterClock;
+
+    overwriteClock.Start();
+    mitk::AlignedSliceOverwrite::Pointer overwrite = mitk::AlignedSliceOverwrite::New();
+    overwrite->SetVolume(m_ResultImage);
+    for (unsigned int i = 0; i < planes.size(); ++i)
+    {
+      CPPUNIT_ASSERT_MESSAGE("A standard plane is aligned with the volume.", overwrite->AddSlice(slices[i], planes[i], 0));
+    }
+    overwrite->Write();
+    overwriteClock.Stop();
+
+    filterClock.Start();
+    for (unsigned int i = 0; i < planes.size(); ++i)
+    {
+      originalSlices.push_back(this->ExtractSlice(m_ExpectedImage, planes[i]));
+      this->OverwriteSlice(m_ExpectedImage, slices[i], planes[i]);
+    }
+    filterClock.Stop();
+
+    CPPUNIT_ASSERT_MESSAGE("The volume equals the one written by the overwrite filter.", this->EqualData(m_ExpectedImage, m_ResultImage));
+    for (unsigned int i = 0; i < planes.size(); ++i)
+    {
+      CPPUNIT_ASSERT_MESSAGE("The original slice holds the voxels replaced by this slice.", this->EqualData(originalSlices[i], overwrite->GetOriginalSlices()[i]));
+    }
+
+    MITK_INFO << "Writing " << planes.size() << " slices: " << 1000.0 * overwriteClock.GetTotal() << "ms (aligned slice overwrite), "
+              << 1000.0 * filterClock.GetTotal() << "ms (overwrite filter, including undo slices)";
+  }
+
+  void AddSlice_RotatedPlane_Rejected()
+  {
+    mitk::PlaneGeometry::Pointer plane = this->NewPlane(mitk::PlaneGeometry::Axial, 16);
+    mitk::Vector3D rotationVector = plane->GetAxisVector(0);
+    rotationVector.Normalize();
+    mitk::RotationOperation* op = new mitk::RotationOperation(mitk::OpROTATE, plane->GetCenter(), rotationVector, 30.0);
+    plane->ExecuteOperation(op);
+    delete op;
+
+    mitk::Image::Pointer slice = this->ExtractSlice(m_ResultImage, plane);
+    mitk::AlignedSliceOverwrite::Pointer overwrite = mitk::AlignedSliceOverwrite::New();
+    overwrite->SetVolume(m_ResultImage);
+    CPPUNIT_ASSERT_MESSAGE("An oblique plane is not aligned with the volume.", !overwrite->AddSlice(slice, plane, 0));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("The slice is not added.", 0u, overwrite->GetNumberOfSlices());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkAlignedSliceOverwrite)
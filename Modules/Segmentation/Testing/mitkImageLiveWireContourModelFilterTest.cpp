@@ -0,0 +1,139 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestingMacros.h"
+#include <mitkTestFixture.h>
+#include <mitkImageLiveWireContourModelFilter.h>
+#include <mitkITKImageImport.h>
+
+#include <itkImageRegionIterator.h>
+
+#include <random>
+
+/**
+ * Moves the end point of a live wire filter around while keeping the start point, so that the
+ * shortest path filter continues its stored search tree, and compares every path to the one of
+ * a fresh filter.
+ */
+class mitkImageLiveWireContourModelFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkImageLiveWireContourModelFilterTestSuite);
+  MITK_TEST(Update_MovedEndPoint_EqualsFreshSearch);
+  MITK_TEST(Update_MovedStartPoint_EqualsFreshSearch);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  typedef itk::Image<short, 2> ImageType;
+
+  mitk::Image::Pointer m_Image;
+
+  static mitk::Point3D MakePoint(double x, double y)
+  {
+    mitk::Point3D point;
+    point[0] = x;
+    point[1] = y;
+    point[2] = 0.0;
+    return point;
+  }
+
+  mitk::ContourModel::Pointer FreshPath(const mitk::Point3D& start, const mitk::Point3D& end)
+  {
+    mitk::ImageLiveWireContourModelFilter::Pointer filter = mitk::ImageLiveWireContourModelFilter::New();
+    filter->SetInput(m_Image);
+    filter->SetStartPoint(start);
+    filter->SetEndPoint(end);
+    filter->Update();
+    return filter->GetOutput();
+  }
+
+  void AssertEqualPaths(mitk::ContourModel* expected, mitk::ContourModel* result)
+  {
+    CPPUNIT_ASSERT_MESSAGE("Fresh search found a path", expected->GetNumberOfVertices() > 0);
+    CPPUNIT_ASSERT_EQUAL(expected->GetNumberOfVertices(), result->GetNumberOfVertices());
+    for (int i = 0; i < expected->GetNumberOfVertices(); ++i)
+    {
+      CPPUNIT_ASSERT_MESSAGE("Path vertices are equal",
+        mitk::Equal(expected->GetVertexAt(i)->Coordinates, result->GetVertexAt(i)->Coordinates, mitk::eps, true));
+    }
+  }
+
+public:
+
+  void setUp() override
+  {
+    // noise on top of a bright ring, so that paths follow the ring and have no equal cost ties
+    ImageType::SizeType size;
+    size.Fill(64);
+    ImageType::Pointer image = ImageType::New();
+    image->SetRegions(size);
+    image->Allocate();
+
+    std::mt19937 generator(42);
+    std::normal_distribution<double> noise(0, 10);
+    itk::ImageRegionIterator<ImageType> iterator(image, image->GetBufferedRegion());
+    for (iterator.GoToBegin(); !iterator.IsAtEnd(); ++iterator)
+    {
+      ImageType::IndexType index = iterator.GetIndex();
+      double distance = std::sqrt(std::pow(index[0] - 32.0, 2) + std::pow(index[1] - 32.0, 2));
+      iterator.Set(static_cast<short>(200.0 * std::exp(-std::pow(distance - 20.0, 2) / 8.0) + noise(generator)));
+    }
+
+    m_Image = mitk::GrabItkImageMemory(image);
+  }
+
+  void tearDown() override
+  {
+    m_Image = nullptr;
+  }
+
+  void Update_MovedEndPoint_EqualsFreshSearch()
+  {
+    const mitk::Point3D start = MakePoint(12, 32);
+    std::vector<mitk::Point3D> ends;
+    ends.push_back(MakePoint(32, 12));
+    ends.push_back(MakePoint(52, 32));
+    ends.push_back(MakePoint(20, 20));
+    ends.push_back(MakePoint(32, 52));
+    ends.push_back(MakePoint(32, 12));
+
+    mitk::ImageLiveWireContourModelFilter::Pointer filter = mitk::ImageLiveWireContourModelFilter::New();
+    filter->SetInput(m_Image);
+    filter->SetStartPoint(start);
+
+    for (auto end = ends.begin(); end != ends.end(); ++end)
+    {
+      filter->SetEndPoint(*end);
+      filter->Update();
+      this->AssertEqualPaths(this->FreshPath(start, *end), filter->GetOutput());
+    }
+  }
+
+  void Update_MovedStartPoint_EqualsFreshSearch()
+  {
+    mitk::ImageLiveWireContourModelFilter::Pointer filter = mitk::ImageLiveWireContourModelFilter::New();
+    filter->SetInput(m_Image);
+    filter->SetStartPoint(MakePoint(12, 32));
+    filter->SetEndPoint(MakePoint(52, 32));
+    filter->Update();
+
+    filter->SetStartPoint(MakePoint(32, 12));
+    filter->Update();
+    this->AssertEqualPaths(this->FreshPath(MakePoint(32, 12), MakePoint(52, 32)), filter->GetOutput());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkImageLiveWireContourModelFilter)
@@ -0,0 +1,221 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestingMacros.h"
+#include <mitkTestFixture.h>
+#include <mitkIncrementalFastMarching.h>
+
+#include <itkFastMarchingImageFilter.h>
+#include <itkImageRegionConstIterator.h>
+#include <itkImageRegionIterator.h>
+#include <itkTimeProbe.h>
+
+#include <cmath>
+#include <random>
+
+/**
+ * Compares the arrival times of the incremental fast marching to itk::FastMarchingImageFilter
+ * after adding seeds one by one and after increasing the stopping value.
+ */
+class mitkIncrementalFastMarchingTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkIncrementalFastMarchingTestSuite);
+  MITK_TEST(Update_AllSeeds_EqualFastMarchingFilter);
+  MITK_TEST(AddSeed_Incremental_EqualFastMarchingFilter);
+  MITK_TEST(SetStoppingValue_Larger_ContinuesMarching);
+  MITK_TEST(SetStoppingValue_Smaller_DoesNotMarch);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  typedef mitk::IncrementalFastMarching::ImageType ImageType;
+  typedef itk::FastMarchingImageFilter<ImageType, ImageType> FastMarchingFilterType;
+
+  ImageType::Pointer m_SpeedImage;
+  std::vector<ImageType::IndexType> m_Seeds;
+
+  ImageType::Pointer FastMarchingFilter(unsigned int numberOfSeeds, double stoppingValue)
+  {
+    FastMarchingFilterType::NodeContainer::Pointer trialPoints = FastMarchingFilterType::NodeContainer::New();
+    trialPoints->Initialize();
+    for (unsigned int i = 0; i < numberOfSeeds; ++i)
+    {
+      FastMarchingFilterType::NodeType node;
+      node.SetValue(0.0);
+      node.SetIndex(m_Seeds[i]);
+      trialPoints->InsertElement(i, node);
+    }
+
+    FastMarchingFilterType::Pointer fastMarching = FastMarchingFilterType::New();
+    fastMarching->SetInput(m_SpeedImage);
+    fastMarching->SetTrialPoints(trialPoints);
+    fastMarching->SetStoppingValue(stoppingValue);
+    fastMarching->Update();
+    return fastMarching->GetOutput();
+  }
+
+  /** largest difference of the arrival times up to stoppingValue, which have to be equal on both sides */
+  double MaximumDifference(ImageType* expected, ImageType* result, double stoppingValue)
+  {
+    double maximum = 0.0;
+    itk::ImageRegionConstIterator<ImageType> expectedIterator(expected, expected->GetBufferedRegion());
+    itk::ImageRegionConstIterator<ImageType> resultIterator(result, result->GetBufferedRegion());
+    for (; !expectedIterator.IsAtEnd(); ++expectedIterator, ++resultIterator)
+    {
+      if (expectedIterator.Get() <= stoppingValue || resultIterator.Get() <= stoppingValue)
+      {
+        maximum = std::max(maximum, std::abs(static_cast<double>(expectedIterator.Get()) - resultIterator.Get()));
+      }
+    }
+    return maximum;
+  }
+
+  mitk::IncrementalFastMarching::Pointer NewFastMarching(double stoppingValue)
+  {
+    mitk::IncrementalFastMarching::Pointer fastMarching = mitk::IncrementalFastMarching::New();
+    fastMarching->Initialize(m_SpeedImage);
+    fastMarching->SetSpeedImage(m_SpeedImage);
+    fastMarching->SetStoppingValue(stoppingValue);
+    return fastMarching;
+  }
+
+public:
+
+  void setUp() override
+  {
+    ImageType::SizeType size;
+    size[0] = 64;
+    size[1] = 56;
+    size[2] = 40;
+    ImageType::SpacingType spacing;
+    spacing[0] = 1.0;
+    spacing[1] = 1.0;
+    spacing[2] = 2.0;
+
+    m_SpeedImage = ImageType::New();
+    m_SpeedImage->SetRegions(size);
+    m_SpeedImage->SetSpacing(spacing);
+    m_SpeedImage->Allocate();
+
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<float> speed(0.2f, 1.0f);
+    itk::ImageRegionIterator<ImageType> iterator(m_SpeedImage, m_SpeedImage->GetBufferedRegion());
+    for (iterator.GoToBegin(); !iterator.IsAtEnd(); ++iterator)
+    {
+      iterator.Set(speed(generator));
+    }
+
+    const itk::IndexValueType seeds[3][3] = { { 10, 10, 10 }, { 40, 30, 20 }, { 30, 45, 5 } };
+    m_Seeds.resize(3);
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      for (unsigned int d = 0; d < 3; ++d)
+      {
+        m_Seeds[i][d] = seeds[i][d];
+      }
+    }
+  }
+
+  void tearDown() override
+  {
+    m_SpeedImage = nullptr;
+    m_Seeds.clear();
+  }
+
+  void Update_AllSeeds_EqualFastMarchingFilter()
+  {
+    mitk::IncrementalFastMarching::Pointer fastMarching = this->NewFastMarching(40.0);
+    for (unsigned int i = 0; i < m_Seeds.size(); ++i)
+    {
+      fastMarching->AddSeed(m_Seeds[i]);
+    }
+    fastMarching->Update();
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("The arrival times equal the ones of the fast marching filter.",
+      0.0, this->MaximumDifference(this->FastMarchingFilter(m_Seeds.size(), 40.0), fastMarching->GetArrivalTimes(), 40.0), 1e-4);
+  }
+
+  void AddSeed_Incremental_EqualFastMarchingFilter()
+  {
+    mitk::IncrementalFastMarching::Pointer fastMarching = this->NewFastMarching(60.0);
+    fastMarching->AddSeed(m_Seeds[0]);
+    fastMarching->Update();
+
+    itk::TimeProbe incrementalClock;
+    itk::TimeProbe filterClock;
+    for (unsigned int i = 1; i < m_Seeds.size(); ++i)
+    {
+      incrementalClock.Start();
+      fastMarching->AddSeed(m_Seeds[i]);
+      fastMarching->Update();
+      incrementalClock.Stop();
+
+      filterClock.Start();
+      ImageType::Pointer expected = this->FastMarchingFilter(i + 1, 60.0);
+      filterClock.Stop();
+
+      CPPUNIT_ASSERT_MESSAGE("Only the points lowered by the new seed are marched.",
+        fastMarching->GetNumberOfMarchedPoints() < m_SpeedImage->GetBufferedRegion().GetNumberOfPixels());
+      CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("The arrival times equal the ones of the fast marching filter.",
+        0.0, this->MaximumDifference(expected, fastMarching->GetArrivalTimes(), 60.0), 1e-2);
+    }
+
+    MITK_INFO << "Adding a seed: " << 1000.0 * incrementalClock.GetTotal() / (m_Seeds.size() - 1) << "ms (incremental), "
+              << 1000.0 * filterClock.GetTotal() / (m_Seeds.size() - 1) << "ms (fast marching filter)";
+  }
+
+  void SetStoppingValue_Larger_ContinuesMarching()
+  {
+    mitk::IncrementalFastMarching::Pointer fastMarching = this->NewFastMarching(20.0);
+    for (unsigned int i = 0; i < m_Seeds.size(); ++i)
+    {
+      fastMarching->AddSeed(m_Seeds[i]);
+    }
+    fastMarching->Update();
+    unsigned long marchedPoints = fastMarching->GetNumberOfMarchedPoints();
+
+    fastMarching->SetStoppingValue(40.0);
+    fastMarching->Update();
+
+    mitk::IncrementalFastMarching::Pointer reference = this->NewFastMarching(40.0);
+    for (unsigned int i = 0; i < m_Seeds.size(); ++i)
+    {
+      reference->AddSeed(m_Seeds[i]);
+    }
+    reference->Update();
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("The marching continues from the front of the smaller stopping value.",
+      reference->GetNumberOfMarchedPoints(), marchedPoints + fastMarching->GetNumberOfMarchedPoints());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("The arrival times equal the ones of the fast marching filter.",
+      0.0, this->MaximumDifference(this->FastMarchingFilter(m_Seeds.size(), 40.0), fastMarching->GetArrivalTimes(), 40.0), 1e-4);
+  }
+
+  void SetStoppingValue_Smaller_DoesNotMarch()
+  {
+    mitk::IncrementalFastMarching::Pointer fastMarching = this->NewFastMarching(40.0);
+    fastMarching->AddSeed(m_Seeds[0]);
+    fastMarching->Update();
+
+    fastMarching->SetStoppingValue(20.0);
+    fastMarching->Update();
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("A smaller stopping value does not march.", 0ul, fastMarching->GetNumberOfMarchedPoints());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("The arrival times up to the smaller stopping value are kept.",
+      0.0, this->MaximumDifference(this->FastMarchingFilter(1, 20.0), fastMarching->GetArrivalTimes(), 20.0), 1e-4);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkIncrementalFastMarching)
@@ -0,0 +1,205 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestingMacros.h"
+#include <mitkTestFixture.h>
+#include <mitkRegionGrowingFloodTree.h>
+
+#include <itkConnectedThresholdImageFilter.h>
+#include <itkImageRegionConstIterator.h>
+#include <itkImageRegionIterator.h>
+#include <itkTimeProbe.h>
+
+#include <random>
+
+/**
+ * Compares cuts of the flood tree to itk::ConnectedThresholdImageFilter for centered and shifted
+ * threshold intervals and reports the time of a threshold change for both.
+ */
+class mitkRegionGrowingFloodTreeTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkRegionGrowingFloodTreeTestSuite);
+  MITK_TEST(Cut_CenteredIntervals_EqualConnectedThreshold);
+  MITK_TEST(Cut_ShiftedIntervals_EqualConnectedThreshold);
+  MITK_TEST(Cut_SeedOutsideInterval_Empty);
+  MITK_TEST(Cut_ThresholdDrag_Runtime);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  typedef itk::Image<short, 2> ImageType;
+  typedef itk::Image<unsigned char, 2> OutputImageType;
+  typedef mitk::RegionGrowingFloodTree<ImageType> FloodTreeType;
+
+  ImageType::Pointer m_Image;
+  ImageType::IndexType m_Seed;
+  double m_ReferenceValue;
+
+  OutputImageType::Pointer NewOutputImage()
+  {
+    OutputImageType::Pointer output = OutputImageType::New();
+    output->CopyInformation(m_Image);
+    output->SetRegions(m_Image->GetBufferedRegion());
+    output->Allocate();
+    output->FillBuffer(0);
+    return output;
+  }
+
+  OutputImageType::Pointer ConnectedThreshold(short lower, short upper)
+  {
+    typedef itk::ConnectedThresholdImageFilter<ImageType, OutputImageType> RegionGrowingFilterType;
+    RegionGrowingFilterType::Pointer regionGrower = RegionGrowingFilterType::New();
+    regionGrower->SetInput(m_Image);
+    regionGrower->AddSeed(m_Seed);
+    regionGrower->SetLower(lower);
+    regionGrower->SetUpper(upper);
+    regionGrower->Update();
+    return regionGrower->GetOutput();
+  }
+
+  bool EqualRegions(OutputImageType* expected, OutputImageType* result)
+  {
+    itk::ImageRegionConstIterator<OutputImageType> expectedIterator(expected, expected->GetBufferedRegion());
+    itk::ImageRegionConstIterator<OutputImageType> resultIterator(result, result->GetBufferedRegion());
+    for (; !expectedIterator.IsAtEnd(); ++expectedIterator, ++resultIterator)
+    {
+      if ((expectedIterator.Get() > 0) != (resultIterator.Get() > 0))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+public:
+
+  void setUp() override
+  {
+    // smoothed noise with a bright blob around the seed
+    ImageType::SizeType size;
+    size.Fill(256);
+    m_Image = ImageType::New();
+    m_Image->SetRegions(size);
+    m_Image->Allocate();
+
+    std::mt19937 generator(42);
+    std::normal_distribution<double> noise(0, 20);
+    itk::ImageRegionIterator<ImageType> iterator(m_Image, m_Image->GetBufferedRegion());
+    for (iterator.GoToBegin(); !iterator.IsAtEnd(); ++iterator)
+    {
+      ImageType::IndexType index = iterator.GetIndex();
+      double distance = std::sqrt(std::pow(index[0] - 128.0, 2) + std::pow(index[1] - 110.0, 2));
+      iterator.Set(static_cast<short>(200.0 * std::exp(-distance / 60.0) + noise(generator)));
+    }
+
+    m_Seed[0] = 128;
+    m_Seed[1] = 110;
+    m_ReferenceValue = m_Image->GetPixel(m_Seed) + 0.5;
+  }
+
+  void tearDown() override
+  {
+    m_Image = nullptr;
+  }
+
+  void Cut_CenteredIntervals_EqualConnectedThreshold()
+  {
+    FloodTreeType::Pointer floodTree = FloodTreeType::New();
+    floodTree->Build(m_Image, m_Seed, m_ReferenceValue);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("The tree contains every pixel.", static_cast<std::size_t>(m_Image->GetBufferedRegion().GetNumberOfPixels()), floodTree->GetNumberOfNodes());
+
+    for (double deviation = 5; deviation <= 120; deviation += 5)
+    {
+      short lower = static_cast<short>(std::ceil(m_ReferenceValue - deviation));
+      short upper = static_cast<short>(std::floor(m_ReferenceValue + deviation));
+      OutputImageType::Pointer output = this->NewOutputImage();
+      floodTree->Cut(lower, upper, output.GetPointer(), 1);
+      CPPUNIT_ASSERT_MESSAGE("The cut equals the connected threshold region.", this->EqualRegions(this->ConnectedThreshold(lower, upper), output));
+    }
+  }
+
+  void Cut_ShiftedIntervals_EqualConnectedThreshold()
+  {
+    FloodTreeType::Pointer floodTree = FloodTreeType::New();
+    floodTree->Build(m_Image, m_Seed, m_ReferenceValue);
+
+    for (int shift = -40; shift <= 40; shift += 8)
+    {
+      short lower = static_cast<short>(m_ReferenceValue - 30 + shift);
+      short upper = static_cast<short>(m_ReferenceValue + 50 + shift);
+      OutputImageType::Pointer output = this->NewOutputImage();
+      OutputImageType::RegionType bounds = floodTree->Cut(lower, upper, output.GetPointer(), 1);
+      OutputImageType::Pointer expected = this->ConnectedThreshold(lower, upper);
+      CPPUNIT_ASSERT_MESSAGE("The cut equals the connected threshold region.", this->EqualRegions(expected, output));
+
+      // every pixel of the region lies inside of the bounds
+      itk::ImageRegionConstIterator<OutputImageType> iterator(expected, expected->GetBufferedRegion());
+      for (iterator.GoToBegin(); !iterator.IsAtEnd(); ++iterator)
+      {
+        if (iterator.Get() > 0)
+        {
+          CPPUNIT_ASSERT_MESSAGE("The region lies inside of the returned bounds.", bounds.IsInside(iterator.GetIndex()));
+        }
+      }
+    }
+  }
+
+  void Cut_SeedOutsideInterval_Empty()
+  {
+    FloodTreeType::Pointer floodTree = FloodTreeType::New();
+    floodTree->Build(m_Image, m_Seed, m_ReferenceValue);
+
+    short seedValue = m_Image->GetPixel(m_Seed);
+    OutputImageType::Pointer output = this->NewOutputImage();
+    OutputImageType::RegionType bounds = floodTree->Cut(seedValue + 1, seedValue + 100, output.GetPointer(), 1);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("The region is empty.", static_cast<itk::SizeValueType>(0), bounds.GetNumberOfPixels());
+  }
+
+  void Cut_ThresholdDrag_Runtime()
+  {
+    const unsigned int steps = 50;
+
+    itk::TimeProbe buildClock;
+    buildClock.Start();
+    FloodTreeType::Pointer floodTree = FloodTreeType::New();
+    floodTree->Build(m_Image, m_Seed, m_ReferenceValue);
+    buildClock.Stop();
+
+    itk::TimeProbe cutClock;
+    itk::TimeProbe filterClock;
+    for (unsigned int i = 0; i < steps; ++i)
+    {
+      short lower = static_cast<short>(m_ReferenceValue - 20 - i);
+      short upper = static_cast<short>(m_ReferenceValue + 20 + i);
+
+      cutClock.Start();
+      OutputImageType::Pointer output = this->NewOutputImage();
+      floodTree->Cut(lower, upper, output.GetPointer(), 1);
+      cutClock.Stop();
+
+      filterClock.Start();
+      OutputImageType::Pointer expected = this->ConnectedThreshold(lower, upper);
+      filterClock.Stop();
+
+      CPPUNIT_ASSERT_MESSAGE("The cut equals the connected threshold region.", this->EqualRegions(expected, output));
+    }
+
+    MITK_INFO << "Threshold change: " << 1000.0 * cutClock.GetTotal() / steps << "ms (flood tree cut, built in "
+              << 1000.0 * buildClock.GetTotal() << "ms), " << 1000.0 * filterClock.GetTotal() / steps << "ms (connected threshold filter)";
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkRegionGrowingFloodTree)
@@ -19,6 +19,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "QmitkStdMultiWidget.h"
 #include "QmitkSelectableGLWidget.h"
 
+#include "mitkAlignedSliceOverwrite.h"
 #include "mitkApplyDiffImageOperation.h"
 #include "mitkColorProperty.h"
 #include "mitkCoreObjectFactory.h"
@@ -1017,6 +1018,10 @@ void QmitkSlicesInterpolator::AcceptAllInterpolations(mitk::SliceNavigationContr
     mitk::Point3D origin = reslicePlane->GetOrigin();
     unsigned int totalChangedSlices(0);
 
+    // slices on the voxel grid of the diff image are collected and written together at the end
+    mitk::AlignedSliceOverwrite::Pointer alignedOverwrite = mitk::AlignedSliceOverwrite::New();
+    alignedOverwrite->SetVolume(diffImage);
+
     for (unsigned int sliceIndex = 0; sliceIndex < zslices; ++sliceIndex)
     {
       // Transforming the current origin of the reslice plane
@@ -1028,7 +1033,11 @@ void QmitkSlicesInterpolator::AcceptAllInterpolations(mitk::SliceNavigationContr
       //Set the slice as 'input'
       mitk::Image::Pointer interpolation = m_Interpolator->Interpolate( sliceDimension, sliceIndex, reslicePlane, timeStep );
 
-      if (interpolation.IsNotNull()) // we don't check if interpolation is necessary/sensible - but m_Interpolator does
+      if (interpolation.IsNotNull() && alignedOverwrite->AddSlice(interpolation, reslicePlane, 0))
+      {
+        ++totalChangedSlices;
+      }
+      else if (interpolation.IsNotNull()) // we don't check if interpolation is necessary/sensible - but m_Interpolator does
       {
         //Setting up the reslicing pipeline which allows us to write the interpolation results back into
         //the image volume
@@ -1052,6 +1061,8 @@ void QmitkSlicesInterpolator::AcceptAllInterpolations(mitk::SliceNavigationContr
       }
       mitk::ProgressBar::GetInstance()->Progress();
     }
+    // the interpolated slices do not overlap, so the order relative to the resliced ones does not matter
+    alignedOverwrite->Write();
     mitk::RenderingManager::GetInstance()->RequestUpdateAll();
 
     if (totalChangedSlices > 0)
@@ -29,6 +29,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkPoints.h>
 #include <vtkPolyData.h>
 #include <vtkSmartPointer.h>
+#include <vtkCellArray.h>
+
+#include <itkTimeProbe.h>
 
 /**
  *  @brief Test for the class "ToFDistanceImageToSurfaceFilter".
@@ -379,6 +382,68 @@ int mitkToFDistanceImageToSurfaceFilterTest(int /* argc */, char* /*argv*/[])
   }
   MITK_TEST_CONDITION_REQUIRED(compareToInput,"Testing backward transformation compared to original image with interpixeldistance");
 
+  // test persistent topology mode: one point per pixel, valid points as in the default mode
+  filter->SetPersistentTopology(true);
+  filter->Modified();
+  filter->Update();
+  vtkPolyData* persistentMesh = filter->GetOutput()->GetVtkPolyData();
+  MITK_TEST_CONDITION_REQUIRED(persistentMesh->GetNumberOfPoints() == dimX*dimY, "Testing number of points in persistent topology mode");
+  MITK_TEST_CONDITION_REQUIRED(persistentMesh->GetNumberOfPolys() == 2*(dimX-1)*(dimY-1), "Testing number of triangles in persistent topology mode");
+  bool persistentPointsEqual = true;
+  for (unsigned int pixelID=0; pixelID<dimX*dimY; pixelID++)
+  {
+    itk::Index<3> index;
+    index[0] = pixelID%dimX;
+    index[1] = pixelID/dimX;
+    index[2] = 0;
+    float distance = 0.0;
+    try
+    {
+      mitk::ImageRegionAccessor readAccess(image);
+      distance = *(float*)readAccess.getPixel(index);
+    }
+    catch(mitk::Exception& e)
+    {
+      MITK_ERROR << "Image read exception!" << e.what();
+    }
+    if (distance<=mitk::eps)
+    {
+      continue;
+    }
+    ToFPoint3D expectedPoint = mitk::ToFProcessingCommon::IndexToCartesianCoordinatesWithInterpixdist(index[0],index[1],distance,focalLength,interPixelDistance,principalPoint);
+    double* res = persistentMesh->GetPoint(pixelID);
+    ToFPoint3D resultPoint;
+    resultPoint[0] = res[0];
+    resultPoint[1] = res[1];
+    resultPoint[2] = res[2];
+    if (!mitk::Equal(expectedPoint,resultPoint))
+    {
+      persistentPointsEqual = false;
+    }
+  }
+  MITK_TEST_CONDITION_REQUIRED(persistentPointsEqual,"Testing points in persistent topology mode");
+
+  // frame rate of both modes on synthetic range data of VGA size
+  mitk::Image::Pointer rangeImage = mitk::ImageGenerator::GenerateRandomImage<float>(640,480,1,1,1,1,1,2000.0,500.0);
+  mitk::ToFDistanceImageToSurfaceFilter::Pointer benchmarkFilter = mitk::ToFDistanceImageToSurfaceFilter::New();
+  benchmarkFilter->SetCameraIntrinsics(cameraIntrinsics);
+  benchmarkFilter->SetInput(rangeImage);
+  for (int persistent = 0; persistent < 2; persistent++)
+  {
+    benchmarkFilter->SetPersistentTopology(persistent == 1);
+    itk::TimeProbe timeProbe;
+    const int numberOfFrames = 30;
+    for (int frame = 0; frame < numberOfFrames; frame++)
+    {
+      rangeImage->Modified();
+      timeProbe.Start();
+      benchmarkFilter->Update();
+      timeProbe.Stop();
+    }
+    MITK_INFO << "ToFDistanceImageToSurfaceFilter " << (persistent ? "with" : "without") << " persistent topology: "
+              << numberOfFrames / timeProbe.GetTotal() << " frames/s";
+  }
+
   //clean up
   delete point;
   //  expectedResult->Delete();
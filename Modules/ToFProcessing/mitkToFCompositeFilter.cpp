@@ -19,17 +19,21 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <itkImage.h>
 
+#include <algorithm>
+#include <cstring>
+
 mitk::ToFCompositeFilter::ToFCompositeFilter() : m_SegmentationMask(nullptr), m_ImageWidth(0), m_ImageHeight(0), m_ImageSize(0),
 m_IplDistanceImage(nullptr), m_IplOutputImage(nullptr), m_ItkInputImage(nullptr), m_ApplyTemporalMedianFilter(false), m_ApplyAverageFilter(false),
   m_ApplyMedianFilter(false), m_ApplyThresholdFilter(false), m_ApplyMaskSegmentation(false), m_ApplyBilateralFilter(false), m_DataBuffer(nullptr),
 m_DataBufferCurrentIndex(0), m_DataBufferMaxSize(0), m_TemporalMedianFilterNumOfFrames(10), m_ThresholdFilterMin(1),
-m_ThresholdFilterMax(7000), m_BilateralFilterDomainSigma(2), m_BilateralFilterRangeSigma(60), m_BilateralFilterKernelRadius(0)
+m_ThresholdFilterMax(7000), m_BilateralFilterDomainSigma(2), m_BilateralFilterRangeSigma(60), m_BilateralFilterKernelRadius(0),
+m_BilateralFilter(BilateralFilterType::New())
 {
 }
 
 mitk::ToFCompositeFilter::~ToFCompositeFilter()
 {
-  cvReleaseImage(&(this->m_IplDistanceImage));
+  cvReleaseImageHeader(&(this->m_IplDistanceImage));
   cvReleaseImage(&(this->m_IplOutputImage));
   if (m_DataBuffer!=nullptr)
   {
@@ -58,13 +62,12 @@ void mitk::ToFCompositeFilter::SetInput( unsigned int idx,  mitk::Image* distanc
         this->m_ImageHeight = distanceImage->GetDimension(1);
         this->m_ImageSize = this->m_ImageWidth * this->m_ImageHeight * sizeof(float);
 
+        // only a header, the data is set to the output buffer in GenerateData()
         if (this->m_IplDistanceImage != nullptr)
         {
-          cvReleaseImage(&(this->m_IplDistanceImage));
+          cvReleaseImageHeader(&(this->m_IplDistanceImage));
         }
-        float* distanceFloatData = (float*) distanceImage->GetSliceData()->GetData();
-        this->m_IplDistanceImage = cvCreateImage(cvSize(this->m_ImageWidth, this->m_ImageHeight), IPL_DEPTH_32F, 1);
-        memcpy(this->m_IplDistanceImage->imageData, (void*)distanceFloatData, this->m_ImageSize);
+        this->m_IplDistanceImage = cvCreateImageHeader(cvSize(this->m_ImageWidth, this->m_ImageHeight), IPL_DEPTH_32F, 1);
 
         if (this->m_IplOutputImage != nullptr)
         {
@@ -103,38 +106,53 @@ void mitk::ToFCompositeFilter::GenerateData()
     if (outputImage.IsNotNull()&&inputImage.IsNotNull())
     {
       outputImage->CopyInformation(inputImage);
-      outputImage->Initialize(inputImage->GetPixelType(),inputImage->GetDimension(),inputImage->GetDimensions());
+      // keep the output buffer if the image format did not change
+      if (!outputImage->IsInitialized() || outputImage->GetPixelType() != inputImage->GetPixelType()
+        || outputImage->GetDimension() != inputImage->GetDimension()
+        || memcmp(outputImage->GetDimensions(), inputImage->GetDimensions(), inputImage->GetDimension()*sizeof(unsigned int)) != 0)
+      {
+        outputImage->Initialize(inputImage->GetPixelType(),inputImage->GetDimension(),inputImage->GetDimensions());
+      }
       outputImage->SetSlice(inputImage->GetSliceData()->GetData());
     }
   }
+  // the distance data is processed in place in the buffer of output 0, the spatial filters
+  // alternate between this buffer and m_IplOutputImage
   float* outputDistanceFloatData = (float*) this->GetOutput()->GetSliceData()->GetData();
-  // copy initial distance image to ipl image
-  float* distanceFloatData = (float*) this->GetInput()->GetSliceData()->GetData();
-  memcpy(this->m_IplDistanceImage->imageData, (void*)distanceFloatData, this->m_ImageSize);
+  cvSetData(this->m_IplDistanceImage, outputDistanceFloatData, this->m_ImageWidth*sizeof(float));
+  IplImage* currentImage = this->m_IplDistanceImage;
+  IplImage* otherImage = this->m_IplOutputImage;
+
   if (m_ApplyThresholdFilter||m_ApplyMaskSegmentation)
   {
-    ProcessSegmentation(this->m_IplDistanceImage);
+    ProcessSegmentation(currentImage);
   }
   if (this->m_ApplyTemporalMedianFilter||this->m_ApplyAverageFilter)
   {
-    ProcessStreamedQuickSelectMedianImageFilter(this->m_IplDistanceImage);
+    ProcessStreamedQuickSelectMedianImageFilter(currentImage);
   }
   if (this->m_ApplyMedianFilter)
   {
-    ProcessCVMedianFilter(this->m_IplDistanceImage, this->m_IplOutputImage);
-    memcpy( this->m_IplDistanceImage->imageData, this->m_IplOutputImage->imageData, this->m_ImageSize );
+    ProcessCVMedianFilter(currentImage, otherImage);
+    std::swap(currentImage, otherImage);
   }
   if (this->m_ApplyBilateralFilter)
   {
-      float* itkFloatData = this->m_ItkInputImage->GetBufferPointer();
-      memcpy(itkFloatData, this->m_IplDistanceImage->imageData, this->m_ImageSize );
-      ItkImageType2D::Pointer itkOutputImage = ProcessItkBilateralFilter(this->m_ItkInputImage);
-      memcpy( this->m_IplDistanceImage->imageData, itkOutputImage->GetBufferPointer(), this->m_ImageSize );
+    // the ITK image imports the current buffer, the result is written to the output directly
+    this->m_ItkInputImage->GetPixelContainer()->SetImportPointer((float*)currentImage->imageData,
+                                                                  this->m_ImageWidth*this->m_ImageHeight, false);
+    this->m_ItkInputImage->Modified();
+    ItkImageType2D::Pointer itkOutputImage = ProcessItkBilateralFilter(this->m_ItkInputImage);
+    memcpy( outputDistanceFloatData, itkOutputImage->GetBufferPointer(), this->m_ImageSize );
+    currentImage = this->m_IplDistanceImage;
 
     //ProcessCVBilateralFilter(this->m_IplDistanceImage, this->m_OutputIplImage, domainSigma, rangeSigma, kernelRadius);
     //memcpy( distanceFloatData, this->m_OutputIplImage->imageData, distanceImageSize );
   }
-  memcpy( outputDistanceFloatData, this->m_IplDistanceImage->imageData, this->m_ImageSize );
+  if (currentImage != this->m_IplDistanceImage)
+  {
+    memcpy( outputDistanceFloatData, currentImage->imageData, this->m_ImageSize );
+  }
 }
 
 void mitk::ToFCompositeFilter::CreateOutputsForAllInputs()
@@ -204,12 +222,11 @@ void mitk::ToFCompositeFilter::ProcessSegmentation(IplImage* inputIplImage)
 ItkImageType2D::Pointer mitk::ToFCompositeFilter::ProcessItkBilateralFilter(ItkImageType2D::Pointer inputItkImage)
 {
   ItkImageType2D::Pointer outputItkImage;
-  BilateralFilterType::Pointer bilateralFilter = BilateralFilterType::New();
-  bilateralFilter->SetInput(inputItkImage);
-  bilateralFilter->SetDomainSigma(m_BilateralFilterDomainSigma);
-  bilateralFilter->SetRangeSigma(m_BilateralFilterRangeSigma);
-  //bilateralFilter->SetRadius(m_BilateralFilterKernelRadius);
-  outputItkImage = bilateralFilter->GetOutput();
+  m_BilateralFilter->SetInput(inputItkImage);
+  m_BilateralFilter->SetDomainSigma(m_BilateralFilterDomainSigma);
+  m_BilateralFilter->SetRangeSigma(m_BilateralFilterRangeSigma);
+  //m_BilateralFilter->SetRadius(m_BilateralFilterKernelRadius);
+  outputItkImage = m_BilateralFilter->GetOutput();
   outputItkImage->Update();
   return outputItkImage;
 }
@@ -232,7 +249,6 @@ void mitk::ToFCompositeFilter::ProcessStreamedQuickSelectMedianImageFilter(IplIm
   float* data = (float*)inputIplImage->imageData;
 
   int imageSize = inputIplImage->width * inputIplImage->height;
-  float* tmpArray;
 
   if (this->m_TemporalMedianFilterNumOfFrames == 0)
   {
@@ -262,7 +278,8 @@ void mitk::ToFCompositeFilter::ProcessStreamedQuickSelectMedianImageFilter(IplIm
   }
 
   int currentBufferSize = this->m_DataBufferMaxSize;
-  tmpArray = new float[this->m_DataBufferMaxSize];
+  m_TemporalMedianValues.resize(this->m_DataBufferMaxSize);
+  float* tmpArray = &m_TemporalMedianValues[0];
 
   // copy data to buffer
   if (this->m_DataBuffer[this->m_DataBufferCurrentIndex] == nullptr)
@@ -299,8 +316,6 @@ void mitk::ToFCompositeFilter::ProcessStreamedQuickSelectMedianImageFilter(IplIm
   }
 
   this->m_DataBufferCurrentIndex = (this->m_DataBufferCurrentIndex + 1) % this->m_DataBufferMaxSize;
-
-  delete[] tmpArray;
 }
 
 #define ELEM_SWAP(a,b) { register float t=(a);(a)=(b);(b)=t; }
@@ -22,6 +22,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <cv.h>
 #include <itkBilateralImageFilter.h>
 
+#include <vector>
+
 typedef itk::Image<float, 2> ItkImageType2D;
 typedef itk::Image<float, 3> ItkImageType3D;
 typedef itk::BilateralImageFilter<ItkImageType2D,ItkImageType2D> BilateralFilterType;
@@ -171,10 +173,10 @@ namespace mitk
     int m_ImageHeight; ///< y-dimension of the image
     int m_ImageSize; ///< size of the image in bytes
 
-    IplImage* m_IplDistanceImage; ///< OpenCV-representation of the distance image
-    IplImage* m_IplOutputImage; ///< OpenCV-representation of the output image
+    IplImage* m_IplDistanceImage; ///< OpenCV header for the distance data of output 0, which is processed in place
+    IplImage* m_IplOutputImage; ///< OpenCV image used as second buffer by the spatial filters
 
-    ItkImageType2D::Pointer m_ItkInputImage; ///< ITK representation of the distance image
+    ItkImageType2D::Pointer m_ItkInputImage; ///< ITK image importing the current distance data without copying it
 
     bool m_ApplyTemporalMedianFilter; ///< Flag indicating if the temporal median filter is currently active for processing the distance image
     bool m_ApplyAverageFilter; ///< Flag indicating if the average filter is currently active for processing the distance image
@@ -194,6 +196,9 @@ namespace mitk
     double m_BilateralFilterRangeSigma; ///< Parameter of the bilateral filter controlling the edge preserving effect of the filter. Default value: 60
     int m_BilateralFilterKernelRadius; ///< Kernel radius of the bilateral filter mask
 
+    BilateralFilterType::Pointer m_BilateralFilter; ///< Bilateral filter, kept between frames
+    std::vector<float> m_TemporalMedianValues; ///< Values of one pixel over the buffered frames, reused for every pixel
+
   };
 } //END mitk namespace
 #endif
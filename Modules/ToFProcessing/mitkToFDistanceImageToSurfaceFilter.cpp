@@ -25,16 +25,20 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkPolyData.h>
 #include <vtkPointData.h>
 #include <vtkFloatArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkUnsignedCharArray.h>
 #include <vtkSmartPointer.h>
 #include <vtkIdList.h>
 
 #include <math.h>
+#include <string.h>
 #include <vtkMath.h>
 
 mitk::ToFDistanceImageToSurfaceFilter::ToFDistanceImageToSurfaceFilter() :
   m_IplScalarImage(nullptr), m_CameraIntrinsics(), m_TextureImageWidth(0), m_TextureImageHeight(0), m_InterPixelDistance(), m_TextureIndex(0),
-  m_GenerateTriangularMesh(true), m_TriangulationThreshold(0.0)
+  m_GenerateTriangularMesh(true), m_TriangulationThreshold(0.0), m_PersistentTopology(false), m_RayZ(0.0)
 {
+  m_PersistentDimensions[0] = m_PersistentDimensions[1] = 0;
   m_InterPixelDistance.Fill(0.045);
   m_CameraIntrinsics = mitk::CameraIntrinsics::New();
   m_CameraIntrinsics->SetFocalLength(273.138946533,273.485900879);
@@ -98,6 +102,37 @@ void mitk::ToFDistanceImageToSurfaceFilter::GenerateData()
   int xDimension = input->GetDimension(0);
   int yDimension = input->GetDimension(1);
   unsigned int size = xDimension*yDimension; //size of the image-array
+
+  float* scalarFloatData = nullptr;
+
+  if (this->m_IplScalarImage) // if scalar image is defined use it for texturing
+  {
+    scalarFloatData = (float*)this->m_IplScalarImage->imageData;
+  }
+  else if (this->GetInput(m_TextureIndex)) // otherwise use intensity image (input(2))
+  {
+    scalarFloatData = (float*)this->GetInput(m_TextureIndex)->GetVolumeData()->GetData();
+  }
+
+  float* inputFloatData = (float*) input->GetSliceData()->GetData();
+
+  //calculate world coordinates of all pixels at once
+  this->UpdateRayTable(input);
+
+  if (m_PersistentTopology)
+  {
+    this->InitializePersistentTopology(xDimension, yDimension);
+    this->GeneratePersistentTopologyData(inputFloatData, scalarFloatData, xDimension, yDimension);
+    output->SetVtkPolyData(m_PersistentMesh);
+    // the mesh is updated in place, so the surface does not notice the change by itself
+    output->CalculateBoundingBox();
+    output->Modified();
+    return;
+  }
+
+  m_Coordinates.resize(3 * size);
+  this->ComputeCoordinates(inputFloatData, &m_Coordinates[0]);
+
   std::vector<bool> isPointValid;
   isPointValid.resize(size);
   vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
@@ -121,39 +156,6 @@ void mitk::ToFDistanceImageToSurfaceFilter::GenerateData()
     m_VertexIdList->SetId(i, 0);
   }
 
-  float* scalarFloatData = nullptr;
-
-  if (this->m_IplScalarImage) // if scalar image is defined use it for texturing
-  {
-    scalarFloatData = (float*)this->m_IplScalarImage->imageData;
-  }
-  else if (this->GetInput(m_TextureIndex)) // otherwise use intensity image (input(2))
-  {
-    scalarFloatData = (float*)this->GetInput(m_TextureIndex)->GetVolumeData()->GetData();
-  }
-
-  float* inputFloatData = (float*) input->GetSliceData()->GetData();
-  //calculate world coordinates
-  mitk::ToFProcessingCommon::ToFPoint2D focalLengthInPixelUnits;
-  mitk::ToFProcessingCommon::ToFScalarType focalLengthInMm;
-  if((m_ReconstructionMode == WithOutInterPixelDistance) || (m_ReconstructionMode == Kinect))
-  {
-    focalLengthInPixelUnits[0] = m_CameraIntrinsics->GetFocalLengthX();
-    focalLengthInPixelUnits[1] = m_CameraIntrinsics->GetFocalLengthY();
-  }
-  else if( m_ReconstructionMode == WithInterPixelDistance)
-  {
-    //convert focallength from pixel to mm
-    focalLengthInMm = (m_CameraIntrinsics->GetFocalLengthX()*m_InterPixelDistance[0]+m_CameraIntrinsics->GetFocalLengthY()*m_InterPixelDistance[1])/2.0;
-  }
-
-  mitk::ToFProcessingCommon::ToFPoint2D principalPoint;
-  principalPoint[0] = m_CameraIntrinsics->GetPrincipalPointX();
-  principalPoint[1] = m_CameraIntrinsics->GetPrincipalPointY();
-
-  mitk::Point3D origin = input->GetGeometry()->GetOrigin();
-  mitk::Vector3D spacing = input->GetGeometry()->GetSpacing();
-
   for (int j=0; j<yDimension; j++)
   {
     for (int i=0; i<xDimension; i++)
@@ -162,35 +164,6 @@ void mitk::ToFDistanceImageToSurfaceFilter::GenerateData()
 
       mitk::ToFProcessingCommon::ToFScalarType distance = (double)inputFloatData[pixelID];
 
-      /** Here we have to incorporate spacing and origin to allow processing of cropped/resampled images
-      * Usually origin will be [0, 0, 0] and spacing will be [1, 1, 1], but just in case the image is moved
-      * due to cropping or the spacing differes due to up- or downsampling.*/
-      unsigned int completeIndexX = i*spacing[0]+origin[0];
-      unsigned int completeIndexY = j*spacing[1]+origin[1];
-
-      mitk::ToFProcessingCommon::ToFPoint3D cartesianCoordinates;
-      switch (m_ReconstructionMode)
-      {
-      case WithOutInterPixelDistance:
-      {
-        cartesianCoordinates = mitk::ToFProcessingCommon::IndexToCartesianCoordinates(completeIndexX,completeIndexY,distance,focalLengthInPixelUnits,principalPoint);
-        break;
-      }
-      case WithInterPixelDistance:
-      {
-        cartesianCoordinates = mitk::ToFProcessingCommon::IndexToCartesianCoordinatesWithInterpixdist(completeIndexX,completeIndexY,distance,focalLengthInMm,m_InterPixelDistance,principalPoint);
-        break;
-      }
-      case Kinect:
-      {
-        cartesianCoordinates = mitk::ToFProcessingCommon::KinectIndexToCartesianCoordinates(completeIndexX,completeIndexY,distance,focalLengthInPixelUnits,principalPoint);
-        break;
-      }
-      default:
-      {
-        MITK_ERROR << "Incorrect reconstruction mode!";
-      }
-      }
       //Epsilon here, because we may have small float values like 0.00000001 which in fact represents 0.
       if (distance<=mitk::eps)
       {
@@ -204,7 +177,7 @@ void mitk::ToFDistanceImageToSurfaceFilter::GenerateData()
         //If we use points->InsertNextPoint(...) instead, the ID's do not
         //correspond to the image pixel ID's. Thus, we have to save them
         //in the vertexIdList.
-        m_VertexIdList->SetId(pixelID, points->InsertNextPoint(cartesianCoordinates.GetDataPointer()));
+        m_VertexIdList->SetId(pixelID, points->InsertNextPoint(&m_Coordinates[3 * pixelID]));
 
         if (m_GenerateTriangularMesh)
         {
@@ -299,6 +272,325 @@ void mitk::ToFDistanceImageToSurfaceFilter::GenerateData()
   output->SetVtkPolyData(mesh);
 }
 
+void mitk::ToFDistanceImageToSurfaceFilter::UpdateRayTable(mitk::Image* input)
+{
+  const int xDimension = input->GetDimension(0);
+  const int yDimension = input->GetDimension(1);
+  const mitk::Point3D origin = input->GetGeometry()->GetOrigin();
+  const mitk::Vector3D spacing = input->GetGeometry()->GetSpacing();
+
+  std::vector<double> parameters;
+  parameters.push_back(xDimension);
+  parameters.push_back(yDimension);
+  parameters.push_back(m_ReconstructionMode);
+  parameters.push_back(m_CameraIntrinsics->GetFocalLengthX());
+  parameters.push_back(m_CameraIntrinsics->GetFocalLengthY());
+  parameters.push_back(m_CameraIntrinsics->GetPrincipalPointX());
+  parameters.push_back(m_CameraIntrinsics->GetPrincipalPointY());
+  parameters.push_back(m_InterPixelDistance[0]);
+  parameters.push_back(m_InterPixelDistance[1]);
+  parameters.push_back(origin[0]);
+  parameters.push_back(origin[1]);
+  parameters.push_back(spacing[0]);
+  parameters.push_back(spacing[1]);
+  if (parameters == m_RayTableParameters)
+  {
+    return;
+  }
+  m_RayTableParameters = parameters;
+
+  const unsigned int size = xDimension*yDimension;
+  m_RayX.assign(size, 0.0);
+  m_RayY.assign(size, 0.0);
+  m_RayNorm.assign(size, 1.0);
+  m_RayZ = 0.0;
+
+  const double focalLengthX = m_CameraIntrinsics->GetFocalLengthX();
+  const double focalLengthY = m_CameraIntrinsics->GetFocalLengthY();
+  const double principalPointX = m_CameraIntrinsics->GetPrincipalPointX();
+  const double principalPointY = m_CameraIntrinsics->GetPrincipalPointY();
+  //convert focallength from pixel to mm
+  const double focalLengthInMm = (focalLengthX*m_InterPixelDistance[0]+focalLengthY*m_InterPixelDistance[1])/2.0;
+
+  switch (m_ReconstructionMode)
+  {
+  case WithOutInterPixelDistance:
+    m_RayZ = focalLengthX;
+    break;
+  case WithInterPixelDistance:
+    m_RayZ = focalLengthInMm;
+    break;
+  case Kinect:
+    m_RayZ = 1.0;
+    break;
+  default:
+    MITK_ERROR << "Incorrect reconstruction mode!";
+    return;
+  }
+
+  // The rays follow the computations of ToFProcessingCommon::IndexToCartesianCoordinates(),
+  // IndexToCartesianCoordinatesWithInterpixdist() and KinectIndexToCartesianCoordinates() term by term,
+  // so the coordinates are identical to the ones of these methods.
+  for (int j=0; j<yDimension; j++)
+  {
+    for (int i=0; i<xDimension; i++)
+    {
+      unsigned int pixelID = i+j*xDimension;
+
+      /** Here we have to incorporate spacing and origin to allow processing of cropped/resampled images
+      * Usually origin will be [0, 0, 0] and spacing will be [1, 1, 1], but just in case the image is moved
+      * due to cropping or the spacing differes due to up- or downsampling.*/
+      unsigned int completeIndexX = i*spacing[0]+origin[0];
+      unsigned int completeIndexY = j*spacing[1]+origin[1];
+
+      switch (m_ReconstructionMode)
+      {
+      case WithOutInterPixelDistance:
+      {
+        ToFProcessingCommon::ToFScalarType imageX = completeIndexX - principalPointX;
+        ToFProcessingCommon::ToFScalarType imageY = completeIndexY - principalPointY;
+        ToFProcessingCommon::ToFScalarType imageY_in_pX = imageY * (focalLengthX / focalLengthY);
+        m_RayX[pixelID] = imageX;
+        m_RayY[pixelID] = imageY_in_pX;
+        m_RayNorm[pixelID] = sqrt(imageX*imageX + imageY_in_pX*imageY_in_pX + focalLengthX*focalLengthX);
+        break;
+      }
+      case WithInterPixelDistance:
+      {
+        ToFProcessingCommon::ToFScalarType imageX = (( completeIndexX - principalPointX ) * m_InterPixelDistance[0]);
+        ToFProcessingCommon::ToFScalarType imageY = (( completeIndexY - principalPointY ) * m_InterPixelDistance[1]);
+        m_RayX[pixelID] = imageX;
+        m_RayY[pixelID] = imageY;
+        m_RayNorm[pixelID] = sqrt(imageX*imageX + imageY*imageY + focalLengthInMm*focalLengthInMm);
+        break;
+      }
+      default: // Kinect
+      {
+        m_RayX[pixelID] = completeIndexX - principalPointX;
+        m_RayY[pixelID] = completeIndexY - principalPointY;
+        break;
+      }
+      }
+    }
+  }
+}
+
+void mitk::ToFDistanceImageToSurfaceFilter::ComputeCoordinates(const float* distances, double* coordinates) const
+{
+  const int size = static_cast<int>(m_RayX.size());
+  const double* rayX = m_RayX.data();
+  const double* rayY = m_RayY.data();
+  const double* rayNorm = m_RayNorm.data();
+  const double rayZ = m_RayZ;
+
+  if (m_ReconstructionMode == Kinect)
+  {
+    const double focalLengthX = m_CameraIntrinsics->GetFocalLengthX();
+    const double focalLengthY = m_CameraIntrinsics->GetFocalLengthY();
+    for (int p = 0; p < size; ++p)
+    {
+      const double distance = distances[p];
+      coordinates[3*p] = distance * rayX[p] / focalLengthX;
+      coordinates[3*p+1] = distance * rayY[p] / focalLengthY;
+      coordinates[3*p+2] = distance;
+    }
+  }
+  else
+  {
+    for (int p = 0; p < size; ++p)
+    {
+      const double distance = distances[p];
+      coordinates[3*p] = distance * rayX[p] / rayNorm[p];
+      coordinates[3*p+1] = distance * rayY[p] / rayNorm[p];
+      coordinates[3*p+2] = distance * rayZ / rayNorm[p];
+    }
+  }
+}
+
+void mitk::ToFDistanceImageToSurfaceFilter::InitializePersistentTopology(int xDimension, int yDimension)
+{
+  if (m_PersistentMesh != nullptr && m_PersistentDimensions[0] == xDimension && m_PersistentDimensions[1] == yDimension)
+  {
+    return;
+  }
+  m_PersistentDimensions[0] = xDimension;
+  m_PersistentDimensions[1] = yDimension;
+
+  const vtkIdType size = xDimension*yDimension;
+  const vtkIdType numberOfTriangles = (xDimension > 1 && yDimension > 1) ? 2*(xDimension-1)*(yDimension-1) : 0;
+
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetDataTypeToDouble();
+  points->SetNumberOfPoints(size);
+
+  vtkSmartPointer<vtkFloatArray> textureCoords = vtkSmartPointer<vtkFloatArray>::New();
+  textureCoords->SetNumberOfComponents(2);
+  textureCoords->SetNumberOfTuples(size);
+
+  vtkSmartPointer<vtkUnsignedCharArray> validPoints = vtkSmartPointer<vtkUnsignedCharArray>::New();
+  validPoints->SetName("ValidPoints");
+  validPoints->SetNumberOfTuples(size);
+
+  // point IDs equal the pixel IDs
+  m_VertexIdList = vtkSmartPointer<vtkIdList>::New();
+  m_VertexIdList->SetNumberOfIds(size);
+  for (int j=0; j<yDimension; j++)
+  {
+    for (int i=0; i<xDimension; i++)
+    {
+      vtkIdType pixelID = i+j*xDimension;
+      m_VertexIdList->SetId(pixelID, pixelID);
+      textureCoords->SetTuple2(pixelID, ((float)i)/xDimension, ((float)j)/yDimension);
+    }
+  }
+
+  // the connectivity is written for every frame, here only the memory is allocated
+  vtkSmartPointer<vtkIdTypeArray> polyIds = vtkSmartPointer<vtkIdTypeArray>::New();
+  polyIds->SetNumberOfValues(4*numberOfTriangles);
+  vtkIdType* polyIdData = polyIds->GetPointer(0);
+  for (vtkIdType t = 0; t < numberOfTriangles; ++t)
+  {
+    polyIdData[4*t] = 3;
+    polyIdData[4*t+1] = polyIdData[4*t+2] = polyIdData[4*t+3] = 0;
+  }
+  m_PersistentPolys = vtkSmartPointer<vtkCellArray>::New();
+  m_PersistentPolys->SetCells(numberOfTriangles, polyIds);
+
+  vtkSmartPointer<vtkIdTypeArray> vertexIds = vtkSmartPointer<vtkIdTypeArray>::New();
+  vertexIds->SetNumberOfValues(2*size);
+  vtkIdType* vertexIdData = vertexIds->GetPointer(0);
+  for (vtkIdType p = 0; p < size; ++p)
+  {
+    vertexIdData[2*p] = 1;
+    vertexIdData[2*p+1] = p;
+  }
+  m_PersistentVertices = vtkSmartPointer<vtkCellArray>::New();
+  m_PersistentVertices->SetCells(size, vertexIds);
+
+  m_PersistentMesh = vtkSmartPointer<vtkPolyData>::New();
+  m_PersistentMesh->SetPoints(points);
+  m_PersistentMesh->GetPointData()->SetTCoords(textureCoords);
+  m_PersistentMesh->GetPointData()->AddArray(validPoints);
+}
+
+void mitk::ToFDistanceImageToSurfaceFilter::GeneratePersistentTopologyData(const float* distances, const float* scalars, int xDimension, int yDimension)
+{
+  const vtkIdType size = xDimension*yDimension;
+
+  vtkPoints* points = m_PersistentMesh->GetPoints();
+  double* coordinates = vtkDoubleArray::SafeDownCast(points->GetData())->GetPointer(0);
+  this->ComputeCoordinates(distances, coordinates);
+
+  vtkUnsignedCharArray* validPoints = vtkUnsignedCharArray::SafeDownCast(m_PersistentMesh->GetPointData()->GetArray("ValidPoints"));
+  unsigned char* isPointValid = validPoints->GetPointer(0);
+
+  //Epsilon here, because we may have small float values like 0.00000001 which in fact represents 0.
+  vtkIdType fallbackID = -1;
+  for (vtkIdType p = 0; p < size; ++p)
+  {
+    isPointValid[p] = (double)distances[p] > mitk::eps ? 1 : 0;
+    if (fallbackID < 0 && isPointValid[p])
+    {
+      fallbackID = p;
+    }
+  }
+  if (fallbackID < 0)
+  {
+    fallbackID = 0;
+  }
+
+  // invalid points are placed onto a valid one, so they do not change the bounds of the surface
+  for (vtkIdType p = 0; p < size; ++p)
+  {
+    if (!isPointValid[p])
+    {
+      coordinates[3*p] = coordinates[3*fallbackID];
+      coordinates[3*p+1] = coordinates[3*fallbackID+1];
+      coordinates[3*p+2] = coordinates[3*fallbackID+2];
+    }
+  }
+
+  if (m_GenerateTriangularMesh)
+  {
+    vtkIdType* ids = m_PersistentPolys->GetData()->GetPointer(0);
+    for (int j=1; j<yDimension; j++)
+    {
+      for (int i=1; i<xDimension; i++)
+      {
+        // see GenerateData() for the naming of the vertices
+        vtkIdType xy = i+j*xDimension;
+        vtkIdType x_1y = xy-1;
+        vtkIdType xy_1 = xy-xDimension;
+        vtkIdType x_1y_1 = xy_1-1;
+
+        bool triangulate = isPointValid[xy] && isPointValid[x_1y] && isPointValid[x_1y_1] && isPointValid[xy_1];
+        if (triangulate && !mitk::Equal(m_TriangulationThreshold, 0.0))
+        {
+          triangulate = (vtkMath::Distance2BetweenPoints(&coordinates[3*xy], &coordinates[3*x_1y]) <= m_TriangulationThreshold)
+            && (vtkMath::Distance2BetweenPoints(&coordinates[3*xy], &coordinates[3*xy_1]) <= m_TriangulationThreshold)
+            && (vtkMath::Distance2BetweenPoints(&coordinates[3*x_1y], &coordinates[3*x_1y_1]) <= m_TriangulationThreshold)
+            && (vtkMath::Distance2BetweenPoints(&coordinates[3*xy_1], &coordinates[3*x_1y_1]) <= m_TriangulationThreshold);
+        }
+
+        vtkIdType* cell = ids + 8*((i-1)+(j-1)*(xDimension-1));
+        if (triangulate)
+        {
+          cell[1] = x_1y;   cell[2] = xy; cell[3] = x_1y_1;
+          cell[5] = x_1y_1; cell[6] = xy; cell[7] = xy_1;
+        }
+        else
+        {
+          // degenerated triangles are not rendered
+          cell[1] = cell[2] = cell[3] = cell[5] = cell[6] = cell[7] = fallbackID;
+        }
+      }
+    }
+    m_PersistentPolys->Modified();
+    if (m_PersistentMesh->GetPolys() != m_PersistentPolys.GetPointer())
+    {
+      m_PersistentMesh->SetPolys(m_PersistentPolys);
+      m_PersistentMesh->SetVerts(vtkSmartPointer<vtkCellArray>::New());
+    }
+  }
+  else
+  {
+    vtkIdType* ids = m_PersistentVertices->GetData()->GetPointer(0);
+    for (vtkIdType p = 0; p < size; ++p)
+    {
+      ids[2*p+1] = isPointValid[p] ? p : fallbackID;
+    }
+    m_PersistentVertices->Modified();
+    if (m_PersistentMesh->GetVerts() != m_PersistentVertices.GetPointer())
+    {
+      m_PersistentMesh->SetVerts(m_PersistentVertices);
+      m_PersistentMesh->SetPolys(vtkSmartPointer<vtkCellArray>::New());
+    }
+  }
+
+  //Scalar values are necessary for mapping colors/texture onto the surface
+  if (scalars)
+  {
+    vtkFloatArray* scalarArray = vtkFloatArray::SafeDownCast(m_PersistentMesh->GetPointData()->GetScalars());
+    if (scalarArray == nullptr)
+    {
+      vtkSmartPointer<vtkFloatArray> newScalarArray = vtkSmartPointer<vtkFloatArray>::New();
+      newScalarArray->SetNumberOfTuples(size);
+      m_PersistentMesh->GetPointData()->SetScalars(newScalarArray);
+      scalarArray = newScalarArray;
+    }
+    memcpy(scalarArray->GetPointer(0), scalars, size*sizeof(float));
+    scalarArray->Modified();
+  }
+  else
+  {
+    m_PersistentMesh->GetPointData()->SetScalars(nullptr);
+  }
+
+  points->Modified();
+  validPoints->Modified();
+  m_PersistentMesh->Modified();
+}
+
 void mitk::ToFDistanceImageToSurfaceFilter::CreateOutputsForAllInputs()
 {
   this->SetNumberOfOutputs(this->GetNumberOfInputs());  // create outputs for all inputs
@@ -28,6 +28,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <vtkSmartPointer.h>
 #include <vtkIdList.h>
+#include <vtkPolyData.h>
+#include <vtkCellArray.h>
+
+#include <vector>
 
 namespace mitk
 {
@@ -82,6 +86,19 @@ namespace mitk
     itkSetMacro(GenerateTriangularMesh,bool);
     itkGetMacro(GenerateTriangularMesh,bool);
 
+    /**
+     * @brief SetPersistentTopology Enables the persistent topology mode for streaming.
+     * The output surface then holds one point per pixel (point ID = pixel ID) and a grid
+     * triangulation which are allocated once per image size and reused for every frame.
+     * An update only overwrites the point coordinates, the scalars and the validity mask
+     * (point data array "ValidPoints"). Triangles and vertices of invalid pixels, as well as
+     * triangles exceeding the triangulation threshold, are collapsed onto a valid point; invalid
+     * points are moved onto this point, too. Default is false.
+     */
+    itkSetMacro(PersistentTopology,bool);
+    itkGetMacro(PersistentTopology,bool);
+    itkBooleanMacro(PersistentTopology);
+
 
     /**
      * @brief The ReconstructionModeType enum: Defines the reconstruction mode, if using no interpixeldistances and focal lenghts in pixel units  or interpixeldistances and focal length in mm. The Kinect option defines a special reconstruction mode for the kinect.
@@ -172,6 +189,25 @@ namespace mitk
     */
     void CreateOutputsForAllInputs();
 
+    /*!
+    \brief Precomputes the viewing ray of every pixel. The rays only depend on the camera intrinsics,
+    the reconstruction mode and the image geometry, so they are recomputed only if one of these changes.
+    */
+    void UpdateRayTable(mitk::Image* input);
+    /*!
+    \brief Scales the rays by the distances, writing interleaved x,y,z coordinates.
+    The loop has no branches or function calls and is vectorized by the compiler.
+    */
+    void ComputeCoordinates(const float* distances, double* coordinates) const;
+    /*!
+    \brief Allocates the mesh for the persistent topology mode if the image size has changed.
+    */
+    void InitializePersistentTopology(int xDimension, int yDimension);
+    /*!
+    \brief Updates the persistent mesh in place for the current frame.
+    */
+    void GeneratePersistentTopologyData(const float* distances, const float* scalars, int xDimension, int yDimension);
+
     IplImage* m_IplScalarImage; ///< Scalar image used for surface texturing
 
     mitk::CameraIntrinsics::Pointer m_CameraIntrinsics; ///< Specifies the intrinsic parameters
@@ -189,6 +225,19 @@ namespace mitk
 
     double m_TriangulationThreshold;
 
+    bool m_PersistentTopology; ///< reuse the output mesh and only update the points in place
+
+    std::vector<double> m_RayX; ///< x component of the (unnormalized) ray of each pixel
+    std::vector<double> m_RayY; ///< y component of the (unnormalized) ray of each pixel
+    std::vector<double> m_RayNorm; ///< length of the ray of each pixel, unused in Kinect mode
+    double m_RayZ; ///< z component of the rays, equal for all pixels
+    std::vector<double> m_RayTableParameters; ///< parameters the ray table was computed for
+    std::vector<double> m_Coordinates; ///< coordinates of all pixels, reused between frames
+
+    int m_PersistentDimensions[2]; ///< image size the persistent mesh was allocated for
+    vtkSmartPointer<vtkPolyData> m_PersistentMesh;
+    vtkSmartPointer<vtkCellArray> m_PersistentPolys; ///< grid triangulation, two triangles per pixel quad
+    vtkSmartPointer<vtkCellArray> m_PersistentVertices; ///< one vertex cell per pixel
   };
 } //END mitk namespace
 #endif
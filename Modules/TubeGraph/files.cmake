@@ -4,9 +4,11 @@ set(CPP_FILES
   DataStructure/mitkCircularProfileTubeElement.cpp
   DataStructure/mitkTubeGraph.cpp
   DataStructure/mitkTubeGraphEdge.cpp
+  DataStructure/mitkTubeGraphSpatialIndex.cpp
   DataStructure/mitkTubeGraphVertex.cpp
   Interactions/mitkTubeGraphDataInteractor.cpp
   Interactions/mitkTubeGraphPicker.cpp
+  IO/mitkTubeGraphBinaryIO.cpp
   IO/mitkTubeGraphDefinitions.cpp
   IO/mitkTubeGraphIO.cpp
   IO/mitkTubeGraphModuleActivator.cpp
@@ -21,7 +21,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkUndirectedGraph.h"
 #include "mitkTubeGraphEdge.h"
 #include "mitkTubeGraphVertex.h"
+#include "mitkTubeGraphSpatialIndex.h"
 
+#include <memory>
 
 #include <boost/graph/undirected_dfs.hpp>
 #include <boost/property_map/property_map.hpp>
@@ -89,6 +91,12 @@ namespace mitk{
     */
     void RemoveSubGraph(std::vector<TubeDescriptorType> deletedTubes);
 
+    /**
+    * Returns a spatial index over the elements of all tubes for picking and region queries.
+    * The index is built on first use and rebuilt whenever the graph has been modified since.
+    */
+    const TubeGraphSpatialIndex* GetSpatialIndex() const;
+
     void SetRootTube(const TubeDescriptorType& root);
     void SetRoot(const VertexDescriptorType& root);
     TubeDescriptorType GetRootTube();
@@ -106,6 +114,9 @@ namespace mitk{
     TubeDescriptorType m_RootTube;
     VertexDescriptorType m_Root;
 
+    mutable std::unique_ptr<TubeGraphSpatialIndex> m_SpatialIndex;
+    mutable unsigned long m_SpatialIndexMTime;
+
     void GetOutEdgesOfAVertex(VertexDescriptorType vertex, DirectedGraphType& directedGraph, std::vector<TubeDescriptorType>& pathToPeriphery);
   };
 
@@ -0,0 +1,80 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef _MITK_TUBE_GRAPH_BINARY_IO_H_
+#define _MITK_TUBE_GRAPH_BINARY_IO_H_
+
+#include <mitkAbstractFileIO.h>
+#include <mitkCustomMimeType.h>
+#include <mitkIOMimeTypes.h>
+
+#include "mitkTubeGraph.h"
+
+namespace mitk
+{
+
+  /**
+  * @brief reader and writer for a compact binary representation of mitk::TubeGraph
+  *
+  * The file contains the same information as the xml representation (see TubeGraphIO), stored
+  * as little endian values: a header with the geometry, the vertices, the edges with their
+  * elements as single precision coordinates and diameters, followed by the label groups,
+  * attributions and annotations. The reader streams the file edge by edge and never holds
+  * more than the elements of one edge in addition to the graph.
+  *
+  * @ingroup IO
+  */
+  class TubeGraphBinaryIO : public mitk::AbstractFileIO
+  {
+  public:
+
+    TubeGraphBinaryIO();
+
+    // -------------- AbstractFileReader -------------
+
+    using AbstractFileReader::Read;
+    virtual std::vector<BaseData::Pointer> Read() override;
+
+    virtual ConfidenceLevel GetReaderConfidenceLevel() const override;
+
+    // -------------- AbstractFileWriter -------------
+
+    virtual void Write() override;
+    virtual ConfidenceLevel GetWriterConfidenceLevel() const override;
+
+    static CustomMimeType TUBEGRAPH_BINARY_MIMETYPE() // tsfb
+    {
+      CustomMimeType mimeType(TUBEGRAPH_BINARY_MIMETYPE_NAME());
+      mimeType.AddExtension("tsfb");
+      mimeType.SetCategory("Graphs");
+      mimeType.SetComment("MITK Binary Tube Graph Structure File");
+      return mimeType;
+    }
+    static std::string TUBEGRAPH_BINARY_MIMETYPE_NAME()
+    {
+      static std::string name = mitk::IOMimeTypes::DEFAULT_BASE_NAME() + ".graphs.tubular-sructure-binary";
+      return name;
+    }
+
+  private:
+    TubeGraphBinaryIO* IOClone() const override;
+    TubeGraphBinaryIO(const TubeGraphBinaryIO& other);
+
+  };
+
+}
+
+#endif //_MITK_TUBE_GRAPH_BINARY_IO_H_
@@ -0,0 +1,108 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef _MITK_TubeGraphSpatialIndex_H
+#define _MITK_TubeGraphSpatialIndex_H
+
+#include <MitkTubeGraphExports.h>
+
+#include "mitkTubeElement.h"
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace mitk {
+
+  class TubeGraph;
+
+  /**
+  * \brief Bounding volume hierarchy over the elements of all tubes of a tube graph.
+  *
+  * Every element is represented by a sphere (its coordinates and half its diameter). The
+  * hierarchy is built once over the whole graph and answers picking and region queries
+  * without iterating over all edges. It has to be rebuilt when the graph changes, see
+  * TubeGraph::GetSpatialIndex().
+  */
+  class MITKTUBEGRAPH_EXPORT TubeGraphSpatialIndex {
+
+  public:
+
+    typedef std::pair<std::size_t, std::size_t> TubeDescriptorType;
+    typedef std::function<bool (const TubeDescriptorType&)> TubeFilterType;
+
+    TubeGraphSpatialIndex();
+    ~TubeGraphSpatialIndex();
+
+    /**
+    * Collects the elements of all edges of the given graph and builds the hierarchy.
+    */
+    void Build(const TubeGraph* graph);
+
+    /**
+    * Returns the number of indexed elements.
+    */
+    std::size_t GetNumberOfElements() const;
+
+    /**
+    * Finds the element with the smallest distance to the given point, whose surface is closer to
+    * the point than the given tolerance. Tubes for which the filter returns false are ignored.
+    * @returns the tube and the element, or an invalid tube and a null element if nothing was found.
+    */
+    std::pair<TubeDescriptorType, TubeElement*> FindNearestElement(const Point3D& point, ScalarType tolerance,
+      const TubeFilterType& filter = TubeFilterType()) const;
+
+    /**
+    * Returns every tube with at least one element intersecting the axis-aligned box between min and max.
+    */
+    std::vector<TubeDescriptorType> FindTubesInRegion(const Point3D& min, const Point3D& max) const;
+
+  private:
+
+    struct Element
+    {
+      Point3D Coordinates;
+      ScalarType Radius;
+      TubeDescriptorType Tube;
+      TubeElement* TubeElementPointer;
+    };
+
+    /**
+    * Leaves reference the range [First, First + Count) of m_Elements, inner nodes their two children.
+    * The box encloses the element centers; MaxRadius is the largest element radius below the node.
+    */
+    struct Node
+    {
+      Point3D Min;
+      Point3D Max;
+      ScalarType MaxRadius;
+      unsigned int First;
+      unsigned int Count;
+      unsigned int Left;
+      unsigned int Right;
+    };
+
+    unsigned int BuildNode(unsigned int first, unsigned int count);
+
+    static ScalarType SquaredDistanceToBox(const Point3D& point, const Point3D& min, const Point3D& max);
+
+    std::vector<Element> m_Elements;
+    std::vector<Node> m_Nodes;
+
+  };//class
+
+}//namespace
+#endif
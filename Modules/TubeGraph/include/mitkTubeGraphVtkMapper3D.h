@@ -28,6 +28,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkActor.h>
 #include <vtkAppendPolyData.h>
 #include <vtkAssembly.h>
+#include <vtkOpenGLPolyDataMapper.h>
 #include <vtkPolyData.h>
 #include <vtkSmartPointer.h>
 
@@ -35,7 +36,8 @@ namespace mitk
 {
   /**
   * 3D Mapper for mitk::Graph< TubeGraphVertex, TubeGraphEdge >. This mapper creates tubes
-  * around each tubular structure by using vtkTubeFilter.
+  * around each tubular structure by using vtkTubeFilter. The visible tubes and furcations
+  * are merged and rendered by a single actor.
   *
   */
 
@@ -82,6 +84,12 @@ namespace mitk
     */
     virtual void RenderTubeGraphPropertyInformation(mitk::BaseRenderer* renderer);
 
+    /**
+    * Appends the poly data of all visible tubes and their furcations into a single
+    * poly data colored by point scalars, which is rendered by one actor.
+    */
+    virtual void MergeVisibleStructures(mitk::BaseRenderer* renderer);
+
 
     /**
     * Converts a single tube into a vtkPolyData. Each point of the
@@ -97,6 +105,7 @@ namespace mitk
     {
     public:
       vtkSmartPointer<vtkAssembly> m_vtkTubeGraphAssembly;
+      vtkSmartPointer<vtkActor> m_vtkMergedActor;
       std::map<TubeGraph::TubeDescriptorType, vtkSmartPointer<vtkActor> > m_vtkTubesActorMap;
       std::map<TubeGraph::VertexDescriptorType, vtkSmartPointer<vtkActor> > m_vtkSpheresActorMap;
 
@@ -106,6 +115,15 @@ namespace mitk
       LocalStorage()
       {
         m_vtkTubeGraphAssembly = vtkSmartPointer<vtkAssembly>::New();
+
+        vtkSmartPointer<vtkOpenGLPolyDataMapper> mergedMapper = vtkSmartPointer<vtkOpenGLPolyDataMapper>::New();
+        mergedMapper->SetScalarModeToUsePointFieldData();
+        mergedMapper->SelectColorArray("colorScalars");
+        mergedMapper->SetColorModeToDirectScalars();
+        m_vtkMergedActor = vtkSmartPointer<vtkActor>::New();
+        m_vtkMergedActor->SetMapper(mergedMapper);
+        m_vtkMergedActor->SetVisibility(false);
+        m_vtkTubeGraphAssembly->AddPart(m_vtkMergedActor);
       }
 
       ~LocalStorage()
@@ -19,11 +19,13 @@ See LICENSE.txt or http://www.mitk.org for details.
 const mitk::TubeGraph::TubeDescriptorType mitk::TubeGraph::ErrorId = std::pair<VertexDescriptorType, VertexDescriptorType>(boost::graph_traits<GraphType>::null_vertex(),boost::graph_traits<GraphType>::null_vertex());
 
 mitk::TubeGraph::TubeGraph()
+: m_SpatialIndexMTime(0)
 {
 }
 
 mitk::TubeGraph::TubeGraph(const mitk::TubeGraph& graph)
-:UndirectedGraph<TubeGraphVertex, TubeGraphEdge>(graph)
+:UndirectedGraph<TubeGraphVertex, TubeGraphEdge>(graph),
+m_SpatialIndexMTime(0)
 {
 }
 
@@ -285,8 +287,22 @@ mitk::TubeGraph::VertexDescriptorType mitk::TubeGraph::GetRootVertex()
   return m_Root;
 }
 
+const mitk::TubeGraphSpatialIndex* mitk::TubeGraph::GetSpatialIndex() const
+{
+  if (!m_SpatialIndex || m_SpatialIndexMTime != this->GetMTime())
+  {
+    if (!m_SpatialIndex)
+      m_SpatialIndex.reset(new TubeGraphSpatialIndex());
+
+    m_SpatialIndex->Build(this);
+    m_SpatialIndexMTime = this->GetMTime();
+  }
+  return m_SpatialIndex.get();
+}
+
 mitk::TubeGraph& mitk::TubeGraph::operator=(const mitk::TubeGraph& rhs)
 {
   UndirectedGraph<TubeGraphVertex, TubeGraphEdge>::operator= (rhs);
+  m_SpatialIndex.reset();
   return *this;
 }
@@ -0,0 +1,236 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTubeGraphSpatialIndex.h"
+
+#include "mitkCircularProfileTubeElement.h"
+#include "mitkTubeGraph.h"
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <type_traits>
+
+static_assert(std::is_same<mitk::TubeGraphSpatialIndex::TubeDescriptorType, mitk::TubeGraph::TubeDescriptorType>::value,
+  "The spatial index has to use the tube descriptors of the tube graph");
+
+// number of elements below which a node is not split any further
+static const unsigned int LeafSize = 8;
+
+mitk::TubeGraphSpatialIndex::TubeGraphSpatialIndex()
+{
+}
+
+mitk::TubeGraphSpatialIndex::~TubeGraphSpatialIndex()
+{
+}
+
+void mitk::TubeGraphSpatialIndex::Build(const mitk::TubeGraph* graph)
+{
+  m_Elements.clear();
+  m_Nodes.clear();
+
+  if (graph == nullptr)
+    return;
+
+  // walk the edges by descriptor; looking up descriptors of edge copies is linear in the number of edges
+  const TubeGraph::GraphType& boostGraph = graph->GetGraph();
+  boost::property_map<TubeGraph::GraphType, edge_properties_t>::const_type edgeProperties = boost::get(edge_properties, boostGraph);
+
+  TubeGraph::EdgeIteratorType iterator, end;
+  for (boost::tie(iterator, end) = boost::edges(boostGraph); iterator != end; ++iterator)
+  {
+    TubeGraphEdge edge = edgeProperties[*iterator];
+    TubeDescriptorType tube(boost::source(*iterator, boostGraph), boost::target(*iterator, boostGraph));
+
+    std::vector<TubeElement*> allElements = edge.GetElementVector();
+    for (auto element = allElements.begin(); element != allElements.end(); ++element)
+    {
+      Element indexElement;
+      indexElement.Coordinates = (*element)->GetCoordinates();
+      indexElement.Radius = 0.0;
+      if (dynamic_cast<const mitk::CircularProfileTubeElement*>(*element))
+        indexElement.Radius = dynamic_cast<const mitk::CircularProfileTubeElement*>(*element)->GetDiameter() / 2.0;
+      indexElement.Tube = tube;
+      indexElement.TubeElementPointer = *element;
+      m_Elements.push_back(indexElement);
+    }
+  }
+
+  if (!m_Elements.empty())
+  {
+    m_Nodes.reserve(2 * (m_Elements.size() / LeafSize + 1));
+    this->BuildNode(0, m_Elements.size());
+  }
+}
+
+unsigned int mitk::TubeGraphSpatialIndex::BuildNode(unsigned int first, unsigned int count)
+{
+  Node node;
+  node.Min = m_Elements[first].Coordinates;
+  node.Max = m_Elements[first].Coordinates;
+  node.MaxRadius = 0.0;
+  node.First = first;
+  node.Count = count;
+  node.Left = 0;
+  node.Right = 0;
+
+  for (unsigned int i = first; i < first + count; ++i)
+  {
+    for (unsigned int d = 0; d < 3; ++d)
+    {
+      node.Min[d] = std::min(node.Min[d], m_Elements[i].Coordinates[d]);
+      node.Max[d] = std::max(node.Max[d], m_Elements[i].Coordinates[d]);
+    }
+    node.MaxRadius = std::max(node.MaxRadius, m_Elements[i].Radius);
+  }
+
+  const unsigned int nodeIndex = m_Nodes.size();
+  m_Nodes.push_back(node);
+
+  if (count > LeafSize)
+  {
+    // split at the median of the longest axis
+    unsigned int axis = 0;
+    for (unsigned int d = 1; d < 3; ++d)
+    {
+      if (node.Max[d] - node.Min[d] > node.Max[axis] - node.Min[axis])
+        axis = d;
+    }
+
+    const unsigned int half = count / 2;
+    std::nth_element(m_Elements.begin() + first, m_Elements.begin() + first + half, m_Elements.begin() + first + count,
+      [axis](const Element& a, const Element& b) { return a.Coordinates[axis] < b.Coordinates[axis]; });
+
+    const unsigned int left = this->BuildNode(first, half);
+    const unsigned int right = this->BuildNode(first + half, count - half);
+    m_Nodes[nodeIndex].Left = left;
+    m_Nodes[nodeIndex].Right = right;
+    m_Nodes[nodeIndex].Count = 0;
+  }
+
+  return nodeIndex;
+}
+
+std::size_t mitk::TubeGraphSpatialIndex::GetNumberOfElements() const
+{
+  return m_Elements.size();
+}
+
+mitk::ScalarType mitk::TubeGraphSpatialIndex::SquaredDistanceToBox(const Point3D& point, const Point3D& min, const Point3D& max)
+{
+  ScalarType squaredDistance = 0.0;
+  for (unsigned int d = 0; d < 3; ++d)
+  {
+    ScalarType delta = 0.0;
+    if (point[d] < min[d])
+      delta = min[d] - point[d];
+    else if (point[d] > max[d])
+      delta = point[d] - max[d];
+    squaredDistance += delta * delta;
+  }
+  return squaredDistance;
+}
+
+std::pair<mitk::TubeGraphSpatialIndex::TubeDescriptorType, mitk::TubeElement*> mitk::TubeGraphSpatialIndex::FindNearestElement(
+  const Point3D& point, ScalarType tolerance, const TubeFilterType& filter) const
+{
+  std::pair<TubeDescriptorType, TubeElement*> result(TubeGraph::ErrorId, nullptr);
+  if (m_Nodes.empty())
+    return result;
+
+  ScalarType closestDistance = itk::NumericTraits<ScalarType>::max();
+
+  std::vector<unsigned int> stack(1, 0);
+  while (!stack.empty())
+  {
+    const Node& node = m_Nodes[stack.back()];
+    stack.pop_back();
+
+    const ScalarType boxDistance = std::sqrt(SquaredDistanceToBox(point, node.Min, node.Max));
+    if (boxDistance >= closestDistance || boxDistance - node.MaxRadius >= tolerance)
+      continue;
+
+    if (node.Count == 0)
+    {
+      // visit the nearer child first, so that the farther one can mostly be pruned
+      const ScalarType leftDistance = SquaredDistanceToBox(point, m_Nodes[node.Left].Min, m_Nodes[node.Left].Max);
+      const ScalarType rightDistance = SquaredDistanceToBox(point, m_Nodes[node.Right].Min, m_Nodes[node.Right].Max);
+      if (leftDistance < rightDistance)
+      {
+        stack.push_back(node.Right);
+        stack.push_back(node.Left);
+      }
+      else
+      {
+        stack.push_back(node.Left);
+        stack.push_back(node.Right);
+      }
+      continue;
+    }
+
+    for (unsigned int i = node.First; i < node.First + node.Count; ++i)
+    {
+      const Element& element = m_Elements[i];
+      const ScalarType distance = point.EuclideanDistanceTo(element.Coordinates);
+      if (distance < closestDistance && (distance - element.Radius) < tolerance && (!filter || filter(element.Tube)))
+      {
+        closestDistance = distance;
+        result.first = element.Tube;
+        result.second = element.TubeElementPointer;
+      }
+    }
+  }
+
+  return result;
+}
+
+std::vector<mitk::TubeGraphSpatialIndex::TubeDescriptorType> mitk::TubeGraphSpatialIndex::FindTubesInRegion(const Point3D& min, const Point3D& max) const
+{
+  std::set<TubeDescriptorType> tubes;
+  if (m_Nodes.empty())
+    return std::vector<TubeDescriptorType>();
+
+  std::vector<unsigned int> stack(1, 0);
+  while (!stack.empty())
+  {
+    const Node& node = m_Nodes[stack.back()];
+    stack.pop_back();
+
+    bool intersects = true;
+    for (unsigned int d = 0; d < 3 && intersects; ++d)
+      intersects = node.Min[d] - node.MaxRadius <= max[d] && node.Max[d] + node.MaxRadius >= min[d];
+
+    if (!intersects)
+      continue;
+
+    if (node.Count == 0)
+    {
+      stack.push_back(node.Left);
+      stack.push_back(node.Right);
+      continue;
+    }
+
+    for (unsigned int i = node.First; i < node.First + node.Count; ++i)
+    {
+      const Element& element = m_Elements[i];
+      if (SquaredDistanceToBox(element.Coordinates, min, max) <= element.Radius * element.Radius)
+        tubes.insert(element.Tube);
+    }
+  }
+
+  return std::vector<TubeDescriptorType>(tubes.begin(), tubes.end());
+}
@@ -0,0 +1,465 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTubeGraphBinaryIO.h"
+
+#include "mitkCircularProfileTubeElement.h"
+#include "mitkTubeGraphProperty.h"
+
+#include <mitkExceptionMacro.h>
+#include <mitkIOMimeTypes.h>
+
+#include <itkByteSwapper.h>
+
+#include <vtkMatrix4x4.h>
+#include <vtkSmartPointer.h>
+
+#include <cstring>
+#include <sstream>
+
+namespace
+{
+  const char MagicNumber[8] = { 'M', 'I', 'T', 'K', 'T', 'S', 'F', 'B' };
+  const unsigned int FileVersion = 1;
+
+  template <typename T>
+  void WriteValues(std::ostream& out, const T* values, std::size_t count)
+  {
+    std::vector<T> buffer(values, values + count);
+    itk::ByteSwapper<T>::SwapRangeFromSystemToLittleEndian(buffer.data(), count);
+    out.write(reinterpret_cast<const char*>(buffer.data()), count * sizeof(T));
+  }
+
+  template <typename T>
+  void WriteValue(std::ostream& out, T value)
+  {
+    WriteValues(out, &value, 1);
+  }
+
+  void WriteString(std::ostream& out, const std::string& value)
+  {
+    WriteValue<unsigned int>(out, value.size());
+    out.write(value.data(), value.size());
+  }
+
+  /** Writes the coordinates and the diameter of a tube element as four floats. */
+  void WriteTubeElement(std::ostream& out, const mitk::TubeElement* element)
+  {
+    float values[4];
+    values[0] = element->GetCoordinates()[0];
+    values[1] = element->GetCoordinates()[1];
+    values[2] = element->GetCoordinates()[2];
+    values[3] = 2;
+    if (dynamic_cast<const mitk::CircularProfileTubeElement*>(element))
+      values[3] = dynamic_cast<const mitk::CircularProfileTubeElement*>(element)->GetDiameter();
+    WriteValues(out, values, 4);
+  }
+
+  template <typename T>
+  void ReadValues(std::istream& in, T* values, std::size_t count)
+  {
+    in.read(reinterpret_cast<char*>(values), count * sizeof(T));
+    if (!in)
+      mitkThrow() << "Unexpected end of binary tube graph file.";
+    itk::ByteSwapper<T>::SwapRangeFromLittleEndianToSystem(values, count);
+  }
+
+  template <typename T>
+  T ReadValue(std::istream& in)
+  {
+    T value;
+    ReadValues(in, &value, 1);
+    return value;
+  }
+
+  /** Returns the end position of a seekable stream. */
+  std::streampos GetEndPosition(std::istream& in)
+  {
+    const std::streampos position = in.tellg();
+    in.seekg(0, std::ios_base::end);
+    const std::streampos end = in.tellg();
+    in.seekg(position);
+    if (position == std::streampos(-1) || end == std::streampos(-1) || !in)
+      mitkThrow() << "Cannot determine the size of the binary tube graph file.";
+    return end;
+  }
+
+  /** Throws if less than count records of recordSize bytes are left, so that counts read from the file are
+   *  checked before anything is allocated for them. */
+  void CheckRemainingSize(std::istream& in, std::streampos end, unsigned long long count, std::size_t recordSize)
+  {
+    const std::streampos position = in.tellg();
+    if (position == std::streampos(-1) || position > end ||
+        static_cast<unsigned long long>(end - position) / recordSize < count)
+      mitkThrow() << "Unexpected end of binary tube graph file.";
+  }
+
+  std::string ReadString(std::istream& in, std::streampos end)
+  {
+    const unsigned int length = ReadValue<unsigned int>(in);
+    CheckRemainingSize(in, end, length, 1);
+
+    std::string value(length, '\0');
+    if (!value.empty())
+    {
+      in.read(&value[0], value.size());
+      if (!in)
+        mitkThrow() << "Unexpected end of binary tube graph file.";
+    }
+    return value;
+  }
+
+  /** Creates a tube element from four floats and extends the bounds by its coordinates. */
+  mitk::CircularProfileTubeElement* CreateTubeElement(const float* values, mitk::BoundingBox::BoundsArrayType& bounds, bool& emptyBounds)
+  {
+    mitk::Point3D coordinate;
+    mitk::FillVector3D(coordinate, values[0], values[1], values[2]);
+
+    for (unsigned int d = 0; d < 3; ++d)
+    {
+      if (emptyBounds || coordinate[d] < bounds[2 * d])
+        bounds[2 * d] = coordinate[d];
+      if (emptyBounds || coordinate[d] > bounds[2 * d + 1])
+        bounds[2 * d + 1] = coordinate[d];
+    }
+    emptyBounds = false;
+
+    return new mitk::CircularProfileTubeElement(coordinate, values[3]);
+  }
+}
+
+namespace mitk {
+  TubeGraphBinaryIO::TubeGraphBinaryIO(const TubeGraphBinaryIO& other)
+    : AbstractFileIO(other)
+  {
+  }
+
+  TubeGraphBinaryIO::TubeGraphBinaryIO()
+    : AbstractFileIO(mitk::TubeGraph::GetStaticNameOfClass(), mitk::TubeGraphBinaryIO::TUBEGRAPH_BINARY_MIMETYPE(), "Binary Tube Graph Structure File")
+  {
+    this->RegisterService();
+  }
+
+  std::vector<BaseData::Pointer> TubeGraphBinaryIO::Read()
+  {
+    std::vector< itk::SmartPointer<mitk::BaseData> > result;
+
+    InputStream inputStream(this, std::ios_base::in | std::ios_base::binary);
+
+    // the counts in the file are checked against the size of the stream, so streams that cannot seek are buffered
+    std::stringstream bufferedStream;
+    std::istream* streamPointer = &inputStream;
+    if (inputStream.tellg() == std::streampos(-1))
+    {
+      inputStream.clear();
+      bufferedStream << inputStream.rdbuf();
+      streamPointer = &bufferedStream;
+    }
+    std::istream& stream = *streamPointer;
+    const std::streampos streamEnd = GetEndPosition(stream);
+
+    char magicNumber[sizeof(MagicNumber)];
+    stream.read(magicNumber, sizeof(MagicNumber));
+    if (!stream || std::memcmp(magicNumber, MagicNumber, sizeof(MagicNumber)) != 0)
+      mitkThrow() << "Not a binary tube graph file.";
+
+    const unsigned int version = ReadValue<unsigned int>(stream);
+    if (version > FileVersion)
+      mitkThrow() << "Binary tube graph file version " << version << " is not supported.";
+
+    // read geometry: the three matrix columns, the origin and the spacing
+    double geometryValues[15];
+    ReadValues(stream, geometryValues, 15);
+
+    mitk::Geometry3D::Pointer geometry = mitk::Geometry3D::New();
+    geometry->Initialize();
+
+    mitk::Point3D origin;
+    mitk::FillVector3D(origin, geometryValues[9], geometryValues[10], geometryValues[11]);
+    geometry->SetOrigin(origin);
+
+    Vector3D spacing;
+    mitk::FillVector3D(spacing, geometryValues[12], geometryValues[13], geometryValues[14]);
+    geometry->SetSpacing(spacing);
+
+    vtkSmartPointer<vtkMatrix4x4> m = vtkSmartPointer<vtkMatrix4x4>::New();
+    for (unsigned int column = 0; column < 3; ++column)
+    {
+      for (unsigned int row = 0; row < 3; ++row)
+        m->SetElement(row, column, geometryValues[3 * column + row]);
+      m->SetElement(column, 3, origin[column]);
+    }
+    m->SetElement(3, 3, 1);
+    geometry->SetIndexToWorldTransformByVtkMatrix(m);
+
+    geometry->SetImageGeometry(false);
+
+    TubeGraph::Pointer newTubeGraph = TubeGraph::New();
+
+    mitk::BoundingBox::BoundsArrayType bounds;
+    bounds.Fill(0.0);
+    bool emptyBounds = true;
+
+    // read vertices; their descriptors are their indices
+    float elementValues[4];
+    const unsigned int numberOfVertices = ReadValue<unsigned int>(stream);
+    CheckRemainingSize(stream, streamEnd, numberOfVertices, 4 * sizeof(float));
+    for (unsigned int index = 0; index < numberOfVertices; ++index)
+    {
+      ReadValues(stream, elementValues, 4);
+
+      mitk::TubeGraphVertex vertexData;
+      vertexData.SetTubeElement(CreateTubeElement(elementValues, bounds, emptyBounds));
+      newTubeGraph->AddVertex(vertexData);
+    }
+
+    // read edges one after another
+    std::vector<float> edgeElementValues;
+    const unsigned int numberOfEdges = ReadValue<unsigned int>(stream);
+    CheckRemainingSize(stream, streamEnd, numberOfEdges, 3 * sizeof(unsigned int));
+    for (unsigned int index = 0; index < numberOfEdges; ++index)
+    {
+      unsigned int edgeHeader[3];
+      ReadValues(stream, edgeHeader, 3);
+
+      if (edgeHeader[0] >= numberOfVertices || edgeHeader[1] >= numberOfVertices)
+        mitkThrow() << "Edge " << index << " references an unknown vertex.";
+
+      CheckRemainingSize(stream, streamEnd, edgeHeader[2], 4 * sizeof(float));
+      edgeElementValues.resize(4 * std::size_t(edgeHeader[2]));
+      if (!edgeElementValues.empty())
+        ReadValues(stream, edgeElementValues.data(), edgeElementValues.size());
+
+      mitk::TubeGraphEdge edgeData;
+      for (unsigned int elementIndex = 0; elementIndex < edgeHeader[2]; ++elementIndex)
+        edgeData.AddTubeElement(CreateTubeElement(&edgeElementValues[4 * elementIndex], bounds, emptyBounds));
+
+      newTubeGraph->AddEdge(edgeHeader[0], edgeHeader[1], edgeData);
+    }
+
+    geometry->SetBounds(bounds);
+
+    MITK_INFO << "Tube Graph read";
+    MITK_INFO << "Edge numb:" << newTubeGraph->GetNumberOfEdges() << " Vertices: " << newTubeGraph->GetNumberOfVertices();
+
+    mitk::TubeGraphProperty::Pointer newProperty = mitk::TubeGraphProperty::New();
+
+    // read label groups
+    const unsigned int numberOfLabelGroups = ReadValue<unsigned int>(stream);
+    CheckRemainingSize(stream, streamEnd, numberOfLabelGroups, 2 * sizeof(unsigned int));
+    for (unsigned int index = 0; index < numberOfLabelGroups; ++index)
+    {
+      mitk::TubeGraphProperty::LabelGroup* newLabelGroup = new mitk::TubeGraphProperty::LabelGroup();
+      newLabelGroup->labelGroupName = ReadString(stream, streamEnd);
+
+      const unsigned int numberOfLabels = ReadValue<unsigned int>(stream);
+      CheckRemainingSize(stream, streamEnd, numberOfLabels, sizeof(unsigned int) + 1 + 3 * sizeof(float));
+      for (unsigned int labelIndex = 0; labelIndex < numberOfLabels; ++labelIndex)
+      {
+        mitk::TubeGraphProperty::LabelGroup::Label* newLabel = new mitk::TubeGraphProperty::LabelGroup::Label();
+        newLabel->labelName = ReadString(stream, streamEnd);
+        newLabel->isVisible = ReadValue<unsigned char>(stream) != 0;
+
+        float color[3];
+        ReadValues(stream, color, 3);
+        newLabel->labelColor[0] = color[0];
+        newLabel->labelColor[1] = color[1];
+        newLabel->labelColor[2] = color[2];
+
+        newLabelGroup->labels.push_back(newLabel);
+      }
+      newProperty->AddLabelGroup(newLabelGroup, newProperty->GetLabelGroups().size());
+    }
+
+    // read attributions
+    std::map<TubeGraphProperty::TubeToLabelGroupType, std::string> tubeToLabelsMap;
+    const unsigned int numberOfAttributions = ReadValue<unsigned int>(stream);
+    CheckRemainingSize(stream, streamEnd, numberOfAttributions, 4 * sizeof(unsigned int));
+    for (unsigned int index = 0; index < numberOfAttributions; ++index)
+    {
+      unsigned int tubeIds[2];
+      ReadValues(stream, tubeIds, 2);
+      TubeGraph::TubeDescriptorType tube(tubeIds[0], tubeIds[1]);
+      std::string labelGroupName = ReadString(stream, streamEnd);
+      std::string labelName = ReadString(stream, streamEnd);
+
+      mitk::TubeGraphProperty::LabelGroup* labelGroup = newProperty->GetLabelGroupByName(labelGroupName);
+      if (labelGroup != nullptr && newProperty->GetLabelByName(labelGroup, labelName) != nullptr)
+      {
+        TubeGraphProperty::TubeToLabelGroupType tubeToLabelGroup(tube, labelGroupName);
+        tubeToLabelsMap.insert(std::pair<TubeGraphProperty::TubeToLabelGroupType, std::string>(tubeToLabelGroup, labelName));
+      }
+    }
+    if (tubeToLabelsMap.size() > 0)
+      newProperty->SetTubesToLabels(tubeToLabelsMap);
+
+    // read annotations
+    const unsigned int numberOfAnnotations = ReadValue<unsigned int>(stream);
+    CheckRemainingSize(stream, streamEnd, numberOfAnnotations, 4 * sizeof(unsigned int));
+    for (unsigned int index = 0; index < numberOfAnnotations; ++index)
+    {
+      mitk::TubeGraphProperty::Annotation* annotation = new mitk::TubeGraphProperty::Annotation();
+      annotation->name = ReadString(stream, streamEnd);
+      annotation->description = ReadString(stream, streamEnd);
+
+      unsigned int tubeIds[2];
+      ReadValues(stream, tubeIds, 2);
+      annotation->tube = TubeGraph::TubeDescriptorType(tubeIds[0], tubeIds[1]);
+      newProperty->AddAnnotation(annotation);
+    }
+
+    MITK_INFO << "Tube Graph Property read";
+
+    newTubeGraph->SetGeometry(geometry);
+    newTubeGraph->SetProperty("Tube Graph.Visualization Information", newProperty);
+    result.push_back(newTubeGraph.GetPointer());
+
+    return result;
+  }
+
+  AbstractFileIO::ConfidenceLevel TubeGraphBinaryIO::GetReaderConfidenceLevel() const
+  {
+    if (AbstractFileIO::GetReaderConfidenceLevel() == Unsupported)
+      return Unsupported;
+    return Supported;
+  }
+
+  void TubeGraphBinaryIO::Write()
+  {
+    OutputStream out(this, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+
+    if ( !out.good() )
+    {
+      mitkThrow() << "Stream not good.";
+    }
+
+    const mitk::TubeGraph* tubeGraph = dynamic_cast<const mitk::TubeGraph*>(this->GetInput());
+    mitk::BaseGeometry* geometry = tubeGraph->GetGeometry();
+    mitk::TubeGraphProperty::Pointer tubeGraphProperty = dynamic_cast<mitk::TubeGraphProperty*>(tubeGraph->GetProperty("Tube Graph.Visualization Information").GetPointer());
+
+    out.write(MagicNumber, sizeof(MagicNumber));
+    WriteValue(out, FileVersion);
+
+    // write geometry
+    double geometryValues[15];
+    for (unsigned int column = 0; column < 3; ++column)
+    {
+      for (unsigned int row = 0; row < 3; ++row)
+        geometryValues[3 * column + row] = geometry->GetMatrixColumn(column)[row];
+      geometryValues[9 + column] = geometry->GetOrigin()[column];
+      geometryValues[12 + column] = geometry->GetSpacing()[column];
+    }
+    WriteValues(out, geometryValues, 15);
+
+    // write vertices in the order of their descriptors
+    const TubeGraph::GraphType& graph = tubeGraph->GetGraph();
+    boost::property_map<TubeGraph::GraphType, vertex_properties_t>::const_type vertexProperties = boost::get(vertex_properties, graph);
+    boost::property_map<TubeGraph::GraphType, edge_properties_t>::const_type edgeProperties = boost::get(edge_properties, graph);
+
+    WriteValue<unsigned int>(out, boost::num_vertices(graph));
+    TubeGraph::VertexIteratorType vertex, vertexEnd;
+    for (boost::tie(vertex, vertexEnd) = boost::vertices(graph); vertex != vertexEnd; ++vertex)
+    {
+      WriteTubeElement(out, vertexProperties[*vertex].GetTubeElement());
+    }
+
+    // write edges
+    WriteValue<unsigned int>(out, boost::num_edges(graph));
+    TubeGraph::EdgeIteratorType edge, edgeEnd;
+    for (boost::tie(edge, edgeEnd) = boost::edges(graph); edge != edgeEnd; ++edge)
+    {
+      TubeGraphEdge edgeData = edgeProperties[*edge];
+
+      unsigned int edgeHeader[3];
+      edgeHeader[0] = boost::source(*edge, graph);
+      edgeHeader[1] = boost::target(*edge, graph);
+      edgeHeader[2] = edgeData.GetNumberOfElements();
+      WriteValues(out, edgeHeader, 3);
+
+      std::vector<mitk::TubeElement*> elementVector = edgeData.GetElementVector();
+      for (auto element = elementVector.begin(); element != elementVector.end(); ++element)
+        WriteTubeElement(out, *element);
+    }
+
+    std::vector<TubeGraphProperty::LabelGroup*> labelGroupVector;
+    std::map<mitk::TubeGraphProperty::TubeToLabelGroupType, std::string> tubeToLabelGroup;
+    std::vector<mitk::TubeGraphProperty::Annotation*> annotations;
+    if (tubeGraphProperty.IsNotNull())
+    {
+      labelGroupVector = tubeGraphProperty->GetLabelGroups();
+      tubeToLabelGroup = tubeGraphProperty->GetTubesToLabels();
+      annotations = tubeGraphProperty->GetAnnotations();
+    }
+
+    // write label groups
+    WriteValue<unsigned int>(out, labelGroupVector.size());
+    for (unsigned int index = 0; index < labelGroupVector.size(); index++)
+    {
+      WriteString(out, labelGroupVector[index]->labelGroupName);
+
+      std::vector<TubeGraphProperty::LabelGroup::Label*> labelVector = labelGroupVector[index]->labels;
+      WriteValue<unsigned int>(out, labelVector.size());
+      for (unsigned int labelIndex = 0; labelIndex < labelVector.size(); labelIndex++)
+      {
+        WriteString(out, labelVector[labelIndex]->labelName);
+        WriteValue<unsigned char>(out, labelVector[labelIndex]->isVisible ? 1 : 0);
+
+        float color[3];
+        color[0] = labelVector[labelIndex]->labelColor[0];
+        color[1] = labelVector[labelIndex]->labelColor[1];
+        color[2] = labelVector[labelIndex]->labelColor[2];
+        WriteValues(out, color, 3);
+      }
+    }
+
+    // write attributions
+    WriteValue<unsigned int>(out, tubeToLabelGroup.size());
+    for (auto it = tubeToLabelGroup.begin(); it != tubeToLabelGroup.end(); ++it)
+    {
+      unsigned int tubeIds[2] = { static_cast<unsigned int>(it->first.first.first), static_cast<unsigned int>(it->first.first.second) };
+      WriteValues(out, tubeIds, 2);
+      WriteString(out, it->first.second);
+      WriteString(out, it->second);
+    }
+
+    // write annotations
+    WriteValue<unsigned int>(out, annotations.size());
+    for (unsigned int index = 0; index < annotations.size(); index++)
+    {
+      WriteString(out, annotations[index]->name);
+      WriteString(out, annotations[index]->description);
+
+      unsigned int tubeIds[2] = { static_cast<unsigned int>(annotations[index]->tube.first), static_cast<unsigned int>(annotations[index]->tube.second) };
+      WriteValues(out, tubeIds, 2);
+    }
+
+    if (!out.good())
+    {
+      mitkThrow() << "Writing the binary tube graph file failed.";
+    }
+  }
+
+  AbstractFileIO::ConfidenceLevel TubeGraphBinaryIO::GetWriterConfidenceLevel() const
+  {
+    if (AbstractFileIO::GetWriterConfidenceLevel() == Unsupported) return Unsupported;
+    return Supported;
+  }
+
+  TubeGraphBinaryIO* TubeGraphBinaryIO::IOClone() const
+  {
+    return new TubeGraphBinaryIO(*this);
+  }
+}
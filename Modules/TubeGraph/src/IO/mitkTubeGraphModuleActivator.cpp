@@ -16,6 +16,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <usModuleActivator.h>
 #include <usModuleContext.h>
 
+#include "mitkTubeGraphBinaryIO.h"
 #include "mitkTubeGraphIO.h"
 
 namespace mitk
@@ -32,6 +33,7 @@ namespace mitk
     void Load(us::ModuleContext* /*context*/) override
     {
       m_FileIOs.push_back(new TubeGraphIO());
+      m_FileIOs.push_back(new TubeGraphBinaryIO());
     }
 
     void Unload(us::ModuleContext*) override
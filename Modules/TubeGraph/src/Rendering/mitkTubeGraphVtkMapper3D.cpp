@@ -37,6 +37,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkTubeFilter.h>
 #include <vtkUnsignedIntArray.h>
 
+#include <set>
+
 mitk::TubeGraphVtkMapper3D::TubeGraphVtkMapper3D()
 {
 }
@@ -88,37 +90,7 @@ void mitk::TubeGraphVtkMapper3D::GenerateDataForRenderer(mitk::BaseRenderer* ren
 
   if (renderTubeGraph)
   {
-    std::vector<TubeGraph::VertexDescriptorType> alreadyRenderedVertexList;
-    //don't render the sphere which is the root of the graph; so add it to the list before;
-    //TODO check both spheres
-    TubeGraph::VertexDescriptorType root = tubeGraph->GetRootVertex();
-    alreadyRenderedVertexList.push_back(root);
-
-
-    for (std::map<TubeGraph::TubeDescriptorType, vtkSmartPointer<vtkActor> >::iterator itTubes = ls->m_vtkTubesActorMap.begin(); itTubes != ls->m_vtkTubesActorMap.end(); itTubes++ )
-    {
-      if(tubeGraphProperty->IsTubeVisible(itTubes->first))
-      {
-        //add tube actor to assembly
-        ls->m_vtkTubeGraphAssembly->AddPart(itTubes->second);
-
-        //render the clipped spheres as end-cups of a tube and connections between tubes
-        if(std::find(alreadyRenderedVertexList.begin(), alreadyRenderedVertexList.end(), itTubes->first.first)== alreadyRenderedVertexList.end())
-        {
-          std::map<TubeGraph::VertexDescriptorType, vtkSmartPointer<vtkActor> >::iterator itSourceSphere = ls->m_vtkSpheresActorMap.find(itTubes->first.first);
-          if(itSourceSphere != ls->m_vtkSpheresActorMap.end())
-            ls->m_vtkTubeGraphAssembly->AddPart(itSourceSphere->second);
-          alreadyRenderedVertexList.push_back(itSourceSphere->first);
-        }
-        if(std::find(alreadyRenderedVertexList.begin(), alreadyRenderedVertexList.end(), itTubes->first.second)== alreadyRenderedVertexList.end())
-        {
-          std::map<TubeGraph::VertexDescriptorType, vtkSmartPointer<vtkActor> >::iterator itTargetSphere = ls->m_vtkSpheresActorMap.find(itTubes->first.second);
-          if(itTargetSphere != ls->m_vtkSpheresActorMap.end())
-            ls->m_vtkTubeGraphAssembly->AddPart(itTargetSphere->second);
-          alreadyRenderedVertexList.push_back(itTargetSphere->first);
-        }
-      }
-    }
+    this->MergeVisibleStructures(renderer);
   }
 
   //// Opacity TODO
@@ -129,6 +101,77 @@ void mitk::TubeGraphVtkMapper3D::GenerateDataForRenderer(mitk::BaseRenderer* ren
   //}
 }
 
+void mitk::TubeGraphVtkMapper3D::MergeVisibleStructures(mitk::BaseRenderer* renderer)
+{
+  LocalStorage *ls = m_LSH.GetLocalStorage(renderer);
+  TubeGraph::Pointer tubeGraph = const_cast<mitk::TubeGraph*>(this->GetInput());
+  TubeGraphProperty::Pointer tubeGraphProperty = dynamic_cast<TubeGraphProperty*>(tubeGraph->GetProperty("Tube Graph.Visualization Information").GetPointer());
+
+  vtkSmartPointer<vtkAppendPolyData> appendPolyData = vtkSmartPointer<vtkAppendPolyData>::New();
+  int numberOfParts = 0;
+
+  std::set<TubeGraph::VertexDescriptorType> alreadyRenderedVertices;
+  //don't render the sphere which is the root of the graph; so add it to the list before;
+  //TODO check both spheres
+  alreadyRenderedVertices.insert(tubeGraph->GetRootVertex());
+
+  for (std::map<TubeGraph::TubeDescriptorType, vtkSmartPointer<vtkActor> >::iterator itTubes = ls->m_vtkTubesActorMap.begin(); itTubes != ls->m_vtkTubesActorMap.end(); itTubes++ )
+  {
+    if(tubeGraphProperty.IsNotNull() && !tubeGraphProperty->IsTubeVisible(itTubes->first))
+      continue;
+
+    //add the tube, which already carries its colors as point scalars
+    vtkPolyDataMapper* tubeMapper = vtkPolyDataMapper::SafeDownCast(itTubes->second->GetMapper());
+    tubeMapper->Update();
+    appendPolyData->AddInputData(tubeMapper->GetInput());
+    ++numberOfParts;
+
+    //add the clipped spheres as end-cups of a tube and connections between tubes; they are colored by their actors so far
+    TubeGraph::VertexDescriptorType vertices[2] = { itTubes->first.first, itTubes->first.second };
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+      if (!alreadyRenderedVertices.insert(vertices[i]).second)
+        continue;
+
+      std::map<TubeGraph::VertexDescriptorType, vtkSmartPointer<vtkActor> >::iterator itSphere = ls->m_vtkSpheresActorMap.find(vertices[i]);
+      if (itSphere == ls->m_vtkSpheresActorMap.end())
+        continue;
+
+      vtkPolyDataMapper* sphereMapper = vtkPolyDataMapper::SafeDownCast(itSphere->second->GetMapper());
+      sphereMapper->Update();
+
+      vtkSmartPointer<vtkPolyData> sphere = vtkSmartPointer<vtkPolyData>::New();
+      sphere->ShallowCopy(sphereMapper->GetInput());
+
+      double sphereColor[3];
+      itSphere->second->GetProperty()->GetColor(sphereColor);
+
+      vtkSmartPointer<vtkUnsignedCharArray> colorScalars = vtkSmartPointer<vtkUnsignedCharArray>::New();
+      colorScalars->SetName("colorScalars");
+      colorScalars->SetNumberOfComponents(3);
+      colorScalars->SetNumberOfTuples(sphere->GetNumberOfPoints());
+      for (vtkIdType pointId = 0; pointId < sphere->GetNumberOfPoints(); ++pointId)
+        colorScalars->SetTuple3(pointId, 255 * sphereColor[0], 255 * sphereColor[1], 255 * sphereColor[2]);
+      sphere->GetPointData()->AddArray(colorScalars);
+
+      appendPolyData->AddInputData(sphere);
+      ++numberOfParts;
+    }
+  }
+
+  //render all visible structures with a single actor instead of one actor per tube and furcation
+  vtkSmartPointer<vtkPolyData> mergedPolyData = vtkSmartPointer<vtkPolyData>::New();
+  if (numberOfParts > 0)
+  {
+    appendPolyData->Update();
+    mergedPolyData = appendPolyData->GetOutput();
+  }
+
+  vtkPolyDataMapper* mergedMapper = vtkPolyDataMapper::SafeDownCast(ls->m_vtkMergedActor->GetMapper());
+  mergedMapper->SetInputData(mergedPolyData);
+  ls->m_vtkMergedActor->SetVisibility(numberOfParts > 0);
+}
+
 void mitk::TubeGraphVtkMapper3D::RenderTubeGraphPropertyInformation(mitk::BaseRenderer* renderer)
 {
   MITK_INFO<< "Render tube graph property information!";
@@ -0,0 +1,4 @@
+set(MODULE_TESTS
+  mitkTubeGraphBinaryIOTest.cpp
+  mitkTubeGraphSpatialIndexTest.cpp
+)
@@ -0,0 +1,264 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestingMacros.h"
+#include <mitkTestFixture.h>
+#include <mitkCircularProfileTubeElement.h>
+#include <mitkIOUtil.h>
+#include <mitkTubeGraph.h>
+#include <mitkTubeGraphProperty.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+/**
+ * Saves a tube graph as .tsf, converts the loaded graph to .tsfb and compares the graph read back
+ * from the binary file, and checks that truncated or corrupt binary files are rejected.
+ */
+class mitkTubeGraphBinaryIOTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkTubeGraphBinaryIOTestSuite);
+  MITK_TEST(Load_BinaryFromXmlFile_EqualsXmlFile);
+  MITK_TEST(Load_TruncatedBinaryFile_Throws);
+  MITK_TEST(Load_CorruptVertexCount_Throws);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  typedef mitk::TubeGraph::TubeDescriptorType TubeDescriptorType;
+
+  std::vector<std::string> m_FilePaths;
+
+  std::string CreateFilePath(const std::string& extension)
+  {
+    m_FilePaths.push_back(mitk::IOUtil::CreateTemporaryFile("TubeGraphXXXXXX." + extension));
+    return m_FilePaths.back();
+  }
+
+  static mitk::TubeGraph::Pointer LoadTubeGraph(const std::string& filePath)
+  {
+    std::vector<mitk::BaseData::Pointer> data = mitk::IOUtil::Load(filePath);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), data.size());
+    mitk::TubeGraph::Pointer tubeGraph = dynamic_cast<mitk::TubeGraph*>(data.front().GetPointer());
+    CPPUNIT_ASSERT_MESSAGE("A tube graph was loaded", tubeGraph.IsNotNull());
+    return tubeGraph;
+  }
+
+  static mitk::TubeGraphProperty* GetTubeGraphProperty(mitk::TubeGraph* tubeGraph)
+  {
+    mitk::TubeGraphProperty* property =
+      dynamic_cast<mitk::TubeGraphProperty*>(tubeGraph->GetProperty("Tube Graph.Visualization Information").GetPointer());
+    CPPUNIT_ASSERT_MESSAGE("The tube graph has visualization information", property != nullptr);
+    return property;
+  }
+
+  static void AssertEqualElements(const mitk::TubeElement* expected, const mitk::TubeElement* result)
+  {
+    CPPUNIT_ASSERT_MESSAGE("Element coordinates are equal",
+      mitk::Equal(expected->GetCoordinates(), result->GetCoordinates(), mitk::eps, true));
+    CPPUNIT_ASSERT_EQUAL(dynamic_cast<const mitk::CircularProfileTubeElement*>(expected)->GetDiameter(),
+      dynamic_cast<const mitk::CircularProfileTubeElement*>(result)->GetDiameter());
+  }
+
+  static void AssertEqualGraphs(mitk::TubeGraph* expected, mitk::TubeGraph* result)
+  {
+    CPPUNIT_ASSERT_EQUAL(expected->GetNumberOfVertices(), result->GetNumberOfVertices());
+    CPPUNIT_ASSERT_EQUAL(expected->GetNumberOfEdges(), result->GetNumberOfEdges());
+
+    for (int vertex = 0; vertex < expected->GetNumberOfVertices(); ++vertex)
+    {
+      AssertEqualElements(expected->GetVertex(vertex).GetTubeElement(), result->GetVertex(vertex).GetTubeElement());
+    }
+
+    const mitk::TubeGraph::GraphType& graph = expected->GetGraph();
+    mitk::TubeGraph::EdgeIteratorType iterator, end;
+    for (boost::tie(iterator, end) = boost::edges(graph); iterator != end; ++iterator)
+    {
+      mitk::TubeGraphEdge expectedEdge = expected->GetEdge(*iterator);
+      mitk::TubeGraphEdge resultEdge = result->GetEdge(
+        result->GetEdgeDescriptorByVerices(boost::source(*iterator, graph), boost::target(*iterator, graph)));
+
+      std::vector<mitk::TubeElement*> expectedElements = expectedEdge.GetElementVector();
+      std::vector<mitk::TubeElement*> resultElements = resultEdge.GetElementVector();
+      CPPUNIT_ASSERT_EQUAL(expectedElements.size(), resultElements.size());
+      for (std::size_t element = 0; element < expectedElements.size(); ++element)
+      {
+        AssertEqualElements(expectedElements[element], resultElements[element]);
+      }
+    }
+
+    mitk::TubeGraphProperty* expectedProperty = GetTubeGraphProperty(expected);
+    mitk::TubeGraphProperty* resultProperty = GetTubeGraphProperty(result);
+
+    mitk::TubeGraphProperty::LabelGroupSetType expectedLabelGroups = expectedProperty->GetLabelGroups();
+    mitk::TubeGraphProperty::LabelGroupSetType resultLabelGroups = resultProperty->GetLabelGroups();
+    CPPUNIT_ASSERT_EQUAL(expectedLabelGroups.size(), resultLabelGroups.size());
+    for (std::size_t group = 0; group < expectedLabelGroups.size(); ++group)
+    {
+      CPPUNIT_ASSERT_EQUAL(expectedLabelGroups[group]->labelGroupName, resultLabelGroups[group]->labelGroupName);
+      CPPUNIT_ASSERT_EQUAL(expectedLabelGroups[group]->labels.size(), resultLabelGroups[group]->labels.size());
+      for (std::size_t label = 0; label < expectedLabelGroups[group]->labels.size(); ++label)
+      {
+        const mitk::TubeGraphProperty::LabelGroup::Label* expectedLabel = expectedLabelGroups[group]->labels[label];
+        const mitk::TubeGraphProperty::LabelGroup::Label* resultLabel = resultLabelGroups[group]->labels[label];
+        CPPUNIT_ASSERT_EQUAL(expectedLabel->labelName, resultLabel->labelName);
+        CPPUNIT_ASSERT_EQUAL(expectedLabel->isVisible, resultLabel->isVisible);
+        CPPUNIT_ASSERT_MESSAGE("Label colors are equal", expectedLabel->labelColor == resultLabel->labelColor);
+      }
+    }
+
+    CPPUNIT_ASSERT_MESSAGE("Attributions are equal", expectedProperty->GetTubesToLabels() == resultProperty->GetTubesToLabels());
+
+    std::vector<mitk::TubeGraphProperty::Annotation*> expectedAnnotations = expectedProperty->GetAnnotations();
+    std::vector<mitk::TubeGraphProperty::Annotation*> resultAnnotations = resultProperty->GetAnnotations();
+    CPPUNIT_ASSERT_EQUAL(expectedAnnotations.size(), resultAnnotations.size());
+    for (std::size_t annotation = 0; annotation < expectedAnnotations.size(); ++annotation)
+    {
+      CPPUNIT_ASSERT_EQUAL(expectedAnnotations[annotation]->name, resultAnnotations[annotation]->name);
+      CPPUNIT_ASSERT_EQUAL(expectedAnnotations[annotation]->description, resultAnnotations[annotation]->description);
+      CPPUNIT_ASSERT_MESSAGE("Annotated tubes are equal", expectedAnnotations[annotation]->tube == resultAnnotations[annotation]->tube);
+    }
+  }
+
+  static std::string ReadFile(const std::string& filePath)
+  {
+    std::ifstream file(filePath.c_str(), std::ios_base::in | std::ios_base::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+
+  static void WriteFile(const std::string& filePath, const std::string& content)
+  {
+    std::ofstream file(filePath.c_str(), std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+    file.write(content.data(), content.size());
+  }
+
+  /** a graph of four vertices and three tubes with labels, attributions and annotations */
+  static mitk::TubeGraph::Pointer CreateTubeGraph()
+  {
+    mitk::TubeGraph::Pointer tubeGraph = mitk::TubeGraph::New();
+
+    std::vector<mitk::TubeGraph::VertexDescriptorType> vertices;
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+      vertices.push_back(tubeGraph->AddVertex(
+        mitk::TubeGraphVertex(new mitk::CircularProfileTubeElement(10.0f * i, 5.0f * i, 1.5f, 2.0f + 0.25f * i))));
+    }
+
+    for (unsigned int i = 1; i < 4; ++i)
+    {
+      mitk::TubeGraphEdge edge;
+      for (unsigned int j = 0; j < 5 * i; ++j)
+      {
+        edge.AddTubeElement(new mitk::CircularProfileTubeElement(0.5f * j, 1.25f * i, -0.75f * j, 0.5f + 0.125f * j));
+      }
+      tubeGraph->AddEdge(vertices[0], vertices[i], edge);
+    }
+
+    mitk::TubeGraphProperty::Pointer property = mitk::TubeGraphProperty::New();
+    const char* groupNames[] = { "Anatomy", "Status" };
+    const char* labelNames[] = { "Artery", "Vein", "Checked" };
+    for (unsigned int group = 0; group < 2; ++group)
+    {
+      mitk::TubeGraphProperty::LabelGroup* labelGroup = new mitk::TubeGraphProperty::LabelGroup();
+      labelGroup->labelGroupName = groupNames[group];
+      for (unsigned int label = group; label < group + 2; ++label)
+      {
+        mitk::TubeGraphProperty::LabelGroup::Label* newLabel = new mitk::TubeGraphProperty::LabelGroup::Label();
+        newLabel->labelName = labelNames[label];
+        newLabel->isVisible = label != 1;
+        newLabel->labelColor.Set(0.25f * label, 1.0f, 0.5f);
+        labelGroup->labels.push_back(newLabel);
+      }
+      property->AddLabelGroup(labelGroup, group);
+    }
+
+    std::map<mitk::TubeGraphProperty::TubeToLabelGroupType, std::string> tubesToLabels;
+    tubesToLabels[std::make_pair(TubeDescriptorType(vertices[0], vertices[1]), "Anatomy")] = "Artery";
+    tubesToLabels[std::make_pair(TubeDescriptorType(vertices[0], vertices[2]), "Anatomy")] = "Vein";
+    tubesToLabels[std::make_pair(TubeDescriptorType(vertices[0], vertices[2]), "Status")] = "Checked";
+    property->SetTubesToLabels(tubesToLabels);
+
+    mitk::TubeGraphProperty::Annotation* annotation = new mitk::TubeGraphProperty::Annotation();
+    annotation->name = "Stenosis";
+    annotation->description = "Narrowing behind the bifurcation";
+    annotation->tube = TubeDescriptorType(vertices[0], vertices[3]);
+    property->AddAnnotation(annotation);
+
+    tubeGraph->SetProperty("Tube Graph.Visualization Information", property);
+    return tubeGraph;
+  }
+
+public:
+
+  void tearDown() override
+  {
+    for (auto filePath = m_FilePaths.begin(); filePath != m_FilePaths.end(); ++filePath)
+    {
+      std::remove(filePath->c_str());
+    }
+    m_FilePaths.clear();
+  }
+
+  void Load_BinaryFromXmlFile_EqualsXmlFile()
+  {
+    const std::string xmlFilePath = this->CreateFilePath("tsf");
+    mitk::IOUtil::Save(CreateTubeGraph(), xmlFilePath);
+    mitk::TubeGraph::Pointer xmlTubeGraph = LoadTubeGraph(xmlFilePath);
+
+    const std::string binaryFilePath = this->CreateFilePath("tsfb");
+    mitk::IOUtil::Save(xmlTubeGraph, binaryFilePath);
+    mitk::TubeGraph::Pointer binaryTubeGraph = LoadTubeGraph(binaryFilePath);
+
+    AssertEqualGraphs(xmlTubeGraph, binaryTubeGraph);
+  }
+
+  void Load_TruncatedBinaryFile_Throws()
+  {
+    const std::string binaryFilePath = this->CreateFilePath("tsfb");
+    mitk::IOUtil::Save(CreateTubeGraph(), binaryFilePath);
+    const std::string content = ReadFile(binaryFilePath);
+    CPPUNIT_ASSERT_MESSAGE("The binary file was written", !content.empty());
+
+    // cuts into the header, the vertices, the edges and the strings of the labels and annotations
+    const double fractions[] = { 0.05, 0.3, 0.6, 0.9, 0.99 };
+    for (auto fraction : fractions)
+    {
+      const std::string truncatedFilePath = this->CreateFilePath("tsfb");
+      WriteFile(truncatedFilePath, content.substr(0, static_cast<std::size_t>(fraction * content.size())));
+      CPPUNIT_ASSERT_THROW(mitk::IOUtil::Load(truncatedFilePath), mitk::Exception);
+    }
+  }
+
+  void Load_CorruptVertexCount_Throws()
+  {
+    const std::string binaryFilePath = this->CreateFilePath("tsfb");
+    mitk::IOUtil::Save(CreateTubeGraph(), binaryFilePath);
+    std::string content = ReadFile(binaryFilePath);
+
+    // the vertex count follows the magic number, the version and 15 doubles of geometry
+    const std::size_t vertexCountOffset = 8 + sizeof(unsigned int) + 15 * sizeof(double);
+    CPPUNIT_ASSERT_MESSAGE("The binary file was written", content.size() > vertexCountOffset + sizeof(unsigned int));
+    const unsigned int vertexCount = 0xffffffff;
+    content.replace(vertexCountOffset, sizeof(unsigned int), reinterpret_cast<const char*>(&vertexCount), sizeof(unsigned int));
+
+    const std::string corruptFilePath = this->CreateFilePath("tsfb");
+    WriteFile(corruptFilePath, content);
+    CPPUNIT_ASSERT_THROW(mitk::IOUtil::Load(corruptFilePath), mitk::Exception);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkTubeGraphBinaryIO)
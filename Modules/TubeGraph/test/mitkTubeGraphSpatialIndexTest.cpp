@@ -0,0 +1,171 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestingMacros.h"
+#include <mitkTestFixture.h>
+#include <mitkCircularProfileTubeElement.h>
+#include <mitkTubeGraph.h>
+#include <mitkTubeGraphSpatialIndex.h>
+
+#include <random>
+
+/**
+ * Compares the nearest element found by the bounding volume hierarchy of a random tube graph
+ * to a search over all elements of all tubes.
+ */
+class mitkTubeGraphSpatialIndexTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkTubeGraphSpatialIndexTestSuite);
+  MITK_TEST(FindNearestElement_RandomPoints_EqualsBruteForce);
+  MITK_TEST(FindNearestElement_Filter_EqualsBruteForce);
+  MITK_TEST(FindNearestElement_EmptyGraph_ReturnsErrorId);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  typedef mitk::TubeGraph::TubeDescriptorType TubeDescriptorType;
+  typedef mitk::TubeGraphSpatialIndex::TubeFilterType TubeFilterType;
+
+  mitk::TubeGraph::Pointer m_TubeGraph;
+  std::mt19937 m_Generator;
+
+  mitk::Point3D RandomPoint(double min, double max)
+  {
+    std::uniform_real_distribution<double> coordinate(min, max);
+    mitk::Point3D point;
+    point[0] = coordinate(m_Generator);
+    point[1] = coordinate(m_Generator);
+    point[2] = coordinate(m_Generator);
+    return point;
+  }
+
+  /** the nearest element by center distance among those whose surface is closer than the tolerance */
+  std::pair<TubeDescriptorType, mitk::TubeElement*> BruteForceNearestElement(const mitk::Point3D& point,
+    mitk::ScalarType tolerance, const TubeFilterType& filter)
+  {
+    std::pair<TubeDescriptorType, mitk::TubeElement*> result(mitk::TubeGraph::ErrorId, nullptr);
+    mitk::ScalarType closestDistance = itk::NumericTraits<mitk::ScalarType>::max();
+
+    const mitk::TubeGraph::GraphType& graph = m_TubeGraph->GetGraph();
+    mitk::TubeGraph::EdgeIteratorType iterator, end;
+    for (boost::tie(iterator, end) = boost::edges(graph); iterator != end; ++iterator)
+    {
+      TubeDescriptorType tube(boost::source(*iterator, graph), boost::target(*iterator, graph));
+      if (filter && !filter(tube))
+        continue;
+
+      mitk::TubeGraphEdge edge = boost::get(edge_properties, graph, *iterator);
+      std::vector<mitk::TubeElement*> elements = edge.GetElementVector();
+      for (auto element = elements.begin(); element != elements.end(); ++element)
+      {
+        const mitk::ScalarType distance = point.EuclideanDistanceTo((*element)->GetCoordinates());
+        const mitk::ScalarType radius = dynamic_cast<mitk::CircularProfileTubeElement*>(*element)->GetDiameter() / 2.0;
+        if (distance < closestDistance && (distance - radius) < tolerance)
+        {
+          closestDistance = distance;
+          result.first = tube;
+          result.second = *element;
+        }
+      }
+    }
+    return result;
+  }
+
+  void AssertEqualResults(const mitk::Point3D& point, mitk::ScalarType tolerance, const TubeFilterType& filter)
+  {
+    std::pair<TubeDescriptorType, mitk::TubeElement*> expected = this->BruteForceNearestElement(point, tolerance, filter);
+    std::pair<TubeDescriptorType, mitk::TubeElement*> result =
+      m_TubeGraph->GetSpatialIndex()->FindNearestElement(point, tolerance, filter);
+
+    CPPUNIT_ASSERT_MESSAGE("The same tube was found", expected.first == result.first);
+    CPPUNIT_ASSERT_MESSAGE("The same element was found", expected.second == result.second);
+  }
+
+public:
+
+  void setUp() override
+  {
+    m_Generator.seed(42);
+    std::uniform_real_distribution<double> diameter(0.1, 4.0);
+    std::normal_distribution<double> step(0.0, 1.5);
+
+    // random walks between random vertices, connected as a chain with some additional shortcuts
+    m_TubeGraph = mitk::TubeGraph::New();
+    std::vector<mitk::TubeGraph::VertexDescriptorType> vertices;
+    std::vector<mitk::Point3D> positions;
+    for (unsigned int i = 0; i < 40; ++i)
+    {
+      positions.push_back(this->RandomPoint(0.0, 100.0));
+      vertices.push_back(m_TubeGraph->AddVertex(
+        mitk::TubeGraphVertex(new mitk::CircularProfileTubeElement(positions.back(), diameter(m_Generator)))));
+    }
+
+    std::uniform_int_distribution<unsigned int> vertexIndex(0, vertices.size() - 1);
+    for (unsigned int i = 0; i < 60; ++i)
+    {
+      unsigned int source = i < vertices.size() - 1 ? i : vertexIndex(m_Generator);
+      unsigned int target = i < vertices.size() - 1 ? i + 1 : vertexIndex(m_Generator);
+      if (source == target)
+        continue;
+
+      mitk::TubeGraphEdge edge;
+      for (unsigned int j = 1; j < 50; ++j)
+      {
+        mitk::Point3D position = positions[source] + (positions[target] - positions[source]) * (j / 50.0);
+        for (unsigned int d = 0; d < 3; ++d)
+          position[d] += step(m_Generator);
+        edge.AddTubeElement(new mitk::CircularProfileTubeElement(position, diameter(m_Generator)));
+      }
+      m_TubeGraph->AddEdge(vertices[source], vertices[target], edge);
+    }
+  }
+
+  void tearDown() override
+  {
+    m_TubeGraph = nullptr;
+  }
+
+  void FindNearestElement_RandomPoints_EqualsBruteForce()
+  {
+    const mitk::ScalarType tolerances[] = { 0.0, 0.5, 1.0, 5.0, 1000.0 };
+    for (unsigned int i = 0; i < 500; ++i)
+    {
+      const mitk::Point3D point = this->RandomPoint(-10.0, 110.0);
+      for (auto tolerance : tolerances)
+        this->AssertEqualResults(point, tolerance, TubeFilterType());
+    }
+  }
+
+  void FindNearestElement_Filter_EqualsBruteForce()
+  {
+    // ignores every tube that starts at a vertex with an odd descriptor
+    TubeFilterType filter = [](const TubeDescriptorType& tube) { return tube.first % 2 == 0; };
+    for (unsigned int i = 0; i < 500; ++i)
+      this->AssertEqualResults(this->RandomPoint(-10.0, 110.0), 1.0, filter);
+  }
+
+  void FindNearestElement_EmptyGraph_ReturnsErrorId()
+  {
+    m_TubeGraph = mitk::TubeGraph::New();
+    std::pair<TubeDescriptorType, mitk::TubeElement*> result =
+      m_TubeGraph->GetSpatialIndex()->FindNearestElement(this->RandomPoint(0.0, 100.0), 1000.0);
+
+    CPPUNIT_ASSERT_MESSAGE("No tube was found", result.first == mitk::TubeGraph::ErrorId);
+    CPPUNIT_ASSERT_MESSAGE("No element was found", result.second == nullptr);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkTubeGraphSpatialIndex)
@@ -15,6 +15,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 ===================================================================*/
 
 #include "mitkUSImageLoggingFilter.h"
+#include "mitkUSImageStreamSource.h"
 #include <mitkTestingMacros.h>
 #include <mitkTestFixture.h>
 #include <mitkTestingConfig.h>
@@ -27,9 +28,13 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkImageGenerator.h"
 
 #include "itksys/SystemTools.hxx"
+#include <itkImageIOBase.h>
 
 #include "Poco/File.h"
 
+#include <cstring>
+#include <fstream>
+
 class mitkUSImageLoggingFilterTestSuite : public mitk::TestFixture
 {
   CPPUNIT_TEST_SUITE(mitkUSImageLoggingFilterTestSuite);
@@ -40,6 +45,8 @@ class mitkUSImageLoggingFilterTestSuite : public mitk::TestFixture
   MITK_TEST(TestSavingAfterMupltipleUpdateCalls);
   MITK_TEST(TestFilterWithEmptyImages);
   MITK_TEST(TestFilterWithInvalidPath);
+  MITK_TEST(TestStreamRecording);
+  MITK_TEST(TestStreamSourceWithInvalidFrames);
   //MITK_TEST(TestJpgFileExtension); //bug 19614
   CPPUNIT_TEST_SUITE_END();
 
@@ -162,6 +169,89 @@ public:
                                mitk::Exception);
   }
 
+  void TestStreamRecording()
+  {
+  std::string fileName = m_TemporaryTestDirectory + "/mitkUSImageLoggingFilterTest_stream.usr";
+  m_TestFilter->SetInput(m_RandomSingleSliceImage);
+  m_TestFilter->StartStreamRecording(fileName);
+  for(int i=0; i<3; i++)
+    {
+    m_TestFilter->Modified();
+    m_TestFilter->Update();
+    std::stringstream testmessage;
+    testmessage << "testmessage" << i;
+    m_TestFilter->AddMessageToCurrentImage(testmessage.str());
+    }
+  m_TestFilter->StopStreamRecording();
+
+  unsigned long recordedFrames = m_TestFilter->GetStreamRecorder()->GetNumberOfRecordedFrames();
+  CPPUNIT_ASSERT_MESSAGE("Testing if all frames were recorded or counted as dropped",
+                         recordedFrames + m_TestFilter->GetStreamRecorder()->GetNumberOfDroppedFrames() == 3);
+
+  mitk::USImageStreamSource::Pointer source = mitk::USImageStreamSource::New();
+  source->Open(fileName);
+  CPPUNIT_ASSERT_MESSAGE("Testing number of frames in the stream file", source->GetNumberOfFrames() == recordedFrames);
+
+  mitk::Image::Pointer frame = source->GetFrame(0);
+  CPPUNIT_ASSERT_MESSAGE("Testing if the first frame can be read", frame.IsNotNull());
+  CPPUNIT_ASSERT_MESSAGE("Testing dimensions of the replayed frame",
+                         frame->GetDimension(0) == m_RandomSingleSliceImage->GetDimension(0) &&
+                         frame->GetDimension(1) == m_RandomSingleSliceImage->GetDimension(1));
+  CPPUNIT_ASSERT_MESSAGE("Testing pixel type of the replayed frame",
+                         frame->GetPixelType() == m_RandomSingleSliceImage->GetPixelType());
+  CPPUNIT_ASSERT_MESSAGE("Testing message of the first frame", source->GetMessages(0) == "testmessage0");
+  CPPUNIT_ASSERT_MESSAGE("Testing access beyond the last frame", source->GetFrame(recordedFrames).IsNull());
+
+  source = NULL;
+  std::remove(fileName.c_str());
+  }
+
+  void TestStreamSourceWithInvalidFrames()
+  {
+  std::string fileName = m_TemporaryTestDirectory + "/mitkUSImageLoggingFilterTest_invalid.usr";
+  std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  file.write(mitk::USImageStreamRecorder::FILE_MAGIC, std::strlen(mitk::USImageStreamRecorder::FILE_MAGIC));
+
+  mitk::USImageStreamFrameInfo info;
+  info.Dimension = 2;
+  info.Dimensions[0] = 16;
+  info.Dimensions[1] = 16;
+  info.Dimensions[2] = 1;
+  for (unsigned int i = 0; i < 3; ++i)
+    {
+    info.Spacing[i] = 1.0;
+    info.Origin[i] = 0.0;
+    }
+  info.ComponentType = itk::ImageIOBase::UCHAR;
+  info.PixelType = itk::ImageIOBase::SCALAR;
+  info.NumberOfComponents = 1;
+  info.Timestamp = 0.0;
+
+  // a data size smaller than the pixels, an unsupported dimension and a valid frame
+  const unsigned long long dataSizes[] = { 16, 256, 256 };
+  const unsigned int dimensions[] = { 2, 5, 2 };
+  std::vector<char> data(256, 0);
+  for (unsigned int frame = 0; frame < 3; ++frame)
+    {
+    info.DataSize = dataSizes[frame];
+    info.Dimension = dimensions[frame];
+    file.write(mitk::USImageStreamRecorder::FRAME_TAG, 4);
+    mitk::USImageStreamRecorder::WriteFrameInfo(file, info);
+    file.write(data.data(), info.DataSize);
+    }
+  file.close();
+
+  mitk::USImageStreamSource::Pointer source = mitk::USImageStreamSource::New();
+  source->Open(fileName);
+  CPPUNIT_ASSERT_MESSAGE("Testing number of frames in the stream file", source->GetNumberOfFrames() == 3);
+  CPPUNIT_ASSERT_MESSAGE("Testing if a frame with too little data is rejected", source->GetFrame(0).IsNull());
+  CPPUNIT_ASSERT_MESSAGE("Testing if a frame with an unsupported dimension is rejected", source->GetFrame(1).IsNull());
+  CPPUNIT_ASSERT_MESSAGE("Testing if a valid frame is read", source->GetFrame(2).IsNotNull());
+
+  source = NULL;
+  std::remove(fileName.c_str());
+  }
+
   void TestJpgFileExtension()
   {
   CPPUNIT_ASSERT_MESSAGE("Testing setting of jpg extension.",m_TestFilter->SetImageFilesExtension(".jpg"));
@@ -131,10 +131,13 @@ void mitk::IGTLMessageToUSImageFilter::Initiate(mitk::Image::Pointer& img,
   region.SetIndex(index);
   output->SetRegions(region);
   output->SetSpacing(spacing);
-  output->Allocate();
 
+  // The itk image only describes the geometry. The pixels are copied once
+  // from the message into a buffer that is handed over to the mitk::Image,
+  // which takes ownership of it instead of copying it again.
+  unsigned char* buffer = new unsigned char[num_pixel * sizeof(TPixel)];
   TPixel* in = (TPixel*)msg->GetScalarPointer();
-  TPixel* out = (TPixel*)output->GetBufferPointer();
+  TPixel* out = (TPixel*)buffer;
   memcpy(out, in, num_pixel * sizeof(TPixel));
   if (big_endian)
   {
@@ -150,7 +153,10 @@ void mitk::IGTLMessageToUSImageFilter::Initiate(mitk::Image::Pointer& img,
 
   img = mitk::Image::New();
   img->InitializeByItk(output.GetPointer());
-  img->SetVolume(output->GetBufferPointer());
+  if (!img->SetImportVolume(buffer, 0, 0, mitk::Image::ManageMemory))
+  {
+    delete[] buffer;
+  }
   //img->GetGeometry()->SetIndexToWorldTransformByVtkMatrix(vtkMatrix);
   m_previousImage = img;
   vtkMatrix->Delete();
@@ -26,7 +26,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 
 mitk::USImageLoggingFilter::USImageLoggingFilter() : m_SystemTimeClock(RealTimeClock::New()),
-                                                     m_ImageExtension(".nrrd")
+                                                     m_ImageExtension(".nrrd"),
+                                                     m_StreamRecorder(USImageStreamRecorder::New())
 {
 }
 
@@ -45,6 +46,13 @@ void mitk::USImageLoggingFilter::GenerateData()
     return;
     }
 
+  //during a stream recording the image is copied to the writer queue of the recorder only
+  if (m_StreamRecorder->IsRecording())
+    {
+    m_StreamRecorder->AddImage(inputImage, m_SystemTimeClock->GetCurrentStamp());
+    return;
+    }
+
   //a clone is needed for a output and to store it.
   mitk::Image::Pointer inputClone = inputImage->Clone();
 
@@ -83,6 +91,11 @@ void mitk::USImageLoggingFilter::GenerateData()
 
 void mitk::USImageLoggingFilter::AddMessageToCurrentImage(std::string message)
 {
+  if (m_StreamRecorder->IsRecording())
+  {
+    m_StreamRecorder->AddMessageToCurrentFrame(message);
+    return;
+  }
   m_LoggedMessages.insert(std::make_pair(static_cast<int>(m_LoggedImages.size()-1),message));
 }
 
@@ -163,3 +176,18 @@ bool mitk::USImageLoggingFilter::SetImageFilesExtension(std::string extension)
   }
   return false;
  }
+
+void mitk::USImageLoggingFilter::StartStreamRecording(std::string fileName)
+{
+  m_StreamRecorder->Start(fileName);
+}
+
+void mitk::USImageLoggingFilter::StopStreamRecording()
+{
+  m_StreamRecorder->Stop();
+}
+
+mitk::USImageStreamRecorder* mitk::USImageLoggingFilter::GetStreamRecorder()
+{
+  return m_StreamRecorder;
+}
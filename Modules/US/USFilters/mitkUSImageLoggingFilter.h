@@ -21,6 +21,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <MitkUSExports.h>
 #include <mitkImageToImageFilter.h>
 #include <mitkRealTimeClock.h>
+#include "mitkUSImageStreamRecorder.h"
 
 
 namespace mitk {
@@ -76,6 +77,19 @@ namespace mitk {
      */
     bool SetImageFilesExtension(std::string extension);
 
+    /** Starts streaming the images to a single file while they are logged instead of keeping clones in
+     *  memory. Images and messages which are logged during a stream recording are not written by
+     *  SaveImages(...). Use mitk::USImageStreamSource to read the file.
+     *  @throw mitk::Exception if the file cannot be created.
+     */
+    void StartStreamRecording(std::string fileName);
+
+    /** Writes the remaining images of the stream recording and closes the file. */
+    void StopStreamRecording();
+
+    /** Returns the recorder of the stream recording, e.g. to query the number of dropped frames. */
+    mitk::USImageStreamRecorder* GetStreamRecorder();
+
 
   protected:
     USImageLoggingFilter();
@@ -88,6 +102,7 @@ namespace mitk {
     std::map<int, std::string> m_LoggedMessages; ///< (Optional) messages for every logged image
     std::vector<double> m_LoggedMITKSystemTimes; ///< Logged system times for every logged image
     std::string m_ImageExtension; ///< stores the image extension, default is ".nrrd"
+    mitk::USImageStreamRecorder::Pointer m_StreamRecorder; ///< writes the images to disk during a stream recording
 
   };
 } // namespace mitk
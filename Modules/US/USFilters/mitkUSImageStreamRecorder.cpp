@@ -0,0 +1,342 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkUSImageStreamRecorder.h"
+#include <mitkExceptionMacro.h>
+#include <mitkImageAccessLock.h>
+
+#include <algorithm>
+#include <cstring>
+
+const char* mitk::USImageStreamRecorder::FILE_MAGIC = "MITKUSR1";
+const char* mitk::USImageStreamRecorder::FRAME_TAG = "FRM";
+const char* mitk::USImageStreamRecorder::MESSAGE_TAG = "MSG";
+
+namespace
+{
+  template <typename T>
+  void WriteValue(std::ostream& stream, const T& value)
+  {
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  template <typename T>
+  bool ReadValue(std::istream& stream, T& value)
+  {
+    stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return stream.gcount() == static_cast<std::streamsize>(sizeof(T));
+  }
+}
+
+mitk::USImageStreamRecorder::USImageStreamRecorder()
+  : m_MultiThreader(itk::MultiThreader::New()),
+    m_ThreadID(-1),
+    m_WriteFailed(false),
+    m_QueueCondition(itk::ConditionVariable::New()),
+    m_StopRequested(false),
+    m_Recording(false),
+    m_MaximumQueueSize(64),
+    m_NumberOfRecordedFrames(0),
+    m_NumberOfDroppedFrames(0),
+    m_LastFrameDropped(false),
+    m_NumberOfDroppedMessages(0)
+{
+}
+
+mitk::USImageStreamRecorder::~USImageStreamRecorder()
+{
+  this->Stop();
+}
+
+void mitk::USImageStreamRecorder::Start(const std::string& fileName)
+{
+  if (this->IsRecording())
+  {
+    mitkThrow() << "A recording is already running. Stop it before starting a new one.";
+  }
+
+  m_File.open(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!m_File.is_open())
+  {
+    mitkThrow() << "Cannot open " << fileName << " for recording.";
+  }
+  m_File.write(FILE_MAGIC, std::strlen(FILE_MAGIC));
+
+  m_QueueMutex.Lock();
+  m_Queue.clear();
+  m_StopRequested = false;
+  m_Recording = true;
+  m_WriteFailed = false;
+  m_NumberOfRecordedFrames = 0;
+  m_NumberOfDroppedFrames = 0;
+  m_LastFrameDropped = false;
+  m_NumberOfDroppedMessages = 0;
+  m_QueueMutex.Unlock();
+
+  m_ThreadID = m_MultiThreader->SpawnThread(WriterThread, this);
+}
+
+void mitk::USImageStreamRecorder::Stop()
+{
+  m_QueueMutex.Lock();
+  if (!m_Recording)
+  {
+    m_QueueMutex.Unlock();
+    return;
+  }
+  m_StopRequested = true;
+  m_QueueCondition->Broadcast();
+  m_QueueMutex.Unlock();
+
+  // waits until the writer thread has written the remaining frames
+  m_MultiThreader->TerminateThread(m_ThreadID);
+  m_ThreadID = -1;
+
+  m_File.close();
+
+  m_QueueMutex.Lock();
+  m_Recording = false;
+  m_QueueMutex.Unlock();
+
+  if (m_NumberOfDroppedFrames > 0)
+  {
+    MITK_WARN << "Dropped " << m_NumberOfDroppedFrames << " of " << m_NumberOfRecordedFrames + m_NumberOfDroppedFrames
+              << " frames during recording because the disk could not keep up.";
+  }
+  if (m_NumberOfDroppedMessages > 0)
+  {
+    MITK_WARN << "Dropped " << m_NumberOfDroppedMessages << " messages which belonged to dropped frames.";
+  }
+}
+
+bool mitk::USImageStreamRecorder::IsRecording()
+{
+  m_QueueMutex.Lock();
+  bool recording = m_Recording && !m_StopRequested;
+  m_QueueMutex.Unlock();
+  return recording;
+}
+
+bool mitk::USImageStreamRecorder::AddImage(const mitk::Image* image, double timestamp)
+{
+  if (image == nullptr || !image->IsInitialized())
+  {
+    return false;
+  }
+
+  // reject early to avoid copying a frame which would be dropped anyway
+  m_QueueMutex.Lock();
+  bool accept = m_Recording && !m_StopRequested && m_Queue.size() < m_MaximumQueueSize;
+  if (m_Recording && !accept)
+  {
+    ++m_NumberOfDroppedFrames;
+    m_LastFrameDropped = true;
+  }
+  m_QueueMutex.Unlock();
+  if (!accept)
+  {
+    return false;
+  }
+
+  Record record;
+  record.IsMessage = false;
+  record.FrameIndex = 0;
+
+  USImageStreamFrameInfo& info = record.Info;
+  info.Dimension = std::min(image->GetDimension(), 3u);
+  size_t numberOfPixels = 1;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    info.Dimensions[i] = i < info.Dimension ? image->GetDimension(i) : 1;
+    info.Spacing[i] = image->GetGeometry()->GetSpacing()[i];
+    info.Origin[i] = image->GetGeometry()->GetOrigin()[i];
+    numberOfPixels *= info.Dimensions[i];
+  }
+  info.ComponentType = image->GetPixelType().GetComponentType();
+  info.PixelType = image->GetPixelType().GetPixelType();
+  info.NumberOfComponents = image->GetPixelType().GetNumberOfComponents();
+  info.Timestamp = timestamp;
+  info.DataSize = numberOfPixels * image->GetPixelType().GetSize();
+
+  {
+    mitk::ImageRegionAccessor accessor(const_cast<mitk::Image*>(image));
+    mitk::ImageAccessLock lock(&accessor);
+    const char* data = static_cast<const char*>(accessor.getData(0));
+    record.Data.assign(data, data + info.DataSize);
+  }
+
+  // Stop() may have been called while the frame was copied, the writer thread would not write it anymore
+  m_QueueMutex.Lock();
+  accept = m_Recording && !m_StopRequested;
+  if (accept)
+  {
+    m_Queue.push_back(record);
+    ++m_NumberOfRecordedFrames;
+    m_LastFrameDropped = false;
+    m_QueueCondition->Signal();
+  }
+  else if (m_Recording)
+  {
+    ++m_NumberOfDroppedFrames;
+    m_LastFrameDropped = true;
+  }
+  m_QueueMutex.Unlock();
+
+  return accept;
+}
+
+void mitk::USImageStreamRecorder::AddMessageToCurrentFrame(const std::string& message)
+{
+  m_QueueMutex.Lock();
+  if (m_Recording && m_LastFrameDropped)
+  {
+    // the message belongs to a frame which is not in the file, attaching it to the previous frame would be wrong
+    ++m_NumberOfDroppedMessages;
+  }
+  else if (m_Recording && m_NumberOfRecordedFrames > 0)
+  {
+    // messages are never dropped, they are small compared to frames
+    Record record;
+    record.IsMessage = true;
+    record.FrameIndex = m_NumberOfRecordedFrames - 1;
+    record.Message = message;
+    m_Queue.push_back(record);
+    m_QueueCondition->Signal();
+  }
+  m_QueueMutex.Unlock();
+}
+
+unsigned long mitk::USImageStreamRecorder::GetNumberOfRecordedFrames()
+{
+  m_QueueMutex.Lock();
+  unsigned long frames = m_NumberOfRecordedFrames;
+  m_QueueMutex.Unlock();
+  return frames;
+}
+
+unsigned long mitk::USImageStreamRecorder::GetNumberOfDroppedFrames()
+{
+  m_QueueMutex.Lock();
+  unsigned long frames = m_NumberOfDroppedFrames;
+  m_QueueMutex.Unlock();
+  return frames;
+}
+
+unsigned long mitk::USImageStreamRecorder::GetNumberOfDroppedMessages()
+{
+  m_QueueMutex.Lock();
+  unsigned long messages = m_NumberOfDroppedMessages;
+  m_QueueMutex.Unlock();
+  return messages;
+}
+
+ITK_THREAD_RETURN_TYPE mitk::USImageStreamRecorder::WriterThread(void* pInfoStruct)
+{
+  /* extract this pointer from Thread Info structure */
+  struct itk::MultiThreader::ThreadInfoStruct * pInfo =
+    (struct itk::MultiThreader::ThreadInfoStruct*)pInfoStruct;
+  mitk::USImageStreamRecorder* recorder = static_cast<mitk::USImageStreamRecorder*>(pInfo->UserData);
+
+  recorder->m_QueueMutex.Lock();
+  while (true)
+  {
+    while (recorder->m_Queue.empty() && !recorder->m_StopRequested)
+    {
+      recorder->m_QueueCondition->Wait(&recorder->m_QueueMutex);
+    }
+
+    if (recorder->m_Queue.empty())
+    {
+      // stop was requested and everything is written
+      break;
+    }
+
+    Record record;
+    std::swap(record, recorder->m_Queue.front());
+    recorder->m_Queue.pop_front();
+
+    // write without holding the lock, so AddImage() does not wait for the disk
+    recorder->m_QueueMutex.Unlock();
+    recorder->WriteRecord(record);
+    recorder->m_QueueMutex.Lock();
+  }
+  recorder->m_QueueMutex.Unlock();
+
+  recorder->m_File.flush();
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+void mitk::USImageStreamRecorder::WriteRecord(const Record& record)
+{
+  if (m_WriteFailed)
+  {
+    return;
+  }
+
+  if (record.IsMessage)
+  {
+    m_File.write(MESSAGE_TAG, 4);
+    WriteValue(m_File, static_cast<unsigned long long>(record.FrameIndex));
+    WriteValue(m_File, static_cast<unsigned int>(record.Message.size()));
+    m_File.write(record.Message.data(), record.Message.size());
+  }
+  else
+  {
+    m_File.write(FRAME_TAG, 4);
+    WriteFrameInfo(m_File, record.Info);
+    m_File.write(record.Data.data(), record.Data.size());
+  }
+
+  if (m_File.fail())
+  {
+    m_WriteFailed = true;
+    MITK_ERROR << "Writing the ultrasound stream failed, the remaining frames are discarded.";
+  }
+}
+
+void mitk::USImageStreamRecorder::WriteFrameInfo(std::ostream& stream, const USImageStreamFrameInfo& info)
+{
+  WriteValue(stream, info.Dimension);
+  for (unsigned int i = 0; i < 3; ++i)
+    WriteValue(stream, info.Dimensions[i]);
+  for (unsigned int i = 0; i < 3; ++i)
+    WriteValue(stream, info.Spacing[i]);
+  for (unsigned int i = 0; i < 3; ++i)
+    WriteValue(stream, info.Origin[i]);
+  WriteValue(stream, info.ComponentType);
+  WriteValue(stream, info.PixelType);
+  WriteValue(stream, info.NumberOfComponents);
+  WriteValue(stream, info.Timestamp);
+  WriteValue(stream, info.DataSize);
+}
+
+bool mitk::USImageStreamRecorder::ReadFrameInfo(std::istream& stream, USImageStreamFrameInfo& info)
+{
+  bool ok = ReadValue(stream, info.Dimension);
+  for (unsigned int i = 0; i < 3; ++i)
+    ok = ok && ReadValue(stream, info.Dimensions[i]);
+  for (unsigned int i = 0; i < 3; ++i)
+    ok = ok && ReadValue(stream, info.Spacing[i]);
+  for (unsigned int i = 0; i < 3; ++i)
+    ok = ok && ReadValue(stream, info.Origin[i]);
+  ok = ok && ReadValue(stream, info.ComponentType);
+  ok = ok && ReadValue(stream, info.PixelType);
+  ok = ok && ReadValue(stream, info.NumberOfComponents);
+  ok = ok && ReadValue(stream, info.Timestamp);
+  ok = ok && ReadValue(stream, info.DataSize);
+  return ok;
+}
@@ -0,0 +1,150 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKUSImageStreamRecorder_H_HEADER_INCLUDED_
+#define MITKUSImageStreamRecorder_H_HEADER_INCLUDED_
+
+// MITK
+#include <MitkUSExports.h>
+#include <mitkCommon.h>
+#include <mitkImage.h>
+
+// ITK
+#include <itkObject.h>
+#include <itkMultiThreader.h>
+#include <itkSimpleMutexLock.h>
+#include <itkConditionVariable.h>
+
+#include <deque>
+#include <fstream>
+#include <vector>
+
+namespace mitk {
+  /**
+   * \brief Geometry, pixel type and timestamp of one frame in an ultrasound stream file.
+   */
+  struct MITKUS_EXPORT USImageStreamFrameInfo
+  {
+    unsigned int Dimension;
+    unsigned int Dimensions[3];
+    double Spacing[3];
+    double Origin[3];
+    int ComponentType;
+    int PixelType;
+    unsigned int NumberOfComponents;
+    double Timestamp;
+    unsigned long long DataSize;
+  };
+
+  /** An object of this class streams ultrasound frames to a single container file while they are
+   *  acquired. AddImage() copies the pixel data of a frame into a bounded queue, a writer thread appends
+   *  the queued frames to the file. Neither are all frames kept in memory nor does the acquisition wait
+   *  for the disk. If the queue is full, the frame is dropped and counted.
+   *
+   *  The file starts with the magic string of FILE_MAGIC and is a sequence of records. A frame record
+   *  ("FRM") holds a USImageStreamFrameInfo followed by the raw pixel data of the first time step, a
+   *  message record ("MSG") holds a message for a frame index. The records are written in the byte
+   *  order of the recording machine. Use mitk::USImageStreamSource to read or replay such a file.
+   *
+   *  \ingroup US
+   */
+  class MITKUS_EXPORT USImageStreamRecorder : public itk::Object
+  {
+  public:
+
+    mitkClassMacroItkParent(USImageStreamRecorder, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    static const char* FILE_MAGIC;
+    static const char* FRAME_TAG;
+    static const char* MESSAGE_TAG;
+
+    /** Opens the file and starts the writer thread.
+     *  @throw mitk::Exception if the file cannot be created or a recording is already running.
+     */
+    void Start(const std::string& fileName);
+
+    /** Writes all queued frames, closes the file and stops the writer thread. */
+    void Stop();
+
+    bool IsRecording();
+
+    /** Queues a copy of the first time step of the image.
+     *  @return false if the frame was dropped because the queue is full or no recording is running.
+     */
+    bool AddImage(const mitk::Image* image, double timestamp);
+
+    /** Adds a message to the last frame which was accepted by AddImage(). If the last frame passed to
+     *  AddImage() was dropped, the message is dropped as well and counted. */
+    void AddMessageToCurrentFrame(const std::string& message);
+
+    /** Maximum number of frames waiting for the writer thread, default is 64. */
+    itkSetMacro(MaximumQueueSize, unsigned int);
+    itkGetMacro(MaximumQueueSize, unsigned int);
+
+    /** Number of frames accepted by AddImage() since Start(). */
+    unsigned long GetNumberOfRecordedFrames();
+
+    /** Number of frames rejected by AddImage() since Start() because the queue was full or Stop() was called
+     *  while the frame was copied. */
+    unsigned long GetNumberOfDroppedFrames();
+
+    /** Number of messages dropped since Start() because they were added after a dropped frame. */
+    unsigned long GetNumberOfDroppedMessages();
+
+    /** Writes the frame info in the format of a frame record. */
+    static void WriteFrameInfo(std::ostream& stream, const USImageStreamFrameInfo& info);
+
+    /** Reads a frame info written by WriteFrameInfo().
+     *  @return false if the stream ended before the frame info was complete. */
+    static bool ReadFrameInfo(std::istream& stream, USImageStreamFrameInfo& info);
+
+  protected:
+    USImageStreamRecorder();
+    virtual ~USImageStreamRecorder();
+
+    struct Record
+    {
+      bool IsMessage;
+      USImageStreamFrameInfo Info;
+      std::vector<char> Data;
+      unsigned long FrameIndex;
+      std::string Message;
+    };
+
+    static ITK_THREAD_RETURN_TYPE WriterThread(void* pInfoStruct);
+    void WriteRecord(const Record& record);
+
+    itk::MultiThreader::Pointer m_MultiThreader;
+    int m_ThreadID;
+
+    std::ofstream m_File;
+    bool m_WriteFailed;
+
+    std::deque<Record> m_Queue;
+    itk::SimpleMutexLock m_QueueMutex;
+    itk::ConditionVariable::Pointer m_QueueCondition;
+    bool m_StopRequested;
+    bool m_Recording;
+
+    unsigned int m_MaximumQueueSize;
+    unsigned long m_NumberOfRecordedFrames;
+    unsigned long m_NumberOfDroppedFrames;
+    bool m_LastFrameDropped;
+    unsigned long m_NumberOfDroppedMessages;
+  };
+} // namespace mitk
+#endif /* MITKUSImageStreamRecorder_H_HEADER_INCLUDED_ */
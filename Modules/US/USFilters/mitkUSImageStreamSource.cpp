@@ -0,0 +1,247 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkUSImageStreamSource.h"
+#include <mitkExceptionMacro.h>
+
+#include <itkRawImageIO.h>
+
+#include <cstring>
+
+namespace
+{
+  /** Checks that the frame is 2D or 3D and that its data size is the number of pixels times the pixel size. */
+  bool IsValidFrame(const mitk::USImageStreamFrameInfo& info, std::size_t pixelSize)
+  {
+    if (info.Dimension < 2 || info.Dimension > 3 || pixelSize == 0 || info.DataSize % pixelSize != 0)
+    {
+      return false;
+    }
+
+    // divides instead of multiplying, so that large dimensions cannot overflow
+    unsigned long long remainingPixels = info.DataSize / pixelSize;
+    for (unsigned int i = 0; i < info.Dimension; ++i)
+    {
+      if (info.Dimensions[i] == 0 || remainingPixels % info.Dimensions[i] != 0)
+      {
+        return false;
+      }
+      remainingPixels /= info.Dimensions[i];
+    }
+    return remainingPixels == 1;
+  }
+}
+
+mitk::USImageStreamSource::USImageStreamSource()
+  : m_CurrentFrame(0),
+    m_Loop(true),
+    m_FileMutex(itk::FastMutexLock::New())
+{
+}
+
+mitk::USImageStreamSource::~USImageStreamSource()
+{
+}
+
+void mitk::USImageStreamSource::Open(const std::string& fileName)
+{
+  m_FileMutex->Lock();
+
+  m_Frames.clear();
+  m_FrameOffsets.clear();
+  m_Messages.clear();
+  m_CurrentFrame = 0;
+
+  if (m_File.is_open())
+  {
+    m_File.close();
+  }
+  m_File.clear();
+  m_File.open(fileName.c_str(), std::ios::in | std::ios::binary);
+
+  const size_t magicLength = std::strlen(USImageStreamRecorder::FILE_MAGIC);
+  std::vector<char> magic(magicLength);
+  if (!m_File.is_open()
+    || !m_File.read(magic.data(), magicLength)
+    || std::memcmp(magic.data(), USImageStreamRecorder::FILE_MAGIC, magicLength) != 0)
+  {
+    m_File.close();
+    m_FileMutex->Unlock();
+    mitkThrow() << fileName << " is no ultrasound stream file.";
+  }
+
+  m_File.seekg(0, std::ios::end);
+  const std::streamoff fileSize = m_File.tellg();
+  m_File.seekg(magicLength, std::ios::beg);
+
+  // index the records, the pixel data is skipped
+  char tag[4];
+  while (m_File.read(tag, 4))
+  {
+    if (std::memcmp(tag, USImageStreamRecorder::FRAME_TAG, 4) == 0)
+    {
+      USImageStreamFrameInfo info;
+      if (!USImageStreamRecorder::ReadFrameInfo(m_File, info))
+        break;
+
+      const std::streamoff offset = m_File.tellg();
+      if (offset + static_cast<std::streamoff>(info.DataSize) > fileSize)
+        break; // incomplete last frame, e.g. if the recording was interrupted
+
+      m_Frames.push_back(info);
+      m_FrameOffsets.push_back(offset);
+      m_File.seekg(info.DataSize, std::ios::cur);
+    }
+    else if (std::memcmp(tag, USImageStreamRecorder::MESSAGE_TAG, 4) == 0)
+    {
+      unsigned long long frameIndex;
+      unsigned int length;
+      if (!m_File.read(reinterpret_cast<char*>(&frameIndex), sizeof(frameIndex))
+        || !m_File.read(reinterpret_cast<char*>(&length), sizeof(length)))
+        break;
+
+      std::string message(length, '\0');
+      if (length > 0 && !m_File.read(&message[0], length))
+        break;
+
+      std::string& messages = m_Messages[static_cast<unsigned long>(frameIndex)];
+      if (!messages.empty())
+        messages += "\n";
+      messages += message;
+    }
+    else
+    {
+      MITK_WARN << "Unknown record in " << fileName << ", ignoring the rest of the file.";
+      break;
+    }
+  }
+  m_File.clear();
+
+  m_FileMutex->Unlock();
+
+  MITK_INFO << "Opened " << fileName << " with " << m_Frames.size() << " frames.";
+}
+
+unsigned long mitk::USImageStreamSource::GetNumberOfFrames()
+{
+  m_FileMutex->Lock();
+  unsigned long numberOfFrames = m_Frames.size();
+  m_FileMutex->Unlock();
+  return numberOfFrames;
+}
+
+mitk::Image::Pointer mitk::USImageStreamSource::GetFrame(unsigned long index)
+{
+  m_FileMutex->Lock();
+  if (index >= m_Frames.size())
+  {
+    m_FileMutex->Unlock();
+    return nullptr;
+  }
+
+  const USImageStreamFrameInfo& info = m_Frames[index];
+
+  // the pixel type is restored through an image io which carries the recorded type ids
+  itk::RawImageIO<unsigned char, 2>::Pointer imageIO = itk::RawImageIO<unsigned char, 2>::New();
+  imageIO->SetComponentType(static_cast<itk::ImageIOBase::IOComponentType>(info.ComponentType));
+  imageIO->SetPixelType(static_cast<itk::ImageIOBase::IOPixelType>(info.PixelType));
+  imageIO->SetNumberOfComponents(info.NumberOfComponents);
+  mitk::PixelType pixelType = MakePixelType(imageIO);
+
+  // the image takes the buffer as it is, so its size has to match the dimensions and the pixel type exactly
+  if (!IsValidFrame(info, pixelType.GetSize()))
+  {
+    m_FileMutex->Unlock();
+    MITK_ERROR << "Frame " << index << " of the ultrasound stream has an invalid size.";
+    return nullptr;
+  }
+
+  mitk::Image::Pointer image = mitk::Image::New();
+  image->Initialize(pixelType, info.Dimension, info.Dimensions);
+
+  mitk::Vector3D spacing;
+  mitk::Point3D origin;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    spacing[i] = info.Spacing[i];
+    origin[i] = info.Origin[i];
+  }
+  image->GetGeometry()->SetSpacing(spacing);
+  image->GetGeometry()->SetOrigin(origin);
+
+  // read the pixel data into a buffer which is then owned by the image
+  char* buffer = new char[info.DataSize];
+  m_File.seekg(m_FrameOffsets[index], std::ios::beg);
+  bool ok = static_cast<bool>(m_File.read(buffer, info.DataSize));
+  m_File.clear();
+  m_FileMutex->Unlock();
+
+  if (!ok || !image->SetImportVolume(buffer, 0, 0, mitk::Image::ManageMemory))
+  {
+    delete[] buffer;
+    MITK_ERROR << "Could not read frame " << index << " of the ultrasound stream.";
+    return nullptr;
+  }
+
+  return image;
+}
+
+double mitk::USImageStreamSource::GetTimestamp(unsigned long index)
+{
+  m_FileMutex->Lock();
+  double timestamp = index < m_Frames.size() ? m_Frames[index].Timestamp : 0.0;
+  m_FileMutex->Unlock();
+  return timestamp;
+}
+
+std::string mitk::USImageStreamSource::GetMessages(unsigned long index)
+{
+  m_FileMutex->Lock();
+  std::string messages;
+  std::map<unsigned long, std::string>::const_iterator it = m_Messages.find(index);
+  if (it != m_Messages.end())
+    messages = it->second;
+  m_FileMutex->Unlock();
+  return messages;
+}
+
+void mitk::USImageStreamSource::SetCurrentFrame(unsigned long index)
+{
+  m_FileMutex->Lock();
+  m_CurrentFrame = index;
+  m_FileMutex->Unlock();
+}
+
+unsigned long mitk::USImageStreamSource::GetCurrentFrame()
+{
+  m_FileMutex->Lock();
+  unsigned long index = m_CurrentFrame;
+  m_FileMutex->Unlock();
+  return index;
+}
+
+void mitk::USImageStreamSource::GetNextRawImage(mitk::Image::Pointer& image)
+{
+  m_FileMutex->Lock();
+  if (m_CurrentFrame >= m_Frames.size() && m_Loop)
+  {
+    m_CurrentFrame = 0;
+  }
+  unsigned long index = m_CurrentFrame++;
+  m_FileMutex->Unlock();
+
+  image = this->GetFrame(index);
+}
@@ -0,0 +1,96 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKUSImageStreamSource_H_HEADER_INCLUDED_
+#define MITKUSImageStreamSource_H_HEADER_INCLUDED_
+
+#include "mitkUSImageSource.h"
+#include "mitkUSImageStreamRecorder.h"
+
+#include <fstream>
+#include <map>
+#include <vector>
+
+namespace mitk {
+  /**
+   * \brief Image source which replays a file written by mitk::USImageStreamRecorder.
+   *
+   * Open() only reads the frame headers and remembers where the pixel data of each frame
+   * starts, so any frame can be read directly with GetFrame() without loading the whole
+   * recording. GetNextImage() returns the frames in recorded order.
+   *
+   * \ingroup US
+   */
+  class MITKUS_EXPORT USImageStreamSource : public USImageSource
+  {
+  public:
+    mitkClassMacro(USImageStreamSource, USImageSource);
+    itkFactorylessNewMacro(Self);
+
+    /**
+    * \brief Opens a recorded stream and indexes its frames.
+    * \throw mitk::Exception if the file cannot be opened or is no ultrasound stream file
+    */
+    void Open(const std::string& fileName);
+
+    unsigned long GetNumberOfFrames();
+
+    /**
+    * \brief Reads the frame with the given index. Returns nullptr if the index is out of range.
+    */
+    mitk::Image::Pointer GetFrame(unsigned long index);
+
+    /**
+    * \brief Returns the timestamp which was recorded with the frame.
+    */
+    double GetTimestamp(unsigned long index);
+
+    /**
+    * \brief Returns the messages of the frame, separated by new lines.
+    */
+    std::string GetMessages(unsigned long index);
+
+    /** Index of the frame returned by the next call of GetNextImage(). */
+    void SetCurrentFrame(unsigned long index);
+    unsigned long GetCurrentFrame();
+
+    /** Start again with the first frame after the last one (default true). */
+    itkSetMacro(Loop, bool);
+    itkGetMacro(Loop, bool);
+
+  protected:
+    USImageStreamSource();
+    virtual ~USImageStreamSource();
+
+    using Superclass::GetNextRawImage;
+
+    /**
+    * \brief Reads the current frame and advances to the next one.
+    */
+    virtual void GetNextRawImage(mitk::Image::Pointer& image) override;
+
+    std::ifstream m_File;
+    std::vector<USImageStreamFrameInfo> m_Frames;
+    std::vector<std::streamoff> m_FrameOffsets;
+    std::map<unsigned long, std::string> m_Messages;
+    unsigned long m_CurrentFrame;
+    bool m_Loop;
+
+    /** guards the file position, frames are read from the acquisition thread */
+    itk::FastMutexLock::Pointer m_FileMutex;
+  };
+} // namespace mitk
+#endif /* MITKUSImageStreamSource_H_HEADER_INCLUDED_ */
@@ -0,0 +1,563 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+// MITK
+#include "mitkUSFreehandCompoundingFilter.h"
+#include <mitkExceptionMacro.h>
+#include <mitkImageDataItem.h>
+
+// ITK
+#include <itkImageIOBase.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+const int mitk::USFreehandCompoundingFilter::BRICK_SIZE;
+
+namespace
+{
+  const unsigned int MAXIMUM_ROW_STEP = 4;
+  const long BRICK_KEY_OFFSET = 1L << 20;
+
+  template <typename T>
+  void CopyFirstChannel(const void* data, size_t numberOfPixels, unsigned int numberOfComponents, float* target)
+  {
+    const T* source = static_cast<const T*>(data);
+    for (size_t i = 0; i < numberOfPixels; ++i)
+    {
+      target[i] = static_cast<float>(source[i * numberOfComponents]);
+    }
+  }
+
+  long FloorDivide(long value, long divisor)
+  {
+    return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+  }
+}
+
+mitk::USFreehandCompoundingFilter::Brick::Brick()
+  : Sum(BRICK_SIZE * BRICK_SIZE * BRICK_SIZE, 0.0f),
+    Count(BRICK_SIZE * BRICK_SIZE * BRICK_SIZE, 0)
+{
+}
+
+mitk::USFreehandCompoundingFilter::USFreehandCompoundingFilter()
+  : m_OutputSpacing(0.5),
+    m_FillHoles(true),
+    m_MaximumFrameTime(0.0),
+    m_RowStep(1),
+    m_NumberOfInsertedFrames(0),
+    m_OutputFillHoles(true),
+    m_MultiThreader(itk::MultiThreader::New())
+{
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    m_BrickMin[i] = m_OutputBrickMin[i] = 0;
+    m_BrickMax[i] = m_OutputBrickMax[i] = -1;
+  }
+
+  // the output is updated brick by brick, so its buffer has to survive the next update
+  this->GetOutput()->SetReleaseDataBeforeUpdateFlag(false);
+}
+
+mitk::USFreehandCompoundingFilter::~USFreehandCompoundingFilter()
+{
+}
+
+void mitk::USFreehandCompoundingFilter::SetOutputSpacing(double spacing)
+{
+  if (spacing <= 0)
+  {
+    mitkThrow() << "Output spacing of USFreehandCompoundingFilter must be positive.";
+  }
+  if (spacing == m_OutputSpacing)
+  {
+    return;
+  }
+
+  this->Reset();
+  m_OutputSpacing = spacing;
+}
+
+void mitk::USFreehandCompoundingFilter::Reset()
+{
+  m_Bricks.clear();
+  m_ModifiedBricks.clear();
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    m_BrickMin[i] = m_OutputBrickMin[i] = 0;
+    m_BrickMax[i] = m_OutputBrickMax[i] = -1;
+  }
+  m_NumberOfInsertedFrames = 0;
+  m_RowStep = 1;
+  this->Modified();
+}
+
+unsigned long mitk::USFreehandCompoundingFilter::GetNumberOfInsertedFrames() const
+{
+  return m_NumberOfInsertedFrames;
+}
+
+unsigned long mitk::USFreehandCompoundingFilter::GetNumberOfBricks() const
+{
+  return m_Bricks.size();
+}
+
+bool mitk::USFreehandCompoundingFilter::InsertFrame(const mitk::Image* frame, const mitk::NavigationData* navigationData)
+{
+  if (frame == nullptr || !frame->IsInitialized() || frame->GetDimension() < 2)
+  {
+    MITK_WARN << "Cannot insert an empty frame into the compounded volume.";
+    return false;
+  }
+  if (navigationData == nullptr || !navigationData->IsDataValid())
+  {
+    return false;
+  }
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  InsertionData data;
+  data.Filter = this;
+  data.Width = frame->GetDimension(0);
+  data.Height = frame->GetDimension(1);
+
+  // convert the first slice to float once, so the threads do not have to care about the pixel type
+  const size_t numberOfPixels = static_cast<size_t>(data.Width) * data.Height;
+  const unsigned int numberOfComponents = frame->GetPixelType().GetNumberOfComponents();
+  data.Pixels.resize(numberOfPixels);
+  mitk::Image::ImageDataItemPointer volume = const_cast<mitk::Image*>(frame)->GetVolumeData(0);
+  const void* pixels = volume->GetData();
+  switch (frame->GetPixelType().GetComponentType())
+  {
+  case itk::ImageIOBase::UCHAR:
+    CopyFirstChannel<unsigned char>(pixels, numberOfPixels, numberOfComponents, &data.Pixels[0]);
+    break;
+  case itk::ImageIOBase::CHAR:
+    CopyFirstChannel<char>(pixels, numberOfPixels, numberOfComponents, &data.Pixels[0]);
+    break;
+  case itk::ImageIOBase::USHORT:
+    CopyFirstChannel<unsigned short>(pixels, numberOfPixels, numberOfComponents, &data.Pixels[0]);
+    break;
+  case itk::ImageIOBase::SHORT:
+    CopyFirstChannel<short>(pixels, numberOfPixels, numberOfComponents, &data.Pixels[0]);
+    break;
+  case itk::ImageIOBase::UINT:
+    CopyFirstChannel<unsigned int>(pixels, numberOfPixels, numberOfComponents, &data.Pixels[0]);
+    break;
+  case itk::ImageIOBase::INT:
+    CopyFirstChannel<int>(pixels, numberOfPixels, numberOfComponents, &data.Pixels[0]);
+    break;
+  case itk::ImageIOBase::FLOAT:
+    CopyFirstChannel<float>(pixels, numberOfPixels, numberOfComponents, &data.Pixels[0]);
+    break;
+  case itk::ImageIOBase::DOUBLE:
+    CopyFirstChannel<double>(pixels, numberOfPixels, numberOfComponents, &data.Pixels[0]);
+    break;
+  default:
+    MITK_WARN << "Pixel type " << frame->GetPixelType().GetComponentTypeAsString()
+              << " is not supported by USFreehandCompoundingFilter.";
+    return false;
+  }
+
+  // index -> tool -> world, the frame is spanned by the images of the index axes
+  const mitk::AffineTransform3D* indexToTool = m_Calibration.IsNotNull()
+    ? m_Calibration.GetPointer()
+    : frame->GetGeometry()->GetIndexToWorldTransform();
+
+  mitk::Point3D index;
+  index.Fill(0);
+  data.Origin = navigationData->TransformPoint(indexToTool->TransformPoint(index));
+  index[0] = 1;
+  data.RowDirection = navigationData->TransformPoint(indexToTool->TransformPoint(index)) - data.Origin;
+  index[0] = 0;
+  index[1] = 1;
+  data.ColumnDirection = navigationData->TransformPoint(indexToTool->TransformPoint(index)) - data.Origin;
+
+  this->AllocateBricks(data);
+
+  m_MultiThreader->SetNumberOfThreads(this->GetNumberOfThreads());
+  m_MultiThreader->SetSingleMethod(InsertRowsCallback, &data);
+  m_MultiThreader->SingleMethodExecute();
+
+  ++m_NumberOfInsertedFrames;
+  this->Modified();
+
+  // skip rows if the insertion cannot keep up, use all rows again as soon as it can
+  if (m_MaximumFrameTime > 0)
+  {
+    double frameTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (frameTime > m_MaximumFrameTime && m_RowStep < MAXIMUM_ROW_STEP)
+    {
+      ++m_RowStep;
+      MITK_DEBUG << "Inserting a frame took " << frameTime << " ms, using every " << m_RowStep << ". row now.";
+    }
+    else if (frameTime < 0.5 * m_MaximumFrameTime && m_RowStep > 1)
+    {
+      --m_RowStep;
+    }
+  }
+
+  return true;
+}
+
+ITK_THREAD_RETURN_TYPE mitk::USFreehandCompoundingFilter::InsertRowsCallback(void* arg)
+{
+  itk::MultiThreader::ThreadInfoStruct* info = static_cast<itk::MultiThreader::ThreadInfoStruct*>(arg);
+  InsertionData* data = static_cast<InsertionData*>(info->UserData);
+  data->Filter->InsertRows(*data, info->ThreadID, info->NumberOfThreads);
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+void mitk::USFreehandCompoundingFilter::InsertRows(const InsertionData& data, unsigned int threadId, unsigned int numberOfThreads)
+{
+  const unsigned int numberOfRows = (data.Height + m_RowStep - 1) / m_RowStep;
+  const unsigned int firstRow = threadId * numberOfRows / numberOfThreads;
+  const unsigned int lastRow = (threadId + 1) * numberOfRows / numberOfThreads;
+  if (firstRow >= lastRow)
+  {
+    return;
+  }
+
+  std::vector<VoxelSample> samples;
+  samples.reserve(static_cast<size_t>(lastRow - firstRow) * data.Width);
+
+  BrickKey cachedKey = 0;
+  Brick* cachedBrick = nullptr;
+  bool cacheValid = false;
+
+  for (unsigned int row = firstRow; row < lastRow; ++row)
+  {
+    const unsigned int y = row * m_RowStep;
+    const mitk::Point3D rowOrigin = data.Origin + data.ColumnDirection * static_cast<double>(y);
+    const float* pixel = &data.Pixels[static_cast<size_t>(y) * data.Width];
+
+    for (unsigned int x = 0; x < data.Width; ++x)
+    {
+      const mitk::Point3D world = rowOrigin + data.RowDirection * static_cast<double>(x);
+
+      long voxel[3];
+      long brickIndex[3];
+      unsigned int offset = 0;
+      for (int d = 2; d >= 0; --d)
+      {
+        voxel[d] = static_cast<long>(std::floor(world[d] / m_OutputSpacing + 0.5));
+        brickIndex[d] = FloorDivide(voxel[d], BRICK_SIZE);
+        offset = offset * BRICK_SIZE + static_cast<unsigned int>(voxel[d] - brickIndex[d] * BRICK_SIZE);
+      }
+
+      // neighbouring pixels mostly fall into the same brick
+      const BrickKey key = MakeBrickKey(brickIndex[0], brickIndex[1], brickIndex[2]);
+      if (!cacheValid || key != cachedKey)
+      {
+        BrickMap::const_iterator it = m_Bricks.find(key);
+        cachedBrick = it != m_Bricks.end() ? it->second.get() : nullptr;
+        cachedKey = key;
+        cacheValid = true;
+      }
+      if (cachedBrick == nullptr)
+      {
+        continue;
+      }
+
+      VoxelSample sample;
+      sample.Target = cachedBrick;
+      sample.Offset = offset;
+      sample.Value = pixel[x];
+      samples.push_back(sample);
+    }
+  }
+
+  // other threads may hit the same bricks, so the samples are added brick by brick
+  // under the lock of the brick
+  std::sort(samples.begin(), samples.end(),
+            [](const VoxelSample& a, const VoxelSample& b) { return a.Target < b.Target; });
+
+  std::vector<VoxelSample>::const_iterator it = samples.begin();
+  while (it != samples.end())
+  {
+    Brick* brick = it->Target;
+    brick->Lock.Lock();
+    for (; it != samples.end() && it->Target == brick; ++it)
+    {
+      if (brick->Count[it->Offset] < 0xFFFF)
+      {
+        brick->Sum[it->Offset] += it->Value;
+        ++brick->Count[it->Offset];
+      }
+    }
+    brick->Lock.Unlock();
+  }
+}
+
+mitk::USFreehandCompoundingFilter::BrickKey mitk::USFreehandCompoundingFilter::MakeBrickKey(long bx, long by, long bz)
+{
+  return (static_cast<BrickKey>(bx + BRICK_KEY_OFFSET) << 42)
+       | (static_cast<BrickKey>(by + BRICK_KEY_OFFSET) << 21)
+       | static_cast<BrickKey>(bz + BRICK_KEY_OFFSET);
+}
+
+void mitk::USFreehandCompoundingFilter::SplitBrickKey(BrickKey key, long& bx, long& by, long& bz)
+{
+  const BrickKey mask = (static_cast<BrickKey>(1) << 21) - 1;
+  bx = static_cast<long>((key >> 42) & mask) - BRICK_KEY_OFFSET;
+  by = static_cast<long>((key >> 21) & mask) - BRICK_KEY_OFFSET;
+  bz = static_cast<long>(key & mask) - BRICK_KEY_OFFSET;
+}
+
+void mitk::USFreehandCompoundingFilter::AllocateBricks(const InsertionData& data)
+{
+  // bounding box of the frame corners in brick coordinates
+  long minimum[3];
+  long maximum[3];
+  for (unsigned int d = 0; d < 3; ++d)
+  {
+    double lower = itk::NumericTraits<double>::max();
+    double upper = itk::NumericTraits<double>::NonpositiveMin();
+    for (unsigned int corner = 0; corner < 4; ++corner)
+    {
+      const double x = (corner & 1) ? data.Width - 0.5 : -0.5;
+      const double y = (corner & 2) ? data.Height - 0.5 : -0.5;
+      const double value = data.Origin[d] + x * data.RowDirection[d] + y * data.ColumnDirection[d];
+      lower = std::min(lower, value);
+      upper = std::max(upper, value);
+    }
+    minimum[d] = FloorDivide(static_cast<long>(std::floor(lower / m_OutputSpacing)) - 1, BRICK_SIZE);
+    maximum[d] = FloorDivide(static_cast<long>(std::ceil(upper / m_OutputSpacing)) + 1, BRICK_SIZE);
+  }
+
+  // only bricks close to the frame plane are needed
+  mitk::Vector3D normal = itk::CrossProduct(data.RowDirection, data.ColumnDirection);
+  const double normalLength = normal.GetNorm();
+  if (normalLength > 0)
+  {
+    normal /= normalLength;
+  }
+  const double brickRadius = (std::sqrt(3.0) * 0.5 * BRICK_SIZE + 1.0) * m_OutputSpacing;
+
+  for (long bz = minimum[2]; bz <= maximum[2]; ++bz)
+  {
+    for (long by = minimum[1]; by <= maximum[1]; ++by)
+    {
+      for (long bx = minimum[0]; bx <= maximum[0]; ++bx)
+      {
+        if (normalLength > 0)
+        {
+          mitk::Point3D center;
+          center[0] = ((bx + 0.5) * BRICK_SIZE - 0.5) * m_OutputSpacing;
+          center[1] = ((by + 0.5) * BRICK_SIZE - 0.5) * m_OutputSpacing;
+          center[2] = ((bz + 0.5) * BRICK_SIZE - 0.5) * m_OutputSpacing;
+          if (std::abs(normal * (center - data.Origin)) > brickRadius)
+          {
+            continue;
+          }
+        }
+
+        const BrickKey key = MakeBrickKey(bx, by, bz);
+        std::unique_ptr<Brick>& brick = m_Bricks[key];
+        if (!brick)
+        {
+          brick.reset(new Brick());
+        }
+        m_ModifiedBricks.insert(key);
+
+        const long brickIndex[3] = { bx, by, bz };
+        for (unsigned int d = 0; d < 3; ++d)
+        {
+          if (m_BrickMin[d] > m_BrickMax[d])
+          {
+            m_BrickMin[d] = m_BrickMax[d] = brickIndex[d];
+          }
+          else
+          {
+            m_BrickMin[d] = std::min(m_BrickMin[d], brickIndex[d]);
+            m_BrickMax[d] = std::max(m_BrickMax[d], brickIndex[d]);
+          }
+        }
+      }
+    }
+  }
+}
+
+bool mitk::USFreehandCompoundingFilter::GetVoxelValue(long x, long y, long z, float& value) const
+{
+  const long bx = FloorDivide(x, BRICK_SIZE);
+  const long by = FloorDivide(y, BRICK_SIZE);
+  const long bz = FloorDivide(z, BRICK_SIZE);
+
+  BrickMap::const_iterator it = m_Bricks.find(MakeBrickKey(bx, by, bz));
+  if (it == m_Bricks.end())
+  {
+    return false;
+  }
+
+  const unsigned int offset = static_cast<unsigned int>(
+    (x - bx * BRICK_SIZE) + BRICK_SIZE * ((y - by * BRICK_SIZE) + BRICK_SIZE * (z - bz * BRICK_SIZE)));
+  if (it->second->Count[offset] == 0)
+  {
+    return false;
+  }
+  value = it->second->Sum[offset] / it->second->Count[offset];
+  return true;
+}
+
+void mitk::USFreehandCompoundingFilter::WriteBrick(BrickKey key, const Brick& brick, float* output,
+                                                   const long* outputBrickOrigin, const long* outputSize) const
+{
+  long brickIndex[3];
+  SplitBrickKey(key, brickIndex[0], brickIndex[1], brickIndex[2]);
+
+  long start[3];
+  for (unsigned int d = 0; d < 3; ++d)
+  {
+    start[d] = brickIndex[d] * BRICK_SIZE;
+  }
+
+  unsigned int offset = 0;
+  for (long z = 0; z < BRICK_SIZE; ++z)
+  {
+    for (long y = 0; y < BRICK_SIZE; ++y)
+    {
+      const size_t outputOffset = static_cast<size_t>(start[0] - outputBrickOrigin[0] * BRICK_SIZE)
+        + outputSize[0] * (static_cast<size_t>(start[1] + y - outputBrickOrigin[1] * BRICK_SIZE)
+        + outputSize[1] * static_cast<size_t>(start[2] + z - outputBrickOrigin[2] * BRICK_SIZE));
+
+      for (long x = 0; x < BRICK_SIZE; ++x, ++offset)
+      {
+        float value = 0.0f;
+        if (brick.Count[offset] > 0)
+        {
+          value = brick.Sum[offset] / brick.Count[offset];
+        }
+        else if (m_FillHoles)
+        {
+          float sum = 0.0f;
+          unsigned int count = 0;
+          for (long dz = -1; dz <= 1; ++dz)
+          {
+            for (long dy = -1; dy <= 1; ++dy)
+            {
+              for (long dx = -1; dx <= 1; ++dx)
+              {
+                float neighbour;
+                if (this->GetVoxelValue(start[0] + x + dx, start[1] + y + dy, start[2] + z + dz, neighbour))
+                {
+                  sum += neighbour;
+                  ++count;
+                }
+              }
+            }
+          }
+          if (count > 0)
+          {
+            value = sum / count;
+          }
+        }
+        output[outputOffset + x] = value;
+      }
+    }
+  }
+}
+
+void mitk::USFreehandCompoundingFilter::GenerateOutputInformation()
+{
+  // the extent of the output is only known after writing the bricks in GenerateData()
+}
+
+void mitk::USFreehandCompoundingFilter::GenerateData()
+{
+  mitk::Image::Pointer output = this->GetOutput();
+  if (m_Bricks.empty())
+  {
+    MITK_DEBUG << "No frames were inserted, the compounded volume stays empty.";
+    return;
+  }
+
+  long outputSize[3];
+  unsigned int dimensions[3];
+  bool extentChanged = !output->IsInitialized() || m_FillHoles != m_OutputFillHoles;
+  for (unsigned int d = 0; d < 3; ++d)
+  {
+    outputSize[d] = (m_BrickMax[d] - m_BrickMin[d] + 1) * BRICK_SIZE;
+    dimensions[d] = static_cast<unsigned int>(outputSize[d]);
+    extentChanged = extentChanged || m_BrickMin[d] != m_OutputBrickMin[d] || m_BrickMax[d] != m_OutputBrickMax[d];
+  }
+
+  if (extentChanged)
+  {
+    output->Initialize(mitk::MakeScalarPixelType<float>(), 3, dimensions);
+
+    mitk::Vector3D spacing;
+    spacing.Fill(m_OutputSpacing);
+    mitk::Point3D origin;
+    for (unsigned int d = 0; d < 3; ++d)
+    {
+      origin[d] = m_BrickMin[d] * BRICK_SIZE * m_OutputSpacing;
+      m_OutputBrickMin[d] = m_BrickMin[d];
+      m_OutputBrickMax[d] = m_BrickMax[d];
+    }
+    m_OutputFillHoles = m_FillHoles;
+    output->GetGeometry()->SetSpacing(spacing);
+    output->GetGeometry()->SetOrigin(origin);
+  }
+
+  // a new buffer is uninitialized, e.g. if the pipeline released the data of the output
+  mitk::Image::ImageDataItemPointer volume = output->GetVolumeData(0);
+  const bool writeAllBricks = extentChanged || volume.GetPointer() != m_OutputVolume.GetPointer();
+  m_OutputVolume = volume;
+
+  float* buffer = static_cast<float*>(volume->GetData());
+  std::set<BrickKey> bricksToWrite;
+  if (writeAllBricks)
+  {
+    std::memset(buffer, 0, sizeof(float) * outputSize[0] * outputSize[1] * outputSize[2]);
+    for (BrickMap::const_iterator it = m_Bricks.begin(); it != m_Bricks.end(); ++it)
+    {
+      bricksToWrite.insert(it->first);
+    }
+  }
+  else
+  {
+    // the hole filling of the neighbours depends on the modified bricks, too
+    for (std::set<BrickKey>::const_iterator it = m_ModifiedBricks.begin(); it != m_ModifiedBricks.end(); ++it)
+    {
+      long bx, by, bz;
+      SplitBrickKey(*it, bx, by, bz);
+      for (long dz = -1; dz <= 1; ++dz)
+        for (long dy = -1; dy <= 1; ++dy)
+          for (long dx = -1; dx <= 1; ++dx)
+          {
+            const BrickKey key = MakeBrickKey(bx + dx, by + dy, bz + dz);
+            if ((dx == 0 && dy == 0 && dz == 0) || (m_FillHoles && m_Bricks.find(key) != m_Bricks.end()))
+              bricksToWrite.insert(key);
+          }
+    }
+  }
+
+  for (std::set<BrickKey>::const_iterator it = bricksToWrite.begin(); it != bricksToWrite.end(); ++it)
+  {
+    BrickMap::const_iterator brick = m_Bricks.find(*it);
+    if (brick != m_Bricks.end())
+    {
+      this->WriteBrick(brick->first, *brick->second, buffer, m_OutputBrickMin, outputSize);
+    }
+  }
+
+  m_ModifiedBricks.clear();
+  output->Modified();
+}
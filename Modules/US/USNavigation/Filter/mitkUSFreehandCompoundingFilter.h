@@ -0,0 +1,189 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef USFREEHANDCOMPOUNDINGFILTER_H_INCLUDED
+#define USFREEHANDCOMPOUNDINGFILTER_H_INCLUDED
+
+#include <MitkUSNavigationExports.h>
+
+// MITK
+#include <mitkImageSource.h>
+#include <mitkNavigationData.h>
+
+// ITK
+#include <itkMultiThreader.h>
+#include <itkSimpleFastMutexLock.h>
+
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace mitk {
+  /**
+  * \brief Compounds tracked 2D ultrasound frames into a 3D volume while scanning.
+  *
+  * Every frame passed to InsertFrame() is placed into space by the calibration (image index to
+  * tool coordinates) and the navigation data of the probe (tool to world coordinates). Each pixel
+  * is added to its nearest voxel, voxels hit by several pixels get the mean value. The rows of a
+  * frame are distributed over several threads.
+  *
+  * The volume grows with the scanned region: it is stored in bricks of BRICK_SIZE^3 voxels which
+  * are allocated when a frame intersects them. Update() writes the bricks into the output image,
+  * which covers the bounding box of all allocated bricks. As long as this box does not change only
+  * the bricks modified since the last update are written. Voxels which were not hit by any pixel
+  * get the mean of their hit neighbours, if FillHoles is enabled, and zero otherwise.
+  *
+  * If a maximum frame time is set, rows are skipped when inserting a frame took longer than this
+  * time, so that the insertion keeps up with the frame rate. The gaps are closed by the hole filling
+  * or by the following frames.
+  *
+  * For offline compounding, InsertFrame() can be called with the frames of a recorded video and the
+  * navigation data of a mitk::NavigationDataPlayer which replays the corresponding tracking data.
+  *
+  * \ingroup US
+  */
+  class MITKUSNAVIGATION_EXPORT USFreehandCompoundingFilter : public ImageSource
+  {
+  public:
+    mitkClassMacro(USFreehandCompoundingFilter, ImageSource);
+    itkFactorylessNewMacro(Self);
+
+    /** Edge length of a brick in voxels. */
+    static const int BRICK_SIZE = 16;
+
+    /**
+    * \brief Sets the transform from image index to tool coordinates.
+    * If no calibration is set, the index to world transform of each frame is used instead, as it is set
+    * by mitk::USCombinedModality.
+    */
+    itkSetObjectMacro(Calibration, mitk::AffineTransform3D);
+    itkGetObjectMacro(Calibration, mitk::AffineTransform3D);
+
+    /**
+    * \brief Isotropic voxel size of the output volume in mm, default is 0.5.
+    * Changing the spacing clears the volume.
+    */
+    void SetOutputSpacing(double spacing);
+    itkGetMacro(OutputSpacing, double);
+
+    /** Fill voxels which were not hit from their neighbours (default true). */
+    itkSetMacro(FillHoles, bool);
+    itkGetMacro(FillHoles, bool);
+    itkBooleanMacro(FillHoles);
+
+    /** Time in ms one frame may take to be inserted, zero (default) means no limit. */
+    itkSetMacro(MaximumFrameTime, double);
+    itkGetMacro(MaximumFrameTime, double);
+
+    /** Only every RowStep-th row is inserted, adapted to the maximum frame time. */
+    itkGetMacro(RowStep, unsigned int);
+
+    /**
+    * \brief Inserts a frame into the volume.
+    * Only the first channel of multi channel images is used.
+    * \return false if the frame is empty or the navigation data is not valid.
+    */
+    bool InsertFrame(const mitk::Image* frame, const mitk::NavigationData* navigationData);
+
+    /** Removes all inserted frames. */
+    void Reset();
+
+    unsigned long GetNumberOfInsertedFrames() const;
+
+    unsigned long GetNumberOfBricks() const;
+
+  protected:
+    USFreehandCompoundingFilter();
+    virtual ~USFreehandCompoundingFilter();
+
+    virtual void GenerateOutputInformation() override;
+    virtual void GenerateData() override;
+
+    typedef long long BrickKey;
+
+    struct Brick
+    {
+      Brick();
+
+      std::vector<float> Sum;
+      std::vector<unsigned short> Count;
+      itk::SimpleFastMutexLock Lock;
+    };
+
+    typedef std::unordered_map<BrickKey, std::unique_ptr<Brick> > BrickMap;
+
+    /** Voxel of a brick which receives a pixel value. */
+    struct VoxelSample
+    {
+      Brick* Target;
+      unsigned int Offset;
+      float Value;
+    };
+
+    /** Data shared by the threads inserting one frame. */
+    struct InsertionData
+    {
+      USFreehandCompoundingFilter* Filter;
+      std::vector<float> Pixels;
+      unsigned int Width;
+      unsigned int Height;
+      mitk::Point3D Origin;
+      mitk::Vector3D RowDirection;
+      mitk::Vector3D ColumnDirection;
+    };
+
+    static ITK_THREAD_RETURN_TYPE InsertRowsCallback(void* arg);
+    void InsertRows(const InsertionData& data, unsigned int threadId, unsigned int numberOfThreads);
+
+    static BrickKey MakeBrickKey(long bx, long by, long bz);
+    static void SplitBrickKey(BrickKey key, long& bx, long& by, long& bz);
+
+    /** Allocates all bricks which the frame plane may hit. */
+    void AllocateBricks(const InsertionData& data);
+
+    /** Mean value of a voxel in global voxel coordinates, false if the voxel was not hit. */
+    bool GetVoxelValue(long x, long y, long z, float& value) const;
+
+    /** Writes one brick into the output buffer which starts at the given brick. */
+    void WriteBrick(BrickKey key, const Brick& brick, float* output, const long* outputBrickOrigin, const long* outputSize) const;
+
+    mitk::AffineTransform3D::Pointer m_Calibration;
+    double m_OutputSpacing;
+    bool m_FillHoles;
+    double m_MaximumFrameTime;
+    unsigned int m_RowStep;
+
+    BrickMap m_Bricks;
+    std::set<BrickKey> m_ModifiedBricks;
+    long m_BrickMin[3];
+    long m_BrickMax[3];
+    unsigned long m_NumberOfInsertedFrames;
+
+    /** extent of the last output, to decide whether it can be updated incrementally */
+    long m_OutputBrickMin[3];
+    long m_OutputBrickMax[3];
+    bool m_OutputFillHoles;
+
+    /** buffer of the last output; if the output holds another one, it was reallocated and is written completely */
+    mitk::Image::ImageDataItemPointer m_OutputVolume;
+
+    itk::MultiThreader::Pointer m_MultiThreader;
+  };
+} // namespace mitk
+
+
+#endif
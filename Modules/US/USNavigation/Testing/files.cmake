@@ -1,6 +1,7 @@
 SET(MODULE_TESTS
    mitkCombinedModalityTest.cpp
    mitkNodeDisplacementFilterTest.cpp
+   mitkUSFreehandCompoundingFilterTest.cpp
 
    # -----------------------------------------------------------------------
 
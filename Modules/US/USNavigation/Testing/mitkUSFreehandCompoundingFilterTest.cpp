@@ -0,0 +1,181 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkUSFreehandCompoundingFilter.h"
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+#include <mitkImageDataItem.h>
+
+#include <cstring>
+
+class mitkUSFreehandCompoundingFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkUSFreehandCompoundingFilterTestSuite);
+  MITK_TEST(TestInvalidInput);
+  MITK_TEST(TestSweep);
+  MITK_TEST(TestHoleFilling);
+  MITK_TEST(TestIncrementalUpdate);
+  MITK_TEST(TestIncrementalUpdateAfterReleasedOutput);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  mitk::USFreehandCompoundingFilter::Pointer m_Filter;
+  mitk::Image::Pointer m_Frame;
+
+  /** frame with a constant value, 20 x 10 pixels by default, pixel (x, y) lies at (x, y, 0) in tool coordinates */
+  mitk::Image::Pointer CreateFrame(unsigned char value, unsigned int width = 20, unsigned int height = 10)
+  {
+    unsigned int dimensions[2] = { width, height };
+    mitk::Image::Pointer frame = mitk::Image::New();
+    frame->Initialize(mitk::MakeScalarPixelType<unsigned char>(), 2, dimensions);
+    mitk::Image::ImageDataItemPointer volume = frame->GetVolumeData(0);
+    std::memset(volume->GetData(), value, width * height);
+    return frame;
+  }
+
+  /** Inserts a sweep over two bricks in x direction and then a small frame which touches the first brick only.
+   *  The voxels of the second brick have to keep their values although only the first brick is written again. */
+  void CheckIncrementalUpdate(bool releaseOutput)
+  {
+    // without hole filling only the touched brick is written, not its neighbours
+    m_Filter->FillHolesOff();
+    for (unsigned int i = 0; i < 10; ++i)
+    {
+      m_Filter->InsertFrame(m_Frame, this->CreateNavigationData(i));
+    }
+    m_Filter->Update();
+    mitk::Image::Pointer output = m_Filter->GetOutput();
+    const unsigned int dimension = output->GetDimension(0);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Voxel in the second brick has the frame value.",
+                                         100.0, this->GetOutputValue(output, 18, 5, 5), 1e-4);
+
+    if (releaseOutput)
+    {
+      output->ReleaseData();
+    }
+
+    m_Filter->InsertFrame(this->CreateFrame(200, 4, 4), this->CreateNavigationData(5));
+    m_Filter->Update();
+    output = m_Filter->GetOutput();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Extent of the output did not change.", dimension, output->GetDimension(0));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Voxel of the small frame is averaged.",
+                                         150.0, this->GetOutputValue(output, 2, 2, 5), 1e-4);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Voxel in the untouched brick keeps its value.",
+                                         100.0, this->GetOutputValue(output, 18, 5, 5), 1e-4);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Empty voxel in the untouched brick stays empty.",
+                                         0.0, this->GetOutputValue(output, 18, 5, 14), 1e-4);
+  }
+
+  mitk::NavigationData::Pointer CreateNavigationData(double z)
+  {
+    mitk::NavigationData::PositionType position;
+    mitk::FillVector3D(position, 0.0, 0.0, z);
+    mitk::NavigationData::Pointer navigationData = mitk::NavigationData::New();
+    navigationData->SetPosition(position);
+    navigationData->SetDataValid(true);
+    return navigationData;
+  }
+
+  float GetOutputValue(mitk::Image* output, double x, double y, double z)
+  {
+    mitk::Point3D world;
+    mitk::FillVector3D(world, x, y, z);
+    itk::Index<3> index;
+    output->GetGeometry()->WorldToIndex(world, index);
+    mitk::Image::ImageDataItemPointer volume = output->GetVolumeData(0);
+    const float* buffer = static_cast<const float*>(volume->GetData());
+    return buffer[index[0] + output->GetDimension(0) * (index[1] + output->GetDimension(1) * index[2])];
+  }
+
+public:
+
+  void setUp() override
+  {
+    m_Filter = mitk::USFreehandCompoundingFilter::New();
+    m_Filter->SetOutputSpacing(1.0);
+    m_Frame = this->CreateFrame(100);
+  }
+
+  void tearDown() override
+  {
+    m_Filter = nullptr;
+    m_Frame = nullptr;
+  }
+
+  void TestInvalidInput()
+  {
+    mitk::NavigationData::Pointer navigationData = this->CreateNavigationData(0.0);
+    navigationData->SetDataValid(false);
+    CPPUNIT_ASSERT_MESSAGE("Frames with invalid navigation data are ignored.",
+                           !m_Filter->InsertFrame(m_Frame, navigationData));
+    CPPUNIT_ASSERT_MESSAGE("Empty frames are ignored.",
+                           !m_Filter->InsertFrame(mitk::Image::New(), this->CreateNavigationData(0.0)));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("No frame was inserted.", 0ul, m_Filter->GetNumberOfInsertedFrames());
+  }
+
+  void TestSweep()
+  {
+    for (unsigned int i = 0; i < 10; ++i)
+    {
+      CPPUNIT_ASSERT_MESSAGE("Frame can be inserted.", m_Filter->InsertFrame(m_Frame, this->CreateNavigationData(i)));
+    }
+    m_Filter->Update();
+
+    mitk::Image::Pointer output = m_Filter->GetOutput();
+    CPPUNIT_ASSERT_MESSAGE("Output volume is initialized.", output->IsInitialized());
+    CPPUNIT_ASSERT_MESSAGE("Output volume covers the sweep.",
+                           output->GetDimension(0) >= 20 && output->GetDimension(1) >= 10 && output->GetDimension(2) >= 10);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Voxel inside the sweep has the frame value.",
+                                         100.0, this->GetOutputValue(output, 5, 5, 5), 1e-4);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Voxel far from the sweep is empty.",
+                                         0.0, this->GetOutputValue(output, 5, 5, 14), 1e-4);
+
+    // a second sweep with another value averages with the first one
+    mitk::Image::Pointer brightFrame = this->CreateFrame(200);
+    m_Filter->InsertFrame(brightFrame, this->CreateNavigationData(5));
+    m_Filter->Update();
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Overlapping frames are averaged.",
+                                         150.0, this->GetOutputValue(m_Filter->GetOutput(), 5, 5, 5), 1e-4);
+  }
+
+  void TestHoleFilling()
+  {
+    // frames two voxels apart leave a gap which is filled from the neighbours
+    m_Filter->InsertFrame(m_Frame, this->CreateNavigationData(2));
+    m_Filter->InsertFrame(m_Frame, this->CreateNavigationData(4));
+    m_Filter->Update();
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Hole between the frames is filled.",
+                                         100.0, this->GetOutputValue(m_Filter->GetOutput(), 5, 5, 3), 1e-4);
+
+    m_Filter->FillHolesOff();
+    m_Filter->Update();
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Hole stays empty without hole filling.",
+                                         0.0, this->GetOutputValue(m_Filter->GetOutput(), 5, 5, 3), 1e-4);
+  }
+
+  void TestIncrementalUpdate()
+  {
+    this->CheckIncrementalUpdate(false);
+  }
+
+  void TestIncrementalUpdateAfterReleasedOutput()
+  {
+    this->CheckIncrementalUpdate(true);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkUSFreehandCompoundingFilter)
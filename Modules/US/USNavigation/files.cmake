@@ -4,4 +4,5 @@ SET(CPP_FILES
   Filter/mitkNavigationDataPassThroughFilter.cpp
   Filter/mitkNeedleProjectionFilter.cpp
   Filter/mitkNodeDisplacementFilter.cpp
+  Filter/mitkUSFreehandCompoundingFilter.cpp
 )
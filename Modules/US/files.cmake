@@ -18,6 +18,8 @@ USFilters/mitkUSImageLoggingFilter.cpp
 USFilters/mitkUSImageSource.cpp
 USFilters/mitkUSImageVideoSource.cpp
 USFilters/mitkIGTLMessageToUSImageFilter.cpp
+USFilters/mitkUSImageStreamRecorder.cpp
+USFilters/mitkUSImageStreamSource.cpp
 
 ## Control Interfaces
 USControlInterfaces/mitkUSAbstractControlInterface.cpp